@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/audio_codecs/opus/pooled_opus_audio_codec_factories.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/match.h"
+#include "api/audio_codecs/opus/audio_decoder_opus.h"
+#include "api/audio_codecs/opus/audio_encoder_opus.h"
+#include "modules/audio_coding/codecs/opus/audio_decoder_opus.h"
+#include "modules/audio_coding/codecs/opus/audio_encoder_opus.h"
+#include "modules/audio_coding/codecs/opus/opus_state_pool.h"
+#include "rtc_base/refcountedobject.h"
+
+namespace webrtc {
+namespace {
+
+// Appends the specs of |fallback_specs| that are not Opus to |specs|.
+void AppendNonOpusSpecs(std::vector<AudioCodecSpec> fallback_specs,
+                        std::vector<AudioCodecSpec>* specs) {
+  for (AudioCodecSpec& spec : fallback_specs) {
+    if (!absl::EqualsIgnoreCase(spec.format.name, "opus"))
+      specs->push_back(std::move(spec));
+  }
+}
+
+class PooledOpusAudioEncoderFactory : public AudioEncoderFactory {
+ public:
+  PooledOpusAudioEncoderFactory(
+      rtc::scoped_refptr<AudioEncoderFactory> fallback,
+      size_t max_idle_states)
+      : fallback_(std::move(fallback)),
+        state_pool_(OpusStatePool::Create(max_idle_states)) {}
+
+  std::vector<AudioCodecSpec> GetSupportedEncoders() override {
+    std::vector<AudioCodecSpec> specs;
+    AudioEncoderOpus::AppendSupportedEncoders(&specs);
+    if (fallback_)
+      AppendNonOpusSpecs(fallback_->GetSupportedEncoders(), &specs);
+    return specs;
+  }
+
+  absl::optional<AudioCodecInfo> QueryAudioEncoder(
+      const SdpAudioFormat& format) override {
+    const auto config = AudioEncoderOpus::SdpToConfig(format);
+    if (config)
+      return AudioEncoderOpus::QueryAudioEncoder(*config);
+    if (fallback_)
+      return fallback_->QueryAudioEncoder(format);
+    return absl::nullopt;
+  }
+
+  std::unique_ptr<AudioEncoder> MakeAudioEncoder(
+      int payload_type,
+      const SdpAudioFormat& format,
+      absl::optional<AudioCodecPairId> codec_pair_id) override {
+    const auto config = AudioEncoderOpus::SdpToConfig(format);
+    if (config) {
+      return absl::make_unique<AudioEncoderOpusImpl>(*config, payload_type,
+                                                     state_pool_);
+    }
+    return fallback_
+               ? fallback_->MakeAudioEncoder(payload_type, format,
+                                             codec_pair_id)
+               : nullptr;
+  }
+
+ private:
+  const rtc::scoped_refptr<AudioEncoderFactory> fallback_;
+  const rtc::scoped_refptr<OpusStatePool> state_pool_;
+};
+
+class PooledOpusAudioDecoderFactory : public AudioDecoderFactory {
+ public:
+  PooledOpusAudioDecoderFactory(
+      rtc::scoped_refptr<AudioDecoderFactory> fallback,
+      size_t max_idle_states)
+      : fallback_(std::move(fallback)),
+        state_pool_(OpusStatePool::Create(max_idle_states)) {}
+
+  std::vector<AudioCodecSpec> GetSupportedDecoders() override {
+    std::vector<AudioCodecSpec> specs;
+    AudioDecoderOpus::AppendSupportedDecoders(&specs);
+    if (fallback_)
+      AppendNonOpusSpecs(fallback_->GetSupportedDecoders(), &specs);
+    return specs;
+  }
+
+  bool IsSupportedDecoder(const SdpAudioFormat& format) override {
+    return AudioDecoderOpus::SdpToConfig(format) ||
+           (fallback_ && fallback_->IsSupportedDecoder(format));
+  }
+
+  std::unique_ptr<AudioDecoder> MakeAudioDecoder(
+      const SdpAudioFormat& format,
+      absl::optional<AudioCodecPairId> codec_pair_id) override {
+    const auto config = AudioDecoderOpus::SdpToConfig(format);
+    if (config) {
+      return absl::make_unique<AudioDecoderOpusImpl>(config->num_channels,
+                                                     state_pool_);
+    }
+    return fallback_ ? fallback_->MakeAudioDecoder(format, codec_pair_id)
+                     : nullptr;
+  }
+
+ private:
+  const rtc::scoped_refptr<AudioDecoderFactory> fallback_;
+  const rtc::scoped_refptr<OpusStatePool> state_pool_;
+};
+
+}  // namespace
+
+rtc::scoped_refptr<AudioEncoderFactory> CreatePooledOpusAudioEncoderFactory(
+    rtc::scoped_refptr<AudioEncoderFactory> fallback,
+    size_t max_idle_states) {
+  return new rtc::RefCountedObject<PooledOpusAudioEncoderFactory>(
+      std::move(fallback), max_idle_states);
+}
+
+rtc::scoped_refptr<AudioDecoderFactory> CreatePooledOpusAudioDecoderFactory(
+    rtc::scoped_refptr<AudioDecoderFactory> fallback,
+    size_t max_idle_states) {
+  return new rtc::RefCountedObject<PooledOpusAudioDecoderFactory>(
+      std::move(fallback), max_idle_states);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,44 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef API_AUDIO_CODECS_OPUS_POOLED_OPUS_AUDIO_CODEC_FACTORIES_H_
+#define API_AUDIO_CODECS_OPUS_POOLED_OPUS_AUDIO_CODEC_FACTORIES_H_
+
+#include <stddef.h>
+
+#include "api/audio_codecs/audio_decoder_factory.h"
+#include "api/audio_codecs/audio_encoder_factory.h"
+#include "rtc_base/scoped_ref_ptr.h"
+#include "rtc_base/system/rtc_export.h"
+
+namespace webrtc {
+
+// Maximum number of idle libopus states the pooled factories keep for each
+// number of channels by default.
+constexpr size_t kDefaultMaxIdleOpusStates = 32;
+
+// Creates a factory that makes Opus encoders recycling the libopus states of
+// the Opus encoders it made before, instead of allocating new ones, and
+// delegates the other formats to |fallback|, which may be null. Meant for
+// applications that create and destroy many streams.
+RTC_EXPORT rtc::scoped_refptr<AudioEncoderFactory>
+CreatePooledOpusAudioEncoderFactory(
+    rtc::scoped_refptr<AudioEncoderFactory> fallback,
+    size_t max_idle_states = kDefaultMaxIdleOpusStates);
+
+// Same as CreatePooledOpusAudioEncoderFactory(), for decoders.
+RTC_EXPORT rtc::scoped_refptr<AudioDecoderFactory>
+CreatePooledOpusAudioDecoderFactory(
+    rtc::scoped_refptr<AudioDecoderFactory> fallback,
+    size_t max_idle_states = kDefaultMaxIdleOpusStates);
+
+}  // namespace webrtc
+
+#endif  // API_AUDIO_CODECS_OPUS_POOLED_OPUS_AUDIO_CODEC_FACTORIES_H_
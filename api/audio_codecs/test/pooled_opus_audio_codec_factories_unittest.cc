@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/audio_codecs/opus/pooled_opus_audio_codec_factories.h"
+
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "api/audio_codecs/builtin_audio_decoder_factory.h"
+#include "api/audio_codecs/builtin_audio_encoder_factory.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+const SdpAudioFormat kOpusFormat("opus", 48000, 2, {{"stereo", "1"}});
+const SdpAudioFormat kG722Format("G722", 8000, 1);
+
+size_t CountOpusSpecs(const std::vector<AudioCodecSpec>& specs) {
+  size_t count = 0;
+  for (const AudioCodecSpec& spec : specs) {
+    if (absl::EqualsIgnoreCase(spec.format.name, "opus"))
+      ++count;
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST(PooledOpusAudioEncoderFactoryTest, OpusAndFallbackFormats) {
+  auto factory =
+      CreatePooledOpusAudioEncoderFactory(CreateBuiltinAudioEncoderFactory());
+  const std::vector<AudioCodecSpec> specs = factory->GetSupportedEncoders();
+  ASSERT_FALSE(specs.empty());
+  EXPECT_TRUE(absl::EqualsIgnoreCase(specs[0].format.name, "opus"));
+  EXPECT_EQ(1u, CountOpusSpecs(specs));
+  EXPECT_GT(specs.size(),
+            CreatePooledOpusAudioEncoderFactory(nullptr)
+                ->GetSupportedEncoders()
+                .size());
+
+  EXPECT_TRUE(factory->QueryAudioEncoder(kOpusFormat));
+  EXPECT_TRUE(factory->QueryAudioEncoder(kG722Format));
+  auto opus_encoder = factory->MakeAudioEncoder(17, kOpusFormat, absl::nullopt);
+  ASSERT_TRUE(opus_encoder);
+  EXPECT_EQ(48000, opus_encoder->SampleRateHz());
+  EXPECT_EQ(2u, opus_encoder->NumChannels());
+  auto g722_encoder = factory->MakeAudioEncoder(9, kG722Format, absl::nullopt);
+  ASSERT_TRUE(g722_encoder);
+  EXPECT_EQ(16000, g722_encoder->SampleRateHz());
+}
+
+TEST(PooledOpusAudioEncoderFactoryTest, NoFallback) {
+  auto factory = CreatePooledOpusAudioEncoderFactory(nullptr);
+  EXPECT_FALSE(factory->QueryAudioEncoder(kG722Format));
+  EXPECT_FALSE(factory->MakeAudioEncoder(9, kG722Format, absl::nullopt));
+  // Encoders made one after the other reuse the same libopus state.
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(factory->MakeAudioEncoder(17, kOpusFormat, absl::nullopt));
+  }
+}
+
+TEST(PooledOpusAudioDecoderFactoryTest, OpusAndFallbackFormats) {
+  auto factory =
+      CreatePooledOpusAudioDecoderFactory(CreateBuiltinAudioDecoderFactory());
+  const std::vector<AudioCodecSpec> specs = factory->GetSupportedDecoders();
+  ASSERT_FALSE(specs.empty());
+  EXPECT_TRUE(absl::EqualsIgnoreCase(specs[0].format.name, "opus"));
+  EXPECT_EQ(1u, CountOpusSpecs(specs));
+
+  EXPECT_TRUE(factory->IsSupportedDecoder(kOpusFormat));
+  EXPECT_TRUE(factory->IsSupportedDecoder(kG722Format));
+  auto opus_decoder = factory->MakeAudioDecoder(kOpusFormat, absl::nullopt);
+  ASSERT_TRUE(opus_decoder);
+  EXPECT_EQ(48000, opus_decoder->SampleRateHz());
+  EXPECT_EQ(2u, opus_decoder->Channels());
+  auto g722_decoder = factory->MakeAudioDecoder(kG722Format, absl::nullopt);
+  ASSERT_TRUE(g722_decoder);
+  EXPECT_EQ(16000, g722_decoder->SampleRateHz());
+}
+
+TEST(PooledOpusAudioDecoderFactoryTest, NoFallback) {
+  auto factory = CreatePooledOpusAudioDecoderFactory(nullptr);
+  EXPECT_FALSE(factory->IsSupportedDecoder(kG722Format));
+  EXPECT_FALSE(factory->MakeAudioDecoder(kG722Format, absl::nullopt));
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(factory->MakeAudioDecoder(kOpusFormat, absl::nullopt));
+  }
+}
+
+}  // namespace webrtc
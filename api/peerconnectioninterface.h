@@ -1273,6 +1273,16 @@ class PeerConnectionFactoryInterface : public rtc::RefCountInterface {
 
     // Sets crypto related options, e.g. enabled cipher suites.
     CryptoOptions crypto_options = CryptoOptions::NoGcm();
+
+    // The number of network threads that subsequently created
+    // PeerConnections are spread over. Each PeerConnection runs all of its
+    // ICE, DTLS and RTP transport work on one of them, picked as the one
+    // serving the fewest PeerConnections when it's created. The factory's
+    // network thread is always the first one; the others are created by the
+    // factory when first needed. PeerConnections created with an injected
+    // PortAllocator always use the factory's network thread. The worker
+    // thread is still shared by all PeerConnections of the factory.
+    int num_network_threads = 1;
   };
 
   // Set the options to be used for subsequently created PeerConnections.
@@ -57,6 +57,7 @@ std::string VideoCodecTestStats::VideoStatistics::ToString(
   ss << "\n" << prefix << "framerate_fps: " << framerate_fps;
   ss << "\n" << prefix << "enc_speed_fps: " << enc_speed_fps;
   ss << "\n" << prefix << "dec_speed_fps: " << dec_speed_fps;
+  ss << "\n" << prefix << "dec_throughput_fps: " << dec_throughput_fps;
   ss << "\n" << prefix << "avg_delay_sec: " << avg_delay_sec;
   ss << "\n"
      << prefix << "max_key_frame_delay_sec: " << max_key_frame_delay_sec;
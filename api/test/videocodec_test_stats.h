@@ -58,6 +58,9 @@ class VideoCodecTestStats {
     int decode_return_code = 0;
     bool decoding_successful = false;
     size_t decode_time_us = 0;
+    // Time spent in Decode() for this frame. Shorter than |decode_time_us| when
+    // the decoder delivers the frame with a later call.
+    size_t decode_call_time_us = 0;
     size_t decoded_width = 0;
     size_t decoded_height = 0;
 
@@ -93,6 +96,9 @@ class VideoCodecTestStats {
 
     float enc_speed_fps = 0.0f;
     float dec_speed_fps = 0.0f;
+    // Decoded frames per second spent in Decode(). Higher than
+    // |dec_speed_fps| for decoders that decode frames in parallel.
+    float dec_throughput_fps = 0.0f;
 
     float avg_delay_sec = 0.0f;
     float max_key_frame_delay_sec = 0.0f;
@@ -14,6 +14,12 @@
 
 namespace webrtc {
 
+rtc::scoped_refptr<VideoFrameBuffer> VideoFrameBuffer::GetScaledBuffer(
+    int scaled_width,
+    int scaled_height) {
+  return nullptr;
+}
+
 rtc::scoped_refptr<I420BufferInterface> VideoFrameBuffer::GetI420() {
   RTC_CHECK(type() == Type::kI420);
   return static_cast<I420BufferInterface*>(this);
@@ -65,6 +65,15 @@ class VideoFrameBuffer : public rtc::RefCountInterface {
   // software encoders.
   virtual rtc::scoped_refptr<I420BufferInterface> ToI420() = 0;
 
+  // Returns the frame scaled to |scaled_width| x |scaled_height|, if the
+  // implementation can provide it more cheaply than by scaling the result of
+  // ToI420(), e.g. because it keeps scaled versions of itself that are shared
+  // by all the sinks of the frame. Returns null otherwise, which is the
+  // default.
+  virtual rtc::scoped_refptr<VideoFrameBuffer> GetScaledBuffer(
+      int scaled_width,
+      int scaled_height);
+
   // These functions should only be called if type() is of the correct type.
   // Calling with a different type will result in a crash.
   // TODO(magjed): Return raw pointers for GetI420 once deprecated interface is
@@ -42,6 +42,17 @@ struct RTC_EXPORT VideoSinkWants {
   absl::optional<int> target_pixel_count;
   // Tells the source the maximum framerate the sink wants.
   int max_framerate_fps = std::numeric_limits<int>::max();
+
+  // Tells a source delivering the same frames to several sinks, e.g. a
+  // VideoBroadcaster, that the sink adapts the resolution of the frames
+  // itself, so the source passes the frames on unscaled. Otherwise, such a
+  // source scales frames larger than max_pixel_count down for the sink.
+  bool adapts_resolution = false;
+  // Tells such a source that it may produce frames larger than
+  // max_pixel_count for other sinks, and scale them down for this one. The
+  // sink must cope with native frames larger than max_pixel_count, which
+  // can't be scaled that way. Otherwise, the source keeps to max_pixel_count.
+  bool accepts_scaled_frames = false;
 };
 
 template <typename VideoFrameT>
@@ -10,6 +10,11 @@
 
 #include "call/rtp_demuxer.h"
 
+#include <string.h>
+
+#include <algorithm>
+
+#include "api/array_view.h"
 #include "call/rtp_packet_sink_interface.h"
 #include "call/rtp_rtcp_demuxer_helper.h"
 #include "call/ssrc_binding_observer.h"
@@ -23,14 +28,56 @@ namespace webrtc {
 RtpDemuxerCriteria::RtpDemuxerCriteria() = default;
 RtpDemuxerCriteria::~RtpDemuxerCriteria() = default;
 
+namespace {
+
+bool IsValidStringExtension(rtc::ArrayView<const uint8_t> data) {
+  // Valid string extension can't be empty.
+  return !data.empty() && data[0] != 0;
+}
+
+// Same as the std::string version of BaseRtpStringExtension::Parse(), without
+// copying the string.
+size_t StringExtensionLength(rtc::ArrayView<const uint8_t> data) {
+  return strnlen(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+template <typename Extension>
+int FindStringExtensionId(const RtpPacketReceived& packet,
+                          const StringIdTable& ids,
+                          bool* has_extension) {
+  rtc::ArrayView<const uint8_t> data = packet.GetRawExtension<Extension>();
+  *has_extension = IsValidStringExtension(data);
+  if (!*has_extension)
+    return StringIdTable::kNoId;
+  return ids.Find(reinterpret_cast<const char*>(data.data()),
+                  StringExtensionLength(data));
+}
+
+bool AllNull(const std::vector<RtpPacketSinkInterface*>& sinks) {
+  return std::find_if(sinks.begin(), sinks.end(),
+                      [](const RtpPacketSinkInterface* sink) {
+                        return sink != nullptr;
+                      }) == sinks.end();
+}
+
+size_t RemoveFromVector(std::vector<RtpPacketSinkInterface*>* sinks,
+                        const RtpPacketSinkInterface* sink) {
+  const size_t old_size = sinks->size();
+  sinks->erase(std::remove(sinks->begin(), sinks->end(), sink), sinks->end());
+  return old_size - sinks->size();
+}
+
+}  // namespace
+
 RtpDemuxer::RtpDemuxer() = default;
 
 RtpDemuxer::~RtpDemuxer() {
-  RTC_DCHECK(sink_by_mid_.empty());
+  RTC_DCHECK(AllNull(sink_by_mid_));
   RTC_DCHECK(sink_by_ssrc_.empty());
-  RTC_DCHECK(sinks_by_pt_.empty());
+  for (const auto& sinks : sinks_by_pt_)
+    RTC_DCHECK(sinks.empty());
   RTC_DCHECK(sink_by_mid_and_rsid_.empty());
-  RTC_DCHECK(sink_by_rsid_.empty());
+  RTC_DCHECK(AllNull(sink_by_rsid_));
   RTC_DCHECK(ssrc_binding_observers_.empty());
 }
 
@@ -49,61 +96,73 @@ bool RtpDemuxer::AddSink(const RtpDemuxerCriteria& criteria,
     return false;
   }
 
+  int mid_id = StringIdTable::kNoId;
   if (!criteria.mid.empty()) {
-    if (criteria.rsid.empty()) {
-      sink_by_mid_.emplace(criteria.mid, sink);
+    mid_id = mids_.Intern(criteria.mid);
+    sink_by_mid_.resize(mids_.size(), nullptr);
+    num_mid_rsid_sinks_by_mid_.resize(mids_.size(), 0);
+  }
+  int rsid_id = StringIdTable::kNoId;
+  if (!criteria.rsid.empty()) {
+    rsid_id = rsids_.Intern(criteria.rsid);
+    sink_by_rsid_.resize(rsids_.size(), nullptr);
+  }
+
+  if (mid_id != StringIdTable::kNoId) {
+    if (rsid_id == StringIdTable::kNoId) {
+      sink_by_mid_[mid_id] = sink;
     } else {
-      sink_by_mid_and_rsid_.emplace(std::make_pair(criteria.mid, criteria.rsid),
-                                    sink);
+      sink_by_mid_and_rsid_.Emplace(MidRsidKey(mid_id, rsid_id), sink);
+      ++num_mid_rsid_sinks_by_mid_[mid_id];
     }
   } else {
-    if (!criteria.rsid.empty()) {
-      sink_by_rsid_.emplace(criteria.rsid, sink);
+    if (rsid_id != StringIdTable::kNoId && !sink_by_rsid_[rsid_id]) {
+      sink_by_rsid_[rsid_id] = sink;
     }
   }
 
   for (uint32_t ssrc : criteria.ssrcs) {
-    sink_by_ssrc_.emplace(ssrc, sink);
+    sink_by_ssrc_.Emplace(ssrc, sink);
   }
 
   for (uint8_t payload_type : criteria.payload_types) {
-    sinks_by_pt_.emplace(payload_type, sink);
+    sinks_by_pt_[payload_type].push_back(sink);
   }
 
-  RefreshKnownMids();
-
   return true;
 }
 
 bool RtpDemuxer::CriteriaWouldConflict(
     const RtpDemuxerCriteria& criteria) const {
   if (!criteria.mid.empty()) {
+    const int mid_id = mids_.Find(criteria.mid);
     if (criteria.rsid.empty()) {
-      // If the MID is in the known_mids_ set, then there is already a sink
-      // added for this MID directly, or there is a sink already added with a
-      // MID, RSID pair for our MID and some RSID.
+      // If the MID is known, then there is already a sink added for this MID
+      // directly, or there is a sink already added with a MID, RSID pair for
+      // our MID and some RSID.
       // Adding this criteria would cause one of these rules to be shadowed, so
       // reject this new criteria.
-      if (known_mids_.find(criteria.mid) != known_mids_.end()) {
+      if (IsKnownMid(mid_id)) {
         return true;
       }
     } else {
       // If the exact rule already exists, then reject this duplicate.
-      if (sink_by_mid_and_rsid_.find(std::make_pair(
-              criteria.mid, criteria.rsid)) != sink_by_mid_and_rsid_.end()) {
+      const int rsid_id = rsids_.Find(criteria.rsid);
+      if (mid_id != StringIdTable::kNoId && rsid_id != StringIdTable::kNoId &&
+          sink_by_mid_and_rsid_.Find(MidRsidKey(mid_id, rsid_id))) {
         return true;
       }
       // If there is already a sink registered for the bare MID, then this
       // criteria will never receive any packets because they will just be
       // directed to that MID sink, so reject this new criteria.
-      if (sink_by_mid_.find(criteria.mid) != sink_by_mid_.end()) {
+      if (SinkByMid(mid_id) != nullptr) {
         return true;
       }
     }
   }
 
   for (uint32_t ssrc : criteria.ssrcs) {
-    if (sink_by_ssrc_.find(ssrc) != sink_by_ssrc_.end()) {
+    if (sink_by_ssrc_.Find(ssrc)) {
       return true;
     }
   }
@@ -113,18 +172,27 @@ bool RtpDemuxer::CriteriaWouldConflict(
   return false;
 }
 
-void RtpDemuxer::RefreshKnownMids() {
-  known_mids_.clear();
-
-  for (auto const& item : sink_by_mid_) {
-    const std::string& mid = item.first;
-    known_mids_.insert(mid);
+RtpPacketSinkInterface* RtpDemuxer::SinkByMid(int mid_id) const {
+  if (mid_id == StringIdTable::kNoId ||
+      static_cast<size_t>(mid_id) >= sink_by_mid_.size()) {
+    return nullptr;
   }
+  return sink_by_mid_[mid_id];
+}
 
-  for (auto const& item : sink_by_mid_and_rsid_) {
-    const std::string& mid = item.first.first;
-    known_mids_.insert(mid);
+RtpPacketSinkInterface* RtpDemuxer::SinkByRsid(int rsid_id) const {
+  if (rsid_id == StringIdTable::kNoId ||
+      static_cast<size_t>(rsid_id) >= sink_by_rsid_.size()) {
+    return nullptr;
   }
+  return sink_by_rsid_[rsid_id];
+}
+
+bool RtpDemuxer::IsKnownMid(int mid_id) const {
+  return SinkByMid(mid_id) != nullptr ||
+         (mid_id != StringIdTable::kNoId &&
+          static_cast<size_t>(mid_id) < num_mid_rsid_sinks_by_mid_.size() &&
+          num_mid_rsid_sinks_by_mid_[mid_id] > 0);
 }
 
 bool RtpDemuxer::AddSink(uint32_t ssrc, RtpPacketSinkInterface* sink) {
@@ -142,12 +210,33 @@ void RtpDemuxer::AddSink(const std::string& rsid,
 
 bool RtpDemuxer::RemoveSink(const RtpPacketSinkInterface* sink) {
   RTC_DCHECK(sink);
-  size_t num_removed = RemoveFromMapByValue(&sink_by_mid_, sink) +
-                       RemoveFromMapByValue(&sink_by_ssrc_, sink) +
-                       RemoveFromMultimapByValue(&sinks_by_pt_, sink) +
-                       RemoveFromMapByValue(&sink_by_mid_and_rsid_, sink) +
-                       RemoveFromMapByValue(&sink_by_rsid_, sink);
-  RefreshKnownMids();
+  size_t num_removed = 0;
+  for (RtpPacketSinkInterface*& mid_sink : sink_by_mid_) {
+    if (mid_sink == sink) {
+      mid_sink = nullptr;
+      ++num_removed;
+    }
+  }
+  for (RtpPacketSinkInterface*& rsid_sink : sink_by_rsid_) {
+    if (rsid_sink == sink) {
+      rsid_sink = nullptr;
+      ++num_removed;
+    }
+  }
+  num_removed += sink_by_ssrc_.EraseIf(
+      [sink](uint32_t ssrc, const RtpPacketSinkInterface* ssrc_sink) {
+        return ssrc_sink == sink;
+      });
+  for (auto& sinks : sinks_by_pt_) {
+    num_removed += RemoveFromVector(&sinks, sink);
+  }
+  num_removed += sink_by_mid_and_rsid_.EraseIf(
+      [this, sink](uint64_t key, const RtpPacketSinkInterface* mid_rsid_sink) {
+        if (mid_rsid_sink != sink)
+          return false;
+        --num_mid_rsid_sinks_by_mid_[key >> 32];
+        return true;
+      });
   return num_removed > 0;
 }
 
@@ -165,49 +254,74 @@ RtpPacketSinkInterface* RtpDemuxer::ResolveSink(
   // See the BUNDLE spec for high level reference to this algorithm:
   // https://tools.ietf.org/html/draft-ietf-mmusic-sdp-bundle-negotiation-38#section-10.2
 
-  // RSID and RRID are routed to the same sinks. If an RSID is specified on a
-  // repair packet, it should be ignored and the RRID should be used.
-  std::string packet_mid, packet_rsid;
-  bool has_mid = use_mid_ && packet.GetExtension<RtpMid>(&packet_mid);
-  bool has_rsid = packet.GetExtension<RepairedRtpStreamId>(&packet_rsid);
-  if (!has_rsid) {
-    has_rsid = packet.GetExtension<RtpStreamId>(&packet_rsid);
+  // The MID and RSID are looked up directly from the packet buffer, so that
+  // no strings are allocated per packet.
+  bool has_mid = false;
+  int packet_mid_id = StringIdTable::kNoId;
+  if (use_mid_) {
+    packet_mid_id = FindStringExtensionId<RtpMid>(packet, mids_, &has_mid);
   }
   uint32_t ssrc = packet.Ssrc();
 
   // The BUNDLE spec says to drop any packets with unknown MIDs, even if the
   // SSRC is known/latched.
-  if (has_mid && known_mids_.find(packet_mid) == known_mids_.end()) {
+  if (has_mid && !IsKnownMid(packet_mid_id)) {
     return nullptr;
   }
 
+  // RSID and RRID are routed to the same sinks. If an RSID is specified on a
+  // repair packet, it should be ignored and the RRID should be used.
+  rtc::ArrayView<const uint8_t> packet_rsid =
+      packet.GetRawExtension<RepairedRtpStreamId>();
+  if (!IsValidStringExtension(packet_rsid)) {
+    packet_rsid = packet.GetRawExtension<RtpStreamId>();
+  }
+  bool has_rsid = IsValidStringExtension(packet_rsid);
+  int packet_rsid_id = StringIdTable::kNoId;
+  if (has_rsid) {
+    const char* data = reinterpret_cast<const char*>(packet_rsid.data());
+    const size_t size = StringExtensionLength(packet_rsid);
+    packet_rsid_id = rsids_.Find(data, size);
+    // An RSID is remembered even if no sink has been added for it yet, up to a
+    // limit on the number of distinct RSIDs.
+    if (packet_rsid_id == StringIdTable::kNoId &&
+        rsids_.size() < kMaxSsrcBindings) {
+      packet_rsid_id = rsids_.Intern(data, size);
+      sink_by_rsid_.resize(rsids_.size(), nullptr);
+    }
+  }
+
   // Cache information we learn about SSRCs and IDs. We need to do this even if
   // there isn't a rule/sink yet because we might add an MID/RSID rule after
   // learning an MID/RSID<->SSRC association.
 
-  std::string* mid = nullptr;
+  int mid_id = StringIdTable::kNoId;
   if (has_mid) {
-    mid_by_ssrc_[ssrc] = packet_mid;
-    mid = &packet_mid;
+    mid_by_ssrc_.Set(ssrc, packet_mid_id);
+    mid_id = packet_mid_id;
   } else {
     // If the packet does not include a MID header extension, check if there is
     // a latched MID for the SSRC.
-    const auto it = mid_by_ssrc_.find(ssrc);
-    if (it != mid_by_ssrc_.end()) {
-      mid = &it->second;
+    const int* latched_mid_id = mid_by_ssrc_.Find(ssrc);
+    if (latched_mid_id) {
+      mid_id = *latched_mid_id;
     }
   }
 
-  std::string* rsid = nullptr;
+  int rsid_id = StringIdTable::kNoId;
   if (has_rsid) {
-    rsid_by_ssrc_[ssrc] = packet_rsid;
-    rsid = &packet_rsid;
+    if (packet_rsid_id != StringIdTable::kNoId) {
+      rsid_by_ssrc_.Set(ssrc, packet_rsid_id);
+    } else {
+      rsid_by_ssrc_.Erase(ssrc);
+    }
+    rsid_id = packet_rsid_id;
   } else {
     // If the packet does not include an RRID/RSID header extension, check if
     // there is a latched RSID for the SSRC.
-    const auto it = rsid_by_ssrc_.find(ssrc);
-    if (it != rsid_by_ssrc_.end()) {
-      rsid = &it->second;
+    const int* latched_rsid_id = rsid_by_ssrc_.Find(ssrc);
+    if (latched_rsid_id) {
+      rsid_id = *latched_rsid_id;
     }
   }
 
@@ -219,16 +333,16 @@ RtpPacketSinkInterface* RtpDemuxer::ResolveSink(
   //                   accepted if the packet's extended sequence number is
   //                   greater than that of the last SSRC mapping update.
   //                   https://tools.ietf.org/html/rfc7941#section-4.2.6
-  if (mid != nullptr) {
-    RtpPacketSinkInterface* sink_by_mid = ResolveSinkByMid(*mid, ssrc);
+  if (mid_id != StringIdTable::kNoId) {
+    RtpPacketSinkInterface* sink_by_mid = ResolveSinkByMid(mid_id, ssrc);
     if (sink_by_mid != nullptr) {
       return sink_by_mid;
     }
 
     // RSID is scoped to a given MID if both are included.
-    if (rsid != nullptr) {
+    if (rsid_id != StringIdTable::kNoId) {
       RtpPacketSinkInterface* sink_by_mid_rsid =
-          ResolveSinkByMidRsid(*mid, *rsid, ssrc);
+          ResolveSinkByMidRsid(mid_id, rsid_id, ssrc);
       if (sink_by_mid_rsid != nullptr) {
         return sink_by_mid_rsid;
       }
@@ -241,8 +355,8 @@ RtpPacketSinkInterface* RtpDemuxer::ResolveSink(
   }
 
   // RSID can be used without MID as long as they are unique.
-  if (rsid != nullptr) {
-    RtpPacketSinkInterface* sink_by_rsid = ResolveSinkByRsid(*rsid, ssrc);
+  if (rsid_id != StringIdTable::kNoId) {
+    RtpPacketSinkInterface* sink_by_rsid = ResolveSinkByRsid(rsid_id, ssrc);
     if (sink_by_rsid != nullptr) {
       return sink_by_rsid;
     }
@@ -250,24 +364,23 @@ RtpPacketSinkInterface* RtpDemuxer::ResolveSink(
 
   // We trust signaled SSRC more than payload type which is likely to conflict
   // between streams.
-  const auto ssrc_sink_it = sink_by_ssrc_.find(ssrc);
-  if (ssrc_sink_it != sink_by_ssrc_.end()) {
-    return ssrc_sink_it->second;
+  RtpPacketSinkInterface* const* ssrc_sink = sink_by_ssrc_.Find(ssrc);
+  if (ssrc_sink) {
+    return *ssrc_sink;
   }
 
   // Legacy senders will only signal payload type, support that as last resort.
   return ResolveSinkByPayloadType(packet.PayloadType(), ssrc);
 }
 
-RtpPacketSinkInterface* RtpDemuxer::ResolveSinkByMid(const std::string& mid,
+RtpPacketSinkInterface* RtpDemuxer::ResolveSinkByMid(int mid_id,
                                                      uint32_t ssrc) {
-  const auto it = sink_by_mid_.find(mid);
-  if (it != sink_by_mid_.end()) {
-    RtpPacketSinkInterface* sink = it->second;
+  RtpPacketSinkInterface* sink = SinkByMid(mid_id);
+  if (sink != nullptr) {
     bool notify = AddSsrcSinkBinding(ssrc, sink);
     if (notify) {
       for (auto* observer : ssrc_binding_observers_) {
-        observer->OnSsrcBoundToMid(mid, ssrc);
+        observer->OnSsrcBoundToMid(mids_.Get(mid_id), ssrc);
       }
     }
     return sink;
@@ -275,20 +388,20 @@ RtpPacketSinkInterface* RtpDemuxer::ResolveSinkByMid(const std::string& mid,
   return nullptr;
 }
 
-RtpPacketSinkInterface* RtpDemuxer::ResolveSinkByMidRsid(
-    const std::string& mid,
-    const std::string& rsid,
-    uint32_t ssrc) {
-  const auto it = sink_by_mid_and_rsid_.find(std::make_pair(mid, rsid));
-  if (it != sink_by_mid_and_rsid_.end()) {
-    RtpPacketSinkInterface* sink = it->second;
-    bool notify = AddSsrcSinkBinding(ssrc, sink);
+RtpPacketSinkInterface* RtpDemuxer::ResolveSinkByMidRsid(int mid_id,
+                                                         int rsid_id,
+                                                         uint32_t ssrc) {
+  RtpPacketSinkInterface* const* sink =
+      sink_by_mid_and_rsid_.Find(MidRsidKey(mid_id, rsid_id));
+  if (sink != nullptr) {
+    bool notify = AddSsrcSinkBinding(ssrc, *sink);
     if (notify) {
       for (auto* observer : ssrc_binding_observers_) {
-        observer->OnSsrcBoundToMidRsid(mid, rsid, ssrc);
+        observer->OnSsrcBoundToMidRsid(mids_.Get(mid_id), rsids_.Get(rsid_id),
+                                       ssrc);
       }
     }
-    return sink;
+    return *sink;
   }
   return nullptr;
 }
@@ -296,15 +409,14 @@ void RtpDemuxer::RegisterRsidResolutionObserver(SsrcBindingObserver* observer) {
   RegisterSsrcBindingObserver(observer);
 }
 
-RtpPacketSinkInterface* RtpDemuxer::ResolveSinkByRsid(const std::string& rsid,
+RtpPacketSinkInterface* RtpDemuxer::ResolveSinkByRsid(int rsid_id,
                                                       uint32_t ssrc) {
-  const auto it = sink_by_rsid_.find(rsid);
-  if (it != sink_by_rsid_.end()) {
-    RtpPacketSinkInterface* sink = it->second;
+  RtpPacketSinkInterface* sink = SinkByRsid(rsid_id);
+  if (sink != nullptr) {
     bool notify = AddSsrcSinkBinding(ssrc, sink);
     if (notify) {
       for (auto* observer : ssrc_binding_observers_) {
-        observer->OnSsrcBoundToRsid(rsid, ssrc);
+        observer->OnSsrcBoundToRsid(rsids_.Get(rsid_id), ssrc);
       }
     }
     return sink;
@@ -319,20 +431,17 @@ void RtpDemuxer::DeregisterRsidResolutionObserver(
 RtpPacketSinkInterface* RtpDemuxer::ResolveSinkByPayloadType(
     uint8_t payload_type,
     uint32_t ssrc) {
-  const auto range = sinks_by_pt_.equal_range(payload_type);
-  if (range.first != range.second) {
-    auto it = range.first;
-    const auto end = range.second;
-    if (std::next(it) == end) {
-      RtpPacketSinkInterface* sink = it->second;
-      bool notify = AddSsrcSinkBinding(ssrc, sink);
-      if (notify) {
-        for (auto* observer : ssrc_binding_observers_) {
-          observer->OnSsrcBoundToPayloadType(payload_type, ssrc);
-        }
+  const std::vector<RtpPacketSinkInterface*>& sinks =
+      sinks_by_pt_[payload_type];
+  if (sinks.size() == 1) {
+    RtpPacketSinkInterface* sink = sinks[0];
+    bool notify = AddSsrcSinkBinding(ssrc, sink);
+    if (notify) {
+      for (auto* observer : ssrc_binding_observers_) {
+        observer->OnSsrcBoundToPayloadType(payload_type, ssrc);
       }
-      return sink;
     }
+    return sink;
   }
   return nullptr;
 }
@@ -346,14 +455,14 @@ bool RtpDemuxer::AddSsrcSinkBinding(uint32_t ssrc,
     return false;
   }
 
-  auto result = sink_by_ssrc_.emplace(ssrc, sink);
-  auto it = result.first;
+  auto result = sink_by_ssrc_.Emplace(ssrc, sink);
+  RtpPacketSinkInterface** bound_sink = result.first;
   bool inserted = result.second;
   if (inserted) {
     return true;
   }
-  if (it->second != sink) {
-    it->second = sink;
+  if (*bound_sink != sink) {
+    *bound_sink = sink;
     return true;
   }
   return false;
@@ -11,12 +11,13 @@
 #ifndef CALL_RTP_DEMUXER_H_
 #define CALL_RTP_DEMUXER_H_
 
-#include <map>
+#include <array>
 #include <set>
 #include <string>
-#include <utility>
 #include <vector>
 
+#include "call/rtp_demuxer_tables.h"
+
 namespace webrtc {
 
 class RtpPacketReceived;
@@ -152,46 +153,63 @@ class RtpDemuxer {
   // If the packet should be dropped, this method returns null.
   RtpPacketSinkInterface* ResolveSink(const RtpPacketReceived& packet);
 
-  // Used by the ResolveSink algorithm.
-  RtpPacketSinkInterface* ResolveSinkByMid(const std::string& mid,
-                                           uint32_t ssrc);
-  RtpPacketSinkInterface* ResolveSinkByMidRsid(const std::string& mid,
-                                               const std::string& rsid,
+  // Used by the ResolveSink algorithm. |mid_id| and |rsid_id| are ids in
+  // |mids_| and |rsids_|.
+  RtpPacketSinkInterface* ResolveSinkByMid(int mid_id, uint32_t ssrc);
+  RtpPacketSinkInterface* ResolveSinkByMidRsid(int mid_id,
+                                               int rsid_id,
                                                uint32_t ssrc);
-  RtpPacketSinkInterface* ResolveSinkByRsid(const std::string& rsid,
-                                            uint32_t ssrc);
+  RtpPacketSinkInterface* ResolveSinkByRsid(int rsid_id, uint32_t ssrc);
   RtpPacketSinkInterface* ResolveSinkByPayloadType(uint8_t payload_type,
                                                    uint32_t ssrc);
 
-  // Regenerate the known_mids_ set from information in the sink_by_mid_ and
-  // sink_by_mid_and_rsid_ maps.
-  void RefreshKnownMids();
+  // Returns the sink added for the MID or RSID, or null.
+  RtpPacketSinkInterface* SinkByMid(int mid_id) const;
+  RtpPacketSinkInterface* SinkByRsid(int rsid_id) const;
+
+  // Returns true if a sink has been added with the MID as its criteria, either
+  // alone or together with an RSID.
+  bool IsKnownMid(int mid_id) const;
+
+  static uint64_t MidRsidKey(int mid_id, int rsid_id) {
+    return (static_cast<uint64_t>(mid_id) << 32) |
+           static_cast<uint32_t>(rsid_id);
+  }
+
+  // MIDs and RSIDs are interned and referred to by id in the tables below, so
+  // that demuxing a packet neither allocates nor compares strings. MIDs are
+  // only interned when sinks are added. RSIDs are also interned when first
+  // seen in a packet, to be able to remember the SSRC they were sent with
+  // until a sink is added for them, up to |kMaxSsrcBindings| RSIDs.
+  StringIdTable mids_;
+  StringIdTable rsids_;
 
   // Map each sink by its component attributes to facilitate quick lookups.
-  // Payload Type mapping is a multimap because if two sinks register for the
-  // same payload type, both AddSinks succeed but we must know not to demux on
-  // that attribute since it is ambiguous.
+  // Payload types may be registered by several sinks, in which case both
+  // AddSinks succeed but we must know not to demux on that attribute since it
+  // is ambiguous.
   // Note: Mappings are only modified by AddSink/RemoveSink (except for
   // SSRC mapping which receives all MID, payload type, or RSID to SSRC bindings
   // discovered when demuxing packets).
-  std::map<std::string, RtpPacketSinkInterface*> sink_by_mid_;
-  std::map<uint32_t, RtpPacketSinkInterface*> sink_by_ssrc_;
-  std::multimap<uint8_t, RtpPacketSinkInterface*> sinks_by_pt_;
-  std::map<std::pair<std::string, std::string>, RtpPacketSinkInterface*>
-      sink_by_mid_and_rsid_;
-  std::map<std::string, RtpPacketSinkInterface*> sink_by_rsid_;
-
-  // Tracks all the MIDs that have been identified in added criteria. Used to
-  // determine if a packet should be dropped right away because the MID is
-  // unknown.
-  std::set<std::string> known_mids_;
+  // Indexed by MID id and RSID id, respectively.
+  std::vector<RtpPacketSinkInterface*> sink_by_mid_;
+  std::vector<RtpPacketSinkInterface*> sink_by_rsid_;
+  OpenAddressingMap<uint32_t, RtpPacketSinkInterface*> sink_by_ssrc_;
+  std::array<std::vector<RtpPacketSinkInterface*>, 256> sinks_by_pt_;
+  // Keyed by MidRsidKey().
+  OpenAddressingMap<uint64_t, RtpPacketSinkInterface*> sink_by_mid_and_rsid_;
+
+  // The number of (MID, RSID) sinks per MID id. Together with |sink_by_mid_|
+  // this determines if a packet should be dropped right away because the MID
+  // is unknown.
+  std::vector<int> num_mid_rsid_sinks_by_mid_;
 
   // Records learned mappings of MID --> SSRC and RSID --> SSRC as packets are
-  // received.
+  // received, as ids.
   // This is stored separately from the sink mappings because if a sink is
   // removed we want to still remember these associations.
-  std::map<uint32_t, std::string> mid_by_ssrc_;
-  std::map<uint32_t, std::string> rsid_by_ssrc_;
+  OpenAddressingMap<uint32_t, int> mid_by_ssrc_;
+  OpenAddressingMap<uint32_t, int> rsid_by_ssrc_;
 
   // Adds a binding from the SSRC to the given sink. Returns true if there was
   // not already a sink bound to the SSRC or if the sink replaced a different
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "call/rtp_demuxer.h"
+#include "call/rtp_packet_sink_interface.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/stringencode.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kNumSinks = 500;
+constexpr int kNumPackets = 1000000;
+constexpr uint32_t kFirstSsrc = 1000;
+constexpr int kMidExtensionId = 11;
+
+class CountingSink : public RtpPacketSinkInterface {
+ public:
+  void OnRtpPacket(const RtpPacketReceived& packet) override { ++num_packets_; }
+
+  int num_packets() const { return num_packets_; }
+
+ private:
+  int num_packets_ = 0;
+};
+
+}  // namespace
+
+// Demuxes |kNumPackets| packets over |kNumSinks| sinks, each of which is added
+// with a MID and an SSRC, as for a BUNDLE transport with many m= sections.
+// Packets either carry the MID header extension, or only the SSRC, and
+// the average CPU time per packet is reported for both.
+class RtpDemuxerPerformanceTest : public testing::TestWithParam<bool> {};
+
+TEST_P(RtpDemuxerPerformanceTest, DemuxPackets) {
+  const bool with_mid = GetParam();
+  RtpDemuxer demuxer;
+  std::vector<CountingSink> sinks(kNumSinks);
+  for (int i = 0; i < kNumSinks; ++i) {
+    RtpDemuxerCriteria criteria;
+    criteria.mid = rtc::ToString(i);
+    criteria.ssrcs.insert(kFirstSsrc + i);
+    ASSERT_TRUE(demuxer.AddSink(criteria, &sinks[i]));
+  }
+
+  RtpHeaderExtensionMap extension_map;
+  extension_map.Register<RtpMid>(kMidExtensionId);
+  std::vector<RtpPacketReceived> packets;
+  packets.reserve(kNumSinks);
+  for (int i = 0; i < kNumSinks; ++i) {
+    packets.emplace_back(&extension_map);
+    packets.back().SetPayloadType(96);
+    packets.back().SetSsrc(kFirstSsrc + i);
+    if (with_mid)
+      packets.back().SetExtension<RtpMid>(rtc::ToString(i));
+  }
+
+  const int64_t start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+  for (int i = 0; i < kNumPackets; ++i)
+    demuxer.OnRtpPacket(packets[i % kNumSinks]);
+  const int64_t elapsed_cpu_ns = rtc::GetThreadCpuTimeNanos() - start_cpu_ns;
+
+  int num_delivered = 0;
+  for (CountingSink& sink : sinks) {
+    EXPECT_EQ(kNumPackets / kNumSinks, sink.num_packets());
+    num_delivered += sink.num_packets();
+    demuxer.RemoveSink(&sink);
+  }
+  EXPECT_EQ(kNumPackets, num_delivered);
+
+  test::PrintResult("rtp_demuxer_cpu_time_per_packet", "",
+                    with_mid ? "mid_and_ssrc" : "ssrc",
+                    static_cast<double>(elapsed_cpu_ns) / kNumPackets, "ns",
+                    true);
+}
+
+INSTANTIATE_TEST_CASE_P(WithAndWithoutMid,
+                        RtpDemuxerPerformanceTest,
+                        ::testing::Bool());
+
+}  // namespace webrtc
@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/rtp_demuxer_tables.h"
+
+#include <string.h>
+
+namespace webrtc {
+
+constexpr int StringIdTable::kNoId;
+
+StringIdTable::StringIdTable() = default;
+StringIdTable::~StringIdTable() = default;
+
+int StringIdTable::Find(const char* data, size_t size) const {
+  const int* first_id = first_id_by_hash_.Find(Hash(data, size));
+  if (!first_id)
+    return kNoId;
+  for (int id = *first_id; id != kNoId; id = next_id_with_same_hash_[id]) {
+    const std::string& str = strings_[id];
+    if (str.size() == size && memcmp(str.data(), data, size) == 0)
+      return id;
+  }
+  return kNoId;
+}
+
+int StringIdTable::Intern(const char* data, size_t size) {
+  int id = Find(data, size);
+  if (id != kNoId)
+    return id;
+  id = static_cast<int>(strings_.size());
+  strings_.emplace_back(data, size);
+  std::pair<int*, bool> result =
+      first_id_by_hash_.Emplace(Hash(data, size), id);
+  if (result.second) {
+    next_id_with_same_hash_.push_back(kNoId);
+  } else {
+    next_id_with_same_hash_.push_back(*result.first);
+    *result.first = id;
+  }
+  return id;
+}
+
+uint32_t StringIdTable::Hash(const char* data, size_t size) {
+  // FNV-1a.
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<uint8_t>(data[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+}  // namespace webrtc
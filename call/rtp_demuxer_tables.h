@@ -0,0 +1,209 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef CALL_RTP_DEMUXER_TABLES_H_
+#define CALL_RTP_DEMUXER_TABLES_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+// Hash map from unsigned integer keys, such as SSRCs, to small values, used
+// by RtpDemuxer on its per packet path. Entries are stored inline in a single
+// array with open addressing and linear probing, so a lookup touches one or
+// a few adjacent cache lines and never allocates.
+template <typename Key, typename Value>
+class OpenAddressingMap {
+  static_assert(std::is_unsigned<Key>::value && sizeof(Key) <= 8,
+                "Keys must be unsigned integers");
+
+ public:
+  OpenAddressingMap() = default;
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  // Returns the value for |key|, or null if there is none.
+  Value* Find(Key key) {
+    if (slots_.empty())
+      return nullptr;
+    for (size_t i = Index(key);; i = Next(i)) {
+      Slot& slot = slots_[i];
+      if (!slot.used)
+        return nullptr;
+      if (slot.key == key)
+        return &slot.value;
+    }
+  }
+  const Value* Find(Key key) const {
+    return const_cast<OpenAddressingMap*>(this)->Find(key);
+  }
+
+  // Inserts |value| for |key| unless the key is already present. Returns the
+  // value stored for the key and whether it was inserted, like
+  // std::map::emplace().
+  std::pair<Value*, bool> Emplace(Key key, const Value& value) {
+    // Keep the load factor at or below 1/2, so that probe sequences are
+    // short.
+    if (2 * (size_ + 1) > slots_.size())
+      Grow();
+    size_t i = Index(key);
+    for (; slots_[i].used; i = Next(i)) {
+      if (slots_[i].key == key)
+        return std::make_pair(&slots_[i].value, false);
+    }
+    slots_[i].used = true;
+    slots_[i].key = key;
+    slots_[i].value = value;
+    ++size_;
+    return std::make_pair(&slots_[i].value, true);
+  }
+
+  // Sets the value for |key|, inserting it if needed.
+  void Set(Key key, const Value& value) {
+    std::pair<Value*, bool> result = Emplace(key, value);
+    if (!result.second)
+      *result.first = value;
+  }
+
+  // Returns true if |key| was present.
+  bool Erase(Key key) {
+    if (slots_.empty())
+      return false;
+    size_t i = Index(key);
+    for (; slots_[i].used; i = Next(i)) {
+      if (slots_[i].key == key) {
+        EraseSlot(i);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Erases all entries for which |predicate(key, value)| returns true, and
+  // returns the number of erased entries.
+  template <typename Predicate>
+  size_t EraseIf(Predicate predicate) {
+    std::vector<Key> keys;
+    for (const Slot& slot : slots_) {
+      if (slot.used && predicate(slot.key, slot.value))
+        keys.push_back(slot.key);
+    }
+    for (Key key : keys)
+      Erase(key);
+    return keys.size();
+  }
+
+ private:
+  struct Slot {
+    Key key = 0;
+    Value value = Value();
+    bool used = false;
+  };
+
+  static constexpr size_t kMinCapacity = 8;
+
+  size_t Index(Key key) const {
+    // Fibonacci hashing, which spreads both sequential and random keys over
+    // the table.
+    return static_cast<size_t>(
+        (static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> shift_);
+  }
+  size_t Next(size_t i) const { return (i + 1) & (slots_.size() - 1); }
+
+  void Grow() {
+    std::vector<Slot> old_slots(slots_.empty() ? kMinCapacity
+                                               : 2 * slots_.size());
+    old_slots.swap(slots_);
+    shift_ = 64;
+    for (size_t capacity = slots_.size(); capacity > 1; capacity >>= 1)
+      --shift_;
+    size_ = 0;
+    for (const Slot& slot : old_slots) {
+      if (slot.used)
+        Emplace(slot.key, slot.value);
+    }
+  }
+
+  // Erases the entry in slot |i| and moves later entries of the same probe
+  // sequence back, so that lookups never need to skip deleted slots.
+  void EraseSlot(size_t i) {
+    RTC_DCHECK(slots_[i].used);
+    size_t hole = i;
+    for (size_t j = Next(i); slots_[j].used; j = Next(j)) {
+      const size_t home = Index(slots_[j].key);
+      // The entry in |j| can move to |hole| unless its home slot lies
+      // cyclically in (hole, j].
+      const bool home_after_hole =
+          hole <= j ? (hole < home && home <= j) : (hole < home || home <= j);
+      if (!home_after_hole) {
+        slots_[hole] = slots_[j];
+        hole = j;
+      }
+    }
+    slots_[hole] = Slot();
+    --size_;
+  }
+
+  std::vector<Slot> slots_;
+  size_t size_ = 0;
+  int shift_ = 64;
+};
+
+// Assigns dense integer ids to strings, so that MIDs and RSIDs can be
+// compared and used as table indices without handling strings. Ids are never
+// released; the number of strings interned is bounded by the caller.
+class StringIdTable {
+ public:
+  static constexpr int kNoId = -1;
+
+  StringIdTable();
+  ~StringIdTable();
+
+  size_t size() const { return strings_.size(); }
+
+  // Returns the id of the string |data|, or kNoId if it hasn't been interned.
+  // Does not allocate.
+  int Find(const char* data, size_t size) const;
+  int Find(const std::string& str) const {
+    return Find(str.data(), str.size());
+  }
+
+  // Returns the id of |str|, interning it if it's new.
+  int Intern(const char* data, size_t size);
+  int Intern(const std::string& str) { return Intern(str.data(), str.size()); }
+
+  const std::string& Get(int id) const {
+    RTC_DCHECK_GE(id, 0);
+    RTC_DCHECK_LT(static_cast<size_t>(id), strings_.size());
+    return strings_[id];
+  }
+
+ private:
+  static uint32_t Hash(const char* data, size_t size);
+
+  std::vector<std::string> strings_;
+  // Ids of strings with colliding hashes are chained through
+  // |next_id_with_same_hash_|.
+  std::vector<int> next_id_with_same_hash_;
+  OpenAddressingMap<uint32_t, int> first_id_by_hash_;
+};
+
+}  // namespace webrtc
+
+#endif  // CALL_RTP_DEMUXER_TABLES_H_
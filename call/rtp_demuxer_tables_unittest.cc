@@ -0,0 +1,121 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/rtp_demuxer_tables.h"
+
+#include <map>
+#include <string>
+
+#include "rtc_base/random.h"
+#include "rtc_base/stringencode.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+TEST(OpenAddressingMapTest, EmptyMap) {
+  OpenAddressingMap<uint32_t, int> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(nullptr, map.Find(17));
+  EXPECT_FALSE(map.Erase(17));
+}
+
+TEST(OpenAddressingMapTest, EmplaceDoesNotOverwrite) {
+  OpenAddressingMap<uint32_t, int> map;
+  auto result = map.Emplace(17, 1);
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ(1, *result.first);
+
+  result = map.Emplace(17, 2);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(1, *result.first);
+  EXPECT_EQ(1u, map.size());
+
+  map.Set(17, 3);
+  ASSERT_NE(nullptr, map.Find(17));
+  EXPECT_EQ(3, *map.Find(17));
+  EXPECT_EQ(1u, map.size());
+}
+
+TEST(OpenAddressingMapTest, EraseIf) {
+  OpenAddressingMap<uint32_t, int> map;
+  for (uint32_t key = 0; key < 100; ++key)
+    map.Set(key, key % 3);
+
+  EXPECT_EQ(34u,
+            map.EraseIf([](uint32_t key, int value) { return value == 0; }));
+  EXPECT_EQ(66u, map.size());
+  for (uint32_t key = 0; key < 100; ++key)
+    EXPECT_EQ(key % 3 != 0, map.Find(key) != nullptr);
+}
+
+// Inserts and erases random keys, some of them colliding in the table, and
+// compares the contents with a std::map after each operation.
+TEST(OpenAddressingMapTest, MatchesStdMapWithRandomOperations) {
+  Random random(0x12345678);
+  OpenAddressingMap<uint32_t, uint32_t> map;
+  std::map<uint32_t, uint32_t> reference;
+  for (int i = 0; i < 20000; ++i) {
+    // Use a small key space so that erases hit existing keys and probe
+    // sequences get long.
+    const uint32_t key = random.Rand(0u, 300u) * 0x10000;
+    if (random.Rand(0, 2) == 0) {
+      EXPECT_EQ(reference.erase(key) > 0, map.Erase(key));
+    } else {
+      map.Set(key, i);
+      reference[key] = i;
+    }
+    ASSERT_EQ(reference.size(), map.size());
+  }
+  for (uint32_t key = 0; key <= 300; ++key) {
+    const uint32_t* value = map.Find(key * 0x10000);
+    auto it = reference.find(key * 0x10000);
+    ASSERT_EQ(it != reference.end(), value != nullptr);
+    if (value)
+      EXPECT_EQ(it->second, *value);
+  }
+}
+
+TEST(StringIdTableTest, InternsStrings) {
+  StringIdTable table;
+  EXPECT_EQ(StringIdTable::kNoId, table.Find("audio"));
+
+  const int audio_id = table.Intern("audio");
+  const int video_id = table.Intern("video");
+  EXPECT_NE(StringIdTable::kNoId, audio_id);
+  EXPECT_NE(audio_id, video_id);
+  EXPECT_EQ(audio_id, table.Intern("audio"));
+  EXPECT_EQ(2u, table.size());
+
+  EXPECT_EQ(audio_id, table.Find("audio"));
+  EXPECT_EQ(video_id, table.Find("video"));
+  EXPECT_EQ(StringIdTable::kNoId, table.Find("vide"));
+  EXPECT_EQ("audio", table.Get(audio_id));
+  EXPECT_EQ("video", table.Get(video_id));
+}
+
+TEST(StringIdTableTest, FindsByPointerAndSize) {
+  StringIdTable table;
+  const int id = table.Intern("mid");
+  const char kBuffer[] = "midx";
+  EXPECT_EQ(id, table.Find(kBuffer, 3));
+  EXPECT_EQ(StringIdTable::kNoId, table.Find(kBuffer, 4));
+}
+
+TEST(StringIdTableTest, ManyStrings) {
+  StringIdTable table;
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_EQ(i, table.Intern(rtc::ToString(i)));
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(i, table.Find(rtc::ToString(i)));
+    EXPECT_EQ(rtc::ToString(i), table.Get(i));
+  }
+}
+
+}  // namespace webrtc
@@ -12,14 +12,13 @@
 #define COMMON_AUDIO_RESAMPLER_INCLUDE_PUSH_RESAMPLER_H_
 
 #include <memory>
-#include <vector>
 
 namespace webrtc {
 
 class PushSincResampler;
 
-// Wraps PushSincResampler to provide stereo support.
-// TODO(ajm): add support for an arbitrary number of channels.
+// Wraps PushSincResampler to resample interleaved audio with any number of
+// channels, which are all resampled together.
 template <typename T>
 class PushResampler {
  public:
@@ -41,13 +40,7 @@ class PushResampler {
   int dst_sample_rate_hz_;
   size_t num_channels_;
 
-  struct ChannelResampler {
-    std::unique_ptr<PushSincResampler> resampler;
-    std::vector<T> source;
-    std::vector<T> destination;
-  };
-
-  std::vector<ChannelResampler> channel_resamplers_;
+  std::unique_ptr<PushSincResampler> resampler_;
 };
 }  // namespace webrtc
 
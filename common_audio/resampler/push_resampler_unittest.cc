@@ -9,6 +9,13 @@
  */
 
 #include "common_audio/resampler/include/push_resampler.h"
+
+#include <math.h>
+
+#include <memory>
+#include <vector>
+
+#include "common_audio/resampler/push_sinc_resampler.h"
 #include "rtc_base/checks.h"  // RTC_DCHECK_IS_ON
 #include "test/gtest.h"
 
@@ -49,4 +56,52 @@ TEST(PushResamplerTest, VerifiesBadInputParameters3) {
 #endif
 #endif
 
+// Ensure the channels of interleaved audio are resampled as if each was
+// resampled on its own.
+TEST(PushResamplerTest, MatchesResamplingEachChannel) {
+  const size_t kNumChannels = 2;
+  const int kDstRateHz = 48000;
+  const size_t kDstFrames = kDstRateHz / 100;
+  for (int src_rate_hz : {16000, 44100, 96000}) {
+    const size_t src_frames = src_rate_hz / 100;
+    PushResampler<float> resampler;
+    ASSERT_EQ(0, resampler.InitializeIfNeeded(src_rate_hz, kDstRateHz,
+                                              kNumChannels));
+    std::vector<std::unique_ptr<PushSincResampler>> mono_resamplers;
+    for (size_t ch = 0; ch < kNumChannels; ++ch) {
+      mono_resamplers.emplace_back(
+          new PushSincResampler(src_frames, kDstFrames));
+    }
+
+    std::vector<float> src(src_frames * kNumChannels);
+    std::vector<float> dst(kDstFrames * kNumChannels);
+    std::vector<float> channel_src(src_frames);
+    std::vector<float> channel_dst(kDstFrames);
+    size_t position = 0;
+    for (int block = 0; block < 3; ++block) {
+      for (size_t i = 0; i < src_frames; ++i, ++position) {
+        for (size_t ch = 0; ch < kNumChannels; ++ch) {
+          src[i * kNumChannels + ch] =
+              static_cast<float>(10000 * sin(0.01 * (ch + 1) * position));
+        }
+      }
+      ASSERT_EQ(static_cast<int>(dst.size()),
+                resampler.Resample(src.data(), src.size(), dst.data(),
+                                   dst.size()));
+
+      for (size_t ch = 0; ch < kNumChannels; ++ch) {
+        for (size_t i = 0; i < src_frames; ++i) {
+          channel_src[i] = src[i * kNumChannels + ch];
+        }
+        mono_resamplers[ch]->Resample(channel_src.data(), src_frames,
+                                      channel_dst.data(), kDstFrames);
+        for (size_t i = 0; i < kDstFrames; ++i) {
+          ASSERT_FLOAT_EQ(channel_dst[i], dst[i * kNumChannels + ch])
+              << src_rate_hz << " Hz, channel " << ch << ", frame " << i;
+        }
+      }
+    }
+  }
+}
+
 }  // namespace webrtc
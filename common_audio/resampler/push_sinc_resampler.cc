@@ -19,12 +19,19 @@ namespace webrtc {
 
 PushSincResampler::PushSincResampler(size_t source_frames,
                                      size_t destination_frames)
+    : PushSincResampler(source_frames, destination_frames, 1) {}
+
+PushSincResampler::PushSincResampler(size_t source_frames,
+                                     size_t destination_frames,
+                                     size_t num_channels)
     : resampler_(new SincResampler(source_frames * 1.0 / destination_frames,
                                    source_frames,
-                                   this)),
+                                   this,
+                                   num_channels)),
       source_ptr_(nullptr),
       source_ptr_int_(nullptr),
       destination_frames_(destination_frames),
+      num_channels_(num_channels),
       first_pass_(true),
       source_available_(0) {}
 
@@ -34,27 +41,28 @@ size_t PushSincResampler::Resample(const int16_t* source,
                                    size_t source_length,
                                    int16_t* destination,
                                    size_t destination_capacity) {
+  const size_t destination_length = destination_frames_ * num_channels_;
   if (!float_buffer_.get())
-    float_buffer_.reset(new float[destination_frames_]);
+    float_buffer_.reset(new float[destination_length]);
 
   source_ptr_int_ = source;
   // Pass nullptr as the float source to have Run() read from the int16 source.
-  Resample(nullptr, source_length, float_buffer_.get(), destination_frames_);
-  FloatS16ToS16(float_buffer_.get(), destination_frames_, destination);
+  Resample(nullptr, source_length, float_buffer_.get(), destination_length);
+  FloatS16ToS16(float_buffer_.get(), destination_length, destination);
   source_ptr_int_ = nullptr;
-  return destination_frames_;
+  return destination_length;
 }
 
 size_t PushSincResampler::Resample(const float* source,
                                    size_t source_length,
                                    float* destination,
                                    size_t destination_capacity) {
-  RTC_CHECK_EQ(source_length, resampler_->request_frames());
-  RTC_CHECK_GE(destination_capacity, destination_frames_);
+  RTC_CHECK_EQ(source_length, resampler_->request_frames() * num_channels_);
+  RTC_CHECK_GE(destination_capacity, destination_frames_ * num_channels_);
   // Cache the source pointer. Calling Resample() will immediately trigger
   // the Run() callback whereupon we provide the cached value.
   source_ptr_ = source;
-  source_available_ = source_length;
+  source_available_ = resampler_->request_frames();
 
   // On the first pass, we call Resample() twice. During the first call, we
   // provide dummy input and discard the output. This is done to prime the
@@ -74,7 +82,7 @@ size_t PushSincResampler::Resample(const float* source,
 
   resampler_->Resample(destination_frames_, destination);
   source_ptr_ = nullptr;
-  return destination_frames_;
+  return destination_frames_ * num_channels_;
 }
 
 void PushSincResampler::Run(size_t frames, float* destination) {
@@ -99,4 +107,29 @@ void PushSincResampler::Run(size_t frames, float* destination) {
   source_available_ -= frames;
 }
 
+void PushSincResampler::RunMultiChannel(size_t frames,
+                                        float* const* destinations) {
+  // Same as Run(), but deinterleaves the source into the channels.
+  RTC_CHECK_EQ(source_available_, frames);
+
+  if (first_pass_) {
+    for (size_t ch = 0; ch < num_channels_; ++ch)
+      std::memset(destinations[ch], 0, frames * sizeof(*destinations[ch]));
+    first_pass_ = false;
+    return;
+  }
+
+  if (source_ptr_) {
+    Deinterleave(source_ptr_, frames, num_channels_, destinations);
+  } else {
+    for (size_t i = 0; i < frames; ++i) {
+      for (size_t ch = 0; ch < num_channels_; ++ch) {
+        destinations[ch][i] =
+            static_cast<float>(source_ptr_int_[i * num_channels_ + ch]);
+      }
+    }
+  }
+  source_available_ -= frames;
+}
+
 }  // namespace webrtc
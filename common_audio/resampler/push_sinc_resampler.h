@@ -30,13 +30,20 @@ class PushSincResampler : public SincResamplerCallback {
   // must correspond to the same time duration (typically 10 ms) as the sample
   // ratio is inferred from them.
   PushSincResampler(size_t source_frames, size_t destination_frames);
+  // Same as above for interleaved audio with |num_channels| channels. The
+  // channels are resampled together, straight from and to the interleaved
+  // buffers.
+  PushSincResampler(size_t source_frames,
+                    size_t destination_frames,
+                    size_t num_channels);
   ~PushSincResampler() override;
 
   // Perform the resampling. |source_frames| must always equal the
-  // |source_frames| provided at construction. |destination_capacity| must be
-  // at least as large as |destination_frames|. Returns the number of samples
-  // provided in destination (for convenience, since this will always be equal
-  // to |destination_frames|).
+  // |source_frames| provided at construction times the number of channels.
+  // |destination_capacity| must be at least as large as |destination_frames|
+  // times the number of channels. Returns the number of samples provided in
+  // destination (for convenience, since this will always be equal to
+  // |destination_frames| times the number of channels).
   size_t Resample(const int16_t* source,
                   size_t source_frames,
                   int16_t* destination,
@@ -55,6 +62,7 @@ class PushSincResampler : public SincResamplerCallback {
  protected:
   // Implements SincResamplerCallback.
   void Run(size_t frames, float* destination) override;
+  void RunMultiChannel(size_t frames, float* const* destinations) override;
 
  private:
   friend class PushSincResamplerTest;
@@ -65,6 +73,7 @@ class PushSincResampler : public SincResamplerCallback {
   const float* source_ptr_;
   const int16_t* source_ptr_int_;
   const size_t destination_frames_;
+  const size_t num_channels_;
 
   // True on the first call to Resample(), to prime the SincResampler buffer.
   bool first_pass_;
@@ -0,0 +1,177 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common_audio/include/audio_util.h"
+#include "common_audio/resampler/include/push_resampler.h"
+#include "common_audio/resampler/push_sinc_resampler.h"
+#include "common_audio/resampler/sinc_resampler.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kDstRateHz = 48000;
+constexpr int kNumIterations = 2000;
+
+// Returns the CPU time in us per call of |process|.
+template <typename Process>
+double MeasureUs(Process process, int num_iterations = kNumIterations) {
+  process();
+  const int64_t start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+  for (int i = 0; i < num_iterations; ++i) {
+    process();
+  }
+  return static_cast<double>(rtc::GetThreadCpuTimeNanos() - start_cpu_ns) /
+         num_iterations / 1000.0;
+}
+
+std::string RatesToString(int src_rate_hz, size_t num_channels) {
+  return std::to_string(src_rate_hz / 1000) + "kHz_to_" +
+         std::to_string(kDstRateHz / 1000) + "kHz_" +
+         std::to_string(num_channels) + "ch";
+}
+
+// Resamples each channel on its own, with the deinterleaving and
+// interleaving copies that PushResampler used to make.
+class PerChannelResampler {
+ public:
+  PerChannelResampler(int src_rate_hz, size_t num_channels)
+      : src_frames_(src_rate_hz / 100),
+        dst_frames_(kDstRateHz / 100),
+        sources_(num_channels, std::vector<int16_t>(src_frames_)),
+        destinations_(num_channels, std::vector<int16_t>(dst_frames_)) {
+    for (size_t ch = 0; ch < num_channels; ++ch) {
+      resamplers_.emplace_back(
+          new PushSincResampler(src_frames_, dst_frames_));
+      source_pointers_.push_back(sources_[ch].data());
+      destination_pointers_.push_back(destinations_[ch].data());
+    }
+  }
+
+  void Resample(const int16_t* src, int16_t* dst) {
+    const size_t num_channels = resamplers_.size();
+    Deinterleave(src, src_frames_, num_channels, source_pointers_.data());
+    for (size_t ch = 0; ch < num_channels; ++ch) {
+      resamplers_[ch]->Resample(sources_[ch].data(), src_frames_,
+                                destinations_[ch].data(), dst_frames_);
+    }
+    Interleave(destination_pointers_.data(), dst_frames_, num_channels, dst);
+  }
+
+ private:
+  const size_t src_frames_;
+  const size_t dst_frames_;
+  std::vector<std::unique_ptr<PushSincResampler>> resamplers_;
+  std::vector<std::vector<int16_t>> sources_;
+  std::vector<std::vector<int16_t>> destinations_;
+  std::vector<int16_t*> source_pointers_;
+  std::vector<int16_t*> destination_pointers_;
+};
+
+// Provides the same block of random samples on each call.
+class RandomSource : public SincResamplerCallback {
+ public:
+  explicit RandomSource(size_t frames) : samples_(frames) {
+    Random random_generator(42U);
+    for (auto& sample : samples_) {
+      sample = static_cast<float>(random_generator.Rand(-10000, 10000));
+    }
+  }
+
+  void Run(size_t frames, float* destination) override {
+    RTC_CHECK_LE(frames, samples_.size());
+    std::copy(samples_.begin(), samples_.begin() + frames, destination);
+  }
+
+ private:
+  std::vector<float> samples_;
+};
+
+}  // namespace
+
+// Measures the resampling of 10 ms of interleaved audio to 48 kHz with
+// PushResampler, which resamples all the channels together, and with one
+// resampler per channel.
+TEST(ResamplerPerformanceTest, PushResampler) {
+  for (int src_rate_hz : {16000, 32000, 44100, 96000}) {
+    for (size_t num_channels : {1, 2, 6}) {
+      Random random_generator(42U);
+      std::vector<int16_t> src(src_rate_hz / 100 * num_channels);
+      for (auto& sample : src) {
+        sample = random_generator.Rand(-10000, 10000);
+      }
+      std::vector<int16_t> dst(kDstRateHz / 100 * num_channels);
+
+      PushResampler<int16_t> resampler;
+      resampler.InitializeIfNeeded(src_rate_hz, kDstRateHz, num_channels);
+      test::PrintResult(
+          "push_resampler_cpu_time", "", RatesToString(src_rate_hz,
+                                                       num_channels),
+          MeasureUs([&] {
+            resampler.Resample(src.data(), src.size(), dst.data(), dst.size());
+          }),
+          "us", false);
+
+      PerChannelResampler per_channel_resampler(src_rate_hz, num_channels);
+      test::PrintResult(
+          "per_channel_resampler_cpu_time", "",
+          RatesToString(src_rate_hz, num_channels),
+          MeasureUs([&] {
+            per_channel_resampler.Resample(src.data(), dst.data());
+          }),
+          "us", false);
+    }
+  }
+}
+
+// Measures SincResampler per 48 kHz output frame with the precomputed
+// polyphase kernels and with the kernels interpolated for every frame, which
+// is what happens for ratios that need too many phases.
+TEST(ResamplerPerformanceTest, SincResamplerKernels) {
+  const size_t kFrames = kDstRateHz / 100;
+  for (int src_rate_hz : {16000, 44100}) {
+    const double ratio = static_cast<double>(src_rate_hz) / kDstRateHz;
+    RandomSource source(SincResampler::kDefaultRequestSize);
+    std::vector<float> dst(kFrames);
+
+    SincResampler polyphase_resampler(
+        ratio, SincResampler::kDefaultRequestSize, &source);
+    ASSERT_GT(polyphase_resampler.polyphase_phases_for_testing(), 0u);
+    test::PrintResult(
+        "sinc_resampler_polyphase_cpu_time", "",
+        RatesToString(src_rate_hz, 1),
+        MeasureUs([&] { polyphase_resampler.Resample(kFrames, dst.data()); }) *
+            1000.0 / kFrames,
+        "ns", false);
+
+    // A tiny deviation from the ratio disables the polyphase kernels.
+    SincResampler interpolated_resampler(
+        ratio * (1 + 1e-8), SincResampler::kDefaultRequestSize, &source);
+    ASSERT_EQ(0u, interpolated_resampler.polyphase_phases_for_testing());
+    test::PrintResult(
+        "sinc_resampler_interpolated_cpu_time", "",
+        RatesToString(src_rate_hz, 1),
+        MeasureUs([&] {
+          interpolated_resampler.Resample(kFrames, dst.data());
+        }) * 1000.0 / kFrames,
+        "ns", false);
+  }
+}
+
+}  // namespace webrtc
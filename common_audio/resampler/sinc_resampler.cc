@@ -119,57 +119,84 @@ double SincScaleFactor(double io_ratio) {
 }  // namespace
 
 const size_t SincResampler::kKernelSize;
+const size_t SincResampler::kMaxPolyphasePhases;
+
+void SincResamplerCallback::RunMultiChannel(size_t frames,
+                                            float* const* destinations) {
+  RTC_NOTREACHED() << "Multichannel SincResampler without RunMultiChannel()";
+}
 
 // If we know the minimum architecture at compile time, avoid CPU detection.
 #if defined(WEBRTC_ARCH_X86_FAMILY)
-#if defined(__SSE2__)
-#define CONVOLVE_FUNC Convolve_SSE
-void SincResampler::InitializeCPUSpecificFeatures() {}
-#else
-// x86 CPU detection required.  Function will be set by
-// InitializeCPUSpecificFeatures().
-// TODO(dalecurtis): Once Chrome moves to an SSE baseline this can be removed.
+// x86 CPU detection required, as AVX2 is used when available.  Functions will
+// be set by InitializeCPUSpecificFeatures().
 #define CONVOLVE_FUNC convolve_proc_
+#define DOT_PRODUCT_FUNC dot_product_proc_
 
 void SincResampler::InitializeCPUSpecificFeatures() {
-  convolve_proc_ = WebRtc_GetCPUInfo(kSSE2) ? Convolve_SSE : Convolve_C;
+  if (WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3)) {
+    convolve_proc_ = Convolve_AVX2;
+    dot_product_proc_ = DotProduct_AVX2;
+  } else if (WebRtc_GetCPUInfo(kSSE2)) {
+    convolve_proc_ = Convolve_SSE;
+    dot_product_proc_ = DotProduct_SSE;
+  } else {
+    convolve_proc_ = Convolve_C;
+    dot_product_proc_ = DotProduct_C;
+  }
 }
-#endif
 #elif defined(WEBRTC_HAS_NEON)
 #define CONVOLVE_FUNC Convolve_NEON
+#define DOT_PRODUCT_FUNC DotProduct_NEON
 void SincResampler::InitializeCPUSpecificFeatures() {}
 #else
 // Unknown architecture.
 #define CONVOLVE_FUNC Convolve_C
+#define DOT_PRODUCT_FUNC DotProduct_C
 void SincResampler::InitializeCPUSpecificFeatures() {}
 #endif
 
 SincResampler::SincResampler(double io_sample_rate_ratio,
                              size_t request_frames,
                              SincResamplerCallback* read_cb)
+    : SincResampler(io_sample_rate_ratio, request_frames, read_cb, 1) {}
+
+SincResampler::SincResampler(double io_sample_rate_ratio,
+                             size_t request_frames,
+                             SincResamplerCallback* read_cb,
+                             size_t num_channels)
     : io_sample_rate_ratio_(io_sample_rate_ratio),
+      polyphase_phases_(0),
+      polyphase_step_(0),
+      polyphase_source_idx_(0),
       read_cb_(read_cb),
       request_frames_(request_frames),
+      num_channels_(num_channels),
       input_buffer_size_(request_frames_ + kKernelSize),
-      // Create input buffers with a 16-byte alignment for SSE optimizations.
+      channel_stride_((input_buffer_size_ + 7) & ~static_cast<size_t>(7)),
+      // Create input buffers with a 32-byte alignment for SIMD optimizations.
       kernel_storage_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * kKernelStorageSize, 16))),
+          AlignedMalloc(sizeof(float) * kKernelStorageSize, 32))),
       kernel_pre_sinc_storage_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * kKernelStorageSize, 16))),
+          AlignedMalloc(sizeof(float) * kKernelStorageSize, 32))),
       kernel_window_storage_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * kKernelStorageSize, 16))),
+          AlignedMalloc(sizeof(float) * kKernelStorageSize, 32))),
       input_buffer_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * input_buffer_size_, 16))),
-#if defined(WEBRTC_ARCH_X86_FAMILY) && !defined(__SSE2__)
+          AlignedMalloc(sizeof(float) * channel_stride_ * num_channels, 32))),
+      channel_destinations_(num_channels),
+#if defined(WEBRTC_ARCH_X86_FAMILY)
       convolve_proc_(nullptr),
+      dot_product_proc_(nullptr),
 #endif
       r1_(input_buffer_.get()),
       r2_(input_buffer_.get() + kKernelSize / 2) {
-#if defined(WEBRTC_ARCH_X86_FAMILY) && !defined(__SSE2__)
+#if defined(WEBRTC_ARCH_X86_FAMILY)
   InitializeCPUSpecificFeatures();
   RTC_DCHECK(convolve_proc_);
+  RTC_DCHECK(dot_product_proc_);
 #endif
   RTC_DCHECK_GT(request_frames_, 0);
+  RTC_DCHECK_GT(num_channels_, 0);
   Flush();
   RTC_DCHECK_GT(block_size_, kKernelSize);
 
@@ -181,6 +208,7 @@ SincResampler::SincResampler(double io_sample_rate_ratio,
          sizeof(*kernel_window_storage_.get()) * kKernelStorageSize);
 
   InitializeKernel();
+  InitializePolyphase();
 }
 
 SincResampler::~SincResampler() {}
@@ -238,6 +266,57 @@ void SincResampler::InitializeKernel() {
   }
 }
 
+void SincResampler::InitializePolyphase() {
+  // The resampling position, to be carried over to the new representation.
+  const double virtual_source_idx =
+      polyphase_phases_ > 0
+          ? static_cast<double>(polyphase_source_idx_) / polyphase_phases_
+          : virtual_source_idx_;
+
+  // Look for the smallest number of phases which makes the ratio a whole
+  // number of phases per output sample.
+  polyphase_phases_ = 0;
+  for (size_t phases = 1; phases <= kMaxPolyphasePhases; ++phases) {
+    const double step = io_sample_rate_ratio_ * phases;
+    const double rounded_step = floor(step + 0.5);
+    if (rounded_step >= 1.0 && fabs(step - rounded_step) < 1e-9) {
+      polyphase_phases_ = phases;
+      polyphase_step_ = static_cast<size_t>(rounded_step);
+      break;
+    }
+  }
+
+  if (polyphase_phases_ == 0) {
+    virtual_source_idx_ = virtual_source_idx;
+    return;
+  }
+  polyphase_source_idx_ =
+      static_cast<size_t>(virtual_source_idx * polyphase_phases_ + 0.5);
+
+  if (!polyphase_kernel_storage_) {
+    polyphase_kernel_storage_.reset(static_cast<float*>(AlignedMalloc(
+        sizeof(float) * kKernelSize * kMaxPolyphasePhases, 32)));
+  }
+
+  // Interpolate the kernel for each phase from the two kernel offsets which
+  // straddle it, exactly as Convolve() interpolates their "convolutions".
+  for (size_t phase = 0; phase < polyphase_phases_; ++phase) {
+    const double virtual_offset_idx =
+        static_cast<double>(phase) / polyphase_phases_ * kKernelOffsetCount;
+    const int offset_idx = static_cast<int>(virtual_offset_idx);
+    const double kernel_interpolation_factor = virtual_offset_idx - offset_idx;
+
+    const float* const k1 = kernel_storage_.get() + offset_idx * kKernelSize;
+    const float* const k2 = k1 + kKernelSize;
+    float* const kernel = polyphase_kernel_storage_.get() + phase * kKernelSize;
+    for (size_t i = 0; i < kKernelSize; ++i) {
+      kernel[i] =
+          static_cast<float>((1.0 - kernel_interpolation_factor) * k1[i] +
+                             kernel_interpolation_factor * k2[i]);
+    }
+  }
+}
+
 void SincResampler::SetRatio(double io_sample_rate_ratio) {
   if (fabs(io_sample_rate_ratio_ - io_sample_rate_ratio) <
       std::numeric_limits<double>::epsilon()) {
@@ -261,6 +340,19 @@ void SincResampler::SetRatio(double io_sample_rate_ratio) {
                         : (sin(sinc_scale_factor * pre_sinc) / pre_sinc)));
     }
   }
+
+  InitializePolyphase();
+}
+
+void SincResampler::RequestInput() {
+  if (num_channels_ == 1) {
+    read_cb_->Run(request_frames_, r0_);
+    return;
+  }
+  for (size_t ch = 0; ch < num_channels_; ++ch) {
+    channel_destinations_[ch] = r0_ + ch * channel_stride_;
+  }
+  read_cb_->RunMultiChannel(request_frames_, channel_destinations_.data());
 }
 
 void SincResampler::Resample(size_t frames, float* destination) {
@@ -268,7 +360,7 @@ void SincResampler::Resample(size_t frames, float* destination) {
 
   // Step (1) -- Prime the input buffer at the start of the input stream.
   if (!buffer_primed_ && remaining_frames) {
-    read_cb_->Run(request_frames_, r0_);
+    RequestInput();
     buffer_primed_ = true;
   }
 
@@ -277,68 +369,121 @@ void SincResampler::Resample(size_t frames, float* destination) {
   const double current_io_ratio = io_sample_rate_ratio_;
   const float* const kernel_ptr = kernel_storage_.get();
   while (remaining_frames) {
-    // |i| may be negative if the last Resample() call ended on an iteration
-    // that put |virtual_source_idx_| over the limit.
-    //
-    // Note: The loop construct here can severely impact performance on ARM
-    // or when built with clang.  See https://codereview.chromium.org/18566009/
-    for (int i = static_cast<int>(
-             ceil((block_size_ - virtual_source_idx_) / current_io_ratio));
-         i > 0; --i) {
-      RTC_DCHECK_LT(virtual_source_idx_, block_size_);
-
-      // |virtual_source_idx_| lies in between two kernel offsets so figure out
-      // what they are.
-      const int source_idx = static_cast<int>(virtual_source_idx_);
-      const double subsample_remainder = virtual_source_idx_ - source_idx;
-
-      const double virtual_offset_idx =
-          subsample_remainder * kKernelOffsetCount;
-      const int offset_idx = static_cast<int>(virtual_offset_idx);
-
-      // We'll compute "convolutions" for the two kernels which straddle
-      // |virtual_source_idx_|.
-      const float* const k1 = kernel_ptr + offset_idx * kKernelSize;
-      const float* const k2 = k1 + kKernelSize;
-
-      // Ensure |k1|, |k2| are 16-byte aligned for SIMD usage.  Should always be
-      // true so long as kKernelSize is a multiple of 16.
-      RTC_DCHECK_EQ(0, reinterpret_cast<uintptr_t>(k1) % 16);
-      RTC_DCHECK_EQ(0, reinterpret_cast<uintptr_t>(k2) % 16);
-
-      // Initialize input pointer based on quantized |virtual_source_idx_|.
-      const float* const input_ptr = r1_ + source_idx;
-
-      // Figure out how much to weight each kernel's "convolution".
-      const double kernel_interpolation_factor =
-          virtual_offset_idx - offset_idx;
-      *destination++ =
-          CONVOLVE_FUNC(input_ptr, k1, k2, kernel_interpolation_factor);
-
-      // Advance the virtual index.
-      virtual_source_idx_ += current_io_ratio;
-
-      if (!--remaining_frames)
+    if (polyphase_phases_ > 0) {
+      const size_t generated_frames =
+          ResamplePolyphase(remaining_frames, destination);
+      destination += generated_frames * num_channels_;
+      remaining_frames -= generated_frames;
+      if (!remaining_frames)
         return;
-    }
 
-    // Wrap back around to the start.
-    virtual_source_idx_ -= block_size_;
+      // Wrap back around to the start.
+      polyphase_source_idx_ -= block_size_ * polyphase_phases_;
+    } else {
+      // |i| may be negative if the last Resample() call ended on an iteration
+      // that put |virtual_source_idx_| over the limit.
+      //
+      // Note: The loop construct here can severely impact performance on ARM
+      // or when built with clang.
+      // See https://codereview.chromium.org/18566009/
+      for (int i = static_cast<int>(
+               ceil((block_size_ - virtual_source_idx_) / current_io_ratio));
+           i > 0; --i) {
+        RTC_DCHECK_LT(virtual_source_idx_, block_size_);
+
+        // |virtual_source_idx_| lies in between two kernel offsets so figure
+        // out what they are.
+        const int source_idx = static_cast<int>(virtual_source_idx_);
+        const double subsample_remainder = virtual_source_idx_ - source_idx;
+
+        const double virtual_offset_idx =
+            subsample_remainder * kKernelOffsetCount;
+        const int offset_idx = static_cast<int>(virtual_offset_idx);
+
+        // We'll compute "convolutions" for the two kernels which straddle
+        // |virtual_source_idx_|.
+        const float* const k1 = kernel_ptr + offset_idx * kKernelSize;
+        const float* const k2 = k1 + kKernelSize;
+
+        // Ensure |k1|, |k2| are 32-byte aligned for SIMD usage.  Should always
+        // be true so long as kKernelSize is a multiple of 32.
+        RTC_DCHECK_EQ(0, reinterpret_cast<uintptr_t>(k1) % 32);
+        RTC_DCHECK_EQ(0, reinterpret_cast<uintptr_t>(k2) % 32);
+
+        // Initialize input pointer based on quantized |virtual_source_idx_|.
+        const float* input_ptr = r1_ + source_idx;
+
+        // Figure out how much to weight each kernel's "convolution".
+        const double kernel_interpolation_factor =
+            virtual_offset_idx - offset_idx;
+        for (size_t ch = 0; ch < num_channels_; ++ch) {
+          *destination++ =
+              CONVOLVE_FUNC(input_ptr, k1, k2, kernel_interpolation_factor);
+          input_ptr += channel_stride_;
+        }
+
+        // Advance the virtual index.
+        virtual_source_idx_ += current_io_ratio;
+
+        if (!--remaining_frames)
+          return;
+      }
+
+      // Wrap back around to the start.
+      virtual_source_idx_ -= block_size_;
+    }
 
     // Step (3) -- Copy r3_, r4_ to r1_, r2_.
     // This wraps the last input frames back to the start of the buffer.
-    memcpy(r1_, r3_, sizeof(*input_buffer_.get()) * kKernelSize);
+    for (size_t ch = 0; ch < num_channels_; ++ch) {
+      memcpy(r1_ + ch * channel_stride_, r3_ + ch * channel_stride_,
+             sizeof(*input_buffer_.get()) * kKernelSize);
+    }
 
     // Step (4) -- Reinitialize regions if necessary.
     if (r0_ == r2_)
       UpdateRegions(true);
 
     // Step (5) -- Refresh the buffer with more input.
-    read_cb_->Run(request_frames_, r0_);
+    RequestInput();
   }
 }
 
+size_t SincResampler::ResamplePolyphase(size_t frames, float* destination) {
+  // Split the position into a whole source sample and a phase, and advance
+  // both incrementally to avoid a division per output sample.
+  const size_t end_idx = block_size_ * polyphase_phases_;
+  const size_t source_step = polyphase_step_ / polyphase_phases_;
+  const size_t phase_step = polyphase_step_ % polyphase_phases_;
+  size_t source_idx = polyphase_source_idx_ / polyphase_phases_;
+  size_t phase = polyphase_source_idx_ % polyphase_phases_;
+
+  const float* const kernel_ptr = polyphase_kernel_storage_.get();
+  size_t generated_frames = 0;
+  while (generated_frames < frames && polyphase_source_idx_ < end_idx) {
+    const float* const k = kernel_ptr + phase * kKernelSize;
+    RTC_DCHECK_EQ(0, reinterpret_cast<uintptr_t>(k) % 32);
+
+    const float* input_ptr = r1_ + source_idx;
+    for (size_t ch = 0; ch < num_channels_; ++ch) {
+      *destination++ = DOT_PRODUCT_FUNC(input_ptr, k);
+      input_ptr += channel_stride_;
+    }
+
+    polyphase_source_idx_ += polyphase_step_;
+    source_idx += source_step;
+    phase += phase_step;
+    if (phase >= polyphase_phases_) {
+      phase -= polyphase_phases_;
+      ++source_idx;
+    }
+    ++generated_frames;
+  }
+  return generated_frames;
+}
+
 #undef CONVOLVE_FUNC
+#undef DOT_PRODUCT_FUNC
 
 size_t SincResampler::ChunkSize() const {
   return static_cast<size_t>(block_size_ / io_sample_rate_ratio_);
@@ -346,9 +491,10 @@ size_t SincResampler::ChunkSize() const {
 
 void SincResampler::Flush() {
   virtual_source_idx_ = 0;
+  polyphase_source_idx_ = 0;
   buffer_primed_ = false;
   memset(input_buffer_.get(), 0,
-         sizeof(*input_buffer_.get()) * input_buffer_size_);
+         sizeof(*input_buffer_.get()) * channel_stride_ * num_channels_);
   UpdateRegions(false);
 }
 
@@ -372,4 +518,13 @@ float SincResampler::Convolve_C(const float* input_ptr,
                             kernel_interpolation_factor * sum2);
 }
 
+float SincResampler::DotProduct_C(const float* input_ptr, const float* k) {
+  float sum = 0;
+  size_t n = kKernelSize;
+  while (n--) {
+    sum += *input_ptr++ * *k++;
+  }
+  return sum;
+}
+
 }  // namespace webrtc
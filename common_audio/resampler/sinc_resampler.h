@@ -16,6 +16,7 @@
 
 #include <stddef.h>
 #include <memory>
+#include <vector>
 
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/gtest_prod_util.h"
@@ -31,9 +32,23 @@ class SincResamplerCallback {
  public:
   virtual ~SincResamplerCallback() {}
   virtual void Run(size_t frames, float* destination) = 0;
+
+  // Called instead of Run() by a SincResampler with more than one channel.
+  // Expects |frames| of each channel to be rendered into the corresponding
+  // entry of |destinations|.
+  virtual void RunMultiChannel(size_t frames, float* const* destinations);
 };
 
-// SincResampler is a high-quality single-channel sample-rate converter.
+// SincResampler is a high-quality sample-rate converter. By default it
+// converts a single channel; with more channels, the channels share the
+// kernels and the resampling position, and the output is interleaved.
+//
+// When the io sample rate ratio is a fraction with a denominator of at most
+// kMaxPolyphasePhases, such as 1/3 for 16 -> 48 kHz or 147/160 for
+// 44.1 -> 48 kHz, the output samples only ever fall on that many sub-sample
+// positions. The resampler then precomputes one kernel per position and
+// tracks its position exactly, instead of interpolating between two kernels
+// for every output sample.
 class SincResampler {
  public:
   // The kernel size can be adjusted for quality (higher is better) at the
@@ -52,6 +67,10 @@ class SincResampler {
   static const size_t kKernelStorageSize =
       kKernelSize * (kKernelOffsetCount + 1);
 
+  // The largest number of precomputed polyphase kernels. Ratios which need
+  // more fall back to interpolating between the kernel offsets.
+  static const size_t kMaxPolyphasePhases = 160;
+
   // Constructs a SincResampler with the specified |read_cb|, which is used to
   // acquire audio data for resampling.  |io_sample_rate_ratio| is the ratio
   // of input / output sample rates.  |request_frames| controls the size in
@@ -61,9 +80,16 @@ class SincResampler {
   SincResampler(double io_sample_rate_ratio,
                 size_t request_frames,
                 SincResamplerCallback* read_cb);
+  // Same as above for |num_channels| channels, which are read with
+  // SincResamplerCallback::RunMultiChannel() when there is more than one.
+  SincResampler(double io_sample_rate_ratio,
+                size_t request_frames,
+                SincResamplerCallback* read_cb,
+                size_t num_channels);
   virtual ~SincResampler();
 
-  // Resample |frames| of data from |read_cb_| into |destination|.
+  // Resample |frames| of data from |read_cb_| into |destination|. With more
+  // than one channel, |destination| receives |frames| interleaved frames.
   void Resample(size_t frames, float* destination);
 
   // The maximum size in frames that guarantees Resample() will only make a
@@ -71,6 +97,11 @@ class SincResampler {
   size_t ChunkSize() const;
 
   size_t request_frames() const { return request_frames_; }
+  size_t num_channels() const { return num_channels_; }
+
+  // Returns the number of precomputed polyphase kernels in use, or 0 if the
+  // kernels are interpolated for every output sample.
+  size_t polyphase_phases_for_testing() const { return polyphase_phases_; }
 
   // Flush all buffered data and reset internal indices.  Not thread safe, do
   // not call while Resample() is in progress.
@@ -89,10 +120,24 @@ class SincResampler {
  private:
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, Convolve);
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, ConvolveBenchmark);
+  FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, ConvolveAVX2);
+  FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, DotProduct);
 
   void InitializeKernel();
   void UpdateRegions(bool second_load);
 
+  // Reads the next |request_frames_| of every channel from |read_cb_| into r0_.
+  void RequestInput();
+
+  // Sets up the polyphase kernels if |io_sample_rate_ratio_| allows it, and
+  // converts the current resampling position accordingly.
+  void InitializePolyphase();
+
+  // Generates output frames with the polyphase kernels until |frames| have
+  // been generated or the end of the block is reached. Returns the number of
+  // generated frames.
+  size_t ResamplePolyphase(size_t frames, float* destination);
+
   // Selects runtime specific CPU features like SSE.  Must be called before
   // using SincResampler.
   // TODO(ajm): Currently managed by the class internally. See the note with
@@ -111,6 +156,10 @@ class SincResampler {
                             const float* k1,
                             const float* k2,
                             double kernel_interpolation_factor);
+  static float Convolve_AVX2(const float* input_ptr,
+                             const float* k1,
+                             const float* k2,
+                             double kernel_interpolation_factor);
 #elif defined(WEBRTC_HAS_NEON)
   static float Convolve_NEON(const float* input_ptr,
                              const float* k1,
@@ -118,6 +167,16 @@ class SincResampler {
                              double kernel_interpolation_factor);
 #endif
 
+  // Compute the dot product of the polyphase kernel |k| and |input_ptr|. On
+  // x86 the underlying implementation is chosen at run time.
+  static float DotProduct_C(const float* input_ptr, const float* k);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  static float DotProduct_SSE(const float* input_ptr, const float* k);
+  static float DotProduct_AVX2(const float* input_ptr, const float* k);
+#elif defined(WEBRTC_HAS_NEON)
+  static float DotProduct_NEON(const float* input_ptr, const float* k);
+#endif
+
   // The ratio of input / output sample rates.
   double io_sample_rate_ratio_;
 
@@ -125,6 +184,14 @@ class SincResampler {
   // double precision to avoid drift.
   double virtual_source_idx_;
 
+  // When |polyphase_phases_| is non-zero, the io sample rate ratio is exactly
+  // |polyphase_step_| / |polyphase_phases_|, and |polyphase_source_idx_| is
+  // the index on the source input buffer in units of 1 / |polyphase_phases_|
+  // samples. It is then used instead of |virtual_source_idx_|.
+  size_t polyphase_phases_;
+  size_t polyphase_step_;
+  size_t polyphase_source_idx_;
+
   // The buffer is primed once at the very beginning of processing.
   bool buffer_primed_;
 
@@ -134,12 +201,19 @@ class SincResampler {
   // The size (in samples) to request from each |read_cb_| execution.
   const size_t request_frames_;
 
+  const size_t num_channels_;
+
   // The number of source frames processed per pass.
   size_t block_size_;
 
-  // The size (in samples) of the internal buffer used by the resampler.
+  // The size (in samples) of the internal buffer used by the resampler, per
+  // channel.
   const size_t input_buffer_size_;
 
+  // The distance between the input buffers of two channels. Rounded up from
+  // |input_buffer_size_| to keep every channel 32-byte aligned.
+  const size_t channel_stride_;
+
   // Contains kKernelOffsetCount kernels back-to-back, each of size kKernelSize.
   // The kernel offsets are sub-sample shifts of a windowed sinc shifted from
   // 0.0 to 1.0 sample.
@@ -147,23 +221,35 @@ class SincResampler {
   std::unique_ptr<float[], AlignedFreeDeleter> kernel_pre_sinc_storage_;
   std::unique_ptr<float[], AlignedFreeDeleter> kernel_window_storage_;
 
+  // Contains |polyphase_phases_| kernels back-to-back, each of size
+  // kKernelSize, for the sub-sample shifts 0, 1 / |polyphase_phases_|, ...
+  // Allocated on first use.
+  std::unique_ptr<float[], AlignedFreeDeleter> polyphase_kernel_storage_;
+
   // Data from the source is copied into this buffer for each processing pass.
+  // Holds |num_channels_| buffers, |channel_stride_| samples apart.
   std::unique_ptr<float[], AlignedFreeDeleter> input_buffer_;
 
-// Stores the runtime selection of which Convolve function to use.
+  // The destinations passed to RunMultiChannel(), one per channel.
+  std::vector<float*> channel_destinations_;
+
+// Stores the runtime selection of which Convolve and DotProduct functions to
+// use.
 // TODO(ajm): Move to using a global static which must only be initialized
 // once by the user. We're not doing this initially, because we don't have
 // e.g. a LazyInstance helper in webrtc.
-#if defined(WEBRTC_ARCH_X86_FAMILY) && !defined(__SSE2__)
+#if defined(WEBRTC_ARCH_X86_FAMILY)
   typedef float (*ConvolveProc)(const float*,
                                 const float*,
                                 const float*,
                                 double);
   ConvolveProc convolve_proc_;
+  typedef float (*DotProductProc)(const float*, const float*);
+  DotProductProc dot_product_proc_;
 #endif
 
-  // Pointers to the various regions inside |input_buffer_|.  See the diagram at
-  // the top of the .cc file for more information.
+  // Pointers to the various regions inside the input buffer of the first
+  // channel.  See the diagram at the top of the .cc file for more information.
   float* r0_;
   float* const r1_;
   float* const r2_;
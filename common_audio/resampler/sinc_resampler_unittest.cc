@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <memory>
 #include <tuple>
+#include <vector>
 
 #include "common_audio/resampler/sinc_resampler.h"
 #include "common_audio/resampler/sinusoidal_linear_chirp_source.h"
@@ -42,6 +43,36 @@ class MockSource : public SincResamplerCallback {
   MOCK_METHOD2(Run, void(size_t frames, float* destination));
 };
 
+// Provides a sine wave with a different frequency for each channel: channel
+// |ch| gets (|first_channel| + |ch| + 1) kHz.
+class SineSource : public SincResamplerCallback {
+ public:
+  SineSource(int sample_rate_hz, size_t num_channels, size_t first_channel = 0)
+      : sample_rate_hz_(sample_rate_hz),
+        num_channels_(num_channels),
+        first_channel_(first_channel) {}
+
+  void Run(size_t frames, float* destination) override {
+    RunMultiChannel(frames, &destination);
+  }
+
+  void RunMultiChannel(size_t frames, float* const* destinations) override {
+    for (size_t i = 0; i < frames; ++i, ++position_) {
+      for (size_t ch = 0; ch < num_channels_; ++ch) {
+        destinations[ch][i] = static_cast<float>(
+            sin(2 * M_PI * 1000 * (first_channel_ + ch + 1) * position_ /
+                sample_rate_hz_));
+      }
+    }
+  }
+
+ private:
+  const int sample_rate_hz_;
+  const size_t num_channels_;
+  const size_t first_channel_;
+  size_t position_ = 0;
+};
+
 ACTION(ClearBuffer) {
   memset(arg1, 0, arg0 * sizeof(float));
 }
@@ -229,6 +260,146 @@ TEST(SincResamplerTest, ConvolveBenchmark) {
 
 #undef CONVOLVE_FUNC
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Ensure Convolve_AVX2() returns the same value as Convolve_C().
+TEST(SincResamplerTest, ConvolveAVX2) {
+  if (!WebRtc_GetCPUInfo(kAVX2) || !WebRtc_GetCPUInfo(kFMA3)) {
+    return;
+  }
+
+  MockSource mock_source;
+  SincResampler resampler(kSampleRateRatio, SincResampler::kDefaultRequestSize,
+                          &mock_source);
+  const float* const kernel = resampler.kernel_storage_.get();
+  const float* const k1 = kernel + SincResampler::kKernelSize;
+  static const double kEpsilon = 0.00000005;
+  for (size_t offset = 0; offset < 8; ++offset) {
+    EXPECT_NEAR(resampler.Convolve_C(kernel + offset, kernel, k1,
+                                     kKernelInterpolationFactor),
+                resampler.Convolve_AVX2(kernel + offset, kernel, k1,
+                                        kKernelInterpolationFactor),
+                kEpsilon);
+  }
+}
+#endif
+
+// Ensure the optimized DotProduct() methods return the same value as
+// DotProduct_C().
+TEST(SincResamplerTest, DotProduct) {
+  MockSource mock_source;
+  SincResampler resampler(kSampleRateRatio, SincResampler::kDefaultRequestSize,
+                          &mock_source);
+  const float* const kernel = resampler.kernel_storage_.get();
+  const float* const k = kernel + 5 * SincResampler::kKernelSize;
+  static const double kEpsilon = 0.00000005;
+  for (size_t offset = 0; offset < 8; ++offset) {
+    const float result = resampler.DotProduct_C(kernel + offset, k);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    EXPECT_NEAR(result, resampler.DotProduct_SSE(kernel + offset, k),
+                kEpsilon);
+    if (WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3)) {
+      EXPECT_NEAR(result, resampler.DotProduct_AVX2(kernel + offset, k),
+                  kEpsilon);
+    }
+#elif defined(WEBRTC_HAS_NEON)
+    EXPECT_NEAR(result, resampler.DotProduct_NEON(kernel + offset, k),
+                kEpsilon);
+#endif
+    // The dot product with the kernel for offset 0 equals the "convolution"
+    // with it.
+    EXPECT_NEAR(resampler.DotProduct_C(kernel + offset, kernel),
+                resampler.Convolve_C(kernel + offset, kernel, k, 0.0),
+                kEpsilon);
+  }
+}
+
+// Verify which ratios use precomputed polyphase kernels.
+TEST(SincResamplerTest, PolyphaseRatios) {
+  MockSource mock_source;
+  const struct {
+    int input_rate;
+    int output_rate;
+    size_t expected_phases;
+  } kTestCases[] = {{16000, 48000, 3},  {44100, 48000, 160},
+                    {48000, 16000, 1},  {48000, 44100, 147},
+                    {32000, 48000, 3},  {8000, 48000, 6},
+                    {22050, 96000, 0},  {44100, 44101, 0}};
+  for (const auto& test_case : kTestCases) {
+    SincResampler resampler(
+        test_case.input_rate * 1.0 / test_case.output_rate,
+        SincResampler::kDefaultRequestSize, &mock_source);
+    EXPECT_EQ(test_case.expected_phases,
+              resampler.polyphase_phases_for_testing())
+        << test_case.input_rate << " -> " << test_case.output_rate;
+  }
+
+  // A drifting ratio falls back to interpolating the kernels, and back.
+  SincResampler resampler(441.0 / 480, SincResampler::kDefaultRequestSize,
+                          &mock_source);
+  resampler.SetRatio(441.0 / 480 * (1 + 1e-6));
+  EXPECT_EQ(0u, resampler.polyphase_phases_for_testing());
+  resampler.SetRatio(441.0 / 480);
+  EXPECT_EQ(160u, resampler.polyphase_phases_for_testing());
+}
+
+// Ensure the polyphase kernels produce the same output as interpolating the
+// kernels, here for 44.1 -> 48 kHz.
+TEST(SincResamplerTest, PolyphaseMatchesInterpolation) {
+  const double kRatio = 441.0 / 480;
+  SineSource polyphase_source(44100, 1);
+  SincResampler polyphase_resampler(kRatio, SincResampler::kDefaultRequestSize,
+                                    &polyphase_source);
+  ASSERT_EQ(160u, polyphase_resampler.polyphase_phases_for_testing());
+
+  // A tiny deviation from the ratio disables the polyphase kernels, while
+  // keeping the resampling position within 1e-4 samples over the test.
+  SineSource interpolated_source(44100, 1);
+  SincResampler interpolated_resampler(kRatio * (1 + 1e-8),
+                                       SincResampler::kDefaultRequestSize,
+                                       &interpolated_source);
+  ASSERT_EQ(0u, interpolated_resampler.polyphase_phases_for_testing());
+
+  const size_t kFrames = 4800;
+  std::vector<float> polyphase_output(kFrames);
+  std::vector<float> interpolated_output(kFrames);
+  polyphase_resampler.Resample(kFrames, polyphase_output.data());
+  interpolated_resampler.Resample(kFrames, interpolated_output.data());
+  for (size_t i = 0; i < kFrames; ++i) {
+    ASSERT_NEAR(interpolated_output[i], polyphase_output[i], 1e-4) << i;
+  }
+}
+
+// Ensure a multichannel SincResampler produces the same interleaved output as
+// one SincResampler per channel, with and without polyphase kernels.
+TEST(SincResamplerTest, MultiChannelMatchesMono) {
+  const size_t kNumChannels = 3;
+  const size_t kFrames = 2000;
+  for (double ratio : {160.0 / 480, 441.0 / 480, kSampleRateRatio}) {
+    SineSource multi_channel_source(16000, kNumChannels);
+    SincResampler multi_channel_resampler(
+        ratio, SincResampler::kDefaultRequestSize, &multi_channel_source,
+        kNumChannels);
+    EXPECT_EQ(kNumChannels, multi_channel_resampler.num_channels());
+    std::vector<float> multi_channel_output(kFrames * kNumChannels);
+    // Use uneven chunks to exercise the block boundaries.
+    multi_channel_resampler.Resample(317, multi_channel_output.data());
+    multi_channel_resampler.Resample(
+        kFrames - 317, multi_channel_output.data() + 317 * kNumChannels);
+
+    for (size_t ch = 0; ch < kNumChannels; ++ch) {
+      SineSource channel_source(16000, 1, ch);
+      SincResampler resampler(ratio, SincResampler::kDefaultRequestSize,
+                              &channel_source);
+      std::vector<float> output(kFrames);
+      resampler.Resample(kFrames, output.data());
+      for (size_t i = 0; i < kFrames; ++i) {
+        ASSERT_FLOAT_EQ(output[i], multi_channel_output[i * kNumChannels + ch])
+            << "ratio " << ratio << ", channel " << ch << ", frame " << i;
+      }
+    }
+  }
+}
+
 typedef std::tuple<int, int, double, double> SincResamplerTestData;
 class SincResamplerTest : public testing::TestWithParam<SincResamplerTestData> {
  public:
@@ -350,7 +521,7 @@ INSTANTIATE_TEST_CASE_P(
         std::make_tuple(16000, 44100, kResamplingRMSError, -62.54),
         std::make_tuple(22050, 44100, kResamplingRMSError, -73.53),
         std::make_tuple(32000, 44100, kResamplingRMSError, -63.32),
-        std::make_tuple(44100, 44100, kResamplingRMSError, -73.53),
+        std::make_tuple(44100, 44100, kResamplingRMSError, -73.52),
         std::make_tuple(48000, 44100, -15.01, -64.04),
         std::make_tuple(96000, 44100, -18.49, -25.51),
         std::make_tuple(192000, 44100, -20.50, -13.31),
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+// Returns the products of the sixteen 16-bit lanes of |a| and |b|, each
+// shifted right by |right_shifts|, summed pairwise into eight 32-bit lanes.
+// Without a shift, the pairwise sums wrap around exactly as the sums of the C
+// version.
+static inline __m256i ShiftedProducts(__m256i a,
+                                      __m256i b,
+                                      int right_shifts,
+                                      __m128i shift) {
+  if (right_shifts == 0) {
+    return _mm256_madd_epi16(a, b);
+  }
+  const __m256i low = _mm256_mullo_epi16(a, b);
+  const __m256i high = _mm256_mulhi_epi16(a, b);
+  return _mm256_add_epi32(
+      _mm256_sra_epi32(_mm256_unpacklo_epi16(low, high), shift),
+      _mm256_sra_epi32(_mm256_unpackhi_epi16(low, high), shift));
+}
+
+// Returns the sums of the eight 32-bit lanes of each of |a|, |b|, |c| and |d|.
+static inline __m128i HorizontalSums(__m256i a,
+                                     __m256i b,
+                                     __m256i c,
+                                     __m256i d) {
+  const __m256i ab = _mm256_add_epi32(_mm256_unpacklo_epi32(a, b),
+                                      _mm256_unpackhi_epi32(a, b));
+  const __m256i cd = _mm256_add_epi32(_mm256_unpacklo_epi32(c, d),
+                                      _mm256_unpackhi_epi32(c, d));
+  const __m256i abcd = _mm256_add_epi32(_mm256_unpacklo_epi64(ab, cd),
+                                        _mm256_unpackhi_epi64(ab, cd));
+  return _mm_add_epi32(_mm256_castsi256_si128(abcd),
+                       _mm256_extracti128_si256(abcd, 1));
+}
+
+// AVX2 version of WebRtcSpl_CrossCorrelation() for x86 platforms. Four lags
+// are computed at once, so that each block of |seq1| is loaded once for all of
+// them. The result is bit exact with the C version.
+void WebRtcSpl_CrossCorrelationAVX2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    size_t dim_seq,
+                                    size_t dim_cross_correlation,
+                                    int right_shifts,
+                                    int step_seq2) {
+  const __m128i shift = _mm_cvtsi32_si128(right_shifts);
+  const size_t dim_seq_simd = dim_seq & ~(size_t)15;
+  size_t i = 0;
+  size_t j = 0;
+  int k = 0;
+
+  for (i = 0; i + 4 <= dim_cross_correlation; i += 4) {
+    const int16_t* seq2_lags[4];
+    __m256i sums[4];
+    for (k = 0; k < 4; ++k) {
+      seq2_lags[k] = seq2 + k * step_seq2;
+      sums[k] = _mm256_setzero_si256();
+    }
+    for (j = 0; j < dim_seq_simd; j += 16) {
+      const __m256i x = _mm256_loadu_si256((const __m256i*)&seq1[j]);
+      for (k = 0; k < 4; ++k) {
+        const __m256i y =
+            _mm256_loadu_si256((const __m256i*)&seq2_lags[k][j]);
+        sums[k] = _mm256_add_epi32(sums[k],
+                                   ShiftedProducts(x, y, right_shifts, shift));
+      }
+    }
+    _mm_storeu_si128((__m128i*)cross_correlation,
+                     HorizontalSums(sums[0], sums[1], sums[2], sums[3]));
+    for (k = 0; k < 4; ++k) {
+      for (j = dim_seq_simd; j < dim_seq; j++) {
+        cross_correlation[k] += (seq1[j] * seq2_lags[k][j]) >> right_shifts;
+      }
+    }
+    seq2 += 4 * step_seq2;
+    cross_correlation += 4;
+  }
+
+  // Remaining lags, one at a time.
+  for (; i < dim_cross_correlation; i++) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sum = zero;
+    for (j = 0; j < dim_seq_simd; j += 16) {
+      const __m256i x = _mm256_loadu_si256((const __m256i*)&seq1[j]);
+      const __m256i y = _mm256_loadu_si256((const __m256i*)&seq2[j]);
+      sum = _mm256_add_epi32(sum, ShiftedProducts(x, y, right_shifts, shift));
+    }
+    int32_t corr = _mm_cvtsi128_si32(HorizontalSums(sum, zero, zero, zero));
+    for (j = dim_seq_simd; j < dim_seq; j++) {
+      corr += (seq1[j] * seq2[j]) >> right_shifts;
+    }
+    *cross_correlation++ = corr;
+    seq2 += step_seq2;
+  }
+}
@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+#include <stddef.h>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+// Longest filter handled by the AVX2 version. The filters used by NetEq have at
+// most eight coefficients.
+#define MAX_COEFFICIENTS_LENGTH 32
+
+// Returns, in the lower half, the sums of the four 32-bit lanes of each lower
+// half of |a|, |b|, |c| and |d|, and the same for the upper halves in the
+// upper half.
+static inline __m256i HorizontalSums(__m256i a,
+                                     __m256i b,
+                                     __m256i c,
+                                     __m256i d) {
+  const __m256i ab = _mm256_add_epi32(_mm256_unpacklo_epi32(a, b),
+                                      _mm256_unpackhi_epi32(a, b));
+  const __m256i cd = _mm256_add_epi32(_mm256_unpacklo_epi32(c, d),
+                                      _mm256_unpackhi_epi32(c, d));
+  return _mm256_add_epi32(_mm256_unpacklo_epi64(ab, cd),
+                          _mm256_unpackhi_epi64(ab, cd));
+}
+
+// AVX2 version of WebRtcSpl_DownsampleFast() for x86 platforms. As in the SSE2
+// version, the filter is applied as a dot product with the reversed and padded
+// coefficients. Eight outputs are computed at once, two per register, with the
+// window of output n in the lower half and that of output n + 4 in the upper
+// half. The result is bit exact with the C version.
+int WebRtcSpl_DownsampleFastAVX2(const int16_t* data_in,
+                                 size_t data_in_length,
+                                 int16_t* data_out,
+                                 size_t data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 size_t coefficients_length,
+                                 int factor,
+                                 size_t delay) {
+  int16_t reversed_coefficients[MAX_COEFFICIENTS_LENGTH] = {0};
+  __m256i coefficient_blocks[MAX_COEFFICIENTS_LENGTH / 8];
+  const size_t padded_length = (coefficients_length + 7) & ~(size_t)7;
+  const size_t num_blocks = padded_length / 8;
+  const size_t overhang = padded_length - coefficients_length;
+  const __m256i round = _mm256_set1_epi32(2048);  // 0.5 in Q12.
+  size_t endpos = delay + factor * (data_out_length - 1) + 1;
+  size_t i = delay;
+  size_t j = 0;
+  size_t k = 0;
+
+  // Return error if any of the running conditions doesn't meet.
+  if (data_out_length == 0 || coefficients_length == 0 ||
+      data_in_length < endpos) {
+    return -1;
+  }
+  if (coefficients_length > MAX_COEFFICIENTS_LENGTH) {
+    return WebRtcSpl_DownsampleFastC(data_in, data_in_length, data_out,
+                                     data_out_length, coefficients,
+                                     coefficients_length, factor, delay);
+  }
+
+  for (j = 0; j < coefficients_length; j++) {
+    reversed_coefficients[coefficients_length - 1 - j] = coefficients[j];
+  }
+  for (k = 0; k < num_blocks; k++) {
+    coefficient_blocks[k] = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*)&reversed_coefficients[8 * k]));
+  }
+
+  // The window of output |i| is data_in[i - coefficients_length + 1] up to
+  // data_in[i + overhang], which must exist for the last of the eight outputs.
+  while (i + 7 * factor < endpos &&
+         i + 7 * factor + overhang < data_in_length) {
+    __m256i sums[4];
+    for (j = 0; j < 4; j++) {
+      const int16_t* window =
+          &data_in[(ptrdiff_t)(i + j * factor) -
+                   (ptrdiff_t)coefficients_length + 1];
+      const int16_t* upper_window = window + 4 * factor;
+      sums[j] = _mm256_setzero_si256();
+      for (k = 0; k < num_blocks; k++) {
+        const __m256i x = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(
+                _mm_loadu_si128((const __m128i*)&window[8 * k])),
+            _mm_loadu_si128((const __m128i*)&upper_window[8 * k]), 1);
+        sums[j] = _mm256_add_epi32(sums[j],
+                                   _mm256_madd_epi16(x, coefficient_blocks[k]));
+      }
+    }
+    __m256i out = HorizontalSums(sums[0], sums[1], sums[2], sums[3]);
+    out = _mm256_srai_epi32(_mm256_add_epi32(out, round), 12);
+    // Saturate, gather the eight outputs in the lower half and store them.
+    out = _mm256_permute4x64_epi64(_mm256_packs_epi32(out, out),
+                                   _MM_SHUFFLE(3, 1, 2, 0));
+    _mm_storeu_si128((__m128i*)data_out, _mm256_castsi256_si128(out));
+    data_out += 8;
+    i += 8 * factor;
+  }
+
+  for (; i < endpos; i += factor) {
+    int32_t out_s32 = 2048;  // Round value, 0.5 in Q12.
+    for (j = 0; j < coefficients_length; j++) {
+      out_s32 += coefficients[j] * data_in[(ptrdiff_t)i - (ptrdiff_t)j];
+    }
+    *data_out++ = WebRtcSpl_SatW32ToW16(out_s32 >> 12);
+  }
+
+  return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+#include <stddef.h>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+// Longest filter handled by the SSE2 version. The filters used by NetEq have at
+// most eight coefficients.
+#define MAX_COEFFICIENTS_LENGTH 32
+
+// Returns the sums of the four 32-bit lanes of each of |a|, |b|, |c| and |d|.
+static inline __m128i HorizontalSums(__m128i a,
+                                     __m128i b,
+                                     __m128i c,
+                                     __m128i d) {
+  const __m128i ab =
+      _mm_add_epi32(_mm_unpacklo_epi32(a, b), _mm_unpackhi_epi32(a, b));
+  const __m128i cd =
+      _mm_add_epi32(_mm_unpacklo_epi32(c, d), _mm_unpackhi_epi32(c, d));
+  return _mm_add_epi32(_mm_unpacklo_epi64(ab, cd), _mm_unpackhi_epi64(ab, cd));
+}
+
+// SSE2 version of WebRtcSpl_DownsampleFast() for x86 platforms. The filter is
+// applied as a dot product of the input with the reversed coefficients, padded
+// with zeros to a multiple of eight, and four outputs are computed at once.
+// The last outputs, for which the padded window would read past the end of
+// |data_in|, are computed as in the C version. The result is bit exact with
+// the C version.
+int WebRtcSpl_DownsampleFastSSE2(const int16_t* data_in,
+                                 size_t data_in_length,
+                                 int16_t* data_out,
+                                 size_t data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 size_t coefficients_length,
+                                 int factor,
+                                 size_t delay) {
+  int16_t reversed_coefficients[MAX_COEFFICIENTS_LENGTH] = {0};
+  __m128i coefficient_blocks[MAX_COEFFICIENTS_LENGTH / 8];
+  const size_t padded_length = (coefficients_length + 7) & ~(size_t)7;
+  const size_t num_blocks = padded_length / 8;
+  const size_t overhang = padded_length - coefficients_length;
+  const __m128i round = _mm_set1_epi32(2048);  // 0.5 in Q12.
+  size_t endpos = delay + factor * (data_out_length - 1) + 1;
+  size_t i = delay;
+  size_t j = 0;
+  size_t k = 0;
+
+  // Return error if any of the running conditions doesn't meet.
+  if (data_out_length == 0 || coefficients_length == 0 ||
+      data_in_length < endpos) {
+    return -1;
+  }
+  if (coefficients_length > MAX_COEFFICIENTS_LENGTH) {
+    return WebRtcSpl_DownsampleFastC(data_in, data_in_length, data_out,
+                                     data_out_length, coefficients,
+                                     coefficients_length, factor, delay);
+  }
+
+  for (j = 0; j < coefficients_length; j++) {
+    reversed_coefficients[coefficients_length - 1 - j] = coefficients[j];
+  }
+  for (k = 0; k < num_blocks; k++) {
+    coefficient_blocks[k] =
+        _mm_loadu_si128((const __m128i*)&reversed_coefficients[8 * k]);
+  }
+
+  // The window of output |i| is data_in[i - coefficients_length + 1] up to
+  // data_in[i + overhang], which must exist for the last of the four outputs.
+  while (i + 3 * factor < endpos &&
+         i + 3 * factor + overhang < data_in_length) {
+    __m128i sums[4];
+    for (j = 0; j < 4; j++) {
+      const int16_t* window =
+          &data_in[(ptrdiff_t)(i + j * factor) -
+                   (ptrdiff_t)coefficients_length + 1];
+      sums[j] = _mm_setzero_si128();
+      for (k = 0; k < num_blocks; k++) {
+        const __m128i x = _mm_loadu_si128((const __m128i*)&window[8 * k]);
+        sums[j] =
+            _mm_add_epi32(sums[j], _mm_madd_epi16(x, coefficient_blocks[k]));
+      }
+    }
+    __m128i out = HorizontalSums(sums[0], sums[1], sums[2], sums[3]);
+    out = _mm_srai_epi32(_mm_add_epi32(out, round), 12);
+    // Saturate and store the outputs.
+    _mm_storel_epi64((__m128i*)data_out, _mm_packs_epi32(out, out));
+    data_out += 4;
+    i += 4 * factor;
+  }
+
+  for (; i < endpos; i += factor) {
+    int32_t out_s32 = 2048;  // Round value, 0.5 in Q12.
+    for (j = 0; j < coefficients_length; j++) {
+      out_s32 += coefficients[j] * data_in[(ptrdiff_t)i - (ptrdiff_t)j];
+    }
+    *data_out++ = WebRtcSpl_SatW32ToW16(out_s32 >> 12);
+  }
+
+  return 0;
+}
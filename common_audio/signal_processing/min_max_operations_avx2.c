@@ -0,0 +1,209 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+#include <stdlib.h>
+
+#include "rtc_base/checks.h"
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+static inline int16_t HorizontalMaxW16(__m256i v) {
+  __m128i w = _mm_max_epi16(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  w = _mm_max_epi16(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(1, 0, 3, 2)));
+  w = _mm_max_epi16(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(2, 3, 0, 1)));
+  w = _mm_max_epi16(w, _mm_shufflelo_epi16(w, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(w);
+}
+
+static inline int16_t HorizontalMinW16(__m256i v) {
+  __m128i w = _mm_min_epi16(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  w = _mm_min_epi16(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(1, 0, 3, 2)));
+  w = _mm_min_epi16(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(2, 3, 0, 1)));
+  w = _mm_min_epi16(w, _mm_shufflelo_epi16(w, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(w);
+}
+
+static inline int32_t HorizontalMaxW32(__m256i v) {
+  __m128i w = _mm_max_epi32(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  w = _mm_max_epi32(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(1, 0, 3, 2)));
+  w = _mm_max_epi32(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(w);
+}
+
+static inline uint32_t HorizontalMaxU32(__m256i v) {
+  __m128i w = _mm_max_epu32(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  w = _mm_max_epu32(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(1, 0, 3, 2)));
+  w = _mm_max_epu32(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (uint32_t)_mm_cvtsi128_si32(w);
+}
+
+static inline int32_t HorizontalMinW32(__m256i v) {
+  __m128i w = _mm_min_epi32(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  w = _mm_min_epi32(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(1, 0, 3, 2)));
+  w = _mm_min_epi32(w, _mm_shuffle_epi32(w, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(w);
+}
+
+// Maximum absolute value of word16 vector. AVX2 version for x86 platforms.
+int16_t WebRtcSpl_MaxAbsValueW16AVX2(const int16_t* vector, size_t length) {
+  const size_t length_simd = length & ~(size_t)15;
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i max_abs = zero;
+  int maximum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (i = 0; i < length_simd; i += 16) {
+    const __m256i v = _mm256_loadu_si256((const __m256i*)&vector[i]);
+    // The saturating negation maps -32768 to 32767, which is also the clamped
+    // result of the C version.
+    max_abs = _mm256_max_epi16(
+        max_abs, _mm256_max_epi16(v, _mm256_subs_epi16(zero, v)));
+  }
+  maximum = HorizontalMaxW16(max_abs);
+
+  for (; i < length; i++) {
+    const int absolute = abs((int)vector[i]);
+    if (absolute > maximum) {
+      maximum = absolute;
+    }
+  }
+
+  // Guard the case for abs(-32768).
+  if (maximum > WEBRTC_SPL_WORD16_MAX) {
+    maximum = WEBRTC_SPL_WORD16_MAX;
+  }
+
+  return (int16_t)maximum;
+}
+
+// Maximum absolute value of word32 vector. AVX2 version for x86 platforms.
+int32_t WebRtcSpl_MaxAbsValueW32AVX2(const int32_t* vector, size_t length) {
+  const size_t length_simd = length & ~(size_t)7;
+  __m256i max_abs = _mm256_setzero_si256();
+  uint32_t absolute = 0, maximum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (i = 0; i < length_simd; i += 8) {
+    // The absolute value of -2^31 is -2^31, which the unsigned maximum takes
+    // as 2^31, as the C version does.
+    max_abs = _mm256_max_epu32(
+        max_abs,
+        _mm256_abs_epi32(_mm256_loadu_si256((const __m256i*)&vector[i])));
+  }
+  maximum = HorizontalMaxU32(max_abs);
+
+  for (; i < length; i++) {
+    absolute = abs((int)vector[i]);
+    if (absolute > maximum) {
+      maximum = absolute;
+    }
+  }
+
+  maximum = WEBRTC_SPL_MIN(maximum, WEBRTC_SPL_WORD32_MAX);
+
+  return (int32_t)maximum;
+}
+
+// Maximum value of word16 vector. AVX2 version for x86 platforms.
+int16_t WebRtcSpl_MaxValueW16AVX2(const int16_t* vector, size_t length) {
+  const size_t length_simd = length & ~(size_t)15;
+  __m256i max_value = _mm256_set1_epi16(WEBRTC_SPL_WORD16_MIN);
+  int16_t maximum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (i = 0; i < length_simd; i += 16) {
+    max_value = _mm256_max_epi16(
+        max_value, _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  maximum = HorizontalMaxW16(max_value);
+
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// Maximum value of word32 vector. AVX2 version for x86 platforms.
+int32_t WebRtcSpl_MaxValueW32AVX2(const int32_t* vector, size_t length) {
+  const size_t length_simd = length & ~(size_t)7;
+  __m256i max_value = _mm256_set1_epi32(WEBRTC_SPL_WORD32_MIN);
+  int32_t maximum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (i = 0; i < length_simd; i += 8) {
+    max_value = _mm256_max_epi32(
+        max_value, _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  maximum = HorizontalMaxW32(max_value);
+
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// Minimum value of word16 vector. AVX2 version for x86 platforms.
+int16_t WebRtcSpl_MinValueW16AVX2(const int16_t* vector, size_t length) {
+  const size_t length_simd = length & ~(size_t)15;
+  __m256i min_value = _mm256_set1_epi16(WEBRTC_SPL_WORD16_MAX);
+  int16_t minimum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (i = 0; i < length_simd; i += 16) {
+    min_value = _mm256_min_epi16(
+        min_value, _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  minimum = HorizontalMinW16(min_value);
+
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
+
+// Minimum value of word32 vector. AVX2 version for x86 platforms.
+int32_t WebRtcSpl_MinValueW32AVX2(const int32_t* vector, size_t length) {
+  const size_t length_simd = length & ~(size_t)7;
+  __m256i min_value = _mm256_set1_epi32(WEBRTC_SPL_WORD32_MAX);
+  int32_t minimum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (i = 0; i < length_simd; i += 8) {
+    min_value = _mm256_min_epi32(
+        min_value, _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  minimum = HorizontalMinW32(min_value);
+
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
@@ -9,9 +9,12 @@
  */
 
 #include <algorithm>
+#include <vector>
 
 #include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "rtc_base/random.h"
 #include "rtc_base/strings/string_builder.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
 #include "test/gtest.h"
 
 static const size_t kVector16Size = 9;
@@ -493,14 +496,14 @@ TEST_F(SplTest, CrossCorrelationTest) {
                              kCrossCorrelationDimension, kShift, kStep);
 
   // WebRtcSpl_CrossCorrelationC() and WebRtcSpl_CrossCorrelationNeon()
-  // are not bit-exact.
+  // are not bit-exact. The x86 versions are.
   const int32_t kExpected[kCrossCorrelationDimension] = {-266947903, -15579555,
                                                          -171282001};
   const int32_t* expected = kExpected;
-#if !defined(MIPS32_LE)
+#if defined(WEBRTC_HAS_NEON)
   const int32_t kExpectedNeon[kCrossCorrelationDimension] = {
       -266947901, -15579553, -171281999};
-  if (WebRtcSpl_CrossCorrelation != WebRtcSpl_CrossCorrelationC) {
+  if (WebRtcSpl_CrossCorrelation == WebRtcSpl_CrossCorrelationNeon) {
     expected = kExpectedNeon;
   }
 #endif
@@ -509,6 +512,118 @@ TEST_F(SplTest, CrossCorrelationTest) {
   }
 }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Verifies that the SSE2 and AVX2 versions of the functions with a pointer are
+// bit exact with the C versions, for lengths that exercise both the vectorized
+// loops and the remainders, and for extreme values.
+TEST_F(SplTest, X86VersionsAreBitExact) {
+  webrtc::Random random_generator(42U);
+  const bool has_avx2 = WebRtc_GetCPUInfo(kAVX2) != 0;
+  const size_t kLength = 200;
+  std::vector<int16_t> vector16(kLength);
+  std::vector<int32_t> vector32(kLength);
+  const int16_t kCoefficients[] = {-123, 1234, 3020, 1555, 3020, 1234, -123};
+
+  for (int iteration = 0; iteration < 100; ++iteration) {
+    for (size_t i = 0; i < kLength; ++i) {
+      vector16[i] = random_generator.Rand(WEBRTC_SPL_WORD16_MIN,
+                                          WEBRTC_SPL_WORD16_MAX);
+      vector32[i] = random_generator.Rand(WEBRTC_SPL_WORD32_MIN,
+                                          WEBRTC_SPL_WORD32_MAX);
+    }
+    if (iteration % 4 == 1) {
+      vector16[random_generator.Rand(0, kLength - 1)] = WEBRTC_SPL_WORD16_MIN;
+      vector32[random_generator.Rand(0, kLength - 1)] = WEBRTC_SPL_WORD32_MIN;
+    }
+    const size_t length = random_generator.Rand(1, 100);
+    SCOPED_TRACE(length);
+    const int16_t* x16 = &vector16[50];
+    const int32_t* x32 = vector32.data();
+
+    EXPECT_EQ(WebRtcSpl_MaxAbsValueW16C(x16, length),
+              WebRtcSpl_MaxAbsValueW16SSE2(x16, length));
+    EXPECT_EQ(WebRtcSpl_MaxAbsValueW32C(x32, length),
+              WebRtcSpl_MaxAbsValueW32SSE2(x32, length));
+    EXPECT_EQ(WebRtcSpl_MaxValueW16C(x16, length),
+              WebRtcSpl_MaxValueW16SSE2(x16, length));
+    EXPECT_EQ(WebRtcSpl_MaxValueW32C(x32, length),
+              WebRtcSpl_MaxValueW32SSE2(x32, length));
+    EXPECT_EQ(WebRtcSpl_MinValueW16C(x16, length),
+              WebRtcSpl_MinValueW16SSE2(x16, length));
+    EXPECT_EQ(WebRtcSpl_MinValueW32C(x32, length),
+              WebRtcSpl_MinValueW32SSE2(x32, length));
+    if (has_avx2) {
+      EXPECT_EQ(WebRtcSpl_MaxAbsValueW16C(x16, length),
+                WebRtcSpl_MaxAbsValueW16AVX2(x16, length));
+      EXPECT_EQ(WebRtcSpl_MaxAbsValueW32C(x32, length),
+                WebRtcSpl_MaxAbsValueW32AVX2(x32, length));
+      EXPECT_EQ(WebRtcSpl_MaxValueW16C(x16, length),
+                WebRtcSpl_MaxValueW16AVX2(x16, length));
+      EXPECT_EQ(WebRtcSpl_MaxValueW32C(x32, length),
+                WebRtcSpl_MaxValueW32AVX2(x32, length));
+      EXPECT_EQ(WebRtcSpl_MinValueW16C(x16, length),
+                WebRtcSpl_MinValueW16AVX2(x16, length));
+      EXPECT_EQ(WebRtcSpl_MinValueW32C(x32, length),
+                WebRtcSpl_MinValueW32AVX2(x32, length));
+    }
+
+    // Cross-correlation with both directions of |seq2|, as used by NetEq.
+    const size_t dim_cross_correlation = random_generator.Rand(1, 20);
+    const int right_shifts = random_generator.Rand(0, 3) == 0
+                                 ? 0
+                                 : random_generator.Rand(1, 10);
+    for (int step_seq2 : {-1, 1}) {
+      std::vector<int32_t> expected(dim_cross_correlation);
+      std::vector<int32_t> actual(dim_cross_correlation);
+      WebRtcSpl_CrossCorrelationC(expected.data(), x16, x16 + 25, length,
+                                  dim_cross_correlation, right_shifts,
+                                  step_seq2);
+      WebRtcSpl_CrossCorrelationSSE2(actual.data(), x16, x16 + 25, length,
+                                     dim_cross_correlation, right_shifts,
+                                     step_seq2);
+      EXPECT_EQ(expected, actual);
+      if (has_avx2) {
+        WebRtcSpl_CrossCorrelationAVX2(actual.data(), x16, x16 + 25, length,
+                                       dim_cross_correlation, right_shifts,
+                                       step_seq2);
+        EXPECT_EQ(expected, actual);
+      }
+    }
+
+    // Decimation with the state in the samples before the input.
+    const size_t coefficients_length = random_generator.Rand(1, 7);
+    const int factor = random_generator.Rand(1, 12);
+    const size_t delay = random_generator.Rand(0, 3);
+    const size_t data_out_length = random_generator.Rand(1, 40);
+    const size_t data_in_length = delay + factor * (data_out_length - 1) + 1 +
+                                  random_generator.Rand(0, 9);
+    if (data_in_length > kLength - 10) {
+      continue;
+    }
+    std::vector<int16_t> expected(data_out_length);
+    std::vector<int16_t> actual(data_out_length);
+    EXPECT_EQ(0, WebRtcSpl_DownsampleFastC(&vector16[10], data_in_length,
+                                           expected.data(), data_out_length,
+                                           kCoefficients, coefficients_length,
+                                           factor, delay));
+    EXPECT_EQ(0, WebRtcSpl_DownsampleFastSSE2(&vector16[10], data_in_length,
+                                              actual.data(), data_out_length,
+                                              kCoefficients,
+                                              coefficients_length, factor,
+                                              delay));
+    EXPECT_EQ(expected, actual);
+    if (has_avx2) {
+      EXPECT_EQ(0, WebRtcSpl_DownsampleFastAVX2(&vector16[10], data_in_length,
+                                                actual.data(), data_out_length,
+                                                kCoefficients,
+                                                coefficients_length, factor,
+                                                delay));
+      EXPECT_EQ(expected, actual);
+    }
+  }
+}
+#endif  // defined(WEBRTC_ARCH_X86_FAMILY)
+
 TEST_F(SplTest, AutoCorrelationTest) {
   int scale = 0;
   int32_t vector32[kVector16Size];
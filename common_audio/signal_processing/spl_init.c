@@ -9,7 +9,7 @@
  */
 
 /* The global function contained in this file initializes SPL function
- * pointers, currently only for ARM platforms.
+ * pointers, for ARM, MIPS and x86 platforms.
  *
  * Some code came from common/rtcd.c in the WebM project.
  */
@@ -60,6 +60,36 @@ static void InitPointersToNeon(void) {
 }
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+/* Initialize function pointers to the SSE2 version. */
+static void InitPointersToSSE2(void) {
+  WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16SSE2;
+  WebRtcSpl_MaxAbsValueW32 = WebRtcSpl_MaxAbsValueW32SSE2;
+  WebRtcSpl_MaxValueW16 = WebRtcSpl_MaxValueW16SSE2;
+  WebRtcSpl_MaxValueW32 = WebRtcSpl_MaxValueW32SSE2;
+  WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16SSE2;
+  WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32SSE2;
+  WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationSSE2;
+  WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastSSE2;
+  WebRtcSpl_ScaleAndAddVectorsWithRound =
+      WebRtcSpl_ScaleAndAddVectorsWithRoundC;
+}
+
+/* Initialize function pointers to the AVX2 version. */
+static void InitPointersToAVX2(void) {
+  WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16AVX2;
+  WebRtcSpl_MaxAbsValueW32 = WebRtcSpl_MaxAbsValueW32AVX2;
+  WebRtcSpl_MaxValueW16 = WebRtcSpl_MaxValueW16AVX2;
+  WebRtcSpl_MaxValueW32 = WebRtcSpl_MaxValueW32AVX2;
+  WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16AVX2;
+  WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32AVX2;
+  WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationAVX2;
+  WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastAVX2;
+  WebRtcSpl_ScaleAndAddVectorsWithRound =
+      WebRtcSpl_ScaleAndAddVectorsWithRoundC;
+}
+#endif
+
 #if defined(MIPS32_LE)
 /* Initialize function pointers to the MIPS version. */
 static void InitPointersToMIPS(void) {
@@ -87,6 +117,14 @@ static void InitFunctionPointers(void) {
   InitPointersToNeon();
 #elif defined(MIPS32_LE)
   InitPointersToMIPS();
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    InitPointersToAVX2();
+  } else if (WebRtc_GetCPUInfo(kSSE2)) {
+    InitPointersToSSE2();
+  } else {
+    InitPointersToC();
+  }
 #else
   InitPointersToC();
 #endif  /* WEBRTC_HAS_NEON */
@@ -0,0 +1,146 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/include/i420_pyramid_buffer.h"
+
+#include "absl/memory/memory.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/refcountedobject.h"
+
+namespace webrtc {
+namespace {
+
+// Resolutions in use at the same time are those of the pyramid levels and of
+// the consumers of the frames. When a source changes resolution, the pools for
+// the old ones are dropped once there are more than this many.
+constexpr size_t kMaxNumberOfPools = 16;
+
+}  // namespace
+
+I420PyramidBuffer::I420PyramidBuffer(
+    rtc::scoped_refptr<I420BufferInterface> buffer,
+    rtc::scoped_refptr<I420PyramidBufferFactory> factory)
+    : buffer_(std::move(buffer)), factory_(std::move(factory)) {
+  levels_.push_back(buffer_);
+}
+
+I420PyramidBuffer::~I420PyramidBuffer() = default;
+
+int I420PyramidBuffer::width() const {
+  return buffer_->width();
+}
+
+int I420PyramidBuffer::height() const {
+  return buffer_->height();
+}
+
+const uint8_t* I420PyramidBuffer::DataY() const {
+  return buffer_->DataY();
+}
+
+const uint8_t* I420PyramidBuffer::DataU() const {
+  return buffer_->DataU();
+}
+
+const uint8_t* I420PyramidBuffer::DataV() const {
+  return buffer_->DataV();
+}
+
+int I420PyramidBuffer::StrideY() const {
+  return buffer_->StrideY();
+}
+
+int I420PyramidBuffer::StrideU() const {
+  return buffer_->StrideU();
+}
+
+int I420PyramidBuffer::StrideV() const {
+  return buffer_->StrideV();
+}
+
+rtc::scoped_refptr<VideoFrameBuffer> I420PyramidBuffer::GetScaledBuffer(
+    int scaled_width,
+    int scaled_height) {
+  return GetScaledI420(scaled_width, scaled_height);
+}
+
+rtc::scoped_refptr<I420BufferInterface> I420PyramidBuffer::GetScaledI420(
+    int scaled_width,
+    int scaled_height) {
+  RTC_DCHECK_GT(scaled_width, 0);
+  RTC_DCHECK_GT(scaled_height, 0);
+  rtc::CritScope lock(&crit_);
+  rtc::scoped_refptr<I420BufferInterface> level =
+      GetLevel(scaled_width, scaled_height);
+  if (level->width() == scaled_width && level->height() == scaled_height)
+    return level;
+  for (const rtc::scoped_refptr<I420BufferInterface>& scaled_buffer :
+       scaled_buffers_) {
+    if (scaled_buffer->width() == scaled_width &&
+        scaled_buffer->height() == scaled_height) {
+      return scaled_buffer;
+    }
+  }
+  rtc::scoped_refptr<I420Buffer> scaled_buffer =
+      factory_->CreateBuffer(scaled_width, scaled_height);
+  scaled_buffer->ScaleFrom(*level);
+  scaled_buffers_.push_back(scaled_buffer);
+  return scaled_buffer;
+}
+
+rtc::scoped_refptr<I420BufferInterface> I420PyramidBuffer::GetLevel(
+    int width,
+    int height) {
+  size_t level_idx = 0;
+  while (true) {
+    const int next_width = (levels_[level_idx]->width() + 1) / 2;
+    const int next_height = (levels_[level_idx]->height() + 1) / 2;
+    if (next_width < width || next_height < height)
+      return levels_[level_idx];
+    if (level_idx + 1 == levels_.size()) {
+      rtc::scoped_refptr<I420Buffer> next_level =
+          factory_->CreateBuffer(next_width, next_height);
+      next_level->ScaleFrom(*levels_[level_idx]);
+      levels_.push_back(next_level);
+    }
+    ++level_idx;
+  }
+}
+
+rtc::scoped_refptr<I420PyramidBufferFactory>
+I420PyramidBufferFactory::Create() {
+  return new rtc::RefCountedObject<I420PyramidBufferFactory>();
+}
+
+I420PyramidBufferFactory::I420PyramidBufferFactory() = default;
+
+I420PyramidBufferFactory::~I420PyramidBufferFactory() = default;
+
+rtc::scoped_refptr<I420PyramidBuffer> I420PyramidBufferFactory::Wrap(
+    rtc::scoped_refptr<I420BufferInterface> buffer) {
+  return new rtc::RefCountedObject<I420PyramidBuffer>(std::move(buffer), this);
+}
+
+rtc::scoped_refptr<I420Buffer> I420PyramidBufferFactory::CreateBuffer(
+    int width,
+    int height) {
+  rtc::CritScope lock(&crit_);
+  const std::pair<int, int> resolution(width, height);
+  auto it = pools_.find(resolution);
+  if (it == pools_.end()) {
+    // Buffers still in use stay valid, they are only no longer recycled.
+    if (pools_.size() >= kMaxNumberOfPools)
+      pools_.clear();
+    it = pools_.emplace(resolution, absl::make_unique<I420BufferPool>()).first;
+  }
+  return it->second->CreateBuffer(width, height);
+}
+
+}  // namespace webrtc
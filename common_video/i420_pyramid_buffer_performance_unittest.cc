@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <utility>
+
+#include "api/video/i420_buffer.h"
+#include "common_video/include/i420_buffer_pool.h"
+#include "common_video/include/i420_pyramid_buffer.h"
+#include "rtc_base/arraysize.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kNumFrames = 100;
+
+// Resolutions asked for by the consumers of a 1080p frame: a 1080p three
+// stream simulcast encoder, a 720p encoder adapted for CPU, and a preview.
+constexpr std::pair<int, int> kConsumerResolutions[] = {
+    {960, 540}, {480, 270}, {1280, 720}, {640, 360}};
+
+rtc::scoped_refptr<I420Buffer> CreateRandomBuffer(int width, int height) {
+  Random random_generator(42U);
+  rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      buffer->MutableDataY()[y * buffer->StrideY() + x] =
+          static_cast<uint8_t>(random_generator.Rand(0, 255));
+    }
+  }
+  for (int y = 0; y < buffer->ChromaHeight(); ++y) {
+    for (int x = 0; x < buffer->ChromaWidth(); ++x) {
+      buffer->MutableDataU()[y * buffer->StrideU() + x] =
+          static_cast<uint8_t>(random_generator.Rand(0, 255));
+      buffer->MutableDataV()[y * buffer->StrideV() + x] =
+          static_cast<uint8_t>(random_generator.Rand(0, 255));
+    }
+  }
+  return buffer;
+}
+
+// Returns the CPU time in us per frame of |process|, which processes one
+// frame.
+template <typename Process>
+double MeasureUsPerFrame(Process process) {
+  process();
+  const int64_t start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+  for (int i = 0; i < kNumFrames; ++i) {
+    process();
+  }
+  return static_cast<double>(rtc::GetThreadCpuTimeNanos() - start_cpu_ns) /
+         kNumFrames / 1000.0;
+}
+
+}  // namespace
+
+// Measures the CPU time spent on scaling a 1080p frame for all its consumers,
+// when each of them scales the full resolution frame into a buffer of its own,
+// and when they share the pyramid of the frame. Both take their buffers from
+// pools, so only the scaling is compared.
+TEST(I420PyramidBufferPerformanceTest, ScaleFor1080pConsumers) {
+  const rtc::scoped_refptr<I420Buffer> frame = CreateRandomBuffer(1920, 1080);
+
+  I420BufferPool pools[arraysize(kConsumerResolutions)];
+  const double independent_us = MeasureUsPerFrame([&] {
+    for (size_t i = 0; i < arraysize(kConsumerResolutions); ++i) {
+      rtc::scoped_refptr<I420Buffer> scaled = pools[i].CreateBuffer(
+          kConsumerResolutions[i].first, kConsumerResolutions[i].second);
+      scaled->ScaleFrom(*frame);
+    }
+  });
+
+  rtc::scoped_refptr<I420PyramidBufferFactory> factory =
+      I420PyramidBufferFactory::Create();
+  const double pyramid_us = MeasureUsPerFrame([&] {
+    rtc::scoped_refptr<I420PyramidBuffer> pyramid = factory->Wrap(frame);
+    for (const auto& resolution : kConsumerResolutions) {
+      pyramid->GetScaledI420(resolution.first, resolution.second);
+    }
+  });
+
+  webrtc::test::PrintResult("i420_scaling_cpu_time_1080p", "", "independent",
+                            independent_us, "us", false);
+  webrtc::test::PrintResult("i420_scaling_cpu_time_1080p", "", "pyramid",
+                            pyramid_us, "us", false);
+  webrtc::test::PrintResult("i420_scaling_cpu_time_1080p", "", "saved",
+                            independent_us - pyramid_us, "us", false);
+}
+
+}  // namespace webrtc
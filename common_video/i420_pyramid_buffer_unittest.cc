@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/include/i420_pyramid_buffer.h"
+
+#include "api/video/i420_buffer.h"
+#include "common_video/libyuv/include/webrtc_libyuv.h"
+#include "test/frame_utils.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+rtc::scoped_refptr<I420Buffer> CreateGradientBuffer(int width, int height) {
+  rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      buffer->MutableDataY()[y * buffer->StrideY() + x] =
+          static_cast<uint8_t>((x * 255 / width + y * 255 / height) / 2);
+    }
+  }
+  for (int y = 0; y < buffer->ChromaHeight(); ++y) {
+    for (int x = 0; x < buffer->ChromaWidth(); ++x) {
+      buffer->MutableDataU()[y * buffer->StrideU() + x] =
+          static_cast<uint8_t>(x * 255 / buffer->ChromaWidth());
+      buffer->MutableDataV()[y * buffer->StrideV() + x] =
+          static_cast<uint8_t>(y * 255 / buffer->ChromaHeight());
+    }
+  }
+  return buffer;
+}
+
+}  // namespace
+
+TEST(I420PyramidBufferTest, ForwardsWrappedBuffer) {
+  rtc::scoped_refptr<I420Buffer> buffer = CreateGradientBuffer(64, 48);
+  rtc::scoped_refptr<I420PyramidBuffer> pyramid =
+      I420PyramidBufferFactory::Create()->Wrap(buffer);
+  EXPECT_EQ(VideoFrameBuffer::Type::kI420, pyramid->type());
+  EXPECT_EQ(64, pyramid->width());
+  EXPECT_EQ(48, pyramid->height());
+  EXPECT_EQ(buffer->DataY(), pyramid->DataY());
+  EXPECT_EQ(buffer->DataU(), pyramid->DataU());
+  EXPECT_EQ(buffer->DataV(), pyramid->DataV());
+  EXPECT_EQ(buffer->StrideY(), pyramid->StrideY());
+  EXPECT_EQ(buffer->StrideU(), pyramid->StrideU());
+  EXPECT_EQ(buffer->StrideV(), pyramid->StrideV());
+  EXPECT_EQ(buffer.get(), pyramid->GetScaledI420(64, 48).get());
+}
+
+TEST(I420PyramidBufferTest, PlainBuffersHaveNoScaledBuffers) {
+  rtc::scoped_refptr<VideoFrameBuffer> buffer = CreateGradientBuffer(64, 48);
+  EXPECT_FALSE(buffer->GetScaledBuffer(32, 24));
+}
+
+TEST(I420PyramidBufferTest, LevelsMatchScalingFromFullResolution) {
+  rtc::scoped_refptr<I420Buffer> buffer = CreateGradientBuffer(640, 360);
+  rtc::scoped_refptr<I420PyramidBuffer> pyramid =
+      I420PyramidBufferFactory::Create()->Wrap(buffer);
+
+  // A 2:1 box filter gives the same result, whether it is applied once or
+  // the pyramid does it.
+  rtc::scoped_refptr<I420Buffer> expected = I420Buffer::Create(320, 180);
+  expected->ScaleFrom(*buffer);
+  EXPECT_TRUE(
+      test::FrameBufsEqual(expected, pyramid->GetScaledBuffer(320, 180)));
+
+  // Further levels are close to scaling from the full resolution.
+  expected = I420Buffer::Create(160, 90);
+  expected->ScaleFrom(*buffer);
+  EXPECT_GT(I420PSNR(*expected, *pyramid->GetScaledI420(160, 90)), 40);
+}
+
+TEST(I420PyramidBufferTest, ScalesFromSmallestLargerLevel) {
+  rtc::scoped_refptr<I420Buffer> buffer = CreateGradientBuffer(640, 360);
+  rtc::scoped_refptr<I420PyramidBuffer> pyramid =
+      I420PyramidBufferFactory::Create()->Wrap(buffer);
+
+  rtc::scoped_refptr<I420BufferInterface> scaled =
+      pyramid->GetScaledI420(240, 135);
+  rtc::scoped_refptr<I420Buffer> expected = I420Buffer::Create(240, 135);
+  expected->ScaleFrom(*pyramid->GetScaledI420(320, 180));
+  EXPECT_TRUE(test::FrameBufsEqual(expected, scaled));
+
+  rtc::scoped_refptr<I420Buffer> direct = I420Buffer::Create(240, 135);
+  direct->ScaleFrom(*buffer);
+  EXPECT_GT(I420PSNR(*direct, *scaled), 40);
+}
+
+TEST(I420PyramidBufferTest, ReturnsSameBufferForSameResolution) {
+  rtc::scoped_refptr<I420PyramidBuffer> pyramid =
+      I420PyramidBufferFactory::Create()->Wrap(CreateGradientBuffer(640, 360));
+  rtc::scoped_refptr<VideoFrameBuffer> level =
+      pyramid->GetScaledBuffer(320, 180);
+  rtc::scoped_refptr<VideoFrameBuffer> scaled =
+      pyramid->GetScaledBuffer(240, 135);
+  EXPECT_EQ(level.get(), pyramid->GetScaledBuffer(320, 180).get());
+  EXPECT_EQ(scaled.get(), pyramid->GetScaledBuffer(240, 135).get());
+  EXPECT_NE(level.get(), scaled.get());
+}
+
+TEST(I420PyramidBufferTest, HandlesOddResolutions) {
+  rtc::scoped_refptr<I420PyramidBuffer> pyramid =
+      I420PyramidBufferFactory::Create()->Wrap(CreateGradientBuffer(99, 75));
+  for (int width = 1, height = 1; width <= 99; width += 7, height += 5) {
+    rtc::scoped_refptr<I420BufferInterface> scaled =
+        pyramid->GetScaledI420(width, height);
+    EXPECT_EQ(width, scaled->width());
+    EXPECT_EQ(height, scaled->height());
+  }
+}
+
+TEST(I420PyramidBufferTest, ReusesMemoryOfReleasedPyramids) {
+  rtc::scoped_refptr<I420PyramidBufferFactory> factory =
+      I420PyramidBufferFactory::Create();
+  rtc::scoped_refptr<I420PyramidBuffer> pyramid =
+      factory->Wrap(CreateGradientBuffer(640, 360));
+  const uint8_t* level_data = pyramid->GetScaledI420(320, 180)->DataY();
+  const uint8_t* scaled_data = pyramid->GetScaledI420(240, 135)->DataY();
+  pyramid = nullptr;
+
+  pyramid = factory->Wrap(CreateGradientBuffer(640, 360));
+  EXPECT_EQ(level_data, pyramid->GetScaledI420(320, 180)->DataY());
+  EXPECT_EQ(scaled_data, pyramid->GetScaledI420(240, 135)->DataY());
+}
+
+TEST(I420PyramidBufferTest, ScaledBuffersOutliveFactoryAndPyramid) {
+  rtc::scoped_refptr<I420PyramidBufferFactory> factory =
+      I420PyramidBufferFactory::Create();
+  rtc::scoped_refptr<I420PyramidBuffer> pyramid =
+      factory->Wrap(CreateGradientBuffer(640, 360));
+  factory = nullptr;
+  rtc::scoped_refptr<I420BufferInterface> scaled =
+      pyramid->GetScaledI420(240, 135);
+  pyramid = nullptr;
+  EXPECT_EQ(240, scaled->width());
+  EXPECT_EQ(135, scaled->height());
+}
+
+}  // namespace webrtc
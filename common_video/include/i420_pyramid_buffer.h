@@ -0,0 +1,120 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_VIDEO_INCLUDE_I420_PYRAMID_BUFFER_H_
+#define COMMON_VIDEO_INCLUDE_I420_PYRAMID_BUFFER_H_
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "api/video/i420_buffer.h"
+#include "api/video/video_frame_buffer.h"
+#include "common_video/include/i420_buffer_pool.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/refcount.h"
+#include "rtc_base/scoped_ref_ptr.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+class I420PyramidBufferFactory;
+
+// An I420 buffer that keeps a pyramid of downscaled versions of itself, so
+// that all the consumers of a frame that need it at lower resolutions, e.g.
+// the simulcast encoders and the sinks of a VideoBroadcaster, share the
+// scaling work. The levels of the pyramid are built on first use, each from
+// the previous one with a 2:1 box filter. A scaled version is then made from
+// the smallest level that is at least as large, and kept for the next
+// consumer asking for the same resolution. The pixel data of the buffer
+// itself is the one of the wrapped buffer. Thread-safe.
+class I420PyramidBuffer : public I420BufferInterface {
+ public:
+  int width() const override;
+  int height() const override;
+  const uint8_t* DataY() const override;
+  const uint8_t* DataU() const override;
+  const uint8_t* DataV() const override;
+  int StrideY() const override;
+  int StrideU() const override;
+  int StrideV() const override;
+
+  // Never returns null.
+  rtc::scoped_refptr<VideoFrameBuffer> GetScaledBuffer(
+      int scaled_width,
+      int scaled_height) override;
+
+  // Returns the buffer scaled to |scaled_width| x |scaled_height|. Returns the
+  // same buffer for the same resolution. Scaling up is done from the buffer
+  // itself.
+  rtc::scoped_refptr<I420BufferInterface> GetScaledI420(int scaled_width,
+                                                        int scaled_height);
+
+ protected:
+  I420PyramidBuffer(rtc::scoped_refptr<I420BufferInterface> buffer,
+                    rtc::scoped_refptr<I420PyramidBufferFactory> factory);
+  ~I420PyramidBuffer() override;
+
+ private:
+  friend class I420PyramidBufferFactory;
+
+  // Returns the smallest level that is at least |width| x |height|, building
+  // the missing levels.
+  rtc::scoped_refptr<I420BufferInterface> GetLevel(int width, int height)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  const rtc::scoped_refptr<I420BufferInterface> buffer_;
+  const rtc::scoped_refptr<I420PyramidBufferFactory> factory_;
+
+  // Held while scaling, so that concurrent consumers asking for the same
+  // resolution wait for each other instead of both doing the work.
+  rtc::CriticalSection crit_;
+  // |levels_[0]| is |buffer_|, and every other level is half the size of the
+  // previous one, rounded up.
+  std::vector<rtc::scoped_refptr<I420BufferInterface>> levels_
+      RTC_GUARDED_BY(crit_);
+  // Scaled versions returned by GetScaledI420() that are not levels.
+  std::vector<rtc::scoped_refptr<I420BufferInterface>> scaled_buffers_
+      RTC_GUARDED_BY(crit_);
+};
+
+// Wraps I420 buffers into I420PyramidBuffers, and owns the pools that the
+// levels and the scaled versions of these are allocated from. A video source
+// uses one factory for all its frames, so that the memory of the pyramid of
+// a frame is reused by the next ones. The pyramid buffers keep the factory
+// alive. Thread-safe.
+class I420PyramidBufferFactory : public rtc::RefCountInterface {
+ public:
+  static rtc::scoped_refptr<I420PyramidBufferFactory> Create();
+
+  rtc::scoped_refptr<I420PyramidBuffer> Wrap(
+      rtc::scoped_refptr<I420BufferInterface> buffer);
+
+ protected:
+  I420PyramidBufferFactory();
+  ~I420PyramidBufferFactory() override;
+
+ private:
+  friend class I420PyramidBuffer;
+
+  // Returns a buffer from the pool for |width| x |height|.
+  rtc::scoped_refptr<I420Buffer> CreateBuffer(int width, int height);
+
+  rtc::CriticalSection crit_;
+  // An I420BufferPool only keeps buffers of one resolution, so there is one
+  // pool for every resolution in use.
+  std::map<std::pair<int, int>, std::unique_ptr<I420BufferPool>> pools_
+      RTC_GUARDED_BY(crit_);
+};
+
+}  // namespace webrtc
+
+#endif  // COMMON_VIDEO_INCLUDE_I420_PYRAMID_BUFFER_H_
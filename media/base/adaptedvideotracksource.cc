@@ -14,12 +14,14 @@
 
 namespace rtc {
 
-AdaptedVideoTrackSource::AdaptedVideoTrackSource() {
+AdaptedVideoTrackSource::AdaptedVideoTrackSource()
+    : pyramid_factory_(webrtc::I420PyramidBufferFactory::Create()) {
   thread_checker_.DetachFromThread();
 }
 
 AdaptedVideoTrackSource::AdaptedVideoTrackSource(int required_alignment)
-    : video_adapter_(required_alignment) {
+    : video_adapter_(required_alignment),
+      pyramid_factory_(webrtc::I420PyramidBufferFactory::Create()) {
   thread_checker_.DetachFromThread();
 }
 AdaptedVideoTrackSource::~AdaptedVideoTrackSource() = default;
@@ -50,8 +52,20 @@ void AdaptedVideoTrackSource::OnFrame(const webrtc::VideoFrame& frame) {
       buffer->type() == webrtc::VideoFrameBuffer::Type::kI420) {
     /* Apply pending rotation. */
     broadcaster_.OnFrame(webrtc::VideoFrame(
-        webrtc::I420Buffer::Rotate(*buffer->GetI420(), frame.rotation()),
+        pyramid_factory_->Wrap(
+            webrtc::I420Buffer::Rotate(*buffer->GetI420(), frame.rotation())),
         webrtc::kVideoRotation_0, frame.timestamp_us()));
+  } else if (buffer->type() == webrtc::VideoFrameBuffer::Type::kI420) {
+    /* Let the sinks share the scaling of the frame. */
+    broadcaster_.OnFrame(
+        webrtc::VideoFrame::Builder()
+            .set_video_frame_buffer(pyramid_factory_->Wrap(buffer->GetI420()))
+            .set_timestamp_us(frame.timestamp_us())
+            .set_timestamp_rtp(frame.timestamp())
+            .set_ntp_time_ms(frame.ntp_time_ms())
+            .set_rotation(frame.rotation())
+            .set_color_space(frame.color_space())
+            .build());
   } else {
     broadcaster_.OnFrame(frame);
   }
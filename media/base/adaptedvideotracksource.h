@@ -13,6 +13,7 @@
 
 #include "api/mediastreaminterface.h"
 #include "api/notifier.h"
+#include "common_video/include/i420_pyramid_buffer.h"
 #include "media/base/videoadapter.h"
 #include "media/base/videobroadcaster.h"
 
@@ -34,7 +35,8 @@ class AdaptedVideoTrackSource
   explicit AdaptedVideoTrackSource(int required_alignment);
   // Checks the apply_rotation() flag. If the frame needs rotation, and it is a
   // plain memory frame, it is rotated. Subclasses producing native frames must
-  // handle apply_rotation() themselves.
+  // handle apply_rotation() themselves. I420 frames are given a downscale
+  // pyramid, shared by the sinks that scale them.
   void OnFrame(const webrtc::VideoFrame& frame);
 
   // Reports the appropriate frame size after adaptation. Returns true
@@ -78,6 +80,8 @@ class AdaptedVideoTrackSource
   absl::optional<Stats> stats_ RTC_GUARDED_BY(stats_crit_);
 
   VideoBroadcaster broadcaster_;
+
+  const rtc::scoped_refptr<webrtc::I420PyramidBufferFactory> pyramid_factory_;
 };
 
 }  // namespace rtc
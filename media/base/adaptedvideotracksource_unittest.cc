@@ -0,0 +1,135 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "media/base/adaptedvideotracksource.h"
+
+#include "api/video/i420_buffer.h"
+#include "api/video/video_frame.h"
+#include "media/base/fakevideorenderer.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/refcountedobject.h"
+#include "test/fake_texture_frame.h"
+
+using cricket::FakeVideoRenderer;
+
+namespace rtc {
+
+namespace {
+
+class TestVideoTrackSource : public AdaptedVideoTrackSource {
+ public:
+  // Delivers a frame the way a capturer would, after asking the adapter for
+  // the resolution the sinks need.
+  bool DeliverFrame(int width, int height, int64_t time_us) {
+    return Deliver(width, height, time_us, false);
+  }
+
+  // Same as above, but delivers a native frame, which the broadcaster can't
+  // scale down for individual sinks.
+  bool DeliverNativeFrame(int width, int height, int64_t time_us) {
+    return Deliver(width, height, time_us, true);
+  }
+
+  SourceState state() const override { return kLive; }
+  bool remote() const override { return false; }
+  bool is_screencast() const override { return false; }
+  absl::optional<bool> needs_denoising() const override {
+    return absl::nullopt;
+  }
+
+ private:
+  bool Deliver(int width, int height, int64_t time_us, bool native) {
+    int out_width;
+    int out_height;
+    int crop_width;
+    int crop_height;
+    int crop_x;
+    int crop_y;
+    if (!AdaptFrame(width, height, time_us, &out_width, &out_height,
+                    &crop_width, &crop_height, &crop_x, &crop_y)) {
+      return false;
+    }
+    if (native) {
+      OnFrame(webrtc::VideoFrame(
+          new rtc::RefCountedObject<webrtc::test::FakeNativeBuffer>(
+              out_width, out_height),
+          webrtc::kVideoRotation_0, time_us));
+      return true;
+    }
+    rtc::scoped_refptr<webrtc::I420Buffer> buffer =
+        webrtc::I420Buffer::Create(out_width, out_height);
+    buffer->InitializeData();
+    OnFrame(webrtc::VideoFrame(buffer, webrtc::kVideoRotation_0, time_us));
+    return true;
+  }
+};
+
+}  // namespace
+
+TEST(AdaptedVideoTrackSourceTest, DeliversLargestResolutionToScaledSinks) {
+  rtc::scoped_refptr<TestVideoTrackSource> source(
+      new rtc::RefCountedObject<TestVideoTrackSource>());
+  VideoSourceInterface<webrtc::VideoFrame>* video_source = source.get();
+
+  FakeVideoRenderer hd_sink;
+  VideoSinkWants hd_wants;
+  hd_wants.max_pixel_count = 1920 * 1080;
+  hd_wants.accepts_scaled_frames = true;
+  video_source->AddOrUpdateSink(&hd_sink, hd_wants);
+
+  FakeVideoRenderer sd_sink;
+  VideoSinkWants sd_wants;
+  sd_wants.max_pixel_count = 640 * 360;
+  sd_wants.accepts_scaled_frames = true;
+  video_source->AddOrUpdateSink(&sd_sink, sd_wants);
+
+  EXPECT_TRUE(source->DeliverFrame(1920, 1080, 1000));
+
+  EXPECT_EQ(1, hd_sink.num_rendered_frames());
+  EXPECT_EQ(1920, hd_sink.width());
+  EXPECT_EQ(1080, hd_sink.height());
+
+  EXPECT_EQ(1, sd_sink.num_rendered_frames());
+  EXPECT_EQ(640, sd_sink.width());
+  EXPECT_EQ(360, sd_sink.height());
+
+  video_source->RemoveSink(&hd_sink);
+  video_source->RemoveSink(&sd_sink);
+}
+
+// An encoder relies on the source keeping to its max_pixel_count when it
+// adapts down, also when a renderer without limits shares the track and the
+// frames are native, so the broadcaster can't scale them.
+TEST(AdaptedVideoTrackSourceTest, KeepsToEncoderWantsWithUnlimitedRenderer) {
+  rtc::scoped_refptr<TestVideoTrackSource> source(
+      new rtc::RefCountedObject<TestVideoTrackSource>());
+  VideoSourceInterface<webrtc::VideoFrame>* video_source = source.get();
+
+  FakeVideoRenderer renderer;
+  video_source->AddOrUpdateSink(&renderer, VideoSinkWants());
+
+  FakeVideoRenderer encoder_sink;
+  VideoSinkWants encoder_wants;
+  encoder_wants.max_pixel_count = 640 * 360;
+  video_source->AddOrUpdateSink(&encoder_sink, encoder_wants);
+
+  EXPECT_TRUE(source->DeliverNativeFrame(1920, 1080, 1000));
+
+  EXPECT_EQ(1, encoder_sink.num_rendered_frames());
+  EXPECT_LE(encoder_sink.width() * encoder_sink.height(), 640 * 360);
+  EXPECT_EQ(1, renderer.num_rendered_frames());
+  EXPECT_EQ(encoder_sink.width(), renderer.width());
+  EXPECT_EQ(encoder_sink.height(), renderer.height());
+
+  video_source->RemoveSink(&renderer);
+  video_source->RemoveSink(&encoder_sink);
+}
+
+}  // namespace rtc
@@ -10,15 +10,93 @@
 
 #include "media/base/videobroadcaster.h"
 
+#include <algorithm>
 #include <limits>
+#include <vector>
 
 #include "api/video/i420_buffer.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 
 namespace rtc {
+namespace {
+
+// Computes the resolution of a |width| x |height| frame scaled down by the
+// largest of the factors 3/4, 1/2, 3/8, 1/4, 3/16... that leaves at most
+// |max_pixel_count| pixels, as cricket::VideoAdapter would. Limiting the
+// factors lets sinks with close limits share a resolution, and makes half of
+// them levels of the frame pyramid.
+void ComputeScaledResolution(int width,
+                             int height,
+                             int max_pixel_count,
+                             int* scaled_width,
+                             int* scaled_height) {
+  for (int shift = 0; shift < 31; ++shift) {
+    for (int numerator : {4, 3}) {
+      *scaled_width = std::max(
+          1, static_cast<int>((int64_t{width} * numerator) >> (shift + 2)));
+      *scaled_height = std::max(
+          1, static_cast<int>((int64_t{height} * numerator) >> (shift + 2)));
+      if (*scaled_width * *scaled_height <= max_pixel_count ||
+          (*scaled_width == 1 && *scaled_height == 1)) {
+        return;
+      }
+    }
+  }
+}
+
+// Makes the versions of one frame scaled for the sinks, once per resolution,
+// when the first sink needs it.
+class ScaledFrames {
+ public:
+  ScaledFrames(const webrtc::VideoFrame& frame,
+               webrtc::I420PyramidBufferFactory* pyramid_factory)
+      : frame_(frame),
+        pyramid_factory_(pyramid_factory),
+        scalable_buffer_(frame.video_frame_buffer()) {}
+
+  // Returns the frame scaled down to at most |max_pixel_count| pixels.
+  webrtc::VideoFrame Get(int max_pixel_count) {
+    int scaled_width = 0;
+    int scaled_height = 0;
+    ComputeScaledResolution(frame_.width(), frame_.height(), max_pixel_count,
+                            &scaled_width, &scaled_height);
+    for (const webrtc::VideoFrame& scaled_frame : scaled_frames_) {
+      if (scaled_frame.width() == scaled_width &&
+          scaled_frame.height() == scaled_height) {
+        return scaled_frame;
+      }
+    }
+    // Frames with a pyramid share the scaling with their other consumers.
+    rtc::scoped_refptr<webrtc::VideoFrameBuffer> scaled_buffer =
+        scalable_buffer_->GetScaledBuffer(scaled_width, scaled_height);
+    if (!scaled_buffer) {
+      scalable_buffer_ = pyramid_factory_->Wrap(scalable_buffer_->ToI420());
+      scaled_buffer =
+          scalable_buffer_->GetScaledBuffer(scaled_width, scaled_height);
+    }
+    scaled_frames_.push_back(webrtc::VideoFrame::Builder()
+                                 .set_video_frame_buffer(scaled_buffer)
+                                 .set_timestamp_us(frame_.timestamp_us())
+                                 .set_timestamp_rtp(frame_.timestamp())
+                                 .set_ntp_time_ms(frame_.ntp_time_ms())
+                                 .set_rotation(frame_.rotation())
+                                 .set_color_space(frame_.color_space())
+                                 .build());
+    return scaled_frames_.back();
+  }
+
+ private:
+  const webrtc::VideoFrame& frame_;
+  webrtc::I420PyramidBufferFactory* const pyramid_factory_;
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> scalable_buffer_;
+  std::vector<webrtc::VideoFrame> scaled_frames_;
+};
 
-VideoBroadcaster::VideoBroadcaster() {
+}  // namespace
+
+VideoBroadcaster::VideoBroadcaster()
+    : pyramid_factory_(webrtc::I420PyramidBufferFactory::Create()) {
   thread_checker_.DetachFromThread();
 }
 VideoBroadcaster::~VideoBroadcaster() = default;
@@ -54,6 +132,11 @@ VideoSinkWants VideoBroadcaster::wants() const {
 
 void VideoBroadcaster::OnFrame(const webrtc::VideoFrame& frame) {
   rtc::CritScope cs(&sinks_and_wants_lock_);
+  // Native frames are passed on as they are, the sinks are expected to be
+  // able to scale them.
+  const bool scalable = frame.video_frame_buffer()->type() !=
+                        webrtc::VideoFrameBuffer::Type::kNative;
+  ScaledFrames scaled_frames(frame, pyramid_factory_.get());
   for (auto& sink_pair : sink_pairs()) {
     if (sink_pair.wants.rotation_applied &&
         frame.rotation() != webrtc::kVideoRotation_0) {
@@ -68,6 +151,11 @@ void VideoBroadcaster::OnFrame(const webrtc::VideoFrame& frame) {
       sink_pair.sink->OnFrame(
           webrtc::VideoFrame(GetBlackFrameBuffer(frame.width(), frame.height()),
                              frame.rotation(), frame.timestamp_us()));
+    } else if (scalable && !sink_pair.wants.adapts_resolution &&
+               frame.size() >
+                   static_cast<uint32_t>(sink_pair.wants.max_pixel_count)) {
+      sink_pair.sink->OnFrame(
+          scaled_frames.Get(sink_pair.wants.max_pixel_count));
     } else {
       sink_pair.sink->OnFrame(frame);
     }
@@ -83,31 +171,57 @@ void VideoBroadcaster::OnDiscardedFrame() {
 void VideoBroadcaster::UpdateWants() {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
 
+  // The source keeps to the smallest pixel counts of the sinks, except for
+  // the sinks that accept frames scaled down for them: those only need the
+  // source to meet the largest of their pixel counts.
   VideoSinkWants wants;
   wants.rotation_applied = false;
+  int scaled_max_pixel_count = 0;
+  absl::optional<int> scaled_target_pixel_count;
+  bool has_scaled_sinks = false;
   for (auto& sink : sink_pairs()) {
     // wants.rotation_applied == ANY(sink.wants.rotation_applied)
     if (sink.wants.rotation_applied) {
       wants.rotation_applied = true;
     }
-    // wants.max_pixel_count == MIN(sink.wants.max_pixel_count)
-    if (sink.wants.max_pixel_count < wants.max_pixel_count) {
-      wants.max_pixel_count = sink.wants.max_pixel_count;
-    }
-    // Select the minimum requested target_pixel_count, if any, of all sinks so
-    // that we don't over utilize the resources for any one.
-    // TODO(sprang): Consider using the median instead, since the limit can be
-    // expressed by max_pixel_count.
-    if (sink.wants.target_pixel_count &&
-        (!wants.target_pixel_count ||
-         (*sink.wants.target_pixel_count < *wants.target_pixel_count))) {
-      wants.target_pixel_count = sink.wants.target_pixel_count;
+    if (sink.wants.accepts_scaled_frames) {
+      has_scaled_sinks = true;
+      scaled_max_pixel_count =
+          std::max(scaled_max_pixel_count, sink.wants.max_pixel_count);
+      if (sink.wants.target_pixel_count &&
+          (!scaled_target_pixel_count ||
+           *sink.wants.target_pixel_count > *scaled_target_pixel_count)) {
+        scaled_target_pixel_count = sink.wants.target_pixel_count;
+      }
+    } else {
+      // wants.max_pixel_count == MIN(sink.wants.max_pixel_count)
+      if (sink.wants.max_pixel_count < wants.max_pixel_count) {
+        wants.max_pixel_count = sink.wants.max_pixel_count;
+      }
+      // Select the minimum requested target_pixel_count, if any, of all sinks
+      // so that we don't over utilize the resources for any one.
+      // TODO(sprang): Consider using the median instead, since the limit can
+      // be expressed by max_pixel_count.
+      if (sink.wants.target_pixel_count &&
+          (!wants.target_pixel_count ||
+           (*sink.wants.target_pixel_count < *wants.target_pixel_count))) {
+        wants.target_pixel_count = sink.wants.target_pixel_count;
+      }
     }
     // Select the minimum for the requested max framerates.
     if (sink.wants.max_framerate_fps < wants.max_framerate_fps) {
       wants.max_framerate_fps = sink.wants.max_framerate_fps;
     }
   }
+  if (has_scaled_sinks) {
+    wants.max_pixel_count =
+        std::min(wants.max_pixel_count, scaled_max_pixel_count);
+    if (scaled_target_pixel_count &&
+        (!wants.target_pixel_count ||
+         *scaled_target_pixel_count < *wants.target_pixel_count)) {
+      wants.target_pixel_count = scaled_target_pixel_count;
+    }
+  }
 
   if (wants.target_pixel_count &&
       *wants.target_pixel_count >= wants.max_pixel_count) {
@@ -17,6 +17,7 @@
 
 #include "api/video/video_frame.h"
 #include "api/video/video_sink_interface.h"
+#include "common_video/include/i420_pyramid_buffer.h"
 #include "media/base/videosourcebase.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/thread_checker.h"
@@ -29,6 +30,12 @@ namespace rtc {
 // Sinks must be added and removed on one and only one thread.
 // Video frames can be broadcasted on any thread. I.e VideoBroadcaster::OnFrame
 // can be called on any thread.
+// Frames with more pixels than the max_pixel_count of a sink are scaled down
+// for it, unless it adapts the resolution itself. Each scaled resolution is
+// made once per frame, when the first sink needs it, and shared by all the
+// sinks that get it. Native frames are passed on unscaled. The source is asked
+// for the smallest resolution of the sinks, except that sinks accepting
+// scaled frames only limit it to the largest resolution they ask for.
 class VideoBroadcaster : public VideoSourceBase,
                          public VideoSinkInterface<webrtc::VideoFrame> {
  public:
@@ -64,6 +71,8 @@ class VideoBroadcaster : public VideoSourceBase,
 
   VideoSinkWants current_wants_ RTC_GUARDED_BY(sinks_and_wants_lock_);
   rtc::scoped_refptr<webrtc::VideoFrameBuffer> black_frame_buffer_;
+  // Provides the scaled buffers for frames that carry no pyramid.
+  const rtc::scoped_refptr<webrtc::I420PyramidBufferFactory> pyramid_factory_;
 };
 
 }  // namespace rtc
@@ -0,0 +1,154 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/video/i420_buffer.h"
+#include "api/video/video_frame.h"
+#include "media/base/videobroadcaster.h"
+#include "rtc_base/arraysize.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace rtc {
+namespace {
+
+constexpr int kWidth = 1920;
+constexpr int kHeight = 1080;
+constexpr int kNumFrames = 100;
+
+// The limits of the sinks, e.g. recorders, previews of several sizes and
+// encoders adapted for CPU. Sink i gets the limit i modulo their number.
+constexpr int kMaxPixelCounts[] = {std::numeric_limits<int>::max(),
+                                   1280 * 720,
+                                   960 * 540,
+                                   640 * 360,
+                                   480 * 270,
+                                   320 * 180,
+                                   1280 * 720,
+                                   640 * 360};
+
+// A sink that scales the frames to its limit itself, with a buffer of its
+// own, as the sinks had to when the broadcaster did not scale.
+class SelfScalingSink : public VideoSinkInterface<webrtc::VideoFrame> {
+ public:
+  explicit SelfScalingSink(int max_pixel_count)
+      : max_pixel_count_(max_pixel_count) {}
+
+  void OnFrame(const webrtc::VideoFrame& frame) override {
+    if (frame.size() <= static_cast<uint32_t>(max_pixel_count_))
+      return;
+    const double scale = std::sqrt(static_cast<double>(max_pixel_count_) /
+                                   frame.size());
+    rtc::scoped_refptr<webrtc::I420Buffer> scaled_buffer =
+        webrtc::I420Buffer::Create(static_cast<int>(frame.width() * scale),
+                                   static_cast<int>(frame.height() * scale));
+    scaled_buffer->ScaleFrom(*frame.video_frame_buffer()->ToI420());
+  }
+
+ private:
+  const int max_pixel_count_;
+};
+
+// A sink that takes the frames as they come.
+class PassiveSink : public VideoSinkInterface<webrtc::VideoFrame> {
+ public:
+  void OnFrame(const webrtc::VideoFrame& frame) override {
+    num_pixels_ += frame.size();
+  }
+
+  uint64_t num_pixels() const { return num_pixels_; }
+
+ private:
+  uint64_t num_pixels_ = 0;
+};
+
+webrtc::VideoFrame CreateRandomFrame() {
+  webrtc::Random random_generator(42U);
+  rtc::scoped_refptr<webrtc::I420Buffer> buffer =
+      webrtc::I420Buffer::Create(kWidth, kHeight);
+  const int size_y = buffer->StrideY() * kHeight;
+  const int size_uv = buffer->StrideU() * buffer->ChromaHeight();
+  for (int i = 0; i < size_y; ++i) {
+    buffer->MutableDataY()[i] =
+        static_cast<uint8_t>(random_generator.Rand(0, 255));
+  }
+  for (int i = 0; i < size_uv; ++i) {
+    buffer->MutableDataU()[i] =
+        static_cast<uint8_t>(random_generator.Rand(0, 255));
+    buffer->MutableDataV()[i] =
+        static_cast<uint8_t>(random_generator.Rand(0, 255));
+  }
+  return webrtc::VideoFrame(buffer, webrtc::kVideoRotation_0, 0);
+}
+
+// Returns the CPU time in us per frame spent by |broadcaster| and its sinks.
+double MeasureUsPerFrame(VideoBroadcaster* broadcaster,
+                         const webrtc::VideoFrame& frame) {
+  broadcaster->OnFrame(frame);
+  const int64_t start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+  for (int i = 0; i < kNumFrames; ++i) {
+    broadcaster->OnFrame(frame);
+  }
+  return static_cast<double>(rtc::GetThreadCpuTimeNanos() - start_cpu_ns) /
+         kNumFrames / 1000.0;
+}
+
+}  // namespace
+
+// Measures the CPU time spent on delivering a 1080p frame to sinks with
+// different limits, when each sink scales the frame itself and when the
+// broadcaster scales it once per resolution.
+TEST(VideoBroadcasterPerformanceTest, ScaleForHeterogeneousSinks) {
+  const webrtc::VideoFrame frame = CreateRandomFrame();
+  const int kNumSinks[] = {1, 4, 16};
+  for (int num_sinks : kNumSinks) {
+    const std::string sinks = "_" + std::to_string(num_sinks) + "_sinks";
+
+    VideoBroadcaster sink_scaling_broadcaster;
+    std::vector<std::unique_ptr<SelfScalingSink>> self_scaling_sinks;
+    for (int i = 0; i < num_sinks; ++i) {
+      const int max_pixel_count =
+          kMaxPixelCounts[i % arraysize(kMaxPixelCounts)];
+      self_scaling_sinks.emplace_back(new SelfScalingSink(max_pixel_count));
+      VideoSinkWants wants;
+      wants.max_pixel_count = max_pixel_count;
+      wants.adapts_resolution = true;
+      sink_scaling_broadcaster.AddOrUpdateSink(self_scaling_sinks.back().get(),
+                                               wants);
+    }
+
+    VideoBroadcaster broadcaster;
+    std::vector<std::unique_ptr<PassiveSink>> passive_sinks;
+    for (int i = 0; i < num_sinks; ++i) {
+      passive_sinks.emplace_back(new PassiveSink());
+      VideoSinkWants wants;
+      wants.max_pixel_count = kMaxPixelCounts[i % arraysize(kMaxPixelCounts)];
+      broadcaster.AddOrUpdateSink(passive_sinks.back().get(), wants);
+    }
+
+    webrtc::test::PrintResult(
+        "video_broadcaster_cpu_time_1080p", sinks, "sinks_scaling",
+        MeasureUsPerFrame(&sink_scaling_broadcaster, frame), "us", false);
+    webrtc::test::PrintResult("video_broadcaster_cpu_time_1080p", sinks,
+                              "broadcaster_scaling",
+                              MeasureUsPerFrame(&broadcaster, frame), "us",
+                              false);
+    EXPECT_LT(0u, passive_sinks.back()->num_pixels());
+  }
+}
+
+}  // namespace rtc
@@ -12,6 +12,7 @@
 
 #include "api/video/i420_buffer.h"
 #include "api/video/video_frame.h"
+#include "common_video/include/i420_pyramid_buffer.h"
 #include "media/base/fakevideorenderer.h"
 #include "media/base/videobroadcaster.h"
 #include "rtc_base/gunit.h"
@@ -20,6 +21,34 @@ using rtc::VideoBroadcaster;
 using rtc::VideoSinkWants;
 using cricket::FakeVideoRenderer;
 
+namespace {
+
+class BufferRecordingSink : public rtc::VideoSinkInterface<webrtc::VideoFrame> {
+ public:
+  void OnFrame(const webrtc::VideoFrame& frame) override {
+    buffer_ = frame.video_frame_buffer();
+    timestamp_us_ = frame.timestamp_us();
+  }
+
+  const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& buffer() const {
+    return buffer_;
+  }
+  int64_t timestamp_us() const { return timestamp_us_; }
+
+ private:
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer_;
+  int64_t timestamp_us_ = 0;
+};
+
+webrtc::VideoFrame CreateFrame(int width, int height, int64_t timestamp_us) {
+  rtc::scoped_refptr<webrtc::I420Buffer> buffer(
+      webrtc::I420Buffer::Create(width, height));
+  webrtc::I420Buffer::SetBlack(buffer);
+  return webrtc::VideoFrame(buffer, webrtc::kVideoRotation_0, timestamp_us);
+}
+
+}  // namespace
+
 TEST(VideoBroadcasterTest, frame_wanted) {
   VideoBroadcaster broadcaster;
   EXPECT_FALSE(broadcaster.frame_wanted());
@@ -94,6 +123,7 @@ TEST(VideoBroadcasterTest, AppliesMinOfSinkWantsMaxPixelCount) {
   FakeVideoRenderer sink1;
   VideoSinkWants wants1;
   wants1.max_pixel_count = 1280 * 720;
+  wants1.adapts_resolution = true;
 
   broadcaster.AddOrUpdateSink(&sink1, wants1);
   EXPECT_EQ(1280 * 720, broadcaster.wants().max_pixel_count);
@@ -101,6 +131,7 @@ TEST(VideoBroadcasterTest, AppliesMinOfSinkWantsMaxPixelCount) {
   FakeVideoRenderer sink2;
   VideoSinkWants wants2;
   wants2.max_pixel_count = 640 * 360;
+  wants2.adapts_resolution = true;
   broadcaster.AddOrUpdateSink(&sink2, wants2);
   EXPECT_EQ(640 * 360, broadcaster.wants().max_pixel_count);
 
@@ -115,6 +146,7 @@ TEST(VideoBroadcasterTest, AppliesMinOfSinkWantsMaxAndTargetPixelCount) {
   FakeVideoRenderer sink1;
   VideoSinkWants wants1;
   wants1.target_pixel_count = 1280 * 720;
+  wants1.adapts_resolution = true;
 
   broadcaster.AddOrUpdateSink(&sink1, wants1);
   EXPECT_EQ(1280 * 720, *broadcaster.wants().target_pixel_count);
@@ -122,6 +154,7 @@ TEST(VideoBroadcasterTest, AppliesMinOfSinkWantsMaxAndTargetPixelCount) {
   FakeVideoRenderer sink2;
   VideoSinkWants wants2;
   wants2.target_pixel_count = 640 * 360;
+  wants2.adapts_resolution = true;
   broadcaster.AddOrUpdateSink(&sink2, wants2);
   EXPECT_EQ(640 * 360, *broadcaster.wants().target_pixel_count);
 
@@ -129,6 +162,56 @@ TEST(VideoBroadcasterTest, AppliesMinOfSinkWantsMaxAndTargetPixelCount) {
   EXPECT_EQ(1280 * 720, *broadcaster.wants().target_pixel_count);
 }
 
+TEST(VideoBroadcasterTest, AppliesMaxOfScaledSinkWantsMaxAndTargetPixelCount) {
+  VideoBroadcaster broadcaster;
+
+  FakeVideoRenderer sink1;
+  VideoSinkWants wants1;
+  wants1.max_pixel_count = 640 * 360;
+  wants1.target_pixel_count = 640 * 360;
+  wants1.accepts_scaled_frames = true;
+  broadcaster.AddOrUpdateSink(&sink1, wants1);
+  EXPECT_EQ(640 * 360, broadcaster.wants().max_pixel_count);
+  EXPECT_EQ(640 * 360, *broadcaster.wants().target_pixel_count);
+
+  // The broadcaster scales the frames down for both sinks, so the source has
+  // to deliver the larger resolution.
+  FakeVideoRenderer sink2;
+  VideoSinkWants wants2;
+  wants2.max_pixel_count = 1920 * 1080;
+  wants2.target_pixel_count = 1280 * 720;
+  wants2.accepts_scaled_frames = true;
+  broadcaster.AddOrUpdateSink(&sink2, wants2);
+  EXPECT_EQ(1920 * 1080, broadcaster.wants().max_pixel_count);
+  EXPECT_EQ(1280 * 720, *broadcaster.wants().target_pixel_count);
+
+  broadcaster.RemoveSink(&sink2);
+  EXPECT_EQ(640 * 360, broadcaster.wants().max_pixel_count);
+  EXPECT_EQ(640 * 360, *broadcaster.wants().target_pixel_count);
+}
+
+TEST(VideoBroadcasterTest, SinksNotAcceptingScaledFramesLimitWants) {
+  VideoBroadcaster broadcaster;
+
+  // E.g. a local preview, which can draw larger frames.
+  FakeVideoRenderer scaled_sink;
+  VideoSinkWants scaled_wants;
+  scaled_wants.max_pixel_count = 1920 * 1080;
+  scaled_wants.accepts_scaled_frames = true;
+  broadcaster.AddOrUpdateSink(&scaled_sink, scaled_wants);
+
+  // E.g. an encoder, which relies on the source for its adaptation.
+  FakeVideoRenderer limiting_sink;
+  VideoSinkWants limiting_wants;
+  limiting_wants.max_pixel_count = 640 * 360;
+  broadcaster.AddOrUpdateSink(&limiting_sink, limiting_wants);
+  EXPECT_EQ(640 * 360, broadcaster.wants().max_pixel_count);
+
+  limiting_wants.max_pixel_count = std::numeric_limits<int>::max();
+  broadcaster.AddOrUpdateSink(&limiting_sink, limiting_wants);
+  EXPECT_EQ(1920 * 1080, broadcaster.wants().max_pixel_count);
+}
+
 TEST(VideoBroadcasterTest, AppliesMinOfSinkWantsMaxFramerate) {
   VideoBroadcaster broadcaster;
   EXPECT_EQ(std::numeric_limits<int>::max(),
@@ -192,3 +275,89 @@ TEST(VideoBroadcasterTest, SinkWantsBlackFrames) {
   EXPECT_TRUE(sink2.black_frame());
   EXPECT_EQ(30, sink2.timestamp_us());
 }
+
+TEST(VideoBroadcasterTest, ScalesFramesDownToSinkMaxPixelCount) {
+  VideoBroadcaster broadcaster;
+
+  BufferRecordingSink sink1;
+  broadcaster.AddOrUpdateSink(&sink1, VideoSinkWants());
+
+  BufferRecordingSink sink2;
+  VideoSinkWants wants2;
+  wants2.max_pixel_count = 640 * 360;
+  broadcaster.AddOrUpdateSink(&sink2, wants2);
+
+  BufferRecordingSink sink3;
+  VideoSinkWants wants3;
+  wants3.max_pixel_count = 500 * 300;
+  broadcaster.AddOrUpdateSink(&sink3, wants3);
+
+  webrtc::VideoFrame frame = CreateFrame(1280, 720, 10 /* timestamp_us */);
+  broadcaster.OnFrame(frame);
+
+  EXPECT_EQ(frame.video_frame_buffer(), sink1.buffer());
+  EXPECT_EQ(640, sink2.buffer()->width());
+  EXPECT_EQ(360, sink2.buffer()->height());
+  EXPECT_EQ(10, sink2.timestamp_us());
+  // Scaled by 3/8, the largest factor leaving at most 500 * 300 pixels.
+  EXPECT_EQ(480, sink3.buffer()->width());
+  EXPECT_EQ(270, sink3.buffer()->height());
+  EXPECT_EQ(10, sink3.timestamp_us());
+
+  // Frames small enough are passed on as they are.
+  frame = CreateFrame(320, 180, 20 /* timestamp_us */);
+  broadcaster.OnFrame(frame);
+  EXPECT_EQ(frame.video_frame_buffer(), sink2.buffer());
+  EXPECT_EQ(frame.video_frame_buffer(), sink3.buffer());
+}
+
+TEST(VideoBroadcasterTest, SinksWithSameScaledResolutionShareFrame) {
+  VideoBroadcaster broadcaster;
+
+  BufferRecordingSink sink1;
+  VideoSinkWants wants1;
+  wants1.max_pixel_count = 640 * 360;
+  broadcaster.AddOrUpdateSink(&sink1, wants1);
+
+  BufferRecordingSink sink2;
+  VideoSinkWants wants2;
+  wants2.max_pixel_count = 700 * 400;
+  broadcaster.AddOrUpdateSink(&sink2, wants2);
+
+  broadcaster.OnFrame(CreateFrame(1280, 720, 0 /* timestamp_us */));
+  ASSERT_TRUE(sink1.buffer());
+  EXPECT_EQ(640, sink1.buffer()->width());
+  EXPECT_EQ(sink1.buffer(), sink2.buffer());
+}
+
+TEST(VideoBroadcasterTest, DoesNotScaleForSinksAdaptingResolution) {
+  VideoBroadcaster broadcaster;
+
+  BufferRecordingSink sink;
+  VideoSinkWants wants;
+  wants.max_pixel_count = 640 * 360;
+  wants.adapts_resolution = true;
+  broadcaster.AddOrUpdateSink(&sink, wants);
+
+  webrtc::VideoFrame frame = CreateFrame(1280, 720, 0 /* timestamp_us */);
+  broadcaster.OnFrame(frame);
+  EXPECT_EQ(frame.video_frame_buffer(), sink.buffer());
+}
+
+TEST(VideoBroadcasterTest, UsesPyramidOfFrame) {
+  VideoBroadcaster broadcaster;
+
+  BufferRecordingSink sink;
+  VideoSinkWants wants;
+  wants.max_pixel_count = 640 * 360;
+  broadcaster.AddOrUpdateSink(&sink, wants);
+
+  rtc::scoped_refptr<webrtc::I420Buffer> buffer(
+      webrtc::I420Buffer::Create(1280, 720));
+  webrtc::I420Buffer::SetBlack(buffer);
+  rtc::scoped_refptr<webrtc::I420PyramidBuffer> pyramid =
+      webrtc::I420PyramidBufferFactory::Create()->Wrap(buffer);
+  broadcaster.OnFrame(webrtc::VideoFrame(pyramid, webrtc::kVideoRotation_0,
+                                         0 /* timestamp_us */));
+  EXPECT_EQ(pyramid->GetScaledBuffer(640, 360), sink.buffer());
+}
@@ -14,12 +14,32 @@
 
 #include "absl/strings/match.h"
 #include "api/video_codecs/sdp_video_format.h"
+#include "media/engine/video_encoder_pool.h"
 #include "modules/video_coding/codecs/h264/include/h264.h"
 #include "modules/video_coding/codecs/vp8/include/vp8.h"
 #include "modules/video_coding/codecs/vp9/include/vp9.h"
 #include "rtc_base/logging.h"
+#include "system_wrappers/include/field_trial.h"
 
 namespace webrtc {
+namespace {
+
+const char kVideoEncoderPoolFieldTrial[] = "WebRTC-VideoEncoderPool";
+
+std::unique_ptr<VideoEncoder> CreateInternalEncoder(
+    const SdpVideoFormat& format) {
+  if (absl::EqualsIgnoreCase(format.name, cricket::kVp8CodecName))
+    return VP8Encoder::Create();
+  if (absl::EqualsIgnoreCase(format.name, cricket::kVp9CodecName))
+    return VP9Encoder::Create(cricket::VideoCodec(format));
+  if (absl::EqualsIgnoreCase(format.name, cricket::kH264CodecName))
+    return H264Encoder::Create(cricket::VideoCodec(format));
+  RTC_LOG(LS_ERROR) << "Trying to created encoder of unsupported format "
+                    << format.name;
+  return nullptr;
+}
+
+}  // namespace
 
 std::vector<SdpVideoFormat> InternalEncoderFactory::GetSupportedFormats()
     const {
@@ -42,15 +62,14 @@ VideoEncoderFactory::CodecInfo InternalEncoderFactory::QueryVideoEncoder(
 
 std::unique_ptr<VideoEncoder> InternalEncoderFactory::CreateVideoEncoder(
     const SdpVideoFormat& format) {
-  if (absl::EqualsIgnoreCase(format.name, cricket::kVp8CodecName))
-    return VP8Encoder::Create();
-  if (absl::EqualsIgnoreCase(format.name, cricket::kVp9CodecName))
-    return VP9Encoder::Create(cricket::VideoCodec(format));
-  if (absl::EqualsIgnoreCase(format.name, cricket::kH264CodecName))
-    return H264Encoder::Create(cricket::VideoCodec(format));
-  RTC_LOG(LS_ERROR) << "Trying to created encoder of unsupported format "
-                    << format.name;
-  return nullptr;
+  if (!field_trial::IsEnabled(kVideoEncoderPoolFieldTrial))
+    return CreateInternalEncoder(format);
+  // The encoders of the process share a pool, so that reconfigurations and
+  // new streams reuse the initialized libvpx and OpenH264 encoders.
+  return CreatePooledVideoEncoder(VideoEncoderPool::GetInstance(), format,
+                                  [format] {
+                                    return CreateInternalEncoder(format);
+                                  });
 }
 
 }  // namespace webrtc
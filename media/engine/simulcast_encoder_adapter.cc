@@ -14,6 +14,7 @@
 #include <string>
 #include <utility>
 
+#include "absl/memory/memory.h"
 #include "api/video/i420_buffer.h"
 #include "api/video/video_bitrate_allocation.h"
 #include "api/video_codecs/video_encoder_factory.h"
@@ -42,6 +43,11 @@ absl::optional<unsigned int> GetScreenshareBoostedQpValue() {
   return qp;
 }
 
+bool IsParallelEncodingEnabled() {
+  return webrtc::field_trial::IsEnabled(
+      "WebRTC-SimulcastEncoderAdapter-ParallelEncoding");
+}
+
 uint32_t SumStreamMaxBitrate(int streams, const webrtc::VideoCodec& codec) {
   uint32_t bitrate_sum = 0;
   for (int i = 0; i < streams; ++i) {
@@ -127,7 +133,13 @@ SimulcastEncoderAdapter::SimulcastEncoderAdapter(VideoEncoderFactory* factory,
       factory_(factory),
       video_format_(format),
       encoded_complete_callback_(nullptr),
-      experimental_boosted_screenshare_qp_(GetScreenshareBoostedQpValue()) {
+      experimental_boosted_screenshare_qp_(GetScreenshareBoostedQpValue()),
+      parallel_encoding_enabled_(IsParallelEncodingEnabled()),
+      num_stream_workers_(0),
+      collecting_encoded_images_(0),
+      workers_done_(false, false),
+      num_busy_workers_(0),
+      pyramid_factory_(I420PyramidBufferFactory::Create()) {
   RTC_DCHECK(factory_);
   encoder_info_.implementation_name = "SimulcastEncoderAdapter";
 
@@ -152,14 +164,17 @@ int SimulcastEncoderAdapter::Release() {
     // Even though it seems very unlikely, there are no guarantees that the
     // encoder will not call back after being Release()'d. Therefore, we first
     // disable the callbacks here.
-    encoder->RegisterEncodeCompleteCallback(nullptr);
-    encoder->Release();
+    RunOnStreamQueue(streaminfos_.size() - 1, [&encoder] {
+      encoder->RegisterEncodeCompleteCallback(nullptr);
+      encoder->Release();
+    });
     streaminfos_.pop_back();  // Deletes callback adapter.
     stored_encoders_.push(std::move(encoder));
   }
 
   // It's legal to move the encoder to another queue now.
   encoder_queue_.Detach();
+  num_stream_workers_ = 0;
 
   rtc::AtomicOps::ReleaseStore(&inited_, 0);
 
@@ -203,6 +218,14 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
     start_bitrates.push_back(stream_bitrate);
   }
 
+  if (parallel_encoding_enabled_ && doing_simulcast && number_of_cores > 1) {
+    num_stream_workers_ = number_of_streams - 1;
+    while (encode_workers_.size() < num_stream_workers_) {
+      encode_workers_.push_back(
+          absl::make_unique<rtc::TaskQueue>("SimulcastEncodeWorker"));
+    }
+  }
+
   encoder_info_.supports_native_handle = true;
   encoder_info_.scaling_settings.thresholds = absl::nullopt;
   // Create |number_of_streams| of encoder instances and init them.
@@ -241,7 +264,17 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
           codec_.codecType == webrtc::kVideoCodecVP8 ? "VP8" : "H264"));
     }
 
-    ret = encoder->InitEncode(&stream_codec, number_of_cores, max_payload_size);
+    std::unique_ptr<EncodedImageCallback> callback(
+        new AdapterEncodedImageCallback(this, i));
+    EncoderInfo encoder_impl_info;
+    RunOnStreamQueue(i, [&] {
+      ret =
+          encoder->InitEncode(&stream_codec, number_of_cores, max_payload_size);
+      if (ret >= 0) {
+        encoder->RegisterEncodeCompleteCallback(callback.get());
+        encoder_impl_info = encoder->GetEncoderInfo();
+      }
+    });
     if (ret < 0) {
       // Explicitly destroy the current encoder; because we haven't registered a
       // StreamInfo for it yet, Release won't do anything about it.
@@ -250,9 +283,6 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
       return ret;
     }
 
-    std::unique_ptr<EncodedImageCallback> callback(
-        new AdapterEncodedImageCallback(this, i));
-    encoder->RegisterEncodeCompleteCallback(callback.get());
     streaminfos_.emplace_back(std::move(encoder), std::move(callback),
                               stream_codec.width, stream_codec.height,
                               send_stream);
@@ -260,11 +290,8 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
     if (!doing_simulcast) {
       // Without simulcast, just pass through the encoder info from the one
       // active encoder.
-      encoder_info_ = streaminfos_[0].encoder->GetEncoderInfo();
+      encoder_info_ = encoder_impl_info;
     } else {
-      const EncoderInfo encoder_impl_info =
-          streaminfos_[i].encoder->GetEncoderInfo();
-
       if (i == 0) {
         // Quality scaling not enabled for simulcast.
         encoder_info_.scaling_settings = VideoEncoder::ScalingSettings::kOff;
@@ -338,6 +365,11 @@ int SimulcastEncoderAdapter::Encode(
     }
   }
 
+  if (num_stream_workers_ > 0 && input_image.video_frame_buffer()->type() !=
+                                     VideoFrameBuffer::Type::kNative) {
+    return EncodeInParallel(input_image, codec_specific_info, send_key_frame);
+  }
+
   int src_width = input_image.width();
   int src_height = input_image.height();
   for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
@@ -369,29 +401,45 @@ int SimulcastEncoderAdapter::Encode(
     if ((dst_width == src_width && dst_height == src_height) ||
         input_image.video_frame_buffer()->type() ==
             VideoFrameBuffer::Type::kNative) {
-      int ret = streaminfos_[stream_idx].encoder->Encode(
-          input_image, codec_specific_info, &stream_frame_types);
+      int ret = WEBRTC_VIDEO_CODEC_OK;
+      RunOnStreamQueue(stream_idx, [&] {
+        ret = streaminfos_[stream_idx].encoder->Encode(
+            input_image, codec_specific_info, &stream_frame_types);
+      });
       if (ret != WEBRTC_VIDEO_CODEC_OK) {
         return ret;
       }
     } else {
-      rtc::scoped_refptr<I420Buffer> dst_buffer =
-          I420Buffer::Create(dst_width, dst_height);
-      rtc::scoped_refptr<I420BufferInterface> src_buffer =
-          input_image.video_frame_buffer()->ToI420();
-      libyuv::I420Scale(src_buffer->DataY(), src_buffer->StrideY(),
-                        src_buffer->DataU(), src_buffer->StrideU(),
-                        src_buffer->DataV(), src_buffer->StrideV(), src_width,
-                        src_height, dst_buffer->MutableDataY(),
-                        dst_buffer->StrideY(), dst_buffer->MutableDataU(),
-                        dst_buffer->StrideU(), dst_buffer->MutableDataV(),
-                        dst_buffer->StrideV(), dst_width, dst_height,
-                        libyuv::kFilterBilinear);
-
-      int ret = streaminfos_[stream_idx].encoder->Encode(
-          VideoFrame(dst_buffer, input_image.timestamp(),
-                     input_image.render_time_ms(), webrtc::kVideoRotation_0),
-          codec_specific_info, &stream_frame_types);
+      // Frames with a downscale pyramid share the scaling with the other
+      // consumers of the frame.
+      rtc::scoped_refptr<VideoFrameBuffer> dst_buffer =
+          input_image.video_frame_buffer()->GetScaledBuffer(dst_width,
+                                                            dst_height);
+      if (!dst_buffer) {
+        rtc::scoped_refptr<I420Buffer> scaled_buffer =
+            I420Buffer::Create(dst_width, dst_height);
+        rtc::scoped_refptr<I420BufferInterface> src_buffer =
+            input_image.video_frame_buffer()->ToI420();
+        libyuv::I420Scale(src_buffer->DataY(), src_buffer->StrideY(),
+                          src_buffer->DataU(), src_buffer->StrideU(),
+                          src_buffer->DataV(), src_buffer->StrideV(),
+                          src_width, src_height, scaled_buffer->MutableDataY(),
+                          scaled_buffer->StrideY(),
+                          scaled_buffer->MutableDataU(),
+                          scaled_buffer->StrideU(),
+                          scaled_buffer->MutableDataV(),
+                          scaled_buffer->StrideV(), dst_width, dst_height,
+                          libyuv::kFilterBilinear);
+        dst_buffer = scaled_buffer;
+      }
+
+      int ret = WEBRTC_VIDEO_CODEC_OK;
+      RunOnStreamQueue(stream_idx, [&] {
+        ret = streaminfos_[stream_idx].encoder->Encode(
+            VideoFrame(dst_buffer, input_image.timestamp(),
+                       input_image.render_time_ms(), webrtc::kVideoRotation_0),
+            codec_specific_info, &stream_frame_types);
+      });
       if (ret != WEBRTC_VIDEO_CODEC_OK) {
         return ret;
       }
@@ -401,6 +449,131 @@ int SimulcastEncoderAdapter::Encode(
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+int SimulcastEncoderAdapter::EncodeInParallel(
+    const VideoFrame& input_image,
+    const CodecSpecificInfo* codec_specific_info,
+    bool send_key_frame) {
+  const std::vector<rtc::scoped_refptr<VideoFrameBuffer>> stream_buffers =
+      BuildScaledInputs(input_image);
+  const size_t last_stream_idx = streaminfos_.size() - 1;
+  RTC_DCHECK_EQ(num_stream_workers_, last_stream_idx);
+
+  int num_workers = 0;
+  for (size_t stream_idx = 0; stream_idx < last_stream_idx; ++stream_idx) {
+    if (stream_buffers[stream_idx])
+      ++num_workers;
+  }
+  rtc::AtomicOps::ReleaseStore(&num_busy_workers_, num_workers);
+  rtc::AtomicOps::ReleaseStore(&collecting_encoded_images_, 1);
+
+  for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
+    if (!stream_buffers[stream_idx]) {
+      continue;
+    }
+    const FrameType frame_type =
+        send_key_frame ? kVideoFrameKey : kVideoFrameDelta;
+    if (send_key_frame) {
+      streaminfos_[stream_idx].key_frame_request = false;
+    }
+    // Frames that need no scaling are passed on as they are, as when encoding
+    // sequentially.
+    const VideoFrame frame =
+        stream_buffers[stream_idx] == input_image.video_frame_buffer()
+            ? input_image
+            : VideoFrame(stream_buffers[stream_idx], input_image.timestamp(),
+                         input_image.render_time_ms(),
+                         webrtc::kVideoRotation_0);
+    if (stream_idx == last_stream_idx) {
+      EncodeStream(stream_idx, frame, codec_specific_info, frame_type);
+    } else {
+      encode_workers_[stream_idx]->PostTask(
+          [this, stream_idx, frame, codec_specific_info, frame_type] {
+            EncodeStream(stream_idx, frame, codec_specific_info, frame_type);
+            if (rtc::AtomicOps::Decrement(&num_busy_workers_) == 0) {
+              workers_done_.Set();
+            }
+          });
+    }
+  }
+  if (num_workers > 0) {
+    workers_done_.Wait(rtc::Event::kForever);
+  }
+  rtc::AtomicOps::ReleaseStore(&collecting_encoded_images_, 0);
+
+  // Deliver the encoded images in stream order. The encoders keep their
+  // output buffers until their next Encode() call.
+  int result = WEBRTC_VIDEO_CODEC_OK;
+  for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
+    StreamInfo& stream_info = streaminfos_[stream_idx];
+    if (!stream_buffers[stream_idx]) {
+      continue;
+    }
+    for (const PendingEncodedImage& pending : stream_info.pending_images) {
+      OnEncodedImage(stream_idx, pending.encoded_image,
+                     &pending.codec_specific_info, pending.fragmentation.get());
+    }
+    stream_info.pending_images.clear();
+    if (result == WEBRTC_VIDEO_CODEC_OK) {
+      result = stream_info.encode_result;
+    }
+  }
+  return result;
+}
+
+std::vector<rtc::scoped_refptr<VideoFrameBuffer>>
+SimulcastEncoderAdapter::BuildScaledInputs(const VideoFrame& input_image) {
+  std::vector<rtc::scoped_refptr<VideoFrameBuffer>> stream_buffers(
+      streaminfos_.size());
+  rtc::scoped_refptr<VideoFrameBuffer> scalable_buffer =
+      input_image.video_frame_buffer();
+  for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
+    if (!streaminfos_[stream_idx].send_stream) {
+      continue;
+    }
+    const int dst_width = streaminfos_[stream_idx].width;
+    const int dst_height = streaminfos_[stream_idx].height;
+    if (dst_width == input_image.width() &&
+        dst_height == input_image.height()) {
+      stream_buffers[stream_idx] = input_image.video_frame_buffer();
+      continue;
+    }
+    stream_buffers[stream_idx] =
+        scalable_buffer->GetScaledBuffer(dst_width, dst_height);
+    if (!stream_buffers[stream_idx]) {
+      scalable_buffer = pyramid_factory_->Wrap(scalable_buffer->ToI420());
+      stream_buffers[stream_idx] =
+          scalable_buffer->GetScaledBuffer(dst_width, dst_height);
+    }
+  }
+  return stream_buffers;
+}
+
+void SimulcastEncoderAdapter::EncodeStream(
+    size_t stream_idx,
+    const VideoFrame& frame,
+    const CodecSpecificInfo* codec_specific_info,
+    FrameType frame_type) {
+  const std::vector<FrameType> stream_frame_types(1, frame_type);
+  streaminfos_[stream_idx].encode_result =
+      streaminfos_[stream_idx].encoder->Encode(frame, codec_specific_info,
+                                               &stream_frame_types);
+}
+
+void SimulcastEncoderAdapter::RunOnStreamQueue(
+    size_t stream_idx,
+    rtc::FunctionView<void()> function) {
+  if (stream_idx >= num_stream_workers_) {
+    function();
+    return;
+  }
+  rtc::Event done(false, false);
+  encode_workers_[stream_idx]->PostTask([&function, &done] {
+    function();
+    done.Set();
+  });
+  done.Wait(rtc::Event::kForever);
+}
+
 int SimulcastEncoderAdapter::RegisterEncodeCompleteCallback(
     EncodedImageCallback* callback) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&encoder_queue_);
@@ -458,8 +631,10 @@ int SimulcastEncoderAdapter::SetRateAllocation(
         stream_allocation.SetBitrate(0, i, bitrate.GetBitrate(stream_idx, i));
       }
     }
-    streaminfos_[stream_idx].encoder->SetRateAllocation(stream_allocation,
-                                                        new_framerate);
+    RunOnStreamQueue(stream_idx, [&] {
+      streaminfos_[stream_idx].encoder->SetRateAllocation(stream_allocation,
+                                                          new_framerate);
+    });
   }
 
   return WEBRTC_VIDEO_CODEC_OK;
@@ -472,6 +647,18 @@ EncodedImageCallback::Result SimulcastEncoderAdapter::OnEncodedImage(
     const EncodedImage& encodedImage,
     const CodecSpecificInfo* codecSpecificInfo,
     const RTPFragmentationHeader* fragmentation) {
+  if (rtc::AtomicOps::AcquireLoad(&collecting_encoded_images_) != 0) {
+    PendingEncodedImage pending;
+    pending.encoded_image = encodedImage;
+    pending.codec_specific_info = *codecSpecificInfo;
+    if (fragmentation) {
+      pending.fragmentation = absl::make_unique<RTPFragmentationHeader>();
+      pending.fragmentation->CopyFrom(*fragmentation);
+    }
+    streaminfos_[stream_idx].pending_images.push_back(std::move(pending));
+    return EncodedImageCallback::Result(EncodedImageCallback::Result::OK);
+  }
+
   EncodedImage stream_image(encodedImage);
   CodecSpecificInfo stream_codec_specific = *codecSpecificInfo;
 
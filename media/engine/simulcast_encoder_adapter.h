@@ -19,10 +19,17 @@
 #include <vector>
 
 #include "absl/types/optional.h"
+#include "api/video/video_frame_buffer.h"
 #include "api/video_codecs/sdp_video_format.h"
+#include "common_video/include/i420_pyramid_buffer.h"
+#include "modules/include/module_common_types.h"
 #include "modules/video_coding/include/video_codec_interface.h"
 #include "rtc_base/atomicops.h"
+#include "rtc_base/event.h"
+#include "rtc_base/function_view.h"
+#include "rtc_base/scoped_ref_ptr.h"
 #include "rtc_base/sequenced_task_checker.h"
+#include "rtc_base/task_queue.h"
 
 namespace webrtc {
 
@@ -33,6 +40,18 @@ class VideoEncoderFactory;
 // webrtc::VideoEncoder instances with the given VideoEncoderFactory.
 // The object is created and destroyed on the worker thread, but all public
 // interfaces should be called from the encoder task queue.
+//
+// With the "WebRTC-SimulcastEncoderAdapter-ParallelEncoding" field trial, and
+// more than one core, the streams of a frame are encoded concurrently: each
+// stream but the last one on its own worker task queue, the last one on the
+// calling task queue. The scaled inputs are then taken from the downscale
+// pyramid of the frame, and the encoded images are delivered after all the
+// streams are encoded, in stream order. All other calls to the encoder of a
+// stream are made on the same task queue as its Encode() calls, so that each
+// encoder is still used from a single sequence.
+//
+// Frames that carry a downscale pyramid, e.g. from an AdaptedVideoTrackSource,
+// are scaled from it in both modes.
 class SimulcastEncoderAdapter : public VideoEncoder {
  public:
   explicit SimulcastEncoderAdapter(VideoEncoderFactory* factory,
@@ -53,7 +72,8 @@ class SimulcastEncoderAdapter : public VideoEncoder {
 
   // Eventual handler for the contained encoders' EncodedImageCallbacks, but
   // called from an internal helper that also knows the correct stream
-  // index.
+  // index. While encoding streams in parallel, the images are kept and
+  // delivered by Encode() instead.
   EncodedImageCallback::Result OnEncodedImage(
       size_t stream_idx,
       const EncodedImage& encoded_image,
@@ -63,6 +83,13 @@ class SimulcastEncoderAdapter : public VideoEncoder {
   EncoderInfo GetEncoderInfo() const override;
 
  private:
+  // An encoded image kept until all the streams of a frame are encoded.
+  struct PendingEncodedImage {
+    EncodedImage encoded_image;
+    CodecSpecificInfo codec_specific_info;
+    std::unique_ptr<RTPFragmentationHeader> fragmentation;
+  };
+
   struct StreamInfo {
     StreamInfo(std::unique_ptr<VideoEncoder> encoder,
                std::unique_ptr<EncodedImageCallback> callback,
@@ -81,6 +108,9 @@ class SimulcastEncoderAdapter : public VideoEncoder {
     uint16_t height;
     bool key_frame_request;
     bool send_stream;
+    // Used when encoding in parallel.
+    int encode_result = WEBRTC_VIDEO_CODEC_OK;
+    std::vector<PendingEncodedImage> pending_images;
   };
 
   // Populate the codec settings for each simulcast stream.
@@ -94,6 +124,25 @@ class SimulcastEncoderAdapter : public VideoEncoder {
 
   void DestroyStoredEncoders();
 
+  // Encodes the active streams of |input_image| concurrently. Returns the
+  // first error in stream order.
+  int EncodeInParallel(const VideoFrame& input_image,
+                       const CodecSpecificInfo* codec_specific_info,
+                       bool send_key_frame);
+  // Returns, for each stream, the input frame scaled to the stream
+  // resolution, or null for inactive streams. The scaled buffers are taken
+  // from the pyramid of the frame, which is built here if it has none.
+  std::vector<rtc::scoped_refptr<VideoFrameBuffer>> BuildScaledInputs(
+      const VideoFrame& input_image);
+  // Runs |function| on the worker task queue of the stream, if it has one,
+  // and waits for it. Otherwise runs it on the calling queue.
+  void RunOnStreamQueue(size_t stream_idx, rtc::FunctionView<void()> function);
+  // Encodes |frame| with the encoder of the stream and keeps the result.
+  void EncodeStream(size_t stream_idx,
+                    const VideoFrame& frame,
+                    const CodecSpecificInfo* codec_specific_info,
+                    FrameType frame_type);
+
   volatile int inited_;  // Accessed atomically.
   VideoEncoderFactory* const factory_;
   const SdpVideoFormat video_format_;
@@ -110,6 +159,22 @@ class SimulcastEncoderAdapter : public VideoEncoder {
   std::stack<std::unique_ptr<VideoEncoder>> stored_encoders_;
 
   const absl::optional<unsigned int> experimental_boosted_screenshare_qp_;
+
+  const bool parallel_encoding_enabled_;
+  // The number of streams with a worker task queue, set by InitEncode() when
+  // the streams are encoded in parallel and zero otherwise.
+  size_t num_stream_workers_;
+  // Nonzero while Encode() waits for the streams encoded in parallel, and
+  // keeps their images. Accessed atomically.
+  volatile int collecting_encoded_images_;
+  // Signaled when the last worker finishes encoding.
+  rtc::Event workers_done_;
+  volatile int num_busy_workers_;  // Accessed atomically.
+  // Worker task queues, one for each stream but the last. Kept across
+  // InitEncode() calls.
+  std::vector<std::unique_ptr<rtc::TaskQueue>> encode_workers_;
+  // Builds the pyramids of frames that have none, when encoding in parallel.
+  const rtc::scoped_refptr<I420PyramidBufferFactory> pyramid_factory_;
 };
 
 }  // namespace webrtc
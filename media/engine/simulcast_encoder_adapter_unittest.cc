@@ -26,10 +26,14 @@
 #include "modules/video_coding/codecs/vp8/include/vp8.h"
 #include "modules/video_coding/include/video_codec_interface.h"
 #include "modules/video_coding/utility/simulcast_test_fixture_impl.h"
+#include "rtc_base/event.h"
+#include "rtc_base/sequenced_task_checker.h"
+#include "test/field_trial.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
 using ::testing::_;
+using ::testing::Invoke;
 using ::testing::Return;
 
 namespace webrtc {
@@ -187,6 +191,7 @@ class MockVideoEncoder : public VideoEncoder {
   int32_t InitEncode(const VideoCodec* codecSettings,
                      int32_t numberOfCores,
                      size_t maxPayloadSize) /* override */ {
+    CheckSequence();
     codec_ = *codecSettings;
     return init_encode_return_value_;
   }
@@ -199,6 +204,7 @@ class MockVideoEncoder : public VideoEncoder {
 
   int32_t RegisterEncodeCompleteCallback(
       EncodedImageCallback* callback) /* override */ {
+    CheckSequence();
     callback_ = callback;
     return 0;
   }
@@ -207,6 +213,7 @@ class MockVideoEncoder : public VideoEncoder {
 
   int32_t SetRateAllocation(const VideoBitrateAllocation& bitrate_allocation,
                             uint32_t framerate) {
+    CheckSequence();
     last_set_bitrate_ = bitrate_allocation;
     return 0;
   }
@@ -257,6 +264,14 @@ class MockVideoEncoder : public VideoEncoder {
 
   VideoBitrateAllocation last_set_bitrate() const { return last_set_bitrate_; }
 
+  // Records whether the encoder is used from more than one sequence. Called
+  // by the non-mocked methods, and to be called by actions of mocked ones.
+  void CheckSequence() {
+    if (!sequence_checker_.CalledSequentially())
+      called_sequentially_ = false;
+  }
+  bool called_sequentially() const { return called_sequentially_; }
+
  private:
   MockVideoEncoderFactory* const factory_;
   bool supports_native_handle_ = false;
@@ -268,6 +283,8 @@ class MockVideoEncoder : public VideoEncoder {
 
   VideoCodec codec_;
   EncodedImageCallback* callback_;
+  rtc::SequencedTaskChecker sequence_checker_;
+  bool called_sequentially_ = true;
 };
 
 std::vector<SdpVideoFormat> MockVideoEncoderFactory::GetSupportedFormats()
@@ -1005,5 +1022,138 @@ TEST_F(TestSimulcastEncoderAdapterFake, TrustedRateControl) {
   EXPECT_FALSE(adapter_->GetEncoderInfo().has_trusted_rate_controller);
 }
 
+// Records the simulcast index and resolution of the encoded images.
+class RecordingEncodedImageCallback : public EncodedImageCallback {
+ public:
+  Result OnEncodedImage(const EncodedImage& encoded_image,
+                        const CodecSpecificInfo* codec_specific_info,
+                        const RTPFragmentationHeader* fragmentation) override {
+    simulcast_indices.push_back(encoded_image.SpatialIndex().value_or(-1));
+    widths.push_back(encoded_image._encodedWidth);
+    return Result(Result::OK, encoded_image.Timestamp());
+  }
+
+  std::vector<int> simulcast_indices;
+  std::vector<int> widths;
+};
+
+TEST(SimulcastEncoderAdapterParallelTest, EncodesStreamsConcurrently) {
+  ScopedFieldTrials field_trials(
+      "WebRTC-SimulcastEncoderAdapter-ParallelEncoding/Enabled/");
+  TestSimulcastEncoderAdapterFakeHelper helper;
+  std::unique_ptr<VideoEncoder> adapter(helper.CreateMockEncoderAdapter());
+  VideoCodec codec;
+  SimulcastTestFixtureImpl::DefaultSettings(
+      &codec, static_cast<const int*>(kTestTemporalLayerProfile),
+      kVideoCodecVP8);
+  SimulcastRateAllocator rate_allocator(codec);
+  RecordingEncodedImageCallback callback;
+  EXPECT_EQ(0, adapter->InitEncode(&codec, 2, 1200));
+  adapter->RegisterEncodeCompleteCallback(&callback);
+  const uint32_t target_bitrate =
+      1000 * (codec.simulcastStream[0].targetBitrate +
+              codec.simulcastStream[1].targetBitrate +
+              codec.simulcastStream[2].minBitrate);
+  adapter->SetRateAllocation(rate_allocator.GetAllocation(target_bitrate, 30),
+                             30);
+
+  // The lowest stream can only finish encoding once the highest one has
+  // started, which requires them to be encoded concurrently. Its image is
+  // still delivered first.
+  rtc::Event highest_stream_started(false, false);
+  std::vector<MockVideoEncoder*> encoders = helper.factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+  for (size_t i = 0; i < encoders.size(); ++i) {
+    MockVideoEncoder* encoder = encoders[i];
+    const SimulcastStream& stream = codec.simulcastStream[i];
+    ON_CALL(*encoder, Encode(_, _, _))
+        .WillByDefault(Invoke([encoder, i, &stream, &highest_stream_started](
+                                  const VideoFrame& frame,
+                                  const CodecSpecificInfo* codec_specific_info,
+                                  const std::vector<FrameType>* frame_types) {
+          EXPECT_EQ(stream.width, frame.width());
+          EXPECT_EQ(stream.height, frame.height());
+          if (i == 0) {
+            EXPECT_TRUE(highest_stream_started.Wait(5000));
+          } else if (i == 2) {
+            highest_stream_started.Set();
+          }
+          encoder->SendEncodedImage(frame.width(), frame.height());
+          return WEBRTC_VIDEO_CODEC_OK;
+        }));
+  }
+
+  rtc::scoped_refptr<VideoFrameBuffer> buffer(
+      I420Buffer::Create(codec.width, codec.height));
+  VideoFrame input_frame(buffer, 100, 1000, kVideoRotation_0);
+  std::vector<FrameType> frame_types(3, kVideoFrameKey);
+  EXPECT_EQ(0, adapter->Encode(input_frame, nullptr, &frame_types));
+  EXPECT_THAT(callback.simulcast_indices, ::testing::ElementsAre(0, 1, 2));
+  EXPECT_THAT(callback.widths,
+              ::testing::ElementsAre(codec.simulcastStream[0].width,
+                                     codec.simulcastStream[1].width,
+                                     codec.simulcastStream[2].width));
+  adapter->Release();
+}
+
+TEST(SimulcastEncoderAdapterParallelTest, UsesEachEncoderFromOneSequence) {
+  ScopedFieldTrials field_trials(
+      "WebRTC-SimulcastEncoderAdapter-ParallelEncoding/Enabled/");
+  TestSimulcastEncoderAdapterFakeHelper helper;
+  std::unique_ptr<VideoEncoder> adapter(helper.CreateMockEncoderAdapter());
+  VideoCodec codec;
+  SimulcastTestFixtureImpl::DefaultSettings(
+      &codec, static_cast<const int*>(kTestTemporalLayerProfile),
+      kVideoCodecVP8);
+  SimulcastRateAllocator rate_allocator(codec);
+  RecordingEncodedImageCallback callback;
+  EXPECT_EQ(0, adapter->InitEncode(&codec, 2, 1200));
+  adapter->RegisterEncodeCompleteCallback(&callback);
+  const uint32_t target_bitrate =
+      1000 * (codec.simulcastStream[0].targetBitrate +
+              codec.simulcastStream[1].targetBitrate +
+              codec.simulcastStream[2].minBitrate);
+  adapter->SetRateAllocation(rate_allocator.GetAllocation(target_bitrate, 30),
+                             30);
+
+  std::vector<MockVideoEncoder*> encoders = helper.factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+  for (MockVideoEncoder* encoder : encoders) {
+    ON_CALL(*encoder, Encode(_, _, _))
+        .WillByDefault(Invoke(
+            [encoder](const VideoFrame& frame,
+                      const CodecSpecificInfo* codec_specific_info,
+                      const std::vector<FrameType>* frame_types) {
+              encoder->CheckSequence();
+              encoder->SendEncodedImage(frame.width(), frame.height());
+              return WEBRTC_VIDEO_CODEC_OK;
+            }));
+    ON_CALL(*encoder, Release()).WillByDefault(Invoke([encoder] {
+      encoder->CheckSequence();
+      return WEBRTC_VIDEO_CODEC_OK;
+    }));
+  }
+
+  // Frames with a native handle are encoded one stream at a time, but still
+  // on the queue of each stream.
+  std::vector<FrameType> frame_types(3, kVideoFrameKey);
+  rtc::scoped_refptr<VideoFrameBuffer> buffer(
+      I420Buffer::Create(codec.width, codec.height));
+  EXPECT_EQ(0, adapter->Encode(VideoFrame(buffer, 100, 1000, kVideoRotation_0),
+                               nullptr, &frame_types));
+  rtc::scoped_refptr<VideoFrameBuffer> native_buffer(
+      new rtc::RefCountedObject<FakeNativeBufferNoI420>(codec.width,
+                                                         codec.height));
+  EXPECT_EQ(0, adapter->Encode(
+                   VideoFrame(native_buffer, 200, 2000, kVideoRotation_0),
+                   nullptr, &frame_types));
+  adapter->SetRateAllocation(rate_allocator.GetAllocation(target_bitrate, 30),
+                             30);
+  adapter->Release();
+
+  for (MockVideoEncoder* encoder : encoders)
+    EXPECT_TRUE(encoder->called_sequentially());
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -0,0 +1,289 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "media/engine/video_encoder_pool.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/types/optional.h"
+#include "modules/video_coding/include/video_error_codes.h"
+#include "rtc_base/checks.h"
+#include "system_wrappers/include/metrics.h"
+
+namespace webrtc {
+namespace {
+
+// Enough for the encoders of a few simulcast streams being reconfigured at the
+// same time. A 1080p libvpx encoder holds several megabytes.
+constexpr size_t kMaxIdleEncoders = 8;
+
+int NumberOfStreams(const VideoCodec& codec) {
+  if (codec.codecType == kVideoCodecVP9)
+    return std::max<int>(1, codec.VP9().numberOfSpatialLayers);
+  return std::max<int>(1, codec.numberOfSimulcastStreams);
+}
+
+int NumberOfTemporalLayers(const VideoCodec& codec) {
+  int number_of_temporal_layers = 0;
+  if (codec.numberOfSimulcastStreams > 1) {
+    number_of_temporal_layers = codec.simulcastStream[0].numberOfTemporalLayers;
+  } else if (codec.codecType == kVideoCodecVP8) {
+    number_of_temporal_layers = codec.VP8().numberOfTemporalLayers;
+  } else if (codec.codecType == kVideoCodecVP9) {
+    number_of_temporal_layers = codec.VP9().numberOfTemporalLayers;
+  }
+  return std::max(1, number_of_temporal_layers);
+}
+
+class PooledVideoEncoder : public VideoEncoder {
+ public:
+  PooledVideoEncoder(
+      VideoEncoderPool* pool,
+      const SdpVideoFormat& format,
+      std::function<std::unique_ptr<VideoEncoder>()> create_encoder,
+      std::unique_ptr<VideoEncoder> encoder);
+  ~PooledVideoEncoder() override;
+
+  int32_t InitEncode(const VideoCodec* codec_settings,
+                     int32_t number_of_cores,
+                     size_t max_payload_size) override;
+  int32_t RegisterEncodeCompleteCallback(
+      EncodedImageCallback* callback) override;
+  int32_t Release() override;
+  int32_t Encode(const VideoFrame& frame,
+                 const CodecSpecificInfo* codec_specific_info,
+                 const std::vector<FrameType>* frame_types) override;
+  int32_t SetRates(uint32_t bitrate, uint32_t framerate) override;
+  int32_t SetRateAllocation(const VideoBitrateAllocation& allocation,
+                            uint32_t framerate) override;
+  EncoderInfo GetEncoderInfo() const override;
+
+ private:
+  // Gives |encoder_| back to the pool.
+  void ReturnEncoder();
+
+  VideoEncoderPool* const pool_;
+  const SdpVideoFormat format_;
+  const std::function<std::unique_ptr<VideoEncoder>()> create_encoder_;
+  EncodedImageCallback* callback_;
+  // Null between Release() and InitEncode().
+  std::unique_ptr<VideoEncoder> encoder_;
+  // The settings |encoder_| was initialized with, unset if it has not been.
+  absl::optional<VideoEncoderPool::SettingsClass> settings_class_;
+  // The info of the last encoder, while |encoder_| is null.
+  EncoderInfo encoder_info_;
+};
+
+PooledVideoEncoder::PooledVideoEncoder(
+    VideoEncoderPool* pool,
+    const SdpVideoFormat& format,
+    std::function<std::unique_ptr<VideoEncoder>()> create_encoder,
+    std::unique_ptr<VideoEncoder> encoder)
+    : pool_(pool),
+      format_(format),
+      create_encoder_(std::move(create_encoder)),
+      callback_(nullptr),
+      encoder_(std::move(encoder)) {
+  RTC_DCHECK(encoder_);
+}
+
+PooledVideoEncoder::~PooledVideoEncoder() {
+  Release();
+}
+
+int32_t PooledVideoEncoder::InitEncode(const VideoCodec* codec_settings,
+                                       int32_t number_of_cores,
+                                       size_t max_payload_size) {
+  if (!codec_settings)
+    return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+  const VideoEncoderPool::SettingsClass settings_class(
+      format_, *codec_settings, number_of_cores);
+  if (settings_class_ && *settings_class_ != settings_class)
+    ReturnEncoder();
+  if (!settings_class_) {
+    // Prefer an initialized encoder over a new one.
+    std::unique_ptr<VideoEncoder> idle_encoder = pool_->Take(settings_class);
+    if (idle_encoder) {
+      encoder_ = std::move(idle_encoder);
+    } else if (!encoder_) {
+      encoder_ = create_encoder_();
+    }
+  }
+  encoder_->RegisterEncodeCompleteCallback(callback_);
+  const int32_t ret =
+      encoder_->InitEncode(codec_settings, number_of_cores, max_payload_size);
+  if (ret == WEBRTC_VIDEO_CODEC_OK) {
+    settings_class_.emplace(settings_class);
+  } else {
+    settings_class_.reset();
+  }
+  return ret;
+}
+
+int32_t PooledVideoEncoder::RegisterEncodeCompleteCallback(
+    EncodedImageCallback* callback) {
+  callback_ = callback;
+  if (!encoder_)
+    return WEBRTC_VIDEO_CODEC_OK;
+  return encoder_->RegisterEncodeCompleteCallback(callback);
+}
+
+int32_t PooledVideoEncoder::Release() {
+  if (!encoder_)
+    return WEBRTC_VIDEO_CODEC_OK;
+  if (!settings_class_)
+    return encoder_->Release();
+  ReturnEncoder();
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int32_t PooledVideoEncoder::Encode(
+    const VideoFrame& frame,
+    const CodecSpecificInfo* codec_specific_info,
+    const std::vector<FrameType>* frame_types) {
+  if (!encoder_)
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  return encoder_->Encode(frame, codec_specific_info, frame_types);
+}
+
+int32_t PooledVideoEncoder::SetRates(uint32_t bitrate, uint32_t framerate) {
+  if (!encoder_)
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  return encoder_->SetRates(bitrate, framerate);
+}
+
+int32_t PooledVideoEncoder::SetRateAllocation(
+    const VideoBitrateAllocation& allocation,
+    uint32_t framerate) {
+  if (!encoder_)
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  return encoder_->SetRateAllocation(allocation, framerate);
+}
+
+VideoEncoder::EncoderInfo PooledVideoEncoder::GetEncoderInfo() const {
+  if (!encoder_)
+    return encoder_info_;
+  return encoder_->GetEncoderInfo();
+}
+
+void PooledVideoEncoder::ReturnEncoder() {
+  RTC_DCHECK(encoder_);
+  RTC_DCHECK(settings_class_);
+  encoder_->RegisterEncodeCompleteCallback(nullptr);
+  encoder_info_ = encoder_->GetEncoderInfo();
+  pool_->Add(*settings_class_, std::move(encoder_));
+  settings_class_.reset();
+}
+
+}  // namespace
+
+VideoEncoderPool::SettingsClass::SettingsClass(const SdpVideoFormat& format,
+                                               const VideoCodec& codec,
+                                               int number_of_cores)
+    : format(format),
+      mode(codec.mode),
+      number_of_streams(NumberOfStreams(codec)),
+      number_of_temporal_layers(NumberOfTemporalLayers(codec)),
+      number_of_cores(number_of_cores) {}
+
+VideoEncoderPool::SettingsClass::SettingsClass(const SettingsClass&) = default;
+
+VideoEncoderPool::SettingsClass::~SettingsClass() = default;
+
+bool VideoEncoderPool::SettingsClass::operator==(
+    const SettingsClass& other) const {
+  return format == other.format && mode == other.mode &&
+         number_of_streams == other.number_of_streams &&
+         number_of_temporal_layers == other.number_of_temporal_layers &&
+         number_of_cores == other.number_of_cores;
+}
+
+VideoEncoderPool* VideoEncoderPool::GetInstance() {
+  static VideoEncoderPool* const pool = new VideoEncoderPool();
+  return pool;
+}
+
+VideoEncoderPool::VideoEncoderPool() = default;
+
+VideoEncoderPool::~VideoEncoderPool() = default;
+
+std::unique_ptr<VideoEncoder> VideoEncoderPool::Take(
+    const SettingsClass& settings_class) {
+  std::unique_ptr<VideoEncoder> encoder;
+  {
+    rtc::CritScope lock(&crit_);
+    for (auto it = idle_encoders_.rbegin(); it != idle_encoders_.rend();
+         ++it) {
+      if (it->first == settings_class) {
+        encoder = std::move(it->second);
+        idle_encoders_.erase(std::next(it).base());
+        break;
+      }
+    }
+    if (encoder) {
+      ++stats_.hits;
+    } else {
+      ++stats_.misses;
+    }
+  }
+  RTC_HISTOGRAM_BOOLEAN("WebRTC.Video.EncoderPool.Hit", encoder != nullptr);
+  return encoder;
+}
+
+void VideoEncoderPool::Add(const SettingsClass& settings_class,
+                           std::unique_ptr<VideoEncoder> encoder) {
+  RTC_DCHECK(encoder);
+  std::unique_ptr<VideoEncoder> evicted_encoder;
+  {
+    rtc::CritScope lock(&crit_);
+    idle_encoders_.emplace_back(settings_class, std::move(encoder));
+    if (idle_encoders_.size() > kMaxIdleEncoders) {
+      evicted_encoder = std::move(idle_encoders_.front().second);
+      idle_encoders_.pop_front();
+    }
+  }
+  // Destroyed outside the lock, as releasing an encoder takes a while.
+}
+
+void VideoEncoderPool::Clear() {
+  std::list<std::pair<SettingsClass, std::unique_ptr<VideoEncoder>>>
+      idle_encoders;
+  {
+    rtc::CritScope lock(&crit_);
+    idle_encoders.swap(idle_encoders_);
+  }
+}
+
+size_t VideoEncoderPool::NumIdleEncoders() const {
+  rtc::CritScope lock(&crit_);
+  return idle_encoders_.size();
+}
+
+VideoEncoderPool::Stats VideoEncoderPool::GetStats() const {
+  rtc::CritScope lock(&crit_);
+  return stats_;
+}
+
+std::unique_ptr<VideoEncoder> CreatePooledVideoEncoder(
+    VideoEncoderPool* pool,
+    const SdpVideoFormat& format,
+    std::function<std::unique_ptr<VideoEncoder>()> create_encoder) {
+  // Answers GetEncoderInfo() until the first InitEncode(), and tells whether
+  // the format is supported.
+  std::unique_ptr<VideoEncoder> encoder = create_encoder();
+  if (!encoder)
+    return nullptr;
+  return absl::make_unique<PooledVideoEncoder>(
+      pool, format, std::move(create_encoder), std::move(encoder));
+}
+
+}  // namespace webrtc
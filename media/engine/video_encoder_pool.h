@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MEDIA_ENGINE_VIDEO_ENCODER_POOL_H_
+#define MEDIA_ENGINE_VIDEO_ENCODER_POOL_H_
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <utility>
+
+#include "api/video_codecs/sdp_video_format.h"
+#include "api/video_codecs/video_codec.h"
+#include "api/video_codecs/video_encoder.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Keeps idle encoders, still initialized, so that a reconfiguration or a new
+// stream with the same kind of settings can take one and reconfigure it in
+// place instead of creating and initializing a new one. The libvpx encoders
+// only reinitialize in place when the new settings allow it, and fall back to
+// a full initialization otherwise. Thread-safe.
+class VideoEncoderPool {
+ public:
+  // What an idle encoder must have been used for to be handed out for new
+  // settings: the same format, content type and layer structure, and the
+  // same number of cores. The resolution and the rates may differ.
+  struct SettingsClass {
+    SettingsClass(const SdpVideoFormat& format,
+                  const VideoCodec& codec,
+                  int number_of_cores);
+    SettingsClass(const SettingsClass&);
+    ~SettingsClass();
+
+    bool operator==(const SettingsClass& other) const;
+    bool operator!=(const SettingsClass& other) const {
+      return !(*this == other);
+    }
+
+    SdpVideoFormat format;
+    VideoCodecMode mode;
+    // Simulcast streams, or spatial layers for VP9.
+    int number_of_streams;
+    int number_of_temporal_layers;
+    int number_of_cores;
+  };
+
+  struct Stats {
+    int hits = 0;
+    int misses = 0;
+  };
+
+  // The pool shared by the encoders of the process.
+  static VideoEncoderPool* GetInstance();
+
+  VideoEncoderPool();
+  ~VideoEncoderPool();
+
+  // Returns the most recently added idle encoder of |settings_class|, or null
+  // if there is none.
+  std::unique_ptr<VideoEncoder> Take(const SettingsClass& settings_class);
+
+  // Keeps |encoder|, which may still be initialized, until a Take() for
+  // |settings_class|. The callback of |encoder| must have been cleared. When
+  // the pool is full, the encoder that has been idle for the longest time is
+  // destroyed.
+  void Add(const SettingsClass& settings_class,
+           std::unique_ptr<VideoEncoder> encoder);
+
+  // Destroys all idle encoders.
+  void Clear();
+
+  size_t NumIdleEncoders() const;
+  Stats GetStats() const;
+
+ private:
+  rtc::CriticalSection crit_;
+  std::list<std::pair<SettingsClass, std::unique_ptr<VideoEncoder>>>
+      idle_encoders_ RTC_GUARDED_BY(crit_);
+  Stats stats_ RTC_GUARDED_BY(crit_);
+};
+
+// Creates an encoder of |format| that takes an encoder from |pool| at
+// InitEncode() and gives it back, without releasing it, at Release() and on
+// destruction. |create_encoder| creates a new one when |pool| has none for
+// the settings. Returns null if |create_encoder| does.
+std::unique_ptr<VideoEncoder> CreatePooledVideoEncoder(
+    VideoEncoderPool* pool,
+    const SdpVideoFormat& format,
+    std::function<std::unique_ptr<VideoEncoder>()> create_encoder);
+
+}  // namespace webrtc
+
+#endif  // MEDIA_ENGINE_VIDEO_ENCODER_POOL_H_
@@ -0,0 +1,156 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "api/video/i420_buffer.h"
+#include "api/video/video_frame.h"
+#include "api/video_codecs/sdp_video_format.h"
+#include "api/video_codecs/video_encoder.h"
+#include "media/base/mediaconstants.h"
+#include "media/engine/internalencoderfactory.h"
+#include "media/engine/video_encoder_pool.h"
+#include "modules/video_coding/include/video_error_codes.h"
+#include "rtc_base/arraysize.h"
+#include "rtc_base/timeutils.h"
+#include "test/field_trial.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+#include "test/video_codec_settings.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kNumReconfigurations = 30;
+// With more cores, the libvpx encoders use more threads at the higher
+// resolutions, which they can not change in place.
+constexpr int kNumCores = 1;
+constexpr size_t kMaxPayloadSize = 1200;
+
+// The resolutions a 720p camera stream goes through when adapting to CPU and
+// bandwidth.
+constexpr std::pair<int, int> kResolutions[] = {
+    {1280, 720}, {960, 540}, {640, 360}, {960, 540}};
+
+class CountingCallback : public EncodedImageCallback {
+ public:
+  Result OnEncodedImage(const EncodedImage& encoded_image,
+                        const CodecSpecificInfo* codec_specific_info,
+                        const RTPFragmentationHeader* fragmentation) override {
+    ++num_encoded_images_;
+    return Result(Result::OK);
+  }
+
+  int num_encoded_images() const { return num_encoded_images_; }
+
+ private:
+  int num_encoded_images_ = 0;
+};
+
+// Reconfigures an encoder of |format| the way the encoder database does, with
+// Release() and InitEncode(), and encodes a frame after each
+// reconfiguration. Returns the average time in ms of Release() and
+// InitEncode().
+double MeasureReconfigurationMs(const SdpVideoFormat& format,
+                                VideoCodecType codec_type) {
+  InternalEncoderFactory factory;
+  std::unique_ptr<VideoEncoder> encoder = factory.CreateVideoEncoder(format);
+  CountingCallback callback;
+  encoder->RegisterEncodeCompleteCallback(&callback);
+  VideoCodec codec;
+  test::CodecSettings(codec_type, &codec);
+
+  int64_t reconfiguration_ns = 0;
+  uint32_t rtp_timestamp = 0;
+  const std::vector<FrameType> frame_types = {kVideoFrameDelta};
+  for (int i = 0; i <= kNumReconfigurations; ++i) {
+    const std::pair<int, int>& resolution =
+        kResolutions[i % arraysize(kResolutions)];
+    codec.width = resolution.first;
+    codec.height = resolution.second;
+    const int64_t start_ns = rtc::TimeNanos();
+    encoder->Release();
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              encoder->InitEncode(&codec, kNumCores, kMaxPayloadSize));
+    // The first initialization is not a reconfiguration.
+    if (i > 0)
+      reconfiguration_ns += rtc::TimeNanos() - start_ns;
+
+    rtc::scoped_refptr<I420Buffer> buffer =
+        I420Buffer::Create(codec.width, codec.height);
+    I420Buffer::SetBlack(buffer);
+    rtp_timestamp += 90000 / codec.maxFramerate;
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              encoder->Encode(VideoFrame(buffer, rtp_timestamp, 0,
+                                         kVideoRotation_0),
+                              nullptr, &frame_types));
+  }
+  encoder->Release();
+  EXPECT_LT(0, callback.num_encoded_images());
+  return static_cast<double>(reconfiguration_ns) / kNumReconfigurations /
+         rtc::kNumNanosecsPerMillisec;
+}
+
+void RunReconfigurationTest(const SdpVideoFormat& format,
+                            VideoCodecType codec_type) {
+  const std::string codec_name = "_" + format.name;
+  {
+    webrtc::test::ScopedFieldTrials field_trials("");
+    webrtc::test::PrintResult("encoder_reconfiguration_time", codec_name,
+                              "new_encoder",
+                              MeasureReconfigurationMs(format, codec_type),
+                              "ms", false);
+  }
+  {
+    webrtc::test::ScopedFieldTrials field_trials(
+        "WebRTC-VideoEncoderPool/Enabled/");
+    VideoEncoderPool* const pool = VideoEncoderPool::GetInstance();
+    pool->Clear();
+    const VideoEncoderPool::Stats stats_before = pool->GetStats();
+    webrtc::test::PrintResult("encoder_reconfiguration_time", codec_name,
+                              "pooled_encoder",
+                              MeasureReconfigurationMs(format, codec_type),
+                              "ms", false);
+    const VideoEncoderPool::Stats stats = pool->GetStats();
+    const int hits = stats.hits - stats_before.hits;
+    const int takes = hits + stats.misses - stats_before.misses;
+    webrtc::test::PrintResult("encoder_pool_hit_rate", codec_name,
+                              "pooled_encoder", 100.0 * hits / takes, "%",
+                              false);
+    pool->Clear();
+  }
+}
+
+}  // namespace
+
+// Measures the time the encoder database spends on reconfiguring a libvpx or
+// OpenH264 encoder for a new resolution, with a new encoder each time and with
+// the encoder pool, in which the libvpx encoders reconfigure in place.
+TEST(VideoEncoderPoolPerformanceTest, ReconfigureVp8) {
+  RunReconfigurationTest(SdpVideoFormat(cricket::kVp8CodecName),
+                         kVideoCodecVP8);
+}
+
+TEST(VideoEncoderPoolPerformanceTest, ReconfigureVp9) {
+  RunReconfigurationTest(SdpVideoFormat(cricket::kVp9CodecName),
+                         kVideoCodecVP9);
+}
+
+#if defined(WEBRTC_USE_H264)
+TEST(VideoEncoderPoolPerformanceTest, ReconfigureH264) {
+  RunReconfigurationTest(SdpVideoFormat(cricket::kH264CodecName),
+                         kVideoCodecH264);
+}
+#endif  // defined(WEBRTC_USE_H264)
+
+}  // namespace webrtc
@@ -0,0 +1,177 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "media/engine/video_encoder_pool.h"
+
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "api/test/mock_video_encoder.h"
+#include "modules/video_coding/include/video_error_codes.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+
+namespace {
+
+constexpr int kNumCores = 2;
+constexpr size_t kMaxPayloadSize = 1200;
+
+class VideoEncoderPoolTest : public testing::Test {
+ protected:
+  VideoEncoderPoolTest() : format_("VP8") {
+    codec_.codecType = kVideoCodecVP8;
+    codec_.width = 640;
+    codec_.height = 360;
+    codec_.maxFramerate = 30;
+    *codec_.VP8() = VideoEncoder::GetDefaultVp8Settings();
+  }
+
+  std::unique_ptr<VideoEncoder> CreatePooledEncoder() {
+    return CreatePooledVideoEncoder(&pool_, format_, [this] {
+      auto encoder = absl::make_unique<NiceMock<MockVideoEncoder>>();
+      created_encoders_.push_back(encoder.get());
+      return encoder;
+    });
+  }
+
+  VideoEncoderPool pool_;
+  const SdpVideoFormat format_;
+  VideoCodec codec_;
+  // Not owned; the encoders are destroyed by the pooled encoders and the pool.
+  std::vector<MockVideoEncoder*> created_encoders_;
+};
+
+}  // namespace
+
+TEST_F(VideoEncoderPoolTest, KeepsEncoderInitializedAcrossRelease) {
+  std::unique_ptr<VideoEncoder> encoder = CreatePooledEncoder();
+  ASSERT_EQ(1u, created_encoders_.size());
+  MockVideoEncoder* const mock = created_encoders_[0];
+  EXPECT_CALL(*mock, InitEncode(_, kNumCores, kMaxPayloadSize)).Times(2);
+  EXPECT_CALL(*mock, Release()).Times(0);
+
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder->InitEncode(&codec_, kNumCores, kMaxPayloadSize));
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->Release());
+  EXPECT_EQ(1u, pool_.NumIdleEncoders());
+
+  // A new resolution is in the same settings class.
+  codec_.width = 320;
+  codec_.height = 180;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder->InitEncode(&codec_, kNumCores, kMaxPayloadSize));
+  EXPECT_EQ(0u, pool_.NumIdleEncoders());
+  EXPECT_EQ(1u, created_encoders_.size());
+
+  testing::Mock::VerifyAndClearExpectations(mock);
+}
+
+TEST_F(VideoEncoderPoolTest, SharesIdleEncodersBetweenInstances) {
+  std::unique_ptr<VideoEncoder> first_encoder = CreatePooledEncoder();
+  MockVideoEncoder* const mock = created_encoders_[0];
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            first_encoder->InitEncode(&codec_, kNumCores, kMaxPayloadSize));
+  first_encoder.reset();
+  EXPECT_EQ(1u, pool_.NumIdleEncoders());
+
+  std::unique_ptr<VideoEncoder> second_encoder = CreatePooledEncoder();
+  ASSERT_EQ(2u, created_encoders_.size());
+  created_encoders_.pop_back();  // Destroyed at InitEncode().
+  EXPECT_CALL(*mock, InitEncode(_, kNumCores, kMaxPayloadSize));
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            second_encoder->InitEncode(&codec_, kNumCores, kMaxPayloadSize));
+
+  const VideoEncoderPool::Stats stats = pool_.GetStats();
+  EXPECT_EQ(1, stats.hits);
+  EXPECT_EQ(1, stats.misses);
+}
+
+TEST_F(VideoEncoderPoolTest, DoesNotShareEncodersBetweenSettingsClasses) {
+  std::unique_ptr<VideoEncoder> encoder = CreatePooledEncoder();
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder->InitEncode(&codec_, kNumCores, kMaxPayloadSize));
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->Release());
+
+  codec_.VP8()->numberOfTemporalLayers = 3;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder->InitEncode(&codec_, kNumCores, kMaxPayloadSize));
+  EXPECT_EQ(2u, created_encoders_.size());
+  EXPECT_EQ(1u, pool_.NumIdleEncoders());
+
+  // Changing the settings class without Release() gives the encoder back too.
+  codec_.mode = VideoCodecMode::kScreensharing;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder->InitEncode(&codec_, kNumCores, kMaxPayloadSize));
+  EXPECT_EQ(3u, created_encoders_.size());
+  EXPECT_EQ(2u, pool_.NumIdleEncoders());
+
+  const VideoEncoderPool::Stats stats = pool_.GetStats();
+  EXPECT_EQ(0, stats.hits);
+  EXPECT_EQ(3, stats.misses);
+}
+
+TEST_F(VideoEncoderPoolTest, DoesNotKeepEncodersThatFailedToInitialize) {
+  std::unique_ptr<VideoEncoder> encoder = CreatePooledEncoder();
+  MockVideoEncoder* const mock = created_encoders_[0];
+  EXPECT_CALL(*mock, InitEncode(_, _, _))
+      .WillOnce(
+          Return(WEBRTC_VIDEO_CODEC_ERR_SIMULCAST_PARAMETERS_NOT_SUPPORTED));
+  EXPECT_CALL(*mock, Release()).WillOnce(Return(WEBRTC_VIDEO_CODEC_OK));
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_ERR_SIMULCAST_PARAMETERS_NOT_SUPPORTED,
+            encoder->InitEncode(&codec_, kNumCores, kMaxPayloadSize));
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->Release());
+  EXPECT_EQ(0u, pool_.NumIdleEncoders());
+}
+
+TEST_F(VideoEncoderPoolTest, ForwardsCallbackToTakenEncoder) {
+  std::unique_ptr<VideoEncoder> encoder = CreatePooledEncoder();
+  MockVideoEncoder* const mock = created_encoders_[0];
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder->InitEncode(&codec_, kNumCores, kMaxPayloadSize));
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder->Release());
+
+  // Another instance uses the encoder in between.
+  std::unique_ptr<VideoEncoder> other_encoder = CreatePooledEncoder();
+  created_encoders_.pop_back();
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            other_encoder->InitEncode(&codec_, kNumCores, kMaxPayloadSize));
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, other_encoder->Release());
+
+  MockEncodedImageCallback callback;
+  EXPECT_CALL(*mock, RegisterEncodeCompleteCallback(_))
+      .Times(testing::AnyNumber());
+  EXPECT_CALL(*mock, RegisterEncodeCompleteCallback(&callback));
+  encoder->RegisterEncodeCompleteCallback(&callback);
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder->InitEncode(&codec_, kNumCores, kMaxPayloadSize));
+}
+
+TEST_F(VideoEncoderPoolTest, DestroysLongestIdleEncoderWhenFull) {
+  std::vector<std::unique_ptr<VideoEncoder>> encoders;
+  for (int i = 0; i < 10; ++i) {
+    encoders.push_back(CreatePooledEncoder());
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              encoders.back()->InitEncode(&codec_, kNumCores,
+                                          kMaxPayloadSize));
+  }
+  encoders.clear();
+  EXPECT_EQ(8u, pool_.NumIdleEncoders());
+
+  pool_.Clear();
+  EXPECT_EQ(0u, pool_.NumIdleEncoders());
+}
+
+}  // namespace webrtc
@@ -70,14 +70,28 @@ class OpusFrame : public AudioDecoder::EncodedAudioFrame {
 }  // namespace
 
 AudioDecoderOpusImpl::AudioDecoderOpusImpl(size_t num_channels)
-    : channels_(num_channels) {
+    : AudioDecoderOpusImpl(num_channels, nullptr) {}
+
+AudioDecoderOpusImpl::AudioDecoderOpusImpl(
+    size_t num_channels,
+    rtc::scoped_refptr<OpusStatePool> state_pool)
+    : channels_(num_channels), state_pool_(std::move(state_pool)) {
   RTC_DCHECK(num_channels == 1 || num_channels == 2);
-  WebRtcOpus_DecoderCreate(&dec_state_, channels_);
-  WebRtcOpus_DecoderInit(dec_state_);
+  if (state_pool_) {
+    dec_state_ = state_pool_->TakeDecoder(channels_);
+    RTC_CHECK(dec_state_);
+  } else {
+    WebRtcOpus_DecoderCreate(&dec_state_, channels_);
+    WebRtcOpus_DecoderInit(dec_state_);
+  }
 }
 
 AudioDecoderOpusImpl::~AudioDecoderOpusImpl() {
-  WebRtcOpus_DecoderFree(dec_state_);
+  if (state_pool_) {
+    state_pool_->ReturnDecoder(dec_state_);
+  } else {
+    WebRtcOpus_DecoderFree(dec_state_);
+  }
 }
 
 std::vector<AudioDecoder::ParseResult> AudioDecoderOpusImpl::ParsePayload(
@@ -17,14 +17,20 @@
 
 #include "api/audio_codecs/audio_decoder.h"
 #include "modules/audio_coding/codecs/opus/opus_interface.h"
+#include "modules/audio_coding/codecs/opus/opus_state_pool.h"
 #include "rtc_base/buffer.h"
 #include "rtc_base/constructormagic.h"
+#include "rtc_base/scoped_ref_ptr.h"
 
 namespace webrtc {
 
 class AudioDecoderOpusImpl final : public AudioDecoder {
  public:
   explicit AudioDecoderOpusImpl(size_t num_channels);
+  // Takes the libopus state from |state_pool| and gives it back on
+  // destruction.
+  AudioDecoderOpusImpl(size_t num_channels,
+                       rtc::scoped_refptr<OpusStatePool> state_pool);
   ~AudioDecoderOpusImpl() override;
 
   std::vector<ParseResult> ParsePayload(rtc::Buffer&& payload,
@@ -52,6 +58,8 @@ class AudioDecoderOpusImpl final : public AudioDecoder {
  private:
   OpusDecInst* dec_state_;
   const size_t channels_;
+  // Null unless |dec_state_| comes from a pool.
+  const rtc::scoped_refptr<OpusStatePool> state_pool_;
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioDecoderOpusImpl);
 };
 
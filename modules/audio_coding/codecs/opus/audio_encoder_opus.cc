@@ -463,11 +463,36 @@ AudioEncoderOpusImpl::AudioEncoderOpusImpl(const AudioEncoderOpusConfig& config,
           // We choose 5sec as initial time constant due to empirical data.
           absl::make_unique<SmoothingFilterImpl>(5000)) {}
 
+AudioEncoderOpusImpl::AudioEncoderOpusImpl(
+    const AudioEncoderOpusConfig& config,
+    int payload_type,
+    rtc::scoped_refptr<OpusStatePool> state_pool)
+    : AudioEncoderOpusImpl(
+          config,
+          payload_type,
+          [this](const ProtoString& config_string, RtcEventLog* event_log) {
+            return DefaultAudioNetworkAdaptorCreator(config_string, event_log);
+          },
+          absl::make_unique<SmoothingFilterImpl>(5000),
+          std::move(state_pool)) {}
+
 AudioEncoderOpusImpl::AudioEncoderOpusImpl(
     const AudioEncoderOpusConfig& config,
     int payload_type,
     const AudioNetworkAdaptorCreator& audio_network_adaptor_creator,
     std::unique_ptr<SmoothingFilter> bitrate_smoother)
+    : AudioEncoderOpusImpl(config,
+                           payload_type,
+                           audio_network_adaptor_creator,
+                           std::move(bitrate_smoother),
+                           nullptr) {}
+
+AudioEncoderOpusImpl::AudioEncoderOpusImpl(
+    const AudioEncoderOpusConfig& config,
+    int payload_type,
+    const AudioNetworkAdaptorCreator& audio_network_adaptor_creator,
+    std::unique_ptr<SmoothingFilter> bitrate_smoother,
+    rtc::scoped_refptr<OpusStatePool> state_pool)
     : payload_type_(payload_type),
       send_side_bwe_with_overhead_(
           webrtc::field_trial::IsEnabled("WebRTC-SendSideBwe-WithOverhead")),
@@ -483,7 +508,8 @@ AudioEncoderOpusImpl::AudioEncoderOpusImpl(
       packet_loss_fraction_smoother_(new PacketLossFractionSmoother()),
       audio_network_adaptor_creator_(audio_network_adaptor_creator),
       bitrate_smoother_(std::move(bitrate_smoother)),
-      consecutive_dtx_frames_(0) {
+      consecutive_dtx_frames_(0),
+      state_pool_(std::move(state_pool)) {
   RTC_DCHECK(0 <= payload_type && payload_type <= 127);
 
   // Sanity check of the redundant payload type field that we want to get rid
@@ -502,7 +528,7 @@ AudioEncoderOpusImpl::AudioEncoderOpusImpl(int payload_type,
     : AudioEncoderOpusImpl(*SdpToConfig(format), payload_type) {}
 
 AudioEncoderOpusImpl::~AudioEncoderOpusImpl() {
-  RTC_CHECK_EQ(0, WebRtcOpus_EncoderFree(inst_));
+  FreeEncoderInstance();
 }
 
 int AudioEncoderOpusImpl::SampleRateHz() const {
@@ -774,16 +800,27 @@ bool AudioEncoderOpusImpl::RecreateEncoderInstance(
   if (!config.IsOk())
     return false;
   config_ = config;
-  if (inst_)
-    RTC_CHECK_EQ(0, WebRtcOpus_EncoderFree(inst_));
   input_buffer_.clear();
   input_buffer_.reserve(Num10msFramesPerPacket() * SamplesPer10msFrame());
-  RTC_CHECK_EQ(0, WebRtcOpus_EncoderCreate(
-                      &inst_, config.num_channels,
-                      config.application ==
-                              AudioEncoderOpusConfig::ApplicationMode::kVoip
-                          ? 0
-                          : 1));
+  const int32_t application =
+      config.application == AudioEncoderOpusConfig::ApplicationMode::kVoip ? 0
+                                                                           : 1;
+  if (state_pool_) {
+    // Resetting the current instance in place is as good as taking a fresh
+    // one from the pool, but only works for the same number of channels.
+    if (inst_ && WebRtcOpus_EncoderChannels(inst_) != config.num_channels)
+      FreeEncoderInstance();
+    if (inst_) {
+      RTC_CHECK_EQ(0, WebRtcOpus_EncoderReset(inst_, application));
+    } else {
+      inst_ = state_pool_->TakeEncoder(config.num_channels, application);
+      RTC_CHECK(inst_);
+    }
+  } else {
+    FreeEncoderInstance();
+    RTC_CHECK_EQ(0, WebRtcOpus_EncoderCreate(&inst_, config.num_channels,
+                                             application));
+  }
   RTC_CHECK_EQ(0, WebRtcOpus_SetBitRate(inst_, GetBitrateBps(config)));
   if (config.fec_enabled) {
     RTC_CHECK_EQ(0, WebRtcOpus_EnableFec(inst_));
@@ -815,6 +852,17 @@ bool AudioEncoderOpusImpl::RecreateEncoderInstance(
   return true;
 }
 
+void AudioEncoderOpusImpl::FreeEncoderInstance() {
+  if (!inst_)
+    return;
+  if (state_pool_) {
+    state_pool_->ReturnEncoder(inst_);
+  } else {
+    RTC_CHECK_EQ(0, WebRtcOpus_EncoderFree(inst_));
+  }
+  inst_ = nullptr;
+}
+
 void AudioEncoderOpusImpl::SetFrameLength(int frame_length_ms) {
   next_frame_length_ms_ = frame_length_ms;
 }
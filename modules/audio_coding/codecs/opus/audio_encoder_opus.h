@@ -23,8 +23,10 @@
 #include "common_audio/smoothing_filter.h"
 #include "modules/audio_coding/audio_network_adaptor/include/audio_network_adaptor.h"
 #include "modules/audio_coding/codecs/opus/opus_interface.h"
+#include "modules/audio_coding/codecs/opus/opus_state_pool.h"
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/protobuf_utils.h"
+#include "rtc_base/scoped_ref_ptr.h"
 
 namespace webrtc {
 
@@ -76,12 +78,24 @@ class AudioEncoderOpusImpl final : public AudioEncoder {
 
   AudioEncoderOpusImpl(const AudioEncoderOpusConfig& config, int payload_type);
 
+  // Takes the libopus state from |state_pool| and gives it back on
+  // destruction.
+  AudioEncoderOpusImpl(const AudioEncoderOpusConfig& config,
+                       int payload_type,
+                       rtc::scoped_refptr<OpusStatePool> state_pool);
+
   // Dependency injection for testing.
   AudioEncoderOpusImpl(
       const AudioEncoderOpusConfig& config,
       int payload_type,
       const AudioNetworkAdaptorCreator& audio_network_adaptor_creator,
       std::unique_ptr<SmoothingFilter> bitrate_smoother);
+  AudioEncoderOpusImpl(
+      const AudioEncoderOpusConfig& config,
+      int payload_type,
+      const AudioNetworkAdaptorCreator& audio_network_adaptor_creator,
+      std::unique_ptr<SmoothingFilter> bitrate_smoother,
+      rtc::scoped_refptr<OpusStatePool> state_pool);
 
   explicit AudioEncoderOpusImpl(const CodecInst& codec_inst);
   AudioEncoderOpusImpl(int payload_type, const SdpAudioFormat& format);
@@ -181,6 +195,8 @@ class AudioEncoderOpusImpl final : public AudioEncoder {
 
   void MaybeUpdateUplinkBandwidth();
 
+  void FreeEncoderInstance();
+
   AudioEncoderOpusConfig config_;
   const int payload_type_;
   const bool send_side_bwe_with_overhead_;
@@ -204,6 +220,8 @@ class AudioEncoderOpusImpl final : public AudioEncoder {
   absl::optional<int64_t> bitrate_smoother_last_update_time_;
   absl::optional<int64_t> link_capacity_allocation_bps_;
   int consecutive_dtx_frames_;
+  // Null unless the encoder state comes from a pool.
+  const rtc::scoped_refptr<OpusStatePool> state_pool_;
 
   friend struct AudioEncoderOpus;
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioEncoderOpusImpl);
@@ -37,6 +37,18 @@ enum {
   kWebRtcOpusDefaultFrameSize = 960,
 };
 
+/* Returns the libopus application for |application|, or -1 if invalid. */
+static int ToOpusApplication(int32_t application) {
+  switch (application) {
+    case 0:
+      return OPUS_APPLICATION_VOIP;
+    case 1:
+      return OPUS_APPLICATION_AUDIO;
+    default:
+      return -1;
+  }
+}
+
 int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
                                  size_t channels,
                                  int32_t application) {
@@ -44,16 +56,9 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
   if (!inst)
     return -1;
 
-  switch (application) {
-    case 0:
-      opus_app = OPUS_APPLICATION_VOIP;
-      break;
-    case 1:
-      opus_app = OPUS_APPLICATION_AUDIO;
-      break;
-    default:
-      return -1;
-  }
+  opus_app = ToOpusApplication(application);
+  if (opus_app < 0)
+    return -1;
 
   OpusEncInst* state = calloc(1, sizeof(OpusEncInst));
   RTC_DCHECK(state);
@@ -83,6 +88,25 @@ int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst) {
   }
 }
 
+int16_t WebRtcOpus_EncoderReset(OpusEncInst* inst, int32_t application) {
+  int opus_app = ToOpusApplication(application);
+  if (!inst || opus_app < 0)
+    return -1;
+
+  /* Initializing the existing state in place gives the same result as
+   * opus_encoder_create(), without the allocation. */
+  if (opus_encoder_init(inst->encoder, 48000, (int)inst->channels,
+                        opus_app) != OPUS_OK) {
+    return -1;
+  }
+  inst->in_dtx_mode = 0;
+  return 0;
+}
+
+size_t WebRtcOpus_EncoderChannels(OpusEncInst* inst) {
+  return inst->channels;
+}
+
 int WebRtcOpus_Encode(OpusEncInst* inst,
                       const int16_t* audio_in,
                       size_t samples,
@@ -313,6 +337,11 @@ void WebRtcOpus_DecoderInit(OpusDecInst* inst) {
   inst->in_dtx_mode = 0;
 }
 
+void WebRtcOpus_DecoderReset(OpusDecInst* inst) {
+  WebRtcOpus_DecoderInit(inst);
+  inst->prev_decoded_samples = kWebRtcOpusDefaultFrameSize;
+}
+
 /* For decoder to determine if it is to output speech or comfort noise. */
 static int16_t DetermineAudioType(OpusDecInst* inst, size_t encoded_bytes) {
   // Audio type becomes comfort noise if |encoded_byte| is 1 and keeps
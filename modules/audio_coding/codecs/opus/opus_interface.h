@@ -49,6 +49,32 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
 
 int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst);
 
+/****************************************************************************
+ * WebRtcOpus_EncoderReset(...)
+ *
+ * This function puts an encoder back in the state it had when it was created,
+ * with all the settings back to their defaults, without reallocating it. The
+ * number of channels is kept; the application may change.
+ *
+ * Input:
+ *      - inst               : Encoder context
+ *      - application        : 0 - VOIP applications.
+ *                                 Favor speech intelligibility.
+ *                             1 - Audio applications.
+ *                                 Favor faithfulness to the original input.
+ *
+ * Return value              : 0 - Success
+ *                            -1 - Error
+ */
+int16_t WebRtcOpus_EncoderReset(OpusEncInst* inst, int32_t application);
+
+/****************************************************************************
+ * WebRtcOpus_EncoderChannels(...)
+ *
+ * This function returns the number of channels created for Opus encoder.
+ */
+size_t WebRtcOpus_EncoderChannels(OpusEncInst* inst);
+
 /****************************************************************************
  * WebRtcOpus_Encode(...)
  *
@@ -298,6 +324,18 @@ size_t WebRtcOpus_DecoderChannels(OpusDecInst* inst);
  */
 void WebRtcOpus_DecoderInit(OpusDecInst* inst);
 
+/****************************************************************************
+ * WebRtcOpus_DecoderReset(...)
+ *
+ * This function puts a decoder back in the state it had when it was created,
+ * without reallocating it. Unlike WebRtcOpus_DecoderInit(), it also forgets
+ * the duration of the last decoded packet.
+ *
+ * Input:
+ *      - inst               : Decoder context
+ */
+void WebRtcOpus_DecoderReset(OpusDecInst* inst);
+
 /****************************************************************************
  * WebRtcOpus_Decode(...)
  *
@@ -0,0 +1,139 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/codecs/opus/opus_state_pool.h"
+
+#include "rtc_base/checks.h"
+#include "rtc_base/refcountedobject.h"
+
+namespace webrtc {
+
+rtc::scoped_refptr<OpusStatePool> OpusStatePool::Create(
+    size_t max_idle_states) {
+  return new rtc::RefCountedObject<OpusStatePool>(max_idle_states);
+}
+
+OpusStatePool::OpusStatePool(size_t max_idle_states)
+    : max_idle_states_(max_idle_states) {
+  for (size_t i = 0; i < kMaxChannels; ++i) {
+    idle_encoders_[i].reserve(max_idle_states_);
+    idle_decoders_[i].reserve(max_idle_states_);
+  }
+}
+
+OpusStatePool::~OpusStatePool() {
+  for (size_t i = 0; i < kMaxChannels; ++i) {
+    for (OpusEncInst* inst : idle_encoders_[i])
+      WebRtcOpus_EncoderFree(inst);
+    for (OpusDecInst* inst : idle_decoders_[i])
+      WebRtcOpus_DecoderFree(inst);
+  }
+}
+
+OpusEncInst* OpusStatePool::TakeEncoder(size_t num_channels,
+                                        int32_t application) {
+  RTC_DCHECK(num_channels == 1 || num_channels == 2);
+  OpusEncInst* inst = nullptr;
+  {
+    rtc::CritScope lock(&crit_);
+    std::vector<OpusEncInst*>& idle = idle_encoders_[num_channels - 1];
+    if (!idle.empty()) {
+      inst = idle.back();
+      idle.pop_back();
+      ++stats_.encoders_reused;
+    } else {
+      ++stats_.encoders_created;
+      stats_.allocated_bytes += sizeof(OpusEncInst) +
+                                opus_encoder_get_size(num_channels);
+    }
+  }
+  // Resetting or creating the state is done outside the lock, since it is by
+  // far the most expensive part.
+  if (inst) {
+    if (WebRtcOpus_EncoderReset(inst, application) != 0) {
+      WebRtcOpus_EncoderFree(inst);
+      return nullptr;
+    }
+    return inst;
+  }
+  if (WebRtcOpus_EncoderCreate(&inst, num_channels, application) != 0)
+    return nullptr;
+  return inst;
+}
+
+void OpusStatePool::ReturnEncoder(OpusEncInst* inst) {
+  if (!inst)
+    return;
+  const size_t num_channels = WebRtcOpus_EncoderChannels(inst);
+  RTC_DCHECK(num_channels == 1 || num_channels == 2);
+  {
+    rtc::CritScope lock(&crit_);
+    std::vector<OpusEncInst*>& idle = idle_encoders_[num_channels - 1];
+    if (idle.size() < max_idle_states_) {
+      idle.push_back(inst);
+      return;
+    }
+  }
+  WebRtcOpus_EncoderFree(inst);
+}
+
+OpusDecInst* OpusStatePool::TakeDecoder(size_t num_channels) {
+  RTC_DCHECK(num_channels == 1 || num_channels == 2);
+  OpusDecInst* inst = nullptr;
+  {
+    rtc::CritScope lock(&crit_);
+    std::vector<OpusDecInst*>& idle = idle_decoders_[num_channels - 1];
+    if (!idle.empty()) {
+      inst = idle.back();
+      idle.pop_back();
+      ++stats_.decoders_reused;
+    } else {
+      ++stats_.decoders_created;
+      stats_.allocated_bytes += sizeof(OpusDecInst) +
+                                opus_decoder_get_size(num_channels);
+    }
+  }
+  if (inst) {
+    WebRtcOpus_DecoderReset(inst);
+    return inst;
+  }
+  if (WebRtcOpus_DecoderCreate(&inst, num_channels) != 0)
+    return nullptr;
+  WebRtcOpus_DecoderInit(inst);
+  return inst;
+}
+
+void OpusStatePool::ReturnDecoder(OpusDecInst* inst) {
+  if (!inst)
+    return;
+  const size_t num_channels = WebRtcOpus_DecoderChannels(inst);
+  RTC_DCHECK(num_channels == 1 || num_channels == 2);
+  {
+    rtc::CritScope lock(&crit_);
+    std::vector<OpusDecInst*>& idle = idle_decoders_[num_channels - 1];
+    if (idle.size() < max_idle_states_) {
+      idle.push_back(inst);
+      return;
+    }
+  }
+  WebRtcOpus_DecoderFree(inst);
+}
+
+OpusStatePool::Stats OpusStatePool::GetStats() const {
+  rtc::CritScope lock(&crit_);
+  Stats stats = stats_;
+  for (size_t i = 0; i < kMaxChannels; ++i) {
+    stats.idle_encoders += idle_encoders_[i].size();
+    stats.idle_decoders += idle_decoders_[i].size();
+  }
+  return stats;
+}
+
+}  // namespace webrtc
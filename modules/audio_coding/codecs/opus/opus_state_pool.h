@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_STATE_POOL_H_
+#define MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_STATE_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <vector>
+
+#include "modules/audio_coding/codecs/opus/opus_interface.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/refcount.h"
+#include "rtc_base/scoped_ref_ptr.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Keeps the libopus states of destroyed encoders and decoders so that new ones
+// can reuse them instead of allocating. A state taken from the pool is reset
+// in place, and behaves exactly as a newly created one. The pool is shared by
+// the encoders and decoders that take states from it, and is thread-safe.
+class OpusStatePool : public rtc::RefCountInterface {
+ public:
+  struct Stats {
+    size_t encoders_created = 0;
+    size_t encoders_reused = 0;
+    size_t decoders_created = 0;
+    size_t decoders_reused = 0;
+    // Heap memory taken by the created states.
+    size_t allocated_bytes = 0;
+    size_t idle_encoders = 0;
+    size_t idle_decoders = 0;
+  };
+
+  // Creates a pool that keeps up to |max_idle_states| idle encoder states and
+  // as many idle decoder states, for each number of channels.
+  static rtc::scoped_refptr<OpusStatePool> Create(size_t max_idle_states);
+
+  // Returns an encoder state for |num_channels| channels (1 or 2), in the
+  // state WebRtcOpus_EncoderCreate() with |application| leaves it. Returns
+  // null on failure.
+  OpusEncInst* TakeEncoder(size_t num_channels, int32_t application);
+  // Gives back a state returned by TakeEncoder(). The pool frees it if it is
+  // full.
+  void ReturnEncoder(OpusEncInst* inst);
+
+  // Returns an initialized decoder state for |num_channels| channels (1 or 2).
+  // Returns null on failure.
+  OpusDecInst* TakeDecoder(size_t num_channels);
+  // Gives back a state returned by TakeDecoder(). The pool frees it if it is
+  // full.
+  void ReturnDecoder(OpusDecInst* inst);
+
+  Stats GetStats() const;
+
+ protected:
+  explicit OpusStatePool(size_t max_idle_states);
+  ~OpusStatePool() override;
+
+ private:
+  static constexpr size_t kMaxChannels = 2;
+
+  const size_t max_idle_states_;
+  rtc::CriticalSection crit_;
+  // Idle states, indexed by number of channels minus one.
+  std::array<std::vector<OpusEncInst*>, kMaxChannels> idle_encoders_
+      RTC_GUARDED_BY(crit_);
+  std::array<std::vector<OpusDecInst*>, kMaxChannels> idle_decoders_
+      RTC_GUARDED_BY(crit_);
+  Stats stats_ RTC_GUARDED_BY(crit_);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_STATE_POOL_H_
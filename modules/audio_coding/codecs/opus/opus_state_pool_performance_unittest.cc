@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "modules/audio_coding/codecs/opus/audio_decoder_opus.h"
+#include "modules/audio_coding/codecs/opus/audio_encoder_opus.h"
+#include "modules/audio_coding/codecs/opus/opus_state_pool.h"
+#include "rtc_base/cpu_time.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kPayloadType = 111;
+// Calls churning on a gateway: at any time |kNumLiveStreams| streams are up,
+// and every setup replaces the oldest stream.
+constexpr size_t kNumLiveStreams = 100;
+constexpr int kNumSetups = 5000;
+// One stream in four is stereo.
+constexpr int kStereoPeriod = 4;
+
+// An audio stream, with the encoder of the send side and the decoder of the
+// receive side, both taking their libopus states from |state_pool|.
+struct Stream {
+  Stream(size_t num_channels, rtc::scoped_refptr<OpusStatePool> state_pool)
+      : encoder(CreateConfig(num_channels), kPayloadType, state_pool),
+        decoder(num_channels, state_pool) {}
+
+  static AudioEncoderOpusConfig CreateConfig(size_t num_channels) {
+    AudioEncoderOpusConfig config;
+    config.num_channels = num_channels;
+    config.fec_enabled = true;
+    return config;
+  }
+
+  AudioEncoderOpusImpl encoder;
+  AudioDecoderOpusImpl decoder;
+};
+
+// Sets up |kNumSetups| streams, tearing down the oldest one each time, and
+// returns the CPU time taken in ns.
+int64_t RunChurn(rtc::scoped_refptr<OpusStatePool> state_pool) {
+  std::vector<std::unique_ptr<Stream>> streams(kNumLiveStreams);
+  for (auto& stream : streams) {
+    stream = absl::make_unique<Stream>(1, state_pool);
+  }
+  const int64_t start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+  for (int i = 0; i < kNumSetups; ++i) {
+    std::unique_ptr<Stream>& stream = streams[i % kNumLiveStreams];
+    stream.reset();
+    stream = absl::make_unique<Stream>(i % kStereoPeriod == 0 ? 2 : 1,
+                                       state_pool);
+  }
+  return rtc::GetThreadCpuTimeNanos() - start_cpu_ns;
+}
+
+}  // namespace
+
+// Measures the rate of Opus stream setups and teardowns, and the libopus state
+// allocations they make, with and without recycling the states. A pool
+// without idle states allocates exactly as the codecs do on their own.
+TEST(OpusStatePoolPerformanceTest, StreamSetupAndTeardown) {
+  for (size_t max_idle_states : {size_t{0}, kNumLiveStreams}) {
+    const char* trace = max_idle_states == 0 ? "new_states" : "pooled_states";
+    auto state_pool = OpusStatePool::Create(max_idle_states);
+    const int64_t elapsed_cpu_ns = RunChurn(state_pool);
+    test::PrintResult("opus_stream_setup_rate", "", trace,
+                      kNumSetups * 1e9 / elapsed_cpu_ns, "setups/s", false);
+
+    // Allocation profile, counting the initial streams too.
+    const OpusStatePool::Stats stats = state_pool->GetStats();
+    const double num_setups = kNumLiveStreams + kNumSetups;
+    test::PrintResult(
+        "opus_stream_setup_state_allocations", "", trace,
+        (stats.encoders_created + stats.decoders_created) / num_setups,
+        "allocations", false);
+    test::PrintResult("opus_stream_setup_allocated_bytes", "", trace,
+                      stats.allocated_bytes / num_setups, "bytes", false);
+    EXPECT_EQ(kNumLiveStreams + kNumSetups,
+              stats.encoders_created + stats.encoders_reused);
+  }
+}
+
+// Measures the cost of reconfiguring a live encoder, which recreates its
+// libopus state, or resets it in place when the encoder is pooled.
+TEST(OpusStatePoolPerformanceTest, EncoderReconfiguration) {
+  constexpr int kNumReconfigurations = 5000;
+  for (bool pooled : {false, true}) {
+    AudioEncoderOpusImpl encoder(
+        Stream::CreateConfig(2), kPayloadType,
+        pooled ? OpusStatePool::Create(/*max_idle_states=*/1) : nullptr);
+    const int64_t start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+    for (int i = 0; i < kNumReconfigurations; ++i) {
+      encoder.SetApplication(i % 2 == 0 ? AudioEncoder::Application::kSpeech
+                                        : AudioEncoder::Application::kAudio);
+    }
+    const int64_t elapsed_cpu_ns =
+        rtc::GetThreadCpuTimeNanos() - start_cpu_ns;
+    test::PrintResult("opus_encoder_reconfiguration_time", "",
+                      pooled ? "pooled" : "not_pooled",
+                      elapsed_cpu_ns / 1000.0 / kNumReconfigurations, "us",
+                      false);
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,189 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/codecs/opus/opus_state_pool.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "modules/audio_coding/codecs/opus/audio_decoder_opus.h"
+#include "modules/audio_coding/codecs/opus/audio_encoder_opus.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kPayloadType = 100;
+constexpr size_t kSamplesPer10Ms = 480;
+constexpr int kNumPackets = 25;
+
+AudioEncoderOpusConfig CreateConfig(size_t num_channels) {
+  AudioEncoderOpusConfig config;
+  config.num_channels = num_channels;
+  config.frame_size_ms = 20;
+  config.fec_enabled = true;
+  return config;
+}
+
+// Encodes |kNumPackets| packets of noise and returns them.
+std::vector<rtc::Buffer> EncodeNoise(AudioEncoder* encoder) {
+  Random random_generator(42U);
+  std::vector<int16_t> audio(kSamplesPer10Ms * encoder->NumChannels());
+  std::vector<rtc::Buffer> packets;
+  uint32_t rtp_timestamp = 0;
+  while (packets.size() < kNumPackets) {
+    for (int16_t& sample : audio) {
+      sample = random_generator.Rand<int16_t>();
+    }
+    rtc::Buffer encoded;
+    encoder->Encode(rtp_timestamp, audio, &encoded);
+    rtp_timestamp += kSamplesPer10Ms;
+    if (encoded.size() > 0)
+      packets.push_back(std::move(encoded));
+  }
+  return packets;
+}
+
+// Decodes the first |num_packets| packets of |packets| and returns the audio.
+// The packet in the middle is treated as lost and recovered from the FEC data
+// of the next one.
+std::vector<int16_t> DecodePackets(AudioDecoder* decoder,
+                                   const std::vector<rtc::Buffer>& packets,
+                                   size_t num_packets) {
+  constexpr size_t kMaxFrameSamples = 2 * 48 * 120;
+  std::vector<int16_t> audio;
+  std::vector<int16_t> decoded(kMaxFrameSamples);
+  AudioDecoder::SpeechType speech_type;
+  for (size_t i = 0; i < num_packets; ++i) {
+    int num_samples;
+    if (i == num_packets / 2 && i + 1 < num_packets) {
+      num_samples = decoder->DecodeRedundant(
+          packets[i + 1].data(), packets[i + 1].size(), 48000,
+          decoded.size() * sizeof(int16_t), decoded.data(), &speech_type);
+    } else {
+      num_samples = decoder->Decode(
+          packets[i].data(), packets[i].size(), 48000,
+          decoded.size() * sizeof(int16_t), decoded.data(), &speech_type);
+    }
+    EXPECT_GT(num_samples, 0);
+    audio.insert(audio.end(), decoded.begin(),
+                 decoded.begin() + std::max(num_samples, 0));
+  }
+  return audio;
+}
+
+}  // namespace
+
+TEST(OpusStatePoolTest, ReusesReturnedStates) {
+  auto pool = OpusStatePool::Create(/*max_idle_states=*/4);
+  OpusEncInst* encoder = pool->TakeEncoder(1, 0);
+  OpusDecInst* decoder = pool->TakeDecoder(2);
+  ASSERT_TRUE(encoder);
+  ASSERT_TRUE(decoder);
+  pool->ReturnEncoder(encoder);
+  pool->ReturnDecoder(decoder);
+  EXPECT_EQ(1u, pool->GetStats().idle_encoders);
+  EXPECT_EQ(1u, pool->GetStats().idle_decoders);
+
+  // States are only reused for the same number of channels.
+  OpusEncInst* stereo_encoder = pool->TakeEncoder(2, 0);
+  EXPECT_NE(encoder, stereo_encoder);
+  EXPECT_EQ(encoder, pool->TakeEncoder(1, 1));
+  EXPECT_EQ(decoder, pool->TakeDecoder(2));
+  EXPECT_EQ(2u, WebRtcOpus_EncoderChannels(stereo_encoder));
+
+  const OpusStatePool::Stats stats = pool->GetStats();
+  EXPECT_EQ(2u, stats.encoders_created);
+  EXPECT_EQ(1u, stats.encoders_reused);
+  EXPECT_EQ(1u, stats.decoders_created);
+  EXPECT_EQ(1u, stats.decoders_reused);
+  EXPECT_EQ(0u, stats.idle_encoders);
+  EXPECT_EQ(0u, stats.idle_decoders);
+
+  pool->ReturnEncoder(encoder);
+  pool->ReturnEncoder(stereo_encoder);
+  pool->ReturnDecoder(decoder);
+}
+
+TEST(OpusStatePoolTest, FreesStatesWhenFull) {
+  auto pool = OpusStatePool::Create(/*max_idle_states=*/1);
+  OpusEncInst* encoder_1 = pool->TakeEncoder(1, 0);
+  OpusEncInst* encoder_2 = pool->TakeEncoder(1, 0);
+  pool->ReturnEncoder(encoder_1);
+  pool->ReturnEncoder(encoder_2);
+  EXPECT_EQ(1u, pool->GetStats().idle_encoders);
+
+  auto empty_pool = OpusStatePool::Create(/*max_idle_states=*/0);
+  empty_pool->ReturnDecoder(empty_pool->TakeDecoder(1));
+  empty_pool->ReturnDecoder(empty_pool->TakeDecoder(1));
+  EXPECT_EQ(0u, empty_pool->GetStats().idle_decoders);
+  EXPECT_EQ(2u, empty_pool->GetStats().decoders_created);
+}
+
+// Checks that an encoder reusing the state of another one produces the same
+// packets as a newly allocated encoder.
+TEST(OpusStatePoolTest, PooledEncoderMatchesNewEncoder) {
+  for (size_t num_channels : {1, 2}) {
+    SCOPED_TRACE(num_channels);
+    const AudioEncoderOpusConfig config = CreateConfig(num_channels);
+    auto pool = OpusStatePool::Create(/*max_idle_states=*/1);
+    {
+      // Leaves a used state, with different settings, in the pool.
+      AudioEncoderOpusConfig other_config = config;
+      other_config.application = AudioEncoderOpusConfig::ApplicationMode::kVoip;
+      other_config.dtx_enabled = true;
+      other_config.bitrate_bps = 12000;
+      AudioEncoderOpusImpl used_encoder(other_config, kPayloadType, pool);
+      EncodeNoise(&used_encoder);
+    }
+    AudioEncoderOpusImpl pooled_encoder(config, kPayloadType, pool);
+    EXPECT_EQ(1u, pool->GetStats().encoders_reused);
+    AudioEncoderOpusImpl new_encoder(config, kPayloadType);
+    EXPECT_EQ(EncodeNoise(&new_encoder), EncodeNoise(&pooled_encoder));
+  }
+}
+
+// Checks that resetting a pooled encoder in place, which also happens when it
+// is reconfigured, leads to the same packets as a new encoder.
+TEST(OpusStatePoolTest, ResetEncoderMatchesNewEncoder) {
+  const AudioEncoderOpusConfig config = CreateConfig(2);
+  AudioEncoderOpusImpl encoder(config, kPayloadType,
+                               OpusStatePool::Create(/*max_idle_states=*/1));
+  EncodeNoise(&encoder);
+  encoder.Reset();
+  AudioEncoderOpusImpl new_encoder(config, kPayloadType);
+  EXPECT_EQ(EncodeNoise(&new_encoder), EncodeNoise(&encoder));
+}
+
+// Checks that a decoder reusing the state of another one produces the same
+// audio as a newly allocated decoder.
+TEST(OpusStatePoolTest, PooledDecoderMatchesNewDecoder) {
+  for (size_t num_channels : {1, 2}) {
+    SCOPED_TRACE(num_channels);
+    AudioEncoderOpusImpl encoder(CreateConfig(num_channels), kPayloadType);
+    const std::vector<rtc::Buffer> packets = EncodeNoise(&encoder);
+    auto pool = OpusStatePool::Create(/*max_idle_states=*/1);
+    {
+      AudioDecoderOpusImpl used_decoder(num_channels, pool);
+      DecodePackets(&used_decoder, packets, 7);
+    }
+    AudioDecoderOpusImpl pooled_decoder(num_channels, pool);
+    EXPECT_EQ(1u, pool->GetStats().decoders_reused);
+    AudioDecoderOpusImpl new_decoder(num_channels);
+    EXPECT_EQ(DecodePackets(&new_decoder, packets, packets.size()),
+              DecodePackets(&pooled_decoder, packets, packets.size()));
+  }
+}
+
+}  // namespace webrtc
@@ -15,6 +15,7 @@
 #include <list>
 #include <memory>
 
+#include "absl/types/optional.h"
 #include "api/audio_codecs/audio_decoder.h"
 #include "modules/audio_coding/neteq/tick_timer.h"
 #include "rtc_base/buffer.h"
@@ -72,7 +73,9 @@ struct Packet {
   // Datagram excluding RTP header and header extension.
   rtc::Buffer payload;
   Priority priority;
-  std::unique_ptr<TickTimer::Stopwatch> waiting_time;
+  // Set when the packet is inserted into the packet buffer. Held by value so
+  // that inserting a packet does not allocate.
+  absl::optional<TickTimer::Stopwatch> waiting_time;
   std::unique_ptr<AudioDecoder::EncodedAudioFrame> frame;
 
   Packet();
@@ -11,10 +11,13 @@
 #ifndef MODULES_AUDIO_CODING_NETEQ_PACKET_BUFFER_H_
 #define MODULES_AUDIO_CODING_NETEQ_PACKET_BUFFER_H_
 
+#include <vector>
+
 #include "absl/types/optional.h"
 #include "modules/audio_coding/neteq/decoder_database.h"
 #include "modules/audio_coding/neteq/packet.h"
 #include "modules/include/module_common_types_public.h"  // IsNewerTimestamp
+#include "rtc_base/checks.h"
 #include "rtc_base/constructormagic.h"
 
 namespace webrtc {
@@ -23,7 +26,9 @@ class DecoderDatabase;
 class StatisticsCalculator;
 class TickTimer;
 
-// This is the actual buffer holding the packets before decoding.
+// This is the actual buffer holding the packets before decoding. The packets
+// are kept sorted in a ring of slots which is allocated once, so that storing
+// a packet allocates nothing.
 class PacketBuffer {
  public:
   enum BufferReturnCodes {
@@ -140,8 +145,29 @@ class PacketBuffer {
   }
 
  private:
+  // Returns the |index|th packet in the buffer, the first one being the next
+  // to decode.
+  Packet& PacketAt(size_t index) {
+    RTC_DCHECK_LT(index, slots_.size());
+    const size_t slot = first_slot_ + index;
+    return slots_[slot < slots_.size() ? slot : slot - slots_.size()];
+  }
+  const Packet& PacketAt(size_t index) const {
+    return const_cast<PacketBuffer*>(this)->PacketAt(index);
+  }
+
+  // Removes the first packet, releasing its contents.
+  void PopFront();
+
+  // Removes the packets for which |pred| returns true, keeping the order of
+  // the others.
+  template <typename Predicate>
+  void RemoveIf(Predicate pred);
+
   size_t max_number_of_packets_;
-  PacketList buffer_;
+  std::vector<Packet> slots_;
+  size_t first_slot_ = 0;
+  size_t num_packets_ = 0;
   const TickTimer* tick_timer_;
   RTC_DISALLOW_COPY_AND_ASSIGN(PacketBuffer);
 };
@@ -0,0 +1,196 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdlib.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "modules/audio_coding/neteq/packet.h"
+#include "modules/audio_coding/neteq/packet_buffer.h"
+#include "modules/audio_coding/neteq/statistics_calculator.h"
+#include "modules/audio_coding/neteq/tick_timer.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/cpu_time.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+// Counts the allocations made while |g_count_allocations| is set. This
+// replaces the global allocation functions, which is why this file is built
+// into an executable of its own. The tests run on one thread.
+namespace {
+bool g_count_allocations = false;
+int g_num_allocations = 0;
+}  // namespace
+
+void* operator new(size_t size) {
+  if (g_count_allocations) {
+    ++g_num_allocations;
+  }
+  void* p = malloc(size > 0 ? size : 1);
+  RTC_CHECK(p);
+  return p;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  free(p);
+}
+
+namespace webrtc {
+namespace {
+
+// Opus at 48 kHz in 20 ms packets of about 32 kbps, with NetEq's default
+// buffer size.
+constexpr size_t kNumStreams = 10000;
+constexpr int kNumPackets = 500;
+constexpr uint32_t kFrameSizeSamples = 960;
+constexpr size_t kPayloadSize = 80;
+constexpr size_t kMaxPacketsInBuffer = 50;
+constexpr size_t kStartDepthPackets = 3;
+// One packet in ten arrives after the next one.
+constexpr int kReorderPeriod = 10;
+
+// The receive side of one stream. The payloads of the extracted packets are
+// reused for the inserted ones, so that only the buffer allocates.
+class Stream {
+ public:
+  Stream(int offset, const TickTimer* tick_timer)
+      : offset_(offset),
+        packet_buffer_(kMaxPacketsInBuffer, tick_timer),
+        timestamp_(0) {}
+
+  void InsertPacket(int index, StatisticsCalculator* stats) {
+    Packet packet;
+    packet.sequence_number = static_cast<uint16_t>(index);
+    packet.timestamp = index * kFrameSizeSamples;
+    packet.payload_type = 111;
+    if (!spare_payloads_.empty()) {
+      packet.payload = std::move(spare_payloads_.back());
+      spare_payloads_.pop_back();
+    }
+    packet.payload.SetSize(kPayloadSize);
+    if ((index + offset_) % kReorderPeriod == 0) {
+      held_back_ = std::move(packet);
+      return;
+    }
+    packet_buffer_.InsertPacket(std::move(packet), stats);
+    if (held_back_) {
+      packet_buffer_.InsertPacket(std::move(*held_back_), stats);
+      held_back_ = absl::nullopt;
+    }
+  }
+
+  // Does what NetEq does on each call of GetAudio(), and decodes one packet
+  // if |decode| is true.
+  size_t GetAudio(bool decode, StatisticsCalculator* stats) {
+    packet_buffer_.DiscardOldPackets(timestamp_, 5 * 48000, stats);
+    size_t num_samples = packet_buffer_.NumSamplesInBuffer(kFrameSizeSamples);
+    if (decode && packet_buffer_.PeekNextPacket()) {
+      absl::optional<Packet> packet = packet_buffer_.GetNextPacket();
+      timestamp_ = packet->timestamp;
+      spare_payloads_.push_back(std::move(packet->payload));
+    }
+    return num_samples;
+  }
+
+ private:
+  const int offset_;
+  PacketBuffer packet_buffer_;
+  uint32_t timestamp_;
+  std::vector<rtc::Buffer> spare_payloads_;
+  absl::optional<Packet> held_back_;
+};
+
+// Returns the number of allocations made while running |function|.
+template <typename Function>
+int CountAllocations(Function function) {
+  g_num_allocations = 0;
+  g_count_allocations = true;
+  function();
+  g_count_allocations = false;
+  return g_num_allocations;
+}
+
+}  // namespace
+
+// Checks that once the payloads are recycled, inserting, querying and
+// extracting packets allocates nothing in the PacketBuffer, also when packets
+// are reordered. This only covers the PacketBuffer: NetEq itself still
+// allocates a payload and a parsed frame for every packet.
+TEST(PacketBufferPerformanceTest, NoAllocationsInPacketBuffer) {
+  TickTimer tick_timer;
+  StatisticsCalculator stats;
+  Stream stream(0, &tick_timer);
+  int index = 0;
+  auto run = [&](int num_packets) {
+    for (int i = 0; i < num_packets; ++i, ++index) {
+      tick_timer.Increment();
+      stream.InsertPacket(index, &stats);
+      stream.GetAudio(false, &stats);
+      tick_timer.Increment();
+      stream.GetAudio(index >= static_cast<int>(kStartDepthPackets), &stats);
+    }
+  };
+  // Let the stream fill up its spare payloads.
+  run(2 * kReorderPeriod);
+  EXPECT_EQ(0, CountAllocations([&] { run(kNumPackets); }));
+}
+
+// Runs many streams through their packet buffers as a server that terminates
+// them does, and reports the PacketBuffer CPU time per packet for the
+// insertion, the extraction and the queries that NetEq makes every 10 ms.
+// Decoding and the rest of NetEq are not included.
+TEST(PacketBufferPerformanceTest, ManyStreams) {
+  TickTimer tick_timer;
+  StatisticsCalculator stats;
+  std::vector<std::unique_ptr<Stream>> streams;
+  for (size_t i = 0; i < kNumStreams; ++i) {
+    streams.emplace_back(new Stream(i, &tick_timer));
+    for (size_t j = 0; j < kStartDepthPackets; ++j) {
+      streams.back()->InsertPacket(j, &stats);
+    }
+  }
+
+  size_t num_samples = 0;
+  const int64_t start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+  for (int i = kStartDepthPackets; i < kNumPackets; ++i) {
+    // Two 10 ms output blocks for every 20 ms packet.
+    for (int block = 0; block < 2; ++block) {
+      tick_timer.Increment();
+      for (auto& stream : streams) {
+        if (block == 0) {
+          stream->InsertPacket(i, &stats);
+        }
+        num_samples += stream->GetAudio(block == 1, &stats);
+      }
+    }
+  }
+  const int64_t elapsed_cpu_ns = rtc::GetThreadCpuTimeNanos() - start_cpu_ns;
+
+  EXPECT_GT(num_samples, 0u);
+  test::PrintResult(
+      "neteq_packet_buffer_cpu_time_per_packet", "", "10000_streams",
+      static_cast<double>(elapsed_cpu_ns) /
+          (kNumStreams * (kNumPackets - kStartDepthPackets)),
+      "ns", true);
+}
+
+}  // namespace webrtc
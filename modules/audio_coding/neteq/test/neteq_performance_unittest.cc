@@ -47,3 +47,25 @@ TEST(NetEqPerformanceTest, RunClean) {
   webrtc::test::PrintResult("neteq_performance", "", "0_pl_0_drift", runtime,
                             "ms", true);
 }
+
+// Runs many streams with 10% packet losses and 10% clock drift, and reports
+// the decoding and jitter buffer CPU time per stream, for every 10 ms of
+// audio.
+TEST(NetEqPerformanceTest, RunStreams) {
+  const int kSimulationTimeMs = 100000;
+  const int kQuickSimulationTimeMs = 1000;
+  const size_t kNumStreams = 100;
+  const int kLossPeriod = 10;  // Drop every 10th packet.
+  const double kDriftFactor = 0.1;
+  const int simulation_time_ms =
+      webrtc::field_trial::IsEnabled("WebRTC-QuickPerfTest")
+          ? kQuickSimulationTimeMs
+          : kSimulationTimeMs;
+  int64_t cpu_time_ns = webrtc::test::NetEqPerformanceTest::RunStreams(
+      kNumStreams, simulation_time_ms, kLossPeriod, kDriftFactor);
+  ASSERT_GT(cpu_time_ns, 0);
+  const double kNumBlocks = simulation_time_ms / 10;
+  webrtc::test::PrintResult(
+      "neteq_performance", "", "10_pl_10_drift_cpu_per_stream",
+      cpu_time_ns / 1000.0 / kNumStreams / kNumBlocks, "us/10ms", false);
+}
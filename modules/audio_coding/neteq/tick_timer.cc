@@ -13,7 +13,7 @@
 namespace webrtc {
 
 TickTimer::Stopwatch::Stopwatch(const TickTimer& ticktimer)
-    : ticktimer_(ticktimer), starttick_(ticktimer.ticks()) {}
+    : ticktimer_(&ticktimer), starttick_(ticktimer.ticks()) {}
 
 TickTimer::Countdown::Countdown(const TickTimer& ticktimer,
                                 uint64_t ticks_to_count)
@@ -31,23 +31,24 @@ class TickTimer {
   // new Stopwatch object from a TickTimer object with the GetNewStopwatch()
   // method. Note: since the Stopwatch object contains a reference to the
   // TickTimer it is associated with, it cannot outlive the TickTimer.
+  // Stopwatch objects can be copied, so that they can also be held by value.
   class Stopwatch {
    public:
     explicit Stopwatch(const TickTimer& ticktimer);
 
-    uint64_t ElapsedTicks() const { return ticktimer_.ticks() - starttick_; }
+    uint64_t ElapsedTicks() const { return ticktimer_->ticks() - starttick_; }
 
     uint64_t ElapsedMs() const {
-      const uint64_t elapsed_ticks = ticktimer_.ticks() - starttick_;
-      const int ms_per_tick = ticktimer_.ms_per_tick();
+      const uint64_t elapsed_ticks = ticktimer_->ticks() - starttick_;
+      const int ms_per_tick = ticktimer_->ms_per_tick();
       return elapsed_ticks < UINT64_MAX / ms_per_tick
                  ? elapsed_ticks * ms_per_tick
                  : UINT64_MAX;
     }
 
    private:
-    const TickTimer& ticktimer_;
-    const uint64_t starttick_;
+    const TickTimer* ticktimer_;
+    uint64_t starttick_;
   };
 
   // Countdown counts down from a given start value with each tick of the
@@ -10,6 +10,9 @@
 
 #include "modules/audio_coding/neteq/tools/neteq_performance_test.h"
 
+#include <memory>
+#include <vector>
+
 #include "api/audio/audio_frame.h"
 #include "api/audio_codecs/builtin_audio_decoder_factory.h"
 #include "common_types.h"  // NOLINT(build/include)
@@ -18,6 +21,7 @@
 #include "modules/audio_coding/neteq/tools/audio_loop.h"
 #include "modules/audio_coding/neteq/tools/rtp_generator.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/cpu_time.h"
 #include "system_wrappers/include/clock.h"
 #include "test/testsupport/fileutils.h"
 
@@ -27,104 +31,166 @@ using webrtc::test::RtpGenerator;
 
 namespace webrtc {
 namespace test {
+namespace {
 
-int64_t NetEqPerformanceTest::Run(int runtime_ms,
-                                  int lossrate,
-                                  double drift_factor) {
-  const std::string kInputFileName =
-      webrtc::test::ResourcePath("audio_coding/testfile32kHz", "pcm");
-  const int kSampRateHz = 32000;
-  const webrtc::NetEqDecoder kDecoderType =
-      webrtc::NetEqDecoder::kDecoderPCM16Bswb32kHz;
-  const std::string kDecoderName = "pcm16-swb32";
-  const int kPayloadType = 95;
-
-  // Initialize NetEq instance.
-  NetEq::Config config;
-  config.sample_rate_hz = kSampRateHz;
-  NetEq* neteq = NetEq::Create(config, CreateBuiltinAudioDecoderFactory());
-  // Register decoder in |neteq|.
-  if (neteq->RegisterPayloadType(kDecoderType, kDecoderName, kPayloadType) != 0)
-    return -1;
+const int kSampRateHz = 32000;
+const int kPayloadType = 95;
+const size_t kInputBlockSizeSamples = 60 * kSampRateHz / 1000;  // 60 ms.
+const int kOutputBlockSizeMs = 10;
+const size_t kMaxLoopLengthSamples = kSampRateHz * 10;  // 10 second loop.
 
-  // Set up AudioLoop object.
-  AudioLoop audio_loop;
-  const size_t kMaxLoopLengthSamples = kSampRateHz * 10;  // 10 second loop.
-  const size_t kInputBlockSizeSamples = 60 * kSampRateHz / 1000;  // 60 ms.
-  if (!audio_loop.Init(kInputFileName, kMaxLoopLengthSamples,
-                       kInputBlockSizeSamples))
-    return -1;
+// One NetEq instance, fed with packets of PCM16b encoded audio from a loop of
+// the input file.
+class Stream {
+ public:
+  Stream(int lossrate, double drift_factor)
+      : lossrate_(lossrate),
+        drift_factor_(drift_factor),
+        rtp_gen_(kSampRateHz / 1000) {}
 
-  int32_t time_now_ms = 0;
-
-  // Get first input packet.
-  RTPHeader rtp_header;
-  RtpGenerator rtp_gen(kSampRateHz / 1000);
-  // Start with positive drift first half of simulation.
-  rtp_gen.set_drift_factor(drift_factor);
-  bool drift_flipped = false;
-  int32_t packet_input_time_ms =
-      rtp_gen.GetRtpHeader(kPayloadType, kInputBlockSizeSamples, &rtp_header);
-  auto input_samples = audio_loop.GetNextBlock();
-  if (input_samples.empty())
-    exit(1);
-  uint8_t input_payload[kInputBlockSizeSamples * sizeof(int16_t)];
-  size_t payload_len = WebRtcPcm16b_Encode(input_samples.data(),
-                                           input_samples.size(), input_payload);
-  RTC_CHECK_EQ(sizeof(input_payload), payload_len);
+  // Skips |num_skipped_blocks| blocks of the input. Returns false on error.
+  bool Init(size_t num_skipped_blocks) {
+    const std::string kInputFileName =
+        webrtc::test::ResourcePath("audio_coding/testfile32kHz", "pcm");
+    const webrtc::NetEqDecoder kDecoderType =
+        webrtc::NetEqDecoder::kDecoderPCM16Bswb32kHz;
+    const std::string kDecoderName = "pcm16-swb32";
 
-  // Main loop.
-  webrtc::Clock* clock = webrtc::Clock::GetRealTimeClock();
-  int64_t start_time_ms = clock->TimeInMilliseconds();
-  AudioFrame out_frame;
-  while (time_now_ms < runtime_ms) {
-    while (packet_input_time_ms <= time_now_ms) {
+    // Initialize NetEq instance.
+    NetEq::Config config;
+    config.sample_rate_hz = kSampRateHz;
+    neteq_.reset(NetEq::Create(config, CreateBuiltinAudioDecoderFactory()));
+    // Register decoder in |neteq_|.
+    if (neteq_->RegisterPayloadType(kDecoderType, kDecoderName,
+                                    kPayloadType) != 0)
+      return false;
+
+    // Set up AudioLoop object.
+    if (!audio_loop_.Init(kInputFileName, kMaxLoopLengthSamples,
+                          kInputBlockSizeSamples))
+      return false;
+    for (size_t i = 0; i < num_skipped_blocks; ++i) {
+      audio_loop_.GetNextBlock();
+    }
+
+    // Get first input packet.
+    // Start with positive drift first half of simulation.
+    rtp_gen_.set_drift_factor(drift_factor_);
+    packet_input_time_ms_ = rtp_gen_.GetRtpHeader(
+        kPayloadType, kInputBlockSizeSamples, &rtp_header_);
+    return EncodeNextBlock();
+  }
+
+  // Inserts the packets due at |time_now_ms| and gets one block of output
+  // audio. Returns false on error.
+  bool Process(int32_t time_now_ms, int runtime_ms) {
+    while (packet_input_time_ms_ <= time_now_ms) {
       // Drop every N packets, where N = FLAG_lossrate.
       bool lost = false;
-      if (lossrate > 0) {
-        lost = ((rtp_header.sequenceNumber - 1) % lossrate) == 0;
+      if (lossrate_ > 0) {
+        lost = ((rtp_header_.sequenceNumber - 1) % lossrate_) == 0;
       }
       if (!lost) {
         // Insert packet.
         int error =
-            neteq->InsertPacket(rtp_header, input_payload,
-                                packet_input_time_ms * kSampRateHz / 1000);
+            neteq_->InsertPacket(rtp_header_, input_payload_,
+                                 packet_input_time_ms_ * kSampRateHz / 1000);
         if (error != NetEq::kOK)
-          return -1;
+          return false;
       }
 
       // Get next packet.
-      packet_input_time_ms = rtp_gen.GetRtpHeader(
-          kPayloadType, kInputBlockSizeSamples, &rtp_header);
-      input_samples = audio_loop.GetNextBlock();
-      if (input_samples.empty())
-        return -1;
-      payload_len = WebRtcPcm16b_Encode(input_samples.data(),
-                                        input_samples.size(), input_payload);
-      RTC_DCHECK_EQ(payload_len, kInputBlockSizeSamples * sizeof(int16_t));
+      packet_input_time_ms_ = rtp_gen_.GetRtpHeader(
+          kPayloadType, kInputBlockSizeSamples, &rtp_header_);
+      if (!EncodeNextBlock())
+        return false;
     }
 
     // Get output audio, but don't do anything with it.
     bool muted;
-    int error = neteq->GetAudio(&out_frame, &muted);
+    int error = neteq_->GetAudio(&out_frame_, &muted);
     RTC_CHECK(!muted);
     if (error != NetEq::kOK)
-      return -1;
+      return false;
 
-    RTC_DCHECK_EQ(out_frame.samples_per_channel_, (kSampRateHz * 10) / 1000);
+    RTC_DCHECK_EQ(out_frame_.samples_per_channel_, (kSampRateHz * 10) / 1000);
 
-    static const int kOutputBlockSizeMs = 10;
-    time_now_ms += kOutputBlockSizeMs;
-    if (time_now_ms >= runtime_ms / 2 && !drift_flipped) {
+    if (time_now_ms + kOutputBlockSizeMs >= runtime_ms / 2 &&
+        !drift_flipped_) {
       // Apply negative drift second half of simulation.
-      rtp_gen.set_drift_factor(-drift_factor);
-      drift_flipped = true;
+      rtp_gen_.set_drift_factor(-drift_factor_);
+      drift_flipped_ = true;
     }
+    return true;
+  }
+
+ private:
+  bool EncodeNextBlock() {
+    auto input_samples = audio_loop_.GetNextBlock();
+    if (input_samples.empty())
+      return false;
+    size_t payload_len = WebRtcPcm16b_Encode(
+        input_samples.data(), input_samples.size(), input_payload_);
+    RTC_CHECK_EQ(sizeof(input_payload_), payload_len);
+    return true;
+  }
+
+  const int lossrate_;
+  const double drift_factor_;
+  std::unique_ptr<NetEq> neteq_;
+  AudioLoop audio_loop_;
+  RtpGenerator rtp_gen_;
+  RTPHeader rtp_header_;
+  int32_t packet_input_time_ms_ = 0;
+  bool drift_flipped_ = false;
+  uint8_t input_payload_[kInputBlockSizeSamples * sizeof(int16_t)];
+  AudioFrame out_frame_;
+};
+
+}  // namespace
+
+int64_t NetEqPerformanceTest::Run(int runtime_ms,
+                                  int lossrate,
+                                  double drift_factor) {
+  Stream stream(lossrate, drift_factor);
+  if (!stream.Init(0))
+    return -1;
+
+  // Main loop.
+  webrtc::Clock* clock = webrtc::Clock::GetRealTimeClock();
+  int64_t start_time_ms = clock->TimeInMilliseconds();
+  for (int32_t time_now_ms = 0; time_now_ms < runtime_ms;
+       time_now_ms += kOutputBlockSizeMs) {
+    if (!stream.Process(time_now_ms, runtime_ms))
+      return -1;
   }
   int64_t end_time_ms = clock->TimeInMilliseconds();
-  delete neteq;
   return end_time_ms - start_time_ms;
 }
 
+int64_t NetEqPerformanceTest::RunStreams(size_t num_streams,
+                                         int runtime_ms,
+                                         int lossrate,
+                                         double drift_factor) {
+  std::vector<std::unique_ptr<Stream>> streams;
+  for (size_t i = 0; i < num_streams; ++i) {
+    streams.emplace_back(new Stream(lossrate, drift_factor));
+    // Start the streams at different positions of the input loop.
+    const size_t kNumBlocks = kMaxLoopLengthSamples / kInputBlockSizeSamples;
+    if (!streams.back()->Init((i * 7) % kNumBlocks))
+      return -1;
+  }
+
+  int64_t start_time_ns = rtc::GetProcessCpuTimeNanos();
+  for (int32_t time_now_ms = 0; time_now_ms < runtime_ms;
+       time_now_ms += kOutputBlockSizeMs) {
+    for (auto& stream : streams) {
+      if (!stream->Process(time_now_ms, runtime_ms))
+        return -1;
+    }
+  }
+  return rtc::GetProcessCpuTimeNanos() - start_time_ns;
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -11,6 +11,7 @@
 #ifndef MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_PERFORMANCE_TEST_H_
 #define MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_PERFORMANCE_TEST_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 namespace webrtc {
@@ -24,6 +25,15 @@ class NetEqPerformanceTest {
   //   |drift_factor|: clock drift in [0, 1].
   // Returns the runtime in ms.
   static int64_t Run(int runtime_ms, int lossrate, double drift_factor);
+
+  // Runs |num_streams| NetEq instances side by side, as a server that
+  // terminates many audio streams does, with the same parameters as above for
+  // each stream. The streams start at different positions of the input.
+  // Returns the CPU time of the process in ns, or -1 on error.
+  static int64_t RunStreams(size_t num_streams,
+                            int runtime_ms,
+                            int lossrate,
+                            double drift_factor);
 };
 
 }  // namespace test
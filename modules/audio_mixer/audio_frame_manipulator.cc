@@ -9,6 +9,14 @@
  */
 
 #include "modules/audio_mixer/audio_frame_manipulator.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "audio/utility/audio_frame_operations.h"
 #include "rtc_base/checks.h"
 
@@ -19,11 +27,38 @@ uint32_t AudioMixerCalculateEnergy(const AudioFrame& audio_frame) {
     return 0;
   }
 
+  // The vector variants wrap around in the same way as the scalar loop, since
+  // all sums are done modulo 2^32.
   uint32_t energy = 0;
   const int16_t* frame_data = audio_frame.data();
-  for (size_t position = 0;
-       position < audio_frame.samples_per_channel_ * audio_frame.num_channels_;
-       position++) {
+  const size_t num_samples =
+      audio_frame.samples_per_channel_ * audio_frame.num_channels_;
+  size_t position = 0;
+#if defined(__SSE2__)
+  __m128i energy_128 = _mm_setzero_si128();
+  for (; position + 8 <= num_samples; position += 8) {
+    const __m128i x = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(&frame_data[position]));
+    energy_128 = _mm_add_epi32(energy_128, _mm_madd_epi16(x, x));
+  }
+  energy_128 = _mm_add_epi32(energy_128, _mm_srli_si128(energy_128, 8));
+  energy_128 = _mm_add_epi32(energy_128, _mm_srli_si128(energy_128, 4));
+  energy = static_cast<uint32_t>(_mm_cvtsi128_si32(energy_128));
+#elif defined(WEBRTC_HAS_NEON)
+  uint32x4_t energy_128 = vdupq_n_u32(0);
+  for (; position + 8 <= num_samples; position += 8) {
+    const int16x8_t x = vld1q_s16(&frame_data[position]);
+    const int16x4_t x_low = vget_low_s16(x);
+    const int16x4_t x_high = vget_high_s16(x);
+    energy_128 = vaddq_u32(
+        energy_128, vreinterpretq_u32_s32(vmull_s16(x_low, x_low)));
+    energy_128 = vaddq_u32(
+        energy_128, vreinterpretq_u32_s32(vmull_s16(x_high, x_high)));
+  }
+  energy = vgetq_lane_u32(energy_128, 0) + vgetq_lane_u32(energy_128, 1) +
+           vgetq_lane_u32(energy_128, 2) + vgetq_lane_u32(energy_128, 3);
+#endif
+  for (; position < num_samples; position++) {
     // TODO(aleloi): This can overflow. Convert to floats.
     energy += frame_data[position] * frame_data[position];
   }
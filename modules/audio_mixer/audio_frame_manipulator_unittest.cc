@@ -11,6 +11,7 @@
 #include <algorithm>
 
 #include "modules/audio_mixer/audio_frame_manipulator.h"
+#include "rtc_base/random.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -62,4 +63,24 @@ TEST(AudioFrameManipulator, CompareBackwardRampWithExpectedResultMono) {
       std::equal(frame_data, frame_data + total_samples, expected_result));
 }
 
+// Checks that the energy matches a plain sum of squares, including the wrap
+// around of the sum, for lengths that are not a multiple of the vector size.
+TEST(AudioFrameManipulator, EnergyMatchesSumOfSquares) {
+  Random random_generator(42U);
+  for (size_t samples_per_channel : {1, 7, 80, 441, 480}) {
+    for (size_t number_of_channels : {1, 2}) {
+      AudioFrame frame;
+      frame.num_channels_ = number_of_channels;
+      frame.samples_per_channel_ = samples_per_channel;
+      int16_t* frame_data = frame.mutable_data();
+      uint32_t expected_energy = 0;
+      for (size_t k = 0; k < samples_per_channel * number_of_channels; ++k) {
+        frame_data[k] = random_generator.Rand(-32768, 32767);
+        expected_energy += frame_data[k] * frame_data[k];
+      }
+      EXPECT_EQ(expected_energy, AudioMixerCalculateEnergy(frame));
+    }
+  }
+}
+
 }  // namespace webrtc
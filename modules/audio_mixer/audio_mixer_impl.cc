@@ -133,6 +133,47 @@ void AudioMixerImpl::Mix(size_t number_of_channels,
   return;
 }
 
+void AudioMixerImpl::MixExcludingSources(
+    size_t number_of_channels,
+    rtc::ArrayView<Source* const> sources,
+    rtc::ArrayView<AudioFrame* const> audio_frames_for_mixing) {
+  RTC_DCHECK(number_of_channels == 1 || number_of_channels == 2);
+  RTC_DCHECK_EQ(sources.size(), audio_frames_for_mixing.size());
+  RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
+
+  CalculateOutputFrequency();
+
+  rtc::CritScope lock(&crit_);
+  const AudioFrameList mix_list = GetAudioFromSources();
+
+  source_status_map_.clear();
+  for (auto& source_status : audio_source_list_) {
+    source_status_map_[source_status->audio_source] = source_status.get();
+  }
+  excluded_frames_.clear();
+  limiters_.clear();
+  for (Source* source : sources) {
+    const auto it = source_status_map_.find(source);
+    RTC_CHECK(it != source_status_map_.end()) << "Source not present in mixer";
+    SourceStatus* const source_status = it->second;
+    // The mixed frames are those of the selected sources.
+    const auto frame = std::find(mix_list.begin(), mix_list.end(),
+                                 &source_status->audio_frame);
+    excluded_frames_.push_back(frame == mix_list.end()
+                                   ? FrameCombiner::kNoExcludedFrame
+                                   : frame - mix_list.begin());
+    if (!source_status->limiter) {
+      source_status->limiter = frame_combiner_.CreateLimiter();
+    }
+    limiters_.push_back(source_status->limiter.get());
+  }
+
+  frame_combiner_.CombineExcluding(mix_list, excluded_frames_,
+                                   number_of_channels, OutputFrequency(),
+                                   audio_source_list_.size(),
+                                   audio_frames_for_mixing, limiters_);
+}
+
 void AudioMixerImpl::CalculateOutputFrequency() {
   RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
   rtc::CritScope lock(&crit_);
@@ -177,6 +218,7 @@ AudioFrameList AudioMixerImpl::GetAudioFromSources() {
   AudioFrameList result;
   std::vector<SourceFrame> audio_source_mixing_data_list;
   std::vector<SourceFrame> ramp_list;
+  audio_source_mixing_data_list.reserve(audio_source_list_.size());
 
   // Get audio from the audio sources and put it in the SourceFrame vector.
   for (auto& source_and_status : audio_source_list_) {
@@ -193,29 +235,34 @@ AudioFrameList AudioMixerImpl::GetAudioFromSources() {
         audio_frame_info == Source::AudioFrameInfo::kMuted);
   }
 
-  // Sort frames by sorting function.
-  std::sort(audio_source_mixing_data_list.begin(),
-            audio_source_mixing_data_list.end(), ShouldMixBefore);
-
-  int max_audio_frame_counter = kMaximumAmountOfMixedAudioSources;
-
-  // Go through list in order and put unmuted frames in result list.
-  for (const auto& p : audio_source_mixing_data_list) {
+  // Only the first kMaximumAmountOfMixedAudioSources frames in sorting order
+  // can be mixed, so there is no need to sort the whole list when there are
+  // many sources.
+  const auto selected_end =
+      audio_source_mixing_data_list.begin() +
+      std::min<size_t>(kMaximumAmountOfMixedAudioSources,
+                       audio_source_mixing_data_list.size());
+  std::partial_sort(audio_source_mixing_data_list.begin(), selected_end,
+                    audio_source_mixing_data_list.end(), ShouldMixBefore);
+
+  // Go through the selected frames in order and put unmuted frames in result
+  // list.
+  for (auto it = audio_source_mixing_data_list.begin(); it != selected_end;
+       ++it) {
     // Filter muted.
-    if (p.muted) {
-      p.source_status->is_mixed = false;
+    if (it->muted) {
+      it->source_status->is_mixed = false;
       continue;
     }
 
     // Add frame to result vector for mixing.
-    bool is_mixed = false;
-    if (max_audio_frame_counter > 0) {
-      --max_audio_frame_counter;
-      result.push_back(p.audio_frame);
-      ramp_list.emplace_back(p.source_status, p.audio_frame, false, -1);
-      is_mixed = true;
-    }
-    p.source_status->is_mixed = is_mixed;
+    result.push_back(it->audio_frame);
+    ramp_list.emplace_back(it->source_status, it->audio_frame, false, -1);
+    it->source_status->is_mixed = true;
+  }
+  for (auto it = selected_end; it != audio_source_mixing_data_list.end();
+       ++it) {
+    it->source_status->is_mixed = false;
   }
   RampAndUpdateGain(ramp_list);
   return result;
@@ -12,8 +12,10 @@
 #define MODULES_AUDIO_MIXER_AUDIO_MIXER_IMPL_H_
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
+#include "api/array_view.h"
 #include "api/audio/audio_mixer.h"
 #include "modules/audio_mixer/frame_combiner.h"
 #include "modules/audio_mixer/output_rate_calculator.h"
@@ -37,6 +39,10 @@ class AudioMixerImpl : public AudioMixer {
 
     // A frame that will be passed to audio_source->GetAudioFrameWithInfo.
     AudioFrame audio_frame;
+
+    // Limits the mix that leaves out this source. Created by the first call
+    // of MixExcludingSources() that asks for that mix.
+    std::unique_ptr<Limiter> limiter;
   };
 
   using SourceStatusList = std::vector<std::unique_ptr<SourceStatus>>;
@@ -61,6 +67,20 @@ class AudioMixerImpl : public AudioMixer {
            AudioFrame* audio_frame_for_mixing) override
       RTC_LOCKS_EXCLUDED(crit_);
 
+  // Produces the N-1 mixes of a conference, where no participant hears
+  // itself. Each source is asked for audio once and the sources are selected
+  // and summed once, as in Mix(). The mix of |sources[i]|, which must have
+  // been added to the mixer, is then obtained by subtracting its frame from
+  // the sum if it was selected, and is placed in |audio_frames_for_mixing[i]|.
+  // Each source keeps its own limiter, regardless of its index in |sources|.
+  // This makes the cost of the mixes linear in the number of participants,
+  // instead of quadratic with one mixer per participant.
+  void MixExcludingSources(
+      size_t number_of_channels,
+      rtc::ArrayView<Source* const> sources,
+      rtc::ArrayView<AudioFrame* const> audio_frames_for_mixing)
+      RTC_LOCKS_EXCLUDED(crit_);
+
   // Returns true if the source was mixed last round. Returns
   // false and logs an error if the source was never added to the
   // mixer.
@@ -105,6 +125,12 @@ class AudioMixerImpl : public AudioMixer {
   // Component that handles actual adding of audio frames.
   FrameCombiner frame_combiner_ RTC_GUARDED_BY(race_checker_);
 
+  // Scratch data of MixExcludingSources(), kept to avoid reallocations.
+  std::unordered_map<const Source*, SourceStatus*> source_status_map_
+      RTC_GUARDED_BY(race_checker_);
+  std::vector<size_t> excluded_frames_ RTC_GUARDED_BY(race_checker_);
+  std::vector<Limiter*> limiters_ RTC_GUARDED_BY(race_checker_);
+
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioMixerImpl);
 };
 }  // namespace webrtc
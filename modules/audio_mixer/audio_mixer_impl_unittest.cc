@@ -10,6 +10,7 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <string>
@@ -530,4 +531,98 @@ TEST(AudioMixer, AnyRateIsPossibleWithNoLimiter) {
     }
   }
 }
+
+TEST(AudioMixer, MixExcludingSourcesLeavesOutEachSource) {
+  constexpr int kAudioSources =
+      AudioMixerImpl::kMaximumAmountOfMixedAudioSources + 1;
+  const auto mixer = AudioMixerImpl::Create(
+      std::unique_ptr<OutputRateCalculator>(new DefaultOutputRateCalculator()),
+      false);
+
+  // Source i has constant samples of value 100 * (i + 1), so the first source
+  // is the only one that is not mixed.
+  MockMixerAudioSource participants[kAudioSources];
+  AudioMixer::Source* sources[kAudioSources];
+  AudioFrame audio_frames[kAudioSources];
+  AudioFrame* audio_frames_for_mixing[kAudioSources];
+  int16_t sum_of_mixed = 0;
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    const int16_t value = 100 * (i + 1);
+    int16_t* data = participants[i].fake_frame()->mutable_data();
+    std::fill(data, data + kDefaultSampleRateHz / 100, value);
+    if (i > 0) {
+      sum_of_mixed += value;
+    }
+    EXPECT_TRUE(mixer->AddSource(&participants[i]));
+    EXPECT_CALL(participants[i], GetAudioFrameWithInfo(_, _)).Times(Exactly(2));
+    sources[i] = &participants[i];
+    audio_frames_for_mixing[i] = &audio_frames[i];
+  }
+
+  // Two mix iterations to compare after the ramp-up step.
+  for (int i = 0; i < 2; ++i) {
+    mixer->MixExcludingSources(1, sources, audio_frames_for_mixing);
+  }
+
+  EXPECT_FALSE(mixer->GetAudioSourceMixabilityStatusForTest(&participants[0]));
+  for (int i = 0; i < kAudioSources; ++i) {
+    const int16_t expected =
+        i == 0 ? sum_of_mixed : sum_of_mixed - 100 * (i + 1);
+    EXPECT_EQ(expected, audio_frames[i].data()[80]) << "Source #" << i;
+    EXPECT_EQ(kDefaultSampleRateHz, audio_frames[i].sample_rate_hz_);
+  }
+}
+
+// Verifies that the limiter state of a mix follows its source when the order
+// of the sources changes between calls.
+TEST(AudioMixer, MixExcludingSourcesLimiterFollowsSource) {
+  constexpr int kAudioSources =
+      AudioMixerImpl::kMaximumAmountOfMixedAudioSources;
+  const auto mixer = AudioMixerImpl::Create();
+  const auto reference_mixer = AudioMixerImpl::Create();
+
+  MockMixerAudioSource participants[kAudioSources];
+  AudioMixer::Source* sources[kAudioSources];
+  AudioMixer::Source* reversed_sources[kAudioSources];
+  AudioFrame audio_frames[kAudioSources];
+  AudioFrame reference_audio_frames[kAudioSources];
+  AudioFrame* audio_frames_for_mixing[kAudioSources];
+  AudioFrame* reversed_audio_frames_for_mixing[kAudioSources];
+  AudioFrame* reference_audio_frames_for_mixing[kAudioSources];
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    EXPECT_TRUE(mixer->AddSource(&participants[i]));
+    EXPECT_TRUE(reference_mixer->AddSource(&participants[i]));
+    sources[i] = &participants[i];
+    reversed_sources[kAudioSources - 1 - i] = &participants[i];
+    audio_frames_for_mixing[i] = &audio_frames[i];
+    reversed_audio_frames_for_mixing[kAudioSources - 1 - i] = &audio_frames[i];
+    reference_audio_frames_for_mixing[i] = &reference_audio_frames[i];
+  }
+
+  for (int frame = 0; frame < 20; ++frame) {
+    // Loud frames whose level changes over time, so that the limiters are
+    // busy and their states differ.
+    for (int i = 0; i < kAudioSources; ++i) {
+      int16_t* data = participants[i].fake_frame()->mutable_data();
+      const int16_t value = 5000 * (i + 1) + 1000 * (frame % 5);
+      std::fill(data, data + kDefaultSampleRateHz / 100, value);
+    }
+    if (frame % 2 == 0) {
+      mixer->MixExcludingSources(1, sources, audio_frames_for_mixing);
+    } else {
+      mixer->MixExcludingSources(1, reversed_sources,
+                                 reversed_audio_frames_for_mixing);
+    }
+    reference_mixer->MixExcludingSources(1, sources,
+                                         reference_audio_frames_for_mixing);
+    for (int i = 0; i < kAudioSources; ++i) {
+      EXPECT_EQ(0, memcmp(reference_audio_frames[i].data(),
+                          audio_frames[i].data(),
+                          sizeof(int16_t) * kDefaultSampleRateHz / 100))
+          << "Frame #" << frame << ", source #" << i;
+    }
+  }
+}
 }  // namespace webrtc
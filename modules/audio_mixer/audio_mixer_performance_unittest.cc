@@ -0,0 +1,211 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/audio/audio_frame.h"
+#include "modules/audio_mixer/audio_mixer_impl.h"
+#include "modules/audio_mixer/default_output_rate_calculator.h"
+#include "modules/audio_mixer/frame_combiner.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kSampleRateHz = 48000;
+constexpr size_t kSamplesPerChannel = kSampleRateHz / 100;
+constexpr int kNumIterations = 1000;
+
+// A source that returns the same frame of random samples on each call. Every
+// fourth source is muted, as happens with discontinuous transmission.
+class RandomSource : public AudioMixer::Source {
+ public:
+  RandomSource(int ssrc, Random* random_generator) : ssrc_(ssrc) {
+    const int16_t amplitude = random_generator->Rand(100, 10000);
+    for (auto& sample : samples_) {
+      sample = random_generator->Rand(-amplitude, amplitude);
+    }
+  }
+
+  AudioFrameInfo GetAudioFrameWithInfo(int sample_rate_hz,
+                                       AudioFrame* audio_frame) override {
+    const bool muted = ssrc_ % 4 == 0;
+    audio_frame->UpdateFrame(0, muted ? nullptr : samples_.data(),
+                             kSamplesPerChannel, sample_rate_hz,
+                             AudioFrame::kNormalSpeech,
+                             AudioFrame::kVadActive, 1);
+    return muted ? AudioFrameInfo::kMuted : AudioFrameInfo::kNormal;
+  }
+
+  int Ssrc() const override { return ssrc_; }
+  int PreferredSampleRate() const override { return kSampleRateHz; }
+
+ private:
+  const int ssrc_;
+  std::array<int16_t, kSamplesPerChannel> samples_;
+};
+
+// Returns the CPU time in us per call of |process|.
+template <typename Process>
+double MeasureUs(Process process, int num_iterations = kNumIterations) {
+  process();
+  const int64_t start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+  for (int i = 0; i < num_iterations; ++i) {
+    process();
+  }
+  return static_cast<double>(rtc::GetThreadCpuTimeNanos() - start_cpu_ns) /
+         num_iterations / 1000.0;
+}
+
+}  // namespace
+
+// Measures one call of Mix() with many sources. This includes the fetching of
+// the frames, the energy computation and the selection of the sources to mix.
+TEST(AudioMixerPerformanceTest, Mix) {
+  for (int num_sources : {16, 64, 256}) {
+    Random random_generator(42U);
+    std::vector<std::unique_ptr<RandomSource>> sources;
+    rtc::scoped_refptr<AudioMixerImpl> mixer = AudioMixerImpl::Create();
+    for (int i = 0; i < num_sources; ++i) {
+      sources.emplace_back(new RandomSource(i, &random_generator));
+      mixer->AddSource(sources.back().get());
+    }
+    AudioFrame frame;
+    test::PrintResult("audio_mixer_mix_cpu_time", "",
+                      std::to_string(num_sources) + "_sources",
+                      MeasureUs([&] { mixer->Mix(1, &frame); }), "us", false);
+  }
+}
+
+// Measures the production of one mix per mixed participant, leaving out the
+// participant itself, with one Combine() call per mix and with a single
+// CombineExcluding() call.
+TEST(AudioMixerPerformanceTest, NMinusOneMixes) {
+  constexpr size_t kNumMixed =
+      AudioMixerImpl::kMaximumAmountOfMixedAudioSources;
+  for (int num_outputs : {16, 64, 256}) {
+    Random random_generator(42U);
+    std::vector<AudioFrame> frames(kNumMixed);
+    std::vector<std::unique_ptr<RandomSource>> sources;
+    std::vector<AudioFrame*> mix_list;
+    for (size_t i = 0; i < kNumMixed; ++i) {
+      sources.emplace_back(new RandomSource(i + 1, &random_generator));
+      sources.back()->GetAudioFrameWithInfo(kSampleRateHz, &frames[i]);
+      mix_list.push_back(&frames[i]);
+    }
+    // The first outputs belong to the mixed participants, the others hear
+    // all of them.
+    std::vector<size_t> excluded_frames(num_outputs,
+                                        FrameCombiner::kNoExcludedFrame);
+    for (size_t i = 0; i < kNumMixed; ++i) {
+      excluded_frames[i] = i;
+    }
+    std::vector<AudioFrame> outputs(num_outputs);
+    std::vector<AudioFrame*> output_pointers;
+    for (auto& output : outputs) {
+      output_pointers.push_back(&output);
+    }
+
+    std::vector<std::unique_ptr<FrameCombiner>> combiners;
+    for (int i = 0; i < num_outputs; ++i) {
+      combiners.emplace_back(new FrameCombiner(true));
+    }
+    const double separate_us = MeasureUs([&] {
+      for (int i = 0; i < num_outputs; ++i) {
+        std::vector<AudioFrame*> other_frames;
+        for (size_t j = 0; j < mix_list.size(); ++j) {
+          if (j != excluded_frames[i]) {
+            other_frames.push_back(mix_list[j]);
+          }
+        }
+        combiners[i]->Combine(other_frames, 1, kSampleRateHz, num_outputs,
+                              output_pointers[i]);
+      }
+    });
+
+    FrameCombiner combiner(true);
+    const double shared_us = MeasureUs([&] {
+      combiner.CombineExcluding(mix_list, excluded_frames, 1, kSampleRateHz,
+                                num_outputs, output_pointers);
+    });
+
+    const std::string trace = std::to_string(num_outputs) + "_outputs";
+    test::PrintResult("audio_mixer_n_minus_one_cpu_time", "",
+                      trace + "_separate_combiners", separate_us, "us",
+                      false);
+    test::PrintResult("audio_mixer_n_minus_one_cpu_time", "",
+                      trace + "_shared_sum", shared_us, "us", false);
+  }
+}
+
+// Measures the production of one mix per participant, leaving out the
+// participant itself, with one mixer per participant that has all the other
+// participants as sources, and with one MixExcludingSources() call. The CPU
+// time is reported per participant: it grows with the number of participants
+// in the former case and stays flat in the latter.
+TEST(AudioMixerPerformanceTest, MixExcludingSources) {
+  for (int num_participants : {16, 64, 256}) {
+    Random random_generator(42U);
+    std::vector<std::unique_ptr<RandomSource>> participants;
+    std::vector<AudioMixer::Source*> sources;
+    for (int i = 0; i < num_participants; ++i) {
+      participants.emplace_back(new RandomSource(i, &random_generator));
+      sources.push_back(participants.back().get());
+    }
+    std::vector<AudioFrame> outputs(num_participants);
+    std::vector<AudioFrame*> output_pointers;
+    for (auto& output : outputs) {
+      output_pointers.push_back(&output);
+    }
+
+    std::vector<rtc::scoped_refptr<AudioMixerImpl>> mixers;
+    for (int i = 0; i < num_participants; ++i) {
+      mixers.push_back(AudioMixerImpl::Create());
+      for (int j = 0; j < num_participants; ++j) {
+        if (j != i) {
+          mixers.back()->AddSource(sources[j]);
+        }
+      }
+    }
+    // One mixer per participant is quadratic, so fewer calls are measured.
+    const double separate_us = MeasureUs(
+        [&] {
+          for (int i = 0; i < num_participants; ++i) {
+            mixers[i]->Mix(1, output_pointers[i]);
+          }
+        },
+        kNumIterations * 16 / num_participants);
+
+    rtc::scoped_refptr<AudioMixerImpl> mixer = AudioMixerImpl::Create();
+    for (auto* source : sources) {
+      mixer->AddSource(source);
+    }
+    const double shared_us = MeasureUs(
+        [&] { mixer->MixExcludingSources(1, sources, output_pointers); });
+
+    const std::string trace =
+        std::to_string(num_participants) + "_participants";
+    test::PrintResult("audio_mixer_mix_excluding_sources_cpu_time", "",
+                      trace + "_mixer_per_participant",
+                      separate_us / num_participants, "us/participant",
+                      false);
+    test::PrintResult("audio_mixer_mix_excluding_sources_cpu_time", "",
+                      trace + "_shared_mixer", shared_us / num_participants,
+                      "us/participant", false);
+  }
+}
+
+}  // namespace webrtc
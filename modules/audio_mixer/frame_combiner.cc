@@ -10,6 +10,13 @@
 
 #include "modules/audio_mixer/frame_combiner.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+
 #include <algorithm>
 #include <array>
 #include <functional>
@@ -34,11 +41,20 @@ constexpr int kMaximumAmountOfChannels = 2;
 constexpr int kMaximumChannelSize = 48 * AudioMixerImpl::kFrameDurationInMs;
 
 using OneChannelBuffer = std::array<float, kMaximumChannelSize>;
+// Interleaved samples of all channels, in the same layout as AudioFrame.
+using InterleavedFloatBuffer =
+    std::array<float, kMaximumAmountOfChannels * kMaximumChannelSize>;
+using InterleavedS16Buffer =
+    std::array<int16_t, kMaximumAmountOfChannels * kMaximumChannelSize>;
 
-void SetAudioFrameFields(const std::vector<AudioFrame*>& mix_list,
+// Sets the fields of the mixed frame and copies |data| to it. |data| is null
+// for a muted frame. The timestamps are only kept when a single frame is
+// mixed, in which case |single_frame| is that frame.
+void SetAudioFrameFields(size_t number_of_frames,
+                         const AudioFrame* single_frame,
+                         const int16_t* data,
                          size_t number_of_channels,
                          int sample_rate,
-                         size_t number_of_streams,
                          AudioFrame* audio_frame_for_mixing) {
   const size_t samples_per_channel = static_cast<size_t>(
       (sample_rate * webrtc::AudioMixerImpl::kFrameDurationInMs) / 1000);
@@ -48,48 +64,117 @@ void SetAudioFrameFields(const std::vector<AudioFrame*>& mix_list,
   // value '0', because it is only supported in the one channel case and
   // is then updated in the helper functions.
   audio_frame_for_mixing->UpdateFrame(
-      0, nullptr, samples_per_channel, sample_rate, AudioFrame::kUndefined,
+      0, data, samples_per_channel, sample_rate, AudioFrame::kUndefined,
       AudioFrame::kVadUnknown, number_of_channels);
 
-  if (mix_list.empty()) {
+  if (number_of_frames == 0) {
     audio_frame_for_mixing->elapsed_time_ms_ = -1;
-  } else if (mix_list.size() == 1) {
-    audio_frame_for_mixing->timestamp_ = mix_list[0]->timestamp_;
-    audio_frame_for_mixing->elapsed_time_ms_ = mix_list[0]->elapsed_time_ms_;
-    audio_frame_for_mixing->ntp_time_ms_ = mix_list[0]->ntp_time_ms_;
+  } else if (number_of_frames == 1) {
+    RTC_DCHECK(single_frame);
+    audio_frame_for_mixing->timestamp_ = single_frame->timestamp_;
+    audio_frame_for_mixing->elapsed_time_ms_ = single_frame->elapsed_time_ms_;
+    audio_frame_for_mixing->ntp_time_ms_ = single_frame->ntp_time_ms_;
   }
 }
 
-void MixFewFramesWithNoLimiter(const std::vector<AudioFrame*>& mix_list,
-                               AudioFrame* audio_frame_for_mixing) {
-  if (mix_list.empty()) {
-    audio_frame_for_mixing->Mute();
-    return;
+// Adds the int16 samples of |x| to |y|.
+void AccumulateS16(const int16_t* x, size_t num_samples, float* y) {
+  size_t k = 0;
+#if defined(__SSE2__)
+  for (; k + 8 <= num_samples; k += 8) {
+    const __m128i x_k =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&x[k]));
+    // Sign extend to 32 bits by shifting the samples into the upper halves.
+    const __m128i x_k_low =
+        _mm_srai_epi32(_mm_unpacklo_epi16(x_k, x_k), 16);
+    const __m128i x_k_high =
+        _mm_srai_epi32(_mm_unpackhi_epi16(x_k, x_k), 16);
+    _mm_storeu_ps(&y[k], _mm_add_ps(_mm_loadu_ps(&y[k]),
+                                    _mm_cvtepi32_ps(x_k_low)));
+    _mm_storeu_ps(&y[k + 4], _mm_add_ps(_mm_loadu_ps(&y[k + 4]),
+                                        _mm_cvtepi32_ps(x_k_high)));
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  for (; k + 8 <= num_samples; k += 8) {
+    const int16x8_t x_k = vld1q_s16(&x[k]);
+    const float32x4_t x_k_low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(x_k)));
+    const float32x4_t x_k_high =
+        vcvtq_f32_s32(vmovl_s16(vget_high_s16(x_k)));
+    vst1q_f32(&y[k], vaddq_f32(vld1q_f32(&y[k]), x_k_low));
+    vst1q_f32(&y[k + 4], vaddq_f32(vld1q_f32(&y[k + 4]), x_k_high));
+  }
+#endif
+  for (; k < num_samples; ++k) {
+    y[k] += x[k];
   }
-  RTC_DCHECK_LE(mix_list.size(), 1);
-  std::copy(mix_list[0]->data(),
-            mix_list[0]->data() +
-                mix_list[0]->num_channels_ * mix_list[0]->samples_per_channel_,
-            audio_frame_for_mixing->mutable_data());
 }
 
-std::array<OneChannelBuffer, kMaximumAmountOfChannels> MixToFloatFrame(
-    const std::vector<AudioFrame*>& mix_list,
-    size_t samples_per_channel,
-    size_t number_of_channels) {
-  // Convert to FloatS16 and mix.
-  using OneChannelBuffer = std::array<float, kMaximumChannelSize>;
-  std::array<OneChannelBuffer, kMaximumAmountOfChannels> mixing_buffer{};
-
-  for (size_t i = 0; i < mix_list.size(); ++i) {
-    const AudioFrame* const frame = mix_list[i];
-    for (size_t j = 0; j < number_of_channels; ++j) {
-      for (size_t k = 0; k < samples_per_channel; ++k) {
-        mixing_buffer[j][k] += frame->data()[number_of_channels * k + j];
-      }
-    }
+// Subtracts the int16 samples of |x| from |y|.
+void SubtractS16(const int16_t* x, size_t num_samples, float* y) {
+  size_t k = 0;
+#if defined(__SSE2__)
+  for (; k + 8 <= num_samples; k += 8) {
+    const __m128i x_k =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&x[k]));
+    const __m128i x_k_low =
+        _mm_srai_epi32(_mm_unpacklo_epi16(x_k, x_k), 16);
+    const __m128i x_k_high =
+        _mm_srai_epi32(_mm_unpackhi_epi16(x_k, x_k), 16);
+    _mm_storeu_ps(&y[k], _mm_sub_ps(_mm_loadu_ps(&y[k]),
+                                    _mm_cvtepi32_ps(x_k_low)));
+    _mm_storeu_ps(&y[k + 4], _mm_sub_ps(_mm_loadu_ps(&y[k + 4]),
+                                        _mm_cvtepi32_ps(x_k_high)));
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  for (; k + 8 <= num_samples; k += 8) {
+    const int16x8_t x_k = vld1q_s16(&x[k]);
+    const float32x4_t x_k_low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(x_k)));
+    const float32x4_t x_k_high =
+        vcvtq_f32_s32(vmovl_s16(vget_high_s16(x_k)));
+    vst1q_f32(&y[k], vsubq_f32(vld1q_f32(&y[k]), x_k_low));
+    vst1q_f32(&y[k + 4], vsubq_f32(vld1q_f32(&y[k + 4]), x_k_high));
+  }
+#endif
+  for (; k < num_samples; ++k) {
+    y[k] -= x[k];
+  }
+}
+
+// Rounds and saturates |x| to int16 in the same way as FloatS16ToS16(). The
+// samples are clamped before being converted to integers, so that rounding
+// half away from zero and truncating gives the same result.
+void RoundToS16(const float* x, size_t num_samples, int16_t* y) {
+  size_t k = 0;
+#if defined(__SSE2__)
+  const __m128 max = _mm_set1_ps(limits_int16::max());
+  const __m128 min = _mm_set1_ps(limits_int16::min());
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 sign_mask = _mm_set1_ps(-0.f);
+  for (; k + 8 <= num_samples; k += 8) {
+    __m128 x_low = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&x[k]), min), max);
+    __m128 x_high =
+        _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&x[k + 4]), min), max);
+    x_low = _mm_add_ps(x_low, _mm_or_ps(_mm_and_ps(x_low, sign_mask), half));
+    x_high =
+        _mm_add_ps(x_high, _mm_or_ps(_mm_and_ps(x_high, sign_mask), half));
+    const __m128i y_k = _mm_packs_epi32(_mm_cvttps_epi32(x_low),
+                                        _mm_cvttps_epi32(x_high));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&y[k]), y_k);
+  }
+#endif
+  for (; k < num_samples; ++k) {
+    y[k] = FloatS16ToS16(x[k]);
+  }
+}
+
+// Sums all frames of |mix_list| into |mixing_buffer|.
+void MixToFloatFrame(const std::vector<AudioFrame*>& mix_list,
+                     size_t num_samples,
+                     InterleavedFloatBuffer* mixing_buffer) {
+  std::fill(mixing_buffer->begin(), mixing_buffer->begin() + num_samples, 0.f);
+  for (const AudioFrame* frame : mix_list) {
+    AccumulateS16(frame->data(), num_samples, mixing_buffer->data());
   }
-  return mixing_buffer;
 }
 
 void RunLimiter(AudioFrameView<float> mixing_buffer_view, Limiter* limiter) {
@@ -100,21 +185,43 @@ void RunLimiter(AudioFrameView<float> mixing_buffer_view, Limiter* limiter) {
   limiter->Process(mixing_buffer_view);
 }
 
-// Both interleaves and rounds.
-void InterleaveToAudioFrame(AudioFrameView<const float> mixing_buffer_view,
-                            AudioFrame* audio_frame_for_mixing) {
-  const size_t number_of_channels = mixing_buffer_view.num_channels();
-  const size_t samples_per_channel = mixing_buffer_view.samples_per_channel();
-  // Put data in the result frame.
-  for (size_t i = 0; i < number_of_channels; ++i) {
-    for (size_t j = 0; j < samples_per_channel; ++j) {
-      audio_frame_for_mixing->mutable_data()[number_of_channels * j + i] =
-          FloatS16ToS16(mixing_buffer_view.channel(i)[j]);
+// Runs |limiter|, if any, on the interleaved |mixing_buffer| and rounds the
+// result into |output|.
+void LimitAndRound(size_t number_of_channels,
+                   size_t samples_per_channel,
+                   Limiter* limiter,
+                   InterleavedFloatBuffer* mixing_buffer,
+                   InterleavedS16Buffer* output) {
+  const size_t num_samples = number_of_channels * samples_per_channel;
+  if (limiter) {
+    if (number_of_channels == 1) {
+      float* channel_pointer = mixing_buffer->data();
+      RunLimiter(AudioFrameView<float>(&channel_pointer, 1,
+                                       samples_per_channel),
+                 limiter);
+    } else {
+      // The limiter works on deinterleaved channels.
+      std::array<OneChannelBuffer, kMaximumAmountOfChannels> channels;
+      std::array<float*, kMaximumAmountOfChannels> channel_pointers{};
+      for (size_t i = 0; i < number_of_channels; ++i) {
+        channel_pointers[i] = channels[i].data();
+      }
+      Deinterleave(mixing_buffer->data(), samples_per_channel,
+                   number_of_channels, channel_pointers.data());
+      RunLimiter(AudioFrameView<float>(channel_pointers.data(),
+                                       number_of_channels,
+                                       samples_per_channel),
+                 limiter);
+      Interleave(channel_pointers.data(), samples_per_channel,
+                 number_of_channels, mixing_buffer->data());
     }
   }
+  RoundToS16(mixing_buffer->data(), num_samples, output->data());
 }
 }  // namespace
 
+constexpr size_t FrameCombiner::kNoExcludedFrame;
+
 FrameCombiner::FrameCombiner(bool use_limiter)
     : data_dumper_(new ApmDataDumper(0)),
       limiter_(static_cast<size_t>(48000), data_dumper_.get(), "AudioMixer"),
@@ -131,11 +238,123 @@ void FrameCombiner::Combine(const std::vector<AudioFrame*>& mix_list,
 
   LogMixingStats(mix_list, sample_rate, number_of_streams);
 
-  SetAudioFrameFields(mix_list, number_of_channels, sample_rate,
-                      number_of_streams, audio_frame_for_mixing);
+  const size_t samples_per_channel = PrepareFrames(
+      mix_list, number_of_channels, sample_rate);
+
+  if (number_of_streams <= 1) {
+    // At most one frame is mixed and no limiter is needed.
+    RTC_DCHECK_LE(mix_list.size(), 1);
+    const AudioFrame* frame = mix_list.empty() ? nullptr : mix_list[0];
+    SetAudioFrameFields(mix_list.size(), frame,
+                        frame ? frame->data() : nullptr, number_of_channels,
+                        sample_rate, audio_frame_for_mixing);
+    return;
+  }
+
+  InterleavedFloatBuffer mixing_buffer;
+  MixToFloatFrame(mix_list, number_of_channels * samples_per_channel,
+                  &mixing_buffer);
+  InterleavedS16Buffer output;
+  LimitAndRound(number_of_channels, samples_per_channel,
+                use_limiter_ ? &limiter_ : nullptr, &mixing_buffer, &output);
+  SetAudioFrameFields(mix_list.size(),
+                      mix_list.size() == 1 ? mix_list[0] : nullptr,
+                      output.data(), number_of_channels, sample_rate,
+                      audio_frame_for_mixing);
+}
+
+void FrameCombiner::CombineExcluding(
+    const std::vector<AudioFrame*>& mix_list,
+    rtc::ArrayView<const size_t> excluded_frames,
+    size_t number_of_channels,
+    int sample_rate,
+    size_t number_of_streams,
+    rtc::ArrayView<AudioFrame* const> audio_frames_for_mixing) {
+  while (limiters_.size() < audio_frames_for_mixing.size()) {
+    limiters_.push_back(CreateLimiter());
+  }
+  std::vector<Limiter*> limiters(audio_frames_for_mixing.size());
+  for (size_t i = 0; i < limiters.size(); ++i) {
+    limiters[i] = limiters_[i].get();
+  }
+  CombineExcluding(mix_list, excluded_frames, number_of_channels, sample_rate,
+                   number_of_streams, audio_frames_for_mixing, limiters);
+}
+
+void FrameCombiner::CombineExcluding(
+    const std::vector<AudioFrame*>& mix_list,
+    rtc::ArrayView<const size_t> excluded_frames,
+    size_t number_of_channels,
+    int sample_rate,
+    size_t number_of_streams,
+    rtc::ArrayView<AudioFrame* const> audio_frames_for_mixing,
+    rtc::ArrayView<Limiter* const> limiters) {
+  RTC_DCHECK_EQ(excluded_frames.size(), audio_frames_for_mixing.size());
+  RTC_DCHECK_EQ(limiters.size(), audio_frames_for_mixing.size());
+
+  LogMixingStats(mix_list, sample_rate, number_of_streams);
+
+  const size_t samples_per_channel = PrepareFrames(
+      mix_list, number_of_channels, sample_rate);
+  const size_t num_samples = number_of_channels * samples_per_channel;
+
+  // The sum of all frames is computed once. Since the samples are integers
+  // and at most a few frames are mixed, the sums are exact and removing a
+  // frame gives the same result as not adding it.
+  InterleavedFloatBuffer sum;
+  if (number_of_streams > 1) {
+    MixToFloatFrame(mix_list, num_samples, &sum);
+  }
 
+  InterleavedFloatBuffer mixing_buffer;
+  InterleavedS16Buffer output;
+  for (size_t i = 0; i < audio_frames_for_mixing.size(); ++i) {
+    AudioFrame* const audio_frame_for_mixing = audio_frames_for_mixing[i];
+    RTC_DCHECK(audio_frame_for_mixing);
+    const size_t excluded = excluded_frames[i];
+    RTC_DCHECK(excluded == kNoExcludedFrame || excluded < mix_list.size());
+    const bool exclude = excluded < mix_list.size();
+    const size_t number_of_frames = mix_list.size() - (exclude ? 1 : 0);
+
+    // The only frame that is left, if any.
+    const AudioFrame* single_frame = nullptr;
+    if (number_of_frames == 1) {
+      single_frame = mix_list[exclude && excluded == 0 ? 1 : 0];
+    }
+
+    if (number_of_streams <= 1) {
+      SetAudioFrameFields(number_of_frames, single_frame,
+                          single_frame ? single_frame->data() : nullptr,
+                          number_of_channels, sample_rate,
+                          audio_frame_for_mixing);
+      continue;
+    }
+
+    std::copy(sum.begin(), sum.begin() + num_samples, mixing_buffer.begin());
+    if (exclude) {
+      SubtractS16(mix_list[excluded]->data(), num_samples,
+                  mixing_buffer.data());
+    }
+    LimitAndRound(number_of_channels, samples_per_channel,
+                  use_limiter_ ? limiters[i] : nullptr,
+                  &mixing_buffer, &output);
+    SetAudioFrameFields(number_of_frames, single_frame, output.data(),
+                        number_of_channels, sample_rate,
+                        audio_frame_for_mixing);
+  }
+}
+
+std::unique_ptr<Limiter> FrameCombiner::CreateLimiter() const {
+  return std::unique_ptr<Limiter>(new Limiter(
+      static_cast<size_t>(48000), data_dumper_.get(), "AudioMixer"));
+}
+
+size_t FrameCombiner::PrepareFrames(const std::vector<AudioFrame*>& mix_list,
+                                    size_t number_of_channels,
+                                    int sample_rate) const {
   const size_t samples_per_channel = static_cast<size_t>(
       (sample_rate * webrtc::AudioMixerImpl::kFrameDurationInMs) / 1000);
+  RTC_DCHECK_LE(samples_per_channel, kMaximumChannelSize);
 
   for (const auto* frame : mix_list) {
     RTC_DCHECK_EQ(samples_per_channel, frame->samples_per_channel_);
@@ -147,28 +366,7 @@ void FrameCombiner::Combine(const std::vector<AudioFrame*>& mix_list,
   for (auto* frame : mix_list) {
     RemixFrame(number_of_channels, frame);
   }
-
-  if (number_of_streams <= 1) {
-    MixFewFramesWithNoLimiter(mix_list, audio_frame_for_mixing);
-    return;
-  }
-
-  std::array<OneChannelBuffer, kMaximumAmountOfChannels> mixing_buffer =
-      MixToFloatFrame(mix_list, samples_per_channel, number_of_channels);
-
-  // Put float data in an AudioFrameView.
-  std::array<float*, kMaximumAmountOfChannels> channel_pointers{};
-  for (size_t i = 0; i < number_of_channels; ++i) {
-    channel_pointers[i] = &mixing_buffer[i][0];
-  }
-  AudioFrameView<float> mixing_buffer_view(
-      &channel_pointers[0], number_of_channels, samples_per_channel);
-
-  if (use_limiter_) {
-    RunLimiter(mixing_buffer_view, &limiter_);
-  }
-
-  InterleaveToAudioFrame(mixing_buffer_view, audio_frame_for_mixing);
+  return samples_per_channel;
 }
 
 void FrameCombiner::LogMixingStats(const std::vector<AudioFrame*>& mix_list,
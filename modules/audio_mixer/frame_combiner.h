@@ -14,6 +14,7 @@
 #include <memory>
 #include <vector>
 
+#include "api/array_view.h"
 #include "api/audio/audio_frame.h"
 #include "modules/audio_processing/agc2/limiter.h"
 
@@ -38,13 +39,52 @@ class FrameCombiner {
                size_t number_of_streams,
                AudioFrame* audio_frame_for_mixing);
 
+  static constexpr size_t kNoExcludedFrame = static_cast<size_t>(-1);
+
+  // Like Combine(), but produces one mix per element of
+  // |audio_frames_for_mixing| out of a single sum of |mix_list|. The mix at
+  // index i leaves out the frame of |mix_list| at index |excluded_frames[i]|,
+  // or leaves out nothing if that is kNoExcludedFrame. This gives the N-1
+  // mixes of a conference, where no participant hears itself. Each output
+  // index has a limiter of its own, so each index should always be used for
+  // the same participant.
+  void CombineExcluding(
+      const std::vector<AudioFrame*>& mix_list,
+      rtc::ArrayView<const size_t> excluded_frames,
+      size_t number_of_channels,
+      int sample_rate,
+      size_t number_of_streams,
+      rtc::ArrayView<AudioFrame* const> audio_frames_for_mixing);
+
+  // Like above, but the mix at index i is limited by |limiters[i]|, so that
+  // the limiter state can follow a participant whose output index changes.
+  // The limiters should be created with CreateLimiter(). They are not used if
+  // the combiner has no limiter.
+  void CombineExcluding(
+      const std::vector<AudioFrame*>& mix_list,
+      rtc::ArrayView<const size_t> excluded_frames,
+      size_t number_of_channels,
+      int sample_rate,
+      size_t number_of_streams,
+      rtc::ArrayView<AudioFrame* const> audio_frames_for_mixing,
+      rtc::ArrayView<Limiter* const> limiters);
+
+  std::unique_ptr<Limiter> CreateLimiter() const;
+
  private:
+  // Checks the frames of |mix_list|, remixes them to |number_of_channels| and
+  // returns the number of samples per channel.
+  size_t PrepareFrames(const std::vector<AudioFrame*>& mix_list,
+                       size_t number_of_channels,
+                       int sample_rate) const;
   void LogMixingStats(const std::vector<AudioFrame*>& mix_list,
                       int sample_rate,
                       size_t number_of_streams) const;
 
   std::unique_ptr<ApmDataDumper> data_dumper_;
   Limiter limiter_;
+  // One per output of CombineExcluding().
+  std::vector<std::unique_ptr<Limiter>> limiters_;
   const bool use_limiter_;
   mutable int uma_logging_counter_ = 0;
 };
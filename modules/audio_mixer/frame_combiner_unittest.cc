@@ -14,9 +14,11 @@
 #include <string>
 
 #include "audio/utility/audio_frame_operations.h"
+#include "common_audio/include/audio_util.h"
 #include "modules/audio_mixer/gain_change_calculator.h"
 #include "modules/audio_mixer/sine_wave_generator.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/random.h"
 #include "rtc_base/strings/string_builder.h"
 #include "test/gtest.h"
 
@@ -61,6 +63,29 @@ void SetUpFrames(int sample_rate_hz, int number_of_channels) {
                        AudioFrame::kVadActive, number_of_channels);
   }
 }
+
+// Fills |frame| with random samples of at most |amplitude|.
+void SetUpRandomFrame(int sample_rate_hz,
+                      int number_of_channels,
+                      int16_t amplitude,
+                      Random* random_generator,
+                      AudioFrame* frame) {
+  const size_t samples_per_channel =
+      rtc::CheckedDivExact(sample_rate_hz, 100);
+  std::vector<int16_t> data(samples_per_channel * number_of_channels);
+  for (auto& sample : data) {
+    sample = random_generator->Rand(-amplitude, amplitude);
+  }
+  frame->UpdateFrame(0, data.data(), samples_per_channel, sample_rate_hz,
+                     AudioFrame::kNormalSpeech, AudioFrame::kVadActive,
+                     number_of_channels);
+}
+
+std::vector<int16_t> FrameData(const AudioFrame& frame) {
+  return std::vector<int16_t>(
+      frame.data(), frame.data() + frame.samples_per_channel_ *
+                                       frame.num_channels_);
+}
 }  // namespace
 
 // The limiter requires sample rate divisible by 2000.
@@ -209,4 +234,102 @@ TEST(FrameCombiner, GainCurveIsSmoothForAlternatingNumberOfStreams) {
     EXPECT_LT(change_calculator.LatestGain(), 1.01f);
   }
 }
+
+// Checks that the mix without a limiter is the rounded and saturated sum of
+// the frames, also when the sum does not fit in 16 bits.
+TEST(FrameCombiner, MixWithoutLimiterIsSaturatedSum) {
+  FrameCombiner combiner(false);
+  Random random_generator(42U);
+  for (const int rate : {8000, 11000, 44100, 48000}) {
+    for (const int number_of_channels : {1, 2}) {
+      SCOPED_TRACE(ProduceDebugText(rate, number_of_channels, 2));
+      SetUpRandomFrame(rate, number_of_channels, 30000, &random_generator,
+                       &frame1);
+      SetUpRandomFrame(rate, number_of_channels, 30000, &random_generator,
+                       &frame2);
+      const std::vector<AudioFrame*> frames_to_combine = {&frame1, &frame2};
+      combiner.Combine(frames_to_combine, number_of_channels, rate,
+                       frames_to_combine.size(), &audio_frame_for_mixing);
+
+      std::vector<int16_t> expected = FrameData(frame1);
+      for (size_t k = 0; k < expected.size(); ++k) {
+        expected[k] =
+            FloatS16ToS16(static_cast<float>(frame1.data()[k]) +
+                          static_cast<float>(frame2.data()[k]));
+      }
+      EXPECT_EQ(expected, FrameData(audio_frame_for_mixing));
+    }
+  }
+}
+
+// Checks that each N-1 mix is the same as the mix of the other frames made by
+// a combiner of its own, with and without limiter.
+TEST(FrameCombiner, CombineExcludingMatchesCombineOfOtherFrames) {
+  constexpr size_t kNumFrames = 3;
+  constexpr int kRate = 48000;
+  for (const bool use_limiter : {false, true}) {
+    for (const int number_of_channels : {1, 2}) {
+      SCOPED_TRACE(ProduceDebugText(kRate, number_of_channels, kNumFrames));
+      Random random_generator(42U);
+      FrameCombiner combiner(use_limiter);
+      std::vector<std::unique_ptr<FrameCombiner>> reference_combiners;
+      // One output per frame, and one with all frames.
+      std::vector<size_t> excluded_frames;
+      for (size_t i = 0; i < kNumFrames; ++i) {
+        excluded_frames.push_back(i);
+      }
+      excluded_frames.push_back(FrameCombiner::kNoExcludedFrame);
+      for (size_t i = 0; i < excluded_frames.size(); ++i) {
+        reference_combiners.emplace_back(new FrameCombiner(use_limiter));
+      }
+      std::vector<AudioFrame> frames(kNumFrames);
+      std::vector<AudioFrame> outputs(excluded_frames.size());
+      std::vector<AudioFrame*> output_pointers;
+      for (auto& output : outputs) {
+        output_pointers.push_back(&output);
+      }
+
+      for (int iteration = 0; iteration < 20; ++iteration) {
+        std::vector<AudioFrame*> mix_list;
+        for (auto& frame : frames) {
+          SetUpRandomFrame(kRate, number_of_channels, 20000,
+                           &random_generator, &frame);
+          mix_list.push_back(&frame);
+        }
+        combiner.CombineExcluding(mix_list, excluded_frames,
+                                  number_of_channels, kRate, kNumFrames,
+                                  output_pointers);
+
+        for (size_t i = 0; i < excluded_frames.size(); ++i) {
+          std::vector<AudioFrame*> other_frames;
+          for (size_t j = 0; j < kNumFrames; ++j) {
+            if (j != excluded_frames[i]) {
+              other_frames.push_back(&frames[j]);
+            }
+          }
+          AudioFrame expected;
+          reference_combiners[i]->Combine(other_frames, number_of_channels,
+                                          kRate, kNumFrames, &expected);
+          EXPECT_EQ(FrameData(expected), FrameData(outputs[i]));
+        }
+      }
+    }
+  }
+}
+
+TEST(FrameCombiner, CombineExcludingKeepsTimestampOfSingleFrame) {
+  FrameCombiner combiner(true);
+  SetUpFrames(48000, 1);
+  frame1.timestamp_ = 1000;
+  frame2.timestamp_ = 2000;
+  const std::vector<AudioFrame*> frames_to_combine = {&frame1, &frame2};
+  const std::vector<size_t> excluded_frames = {0, 1};
+  AudioFrame output1;
+  AudioFrame output2;
+  const std::vector<AudioFrame*> outputs = {&output1, &output2};
+  combiner.CombineExcluding(frames_to_combine, excluded_frames, 1, 48000,
+                            frames_to_combine.size(), outputs);
+  EXPECT_EQ(2000u, output1.timestamp_);
+  EXPECT_EQ(1000u, output2.timestamp_);
+}
 }  // namespace webrtc
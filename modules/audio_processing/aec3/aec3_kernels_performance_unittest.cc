@@ -0,0 +1,293 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "api/array_view.h"
+#include "api/audio/echo_canceller3_config.h"
+#include "modules/audio_processing/aec3/adaptive_fir_filter.h"
+#include "modules/audio_processing/aec3/aec3_common.h"
+#include "modules/audio_processing/aec3/fft_data.h"
+#include "modules/audio_processing/aec3/matched_filter.h"
+#include "modules/audio_processing/aec3/render_delay_buffer.h"
+#include "modules/audio_processing/aec3/vector_math.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/random.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace aec3 {
+namespace {
+
+constexpr int kNumIterations = 100000;
+// Same as the default main filter and the matched filters of the delay
+// estimator.
+constexpr size_t kNumPartitions = 13;
+constexpr size_t kMatchedFilterSize = 32 * 16;
+constexpr size_t kMatchedFilterSubBlockSize = 16;
+
+using Results = std::vector<std::pair<std::string, double>>;
+
+// Fills |v| with random samples in the full 16 bit range.
+void RandomizeSamples(Random* random_generator, rtc::ArrayView<float> v) {
+  for (auto& v_k : v) {
+    v_k = 2 * 32767.f * random_generator->Rand<float>() - 32767.f;
+  }
+}
+
+// Returns the CPU time in ns per call of |kernel|.
+template <typename Kernel>
+double MeasureNs(Kernel kernel) {
+  kernel();
+  const int64_t start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+  for (int i = 0; i < kNumIterations; ++i) {
+    kernel();
+  }
+  const int64_t elapsed_cpu_ns = rtc::GetThreadCpuTimeNanos() - start_cpu_ns;
+  return static_cast<double>(elapsed_cpu_ns) / kNumIterations;
+}
+
+bool HasSse2() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return WebRtc_GetCPUInfo(kSSE2) != 0;
+#else
+  return false;
+#endif
+}
+
+bool HasAvx2() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0;
+#else
+  return false;
+#endif
+}
+
+// Prints the time per call of each variant of |kernel|, and the speedup of
+// the AVX2 variant over the SSE2 one.
+void PrintResults(const std::string& kernel, const Results& results) {
+  double sse2_ns = 0.0;
+  double avx2_ns = 0.0;
+  for (const auto& result : results) {
+    test::PrintResult("aec3_" + kernel + "_cpu_time", "", result.first,
+                      result.second, "ns", false);
+    if (result.first == "sse2")
+      sse2_ns = result.second;
+    if (result.first == "avx2")
+      avx2_ns = result.second;
+  }
+  if (sse2_ns > 0.0 && avx2_ns > 0.0) {
+    test::PrintResult("aec3_" + kernel + "_avx2_speedup", "", "over_sse2",
+                      sse2_ns / avx2_ns, "x", false);
+  }
+}
+
+// A render buffer filled with random data, and a filter of |kNumPartitions|
+// random partitions.
+class FilterSetup {
+ public:
+  FilterSetup()
+      : render_delay_buffer_(
+            RenderDelayBuffer::Create(EchoCanceller3Config(), 3)),
+        H_(kNumPartitions) {
+    Random random_generator(42U);
+    std::vector<std::vector<float>> x(3, std::vector<float>(kBlockSize, 0.f));
+    for (int k = 0; k < 20; ++k) {
+      RandomizeSamples(&random_generator, x[0]);
+      render_delay_buffer_->Insert(x);
+      if (k == 0) {
+        render_delay_buffer_->Reset();
+      }
+      render_delay_buffer_->PrepareCaptureProcessing();
+    }
+    for (auto& H_j : H_) {
+      RandomizeFftData(&random_generator, &H_j);
+    }
+    RandomizeFftData(&random_generator, &G_);
+  }
+
+  const RenderBuffer& render_buffer() const {
+    return *render_delay_buffer_->GetRenderBuffer();
+  }
+  std::vector<FftData>& H() { return H_; }
+  const FftData& G() const { return G_; }
+
+ private:
+  static void RandomizeFftData(Random* random_generator, FftData* X) {
+    for (size_t k = 0; k < kFftLengthBy2Plus1; ++k) {
+      X->re[k] = random_generator->Rand<float>() - 0.5f;
+      X->im[k] = random_generator->Rand<float>() - 0.5f;
+    }
+  }
+
+  std::unique_ptr<RenderDelayBuffer> render_delay_buffer_;
+  std::vector<FftData> H_;
+  FftData G_;
+};
+
+}  // namespace
+
+TEST(Aec3KernelsPerformanceTest, ApplyFilter) {
+  FilterSetup setup;
+  const RenderBuffer& render_buffer = setup.render_buffer();
+  const std::vector<FftData>& H = setup.H();
+  FftData S;
+  Results results;
+  results.emplace_back(
+      "c", MeasureNs([&] { ApplyFilter(render_buffer, H, &S); }));
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (HasSse2()) {
+    results.emplace_back(
+        "sse2", MeasureNs([&] { ApplyFilter_SSE2(render_buffer, H, &S); }));
+  }
+  if (HasAvx2()) {
+    results.emplace_back(
+        "avx2", MeasureNs([&] { ApplyFilter_AVX2(render_buffer, H, &S); }));
+  }
+#endif
+  PrintResults("apply_filter", results);
+}
+
+TEST(Aec3KernelsPerformanceTest, AdaptPartitions) {
+  FilterSetup setup;
+  const RenderBuffer& render_buffer = setup.render_buffer();
+  std::vector<FftData>& H = setup.H();
+  const FftData& G = setup.G();
+  Results results;
+  results.emplace_back(
+      "c", MeasureNs([&] { AdaptPartitions(render_buffer, G, H); }));
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (HasSse2()) {
+    results.emplace_back(
+        "sse2",
+        MeasureNs([&] { AdaptPartitions_SSE2(render_buffer, G, H); }));
+  }
+  if (HasAvx2()) {
+    results.emplace_back(
+        "avx2",
+        MeasureNs([&] { AdaptPartitions_AVX2(render_buffer, G, H); }));
+  }
+#endif
+  PrintResults("adapt_partitions", results);
+}
+
+TEST(Aec3KernelsPerformanceTest, UpdateFrequencyResponse) {
+  FilterSetup setup;
+  const std::vector<FftData>& H = setup.H();
+  std::vector<std::array<float, kFftLengthBy2Plus1>> H2(kNumPartitions);
+  Results results;
+  results.emplace_back("c",
+                       MeasureNs([&] { UpdateFrequencyResponse(H, &H2); }));
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (HasSse2()) {
+    results.emplace_back(
+        "sse2", MeasureNs([&] { UpdateFrequencyResponse_SSE2(H, &H2); }));
+  }
+  if (HasAvx2()) {
+    results.emplace_back(
+        "avx2", MeasureNs([&] { UpdateFrequencyResponse_AVX2(H, &H2); }));
+  }
+#endif
+  PrintResults("update_frequency_response", results);
+}
+
+TEST(Aec3KernelsPerformanceTest, UpdateErlEstimator) {
+  FilterSetup setup;
+  std::vector<std::array<float, kFftLengthBy2Plus1>> H2(kNumPartitions);
+  UpdateFrequencyResponse(setup.H(), &H2);
+  std::array<float, kFftLengthBy2Plus1> erl;
+  Results results;
+  results.emplace_back("c", MeasureNs([&] { UpdateErlEstimator(H2, &erl); }));
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (HasSse2()) {
+    results.emplace_back(
+        "sse2", MeasureNs([&] { UpdateErlEstimator_SSE2(H2, &erl); }));
+  }
+  if (HasAvx2()) {
+    results.emplace_back(
+        "avx2", MeasureNs([&] { UpdateErlEstimator_AVX2(H2, &erl); }));
+  }
+#endif
+  PrintResults("update_erl_estimator", results);
+}
+
+// Runs the matched filter over one sub-block of the default delay estimator
+// configuration. The threshold is zero so that the filter is always updated.
+TEST(Aec3KernelsPerformanceTest, MatchedFilterCore) {
+  Random random_generator(42U);
+  std::vector<float> x(2000);
+  RandomizeSamples(&random_generator, x);
+  std::vector<float> y(kMatchedFilterSubBlockSize);
+  RandomizeSamples(&random_generator, y);
+  std::vector<float> h(kMatchedFilterSize, 0.f);
+  constexpr float kSmoothing = 0.7f;
+  bool filters_updated = false;
+  float error_sum = 0.f;
+  Results results;
+  results.emplace_back("c", MeasureNs([&] {
+                         MatchedFilterCore(100, 0.f, kSmoothing, x, y, h,
+                                           &filters_updated, &error_sum);
+                       }));
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (HasSse2()) {
+    results.emplace_back("sse2", MeasureNs([&] {
+                           MatchedFilterCore_SSE2(100, 0.f, kSmoothing, x, y,
+                                                  h, &filters_updated,
+                                                  &error_sum);
+                         }));
+  }
+  if (HasAvx2()) {
+    results.emplace_back("avx2", MeasureNs([&] {
+                           MatchedFilterCore_AVX2(100, 0.f, kSmoothing, x, y,
+                                                  h, &filters_updated,
+                                                  &error_sum);
+                         }));
+  }
+#endif
+  EXPECT_TRUE(filters_updated);
+  PrintResults("matched_filter_core", results);
+}
+
+// Runs the three vector operations on one spectrum, as done per block by the
+// suppressor.
+TEST(Aec3KernelsPerformanceTest, VectorMath) {
+  std::array<float, kFftLengthBy2Plus1> x;
+  std::array<float, kFftLengthBy2Plus1> y;
+  std::array<float, kFftLengthBy2Plus1> z;
+  for (size_t k = 0; k < x.size(); ++k) {
+    x[k] = y[k] = z[k] = k + 1.f;
+  }
+  std::vector<std::pair<std::string, Aec3Optimization>> variants = {
+      {"c", Aec3Optimization::kNone}};
+  if (HasSse2())
+    variants.emplace_back("sse2", Aec3Optimization::kSse2);
+  if (HasAvx2())
+    variants.emplace_back("avx2", Aec3Optimization::kAvx2);
+
+  Results results;
+  for (const auto& variant : variants) {
+    VectorMath vector_math(variant.second);
+    results.emplace_back(variant.first, MeasureNs([&] {
+                           vector_math.Multiply(x, y, z);
+                           vector_math.Accumulate(x, z);
+                           vector_math.Sqrt(z);
+                         }));
+  }
+  PrintResults("vector_math", results);
+}
+
+}  // namespace aec3
+}  // namespace webrtc
@@ -277,8 +277,9 @@ const int kNumberOfHighPassBiQuads_16kHz = 1;
 class EchoCanceller3::RenderWriter {
  public:
   RenderWriter(ApmDataDumper* data_dumper,
-               SwapQueue<std::vector<std::vector<float>>,
-                         Aec3RenderQueueItemVerifier>* render_transfer_queue,
+               LockFreeSwapQueue<std::vector<std::vector<float>>,
+                                 Aec3RenderQueueItemVerifier>*
+                   render_transfer_queue,
                std::unique_ptr<CascadedBiQuadFilter> render_highpass_filter,
                int sample_rate_hz,
                int frame_length,
@@ -293,15 +294,15 @@ class EchoCanceller3::RenderWriter {
   const int num_bands_;
   std::unique_ptr<CascadedBiQuadFilter> render_highpass_filter_;
   std::vector<std::vector<float>> render_queue_input_frame_;
-  SwapQueue<std::vector<std::vector<float>>, Aec3RenderQueueItemVerifier>*
-      render_transfer_queue_;
+  LockFreeSwapQueue<std::vector<std::vector<float>>,
+                    Aec3RenderQueueItemVerifier>* render_transfer_queue_;
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(RenderWriter);
 };
 
 EchoCanceller3::RenderWriter::RenderWriter(
     ApmDataDumper* data_dumper,
-    SwapQueue<std::vector<std::vector<float>>, Aec3RenderQueueItemVerifier>*
-        render_transfer_queue,
+    LockFreeSwapQueue<std::vector<std::vector<float>>,
+                      Aec3RenderQueueItemVerifier>* render_transfer_queue,
     std::unique_ptr<CascadedBiQuadFilter> render_highpass_filter,
     int sample_rate_hz,
     int frame_length,
@@ -377,8 +378,6 @@ EchoCanceller3::EchoCanceller3(const EchoCanceller3Config& config,
               std::vector<float>(frame_length_, 0.f)),
           Aec3RenderQueueItemVerifier(num_bands_, frame_length_)),
       block_processor_(std::move(block_processor)),
-      render_queue_output_frame_(num_bands_,
-                                 std::vector<float>(frame_length_, 0.f)),
       block_(num_bands_, std::vector<float>(kBlockSize, 0.f)),
       sub_frame_view_(num_bands_),
       block_delay_buffer_(num_bands_,
@@ -497,14 +496,14 @@ void EchoCanceller3::SetAudioBufferDelay(size_t delay_ms) {
 
 void EchoCanceller3::EmptyRenderQueue() {
   RTC_DCHECK_RUNS_SERIALIZED(&capture_race_checker_);
-  bool frame_to_buffer =
-      render_transfer_queue_.Remove(&render_queue_output_frame_);
-  while (frame_to_buffer) {
-    BufferRenderFrameContent(&render_queue_output_frame_, 0, &render_blocker_,
-                             block_processor_.get(), &block_, &sub_frame_view_);
+  // The render frames are read in place in the queue.
+  while (std::vector<std::vector<float>>* frame =
+             render_transfer_queue_.Front()) {
+    BufferRenderFrameContent(frame, 0, &render_blocker_, block_processor_.get(),
+                             &block_, &sub_frame_view_);
 
     if (sample_rate_hz_ != 8000) {
-      BufferRenderFrameContent(&render_queue_output_frame_, 1, &render_blocker_,
+      BufferRenderFrameContent(frame, 1, &render_blocker_,
                                block_processor_.get(), &block_,
                                &sub_frame_view_);
     }
@@ -512,8 +511,7 @@ void EchoCanceller3::EmptyRenderQueue() {
     BufferRemainingRenderFrameContent(&render_blocker_, block_processor_.get(),
                                       &block_);
 
-    frame_to_buffer =
-        render_transfer_queue_.Remove(&render_queue_output_frame_);
+    render_transfer_queue_.PopFront();
   }
 }
 }  // namespace webrtc
@@ -60,6 +60,9 @@ struct FftData {
         power_spectrum[kFftLengthBy2] = re[kFftLengthBy2] * re[kFftLengthBy2] +
                                         im[kFftLengthBy2] * im[kFftLengthBy2];
       } break;
+      case Aec3Optimization::kAvx2:
+        SpectrumAVX2(power_spectrum);
+        break;
 #endif
       default:
         std::transform(re.begin(), re.end(), im.begin(), power_spectrum.begin(),
@@ -89,6 +92,12 @@ struct FftData {
     }
   }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  // AVX2 and FMA variant of Spectrum(), built with those instructions enabled
+  // in fft_data_avx2.cc.
+  void SpectrumAVX2(rtc::ArrayView<float> power_spectrum) const;
+#endif
+
   std::array<float, kFftLengthBy2Plus1> re;
   std::array<float, kFftLengthBy2Plus1> im;
 };
@@ -24,6 +24,7 @@
 #include <algorithm>
 #include <array>
 #include <functional>
+#include <numeric>
 
 #include "api/array_view.h"
 #include "modules/audio_processing/aec3/aec3_common.h"
@@ -39,7 +40,7 @@ class VectorMath {
       : optimization_(optimization) {}
 
   // Elementwise square root.
-  void Sqrt(rtc::ArrayView<float> x) {
+  void Sqrt(rtc::ArrayView<float> x) const {
     switch (optimization_) {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
       case Aec3Optimization::kSse2: {
@@ -57,6 +58,9 @@ class VectorMath {
           x[j] = sqrtf(x[j]);
         }
       } break;
+      case Aec3Optimization::kAvx2:
+        SqrtAVX2(x);
+        break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
       case Aec3Optimization::kNeon: {
@@ -111,7 +115,7 @@ class VectorMath {
   // Elementwise vector multiplication z = x * y.
   void Multiply(rtc::ArrayView<const float> x,
                 rtc::ArrayView<const float> y,
-                rtc::ArrayView<float> z) {
+                rtc::ArrayView<float> z) const {
     RTC_DCHECK_EQ(z.size(), x.size());
     RTC_DCHECK_EQ(z.size(), y.size());
     switch (optimization_) {
@@ -132,6 +136,9 @@ class VectorMath {
           z[j] = x[j] * y[j];
         }
       } break;
+      case Aec3Optimization::kAvx2:
+        MultiplyAVX2(x, y, z);
+        break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
       case Aec3Optimization::kNeon: {
@@ -158,7 +165,8 @@ class VectorMath {
   }
 
   // Elementwise vector accumulation z += x.
-  void Accumulate(rtc::ArrayView<const float> x, rtc::ArrayView<float> z) {
+  void Accumulate(rtc::ArrayView<const float> x,
+                  rtc::ArrayView<float> z) const {
     RTC_DCHECK_EQ(z.size(), x.size());
     switch (optimization_) {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
@@ -178,6 +186,9 @@ class VectorMath {
           z[j] += x[j];
         }
       } break;
+      case Aec3Optimization::kAvx2:
+        AccumulateAVX2(x, z);
+        break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
       case Aec3Optimization::kNeon: {
@@ -203,7 +214,131 @@ class VectorMath {
     }
   }
 
+  // Returns the dot product of |x| and |y|.
+  float DotProduct(rtc::ArrayView<const float> x,
+                   rtc::ArrayView<const float> y) const {
+    RTC_DCHECK_EQ(x.size(), y.size());
+    switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+      case Aec3Optimization::kSse2: {
+        const int x_size = static_cast<int>(x.size());
+        const int vector_limit = x_size >> 2;
+
+        __m128 sums = _mm_setzero_ps();
+        int j = 0;
+        for (; j < vector_limit * 4; j += 4) {
+          const __m128 x_j = _mm_loadu_ps(&x[j]);
+          const __m128 y_j = _mm_loadu_ps(&y[j]);
+          sums = _mm_add_ps(sums, _mm_mul_ps(x_j, y_j));
+        }
+        sums = _mm_add_ps(sums, _mm_movehl_ps(sums, sums));
+        sums = _mm_add_ss(sums, _mm_shuffle_ps(sums, sums, 0x55));
+        float sum = _mm_cvtss_f32(sums);
+
+        for (; j < x_size; ++j) {
+          sum += x[j] * y[j];
+        }
+        return sum;
+      }
+      case Aec3Optimization::kAvx2:
+        return DotProductAVX2(x, y);
+#endif
+#if defined(WEBRTC_HAS_NEON)
+      case Aec3Optimization::kNeon: {
+        const int x_size = static_cast<int>(x.size());
+        const int vector_limit = x_size >> 2;
+
+        float32x4_t sums = vdupq_n_f32(0.f);
+        int j = 0;
+        for (; j < vector_limit * 4; j += 4) {
+          const float32x4_t x_j = vld1q_f32(&x[j]);
+          const float32x4_t y_j = vld1q_f32(&y[j]);
+          sums = vmlaq_f32(sums, x_j, y_j);
+        }
+        const float32x2_t half_sums =
+            vadd_f32(vget_low_f32(sums), vget_high_f32(sums));
+        float sum = vget_lane_f32(vpadd_f32(half_sums, half_sums), 0);
+
+        for (; j < x_size; ++j) {
+          sum += x[j] * y[j];
+        }
+        return sum;
+      }
+#endif
+      default:
+        return std::inner_product(x.begin(), x.end(), y.begin(), 0.f);
+    }
+  }
+
+  // Elementwise multiply-accumulate y += a * x.
+  void MultiplyAccumulate(float a,
+                          rtc::ArrayView<const float> x,
+                          rtc::ArrayView<float> y) const {
+    RTC_DCHECK_EQ(y.size(), x.size());
+    switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+      case Aec3Optimization::kSse2: {
+        const int x_size = static_cast<int>(x.size());
+        const int vector_limit = x_size >> 2;
+
+        const __m128 a_128 = _mm_set1_ps(a);
+        int j = 0;
+        for (; j < vector_limit * 4; j += 4) {
+          const __m128 x_j = _mm_loadu_ps(&x[j]);
+          __m128 y_j = _mm_loadu_ps(&y[j]);
+          y_j = _mm_add_ps(y_j, _mm_mul_ps(a_128, x_j));
+          _mm_storeu_ps(&y[j], y_j);
+        }
+
+        for (; j < x_size; ++j) {
+          y[j] += a * x[j];
+        }
+      } break;
+      case Aec3Optimization::kAvx2:
+        MultiplyAccumulateAVX2(a, x, y);
+        break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+      case Aec3Optimization::kNeon: {
+        const int x_size = static_cast<int>(x.size());
+        const int vector_limit = x_size >> 2;
+
+        int j = 0;
+        for (; j < vector_limit * 4; j += 4) {
+          const float32x4_t x_j = vld1q_f32(&x[j]);
+          float32x4_t y_j = vld1q_f32(&y[j]);
+          y_j = vmlaq_n_f32(y_j, x_j, a);
+          vst1q_f32(&y[j], y_j);
+        }
+
+        for (; j < x_size; ++j) {
+          y[j] += a * x[j];
+        }
+      } break;
+#endif
+      default:
+        std::transform(x.begin(), x.end(), y.begin(), y.begin(),
+                       [a](float x_j, float y_j) { return y_j + a * x_j; });
+    }
+  }
+
  private:
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  // AVX2 and FMA variants of the above, built with those instructions enabled
+  // in vector_math_avx2.cc.
+  void SqrtAVX2(rtc::ArrayView<float> x) const;
+  void MultiplyAVX2(rtc::ArrayView<const float> x,
+                    rtc::ArrayView<const float> y,
+                    rtc::ArrayView<float> z) const;
+  void AccumulateAVX2(rtc::ArrayView<const float> x,
+                      rtc::ArrayView<float> z) const;
+  float DotProductAVX2(rtc::ArrayView<const float> x,
+                       rtc::ArrayView<const float> y) const;
+  void MultiplyAccumulateAVX2(float a,
+                              rtc::ArrayView<const float> x,
+                              rtc::ArrayView<float> y) const;
+#endif
+
   Aec3Optimization optimization_;
 };
 
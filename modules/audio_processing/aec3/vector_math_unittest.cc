@@ -75,6 +75,40 @@ TEST(VectorMath, Accumulate) {
     EXPECT_FLOAT_EQ(x[k] + 2.f * x[k], z_neon[k]);
   }
 }
+
+TEST(VectorMath, DotProduct) {
+  std::array<float, kFftLengthBy2Plus1> x;
+  std::array<float, kFftLengthBy2Plus1> y;
+
+  for (size_t k = 0; k < x.size(); ++k) {
+    x[k] = (2.f / 3.f) * k / x.size();
+    y[k] = (1.f / 3.f) * k / x.size();
+  }
+
+  const float dot = aec3::VectorMath(Aec3Optimization::kNone).DotProduct(x, y);
+  const float dot_neon =
+      aec3::VectorMath(Aec3Optimization::kNeon).DotProduct(x, y);
+  EXPECT_NEAR(dot, dot_neon, 0.0001f);
+}
+
+TEST(VectorMath, MultiplyAccumulate) {
+  std::array<float, kFftLengthBy2Plus1> x;
+  std::array<float, kFftLengthBy2Plus1> y;
+  std::array<float, kFftLengthBy2Plus1> y_neon;
+
+  for (size_t k = 0; k < x.size(); ++k) {
+    x[k] = k;
+    y[k] = y_neon[k] = 2.f * k;
+  }
+
+  aec3::VectorMath(Aec3Optimization::kNone).MultiplyAccumulate(0.5f, x, y);
+  aec3::VectorMath(Aec3Optimization::kNeon)
+      .MultiplyAccumulate(0.5f, x, y_neon);
+  for (size_t k = 0; k < y.size(); ++k) {
+    EXPECT_FLOAT_EQ(y[k], y_neon[k]);
+    EXPECT_FLOAT_EQ(2.5f * x[k], y_neon[k]);
+  }
+}
 #endif
 
 #if defined(WEBRTC_ARCH_X86_FAMILY)
@@ -141,6 +175,147 @@ TEST(VectorMath, Accumulate) {
     }
   }
 }
+
+TEST(VectorMath, DotProduct) {
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    std::array<float, kFftLengthBy2Plus1> x;
+    std::array<float, kFftLengthBy2Plus1> y;
+
+    for (size_t k = 0; k < x.size(); ++k) {
+      x[k] = (2.f / 3.f) * k / x.size();
+      y[k] = (1.f / 3.f) * k / x.size();
+    }
+
+    const float dot =
+        aec3::VectorMath(Aec3Optimization::kNone).DotProduct(x, y);
+    const float dot_sse2 =
+        aec3::VectorMath(Aec3Optimization::kSse2).DotProduct(x, y);
+    EXPECT_NEAR(dot, dot_sse2, 0.0001f);
+  }
+}
+
+TEST(VectorMath, MultiplyAccumulate) {
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    std::array<float, kFftLengthBy2Plus1> x;
+    std::array<float, kFftLengthBy2Plus1> y;
+    std::array<float, kFftLengthBy2Plus1> y_sse2;
+
+    for (size_t k = 0; k < x.size(); ++k) {
+      x[k] = k;
+      y[k] = y_sse2[k] = 2.f * k;
+    }
+
+    aec3::VectorMath(Aec3Optimization::kNone).MultiplyAccumulate(0.5f, x, y);
+    aec3::VectorMath(Aec3Optimization::kSse2)
+        .MultiplyAccumulate(0.5f, x, y_sse2);
+    for (size_t k = 0; k < y.size(); ++k) {
+      EXPECT_FLOAT_EQ(y[k], y_sse2[k]);
+      EXPECT_FLOAT_EQ(2.5f * x[k], y_sse2[k]);
+    }
+  }
+}
+
+TEST(VectorMath, SqrtAvx2) {
+  if (WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0) {
+    std::array<float, kFftLengthBy2Plus1> x;
+    std::array<float, kFftLengthBy2Plus1> z;
+    std::array<float, kFftLengthBy2Plus1> z_avx2;
+
+    for (size_t k = 0; k < x.size(); ++k) {
+      x[k] = (2.f / 3.f) * k;
+    }
+
+    std::copy(x.begin(), x.end(), z.begin());
+    aec3::VectorMath(Aec3Optimization::kNone).Sqrt(z);
+    std::copy(x.begin(), x.end(), z_avx2.begin());
+    aec3::VectorMath(Aec3Optimization::kAvx2).Sqrt(z_avx2);
+    EXPECT_EQ(z, z_avx2);
+    for (size_t k = 0; k < z.size(); ++k) {
+      EXPECT_FLOAT_EQ(z[k], z_avx2[k]);
+      EXPECT_FLOAT_EQ(sqrtf(x[k]), z_avx2[k]);
+    }
+  }
+}
+
+TEST(VectorMath, MultiplyAvx2) {
+  if (WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0) {
+    std::array<float, kFftLengthBy2Plus1> x;
+    std::array<float, kFftLengthBy2Plus1> y;
+    std::array<float, kFftLengthBy2Plus1> z;
+    std::array<float, kFftLengthBy2Plus1> z_avx2;
+
+    for (size_t k = 0; k < x.size(); ++k) {
+      x[k] = k;
+      y[k] = (2.f / 3.f) * k;
+    }
+
+    aec3::VectorMath(Aec3Optimization::kNone).Multiply(x, y, z);
+    aec3::VectorMath(Aec3Optimization::kAvx2).Multiply(x, y, z_avx2);
+    for (size_t k = 0; k < z.size(); ++k) {
+      EXPECT_FLOAT_EQ(z[k], z_avx2[k]);
+      EXPECT_FLOAT_EQ(x[k] * y[k], z_avx2[k]);
+    }
+  }
+}
+
+TEST(VectorMath, AccumulateAvx2) {
+  if (WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0) {
+    std::array<float, kFftLengthBy2Plus1> x;
+    std::array<float, kFftLengthBy2Plus1> z;
+    std::array<float, kFftLengthBy2Plus1> z_avx2;
+
+    for (size_t k = 0; k < x.size(); ++k) {
+      x[k] = k;
+      z[k] = z_avx2[k] = 2.f * k;
+    }
+
+    aec3::VectorMath(Aec3Optimization::kNone).Accumulate(x, z);
+    aec3::VectorMath(Aec3Optimization::kAvx2).Accumulate(x, z_avx2);
+    for (size_t k = 0; k < z.size(); ++k) {
+      EXPECT_FLOAT_EQ(z[k], z_avx2[k]);
+      EXPECT_FLOAT_EQ(x[k] + 2.f * x[k], z_avx2[k]);
+    }
+  }
+}
+
+TEST(VectorMath, DotProductAvx2) {
+  if (WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0) {
+    std::array<float, kFftLengthBy2Plus1> x;
+    std::array<float, kFftLengthBy2Plus1> y;
+
+    for (size_t k = 0; k < x.size(); ++k) {
+      x[k] = (2.f / 3.f) * k / x.size();
+      y[k] = (1.f / 3.f) * k / x.size();
+    }
+
+    const float dot =
+        aec3::VectorMath(Aec3Optimization::kNone).DotProduct(x, y);
+    const float dot_avx2 =
+        aec3::VectorMath(Aec3Optimization::kAvx2).DotProduct(x, y);
+    EXPECT_NEAR(dot, dot_avx2, 0.0001f);
+  }
+}
+
+TEST(VectorMath, MultiplyAccumulateAvx2) {
+  if (WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0) {
+    std::array<float, kFftLengthBy2Plus1> x;
+    std::array<float, kFftLengthBy2Plus1> y;
+    std::array<float, kFftLengthBy2Plus1> y_avx2;
+
+    for (size_t k = 0; k < x.size(); ++k) {
+      x[k] = k;
+      y[k] = y_avx2[k] = 2.f * k;
+    }
+
+    aec3::VectorMath(Aec3Optimization::kNone).MultiplyAccumulate(0.5f, x, y);
+    aec3::VectorMath(Aec3Optimization::kAvx2)
+        .MultiplyAccumulate(0.5f, x, y_avx2);
+    for (size_t k = 0; k < y.size(); ++k) {
+      EXPECT_FLOAT_EQ(y[k], y_avx2[k]);
+      EXPECT_FLOAT_EQ(2.5f * x[k], y_avx2[k]);
+    }
+  }
+}
 #endif
 
 }  // namespace webrtc
@@ -19,6 +19,7 @@
 #include "modules/audio_processing/agc2/rnn_vad/common.h"
 #include "modules/audio_processing/agc2/rnn_vad/pitch_info.h"
 #include "modules/audio_processing/agc2/rnn_vad/pitch_search_internal.h"
+#include "modules/audio_processing/aec3/vector_math.h"
 
 namespace webrtc {
 namespace rnn_vad {
@@ -26,7 +27,9 @@ namespace rnn_vad {
 // Pitch estimator.
 class PitchEstimator {
  public:
+  // Uses the scalar implementation.
   PitchEstimator();
+  explicit PitchEstimator(Aec3Optimization optimization);
   PitchEstimator(const PitchEstimator&) = delete;
   PitchEstimator& operator=(const PitchEstimator&) = delete;
   ~PitchEstimator();
@@ -35,6 +38,7 @@ class PitchEstimator {
   PitchInfo Estimate(rtc::ArrayView<const float, kBufSize24kHz> pitch_buf);
 
  private:
+  const aec3::VectorMath vector_math_;
   PitchInfo last_pitch_48kHz_;
   std::unique_ptr<RealFourier> fft_;
   std::vector<float> pitch_buf_decimated_;
@@ -18,6 +18,7 @@
 #include "common_audio/real_fourier.h"
 #include "modules/audio_processing/agc2/rnn_vad/common.h"
 #include "modules/audio_processing/agc2/rnn_vad/pitch_info.h"
+#include "modules/audio_processing/aec3/vector_math.h"
 
 namespace webrtc {
 namespace rnn_vad {
@@ -59,7 +60,8 @@ float ComputePitchGainThreshold(size_t candidate_pitch_period,
 // that of "b" to the frame size (e.g., 16 ms and 20 ms respectively).
 void ComputeSlidingFrameSquareEnergies(
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
-    rtc::ArrayView<float, kMaxPitch24kHz + 1> yy_values);
+    rtc::ArrayView<float, kMaxPitch24kHz + 1> yy_values,
+    const aec3::VectorMath& vector_math);
 
 // Computes the auto-correlation coefficients for a given pitch interval.
 // |auto_corr| indexes are inverted lags.
@@ -93,14 +95,16 @@ std::array<size_t, 2> FindBestPitchPeriods(
 // 48 kHz.
 size_t RefinePitchPeriod48kHz(
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
-    rtc::ArrayView<const size_t, 2> inv_lags);
+    rtc::ArrayView<const size_t, 2> inv_lags,
+    const aec3::VectorMath& vector_math);
 
 // Refines the pitch period estimation and compute the pitch gain. Returns the
 // refined pitch estimation data at 48 kHz.
 PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
     size_t initial_pitch_period_48kHz,
-    PitchInfo prev_pitch_48kHz);
+    PitchInfo prev_pitch_48kHz,
+    const aec3::VectorMath& vector_math);
 
 }  // namespace rnn_vad
 }  // namespace webrtc
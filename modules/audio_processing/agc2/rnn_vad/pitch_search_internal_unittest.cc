@@ -111,8 +111,9 @@ TEST(RnnVadTest, ComputeSlidingFrameSquareEnergiesBitExactness) {
   {
     // TODO(bugs.webrtc.org/8948): Add when the issue is fixed.
     // FloatingPointExceptionObserver fpe_observer;
-    ComputeSlidingFrameSquareEnergies(test_data.GetPitchBufView(),
-                                      computed_output);
+    ComputeSlidingFrameSquareEnergies(
+        test_data.GetPitchBufView(), computed_output,
+        aec3::VectorMath(Aec3Optimization::kNone));
   }
   auto square_energies_view = test_data.GetPitchBufSquareEnergiesView();
   ExpectNearAbsolute({square_energies_view.data(), square_energies_view.size()},
@@ -183,15 +184,20 @@ TEST(RnnVadTest, RefinePitchPeriod48kHzBitExactness) {
   TestData test_data;
   std::array<float, kBufSize12kHz> pitch_buf_decimated;
   Decimate2x(test_data.GetPitchBufView(), pitch_buf_decimated);
-  size_t pitch_inv_lag;
-  {
-    // TODO(bugs.webrtc.org/8948): Add when the issue is fixed.
-    // FloatingPointExceptionObserver fpe_observer;
-    const std::array<size_t, 2> pitch_candidates_inv_lags = {280, 284};
-    pitch_inv_lag = RefinePitchPeriod48kHz(test_data.GetPitchBufView(),
-                                           pitch_candidates_inv_lags);
+  for (Aec3Optimization optimization : GetOptimizationsToTest()) {
+    SCOPED_TRACE(static_cast<int>(optimization));
+    size_t pitch_inv_lag;
+    {
+      // TODO(bugs.webrtc.org/8948): Add when the issue is fixed.
+      // FloatingPointExceptionObserver fpe_observer;
+      const std::array<size_t, 2> pitch_candidates_inv_lags = {280, 284};
+      pitch_inv_lag =
+          RefinePitchPeriod48kHz(test_data.GetPitchBufView(),
+                                 pitch_candidates_inv_lags,
+                                 aec3::VectorMath(optimization));
+    }
+    EXPECT_EQ(560u, pitch_inv_lag);
   }
-  EXPECT_EQ(560u, pitch_inv_lag);
 }
 
 class CheckLowerPitchPeriodsAndComputePitchGainTest
@@ -212,7 +218,8 @@ TEST_P(CheckLowerPitchPeriodsAndComputePitchGainTest, BitExactness) {
     // FloatingPointExceptionObserver fpe_observer;
     const auto computed_output = CheckLowerPitchPeriodsAndComputePitchGain(
         test_data.GetPitchBufView(), initial_pitch_period,
-        {prev_pitch_period, prev_pitch_gain});
+        {prev_pitch_period, prev_pitch_gain},
+        aec3::VectorMath(Aec3Optimization::kNone));
     EXPECT_EQ(expected_pitch_period, computed_output.period);
     EXPECT_NEAR(expected_pitch_gain, computed_output.gain, 1e-6f);
   }
@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <vector>
 
 #include "rtc_base/checks.h"
 #include "third_party/rnnoise/src/rnn_activations.h"
@@ -48,24 +49,85 @@ using rnnoise::RectifiedLinearUnit;
 using rnnoise::SigmoidApproximated;
 using rnnoise::TansigApproximated;
 
+namespace {
+
+// Returns |params| scaled by the weights scale and converted to float.
+std::vector<float> ScaleParams(rtc::ArrayView<const int8_t> params) {
+  std::vector<float> scaled_params(params.size());
+  std::transform(params.begin(), params.end(), scaled_params.begin(),
+                 [](int8_t param) { return kWeightsScale * param; });
+  return scaled_params;
+}
+
+// Adds sum_i x[i] * W[i][offset:offset + |y|] to |y|, where W is the weights
+// matrix with |stride| columns read from |float_weights|, if not empty, or
+// from |weights| otherwise. Since the weights scale is a power of two,
+// applying it to x[i] instead of the weights does not change the result.
+void AddWeightedRows(const aec3::VectorMath& vector_math,
+                     rtc::ArrayView<const float> x,
+                     rtc::ArrayView<const int8_t> weights,
+                     rtc::ArrayView<const float> float_weights,
+                     size_t stride,
+                     size_t offset,
+                     rtc::ArrayView<float> y) {
+  if (float_weights.empty()) {
+    std::array<float, 3 * kRecurrentLayersMaxUnits> row;
+    RTC_DCHECK_LE(y.size(), row.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+      const int8_t* weights_row = &weights[i * stride + offset];
+      std::copy(weights_row, weights_row + y.size(), row.begin());
+      vector_math.MultiplyAccumulate(kWeightsScale * x[i],
+                                     {row.data(), y.size()}, y);
+    }
+  } else {
+    for (size_t i = 0; i < x.size(); ++i) {
+      vector_math.MultiplyAccumulate(
+          x[i], float_weights.subview(i * stride + offset, y.size()), y);
+    }
+  }
+}
+
+}  // namespace
+
 FullyConnectedLayer::FullyConnectedLayer(
     const size_t input_size,
     const size_t output_size,
     const rtc::ArrayView<const int8_t> bias,
     const rtc::ArrayView<const int8_t> weights,
     float (*const activation_function)(float))
+    : FullyConnectedLayer(input_size,
+                          output_size,
+                          bias,
+                          weights,
+                          activation_function,
+                          Aec3Optimization::kNone,
+                          WeightsFormat::kFloat) {}
+
+FullyConnectedLayer::FullyConnectedLayer(
+    const size_t input_size,
+    const size_t output_size,
+    const rtc::ArrayView<const int8_t> bias,
+    const rtc::ArrayView<const int8_t> weights,
+    float (*const activation_function)(float),
+    Aec3Optimization optimization,
+    WeightsFormat weights_format)
     : input_size_(input_size),
       output_size_(output_size),
-      bias_(bias),
       weights_(weights),
-      activation_function_(activation_function) {
+      float_weights_(weights_format == WeightsFormat::kFloat
+                         ? ScaleParams(weights)
+                         : std::vector<float>()),
+      activation_function_(activation_function),
+      vector_math_(optimization) {
   RTC_DCHECK_LE(output_size_, kFullyConnectedLayersMaxUnits)
       << "Static over-allocation of fully-connected layers output vectors is "
          "not sufficient.";
-  RTC_DCHECK_EQ(output_size_, bias_.size())
+  RTC_DCHECK_EQ(output_size_, bias.size())
       << "Mismatching output size and bias terms array size.";
   RTC_DCHECK_EQ(input_size_ * output_size_, weights_.size())
       << "Mismatching input-output size and weight coefficients array size.";
+  std::transform(bias.begin(), bias.end(), bias_.begin(),
+                 [](int8_t b) { return kWeightsScale * b; });
 }
 
 FullyConnectedLayer::~FullyConnectedLayer() = default;
@@ -75,16 +137,14 @@ rtc::ArrayView<const float> FullyConnectedLayer::GetOutput() const {
 }
 
 void FullyConnectedLayer::ComputeOutput(rtc::ArrayView<const float> input) {
-  // TODO(bugs.chromium.org/9076): Optimize using SSE/AVX fused multiply-add
-  // operations.
+  RTC_DCHECK_EQ(input_size_, input.size());
+  // The weights are stored input by input, so the layer accumulates the
+  // contribution of each input to all the outputs at once.
+  std::copy(bias_.begin(), bias_.begin() + output_size_, output_.begin());
+  AddWeightedRows(vector_math_, input, weights_, float_weights_, output_size_,
+                  0, {output_.data(), output_size_});
   for (size_t o = 0; o < output_size_; ++o) {
-    output_[o] = bias_[o];
-    // TODO(bugs.chromium.org/9076): Benchmark how different layouts for
-    // |weights_| change the performance across different platforms.
-    for (size_t i = 0; i < input_size_; ++i) {
-      output_[o] += input[i] * weights_[i * output_size_ + o];
-    }
-    output_[o] = (*activation_function_)(kWeightsScale * output_[o]);
+    output_[o] = (*activation_function_)(output_[o]);
   }
 }
 
@@ -95,22 +155,49 @@ GatedRecurrentLayer::GatedRecurrentLayer(
     const rtc::ArrayView<const int8_t> weights,
     const rtc::ArrayView<const int8_t> recurrent_weights,
     float (*const activation_function)(float))
+    : GatedRecurrentLayer(input_size,
+                          output_size,
+                          bias,
+                          weights,
+                          recurrent_weights,
+                          activation_function,
+                          Aec3Optimization::kNone,
+                          WeightsFormat::kFloat) {}
+
+GatedRecurrentLayer::GatedRecurrentLayer(
+    const size_t input_size,
+    const size_t output_size,
+    const rtc::ArrayView<const int8_t> bias,
+    const rtc::ArrayView<const int8_t> weights,
+    const rtc::ArrayView<const int8_t> recurrent_weights,
+    float (*const activation_function)(float),
+    Aec3Optimization optimization,
+    WeightsFormat weights_format)
     : input_size_(input_size),
       output_size_(output_size),
-      bias_(bias),
       weights_(weights),
       recurrent_weights_(recurrent_weights),
-      activation_function_(activation_function) {
+      float_weights_(weights_format == WeightsFormat::kFloat
+                         ? ScaleParams(weights)
+                         : std::vector<float>()),
+      float_recurrent_weights_(weights_format == WeightsFormat::kFloat
+                                   ? ScaleParams(recurrent_weights)
+                                   : std::vector<float>()),
+      activation_function_(activation_function),
+      optimization_(optimization),
+      vector_math_(optimization) {
   RTC_DCHECK_LE(output_size_, kRecurrentLayersMaxUnits)
       << "Static over-allocation of recurrent layers state vectors is not "
       << "sufficient.";
-  RTC_DCHECK_EQ(3 * output_size_, bias_.size())
+  RTC_DCHECK_EQ(3 * output_size_, bias.size())
       << "Mismatching output size and bias terms array size.";
   RTC_DCHECK_EQ(3 * input_size_ * output_size_, weights_.size())
       << "Mismatching input-output size and weight coefficients array size.";
   RTC_DCHECK_EQ(3 * input_size_ * output_size_, recurrent_weights_.size())
       << "Mismatching input-output size and recurrent weight coefficients array"
       << " size.";
+  std::transform(bias.begin(), bias.end(), bias_.begin(),
+                 [](int8_t b) { return kWeightsScale * b; });
   Reset();
 }
 
@@ -125,82 +212,87 @@ void GatedRecurrentLayer::Reset() {
 }
 
 void GatedRecurrentLayer::ComputeOutput(rtc::ArrayView<const float> input) {
-  // TODO(bugs.chromium.org/9076): Optimize using SSE/AVX fused multiply-add
-  // operations.
-  // Stride and offset used to read parameter arrays.
+  RTC_DCHECK_EQ(input_size_, input.size());
+  // Each row of parameters holds the update, reset and output gates one after
+  // the other, so that the gates are computed together.
   const size_t stride = 3 * output_size_;
-  size_t offset = 0;
+  std::array<float, 3 * kRecurrentLayersMaxUnits> gates;
+  std::copy(bias_.begin(), bias_.begin() + stride, gates.begin());
+  rtc::ArrayView<float> update(gates.data(), output_size_);
+  rtc::ArrayView<float> reset(gates.data() + output_size_, output_size_);
+  rtc::ArrayView<float> output(gates.data() + 2 * output_size_, output_size_);
+  const rtc::ArrayView<const float> state(state_.data(), output_size_);
 
-  // Compute update gates.
-  std::array<float, kRecurrentLayersMaxUnits> update;
-  for (size_t o = 0; o < output_size_; ++o) {
-    update[o] = bias_[o];
-    // TODO(bugs.chromium.org/9076): Benchmark how different layouts for
-    // |weights_| and |recurrent_weights_| change the performance across
-    // different platforms.
-    for (size_t i = 0; i < input_size_; ++i) {  // Add input.
-      update[o] += input[i] * weights_[i * stride + o];
-    }
-    for (size_t s = 0; s < output_size_; ++s) {
-      update[o] += state_[s] * recurrent_weights_[s * stride + o];
-    }  // Add state.
-    update[o] = SigmoidApproximated(kWeightsScale * update[o]);
+  // Add the input to all the gates.
+  AddWeightedRows(vector_math_, input, weights_, float_weights_, stride, 0,
+                  {gates.data(), stride});
+  // Add the state to the update and reset gates.
+  AddWeightedRows(vector_math_, state, recurrent_weights_,
+                  float_recurrent_weights_, stride, 0,
+                  {gates.data(), 2 * output_size_});
+  for (size_t o = 0; o < 2 * output_size_; ++o) {
+    gates[o] = SigmoidApproximated(gates[o]);
   }
 
-  // Compute reset gates.
-  offset += output_size_;
-  std::array<float, kRecurrentLayersMaxUnits> reset;
-  for (size_t o = 0; o < output_size_; ++o) {
-    reset[o] = bias_[offset + o];
-    for (size_t i = 0; i < input_size_; ++i) {  // Add input.
-      reset[o] += input[i] * weights_[offset + i * stride + o];
+  // Add the state through the reset gates to the output gates.
+  if (optimization_ == Aec3Optimization::kNone) {
+    // Multiplies in the same order as the reference implementation, so that
+    // the default path stays bitexact.
+    for (size_t s = 0; s < output_size_; ++s) {
+      const size_t row_offset = s * stride + 2 * output_size_;
+      for (size_t o = 0; o < output_size_; ++o) {
+        const float weight =
+            float_recurrent_weights_.empty()
+                ? kWeightsScale * recurrent_weights_[row_offset + o]
+                : float_recurrent_weights_[row_offset + o];
+        output[o] += state_[s] * weight * reset[s];
+      }
     }
-    for (size_t s = 0; s < output_size_; ++s) {  // Add state.
-      reset[o] += state_[s] * recurrent_weights_[offset + s * stride + o];
+  } else {
+    std::array<float, kRecurrentLayersMaxUnits> reset_state;
+    for (size_t s = 0; s < output_size_; ++s) {
+      reset_state[s] = state_[s] * reset[s];
     }
-    reset[o] = SigmoidApproximated(kWeightsScale * reset[o]);
+    AddWeightedRows(vector_math_, {reset_state.data(), output_size_},
+                    recurrent_weights_, float_recurrent_weights_, stride,
+                    2 * output_size_, output);
   }
 
-  // Compute output.
-  offset += output_size_;
-  std::array<float, kRecurrentLayersMaxUnits> output;
+  // Update the state through the update gates. Every output only depends on
+  // its own state element, so the state can be updated in place.
   for (size_t o = 0; o < output_size_; ++o) {
-    output[o] = bias_[offset + o];
-    for (size_t i = 0; i < input_size_; ++i) {  // Add input.
-      output[o] += input[i] * weights_[offset + i * stride + o];
-    }
-    for (size_t s = 0; s < output_size_;
-         ++s) {  // Add state through reset gates.
-      output[o] +=
-          state_[s] * recurrent_weights_[offset + s * stride + o] * reset[s];
-    }
-    output[o] = (*activation_function_)(kWeightsScale * output[o]);
-    // Update output through the update gates.
-    output[o] = update[o] * state_[o] + (1.f - update[o]) * output[o];
+    const float candidate = (*activation_function_)(output[o]);
+    state_[o] = update[o] * state_[o] + (1.f - update[o]) * candidate;
   }
-
-  // Update the state. Not done in the previous loop since that would pollute
-  // the current state and lead to incorrect output values.
-  std::copy(output.begin(), output.end(), state_.begin());
 }
 
 RnnBasedVad::RnnBasedVad()
+    : RnnBasedVad(Aec3Optimization::kNone, WeightsFormat::kFloat) {}
+
+RnnBasedVad::RnnBasedVad(Aec3Optimization optimization,
+                         WeightsFormat weights_format)
     : input_layer_(kInputLayerInputSize,
                    kInputLayerOutputSize,
                    kInputDenseBias,
                    kInputDenseWeights,
-                   TansigApproximated),
+                   TansigApproximated,
+                   optimization,
+                   weights_format),
       hidden_layer_(kInputLayerOutputSize,
                     kHiddenLayerOutputSize,
                     kHiddenGruBias,
                     kHiddenGruWeights,
                     kHiddenGruRecurrentWeights,
-                    RectifiedLinearUnit),
+                    RectifiedLinearUnit,
+                    optimization,
+                    weights_format),
       output_layer_(kHiddenLayerOutputSize,
                     kOutputLayerOutputSize,
                     kOutputDenseBias,
                     kOutputDenseWeights,
-                    SigmoidApproximated) {
+                    SigmoidApproximated,
+                    optimization,
+                    weights_format) {
   // Input-output chaining size checks.
   RTC_DCHECK_EQ(input_layer_.output_size(), hidden_layer_.input_size())
       << "The input and the hidden layers sizes do not match.";
@@ -14,9 +14,11 @@
 #include <stddef.h>
 #include <sys/types.h>
 #include <array>
+#include <vector>
 
 #include "api/array_view.h"
 #include "modules/audio_processing/agc2/rnn_vad/common.h"
+#include "modules/audio_processing/aec3/vector_math.h"
 
 namespace webrtc {
 namespace rnn_vad {
@@ -33,14 +35,32 @@ constexpr size_t kFullyConnectedLayersMaxUnits = 24;
 // recurrent layer.
 constexpr size_t kRecurrentLayersMaxUnits = 24;
 
+// Format in which the layers read their int8 quantized weights.
+enum class WeightsFormat {
+  // The weights are scaled and converted to float when the layer is created.
+  // This is the fastest format, but each layer keeps a float copy of them.
+  kFloat,
+  // The weights are read in place and converted to float while computing the
+  // output. This saves memory when many VADs are instantiated.
+  kInt8
+};
+
 // Fully-connected layer.
 class FullyConnectedLayer {
  public:
+  // Uses the scalar implementation with float weights.
   FullyConnectedLayer(const size_t input_size,
                       const size_t output_size,
                       const rtc::ArrayView<const int8_t> bias,
                       const rtc::ArrayView<const int8_t> weights,
                       float (*const activation_function)(float));
+  FullyConnectedLayer(const size_t input_size,
+                      const size_t output_size,
+                      const rtc::ArrayView<const int8_t> bias,
+                      const rtc::ArrayView<const int8_t> weights,
+                      float (*const activation_function)(float),
+                      Aec3Optimization optimization,
+                      WeightsFormat weights_format);
   FullyConnectedLayer(const FullyConnectedLayer&) = delete;
   FullyConnectedLayer& operator=(const FullyConnectedLayer&) = delete;
   ~FullyConnectedLayer();
@@ -53,9 +73,13 @@ class FullyConnectedLayer {
  private:
   const size_t input_size_;
   const size_t output_size_;
-  const rtc::ArrayView<const int8_t> bias_;
+  // Bias terms scaled by the weights scale.
+  std::array<float, kFullyConnectedLayersMaxUnits> bias_;
   const rtc::ArrayView<const int8_t> weights_;
+  // Scaled weights; empty if the weights are read from |weights_|.
+  const std::vector<float> float_weights_;
   float (*const activation_function_)(float);
+  const aec3::VectorMath vector_math_;
   // The output vector of a recurrent layer has length equal to |output_size_|.
   // However, for efficiency, over-allocation is used.
   std::array<float, kFullyConnectedLayersMaxUnits> output_;
@@ -64,12 +88,21 @@ class FullyConnectedLayer {
 // Recurrent layer with gated recurrent units (GRUs).
 class GatedRecurrentLayer {
  public:
+  // Uses the scalar implementation with float weights.
   GatedRecurrentLayer(const size_t input_size,
                       const size_t output_size,
                       const rtc::ArrayView<const int8_t> bias,
                       const rtc::ArrayView<const int8_t> weights,
                       const rtc::ArrayView<const int8_t> recurrent_weights,
                       float (*const activation_function)(float));
+  GatedRecurrentLayer(const size_t input_size,
+                      const size_t output_size,
+                      const rtc::ArrayView<const int8_t> bias,
+                      const rtc::ArrayView<const int8_t> weights,
+                      const rtc::ArrayView<const int8_t> recurrent_weights,
+                      float (*const activation_function)(float),
+                      Aec3Optimization optimization,
+                      WeightsFormat weights_format);
   GatedRecurrentLayer(const GatedRecurrentLayer&) = delete;
   GatedRecurrentLayer& operator=(const GatedRecurrentLayer&) = delete;
   ~GatedRecurrentLayer();
@@ -83,10 +116,18 @@ class GatedRecurrentLayer {
  private:
   const size_t input_size_;
   const size_t output_size_;
-  const rtc::ArrayView<const int8_t> bias_;
+  // Bias terms of the update, reset and output gates scaled by the weights
+  // scale.
+  std::array<float, 3 * kRecurrentLayersMaxUnits> bias_;
   const rtc::ArrayView<const int8_t> weights_;
   const rtc::ArrayView<const int8_t> recurrent_weights_;
+  // Scaled weights; empty if the weights are read from |weights_| and
+  // |recurrent_weights_|.
+  const std::vector<float> float_weights_;
+  const std::vector<float> float_recurrent_weights_;
   float (*const activation_function_)(float);
+  const Aec3Optimization optimization_;
+  const aec3::VectorMath vector_math_;
   // The state vector of a recurrent layer has length equal to |output_size_|.
   // However, to avoid dynamic allocation, over-allocation is used.
   std::array<float, kRecurrentLayersMaxUnits> state_;
@@ -95,7 +136,10 @@ class GatedRecurrentLayer {
 // Recurrent network based VAD.
 class RnnBasedVad {
  public:
+  // Uses the scalar implementation with float weights, which is bitexact with
+  // the reference. The SIMD optimizations change the results slightly.
   RnnBasedVad();
+  RnnBasedVad(Aec3Optimization optimization, WeightsFormat weights_format);
   RnnBasedVad(const RnnBasedVad&) = delete;
   RnnBasedVad& operator=(const RnnBasedVad&) = delete;
   ~RnnBasedVad();
@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "modules/audio_processing/agc2/rnn_vad/common.h"
+#include "modules/audio_processing/agc2/rnn_vad/pitch_search.h"
+#include "modules/audio_processing/agc2/rnn_vad/rnn.h"
+#include "modules/audio_processing/agc2/rnn_vad/test_utils.h"
+#include "modules/audio_processing/aec3/vector_math.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace rnn_vad {
+namespace test {
+namespace {
+
+constexpr size_t kNumFrames = 100;
+constexpr int kNumIterations = 20;
+
+// Returns the CPU time in us per frame of |process|, which processes
+// |kNumFrames| frames.
+template <typename Process>
+double MeasureUsPerFrame(Process process) {
+  process();
+  const int64_t start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+  for (int i = 0; i < kNumIterations; ++i) {
+    process();
+  }
+  return static_cast<double>(rtc::GetThreadCpuTimeNanos() - start_cpu_ns) /
+         (kNumIterations * kNumFrames) / 1000.0;
+}
+
+std::string OptimizationToString(Aec3Optimization optimization) {
+  switch (optimization) {
+    case Aec3Optimization::kNone:
+      return "none";
+    case Aec3Optimization::kSse2:
+      return "sse2";
+    case Aec3Optimization::kAvx2:
+      return "avx2";
+    case Aec3Optimization::kNeon:
+      return "neon";
+  }
+  return "";
+}
+
+std::string WeightsFormatToString(WeightsFormat weights_format) {
+  return weights_format == WeightsFormat::kFloat ? "float_weights"
+                                                 : "int8_weights";
+}
+
+}  // namespace
+
+// Measures the per-frame cost of the RNN for every optimization and weights
+// format.
+TEST(RnnVadPerformanceTest, Rnn) {
+  Random random_generator(42U);
+  std::vector<std::array<float, kFeatureVectorSize>> feature_vectors(
+      kNumFrames);
+  for (auto& feature_vector : feature_vectors) {
+    for (float& feature : feature_vector) {
+      feature = 4.f * random_generator.Rand<float>() - 2.f;
+    }
+  }
+
+  for (Aec3Optimization optimization : GetOptimizationsToTest()) {
+    for (WeightsFormat weights_format :
+         {WeightsFormat::kFloat, WeightsFormat::kInt8}) {
+      RnnBasedVad vad(optimization, weights_format);
+      float vad_probability = 0.f;
+      webrtc::test::PrintResult(
+          "rnn_vad_rnn_cpu_time", "",
+          OptimizationToString(optimization) + "_" +
+              WeightsFormatToString(weights_format),
+          MeasureUsPerFrame([&] {
+            for (const auto& feature_vector : feature_vectors) {
+              vad_probability +=
+                  vad.ComputeVadProbability(feature_vector, false);
+            }
+          }),
+          "us", false);
+      // Prevents the computation from being optimized away.
+      EXPECT_LE(0.f, vad_probability);
+    }
+  }
+}
+
+// Measures the per-frame cost of the pitch search for every optimization.
+TEST(RnnVadPerformanceTest, PitchSearch) {
+  Random random_generator(42U);
+  std::vector<std::array<float, kBufSize24kHz>> pitch_buffers(kNumFrames);
+  for (auto& pitch_buffer : pitch_buffers) {
+    for (float& sample : pitch_buffer) {
+      sample = static_cast<float>(random_generator.Rand(-10000, 10000));
+    }
+  }
+
+  for (Aec3Optimization optimization : GetOptimizationsToTest()) {
+    PitchEstimator pitch_estimator(optimization);
+    size_t pitch_periods_sum = 0;
+    webrtc::test::PrintResult(
+        "rnn_vad_pitch_search_cpu_time", "", OptimizationToString(optimization),
+        MeasureUsPerFrame([&] {
+          for (const auto& pitch_buffer : pitch_buffers) {
+            pitch_periods_sum += pitch_estimator.Estimate(pitch_buffer).period;
+          }
+        }),
+        "us", false);
+    EXPECT_LT(0u, pitch_periods_sum);
+  }
+}
+
+}  // namespace test
+}  // namespace rnn_vad
+}  // namespace webrtc
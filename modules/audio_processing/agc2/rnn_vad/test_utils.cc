@@ -46,6 +46,23 @@ void ExpectNearAbsolute(rtc::ArrayView<const float> expected,
   }
 }
 
+std::vector<Aec3Optimization> GetOptimizationsToTest() {
+  std::vector<Aec3Optimization> optimizations = {Aec3Optimization::kNone};
+  switch (DetectOptimization()) {
+    case Aec3Optimization::kAvx2:
+      optimizations.push_back(Aec3Optimization::kSse2);
+      optimizations.push_back(Aec3Optimization::kAvx2);
+      break;
+    case Aec3Optimization::kSse2:
+    case Aec3Optimization::kNeon:
+      optimizations.push_back(DetectOptimization());
+      break;
+    case Aec3Optimization::kNone:
+      break;
+  }
+  return optimizations;
+}
+
 std::unique_ptr<BinaryFileReader<float>> CreatePitchSearchTestDataReader() {
   constexpr size_t cols = 1396;
   return absl::make_unique<BinaryFileReader<float>>(
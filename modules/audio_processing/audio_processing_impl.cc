@@ -992,13 +992,13 @@ void AudioProcessingImpl::AllocateRenderQueue() {
         aec_render_queue_element_max_size_);
 
     aec_render_signal_queue_.reset(
-        new SwapQueue<std::vector<float>, RenderQueueItemVerifier<float>>(
+        new LockFreeSwapQueue<std::vector<float>,
+                              RenderQueueItemVerifier<float>>(
             kMaxNumFramesToBuffer, template_queue_element,
             RenderQueueItemVerifier<float>(
                 aec_render_queue_element_max_size_)));
 
     aec_render_queue_buffer_.resize(aec_render_queue_element_max_size_);
-    aec_capture_queue_buffer_.resize(aec_render_queue_element_max_size_);
   } else {
     aec_render_signal_queue_->Clear();
   }
@@ -1012,13 +1012,13 @@ void AudioProcessingImpl::AllocateRenderQueue() {
         aecm_render_queue_element_max_size_);
 
     aecm_render_signal_queue_.reset(
-        new SwapQueue<std::vector<int16_t>, RenderQueueItemVerifier<int16_t>>(
+        new LockFreeSwapQueue<std::vector<int16_t>,
+                              RenderQueueItemVerifier<int16_t>>(
             kMaxNumFramesToBuffer, template_queue_element,
             RenderQueueItemVerifier<int16_t>(
                 aecm_render_queue_element_max_size_)));
 
     aecm_render_queue_buffer_.resize(aecm_render_queue_element_max_size_);
-    aecm_capture_queue_buffer_.resize(aecm_render_queue_element_max_size_);
   } else {
     aecm_render_signal_queue_->Clear();
   }
@@ -1031,13 +1031,13 @@ void AudioProcessingImpl::AllocateRenderQueue() {
         agc_render_queue_element_max_size_);
 
     agc_render_signal_queue_.reset(
-        new SwapQueue<std::vector<int16_t>, RenderQueueItemVerifier<int16_t>>(
+        new LockFreeSwapQueue<std::vector<int16_t>,
+                              RenderQueueItemVerifier<int16_t>>(
             kMaxNumFramesToBuffer, template_queue_element,
             RenderQueueItemVerifier<int16_t>(
                 agc_render_queue_element_max_size_)));
 
     agc_render_queue_buffer_.resize(agc_render_queue_element_max_size_);
-    agc_capture_queue_buffer_.resize(agc_render_queue_element_max_size_);
   } else {
     agc_render_signal_queue_->Clear();
   }
@@ -1050,13 +1050,13 @@ void AudioProcessingImpl::AllocateRenderQueue() {
         red_render_queue_element_max_size_);
 
     red_render_signal_queue_.reset(
-        new SwapQueue<std::vector<float>, RenderQueueItemVerifier<float>>(
+        new LockFreeSwapQueue<std::vector<float>,
+                              RenderQueueItemVerifier<float>>(
             kMaxNumFramesToBuffer, template_queue_element,
             RenderQueueItemVerifier<float>(
                 red_render_queue_element_max_size_)));
 
     red_render_queue_buffer_.resize(red_render_queue_element_max_size_);
-    red_capture_queue_buffer_.resize(red_render_queue_element_max_size_);
   } else {
     red_render_signal_queue_->Clear();
   }
@@ -1064,25 +1064,29 @@ void AudioProcessingImpl::AllocateRenderQueue() {
 
 void AudioProcessingImpl::EmptyQueuedRenderAudio() {
   rtc::CritScope cs_capture(&crit_capture_);
-  while (aec_render_signal_queue_->Remove(&aec_capture_queue_buffer_)) {
-    private_submodules_->echo_cancellation->ProcessRenderAudio(
-        aec_capture_queue_buffer_);
+  // The queued frames are processed in place, and then handed back to the
+  // render side for reuse.
+  while (const std::vector<float>* frame = aec_render_signal_queue_->Front()) {
+    private_submodules_->echo_cancellation->ProcessRenderAudio(*frame);
+    aec_render_signal_queue_->PopFront();
   }
 
-  while (aecm_render_signal_queue_->Remove(&aecm_capture_queue_buffer_)) {
-    private_submodules_->echo_control_mobile->ProcessRenderAudio(
-        aecm_capture_queue_buffer_);
+  while (const std::vector<int16_t>* frame =
+             aecm_render_signal_queue_->Front()) {
+    private_submodules_->echo_control_mobile->ProcessRenderAudio(*frame);
+    aecm_render_signal_queue_->PopFront();
   }
 
-  while (agc_render_signal_queue_->Remove(&agc_capture_queue_buffer_)) {
-    public_submodules_->gain_control->ProcessRenderAudio(
-        agc_capture_queue_buffer_);
+  while (const std::vector<int16_t>* frame =
+             agc_render_signal_queue_->Front()) {
+    public_submodules_->gain_control->ProcessRenderAudio(*frame);
+    agc_render_signal_queue_->PopFront();
   }
 
-  while (red_render_signal_queue_->Remove(&red_capture_queue_buffer_)) {
+  while (const std::vector<float>* frame = red_render_signal_queue_->Front()) {
     RTC_DCHECK(private_submodules_->echo_detector);
-    private_submodules_->echo_detector->AnalyzeRenderAudio(
-        red_capture_queue_buffer_);
+    private_submodules_->echo_detector->AnalyzeRenderAudio(*frame);
+    red_render_signal_queue_->PopFront();
   }
 }
 
@@ -25,6 +25,7 @@
 #include "rtc_base/function_view.h"
 #include "rtc_base/gtest_prod_util.h"
 #include "rtc_base/ignore_wundef.h"
+#include "rtc_base/lock_free_swap_queue.h"
 #include "rtc_base/swap_queue.h"
 #include "rtc_base/thread_annotations.h"
 
@@ -418,37 +419,36 @@ class AudioProcessingImpl : public AudioProcessing {
   size_t aec_render_queue_element_max_size_ RTC_GUARDED_BY(crit_render_)
       RTC_GUARDED_BY(crit_capture_) = 0;
   std::vector<float> aec_render_queue_buffer_ RTC_GUARDED_BY(crit_render_);
-  std::vector<float> aec_capture_queue_buffer_ RTC_GUARDED_BY(crit_capture_);
 
   size_t aecm_render_queue_element_max_size_ RTC_GUARDED_BY(crit_render_)
       RTC_GUARDED_BY(crit_capture_) = 0;
   std::vector<int16_t> aecm_render_queue_buffer_ RTC_GUARDED_BY(crit_render_);
-  std::vector<int16_t> aecm_capture_queue_buffer_ RTC_GUARDED_BY(crit_capture_);
 
   size_t agc_render_queue_element_max_size_ RTC_GUARDED_BY(crit_render_)
       RTC_GUARDED_BY(crit_capture_) = 0;
   std::vector<int16_t> agc_render_queue_buffer_ RTC_GUARDED_BY(crit_render_);
-  std::vector<int16_t> agc_capture_queue_buffer_ RTC_GUARDED_BY(crit_capture_);
 
   size_t red_render_queue_element_max_size_ RTC_GUARDED_BY(crit_render_)
       RTC_GUARDED_BY(crit_capture_) = 0;
   std::vector<float> red_render_queue_buffer_ RTC_GUARDED_BY(crit_render_);
-  std::vector<float> red_capture_queue_buffer_ RTC_GUARDED_BY(crit_capture_);
 
   RmsLevel capture_input_rms_ RTC_GUARDED_BY(crit_capture_);
   RmsLevel capture_output_rms_ RTC_GUARDED_BY(crit_capture_);
   int capture_rms_interval_counter_ RTC_GUARDED_BY(crit_capture_) = 0;
 
-  // Lock protection not needed.
-  std::unique_ptr<SwapQueue<std::vector<float>, RenderQueueItemVerifier<float>>>
+  // Lock protection not needed. The render thread is the only producer, and
+  // the consumers run under |crit_capture_|.
+  std::unique_ptr<
+      LockFreeSwapQueue<std::vector<float>, RenderQueueItemVerifier<float>>>
       aec_render_signal_queue_;
   std::unique_ptr<
-      SwapQueue<std::vector<int16_t>, RenderQueueItemVerifier<int16_t>>>
+      LockFreeSwapQueue<std::vector<int16_t>, RenderQueueItemVerifier<int16_t>>>
       aecm_render_signal_queue_;
   std::unique_ptr<
-      SwapQueue<std::vector<int16_t>, RenderQueueItemVerifier<int16_t>>>
+      LockFreeSwapQueue<std::vector<int16_t>, RenderQueueItemVerifier<int16_t>>>
       agc_render_signal_queue_;
-  std::unique_ptr<SwapQueue<std::vector<float>, RenderQueueItemVerifier<float>>>
+  std::unique_ptr<
+      LockFreeSwapQueue<std::vector<float>, RenderQueueItemVerifier<float>>>
       red_render_signal_queue_;
 };
 
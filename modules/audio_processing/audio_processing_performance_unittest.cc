@@ -219,6 +219,15 @@ class TimedThreadApiProcessor {
         "apm_timing", sample_rate_name, processor_name, GetDurationAverage(),
         GetDurationStandardDeviation(), "us", false);
 
+    // The tail of the durations shows how much the render and capture calls
+    // block each other.
+    const int kPercentiles[] = {50, 90, 99, 100};
+    for (int percentile : kPercentiles) {
+      webrtc::test::PrintResult(
+          "apm_timing_p" + std::to_string(percentile), sample_rate_name,
+          processor_name, GetDurationPercentile(percentile), "us", false);
+    }
+
     if (kPrintAllDurations) {
       webrtc::test::PrintResultList("apm_call_durations", sample_rate_name,
                                     processor_name, api_call_durations_, "us",
@@ -252,6 +261,23 @@ class TimedThreadApiProcessor {
                 : -1);
   }
 
+  // Returns the smallest duration that is at least as large as |percentile|
+  // percent of the durations.
+  int64_t GetDurationPercentile(int percentile) const {
+    if (api_call_durations_.size() <=
+        static_cast<size_t>(kNumInitializationFrames)) {
+      return -1;
+    }
+    std::vector<double> durations(
+        api_call_durations_.begin() + kNumInitializationFrames,
+        api_call_durations_.end());
+    const size_t index =
+        std::max<size_t>((durations.size() * percentile + 99) / 100, 1) - 1;
+    std::nth_element(durations.begin(), durations.begin() + index,
+                     durations.end());
+    return rtc::checked_cast<int64_t>(durations[index]);
+  }
+
   int64_t GetDurationAverage() const {
     int64_t average_duration = 0;
     for (size_t k = kNumInitializationFrames; k < api_call_durations_.size();
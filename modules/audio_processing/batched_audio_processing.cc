@@ -0,0 +1,223 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/batched_audio_processing.h"
+
+#include <algorithm>
+
+#include "common_audio/include/audio_util.h"
+#include "modules/audio_processing/agc2/adaptive_agc.h"
+#include "modules/audio_processing/agc2/gain_applier.h"
+#include "modules/audio_processing/agc2/limiter.h"
+#include "modules/audio_processing/audio_buffer.h"
+#include "modules/audio_processing/gain_controller2.h"
+#include "modules/audio_processing/include/audio_frame_view.h"
+#include "modules/audio_processing/logging/apm_data_dumper.h"
+#include "modules/audio_processing/noise_suppression_impl.h"
+#include "rtc_base/atomicops.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+
+namespace webrtc {
+namespace {
+
+bool ValidSampleRate(int sample_rate_hz) {
+  return sample_rate_hz == AudioProcessing::kSampleRate8kHz ||
+         sample_rate_hz == AudioProcessing::kSampleRate16kHz ||
+         sample_rate_hz == AudioProcessing::kSampleRate32kHz ||
+         sample_rate_hz == AudioProcessing::kSampleRate48kHz;
+}
+
+}  // namespace
+
+// The streams of one shard. The fixed digital gain is the same for all streams
+// and is applied to all of them at once, while the adaptive digital gain and
+// the limiter depend on the level of each stream.
+class BatchedAudioProcessing::Shard {
+ public:
+  Shard(const Config& config, size_t num_frames, size_t num_streams)
+      : stream_config_(config.sample_rate_hz, num_streams),
+        split_bands_(config.noise_suppression_enabled &&
+                     config.sample_rate_hz >
+                         AudioProcessing::kSampleRate16kHz),
+        audio_(num_frames, num_streams, num_frames, num_streams, num_frames),
+        noise_suppression_(&crit_),
+        data_dumper_(rtc::AtomicOps::Increment(&instance_count_)),
+        gain_controller2_config_(config.gain_controller2),
+        gain_applier_(/*hard_clip_samples=*/false,
+                      /*initial_gain_factor=*/0.f) {
+    noise_suppression_.Enable(config.noise_suppression_enabled);
+    noise_suppression_.set_level(config.noise_suppression_level);
+    noise_suppression_.Initialize(num_streams, config.sample_rate_hz);
+    if (gain_controller2_config_.enabled) {
+      gain_applier_.SetGainFactor(
+          DbToRatio(gain_controller2_config_.fixed_digital.gain_db));
+      gain_controllers_.reserve(num_streams);
+      for (size_t i = 0; i < num_streams; ++i) {
+        gain_controllers_.emplace_back(new StreamGainController(
+            config.sample_rate_hz, gain_controller2_config_, &data_dumper_));
+      }
+    }
+  }
+
+  size_t num_streams() const { return stream_config_.num_channels(); }
+
+  // Processes the frames of the streams of the shard, in the same order as
+  // done by AudioProcessingImpl.
+  void Process(float* const* streams) {
+    audio_.CopyFrom(streams, stream_config_);
+    if (split_bands_) {
+      audio_.SplitIntoFrequencyBands();
+    }
+    noise_suppression_.AnalyzeCaptureAudio(&audio_);
+    noise_suppression_.ProcessCaptureAudio(&audio_);
+    if (split_bands_) {
+      audio_.MergeFrequencyBands();
+    }
+    if (gain_controller2_config_.enabled) {
+      gain_applier_.ApplyGain(AudioFrameView<float>(
+          audio_.channels_f(), audio_.num_channels(), audio_.num_frames()));
+      for (size_t i = 0; i < gain_controllers_.size(); ++i) {
+        gain_controllers_[i]->Process(
+            AudioFrameView<float>(&audio_.channels_f()[i], 1,
+                                  audio_.num_frames()),
+            gain_controller2_config_.adaptive_digital.enabled);
+      }
+    }
+    audio_.CopyTo(stream_config_, streams);
+  }
+
+ private:
+  class StreamGainController {
+   public:
+    StreamGainController(
+        int sample_rate_hz,
+        const AudioProcessing::Config::GainController2& config,
+        ApmDataDumper* data_dumper)
+        : adaptive_agc_(data_dumper, config),
+          limiter_(static_cast<size_t>(sample_rate_hz), data_dumper, "Agc2") {}
+
+    void Process(AudioFrameView<float> frame, bool adaptive) {
+      if (adaptive) {
+        adaptive_agc_.Process(frame, limiter_.LastAudioLevel());
+      }
+      limiter_.Process(frame);
+    }
+
+   private:
+    AdaptiveAgc adaptive_agc_;
+    Limiter limiter_;
+  };
+
+  static int instance_count_;
+  const StreamConfig stream_config_;
+  const bool split_bands_;
+  AudioBuffer audio_;
+  rtc::CriticalSection crit_;
+  NoiseSuppressionImpl noise_suppression_;
+  ApmDataDumper data_dumper_;
+  const AudioProcessing::Config::GainController2 gain_controller2_config_;
+  GainApplier gain_applier_;
+  std::vector<std::unique_ptr<StreamGainController>> gain_controllers_;
+};
+
+int BatchedAudioProcessing::Shard::instance_count_ = 0;
+
+// Processes one shard per call of ProcessStreams() on a thread of its own.
+class BatchedAudioProcessing::Worker {
+ public:
+  explicit Worker(Shard* shard)
+      : shard_(shard),
+        thread_(&Worker::Run,
+                this,
+                "BatchedApmWorker",
+                rtc::kRealtimePriority) {
+    thread_.Start();
+  }
+
+  ~Worker() {
+    quit_ = true;
+    start_.Set();
+    thread_.Stop();
+  }
+
+  void Start(float* const* streams) {
+    streams_ = streams;
+    start_.Set();
+  }
+
+  void WaitUntilDone() { done_.Wait(rtc::Event::kForever); }
+
+ private:
+  static void Run(void* obj) { static_cast<Worker*>(obj)->Loop(); }
+
+  void Loop() {
+    while (true) {
+      start_.Wait(rtc::Event::kForever);
+      if (quit_) {
+        return;
+      }
+      shard_->Process(streams_);
+      done_.Set();
+    }
+  }
+
+  Shard* const shard_;
+  // Written before |start_| is set and read after it has been waited for.
+  float* const* streams_ = nullptr;
+  bool quit_ = false;
+  rtc::Event start_;
+  rtc::Event done_;
+  rtc::PlatformThread thread_;
+};
+
+BatchedAudioProcessing::BatchedAudioProcessing(const Config& config)
+    : config_(config),
+      num_frames_(rtc::CheckedDivExact(config.sample_rate_hz, 100)) {
+  RTC_CHECK(ValidSampleRate(config_.sample_rate_hz));
+  RTC_CHECK_GT(config_.num_streams, 0);
+  RTC_CHECK(!config_.gain_controller2.enabled ||
+            GainController2::Validate(config_.gain_controller2));
+
+  // Spread the streams as evenly as possible over the shards.
+  const size_t num_shards =
+      std::max<size_t>(1, std::min(config_.num_threads, config_.num_streams));
+  for (size_t i = 0; i < num_shards; ++i) {
+    const size_t begin = i * config_.num_streams / num_shards;
+    const size_t end = (i + 1) * config_.num_streams / num_shards;
+    shards_.emplace_back(new Shard(config_, num_frames_, end - begin));
+  }
+  for (size_t i = 1; i < num_shards; ++i) {
+    workers_.emplace_back(new Worker(shards_[i].get()));
+  }
+}
+
+BatchedAudioProcessing::~BatchedAudioProcessing() {
+  // The workers must be stopped before the shards that they process.
+  workers_.clear();
+}
+
+void BatchedAudioProcessing::ProcessStreams(
+    rtc::ArrayView<float* const> streams) {
+  RTC_DCHECK_EQ(config_.num_streams, streams.size());
+  size_t begin = shards_[0]->num_streams();
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i]->Start(&streams[begin]);
+    begin += shards_[i + 1]->num_streams();
+  }
+  shards_[0]->Process(streams.data());
+  for (auto& worker : workers_) {
+    worker->WaitUntilDone();
+  }
+}
+
+}  // namespace webrtc
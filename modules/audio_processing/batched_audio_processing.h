@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_BATCHED_AUDIO_PROCESSING_H_
+#define MODULES_AUDIO_PROCESSING_BATCHED_AUDIO_PROCESSING_H_
+
+#include <memory>
+#include <vector>
+
+#include "api/array_view.h"
+#include "modules/audio_processing/include/audio_processing.h"
+#include "rtc_base/constructormagic.h"
+
+namespace webrtc {
+
+// Capture side processing of many independent mono streams, e.g. all the
+// participants of a server side conference, with one call per 10 ms.
+//
+// Instead of one AudioProcessing instance per stream, the streams are split
+// into contiguous shards. Each shard keeps the samples, the band split signals
+// and the splitting filter states of all its streams in shared channel
+// buffers, with one stream per channel, and runs each submodule over all of
+// its streams before moving on to the next submodule. One shard is processed
+// on the calling thread and each of the others on a worker thread of its own.
+//
+// Only noise suppression and the gain controller 2 are supported. The state of
+// each stream is independent of the other streams in the batch.
+class BatchedAudioProcessing {
+ public:
+  struct Config {
+    int sample_rate_hz = AudioProcessing::kSampleRate48kHz;
+    size_t num_streams = 1;
+    // Number of shards, including the one processed on the calling thread.
+    // Clamped to |num_streams|.
+    size_t num_threads = 1;
+    bool noise_suppression_enabled = true;
+    NoiseSuppression::Level noise_suppression_level =
+        NoiseSuppression::kModerate;
+    AudioProcessing::Config::GainController2 gain_controller2;
+  };
+
+  explicit BatchedAudioProcessing(const Config& config);
+  ~BatchedAudioProcessing();
+
+  // Processes one 10 ms frame of every stream in place. |streams| must hold
+  // |num_streams| deinterleaved frames of |num_frames| samples in [-1, 1].
+  void ProcessStreams(rtc::ArrayView<float* const> streams);
+
+  size_t num_streams() const { return config_.num_streams; }
+  size_t num_frames() const { return num_frames_; }
+  size_t num_threads() const { return shards_.size(); }
+
+ private:
+  class Shard;
+  class Worker;
+
+  const Config config_;
+  const size_t num_frames_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  // One per shard but the first.
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(BatchedAudioProcessing);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_BATCHED_AUDIO_PROCESSING_H_
@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "modules/audio_processing/batched_audio_processing.h"
+#include "modules/audio_processing/include/audio_processing.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/random.h"
+#include "rtc_base/timeutils.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kSampleRateHz = 48000;
+constexpr size_t kNumFrames = kSampleRateHz / 100;
+constexpr size_t kNumStreams = 256;
+constexpr int kNumIterations = 200;
+constexpr float kFrameDurationNs = 10e6f;
+
+// Holds one frame of random noise per stream. The frames are restored before
+// each call since they are processed in place, and repeatedly suppressing the
+// same frame would soon lead to denormal samples.
+class StreamFrames {
+ public:
+  explicit StreamFrames(size_t num_streams)
+      : input_(num_streams * kNumFrames),
+        samples_(input_.size()),
+        streams_(num_streams) {
+    Random random_generator(42U);
+    for (auto& sample : input_) {
+      sample = 0.1f * (2.f * random_generator.Rand<float>() - 1.f);
+    }
+    for (size_t i = 0; i < num_streams; ++i) {
+      streams_[i] = &samples_[i * kNumFrames];
+    }
+  }
+
+  std::vector<float*>& Restore() {
+    std::copy(input_.begin(), input_.end(), samples_.begin());
+    return streams_;
+  }
+
+ private:
+  std::vector<float> input_;
+  std::vector<float> samples_;
+  std::vector<float*> streams_;
+};
+
+AudioProcessing::Config::GainController2 CreateGainController2Config() {
+  AudioProcessing::Config::GainController2 config;
+  config.enabled = true;
+  config.fixed_digital.gain_db = 6.f;
+  config.adaptive_digital.enabled = true;
+  return config;
+}
+
+// Reports the number of streams that one core can process in real time, given
+// the process CPU time spent on |kNumIterations| calls of |process|, as well as
+// the wall clock time per call.
+template <typename Process>
+void MeasureAndPrint(const std::string& trace, Process process) {
+  process();
+  const int64_t start_cpu_ns = rtc::GetProcessCpuTimeNanos();
+  const int64_t start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kNumIterations; ++i) {
+    process();
+  }
+  const double cpu_ns_per_call =
+      static_cast<double>(rtc::GetProcessCpuTimeNanos() - start_cpu_ns) /
+      kNumIterations;
+  const double ns_per_call =
+      static_cast<double>(rtc::TimeNanos() - start_ns) / kNumIterations;
+  test::PrintResult("batched_apm_streams_per_core", "", trace,
+                    kNumStreams * kFrameDurationNs / cpu_ns_per_call,
+                    "streams", false);
+  test::PrintResult("batched_apm_wall_time", "", trace, ns_per_call / 1000.0,
+                    "us", false);
+}
+
+}  // namespace
+
+// Runs one AudioProcessing instance per stream, as a reference.
+TEST(BatchedAudioProcessingPerformanceTest, IndependentInstances) {
+  AudioProcessing::Config config;
+  config.gain_controller2 = CreateGainController2Config();
+  std::vector<std::unique_ptr<AudioProcessing>> apms;
+  for (size_t i = 0; i < kNumStreams; ++i) {
+    apms.emplace_back(AudioProcessingBuilder().Create());
+    apms.back()->ApplyConfig(config);
+    apms.back()->noise_suppression()->Enable(true);
+  }
+  StreamFrames frames(kNumStreams);
+  const StreamConfig stream_config(kSampleRateHz, 1);
+  MeasureAndPrint("independent_instances", [&] {
+    std::vector<float*>& streams = frames.Restore();
+    for (size_t i = 0; i < kNumStreams; ++i) {
+      float* const* stream = &streams[i];
+      apms[i]->ProcessStream(stream, stream_config, stream_config, stream);
+    }
+  });
+}
+
+TEST(BatchedAudioProcessingPerformanceTest, Batched) {
+  for (size_t num_threads : {1, 2, 4}) {
+    BatchedAudioProcessing::Config config;
+    config.sample_rate_hz = kSampleRateHz;
+    config.num_streams = kNumStreams;
+    config.num_threads = num_threads;
+    config.gain_controller2 = CreateGainController2Config();
+    BatchedAudioProcessing apm(config);
+    StreamFrames frames(kNumStreams);
+    MeasureAndPrint("batched_" + std::to_string(num_threads) + "_threads",
+                    [&] { apm.ProcessStreams(frames.Restore()); });
+  }
+}
+
+}  // namespace webrtc
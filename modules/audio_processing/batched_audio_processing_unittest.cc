@@ -0,0 +1,177 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "modules/audio_processing/batched_audio_processing.h"
+#include "rtc_base/random.h"
+#include "rtc_base/system/arch.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kNumFramesToProcess = 100;
+
+BatchedAudioProcessing::Config CreateConfig(int sample_rate_hz,
+                                            size_t num_streams,
+                                            size_t num_threads) {
+  BatchedAudioProcessing::Config config;
+  config.sample_rate_hz = sample_rate_hz;
+  config.num_streams = num_streams;
+  config.num_threads = num_threads;
+  config.noise_suppression_enabled = true;
+  config.gain_controller2.enabled = true;
+  config.gain_controller2.fixed_digital.gain_db = 6.f;
+  config.gain_controller2.adaptive_digital.enabled = true;
+  return config;
+}
+
+// Generates noise in [-|amplitude|, |amplitude|] whose seed depends on the
+// stream, so that each stream has its own content.
+void GenerateFrame(size_t stream, int frame, float amplitude, float* x,
+                   size_t num_frames) {
+  Random random_generator(1 + 1000 * stream + frame);
+  for (size_t k = 0; k < num_frames; ++k) {
+    x[k] = amplitude * (2.f * random_generator.Rand<float>() - 1.f);
+  }
+}
+
+float Amplitude(size_t stream) {
+  return 0.001f + 0.1f * (stream % 5);
+}
+
+// Processes |kNumFramesToProcess| frames of |num_streams| streams and returns
+// the last output frame of each stream.
+std::vector<std::vector<float>> ProcessStreams(
+    const BatchedAudioProcessing::Config& config,
+    size_t first_stream) {
+  BatchedAudioProcessing apm(config);
+  std::vector<std::vector<float>> frames(
+      config.num_streams, std::vector<float>(apm.num_frames()));
+  std::vector<float*> streams(config.num_streams);
+  for (size_t i = 0; i < frames.size(); ++i) {
+    streams[i] = frames[i].data();
+  }
+  for (int frame = 0; frame < kNumFramesToProcess; ++frame) {
+    for (size_t i = 0; i < frames.size(); ++i) {
+      GenerateFrame(first_stream + i, frame, Amplitude(first_stream + i),
+                    streams[i], apm.num_frames());
+    }
+    apm.ProcessStreams(streams);
+  }
+  return frames;
+}
+
+// Processes |kNumFramesToProcess| frames of |stream| with an AudioProcessing
+// instance set up like |config| and returns the last output frame.
+std::vector<float> ProcessStreamWithAudioProcessing(
+    const BatchedAudioProcessing::Config& config,
+    size_t stream) {
+  std::unique_ptr<AudioProcessing> apm(AudioProcessingBuilder().Create());
+  apm->noise_suppression()->Enable(config.noise_suppression_enabled);
+  apm->noise_suppression()->set_level(config.noise_suppression_level);
+  AudioProcessing::Config apm_config;
+  apm_config.gain_controller2 = config.gain_controller2;
+  apm->ApplyConfig(apm_config);
+
+  const StreamConfig stream_config(config.sample_rate_hz, 1);
+  std::vector<float> frame(stream_config.num_frames());
+  float* const channels[] = {frame.data()};
+  for (int i = 0; i < kNumFramesToProcess; ++i) {
+    GenerateFrame(stream, i, Amplitude(stream), frame.data(), frame.size());
+    EXPECT_EQ(AudioProcessing::kNoError,
+              apm->ProcessStream(channels, stream_config, stream_config,
+                                 channels));
+  }
+  return frame;
+}
+
+}  // namespace
+
+TEST(BatchedAudioProcessing, ShardsAreClampedToTheNumberOfStreams) {
+  BatchedAudioProcessing apm(CreateConfig(16000, 3, 8));
+  EXPECT_EQ(3u, apm.num_threads());
+  EXPECT_EQ(160u, apm.num_frames());
+}
+
+// Verifies that each stream of a batch is processed as if it was processed on
+// its own, regardless of the number of streams and threads.
+TEST(BatchedAudioProcessing, StreamsAreProcessedIndependently) {
+  constexpr size_t kNumStreams = 7;
+  for (int sample_rate_hz : {8000, 16000, 32000, 48000}) {
+    for (size_t num_threads : {1, 3}) {
+      SCOPED_TRACE(sample_rate_hz);
+      SCOPED_TRACE(num_threads);
+      const std::vector<std::vector<float>> batched = ProcessStreams(
+          CreateConfig(sample_rate_hz, kNumStreams, num_threads), 0);
+      for (size_t i = 0; i < kNumStreams; ++i) {
+        const std::vector<std::vector<float>> single =
+            ProcessStreams(CreateConfig(sample_rate_hz, 1, 1), i);
+        EXPECT_EQ(single[0], batched[i]);
+      }
+    }
+  }
+}
+
+// Verifies that each stream of a batch gets the same output as from an
+// AudioProcessing instance of its own with the same submodules enabled.
+TEST(BatchedAudioProcessing, StreamsMatchAudioProcessing) {
+  constexpr size_t kNumStreams = 5;
+  // AudioProcessing splits 48 kHz into bands at 32 kHz on ARM, while
+  // BatchedAudioProcessing always runs at the stream rate.
+#if defined(WEBRTC_ARCH_ARM_FAMILY)
+  const int kSampleRatesHz[] = {8000, 16000, 32000};
+#else
+  const int kSampleRatesHz[] = {8000, 16000, 32000, 48000};
+#endif
+  for (int sample_rate_hz : kSampleRatesHz) {
+    SCOPED_TRACE(sample_rate_hz);
+    const BatchedAudioProcessing::Config config =
+        CreateConfig(sample_rate_hz, kNumStreams, 2);
+    const std::vector<std::vector<float>> batched = ProcessStreams(config, 0);
+    for (size_t i = 0; i < kNumStreams; ++i) {
+      SCOPED_TRACE(i);
+      EXPECT_EQ(ProcessStreamWithAudioProcessing(config, i), batched[i]);
+    }
+  }
+}
+
+// Verifies that the processing is applied, i.e., that the output differs from
+// the input and that the noise suppressor attenuates stationary noise.
+TEST(BatchedAudioProcessing, AttenuatesStationaryNoise) {
+  BatchedAudioProcessing::Config config = CreateConfig(48000, 2, 2);
+  config.gain_controller2.enabled = false;
+  BatchedAudioProcessing apm(config);
+  std::vector<std::vector<float>> frames(2,
+                                         std::vector<float>(apm.num_frames()));
+  std::vector<float*> streams = {frames[0].data(), frames[1].data()};
+  float input_energy = 0.f;
+  float output_energy = 0.f;
+  for (int frame = 0; frame < kNumFramesToProcess; ++frame) {
+    for (size_t i = 0; i < streams.size(); ++i) {
+      GenerateFrame(i, frame, 0.1f, streams[i], apm.num_frames());
+    }
+    if (frame == kNumFramesToProcess - 1) {
+      for (float x : frames[1]) {
+        input_energy += x * x;
+      }
+    }
+    apm.ProcessStreams(streams);
+  }
+  for (float x : frames[1]) {
+    output_energy += x * x;
+  }
+  EXPECT_LT(output_energy, 0.5f * input_energy);
+}
+
+}  // namespace webrtc
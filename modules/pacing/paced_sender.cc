@@ -18,6 +18,8 @@
 #include "modules/congestion_controller/goog_cc/alr_detector.h"
 #include "modules/pacing/bitrate_prober.h"
 #include "modules/pacing/interval_budget.h"
+#include "modules/pacing/ring_buffer_packet_queue.h"
+#include "modules/pacing/round_robin_packet_queue.h"
 #include "modules/utility/include/process_thread.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
@@ -38,6 +40,22 @@ const int64_t kMaxIntervalTimeMs = 30;
 }  // namespace
 
 namespace webrtc {
+namespace {
+
+std::unique_ptr<PacketQueueInterface> CreatePacketQueue(
+    PacedSender::QueueType queue_type,
+    int64_t start_time_us) {
+  switch (queue_type) {
+    case PacedSender::QueueType::kRoundRobin:
+      return absl::make_unique<RoundRobinPacketQueue>(start_time_us);
+    case PacedSender::QueueType::kRingBuffer:
+      return absl::make_unique<RingBufferPacketQueue>(start_time_us);
+  }
+  RTC_NOTREACHED();
+  return nullptr;
+}
+
+}  // namespace
 
 const int64_t PacedSender::kMaxQueueLengthMs = 2000;
 const float PacedSender::kDefaultPaceMultiplier = 2.5f;
@@ -45,6 +63,12 @@ const float PacedSender::kDefaultPaceMultiplier = 2.5f;
 PacedSender::PacedSender(const Clock* clock,
                          PacketSender* packet_sender,
                          RtcEventLog* event_log)
+    : PacedSender(clock, packet_sender, event_log, QueueType::kRoundRobin) {}
+
+PacedSender::PacedSender(const Clock* clock,
+                         PacketSender* packet_sender,
+                         RtcEventLog* event_log,
+                         QueueType queue_type)
     : clock_(clock),
       packet_sender_(packet_sender),
       alr_detector_(absl::make_unique<AlrDetector>(event_log)),
@@ -65,7 +89,7 @@ PacedSender::PacedSender(const Clock* clock,
       time_last_process_us_(clock->TimeInMicroseconds()),
       last_send_time_us_(clock->TimeInMicroseconds()),
       first_sent_packet_ms_(-1),
-      packets_(clock->TimeInMicroseconds()),
+      packets_(CreatePacketQueue(queue_type, clock->TimeInMicroseconds())),
       packet_counter_(0),
       pacing_factor_(kDefaultPaceMultiplier),
       queue_time_limit(kMaxQueueLengthMs),
@@ -89,7 +113,7 @@ void PacedSender::Pause() {
     if (!paused_)
       RTC_LOG(LS_INFO) << "PacedSender paused.";
     paused_ = true;
-    packets_.SetPauseState(true, TimeMilliseconds());
+    packets_->SetPauseState(true, TimeMilliseconds());
   }
   rtc::CritScope cs(&process_thread_lock_);
   // Tell the process thread to call our TimeUntilNextProcess() method to get
@@ -104,7 +128,7 @@ void PacedSender::Resume() {
     if (paused_)
       RTC_LOG(LS_INFO) << "PacedSender resumed.";
     paused_ = false;
-    packets_.SetPauseState(false, TimeMilliseconds());
+    packets_->SetPauseState(false, TimeMilliseconds());
   }
   rtc::CritScope cs(&process_thread_lock_);
   // Tell the process thread to call our TimeUntilNextProcess() method to
@@ -197,7 +221,7 @@ void PacedSender::InsertPacket(RtpPacketSender::Priority priority,
   if (capture_time_ms < 0)
     capture_time_ms = now_ms;
 
-  packets_.Push(RoundRobinPacketQueue::Packet(
+  packets_->Push(PacketQueueInterface::Packet(
       priority, ssrc, sequence_number, capture_time_ms, now_ms, bytes,
       retransmission, packet_counter_++));
 }
@@ -210,7 +234,7 @@ void PacedSender::SetAccountForAudioPackets(bool account_for_audio) {
 int64_t PacedSender::ExpectedQueueTimeMs() const {
   rtc::CritScope cs(&critsect_);
   RTC_DCHECK_GT(pacing_bitrate_kbps_, 0);
-  return static_cast<int64_t>(packets_.SizeInBytes() * 8 /
+  return static_cast<int64_t>(packets_->SizeInBytes() * 8 /
                               pacing_bitrate_kbps_);
 }
 
@@ -222,7 +246,7 @@ absl::optional<int64_t> PacedSender::GetApplicationLimitedRegionStartTime()
 
 size_t PacedSender::QueueSizePackets() const {
   rtc::CritScope cs(&critsect_);
-  return packets_.SizeInPackets();
+  return packets_->SizeInPackets();
 }
 
 int64_t PacedSender::FirstSentPacketTimeMs() const {
@@ -233,7 +257,7 @@ int64_t PacedSender::FirstSentPacketTimeMs() const {
 int64_t PacedSender::QueueInMs() const {
   rtc::CritScope cs(&critsect_);
 
-  int64_t oldest_packet = packets_.OldestEnqueueTimeMs();
+  int64_t oldest_packet = packets_->OldestEnqueueTimeMs();
   if (oldest_packet == 0)
     return 0;
 
@@ -303,15 +327,15 @@ void PacedSender::Process() {
 
   if (elapsed_time_ms > 0) {
     int target_bitrate_kbps = pacing_bitrate_kbps_;
-    size_t queue_size_bytes = packets_.SizeInBytes();
+    size_t queue_size_bytes = packets_->SizeInBytes();
     if (queue_size_bytes > 0) {
       // Assuming equal size packets and input/output rate, the average packet
       // has avg_time_left_ms left to get queue_size_bytes out of the queue, if
       // time constraint shall be met. Determine bitrate needed for that.
-      packets_.UpdateQueueTime(TimeMilliseconds());
+      packets_->UpdateQueueTime(TimeMilliseconds());
       if (drain_large_queues_) {
         int64_t avg_time_left_ms = std::max<int64_t>(
-            1, queue_time_limit - packets_.AverageQueueTimeMs());
+            1, queue_time_limit - packets_->AverageQueueTimeMs());
         int min_bitrate_needed_kbps =
             static_cast<int>(queue_size_bytes * 8 / avg_time_left_ms);
         if (min_bitrate_needed_kbps > target_bitrate_kbps)
@@ -333,7 +357,7 @@ void PacedSender::Process() {
   }
   // The paused state is checked in the loop since it leaves the critical
   // section allowing the paused state to be changed from other code.
-  while (!packets_.Empty() && !paused_) {
+  while (!packets_->Empty() && !paused_) {
     const auto* packet = GetPendingPacket(pacing_info);
     if (packet == nullptr)
       break;
@@ -351,12 +375,12 @@ void PacedSender::Process() {
         break;
     } else {
       // Send failed, put it back into the queue.
-      packets_.CancelPop(*packet);
+      packets_->CancelPop(*packet);
       break;
     }
   }
 
-  if (packets_.Empty() && !Congested()) {
+  if (packets_->Empty() && !Congested()) {
     // We can not send padding unless a normal packet has first been sent. If we
     // do, timestamps get messed up.
     if (packet_counter_ > 0) {
@@ -387,25 +411,25 @@ void PacedSender::ProcessThreadAttached(ProcessThread* process_thread) {
   process_thread_ = process_thread;
 }
 
-const RoundRobinPacketQueue::Packet* PacedSender::GetPendingPacket(
+const PacketQueueInterface::Packet* PacedSender::GetPendingPacket(
     const PacedPacketInfo& pacing_info) {
   // Since we need to release the lock in order to send, we first pop the
   // element from the priority queue but keep it in storage, so that we can
   // reinsert it if send fails.
-  const RoundRobinPacketQueue::Packet* packet = &packets_.BeginPop();
+  const PacketQueueInterface::Packet* packet = &packets_->BeginPop();
   bool audio_packet = packet->priority == kHighPriority;
   bool apply_pacing =
       !audio_packet || account_for_audio_ || video_blocks_audio_;
   if (apply_pacing && (Congested() || (media_budget_.bytes_remaining() == 0 &&
                                        pacing_info.probe_cluster_id ==
                                            PacedPacketInfo::kNotAProbe))) {
-    packets_.CancelPop(*packet);
+    packets_->CancelPop(*packet);
     return nullptr;
   }
   return packet;
 }
 
-void PacedSender::OnPacketSent(const RoundRobinPacketQueue::Packet* packet) {
+void PacedSender::OnPacketSent(const PacketQueueInterface::Packet* packet) {
   if (first_sent_packet_ms_ == -1)
     first_sent_packet_ms_ = TimeMilliseconds();
   bool audio_packet = packet->priority == kHighPriority;
@@ -419,7 +443,7 @@ void PacedSender::OnPacketSent(const RoundRobinPacketQueue::Packet* packet) {
     last_send_time_us_ = clock_->TimeInMicroseconds();
   }
   // Send succeeded, remove it from the queue.
-  packets_.FinalizePop(*packet);
+  packets_->FinalizePop(*packet);
 }
 
 void PacedSender::OnPaddingSent(size_t bytes_sent) {
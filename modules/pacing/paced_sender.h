@@ -20,7 +20,7 @@
 #include "modules/pacing/bitrate_prober.h"
 #include "modules/pacing/interval_budget.h"
 #include "modules/pacing/pacer.h"
-#include "modules/pacing/round_robin_packet_queue.h"
+#include "modules/pacing/packet_queue_interface.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/utility/include/process_thread.h"
 #include "rtc_base/criticalsection.h"
@@ -66,9 +66,22 @@ class PacedSender : public Pacer {
   // overshoots from the encoder.
   static const float kDefaultPaceMultiplier;
 
+  // Implementation of the queue holding the packets waiting to be sent.
+  enum class QueueType {
+    // RoundRobinPacketQueue, allocates memory for every queued packet.
+    kRoundRobin,
+    // RingBufferPacketQueue, preallocated and O(1) average push and pop, for
+    // senders with many streams or high packet rates.
+    kRingBuffer,
+  };
+
   PacedSender(const Clock* clock,
               PacketSender* packet_sender,
               RtcEventLog* event_log);
+  PacedSender(const Clock* clock,
+              PacketSender* packet_sender,
+              RtcEventLog* event_log,
+              QueueType queue_type);
 
   ~PacedSender() override;
 
@@ -154,10 +167,10 @@ class PacedSender : public Pacer {
   void UpdateBudgetWithBytesSent(size_t bytes)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
 
-  const RoundRobinPacketQueue::Packet* GetPendingPacket(
+  const PacketQueueInterface::Packet* GetPendingPacket(
       const PacedPacketInfo& pacing_info)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
-  void OnPacketSent(const RoundRobinPacketQueue::Packet* packet)
+  void OnPacketSent(const PacketQueueInterface::Packet* packet)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   void OnPaddingSent(size_t padding_sent)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
@@ -199,7 +212,8 @@ class PacedSender : public Pacer {
   int64_t last_send_time_us_ RTC_GUARDED_BY(critsect_);
   int64_t first_sent_packet_ms_ RTC_GUARDED_BY(critsect_);
 
-  RoundRobinPacketQueue packets_ RTC_GUARDED_BY(critsect_);
+  const std::unique_ptr<PacketQueueInterface> packets_
+      RTC_PT_GUARDED_BY(critsect_);
   uint64_t packet_counter_ RTC_GUARDED_BY(critsect_);
 
   int64_t congestion_window_bytes_ RTC_GUARDED_BY(critsect_) =
@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+#include <tuple>
+
+#include "modules/pacing/paced_sender.h"
+#include "rtc_base/cpu_time.h"
+#include "system_wrappers/include/clock.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kNumStreams = 200;
+constexpr int kPacketsPerSecond = 50000;
+constexpr size_t kPacketSize = 1200;
+constexpr int64_t kDurationMs = 10000;
+
+class CountingPacketSender : public PacedSender::PacketSender {
+ public:
+  bool TimeToSendPacket(uint32_t ssrc,
+                        uint16_t sequence_number,
+                        int64_t capture_time_ms,
+                        bool retransmission,
+                        const PacedPacketInfo& cluster_info) override {
+    ++packets_sent_;
+    return true;
+  }
+  size_t TimeToSendPadding(size_t bytes,
+                           const PacedPacketInfo& cluster_info) override {
+    return 0;
+  }
+
+  int packets_sent() const { return packets_sent_; }
+
+ private:
+  int packets_sent_ = 0;
+};
+
+}  // namespace
+
+// Feeds |kPacketsPerSecond| packets spread over |kNumStreams| SSRCs through
+// the pacer for |kDurationMs| of simulated time and reports the CPU time
+// spent per packet. With a pacing rate below the send rate the queue keeps
+// growing until the pacer starts draining it to meet its queue time limit.
+class PacedSenderPerformanceTest
+    : public testing::TestWithParam<std::tuple<PacedSender::QueueType, bool>> {
+};
+
+TEST_P(PacedSenderPerformanceTest, ManyStreams) {
+  const PacedSender::QueueType queue_type = std::get<0>(GetParam());
+  const bool congested = std::get<1>(GetParam());
+  const uint32_t send_rate_bps = kPacketsPerSecond * kPacketSize * 8;
+
+  SimulatedClock clock(123456);
+  CountingPacketSender packet_sender;
+  PacedSender pacer(&clock, &packet_sender, nullptr, queue_type);
+  pacer.SetProbingEnabled(false);
+  pacer.SetPacingRates(congested ? send_rate_bps * 0.9 : send_rate_bps * 1.1,
+                       0);
+
+  const int packets_per_ms = kPacketsPerSecond / 1000;
+  uint16_t sequence_numbers[kNumStreams] = {};
+  int inserted = 0;
+  const int64_t start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+  for (int64_t ms = 0; ms < kDurationMs; ++ms) {
+    for (int i = 0; i < packets_per_ms; ++i, ++inserted) {
+      // Let one stream be audio, which is sent with high priority.
+      const int stream = inserted % kNumStreams;
+      const PacedSender::Priority priority = stream == 0
+                                                 ? PacedSender::kHighPriority
+                                                 : PacedSender::kNormalPriority;
+      pacer.InsertPacket(priority, 1000 + stream, sequence_numbers[stream]++,
+                         clock.TimeInMilliseconds(), kPacketSize, false);
+    }
+    if (pacer.TimeUntilNextProcess() <= 0)
+      pacer.Process();
+    clock.AdvanceTimeMilliseconds(1);
+  }
+  const int64_t cpu_ns = rtc::GetThreadCpuTimeNanos() - start_cpu_ns;
+
+  EXPECT_GT(packet_sender.packets_sent(), 0);
+  ASSERT_GT(cpu_ns, 0);
+  const std::string trace =
+      std::string(queue_type == PacedSender::QueueType::kRingBuffer
+                      ? "ring_buffer"
+                      : "round_robin") +
+      (congested ? "_congested" : "_uncongested");
+  test::PrintResult("pacer_cpu_time_per_packet", "", trace,
+                    static_cast<double>(cpu_ns) / inserted, "ns", true);
+  test::PrintResult("pacer_final_queue_size", "", trace,
+                    pacer.QueueSizePackets(), "packets", false);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    QueueTypes,
+    PacedSenderPerformanceTest,
+    ::testing::Combine(::testing::Values(PacedSender::QueueType::kRoundRobin,
+                                         PacedSender::QueueType::kRingBuffer),
+                       ::testing::Bool()));
+
+}  // namespace webrtc
@@ -106,12 +106,14 @@ class PacedSenderProbing : public PacedSender::PacketSender {
   int padding_sent_;
 };
 
-class PacedSenderTest : public testing::TestWithParam<std::string> {
+class PacedSenderTest
+    : public testing::TestWithParam<PacedSender::QueueType> {
  protected:
   PacedSenderTest() : clock_(123456) {
     srand(0);
     // Need to initialize PacedSender after we initialize clock.
-    send_bucket_.reset(new PacedSender(&clock_, &callback_, nullptr));
+    send_bucket_.reset(
+        new PacedSender(&clock_, &callback_, nullptr, GetParam()));
     send_bucket_->CreateProbeCluster(kFirstClusterBps);
     send_bucket_->CreateProbeCluster(kSecondClusterBps);
     // Default to bitrate probing disabled for testing purposes. Probing tests
@@ -274,7 +276,7 @@ TEST_F(PacedSenderFieldTrialTest, BudgetDoesNotAffectAudioInTrial) {
   ProcessNext(&pacer);
 }
 
-TEST_F(PacedSenderTest, FirstSentPacketTimeIsSet) {
+TEST_P(PacedSenderTest, FirstSentPacketTimeIsSet) {
   uint16_t sequence_number = 1234;
   const uint32_t kSsrc = 12345;
   const size_t kSizeBytes = 250;
@@ -293,7 +295,7 @@ TEST_F(PacedSenderTest, FirstSentPacketTimeIsSet) {
   EXPECT_EQ(kStartMs, send_bucket_->FirstSentPacketTimeMs());
 }
 
-TEST_F(PacedSenderTest, QueuePacket) {
+TEST_P(PacedSenderTest, QueuePacket) {
   uint32_t ssrc = 12345;
   uint16_t sequence_number = 1234;
   // Due to the multiplicative factor we can send 5 packets during a send
@@ -341,7 +343,7 @@ TEST_F(PacedSenderTest, QueuePacket) {
   EXPECT_EQ(1u, send_bucket_->QueueSizePackets());
 }
 
-TEST_F(PacedSenderTest, PaceQueuedPackets) {
+TEST_P(PacedSenderTest, PaceQueuedPackets) {
   uint32_t ssrc = 12345;
   uint16_t sequence_number = 1234;
 
@@ -393,7 +395,7 @@ TEST_F(PacedSenderTest, PaceQueuedPackets) {
   EXPECT_EQ(1u, send_bucket_->QueueSizePackets());
 }
 
-TEST_F(PacedSenderTest, RepeatedRetransmissionsAllowed) {
+TEST_P(PacedSenderTest, RepeatedRetransmissionsAllowed) {
   // Send one packet, then two retransmissions of that packet.
   for (size_t i = 0; i < 3; i++) {
     constexpr uint32_t ssrc = 333;
@@ -407,7 +409,7 @@ TEST_F(PacedSenderTest, RepeatedRetransmissionsAllowed) {
   send_bucket_->Process();
 }
 
-TEST_F(PacedSenderTest, CanQueuePacketsWithSameSequenceNumberOnDifferentSsrcs) {
+TEST_P(PacedSenderTest, CanQueuePacketsWithSameSequenceNumberOnDifferentSsrcs) {
   uint32_t ssrc = 12345;
   uint16_t sequence_number = 1234;
 
@@ -422,7 +424,7 @@ TEST_F(PacedSenderTest, CanQueuePacketsWithSameSequenceNumberOnDifferentSsrcs) {
   send_bucket_->Process();
 }
 
-TEST_F(PacedSenderTest, Padding) {
+TEST_P(PacedSenderTest, Padding) {
   uint32_t ssrc = 12345;
   uint16_t sequence_number = 1234;
 
@@ -462,7 +464,7 @@ TEST_F(PacedSenderTest, Padding) {
   send_bucket_->Process();
 }
 
-TEST_F(PacedSenderTest, NoPaddingBeforeNormalPacket) {
+TEST_P(PacedSenderTest, NoPaddingBeforeNormalPacket) {
   send_bucket_->SetPacingRates(kTargetBitrateBps * kPaceMultiplier,
                                kTargetBitrateBps);
 
@@ -485,7 +487,7 @@ TEST_F(PacedSenderTest, NoPaddingBeforeNormalPacket) {
   send_bucket_->Process();
 }
 
-TEST_F(PacedSenderTest, VerifyPaddingUpToBitrate) {
+TEST_P(PacedSenderTest, VerifyPaddingUpToBitrate) {
   uint32_t ssrc = 12345;
   uint16_t sequence_number = 1234;
   int64_t capture_time_ms = 56789;
@@ -506,14 +508,15 @@ TEST_F(PacedSenderTest, VerifyPaddingUpToBitrate) {
   }
 }
 
-TEST_F(PacedSenderTest, VerifyAverageBitrateVaryingMediaPayload) {
+TEST_P(PacedSenderTest, VerifyAverageBitrateVaryingMediaPayload) {
   uint32_t ssrc = 12345;
   uint16_t sequence_number = 1234;
   int64_t capture_time_ms = 56789;
   const int kTimeStep = 5;
   const int64_t kBitrateWindow = 10000;
   PacedSenderPadding callback;
-  send_bucket_.reset(new PacedSender(&clock_, &callback, nullptr));
+  send_bucket_.reset(
+      new PacedSender(&clock_, &callback, nullptr, GetParam()));
   send_bucket_->SetProbingEnabled(false);
   send_bucket_->SetPacingRates(kTargetBitrateBps * kPaceMultiplier,
                                kTargetBitrateBps);
@@ -536,7 +539,7 @@ TEST_F(PacedSenderTest, VerifyAverageBitrateVaryingMediaPayload) {
               1);
 }
 
-TEST_F(PacedSenderTest, Priority) {
+TEST_P(PacedSenderTest, Priority) {
   uint32_t ssrc_low_priority = 12345;
   uint32_t ssrc = 12346;
   uint16_t sequence_number = 1234;
@@ -591,7 +594,7 @@ TEST_F(PacedSenderTest, Priority) {
   send_bucket_->Process();
 }
 
-TEST_F(PacedSenderTest, RetransmissionPriority) {
+TEST_P(PacedSenderTest, RetransmissionPriority) {
   uint32_t ssrc = 12345;
   uint16_t sequence_number = 1234;
   int64_t capture_time_ms = 45678;
@@ -645,7 +648,7 @@ TEST_F(PacedSenderTest, RetransmissionPriority) {
   EXPECT_EQ(0u, send_bucket_->QueueSizePackets());
 }
 
-TEST_F(PacedSenderTest, HighPrioDoesntAffectBudget) {
+TEST_P(PacedSenderTest, HighPrioDoesntAffectBudget) {
   uint32_t ssrc = 12346;
   uint16_t sequence_number = 1234;
   int64_t capture_time_ms = 56789;
@@ -683,7 +686,7 @@ TEST_F(PacedSenderTest, HighPrioDoesntAffectBudget) {
   EXPECT_EQ(0u, send_bucket_->QueueSizePackets());
 }
 
-TEST_F(PacedSenderTest, SendsOnlyPaddingWhenCongested) {
+TEST_P(PacedSenderTest, SendsOnlyPaddingWhenCongested) {
   uint32_t ssrc = 202020;
   uint16_t sequence_number = 1000;
   int kPacketSize = 250;
@@ -721,7 +724,7 @@ TEST_F(PacedSenderTest, SendsOnlyPaddingWhenCongested) {
   EXPECT_EQ(blocked_packets, send_bucket_->QueueSizePackets());
 }
 
-TEST_F(PacedSenderTest, DoesNotAllowOveruseAfterCongestion) {
+TEST_P(PacedSenderTest, DoesNotAllowOveruseAfterCongestion) {
   uint32_t ssrc = 202020;
   uint16_t seq_num = 1000;
   RtpPacketSender::Priority prio = PacedSender::kNormalPriority;
@@ -763,7 +766,7 @@ TEST_F(PacedSenderTest, DoesNotAllowOveruseAfterCongestion) {
   send_bucket_->Process();
 }
 
-TEST_F(PacedSenderTest, ResumesSendingWhenCongestionEnds) {
+TEST_P(PacedSenderTest, ResumesSendingWhenCongestionEnds) {
   uint32_t ssrc = 202020;
   uint16_t sequence_number = 1000;
   int64_t kPacketSize = 250;
@@ -822,7 +825,7 @@ TEST_F(PacedSenderTest, ResumesSendingWhenCongestionEnds) {
   }
 }
 
-TEST_F(PacedSenderTest, Pause) {
+TEST_P(PacedSenderTest, Pause) {
   uint32_t ssrc_low_priority = 12345;
   uint32_t ssrc = 12346;
   uint32_t ssrc_high_priority = 12347;
@@ -942,7 +945,7 @@ TEST_F(PacedSenderTest, Pause) {
   EXPECT_EQ(0, send_bucket_->QueueInMs());
 }
 
-TEST_F(PacedSenderTest, ResendPacket) {
+TEST_P(PacedSenderTest, ResendPacket) {
   uint32_t ssrc = 12346;
   uint16_t sequence_number = 1234;
   int64_t capture_time_ms = clock_.TimeInMilliseconds();
@@ -995,7 +998,7 @@ TEST_F(PacedSenderTest, ResendPacket) {
   EXPECT_EQ(0, send_bucket_->QueueInMs());
 }
 
-TEST_F(PacedSenderTest, ExpectedQueueTimeMs) {
+TEST_P(PacedSenderTest, ExpectedQueueTimeMs) {
   uint32_t ssrc = 12346;
   uint16_t sequence_number = 1234;
   const size_t kNumPackets = 60;
@@ -1032,7 +1035,7 @@ TEST_F(PacedSenderTest, ExpectedQueueTimeMs) {
               static_cast<int64_t>(1000 * kPacketSize * 8 / kMaxBitrate));
 }
 
-TEST_F(PacedSenderTest, QueueTimeGrowsOverTime) {
+TEST_P(PacedSenderTest, QueueTimeGrowsOverTime) {
   uint32_t ssrc = 12346;
   uint16_t sequence_number = 1234;
   EXPECT_EQ(0, send_bucket_->QueueInMs());
@@ -1047,14 +1050,15 @@ TEST_F(PacedSenderTest, QueueTimeGrowsOverTime) {
   EXPECT_EQ(0, send_bucket_->QueueInMs());
 }
 
-TEST_F(PacedSenderTest, ProbingWithInsertedPackets) {
+TEST_P(PacedSenderTest, ProbingWithInsertedPackets) {
   const size_t kPacketSize = 1200;
   const int kInitialBitrateBps = 300000;
   uint32_t ssrc = 12346;
   uint16_t sequence_number = 1234;
 
   PacedSenderProbing packet_sender;
-  send_bucket_.reset(new PacedSender(&clock_, &packet_sender, nullptr));
+  send_bucket_.reset(
+      new PacedSender(&clock_, &packet_sender, nullptr, GetParam()));
   send_bucket_->CreateProbeCluster(kFirstClusterBps);
   send_bucket_->CreateProbeCluster(kSecondClusterBps);
   send_bucket_->SetPacingRates(kInitialBitrateBps * kPaceMultiplier, 0);
@@ -1093,14 +1097,15 @@ TEST_F(PacedSenderTest, ProbingWithInsertedPackets) {
               kSecondClusterBps, kBitrateProbingError);
 }
 
-TEST_F(PacedSenderTest, ProbingWithPaddingSupport) {
+TEST_P(PacedSenderTest, ProbingWithPaddingSupport) {
   const size_t kPacketSize = 1200;
   const int kInitialBitrateBps = 300000;
   uint32_t ssrc = 12346;
   uint16_t sequence_number = 1234;
 
   PacedSenderProbing packet_sender;
-  send_bucket_.reset(new PacedSender(&clock_, &packet_sender, nullptr));
+  send_bucket_.reset(
+      new PacedSender(&clock_, &packet_sender, nullptr, GetParam()));
   send_bucket_->CreateProbeCluster(kFirstClusterBps);
   send_bucket_->SetPacingRates(kInitialBitrateBps * kPaceMultiplier, 0);
 
@@ -1129,7 +1134,7 @@ TEST_F(PacedSenderTest, ProbingWithPaddingSupport) {
               kFirstClusterBps, kBitrateProbingError);
 }
 
-TEST_F(PacedSenderTest, PaddingOveruse) {
+TEST_P(PacedSenderTest, PaddingOveruse) {
   uint32_t ssrc = 12346;
   uint16_t sequence_number = 1234;
   const size_t kPacketSize = 1200;
@@ -1156,7 +1161,7 @@ TEST_F(PacedSenderTest, PaddingOveruse) {
 
 // TODO(philipel): Move to PacketQueue2 unittests.
 #if 0
-TEST_F(PacedSenderTest, AverageQueueTime) {
+TEST_P(PacedSenderTest, AverageQueueTime) {
   uint32_t ssrc = 12346;
   uint16_t sequence_number = 1234;
   const size_t kPacketSize = 1200;
@@ -1202,7 +1207,7 @@ TEST_F(PacedSenderTest, AverageQueueTime) {
 }
 #endif
 
-TEST_F(PacedSenderTest, ProbeClusterId) {
+TEST_P(PacedSenderTest, ProbeClusterId) {
   uint32_t ssrc = 12346;
   uint16_t sequence_number = 1234;
   const size_t kPacketSize = 1200;
@@ -1249,7 +1254,7 @@ TEST_F(PacedSenderTest, ProbeClusterId) {
   send_bucket_->Process();
 }
 
-TEST_F(PacedSenderTest, AvoidBusyLoopOnSendFailure) {
+TEST_P(PacedSenderTest, AvoidBusyLoopOnSendFailure) {
   uint32_t ssrc = 12346;
   uint16_t sequence_number = 1234;
   const size_t kPacketSize = kFirstClusterBps / (8000 / 10);
@@ -1279,7 +1284,7 @@ TEST_F(PacedSenderTest, AvoidBusyLoopOnSendFailure) {
 
 // TODO(philipel): Move to PacketQueue2 unittests.
 #if 0
-TEST_F(PacedSenderTest, QueueTimeWithPause) {
+TEST_P(PacedSenderTest, QueueTimeWithPause) {
   const size_t kPacketSize = 1200;
   const uint32_t kSsrc = 12346;
   uint16_t sequence_number = 1234;
@@ -1308,7 +1313,7 @@ TEST_F(PacedSenderTest, QueueTimeWithPause) {
   EXPECT_EQ(200, send_bucket_->AverageQueueTimeMs());
 }
 
-TEST_F(PacedSenderTest, QueueTimePausedDuringPush) {
+TEST_P(PacedSenderTest, QueueTimePausedDuringPush) {
   const size_t kPacketSize = 1200;
   const uint32_t kSsrc = 12346;
   uint16_t sequence_number = 1234;
@@ -1340,6 +1345,12 @@ TEST_F(PacedSenderTest, QueueTimePausedDuringPush) {
 }
 #endif
 
+INSTANTIATE_TEST_CASE_P(
+    QueueTypes,
+    PacedSenderTest,
+    ::testing::Values(PacedSender::QueueType::kRoundRobin,
+                      PacedSender::QueueType::kRingBuffer));
+
 // TODO(sprang): Extract PacketQueue from PacedSender so that we can test
 // removing elements while paused. (This is possible, but only because of semi-
 // racy condition so can't easily be tested).
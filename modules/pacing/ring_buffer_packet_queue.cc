@@ -0,0 +1,329 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/pacing/ring_buffer_packet_queue.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+constexpr uint32_t RingBufferPacketQueue::kNoIndex;
+constexpr size_t RingBufferPacketQueue::kInitialCapacity;
+
+RingBufferPacketQueue::Slot::Slot()
+    : packet(RtpPacketSender::kNormalPriority, 0, 0, 0, 0, 0, false, 0),
+      next(kNoIndex),
+      enqueue_time_ms(0),
+      pushed_before(kNoIndex),
+      pushed_after(kNoIndex) {}
+
+RingBufferPacketQueue::Stream::Stream()
+    : ssrc(0), level(-1), prev(kNoIndex), next(kNoIndex), deficit(0) {}
+
+RingBufferPacketQueue::RingBufferPacketQueue(int64_t start_time_us)
+    : time_last_updated_ms_(start_time_us / 1000) {
+  std::fill(current_stream_, current_stream_ + kNumPriorityLevels, kNoIndex);
+  GrowSlots();
+}
+
+RingBufferPacketQueue::~RingBufferPacketQueue() {}
+
+void RingBufferPacketQueue::Push(const Packet& packet) {
+  uint32_t stream_index = GetOrCreateStream(packet.ssrc);
+  uint32_t slot_index = AllocateSlot();
+  Slot& slot = slots_[slot_index];
+  slot.packet = packet;
+  slot.next = kNoIndex;
+  slot.enqueue_time_ms = packet.enqueue_time_ms;
+  LinkPushed(slot_index);
+
+  // See RoundRobinPacketQueue::Push() for how the time spent in a paused
+  // state is subtracted from the queue time of a packet.
+  UpdateQueueTime(packet.enqueue_time_ms);
+  slot.packet.enqueue_time_ms -= pause_time_sum_ms_;
+
+  FifoQueue& queue = streams_[stream_index].queues[QueueIndex(packet)];
+  if (queue.tail == kNoIndex) {
+    queue.head = slot_index;
+  } else {
+    slots_[queue.tail].next = slot_index;
+  }
+  queue.tail = slot_index;
+
+  size_packets_ += 1;
+  size_bytes_ += packet.bytes;
+  UpdateSchedule(stream_index);
+}
+
+const PacketQueueInterface::Packet& RingBufferPacketQueue::BeginPop() {
+  RTC_CHECK(!pop_packet_);
+  int level = 0;
+  while (level < kNumPriorityLevels && current_stream_[level] == kNoIndex)
+    ++level;
+  RTC_CHECK_LT(level, kNumPriorityLevels);
+
+  // Deficit round robin: a stream may send as long as it has enough deficit
+  // left for its next packet, otherwise it is given another quantum and the
+  // turn passes to the next stream. This terminates since every lap adds to
+  // the deficit of all streams.
+  uint32_t stream_index = current_stream_[level];
+  FifoQueue* queue = nullptr;
+  while (true) {
+    Stream& stream = streams_[stream_index];
+    RTC_DCHECK_EQ(stream.level, level);
+    queue = &stream.queues[2 * level];
+    if (queue->head == kNoIndex)
+      queue = &stream.queues[2 * level + 1];
+    RTC_CHECK_NE(queue->head, kNoIndex);
+    const size_t bytes = slots_[queue->head].packet.bytes;
+    if (stream.deficit >= static_cast<int64_t>(bytes))
+      break;
+    stream.deficit += kQuantumBytes;
+    stream_index = stream.next;
+  }
+  current_stream_[level] = stream_index;
+
+  pop_stream_ = stream_index;
+  pop_slot_ = queue->head;
+  queue->head = slots_[pop_slot_].next;
+  if (queue->head == kNoIndex)
+    queue->tail = kNoIndex;
+  pop_packet_.emplace(slots_[pop_slot_].packet);
+  return *pop_packet_;
+}
+
+void RingBufferPacketQueue::CancelPop(const Packet& packet) {
+  RTC_CHECK(pop_packet_);
+  // Put the packet back in front of its queue.
+  FifoQueue& queue = streams_[pop_stream_].queues[QueueIndex(*pop_packet_)];
+  slots_[pop_slot_].next = queue.head;
+  queue.head = pop_slot_;
+  if (queue.tail == kNoIndex)
+    queue.tail = pop_slot_;
+
+  const uint32_t stream_index = pop_stream_;
+  pop_packet_.reset();
+  pop_slot_ = kNoIndex;
+  pop_stream_ = kNoIndex;
+  UpdateSchedule(stream_index);
+}
+
+void RingBufferPacketQueue::FinalizePop(const Packet& packet) {
+  RTC_CHECK(pop_packet_);
+  const Packet& popped = *pop_packet_;
+
+  int64_t time_in_non_paused_state_ms =
+      time_last_updated_ms_ - popped.enqueue_time_ms - pause_time_sum_ms_;
+  queue_time_sum_ms_ -= time_in_non_paused_state_ms;
+  UnlinkPushed(pop_slot_);
+
+  size_bytes_ -= popped.bytes;
+  size_packets_ -= 1;
+  RTC_CHECK(size_packets_ > 0 || queue_time_sum_ms_ == 0);
+
+  streams_[pop_stream_].deficit -= popped.bytes;
+
+  slots_[pop_slot_].next = free_slots_;
+  free_slots_ = pop_slot_;
+  const uint32_t stream_index = pop_stream_;
+  pop_packet_.reset();
+  pop_slot_ = kNoIndex;
+  pop_stream_ = kNoIndex;
+  UpdateSchedule(stream_index);
+}
+
+bool RingBufferPacketQueue::Empty() const {
+  return size_packets_ == 0;
+}
+
+size_t RingBufferPacketQueue::SizeInPackets() const {
+  return size_packets_;
+}
+
+uint64_t RingBufferPacketQueue::SizeInBytes() const {
+  return size_bytes_;
+}
+
+int64_t RingBufferPacketQueue::OldestEnqueueTimeMs() const {
+  if (Empty())
+    return 0;
+  RTC_CHECK_NE(oldest_slot_, kNoIndex);
+  return slots_[oldest_slot_].enqueue_time_ms;
+}
+
+void RingBufferPacketQueue::UpdateQueueTime(int64_t timestamp_ms) {
+  RTC_CHECK_GE(timestamp_ms, time_last_updated_ms_);
+  if (timestamp_ms == time_last_updated_ms_)
+    return;
+
+  int64_t delta_ms = timestamp_ms - time_last_updated_ms_;
+
+  if (paused_) {
+    pause_time_sum_ms_ += delta_ms;
+  } else {
+    queue_time_sum_ms_ += delta_ms * size_packets_;
+  }
+
+  time_last_updated_ms_ = timestamp_ms;
+}
+
+void RingBufferPacketQueue::SetPauseState(bool paused, int64_t timestamp_ms) {
+  if (paused_ == paused)
+    return;
+  UpdateQueueTime(timestamp_ms);
+  paused_ = paused;
+}
+
+int64_t RingBufferPacketQueue::AverageQueueTimeMs() const {
+  if (Empty())
+    return 0;
+  return queue_time_sum_ms_ / size_packets_;
+}
+
+int RingBufferPacketQueue::QueueIndex(const Packet& packet) {
+  int level;
+  switch (packet.priority) {
+    case RtpPacketSender::kHighPriority:
+      level = 0;
+      break;
+    case RtpPacketSender::kNormalPriority:
+      level = 1;
+      break;
+    default:
+      level = 2;
+      break;
+  }
+  // Retransmissions go before media packets of the same priority.
+  return 2 * level + (packet.retransmission ? 0 : 1);
+}
+
+uint32_t RingBufferPacketQueue::GetOrCreateStream(uint32_t ssrc) {
+  auto it = stream_indices_.find(ssrc);
+  if (it != stream_indices_.end())
+    return it->second;
+  uint32_t index = static_cast<uint32_t>(streams_.size());
+  streams_.emplace_back();
+  streams_.back().ssrc = ssrc;
+  stream_indices_.emplace(ssrc, index);
+  return index;
+}
+
+uint32_t RingBufferPacketQueue::AllocateSlot() {
+  if (free_slots_ == kNoIndex)
+    GrowSlots();
+  uint32_t index = free_slots_;
+  free_slots_ = slots_[index].next;
+  return index;
+}
+
+void RingBufferPacketQueue::GrowSlots() {
+  const size_t old_size = slots_.size();
+  const size_t new_size = std::max(kInitialCapacity, 2 * old_size);
+  RTC_CHECK_LT(new_size, kNoIndex);
+  slots_.resize(new_size);
+  for (size_t i = old_size; i < new_size; ++i) {
+    slots_[i].next = free_slots_;
+    free_slots_ = static_cast<uint32_t>(i);
+  }
+}
+
+void RingBufferPacketQueue::LinkPushed(uint32_t slot_index) {
+  Slot& slot = slots_[slot_index];
+  slot.pushed_before = newest_slot_;
+  slot.pushed_after = kNoIndex;
+  if (newest_slot_ == kNoIndex) {
+    oldest_slot_ = slot_index;
+  } else {
+    slots_[newest_slot_].pushed_after = slot_index;
+  }
+  newest_slot_ = slot_index;
+}
+
+void RingBufferPacketQueue::UnlinkPushed(uint32_t slot_index) {
+  Slot& slot = slots_[slot_index];
+  if (slot.pushed_before == kNoIndex) {
+    oldest_slot_ = slot.pushed_after;
+  } else {
+    slots_[slot.pushed_before].pushed_after = slot.pushed_after;
+  }
+  if (slot.pushed_after == kNoIndex) {
+    newest_slot_ = slot.pushed_before;
+  } else {
+    slots_[slot.pushed_after].pushed_before = slot.pushed_before;
+  }
+  slot.pushed_before = kNoIndex;
+  slot.pushed_after = kNoIndex;
+}
+
+void RingBufferPacketQueue::UpdateSchedule(uint32_t stream_index) {
+  Stream& stream = streams_[stream_index];
+  int level = -1;
+  for (int i = 0; i < kNumPacketQueues; ++i) {
+    if (stream.queues[i].head != kNoIndex) {
+      level = i / 2;
+      break;
+    }
+  }
+  // A stream that is being popped from stays scheduled for the popped packet,
+  // since it may be put back with CancelPop().
+  if (pop_packet_ && stream_index == pop_stream_) {
+    const int pop_level = QueueIndex(*pop_packet_) / 2;
+    if (level == -1 || pop_level < level)
+      level = pop_level;
+  }
+  if (level == stream.level)
+    return;
+
+  if (stream.level != -1)
+    Unschedule(stream_index);
+  if (level == -1) {
+    stream.deficit = 0;
+  } else {
+    Schedule(stream_index, level);
+  }
+}
+
+void RingBufferPacketQueue::Schedule(uint32_t stream_index, int level) {
+  Stream& stream = streams_[stream_index];
+  stream.level = level;
+  uint32_t current = current_stream_[level];
+  if (current == kNoIndex) {
+    stream.prev = stream_index;
+    stream.next = stream_index;
+    current_stream_[level] = stream_index;
+    return;
+  }
+  // Insert last in the round, i.e. just before the current stream.
+  stream.next = current;
+  stream.prev = streams_[current].prev;
+  streams_[stream.prev].next = stream_index;
+  streams_[current].prev = stream_index;
+}
+
+void RingBufferPacketQueue::Unschedule(uint32_t stream_index) {
+  Stream& stream = streams_[stream_index];
+  const int level = stream.level;
+  if (stream.next == stream_index) {
+    current_stream_[level] = kNoIndex;
+  } else {
+    streams_[stream.prev].next = stream.next;
+    streams_[stream.next].prev = stream.prev;
+    if (current_stream_[level] == stream_index)
+      current_stream_[level] = stream.next;
+  }
+  stream.level = -1;
+  stream.prev = kNoIndex;
+  stream.next = kNoIndex;
+}
+
+}  // namespace webrtc
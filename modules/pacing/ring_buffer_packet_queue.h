@@ -0,0 +1,139 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_PACING_RING_BUFFER_PACKET_QUEUE_H_
+#define MODULES_PACING_RING_BUFFER_PACKET_QUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "modules/pacing/packet_queue_interface.h"
+
+namespace webrtc {
+
+// Packet queue with the same ordering rules as RoundRobinPacketQueue, built to
+// not allocate memory per packet. Packets are kept in a preallocated slot pool
+// and linked into intrusive per-stream FIFOs, one per priority level and
+// retransmission flag, and into a list in push order to find the oldest
+// packet. Storage only grows (by doubling) when more packets are queued than
+// ever before.
+//
+// Streams with the same priority share the send rate using deficit round
+// robin, giving O(1) average Push() and pop instead of the O(log n) ordered
+// containers of RoundRobinPacketQueue.
+class RingBufferPacketQueue : public PacketQueueInterface {
+ public:
+  explicit RingBufferPacketQueue(int64_t start_time_us);
+  ~RingBufferPacketQueue() override;
+
+  void Push(const Packet& packet) override;
+  const Packet& BeginPop() override;
+  void CancelPop(const Packet& packet) override;
+  void FinalizePop(const Packet& packet) override;
+
+  bool Empty() const override;
+  size_t SizeInPackets() const override;
+  uint64_t SizeInBytes() const override;
+
+  int64_t OldestEnqueueTimeMs() const override;
+  int64_t AverageQueueTimeMs() const override;
+  void UpdateQueueTime(int64_t timestamp_ms) override;
+  void SetPauseState(bool paused, int64_t timestamp_ms) override;
+
+ private:
+  static constexpr uint32_t kNoIndex = 0xFFFFFFFF;
+  // High, normal and low priority.
+  static constexpr int kNumPriorityLevels = 3;
+  // Every level has a retransmission and a media queue.
+  static constexpr int kNumPacketQueues = 2 * kNumPriorityLevels;
+  // Bytes a stream may send each round; the same bound RoundRobinPacketQueue
+  // uses for how far one stream can get ahead of another.
+  static constexpr int64_t kQuantumBytes = 1400;
+  static constexpr size_t kInitialCapacity = 256;
+
+  struct Slot {
+    Slot();
+
+    Packet packet;
+    // Next packet in the same stream queue, or next free slot.
+    uint32_t next;
+    // Enqueue time as pushed, before subtracting the paused time.
+    int64_t enqueue_time_ms;
+    // Neighbours in the list of queued packets in push order.
+    uint32_t pushed_before;
+    uint32_t pushed_after;
+  };
+
+  struct FifoQueue {
+    uint32_t head = kNoIndex;
+    uint32_t tail = kNoIndex;
+  };
+
+  struct Stream {
+    Stream();
+
+    uint32_t ssrc;
+    FifoQueue queues[kNumPacketQueues];
+    // Level this stream is scheduled at, or -1 if it has no packets.
+    int level;
+    // Neighbours in the circular schedule of |level|.
+    uint32_t prev;
+    uint32_t next;
+    // Deficit round robin send allowance, in bytes.
+    int64_t deficit;
+  };
+
+  static int QueueIndex(const Packet& packet);
+
+  uint32_t GetOrCreateStream(uint32_t ssrc);
+  uint32_t AllocateSlot();
+  void GrowSlots();
+  void LinkPushed(uint32_t slot_index);
+  void UnlinkPushed(uint32_t slot_index);
+
+  // Moves |stream| to the schedule of its highest priority queued packet, or
+  // removes it from scheduling if it has no packets left.
+  void UpdateSchedule(uint32_t stream_index);
+  void Schedule(uint32_t stream_index, int level);
+  void Unschedule(uint32_t stream_index);
+
+  int64_t time_last_updated_ms_;
+  absl::optional<Packet> pop_packet_;
+  uint32_t pop_slot_ = kNoIndex;
+  uint32_t pop_stream_ = kNoIndex;
+
+  bool paused_ = false;
+  size_t size_packets_ = 0;
+  size_t size_bytes_ = 0;
+  int64_t queue_time_sum_ms_ = 0;
+  int64_t pause_time_sum_ms_ = 0;
+
+  std::vector<Slot> slots_;
+  uint32_t free_slots_ = kNoIndex;
+
+  std::vector<Stream> streams_;
+  std::unordered_map<uint32_t, uint32_t> stream_indices_;
+  // The stream to pop from next for each priority level, or kNoIndex if no
+  // stream is scheduled at that level.
+  uint32_t current_stream_[kNumPriorityLevels];
+
+  // Ends of the list of queued packets in push order, which is also enqueue
+  // time order. A packet leaves the list when it is sent, however long it has
+  // been starved, so the list never holds more than the queued packets.
+  uint32_t oldest_slot_ = kNoIndex;
+  uint32_t newest_slot_ = kNoIndex;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_PACING_RING_BUFFER_PACKET_QUEUE_H_
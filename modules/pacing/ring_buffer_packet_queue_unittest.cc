@@ -0,0 +1,160 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <map>
+#include <vector>
+
+#include "modules/pacing/ring_buffer_packet_queue.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int64_t kStartTimeMs = 1000;
+
+class RingBufferPacketQueueTest : public testing::Test {
+ protected:
+  RingBufferPacketQueueTest() : queue_(kStartTimeMs * 1000) {}
+
+  void Push(RtpPacketSender::Priority priority,
+            uint32_t ssrc,
+            size_t bytes,
+            bool retransmission = false,
+            int64_t now_ms = kStartTimeMs) {
+    queue_.Push(PacketQueueInterface::Packet(priority, ssrc, sequence_number_++,
+                                             now_ms, now_ms, bytes,
+                                             retransmission, enqueue_order_++));
+  }
+
+  PacketQueueInterface::Packet Pop() {
+    const PacketQueueInterface::Packet& packet = queue_.BeginPop();
+    PacketQueueInterface::Packet copy(packet);
+    queue_.FinalizePop(packet);
+    return copy;
+  }
+
+  RingBufferPacketQueue queue_;
+  uint16_t sequence_number_ = 0;
+  uint64_t enqueue_order_ = 0;
+};
+
+}  // namespace
+
+TEST_F(RingBufferPacketQueueTest, PopsInPriorityOrder) {
+  Push(RtpPacketSender::kLowPriority, 1, 100);
+  Push(RtpPacketSender::kNormalPriority, 2, 100);
+  Push(RtpPacketSender::kNormalPriority, 2, 100, true);
+  Push(RtpPacketSender::kHighPriority, 3, 100);
+  EXPECT_EQ(4u, queue_.SizeInPackets());
+  EXPECT_EQ(400u, queue_.SizeInBytes());
+
+  PacketQueueInterface::Packet packet = Pop();
+  EXPECT_EQ(3u, packet.ssrc);
+  packet = Pop();
+  EXPECT_EQ(2u, packet.ssrc);
+  EXPECT_TRUE(packet.retransmission);
+  packet = Pop();
+  EXPECT_EQ(2u, packet.ssrc);
+  EXPECT_FALSE(packet.retransmission);
+  packet = Pop();
+  EXPECT_EQ(1u, packet.ssrc);
+  EXPECT_TRUE(queue_.Empty());
+}
+
+TEST_F(RingBufferPacketQueueTest, KeepsPacketOrderWithinStream) {
+  for (int i = 0; i < 10; ++i)
+    Push(RtpPacketSender::kNormalPriority, 1, 100);
+  for (uint16_t i = 0; i < 10; ++i)
+    EXPECT_EQ(i, Pop().sequence_number);
+}
+
+TEST_F(RingBufferPacketQueueTest, CancelPopPutsPacketBackFirst) {
+  Push(RtpPacketSender::kNormalPriority, 1, 100);
+  Push(RtpPacketSender::kNormalPriority, 1, 100);
+  const PacketQueueInterface::Packet& packet = queue_.BeginPop();
+  EXPECT_EQ(0, packet.sequence_number);
+  // A packet pushed while the pop is in progress doesn't affect the order.
+  Push(RtpPacketSender::kNormalPriority, 1, 100);
+  queue_.CancelPop(packet);
+  EXPECT_EQ(3u, queue_.SizeInPackets());
+  EXPECT_EQ(0, Pop().sequence_number);
+  EXPECT_EQ(1, Pop().sequence_number);
+  EXPECT_EQ(2, Pop().sequence_number);
+}
+
+TEST_F(RingBufferPacketQueueTest, SharesRateBetweenStreamsByBytes) {
+  // Stream 1 sends packets twice the size of those of stream 2, so it should
+  // get about half as many packets through.
+  for (int i = 0; i < 100; ++i) {
+    Push(RtpPacketSender::kNormalPriority, 1, 1000);
+    Push(RtpPacketSender::kNormalPriority, 2, 500);
+    Push(RtpPacketSender::kNormalPriority, 2, 500);
+  }
+  std::map<uint32_t, size_t> bytes_sent;
+  for (int i = 0; i < 150; ++i) {
+    PacketQueueInterface::Packet packet = Pop();
+    bytes_sent[packet.ssrc] += packet.bytes;
+  }
+  EXPECT_NEAR(bytes_sent[1], bytes_sent[2], 1400);
+}
+
+TEST_F(RingBufferPacketQueueTest, TracksOldestEnqueueTime) {
+  Push(RtpPacketSender::kLowPriority, 1, 100, false, kStartTimeMs);
+  Push(RtpPacketSender::kNormalPriority, 2, 100, false, kStartTimeMs + 10);
+  Push(RtpPacketSender::kNormalPriority, 2, 100, false, kStartTimeMs + 20);
+  EXPECT_EQ(kStartTimeMs, queue_.OldestEnqueueTimeMs());
+  Pop();
+  Pop();
+  EXPECT_EQ(kStartTimeMs, queue_.OldestEnqueueTimeMs());
+  Pop();
+  EXPECT_TRUE(queue_.Empty());
+  EXPECT_EQ(0, queue_.OldestEnqueueTimeMs());
+}
+
+TEST_F(RingBufferPacketQueueTest, TracksOldestEnqueueTimeOfStarvedPacket) {
+  // The low priority packet is not sent while normal priority packets keep
+  // coming, which must not make the bookkeeping of the others grow.
+  Push(RtpPacketSender::kLowPriority, 1, 100, false, kStartTimeMs);
+  const int kNumPackets = 10000;
+  for (int i = 1; i <= kNumPackets; ++i) {
+    Push(RtpPacketSender::kNormalPriority, 2, 100, false, kStartTimeMs + i);
+    EXPECT_EQ(2u, Pop().ssrc);
+    EXPECT_EQ(kStartTimeMs, queue_.OldestEnqueueTimeMs());
+  }
+  Push(RtpPacketSender::kNormalPriority, 2, 100, false,
+       kStartTimeMs + kNumPackets + 1);
+  EXPECT_EQ(2u, queue_.SizeInPackets());
+  EXPECT_EQ(2u, Pop().ssrc);
+  EXPECT_EQ(1u, Pop().ssrc);
+  EXPECT_TRUE(queue_.Empty());
+}
+
+TEST_F(RingBufferPacketQueueTest, OldestEnqueueTimeFollowsSentPackets) {
+  Push(RtpPacketSender::kNormalPriority, 1, 100, false, kStartTimeMs);
+  Push(RtpPacketSender::kNormalPriority, 1, 100, false, kStartTimeMs + 10);
+  Push(RtpPacketSender::kLowPriority, 2, 100, false, kStartTimeMs + 20);
+  Pop();
+  EXPECT_EQ(kStartTimeMs + 10, queue_.OldestEnqueueTimeMs());
+  Pop();
+  EXPECT_EQ(kStartTimeMs + 20, queue_.OldestEnqueueTimeMs());
+}
+
+TEST_F(RingBufferPacketQueueTest, GrowsBeyondInitialCapacity) {
+  const int kNumPackets = 5000;
+  for (int i = 0; i < kNumPackets; ++i)
+    Push(RtpPacketSender::kNormalPriority, i % 7, 100, false, kStartTimeMs + i);
+  EXPECT_EQ(static_cast<size_t>(kNumPackets), queue_.SizeInPackets());
+  EXPECT_EQ(kStartTimeMs, queue_.OldestEnqueueTimeMs());
+  for (int i = 0; i < kNumPackets; ++i)
+    Pop();
+  EXPECT_TRUE(queue_.Empty());
+}
+
+}  // namespace webrtc
@@ -13,61 +13,35 @@
 
 #include <stddef.h>
 #include <stdint.h>
-#include <list>
 #include <map>
 #include <queue>
 #include <set>
 
 #include "absl/types/optional.h"
+#include "modules/pacing/packet_queue_interface.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "system_wrappers/include/clock.h"
 
 namespace webrtc {
 
-class RoundRobinPacketQueue {
+class RoundRobinPacketQueue : public PacketQueueInterface {
  public:
   explicit RoundRobinPacketQueue(int64_t start_time_us);
-  ~RoundRobinPacketQueue();
-
-  struct Packet {
-    Packet(RtpPacketSender::Priority priority,
-           uint32_t ssrc,
-           uint16_t seq_number,
-           int64_t capture_time_ms,
-           int64_t enqueue_time_ms,
-           size_t length_in_bytes,
-           bool retransmission,
-           uint64_t enqueue_order);
-    Packet(const Packet& other);
-    virtual ~Packet();
-    bool operator<(const Packet& other) const;
-
-    RtpPacketSender::Priority priority;
-    uint32_t ssrc;
-    uint16_t sequence_number;
-    int64_t capture_time_ms;  // Absolute time of frame capture.
-    int64_t enqueue_time_ms;  // Absolute time of pacer queue entry.
-    int64_t sum_paused_ms;
-    size_t bytes;
-    bool retransmission;
-    uint64_t enqueue_order;
-    std::list<Packet>::iterator this_it;
-    std::multiset<int64_t>::iterator enqueue_time_it;
-  };
+  ~RoundRobinPacketQueue() override;
 
-  void Push(const Packet& packet);
-  const Packet& BeginPop();
-  void CancelPop(const Packet& packet);
-  void FinalizePop(const Packet& packet);
+  void Push(const Packet& packet) override;
+  const Packet& BeginPop() override;
+  void CancelPop(const Packet& packet) override;
+  void FinalizePop(const Packet& packet) override;
 
-  bool Empty() const;
-  size_t SizeInPackets() const;
-  uint64_t SizeInBytes() const;
+  bool Empty() const override;
+  size_t SizeInPackets() const override;
+  uint64_t SizeInBytes() const override;
 
-  int64_t OldestEnqueueTimeMs() const;
-  int64_t AverageQueueTimeMs() const;
-  void UpdateQueueTime(int64_t timestamp_ms);
-  void SetPauseState(bool paused, int64_t timestamp_ms);
+  int64_t OldestEnqueueTimeMs() const override;
+  int64_t AverageQueueTimeMs() const override;
+  void UpdateQueueTime(int64_t timestamp_ms) override;
+  void SetPauseState(bool paused, int64_t timestamp_ms) override;
 
  private:
   struct StreamPrioKey {
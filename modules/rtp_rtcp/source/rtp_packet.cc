@@ -31,6 +31,8 @@ constexpr size_t kTwoByteExtensionHeaderLength = 2;
 constexpr size_t kDefaultPacketSize = 1500;
 }  // namespace
 
+constexpr size_t RtpPacket::kMaxExtensions;
+
 //  0                   1                   2                   3
 //  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
 // +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
@@ -73,6 +75,7 @@ RtpPacket::~RtpPacket() {}
 
 void RtpPacket::IdentifyExtensions(const ExtensionManager& extensions) {
   extensions_ = extensions;
+  UpdateExtensionIndex();
 }
 
 bool RtpPacket::Parse(const uint8_t* buffer, size_t buffer_size) {
@@ -122,6 +125,9 @@ void RtpPacket::CopyHeaderFrom(const RtpPacket& packet) {
   payload_offset_ = packet.payload_offset_;
   extensions_ = packet.extensions_;
   extension_entries_ = packet.extension_entries_;
+  num_extension_entries_ = packet.num_extension_entries_;
+  memcpy(extension_index_by_type_, packet.extension_index_by_type_,
+         sizeof(extension_index_by_type_));
   extensions_size_ = packet.extensions_size_;
   buffer_.SetData(packet.data(), packet.headers_size());
   // Reset payload and padding.
@@ -202,6 +208,11 @@ rtc::ArrayView<uint8_t> RtpPacket::AllocateRawExtension(int id, size_t length) {
                       << " after padding was set.";
     return nullptr;
   }
+  if (num_extension_entries_ == kMaxExtensions) {
+    RTC_LOG(LS_ERROR) << "Can't add new extension id " << id
+                      << ", too many extensions.";
+    return nullptr;
+  }
 
   const size_t num_csrc = data()[0] & 0x0F;
   const size_t extensions_offset = kFixedHeaderSize + (num_csrc * 4) + 4;
@@ -222,7 +233,7 @@ rtc::ArrayView<uint8_t> RtpPacket::AllocateRawExtension(int id, size_t length) {
       // The header extension will grow with one byte per already allocated
       // extension + the size of the extension that is about to be allocated.
       size_t expected_new_extensions_size =
-          extensions_size_ + extension_entries_.size() +
+          extensions_size_ + num_extension_entries_ +
           kTwoByteExtensionHeaderLength + length;
       if (extensions_offset + expected_new_extensions_size > capacity()) {
         RTC_LOG(LS_ERROR)
@@ -276,8 +287,11 @@ rtc::ArrayView<uint8_t> RtpPacket::AllocateRawExtension(int id, size_t length) {
   const uint16_t extension_info_offset = rtc::dchecked_cast<uint16_t>(
       extensions_offset + extensions_size_ + extension_header_size);
   const uint8_t extension_info_length = rtc::dchecked_cast<uint8_t>(length);
-  extension_entries_.emplace_back(id, extension_info_length,
-                                  extension_info_offset);
+  extension_entries_[num_extension_entries_++] =
+      ExtensionInfo(id, extension_info_length, extension_info_offset);
+  const RTPExtensionType type = extensions_.GetType(id);
+  if (type != ExtensionManager::kInvalidType)
+    extension_index_by_type_[type] = num_extension_entries_;
 
   extensions_size_ = new_extensions_size;
 
@@ -293,32 +307,32 @@ void RtpPacket::PromoteToTwoByteHeaderExtension() {
   size_t num_csrc = data()[0] & 0x0F;
   size_t extensions_offset = kFixedHeaderSize + (num_csrc * 4) + 4;
 
-  RTC_CHECK_GT(extension_entries_.size(), 0);
+  RTC_CHECK_GT(num_extension_entries_, 0);
   RTC_CHECK_EQ(payload_size_, 0);
   RTC_CHECK_EQ(kOneByteExtensionProfileId, ByteReader<uint16_t>::ReadBigEndian(
                                                data() + extensions_offset - 4));
   // Rewrite data.
   // Each extension adds one to the offset. The write-read delta for the last
   // extension is therefore the same as the number of extension entries.
-  size_t write_read_delta = extension_entries_.size();
-  for (auto extension_entry = extension_entries_.rbegin();
-       extension_entry != extension_entries_.rend(); ++extension_entry) {
-    size_t read_index = extension_entry->offset;
+  size_t write_read_delta = num_extension_entries_;
+  for (size_t i = num_extension_entries_; i > 0; --i) {
+    ExtensionInfo& extension_entry = extension_entries_[i - 1];
+    size_t read_index = extension_entry.offset;
     size_t write_index = read_index + write_read_delta;
     // Update offset.
-    extension_entry->offset = rtc::dchecked_cast<uint16_t>(write_index);
+    extension_entry.offset = rtc::dchecked_cast<uint16_t>(write_index);
     // Copy data. Use memmove since read/write regions may overlap.
-    memmove(WriteAt(write_index), data() + read_index, extension_entry->length);
+    memmove(WriteAt(write_index), data() + read_index, extension_entry.length);
     // Rewrite id and length.
-    WriteAt(--write_index, extension_entry->length);
-    WriteAt(--write_index, extension_entry->id);
+    WriteAt(--write_index, extension_entry.length);
+    WriteAt(--write_index, extension_entry.id);
     --write_read_delta;
   }
 
   // Update profile header, extensions length, and zero padding.
   ByteWriter<uint16_t>::WriteBigEndian(WriteAt(extensions_offset - 4),
                                        kTwoByteExtensionProfileId);
-  extensions_size_ += extension_entries_.size();
+  extensions_size_ += num_extension_entries_;
   uint16_t extensions_size_padded =
       SetExtensionLengthMaybeAddZeroPadding(extensions_offset);
   payload_offset_ = extensions_offset + extensions_size_padded;
@@ -389,7 +403,8 @@ void RtpPacket::Clear() {
   payload_size_ = 0;
   padding_size_ = 0;
   extensions_size_ = 0;
-  extension_entries_.clear();
+  num_extension_entries_ = 0;
+  memset(extension_index_by_type_, 0, sizeof(extension_index_by_type_));
 
   memset(WriteAt(0), 0, kFixedHeaderSize);
   buffer_.SetSize(kFixedHeaderSize);
@@ -429,7 +444,7 @@ bool RtpPacket::ParseBuffer(const uint8_t* buffer, size_t size) {
   }
 
   extensions_size_ = 0;
-  extension_entries_.clear();
+  num_extension_entries_ = 0;
   if (has_extension) {
     /* RTP header extension, RFC 3550.
      0                   1                   2                   3
@@ -487,8 +502,14 @@ bool RtpPacket::ParseBuffer(const uint8_t* buffer, size_t size) {
           break;
         }
 
-        ExtensionInfo& extension_info = FindOrCreateExtensionInfo(id);
-        if (extension_info.length != 0) {
+        ExtensionInfo* extension_info = FindOrCreateExtensionInfo(id);
+        if (extension_info == nullptr) {
+          RTC_LOG(LS_WARNING)
+              << "Too many rtp header extensions. Ignoring id " << id << ".";
+          extensions_size_ += extension_header_length + length;
+          continue;
+        }
+        if (extension_info->length != 0) {
           RTC_LOG(LS_VERBOSE)
               << "Duplicate rtp header extension id " << id << ". Overwriting.";
         }
@@ -499,13 +520,14 @@ bool RtpPacket::ParseBuffer(const uint8_t* buffer, size_t size) {
           RTC_DLOG(LS_WARNING) << "Oversized rtp header extension.";
           break;
         }
-        extension_info.offset = static_cast<uint16_t>(offset);
-        extension_info.length = length;
+        extension_info->offset = static_cast<uint16_t>(offset);
+        extension_info->length = length;
         extensions_size_ += extension_header_length + length;
       }
     }
     payload_offset_ = extension_offset + extensions_capacity;
   }
+  UpdateExtensionIndex();
 
   if (payload_offset_ + padding_size_ > size) {
     return false;
@@ -515,37 +537,50 @@ bool RtpPacket::ParseBuffer(const uint8_t* buffer, size_t size) {
 }
 
 const RtpPacket::ExtensionInfo* RtpPacket::FindExtensionInfo(int id) const {
-  for (const ExtensionInfo& extension : extension_entries_) {
-    if (extension.id == id) {
-      return &extension;
+  for (size_t i = 0; i < num_extension_entries_; ++i) {
+    if (extension_entries_[i].id == id) {
+      return &extension_entries_[i];
     }
   }
   return nullptr;
 }
 
-RtpPacket::ExtensionInfo& RtpPacket::FindOrCreateExtensionInfo(int id) {
-  for (ExtensionInfo& extension : extension_entries_) {
-    if (extension.id == id) {
-      return extension;
+RtpPacket::ExtensionInfo* RtpPacket::FindOrCreateExtensionInfo(int id) {
+  for (size_t i = 0; i < num_extension_entries_; ++i) {
+    if (extension_entries_[i].id == id) {
+      return &extension_entries_[i];
     }
   }
-  extension_entries_.emplace_back(id);
-  return extension_entries_.back();
+  if (num_extension_entries_ == kMaxExtensions) {
+    return nullptr;
+  }
+  ExtensionInfo& extension = extension_entries_[num_extension_entries_++];
+  extension = ExtensionInfo(id);
+  return &extension;
+}
+
+void RtpPacket::UpdateExtensionIndex() {
+  memset(extension_index_by_type_, 0, sizeof(extension_index_by_type_));
+  for (size_t i = 0; i < num_extension_entries_; ++i) {
+    const RTPExtensionType type =
+        extensions_.GetType(extension_entries_[i].id);
+    if (type != ExtensionManager::kInvalidType)
+      extension_index_by_type_[type] = rtc::dchecked_cast<uint8_t>(i + 1);
+  }
 }
 
 rtc::ArrayView<const uint8_t> RtpPacket::FindExtension(
     ExtensionType type) const {
-  uint8_t id = extensions_.GetId(type);
-  if (id == ExtensionManager::kInvalidId) {
-    // Extension not registered.
-    return nullptr;
-  }
-  ExtensionInfo const* extension_info = FindExtensionInfo(id);
-  if (extension_info == nullptr) {
+  RTC_DCHECK_GT(type, kRtpExtensionNone);
+  RTC_DCHECK_LT(type, kRtpExtensionNumberOfExtensions);
+  // Unregistered extensions and extensions not in the packet have index 0.
+  const uint8_t index = extension_index_by_type_[type];
+  if (index == 0) {
     return nullptr;
   }
-  return rtc::MakeArrayView(data() + extension_info->offset,
-                            extension_info->length);
+  const ExtensionInfo& extension_info = extension_entries_[index - 1];
+  return rtc::MakeArrayView(data() + extension_info.offset,
+                            extension_info.length);
 }
 
 rtc::ArrayView<uint8_t> RtpPacket::AllocateExtension(ExtensionType type,
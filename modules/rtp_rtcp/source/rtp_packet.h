@@ -10,6 +10,7 @@
 #ifndef MODULES_RTP_RTCP_SOURCE_RTP_PACKET_H_
 #define MODULES_RTP_RTCP_SOURCE_RTP_PACKET_H_
 
+#include <array>
 #include <vector>
 
 #include "absl/types/optional.h"
@@ -125,6 +126,7 @@ class RtpPacket {
 
  private:
   struct ExtensionInfo {
+    ExtensionInfo() : ExtensionInfo(0, 0, 0) {}
     explicit ExtensionInfo(uint8_t id) : ExtensionInfo(id, 0, 0) {}
     ExtensionInfo(uint8_t id, uint8_t length, uint16_t offset)
         : id(id), length(length), offset(offset) {}
@@ -133,6 +135,11 @@ class RtpPacket {
     uint16_t offset;
   };
 
+  // Maximum number of distinct extensions kept for a packet. The one-byte
+  // header format allows 14 ids; with the two-byte format any extensions
+  // beyond this are ignored.
+  static constexpr size_t kMaxExtensions = 16;
+
   // Helper function for Parse. Fill header fields using data in given buffer,
   // but does not touch packet own buffer, leaving packet in invalid state.
   bool ParseBuffer(const uint8_t* buffer, size_t size);
@@ -141,9 +148,14 @@ class RtpPacket {
   // found.
   const ExtensionInfo* FindExtensionInfo(int id) const;
 
-  // Returns reference to extension info for a given id. Creates a new entry
-  // with the specified id if not found.
-  ExtensionInfo& FindOrCreateExtensionInfo(int id);
+  // Returns pointer to extension info for a given id. Creates a new entry
+  // with the specified id if not found. Returns nullptr if there is no room
+  // for a new entry.
+  ExtensionInfo* FindOrCreateExtensionInfo(int id);
+
+  // Recomputes |extension_index_by_type_| from |extension_entries_| and
+  // |extensions_|.
+  void UpdateExtensionIndex();
 
   // Find an extension |type|.
   // Returns view of the raw extension or empty view on failure.
@@ -177,7 +189,14 @@ class RtpPacket {
   size_t payload_size_;
 
   ExtensionManager extensions_;
-  std::vector<ExtensionInfo> extension_entries_;
+  // Extensions present in the packet, in the order they appear, stored inline
+  // so that parsing a packet doesn't allocate.
+  std::array<ExtensionInfo, kMaxExtensions> extension_entries_;
+  uint8_t num_extension_entries_ = 0;
+  // Index + 1 in |extension_entries_| of the entry for each extension type
+  // registered in |extensions_|, or 0 if the packet doesn't have it. Makes
+  // FindExtension() a table lookup.
+  uint8_t extension_index_by_type_[kRtpExtensionNumberOfExtensions];
   size_t extensions_size_ = 0;  // Unaligned.
   rtc::CopyOnWriteBuffer buffer_;
 };
@@ -16,6 +16,7 @@
 
 #include "absl/memory/memory.h"
 #include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/arraysize.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "system_wrappers/include/clock.h"
@@ -33,12 +34,53 @@ size_t SizeDiff(size_t packet_size, size_t size) {
   }
   return size - packet_size;
 }
+
+// Returns the index of the highest set bit in |bits|, which must be non-zero.
+int HighestSetBit(uint64_t bits) {
+  int index = 0;
+  for (int shift = 32; shift > 0; shift /= 2) {
+    if (bits >> shift) {
+      bits >>= shift;
+      index += shift;
+    }
+  }
+  return index;
+}
+
+// Returns the highest set bit at or below |index| in the bitmap |words|, or
+// -1 if there is none.
+int FindSetBitAtOrBelow(const uint64_t* words, int index) {
+  int word = index / 64;
+  uint64_t bits = words[word] & (~uint64_t{0} >> (63 - index % 64));
+  while (bits == 0) {
+    if (word == 0)
+      return -1;
+    bits = words[--word];
+  }
+  return word * 64 + HighestSetBit(bits);
+}
+
+// Returns the lowest set bit at or above |index| in the bitmap |words| of
+// |num_words| words, or -1 if there is none.
+int FindSetBitAtOrAbove(const uint64_t* words, int num_words, int index) {
+  int word = index / 64;
+  uint64_t bits = words[word] & (~uint64_t{0} << (index % 64));
+  while (bits == 0) {
+    if (++word == num_words)
+      return -1;
+    bits = words[word];
+  }
+  return word * 64 + HighestSetBit(bits & (~bits + 1));
+}
 }  // namespace
 
 constexpr size_t RtpPacketHistory::kMaxCapacity;
 constexpr int64_t RtpPacketHistory::kMinPacketDurationMs;
 constexpr int RtpPacketHistory::kMinPacketDurationRtt;
 constexpr int RtpPacketHistory::kPacketCullingDelayFactor;
+constexpr size_t RtpPacketHistory::kMinRingSize;
+constexpr size_t RtpPacketHistory::kMaxRingSize;
+constexpr size_t RtpPacketHistory::kNumPacketSizeSlots;
 
 RtpPacketHistory::PacketState::PacketState() = default;
 RtpPacketHistory::PacketState::PacketState(const PacketState&) = default;
@@ -54,7 +96,13 @@ RtpPacketHistory::RtpPacketHistory(Clock* clock)
     : clock_(clock),
       number_to_store_(0),
       mode_(StorageMode::kDisabled),
-      rtt_ms_(-1) {}
+      rtt_ms_(-1),
+      first_seqno_(0),
+      window_size_(0),
+      num_packets_(0) {
+  std::fill(packet_size_present_,
+            packet_size_present_ + arraysize(packet_size_present_), 0);
+}
 
 RtpPacketHistory::~RtpPacketHistory() {}
 
@@ -68,6 +116,11 @@ void RtpPacketHistory::SetStorePacketsStatus(StorageMode mode,
   Reset();
   mode_ = mode;
   number_to_store_ = std::min(kMaxCapacity, number_to_store);
+  if (mode_ != StorageMode::kDisabled) {
+    // Preallocate for the expected number of packets, to avoid growing the
+    // ring while sending.
+    EnsureRingSize(number_to_store_);
+  }
 }
 
 RtpPacketHistory::StorageMode RtpPacketHistory::GetStorageMode() const {
@@ -95,16 +148,14 @@ void RtpPacketHistory::PutRtpPacket(std::unique_ptr<RtpPacketToSend> packet,
 
   // Store packet.
   const uint16_t rtp_seq_no = packet->SequenceNumber();
-  StoredPacket& stored_packet = packet_history_[rtp_seq_no];
+  StoredPacket& stored_packet = GetOrCreateSlot(rtp_seq_no);
   RTC_DCHECK(stored_packet.packet == nullptr);
   if (stored_packet.packet) {
     // It is an error if this happen. But it can happen if the sequence numbers
     // for some reason restart without that the history has been reset.
-    auto size_iterator = packet_size_.find(stored_packet.packet->size());
-    if (size_iterator != packet_size_.end() &&
-        size_iterator->second == stored_packet.packet->SequenceNumber()) {
-      packet_size_.erase(size_iterator);
-    }
+    RemoveFromSizeIndex(*stored_packet.packet);
+  } else {
+    ++num_packets_;
   }
   stored_packet.packet = std::move(packet);
 
@@ -115,12 +166,9 @@ void RtpPacketHistory::PutRtpPacket(std::unique_ptr<RtpPacketToSend> packet,
   stored_packet.storage_type = type;
   stored_packet.times_retransmitted = 0;
 
-  if (!start_seqno_) {
-    start_seqno_ = rtp_seq_no;
-  }
   // Store the sequence number of the last send packet with this size.
   if (type != StorageType::kDontRetransmit) {
-    packet_size_[stored_packet.packet->size()] = rtp_seq_no;
+    AddToSizeIndex(*stored_packet.packet);
   }
 }
 
@@ -132,13 +180,13 @@ std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetPacketAndSetSendTime(
   }
 
   int64_t now_ms = clock_->TimeInMilliseconds();
-  StoredPacketIterator rtp_it = packet_history_.find(sequence_number);
-  if (rtp_it == packet_history_.end()) {
+  StoredPacket* stored_packet = FindPacket(sequence_number);
+  if (stored_packet == nullptr) {
     return nullptr;
   }
 
-  StoredPacket& packet = rtp_it->second;
-  if (!VerifyRtt(rtp_it->second, now_ms)) {
+  StoredPacket& packet = *stored_packet;
+  if (!VerifyRtt(packet, now_ms)) {
     return nullptr;
   }
 
@@ -152,7 +200,7 @@ std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetPacketAndSetSendTime(
   if (packet.storage_type == StorageType::kDontRetransmit) {
     // Non retransmittable packet, so call must come from paced sender.
     // Remove from history and return actual packet instance.
-    return RemovePacket(rtp_it);
+    return RemovePacket(sequence_number);
   }
   return absl::make_unique<RtpPacketToSend>(*packet.packet);
 }
@@ -164,16 +212,16 @@ absl::optional<RtpPacketHistory::PacketState> RtpPacketHistory::GetPacketState(
     return absl::nullopt;
   }
 
-  auto rtp_it = packet_history_.find(sequence_number);
-  if (rtp_it == packet_history_.end()) {
+  const StoredPacket* stored_packet = FindPacket(sequence_number);
+  if (stored_packet == nullptr) {
     return absl::nullopt;
   }
 
-  if (!VerifyRtt(rtp_it->second, clock_->TimeInMilliseconds())) {
+  if (!VerifyRtt(*stored_packet, clock_->TimeInMilliseconds())) {
     return absl::nullopt;
   }
 
-  return StoredPacketToPacketState(rtp_it->second);
+  return StoredPacketToPacketState(*stored_packet);
 }
 
 bool RtpPacketHistory::VerifyRtt(const RtpPacketHistory::StoredPacket& packet,
@@ -196,81 +244,88 @@ std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetBestFittingPacket(
     size_t packet_length) const {
   // TODO(sprang): Make this smarter, taking retransmit count etc into account.
   rtc::CritScope cs(&lock_);
-  if (packet_length < kMinPacketRequestBytes || packet_size_.empty()) {
+  if (packet_length < kMinPacketRequestBytes) {
     return nullptr;
   }
 
-  auto size_iter_upper = packet_size_.upper_bound(packet_length);
-  auto size_iter_lower = size_iter_upper;
-  if (size_iter_upper == packet_size_.end()) {
-    --size_iter_upper;
+  // Find the closest present sizes below and above the requested one. If
+  // there is only one of them, it is used for both.
+  const int target_slot =
+      static_cast<int>(std::min(packet_length, kNumPacketSizeSlots - 1));
+  int lower_slot = FindSetBitAtOrBelow(packet_size_present_, target_slot);
+  int upper_slot =
+      target_slot + 1 < static_cast<int>(kNumPacketSizeSlots)
+          ? FindSetBitAtOrAbove(packet_size_present_,
+                                arraysize(packet_size_present_),
+                                target_slot + 1)
+          : -1;
+  if (lower_slot < 0 && upper_slot < 0) {
+    return nullptr;
   }
-  if (size_iter_lower != packet_size_.begin()) {
-    --size_iter_lower;
+  if (lower_slot < 0) {
+    lower_slot = upper_slot;
+  } else if (upper_slot < 0) {
+    upper_slot = lower_slot;
   }
-  const size_t upper_bound_diff =
-      SizeDiff(size_iter_upper->first, packet_length);
-  const size_t lower_bound_diff =
-      SizeDiff(size_iter_lower->first, packet_length);
+  const size_t upper_bound_diff = SizeDiff(upper_slot, packet_length);
+  const size_t lower_bound_diff = SizeDiff(lower_slot, packet_length);
 
   const uint16_t seq_no = upper_bound_diff < lower_bound_diff
-                              ? size_iter_upper->second
-                              : size_iter_lower->second;
-  auto history_it = packet_history_.find(seq_no);
-  if (history_it == packet_history_.end()) {
+                              ? packet_size_seqno_[upper_slot]
+                              : packet_size_seqno_[lower_slot];
+  const StoredPacket* stored_packet = FindPacket(seq_no);
+  if (stored_packet == nullptr) {
     RTC_LOG(LS_ERROR) << "Can't find packet in history with seq_no" << seq_no;
     RTC_DCHECK(false);
     return nullptr;
   }
-  if (!history_it->second.packet) {
-    RTC_LOG(LS_ERROR) << "Packet pointer is null in history for seq_no"
-                      << seq_no;
-    RTC_DCHECK(false);
-    return nullptr;
-  }
-  RtpPacketToSend* best_packet = history_it->second.packet.get();
+  RtpPacketToSend* best_packet = stored_packet->packet.get();
   return absl::make_unique<RtpPacketToSend>(*best_packet);
 }
 
 void RtpPacketHistory::Reset() {
-  packet_history_.clear();
-  packet_size_.clear();
-  start_seqno_.reset();
+  const size_t mask = packet_history_.size() - 1;
+  for (size_t i = 0; i < window_size_; ++i) {
+    packet_history_[(first_seqno_ + i) & mask] = StoredPacket();
+  }
+  first_seqno_ = 0;
+  window_size_ = 0;
+  num_packets_ = 0;
+  std::fill(packet_size_present_,
+            packet_size_present_ + arraysize(packet_size_present_), 0);
 }
 
 void RtpPacketHistory::CullOldPackets(int64_t now_ms) {
   int64_t packet_duration_ms =
       std::max(kMinPacketDurationRtt * rtt_ms_, kMinPacketDurationMs);
-  while (!packet_history_.empty()) {
-    auto stored_packet_it = packet_history_.find(*start_seqno_);
-    RTC_DCHECK(stored_packet_it != packet_history_.end());
-
-    if (packet_history_.size() >= kMaxCapacity) {
+  while (num_packets_ > 0) {
+    if (num_packets_ >= kMaxCapacity) {
       // We have reached the absolute max capacity, remove one packet
       // unconditionally.
-      RemovePacket(stored_packet_it);
+      RemovePacket(first_seqno_);
       continue;
     }
 
-    const StoredPacket& stored_packet = stored_packet_it->second;
-    if (!stored_packet.send_time_ms) {
+    const StoredPacket* stored_packet = FindPacket(first_seqno_);
+    RTC_DCHECK(stored_packet);
+    if (!stored_packet->send_time_ms) {
       // Don't remove packets that have not been sent.
       return;
     }
 
-    if (*stored_packet.send_time_ms + packet_duration_ms > now_ms) {
+    if (*stored_packet->send_time_ms + packet_duration_ms > now_ms) {
       // Don't cull packets too early to avoid failed retransmission requests.
       return;
     }
 
-    if (packet_history_.size() >= number_to_store_ ||
+    if (num_packets_ >= number_to_store_ ||
         (mode_ == StorageMode::kStoreAndCull &&
-         *stored_packet.send_time_ms +
+         *stored_packet->send_time_ms +
                  (packet_duration_ms * kPacketCullingDelayFactor) <=
              now_ms)) {
       // Too many packets in history, or this packet has timed out. Remove it
       // and continue.
-      RemovePacket(stored_packet_it);
+      RemovePacket(first_seqno_);
     } else {
       // No more packets can be removed right now.
       return;
@@ -278,36 +333,123 @@ void RtpPacketHistory::CullOldPackets(int64_t now_ms) {
   }
 }
 
-std::unique_ptr<RtpPacketToSend> RtpPacketHistory::RemovePacket(
-    StoredPacketIterator packet_it) {
-  // Move the packet out from the StoredPacket container.
-  std::unique_ptr<RtpPacketToSend> rtp_packet =
-      std::move(packet_it->second.packet);
-  // Erase the packet from the map, and capture iterator to the next one.
-  StoredPacketIterator next_it = packet_history_.erase(packet_it);
+RtpPacketHistory::StoredPacket* RtpPacketHistory::FindPacket(
+    uint16_t sequence_number) {
+  const auto* const_this = this;
+  return const_cast<StoredPacket*>(const_this->FindPacket(sequence_number));
+}
 
-  // |next_it| now points to the next element, or to the end. If the end,
-  // check if we can wrap around.
-  if (next_it == packet_history_.end()) {
-    next_it = packet_history_.begin();
+const RtpPacketHistory::StoredPacket* RtpPacketHistory::FindPacket(
+    uint16_t sequence_number) const {
+  const uint16_t offset = sequence_number - first_seqno_;
+  if (offset >= window_size_) {
+    return nullptr;
   }
+  const StoredPacket& stored_packet =
+      packet_history_[sequence_number & (packet_history_.size() - 1)];
+  return stored_packet.packet ? &stored_packet : nullptr;
+}
 
-  // Update |start_seq_no| to the new oldest item.
-  if (next_it != packet_history_.end()) {
-    start_seqno_ = next_it->first;
-  } else {
-    start_seqno_.reset();
+RtpPacketHistory::StoredPacket& RtpPacketHistory::GetOrCreateSlot(
+    uint16_t sequence_number) {
+  if (num_packets_ == 0) {
+    first_seqno_ = sequence_number;
+    window_size_ = 0;
+  }
+  uint16_t offset = sequence_number - first_seqno_;
+  if (offset >= window_size_) {
+    if (offset < 0x8000) {
+      // Newer than all stored packets. Make room by removing the oldest
+      // packets if the window would no longer fit in the ring, which can only
+      // happen if there are gaps in the sequence numbers.
+      while (num_packets_ > 0 && offset >= kMaxRingSize) {
+        RemovePacket(first_seqno_);
+        offset = sequence_number - first_seqno_;
+      }
+      if (num_packets_ == 0) {
+        first_seqno_ = sequence_number;
+        offset = 0;
+      }
+      window_size_ = offset + 1;
+    } else {
+      // Older than all stored packets, so the sequence numbers have jumped
+      // backwards.
+      const uint16_t extension = first_seqno_ - sequence_number;
+      if (window_size_ + extension > kMaxRingSize) {
+        RTC_LOG(LS_WARNING) << "Purging packet history on sequence number "
+                               "jump to "
+                            << sequence_number;
+        Reset();
+        window_size_ = 1;
+      } else {
+        window_size_ += extension;
+      }
+      first_seqno_ = sequence_number;
+    }
+    EnsureRingSize(window_size_);
   }
+  return packet_history_[sequence_number & (packet_history_.size() - 1)];
+}
 
-  auto size_iterator = packet_size_.find(rtp_packet->size());
-  if (size_iterator != packet_size_.end() &&
-      size_iterator->second == rtp_packet->SequenceNumber()) {
-    packet_size_.erase(size_iterator);
+void RtpPacketHistory::EnsureRingSize(size_t min_size) {
+  RTC_DCHECK_LE(min_size, kMaxRingSize);
+  size_t size = std::max(packet_history_.size(), kMinRingSize);
+  while (size < min_size) {
+    size *= 2;
+  }
+  if (size == packet_history_.size()) {
+    return;
   }
+  std::vector<StoredPacket> ring(size);
+  const size_t old_mask = packet_history_.size() - 1;
+  for (size_t i = 0; i < window_size_; ++i) {
+    const uint16_t seq_no = first_seqno_ + i;
+    ring[seq_no & (size - 1)] = std::move(packet_history_[seq_no & old_mask]);
+  }
+  packet_history_.swap(ring);
+}
 
+std::unique_ptr<RtpPacketToSend> RtpPacketHistory::RemovePacket(
+    uint16_t sequence_number) {
+  const size_t mask = packet_history_.size() - 1;
+  StoredPacket& stored_packet = packet_history_[sequence_number & mask];
+  RTC_DCHECK(stored_packet.packet);
+  // Move the packet out from the StoredPacket container.
+  std::unique_ptr<RtpPacketToSend> rtp_packet = std::move(stored_packet.packet);
+  stored_packet = StoredPacket();
+  --num_packets_;
+
+  // Shrink the window so that it again starts and ends with a packet. Every
+  // slot is skipped at most once per stored packet, so this is amortized O(1).
+  if (num_packets_ == 0) {
+    window_size_ = 0;
+  } else {
+    while (!packet_history_[first_seqno_ & mask].packet) {
+      ++first_seqno_;
+      --window_size_;
+    }
+    while (!packet_history_[(first_seqno_ + window_size_ - 1) & mask].packet) {
+      --window_size_;
+    }
+  }
+
+  RemoveFromSizeIndex(*rtp_packet);
   return rtp_packet;
 }
 
+void RtpPacketHistory::AddToSizeIndex(const RtpPacketToSend& packet) {
+  const size_t slot = std::min(packet.size(), kNumPacketSizeSlots - 1);
+  packet_size_seqno_[slot] = packet.SequenceNumber();
+  packet_size_present_[slot / 64] |= uint64_t{1} << (slot % 64);
+}
+
+void RtpPacketHistory::RemoveFromSizeIndex(const RtpPacketToSend& packet) {
+  const size_t slot = std::min(packet.size(), kNumPacketSizeSlots - 1);
+  if (packet_size_seqno_[slot] == packet.SequenceNumber()) {
+    packet_size_present_[slot / 64] &= ~(uint64_t{1} << (slot % 64));
+  }
+}
+
 RtpPacketHistory::PacketState RtpPacketHistory::StoredPacketToPacketState(
     const RtpPacketHistory::StoredPacket& stored_packet) {
   RtpPacketHistory::PacketState state;
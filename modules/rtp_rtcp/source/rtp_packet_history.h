@@ -11,7 +11,6 @@
 #ifndef MODULES_RTP_RTCP_SOURCE_RTP_PACKET_HISTORY_H_
 #define MODULES_RTP_RTCP_SOURCE_RTP_PACKET_HISTORY_H_
 
-#include <map>
 #include <memory>
 #include <vector>
 
@@ -110,7 +109,17 @@ class RtpPacketHistory {
     std::unique_ptr<RtpPacketToSend> packet;
   };
 
-  using StoredPacketIterator = std::map<uint16_t, StoredPacket>::iterator;
+  // Packets are kept in a ring indexed by sequence number modulo its size. It
+  // grows by doubling, up to a size where any kMaxCapacity consecutive
+  // sequence numbers fit.
+  static constexpr size_t kMinRingSize = 64;
+  static constexpr size_t kMaxRingSize = 16384;
+  static_assert((kMaxRingSize & (kMaxRingSize - 1)) == 0,
+                "Ring size must be a power of two dividing 2^16.");
+  static_assert(kMaxRingSize >= kMaxCapacity, "Ring too small.");
+  // GetBestFittingPacket() looks up packets by size with byte precision up to
+  // this size. Larger packets share the last slot.
+  static constexpr size_t kNumPacketSizeSlots = 2048;
 
   // Helper method used by GetPacketAndSetSendTime() and GetPacketState() to
   // check if packet has too recently been sent.
@@ -118,9 +127,24 @@ class RtpPacketHistory {
       RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
   void Reset() RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
   void CullOldPackets(int64_t now_ms) RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Returns the stored packet with |sequence_number|, or nullptr.
+  StoredPacket* FindPacket(uint16_t sequence_number)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  const StoredPacket* FindPacket(uint16_t sequence_number) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Extends the window of stored sequence numbers to include
+  // |sequence_number|, removing the oldest packets if the window would get
+  // too large, and returns its slot.
+  StoredPacket& GetOrCreateSlot(uint16_t sequence_number)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void EnsureRingSize(size_t min_size) RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
   // Removes the packet from the history, and context/mapping that has been
   // stored. Returns the RTP packet instance contained within the StoredPacket.
-  std::unique_ptr<RtpPacketToSend> RemovePacket(StoredPacketIterator packet)
+  std::unique_ptr<RtpPacketToSend> RemovePacket(uint16_t sequence_number)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void AddToSizeIndex(const RtpPacketToSend& packet)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void RemoveFromSizeIndex(const RtpPacketToSend& packet)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
   static PacketState StoredPacketToPacketState(
       const StoredPacket& stored_packet);
@@ -131,13 +155,20 @@ class RtpPacketHistory {
   StorageMode mode_ RTC_GUARDED_BY(lock_);
   int64_t rtt_ms_ RTC_GUARDED_BY(lock_);
 
-  // Map from rtp sequence numbers to stored packet.
-  std::map<uint16_t, StoredPacket> packet_history_ RTC_GUARDED_BY(lock_);
-  std::map<size_t, uint16_t> packet_size_ RTC_GUARDED_BY(lock_);
-
+  // Ring of stored packets, where sequence number |n| is kept at index
+  // n % size. Only the |window_size_| slots starting at |first_seqno_| may
+  // hold packets, and the first and last of them always do.
+  std::vector<StoredPacket> packet_history_ RTC_GUARDED_BY(lock_);
   // The earliest packet in the history. This might not be the lowest sequence
   // number, in case there is a wraparound.
-  absl::optional<uint16_t> start_seqno_ RTC_GUARDED_BY(lock_);
+  uint16_t first_seqno_ RTC_GUARDED_BY(lock_);
+  size_t window_size_ RTC_GUARDED_BY(lock_);
+  size_t num_packets_ RTC_GUARDED_BY(lock_);
+
+  // Sequence number of the last retransmittable packet stored with a given
+  // size, and a bitmap of which sizes are present.
+  uint16_t packet_size_seqno_[kNumPacketSizeSlots] RTC_GUARDED_BY(lock_);
+  uint64_t packet_size_present_[kNumPacketSizeSlots / 64] RTC_GUARDED_BY(lock_);
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(RtpPacketHistory);
 };
@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "modules/rtp_rtcp/source/rtp_packet_history.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/random.h"
+#include "system_wrappers/include/clock.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+// A history of 10k packets at the absolute capacity limit, filled by a high
+// bitrate simulcast sender.
+constexpr size_t kHistorySize = RtpPacketHistory::kMaxCapacity;
+constexpr int kPacketsPerMs = 10;
+constexpr int kNumIterations = 200000;
+
+class RtpPacketHistoryPerformanceTest : public ::testing::Test {
+ protected:
+  RtpPacketHistoryPerformanceTest()
+      : clock_(123456), history_(&clock_), random_(0x1234) {
+    history_.SetStorePacketsStatus(RtpPacketHistory::StorageMode::kStoreAndCull,
+                                   kHistorySize);
+    history_.SetRtt(0);
+  }
+
+  void PutPacket() {
+    std::unique_ptr<RtpPacketToSend> packet(new RtpPacketToSend(nullptr));
+    packet->SetSequenceNumber(sequence_number_++);
+    packet->SetPayloadSize(random_.Rand(200, 1200));
+    history_.PutRtpPacket(std::move(packet), kAllowRetransmission,
+                          clock_.TimeInMilliseconds());
+    if (sequence_number_ % kPacketsPerMs == 0)
+      clock_.AdvanceTimeMilliseconds(1);
+  }
+
+  // Fills the history until packets start being culled.
+  void FillHistory() {
+    for (size_t i = 0; i < 2 * kHistorySize; ++i)
+      PutPacket();
+  }
+
+  void ReportNsPerCall(const std::string& measurement, int64_t cpu_ns) {
+    test::PrintResult(measurement, "", "history_10k",
+                      static_cast<double>(cpu_ns) / kNumIterations, "ns",
+                      true);
+  }
+
+  SimulatedClock clock_;
+  RtpPacketHistory history_;
+  Random random_;
+  uint16_t sequence_number_ = 0;
+};
+
+}  // namespace
+
+TEST_F(RtpPacketHistoryPerformanceTest, PutRtpPacket) {
+  FillHistory();
+  const int64_t start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+  for (int i = 0; i < kNumIterations; ++i)
+    PutPacket();
+  ReportNsPerCall("rtp_history_put_packet",
+                  rtc::GetThreadCpuTimeNanos() - start_cpu_ns);
+}
+
+// Retransmits random packets from the history, as when serving a stream of
+// NACKs, while new packets keep being stored.
+TEST_F(RtpPacketHistoryPerformanceTest, GetPacketAndSetSendTime) {
+  FillHistory();
+  int found = 0;
+  const int64_t start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+  for (int i = 0; i < kNumIterations; ++i) {
+    const uint16_t nacked = sequence_number_ - 1 - random_.Rand(0, 5000);
+    if (history_.GetPacketAndSetSendTime(nacked))
+      ++found;
+    if (i % 4 == 0)
+      PutPacket();
+  }
+  ReportNsPerCall("rtp_history_nack_lookup",
+                  rtc::GetThreadCpuTimeNanos() - start_cpu_ns);
+  EXPECT_GT(found, kNumIterations / 2);
+}
+
+TEST_F(RtpPacketHistoryPerformanceTest, GetBestFittingPacket) {
+  FillHistory();
+  int found = 0;
+  const int64_t start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+  for (int i = 0; i < kNumIterations; ++i) {
+    if (history_.GetBestFittingPacket(random_.Rand(50, 1300)))
+      ++found;
+  }
+  ReportNsPerCall("rtp_history_best_fitting_packet",
+                  rtc::GetThreadCpuTimeNanos() - start_cpu_ns);
+  EXPECT_EQ(kNumIterations, found);
+}
+
+}  // namespace webrtc
@@ -578,4 +578,69 @@ TEST_F(RtpPacketHistoryTest,
               ::testing::NotNull());
 }
 
+TEST_F(RtpPacketHistoryTest, HandlesHolesInSequenceNumbers) {
+  hist_.SetStorePacketsStatus(StorageMode::kStore, 10);
+  // Skip every other sequence number, and let the pacer remove a packet from
+  // the middle of the history.
+  for (int i = 0; i < 5; ++i) {
+    hist_.PutRtpPacket(CreateRtpPacket(To16u(kStartSeqNum + 2 * i)),
+                       i == 2 ? kDontRetransmit : kAllowRetransmission,
+                       absl::nullopt);
+  }
+  EXPECT_FALSE(hist_.GetPacketState(To16u(kStartSeqNum + 1)));
+  EXPECT_TRUE(hist_.GetPacketAndSetSendTime(To16u(kStartSeqNum + 4)));
+  EXPECT_FALSE(hist_.GetPacketState(To16u(kStartSeqNum + 4)));
+  for (int i : {0, 1, 3, 4}) {
+    EXPECT_TRUE(hist_.GetPacketState(To16u(kStartSeqNum + 2 * i)));
+  }
+}
+
+TEST_F(RtpPacketHistoryTest, RemovesOldestPacketsOnLargeSequenceNumberJump) {
+  hist_.SetStorePacketsStatus(StorageMode::kStore, 10);
+  hist_.PutRtpPacket(CreateRtpPacket(kStartSeqNum), kAllowRetransmission,
+                     absl::nullopt);
+  hist_.PutRtpPacket(CreateRtpPacket(To16u(kStartSeqNum + 10000)),
+                     kAllowRetransmission, absl::nullopt);
+  EXPECT_TRUE(hist_.GetPacketState(kStartSeqNum));
+
+  // Not even unsent packets can be kept once the sequence numbers span more
+  // than the history can index.
+  hist_.PutRtpPacket(CreateRtpPacket(To16u(kStartSeqNum + 20000)),
+                     kAllowRetransmission, absl::nullopt);
+  EXPECT_FALSE(hist_.GetPacketState(kStartSeqNum));
+  EXPECT_TRUE(hist_.GetPacketState(To16u(kStartSeqNum + 10000)));
+  EXPECT_TRUE(hist_.GetPacketState(To16u(kStartSeqNum + 20000)));
+}
+
+TEST_F(RtpPacketHistoryTest, StoresPacketsOlderThanFirstPacket) {
+  hist_.SetStorePacketsStatus(StorageMode::kStore, 10);
+  hist_.PutRtpPacket(CreateRtpPacket(kStartSeqNum), kAllowRetransmission,
+                     absl::nullopt);
+  hist_.PutRtpPacket(CreateRtpPacket(kStartSeqNum - 5), kAllowRetransmission,
+                     absl::nullopt);
+  EXPECT_TRUE(hist_.GetPacketState(kStartSeqNum));
+  EXPECT_TRUE(hist_.GetPacketState(kStartSeqNum - 5));
+  EXPECT_FALSE(hist_.GetPacketState(kStartSeqNum - 1));
+}
+
+TEST_F(RtpPacketHistoryTest, GetBestFittingPacketWithLargePackets) {
+  hist_.SetStorePacketsStatus(StorageMode::kStore, 10);
+  std::unique_ptr<RtpPacketToSend> packet(new RtpPacketToSend(nullptr, 4000));
+  packet->SetSequenceNumber(kStartSeqNum);
+  packet->SetPayloadSize(3000);
+  hist_.PutRtpPacket(std::move(packet), kAllowRetransmission,
+                     fake_clock_.TimeInMilliseconds());
+  packet = CreateRtpPacket(kStartSeqNum + 1);
+  packet->SetPayloadSize(100);
+  hist_.PutRtpPacket(std::move(packet), kAllowRetransmission,
+                     fake_clock_.TimeInMilliseconds());
+
+  auto best_packet = hist_.GetBestFittingPacket(5000);
+  ASSERT_THAT(best_packet, ::testing::NotNull());
+  EXPECT_EQ(best_packet->SequenceNumber(), kStartSeqNum);
+  best_packet = hist_.GetBestFittingPacket(200);
+  ASSERT_THAT(best_packet, ::testing::NotNull());
+  EXPECT_EQ(best_packet->SequenceNumber(), kStartSeqNum + 1);
+}
+
 }  // namespace webrtc
@@ -0,0 +1,153 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+
+#include <bitset>
+#include <string>
+#include <vector>
+
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/source/rtp_generic_frame_descriptor_extension.h"
+#include "modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/copyonwritebuffer.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/logging.h"
+#include "test/gtest.h"
+#include "test/testsupport/fileutils.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kNumIterations = 200000;
+
+// The rtp_packet_fuzzer seed corpus. Each file starts with two bytes that
+// select the registered extensions, followed by the packet.
+std::string RtpCorpusPath() {
+  const std::string resources_dir =
+      test::DirName(test::ResourcePath("rtp", ""));
+  return test::JoinFilename(test::DirName(resources_dir),
+                            "test/fuzzers/corpora/rtp-corpus");
+}
+
+struct CorpusEntry {
+  RtpHeaderExtensionMap extensions;
+  rtc::CopyOnWriteBuffer packet;
+};
+
+std::vector<CorpusEntry> ReadRtpCorpus() {
+  std::vector<CorpusEntry> corpus;
+  absl::optional<std::vector<std::string>> files =
+      test::ReadDirectory(RtpCorpusPath());
+  if (!files)
+    return corpus;
+  for (const std::string& file : *files) {
+    FILE* f = fopen(file.c_str(), "rb");
+    if (!f)
+      continue;
+    std::vector<uint8_t> data(test::GetFileSize(file));
+    const size_t size = fread(data.data(), 1, data.size(), f);
+    fclose(f);
+    if (size <= 2)
+      continue;
+    // Same extension registration as in rtp_packet_fuzzer.cc.
+    CorpusEntry entry;
+    std::bitset<16> extension_mask(data[0] | (data[1] << 8));
+    for (int i = 1; i < kRtpExtensionNumberOfExtensions; ++i) {
+      if (extension_mask[i])
+        entry.extensions.RegisterByType(i, static_cast<RTPExtensionType>(i));
+    }
+    entry.packet.SetData(data.data() + 2, size - 2);
+    corpus.push_back(entry);
+  }
+  return corpus;
+}
+
+// Looks up every known extension, as a receiver does over the course of
+// handling a packet.
+size_t GetAllRawExtensions(const RtpPacketReceived& packet) {
+  return packet.GetRawExtension<TransmissionOffset>().size() +
+         packet.GetRawExtension<AudioLevel>().size() +
+         packet.GetRawExtension<AbsoluteSendTime>().size() +
+         packet.GetRawExtension<VideoOrientation>().size() +
+         packet.GetRawExtension<TransportSequenceNumber>().size() +
+         packet.GetRawExtension<PlayoutDelayLimits>().size() +
+         packet.GetRawExtension<VideoContentTypeExtension>().size() +
+         packet.GetRawExtension<VideoTimingExtension>().size() +
+         packet.GetRawExtension<FrameMarkingExtension>().size() +
+         packet.GetRawExtension<RtpStreamId>().size() +
+         packet.GetRawExtension<RepairedRtpStreamId>().size() +
+         packet.GetRawExtension<RtpMid>().size() +
+         packet.GetRawExtension<RtpGenericFrameDescriptorExtension>().size() +
+         packet.GetRawExtension<HdrMetadataExtension>().size();
+}
+
+// Returns the CPU time in ns per packet to parse |packet| and look up all
+// extensions in it.
+double ParseAndGetExtensionsNs(const RtpHeaderExtensionMap& extensions,
+                               const rtc::CopyOnWriteBuffer& buffer) {
+  size_t total_size = 0;
+  const int64_t start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+  for (int i = 0; i < kNumIterations; ++i) {
+    RtpPacketReceived packet(&extensions);
+    if (packet.Parse(buffer))
+      total_size += GetAllRawExtensions(packet);
+  }
+  const int64_t elapsed_cpu_ns = rtc::GetThreadCpuTimeNanos() - start_cpu_ns;
+  // Keep the lookups from being optimized away.
+  EXPECT_GE(total_size, 0u);
+  return static_cast<double>(elapsed_cpu_ns) / kNumIterations;
+}
+
+}  // namespace
+
+TEST(RtpPacketPerformanceTest, ParseFuzzerCorpus) {
+  std::vector<CorpusEntry> corpus = ReadRtpCorpus();
+  ASSERT_FALSE(corpus.empty()) << "No packets found in " << RtpCorpusPath();
+
+  // Some of the corpus packets are malformed on purpose, don't measure the
+  // warnings logged for them.
+  const rtc::LoggingSeverity log_severity = rtc::LogMessage::GetLogToDebug();
+  rtc::LogMessage::LogToDebug(rtc::LS_NONE);
+  double total_ns = 0;
+  for (const CorpusEntry& entry : corpus)
+    total_ns += ParseAndGetExtensionsNs(entry.extensions, entry.packet);
+  rtc::LogMessage::LogToDebug(log_severity);
+  test::PrintResult("rtp_packet_parse_cpu_time", "", "fuzzer_corpus",
+                    total_ns / corpus.size(), "ns", true);
+}
+
+// The extensions sent with every packet by our senders.
+TEST(RtpPacketPerformanceTest, ParseSenderLayout) {
+  RtpHeaderExtensionMap extensions;
+  extensions.Register<AudioLevel>(1);
+  extensions.Register<AbsoluteSendTime>(3);
+  extensions.Register<TransportSequenceNumber>(5);
+  extensions.Register<RtpMid>(9);
+  RtpPacketToSend send_packet(&extensions);
+  send_packet.SetPayloadType(111);
+  send_packet.SetSequenceNumber(1234);
+  send_packet.SetTimestamp(567890);
+  send_packet.SetSsrc(0x12345678);
+  ASSERT_TRUE(send_packet.SetExtension<AbsoluteSendTime>(0x123456));
+  ASSERT_TRUE(send_packet.SetExtension<TransportSequenceNumber>(42));
+  ASSERT_TRUE(send_packet.SetExtension<RtpMid>("audio"));
+  ASSERT_TRUE(send_packet.SetExtension<AudioLevel>(true, 30));
+  send_packet.SetPayloadSize(160);
+
+  test::PrintResult("rtp_packet_parse_cpu_time", "", "sender_layout",
+                    ParseAndGetExtensionsNs(extensions, send_packet.Buffer()),
+                    "ns", true);
+}
+
+}  // namespace webrtc
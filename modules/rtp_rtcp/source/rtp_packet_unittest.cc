@@ -716,6 +716,44 @@ TEST(RtpPacketTest, ParseWithExtensionDelayed) {
   EXPECT_EQ(0u, packet.padding_size());
 }
 
+TEST(RtpPacketTest, ParseWithExtensionsReidentified) {
+  RtpPacketToSend::ExtensionManager extensions;
+  extensions.Register(kRtpExtensionTransmissionTimeOffset,
+                      kTransmissionOffsetExtensionId);
+  RtpPacketReceived packet(&extensions);
+  EXPECT_TRUE(packet.Parse(kPacketWithTOAndAL, sizeof(kPacketWithTOAndAL)));
+  EXPECT_TRUE(packet.HasExtension<TransmissionOffset>());
+  EXPECT_FALSE(packet.HasExtension<AudioLevel>());
+
+  RtpPacketToSend::ExtensionManager other_extensions;
+  other_extensions.Register(kRtpExtensionAudioLevel, kAudioLevelExtensionId);
+  packet.IdentifyExtensions(other_extensions);
+  EXPECT_FALSE(packet.HasExtension<TransmissionOffset>());
+  bool voice_active;
+  uint8_t audio_level;
+  EXPECT_TRUE(packet.GetExtension<AudioLevel>(&voice_active, &audio_level));
+  EXPECT_EQ(kAudioLevel, audio_level);
+}
+
+TEST(RtpPacketTest, ParseIgnoresExtensionsBeyondMaximumNumber) {
+  // Two-byte header with 20 one byte extensions with ids 1 to 20.
+  constexpr int kNumExtensions = 20;
+  std::vector<uint8_t> buffer(kMinimumPacket,
+                              kMinimumPacket + sizeof(kMinimumPacket));
+  buffer[0] |= 0x10;
+  buffer.insert(buffer.end(), {0x10, 0x00, 0x00, 3 * kNumExtensions / 4});
+  for (int id = 1; id <= kNumExtensions; ++id)
+    buffer.insert(buffer.end(), {static_cast<uint8_t>(id), 0x01, 0x80});
+
+  RtpPacketToSend::ExtensionManager extensions(/*extmap_allow_mixed=*/true);
+  extensions.Register(kRtpExtensionAudioLevel, 1);
+  extensions.Register(kRtpExtensionVideoRotation, kNumExtensions);
+  RtpPacketReceived packet(&extensions);
+  EXPECT_TRUE(packet.Parse(buffer.data(), buffer.size()));
+  EXPECT_TRUE(packet.HasExtension<AudioLevel>());
+  EXPECT_FALSE(packet.HasExtension<VideoOrientation>());
+}
+
 TEST(RtpPacketTest, ParseDynamicSizeExtension) {
   // clang-format off
   const uint8_t kPacket1[] = {
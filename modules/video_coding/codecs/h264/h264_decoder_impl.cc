@@ -22,12 +22,16 @@ extern "C" {
 
 #include "api/video/color_space.h"
 #include "api/video/i420_buffer.h"
+#include "api/video/video_content_type.h"
+#include "common_video/h264/h264_common.h"
+#include "common_video/h264/sps_parser.h"
 #include "common_video/include/video_frame_buffer.h"
 #include "modules/video_coding/codecs/h264/h264_color_space.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/keep_ref_until_done.h"
 #include "rtc_base/logging.h"
+#include "system_wrappers/include/field_trial.h"
 #include "system_wrappers/include/metrics.h"
 
 namespace webrtc {
@@ -40,6 +44,24 @@ const size_t kYPlaneIndex = 0;
 const size_t kUPlaneIndex = 1;
 const size_t kVPlaneIndex = 2;
 
+// "Enabled" chooses the number of threads from the resolution of the key
+// frames, "Enabled-FrameThreads" also decodes consecutive frames in parallel,
+// which delays the output by one frame per additional thread. Frame threads
+// are not used for screen content and low frame rates.
+const char kDecoderThreadingFieldTrial[] = "WebRTC-VideoDecoderThreading";
+const char kFrameThreadsGroup[] = "Enabled-FrameThreads";
+
+// The frames held by frame threads must fit in the frame information the
+// VCMGenericDecoder keeps.
+const int kMaxThreads = 8;
+
+// Below this frame rate, frames held by frame threads stay on hold for too
+// long, e.g. with screen content that only changes now and then.
+const int kMinFrameThreadsFps = 20;
+const int kRtpTicksPerSecond = 90000;
+const int64_t kMaxFrameThreadsInterval =
+    kRtpTicksPerSecond / kMinFrameThreadsFps;
+
 // Used by histograms. Values of entries should not be changed.
 enum H264DecoderImplEvent {
   kH264DecoderEventInit = 0,
@@ -47,6 +69,43 @@ enum H264DecoderImplEvent {
   kH264DecoderEventMax = 16,
 };
 
+// Slice threads only help streams with several slices per frame, and frame
+// threads cost a frame of delay each, so only larger resolutions get more.
+int NumberOfDecoderThreads(int width, int height, int number_of_cores) {
+  int max_threads = 1;
+  if (width * height >= 3840 * 2160) {
+    max_threads = kMaxThreads;
+  } else if (width * height >= 1920 * 1080) {
+    max_threads = 4;
+  } else if (width * height >= 1280 * 720) {
+    max_threads = 2;
+  }
+  return std::max(1, std::min(number_of_cores, max_threads));
+}
+
+// Finds the resolution in the SPS that key frames start with.
+bool ParseSpsResolution(const EncodedImage& input_image,
+                        int* width,
+                        int* height) {
+  for (const H264::NaluIndex& index :
+       H264::FindNaluIndices(input_image._buffer, input_image._length)) {
+    const uint8_t* nalu = input_image._buffer + index.payload_start_offset;
+    if (index.payload_size <= H264::kNaluTypeSize ||
+        H264::ParseNaluType(nalu[0]) != H264::NaluType::kSps) {
+      continue;
+    }
+    absl::optional<SpsParser::SpsState> sps =
+        SpsParser::ParseSps(nalu + H264::kNaluTypeSize,
+                            index.payload_size - H264::kNaluTypeSize);
+    if (!sps)
+      return false;
+    *width = static_cast<int>(sps->width);
+    *height = static_cast<int>(sps->height);
+    return true;
+  }
+  return false;
+}
+
 }  // namespace
 
 int H264DecoderImpl::AVGetBuffer2(
@@ -139,11 +198,20 @@ void H264DecoderImpl::AVFreeBuffer2(void* opaque, uint8_t* data) {
   delete video_frame;
 }
 
-H264DecoderImpl::H264DecoderImpl() : pool_(true),
-                                     decoded_image_callback_(nullptr),
-                                     has_reported_init_(false),
-                                     has_reported_error_(false) {
-}
+H264DecoderImpl::H264DecoderImpl()
+    : pool_(true),
+      decoded_image_callback_(nullptr),
+      has_reported_init_(false),
+      has_reported_error_(false),
+      threads_follow_resolution_(
+          field_trial::IsEnabled(kDecoderThreadingFieldTrial)),
+      frame_threads_(field_trial::FindFullName(kDecoderThreadingFieldTrial) ==
+                     kFrameThreadsGroup),
+      number_of_cores_(1),
+      num_threads_(1),
+      use_frame_threads_(false),
+      key_frame_requested_(false),
+      frame_interval_(0) {}
 
 H264DecoderImpl::~H264DecoderImpl() {
   Release();
@@ -166,23 +234,47 @@ int32_t H264DecoderImpl::InitDecode(const VideoCodec* codec_settings,
   }
   RTC_DCHECK(!av_context_);
 
+  number_of_cores_ = number_of_cores;
+  frame_interval_ = 0;
+  last_rtp_timestamp_ = absl::nullopt;
+  if (codec_settings && codec_settings->maxFramerate > 0)
+    frame_interval_ = kRtpTicksPerSecond / codec_settings->maxFramerate;
+  ret = OpenContext(codec_settings ? codec_settings->width : 0,
+                    codec_settings ? codec_settings->height : 0,
+                    frame_threads_ &&
+                        frame_interval_ <= kMaxFrameThreadsInterval);
+  if (ret != WEBRTC_VIDEO_CODEC_OK) {
+    ReportError();
+    return ret;
+  }
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int32_t H264DecoderImpl::OpenContext(int width,
+                                     int height,
+                                     bool use_frame_threads) {
   // Initialize AVCodecContext.
   av_context_.reset(avcodec_alloc_context3(nullptr));
 
   av_context_->codec_type = AVMEDIA_TYPE_VIDEO;
   av_context_->codec_id = AV_CODEC_ID_H264;
-  if (codec_settings) {
-    av_context_->coded_width = codec_settings->width;
-    av_context_->coded_height = codec_settings->height;
-  }
+  av_context_->coded_width = width;
+  av_context_->coded_height = height;
   av_context_->pix_fmt = kPixelFormatDefault;
   av_context_->extradata = nullptr;
   av_context_->extradata_size = 0;
 
-  // If this is ever increased, look at |av_context_->thread_safe_callbacks| and
-  // make it possible to disable the thread checker in the frame buffer pool.
-  av_context_->thread_count = 1;
-  av_context_->thread_type = FF_THREAD_SLICE;
+  // |av_context_->thread_safe_callbacks| is left unset, so that FFmpeg calls
+  // |AVGetBuffer2| on the thread calling |Decode| also with frame threads, as
+  // the race checker of the frame buffer pool requires.
+  num_threads_ = 1;
+  if (threads_follow_resolution_)
+    num_threads_ = NumberOfDecoderThreads(width, height, number_of_cores_);
+  av_context_->thread_count = num_threads_;
+  use_frame_threads_ = use_frame_threads;
+  key_frame_requested_ = false;
+  av_context_->thread_type =
+      use_frame_threads_ ? FF_THREAD_FRAME : FF_THREAD_SLICE;
 
   // Function used by FFmpeg to get buffers to store decoded frames in.
   av_context_->get_buffer2 = AVGetBuffer2;
@@ -196,14 +288,12 @@ int32_t H264DecoderImpl::InitDecode(const VideoCodec* codec_settings,
     // been compiled/initialized with the correct set of codecs.
     RTC_LOG(LS_ERROR) << "FFmpeg H.264 decoder not found.";
     Release();
-    ReportError();
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
   int res = avcodec_open2(av_context_.get(), codec, nullptr);
   if (res < 0) {
     RTC_LOG(LS_ERROR) << "avcodec_open2 error: " << res;
     Release();
-    ReportError();
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
 
@@ -211,9 +301,78 @@ int32_t H264DecoderImpl::InitDecode(const VideoCodec* codec_settings,
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+int32_t H264DecoderImpl::UpdateNumberOfThreads(
+    const EncodedImage& input_image) {
+  int width = 0;
+  int height = 0;
+  const bool use_frame_threads = UseFrameThreads(input_image);
+  if (!ParseSpsResolution(input_image, &width, &height) ||
+      (NumberOfDecoderThreads(width, height, number_of_cores_) ==
+           num_threads_ &&
+       use_frame_threads == use_frame_threads_)) {
+    key_frame_requested_ = false;
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  // An IDR frame does not refer to earlier frames, so nothing is lost by
+  // recreating the context once the earlier frames are out.
+  DrainFrames();
+  Release();
+  return OpenContext(width, height, use_frame_threads);
+}
+
+bool H264DecoderImpl::UseFrameThreads(const EncodedImage& key_frame) const {
+  return frame_threads_ &&
+         !videocontenttypehelpers::IsScreenshare(key_frame.content_type_) &&
+         frame_interval_ <= kMaxFrameThreadsInterval;
+}
+
+void H264DecoderImpl::UpdateFrameInterval(uint32_t rtp_timestamp) {
+  if (last_rtp_timestamp_) {
+    // Ignores reordered and repeated timestamps. Gaps count as at most one
+    // second, so that a stream recovers from an idle period.
+    const int64_t interval = std::min<int64_t>(
+        static_cast<int32_t>(rtp_timestamp - *last_rtp_timestamp_),
+        kRtpTicksPerSecond);
+    if (interval <= 0)
+      return;
+    frame_interval_ = frame_interval_ == 0
+                          ? interval
+                          : frame_interval_ + (interval - frame_interval_) / 8;
+  }
+  last_rtp_timestamp_ = rtp_timestamp;
+}
+
+bool H264DecoderImpl::HasFrameThreads() const {
+  return use_frame_threads_ && num_threads_ > 1;
+}
+
+absl::optional<uint8_t> H264DecoderImpl::TakeQp(uint32_t rtp_timestamp) {
+  while (!pending_qps_.empty()) {
+    const std::pair<uint32_t, absl::optional<uint8_t>> entry =
+        pending_qps_.front();
+    pending_qps_.pop_front();
+    if (entry.first == rtp_timestamp)
+      return entry.second;
+  }
+  return absl::nullopt;
+}
+
+void H264DecoderImpl::DrainFrames() {
+  if (!HasFrameThreads())
+    return;
+  if (avcodec_send_packet(av_context_.get(), nullptr) < 0)
+    return;
+  while (avcodec_receive_frame(av_context_.get(), av_frame_.get()) == 0) {
+    const uint32_t rtp_timestamp =
+        static_cast<uint32_t>(av_frame_->reordered_opaque);
+    DeliverFrame(rtp_timestamp, TakeQp(rtp_timestamp));
+  }
+}
+
 int32_t H264DecoderImpl::Release() {
   av_context_.reset();
   av_frame_.reset();
+  pending_qps_.clear();
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -268,8 +427,19 @@ int32_t H264DecoderImpl::Decode(const EncodedImage& input_image,
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
   packet.size = static_cast<int>(input_image._length);
-  int64_t frame_timestamp_us = input_image.ntp_time_ms_ * 1000;  // ms -> μs
-  av_context_->reordered_opaque = frame_timestamp_us;
+
+  UpdateFrameInterval(input_image.Timestamp());
+  if (threads_follow_resolution_ && input_image._frameType == kVideoFrameKey) {
+    int32_t ret = UpdateNumberOfThreads(input_image);
+    if (ret != WEBRTC_VIDEO_CODEC_OK) {
+      ReportError();
+      return ret;
+    }
+  }
+
+  // Frame threads deliver the frames of earlier calls, identified by their
+  // RTP timestamp.
+  av_context_->reordered_opaque = input_image.Timestamp();
 
   int result = avcodec_send_packet(av_context_.get(), &packet);
   if (result < 0) {
@@ -278,17 +448,58 @@ int32_t H264DecoderImpl::Decode(const EncodedImage& input_image,
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
 
-  result = avcodec_receive_frame(av_context_.get(), av_frame_.get());
-  if (result < 0) {
-    RTC_LOG(LS_ERROR) << "avcodec_receive_frame error: " << result;
-    ReportError();
-    return WEBRTC_VIDEO_CODEC_ERROR;
+  absl::optional<uint8_t> qp;
+  // TODO(sakal): Maybe it is possible to get QP directly from FFmpeg.
+  h264_bitstream_parser_.ParseBitstream(input_image._buffer,
+                                        input_image._length);
+  int qp_int;
+  if (h264_bitstream_parser_.GetLastSliceQp(&qp_int)) {
+    qp.emplace(qp_int);
+  }
+  // Kept until the frame is delivered, possibly by a later call.
+  pending_qps_.emplace_back(input_image.Timestamp(), qp);
+  if (pending_qps_.size() > kMaxThreads)
+    pending_qps_.pop_front();
+
+  bool input_frame_decoded = false;
+  while (true) {
+    result = avcodec_receive_frame(av_context_.get(), av_frame_.get());
+    if (result == AVERROR(EAGAIN))
+      break;
+    if (result < 0) {
+      RTC_LOG(LS_ERROR) << "avcodec_receive_frame error: " << result;
+      ReportError();
+      return WEBRTC_VIDEO_CODEC_ERROR;
+    }
+    // We don't expect reordering. Only frame threads delay the output.
+    const uint32_t rtp_timestamp =
+        static_cast<uint32_t>(av_frame_->reordered_opaque);
+    const bool is_input_frame = rtp_timestamp == input_image.Timestamp();
+    RTC_DCHECK(is_input_frame || HasFrameThreads());
+    DeliverFrame(rtp_timestamp, TakeQp(rtp_timestamp));
+    input_frame_decoded |= is_input_frame;
   }
 
-  // We don't expect reordering. Decoded frame tamestamp should match
-  // the input one.
-  RTC_DCHECK_EQ(av_frame_->reordered_opaque, frame_timestamp_us);
+  if (HasFrameThreads() && !key_frame_requested_ &&
+      frame_interval_ > kMaxFrameThreadsInterval) {
+    // The frame rate dropped, and the held frames would now be late. Frame
+    // threads can only be turned off at a key frame.
+    RTC_LOG(LS_INFO) << "Frame rate too low for frame threads, requesting a "
+                        "key frame.";
+    key_frame_requested_ = true;
+    return WEBRTC_VIDEO_CODEC_OK_REQUEST_KEYFRAME;
+  }
+  if (input_frame_decoded)
+    return WEBRTC_VIDEO_CODEC_OK;
+  if (HasFrameThreads())
+    return WEBRTC_VIDEO_CODEC_OUTPUT_DELAYED;
+  RTC_LOG(LS_ERROR) << "avcodec_receive_frame error: " << result;
+  ReportError();
+  return WEBRTC_VIDEO_CODEC_ERROR;
+}
 
+void H264DecoderImpl::DeliverFrame(uint32_t rtp_timestamp,
+                                   absl::optional<uint8_t> qp) {
   // Obtain the |video_frame| containing the decoded image.
   VideoFrame* input_frame =
       static_cast<VideoFrame*>(av_buffer_get_opaque(av_frame_->buf[0]));
@@ -304,20 +515,11 @@ int32_t H264DecoderImpl::Decode(const EncodedImage& input_image,
       VideoFrame::Builder()
           .set_video_frame_buffer(input_frame->video_frame_buffer())
           .set_timestamp_us(input_frame->timestamp_us())
-          .set_timestamp_rtp(input_image.Timestamp())
+          .set_timestamp_rtp(rtp_timestamp)
           .set_rotation(input_frame->rotation())
           .set_color_space(color_space)
           .build();
 
-  absl::optional<uint8_t> qp;
-  // TODO(sakal): Maybe it is possible to get QP directly from FFmpeg.
-  h264_bitstream_parser_.ParseBitstream(input_image._buffer,
-                                        input_image._length);
-  int qp_int;
-  if (h264_bitstream_parser_.GetLastSliceQp(&qp_int)) {
-    qp.emplace(qp_int);
-  }
-
   // The decoded image may be larger than what is supposed to be visible, see
   // |AVGetBuffer2|'s use of |avcodec_align_dimensions|. This crops the image
   // without copying the underlying buffer.
@@ -346,8 +548,6 @@ int32_t H264DecoderImpl::Decode(const EncodedImage& input_image,
   // Stop referencing it, possibly freeing |input_frame|.
   av_frame_unref(av_frame_.get());
   input_frame = nullptr;
-
-  return WEBRTC_VIDEO_CODEC_OK;
 }
 
 const char* H264DecoderImpl::ImplementationName() const {
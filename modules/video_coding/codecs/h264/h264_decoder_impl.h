@@ -12,7 +12,9 @@
 #ifndef MODULES_VIDEO_CODING_CODECS_H264_H264_DECODER_IMPL_H_
 #define MODULES_VIDEO_CODING_CODECS_H264_H264_DECODER_IMPL_H_
 
+#include <deque>
 #include <memory>
+#include <utility>
 
 #include "modules/video_coding/codecs/h264/include/h264.h"
 
@@ -20,6 +22,7 @@ extern "C" {
 #include "third_party/ffmpeg/libavcodec/avcodec.h"
 }  // extern "C"
 
+#include "absl/types/optional.h"
 #include "common_video/h264/h264_bitstream_parser.h"
 #include "common_video/include/i420_buffer_pool.h"
 
@@ -64,6 +67,31 @@ class H264DecoderImpl : public H264Decoder {
   // Called by FFmpeg when it is done with a video frame, see |AVGetBuffer2|.
   static void AVFreeBuffer2(void* opaque, uint8_t* data);
 
+  // Creates |av_context_| for a stream of |width|x|height|, which are zero if
+  // unknown, with frame threads if |use_frame_threads| is set.
+  int32_t OpenContext(int width, int height, bool use_frame_threads);
+
+  // Recreates |av_context_| with the threads suited for the resolution and
+  // content of |input_image|, which must be a key frame.
+  int32_t UpdateNumberOfThreads(const EncodedImage& input_image);
+
+  // Frame threads hold frames until later Decode() calls, so they are only
+  // used for video that is not screen content and arrives at a steady, high
+  // enough frame rate.
+  bool UseFrameThreads(const EncodedImage& key_frame) const;
+  void UpdateFrameInterval(uint32_t rtp_timestamp);
+  bool HasFrameThreads() const;
+
+  // Returns the QP of the frame with |rtp_timestamp| and forgets the QPs of
+  // the frames decoded before it.
+  absl::optional<uint8_t> TakeQp(uint32_t rtp_timestamp);
+
+  // Delivers the frames that frame threads still hold.
+  void DrainFrames();
+
+  // Delivers |av_frame_|, decoded from the frame with |rtp_timestamp|.
+  void DeliverFrame(uint32_t rtp_timestamp, absl::optional<uint8_t> qp);
+
   bool IsInitialized() const;
 
   // Reports statistics with histograms.
@@ -79,6 +107,23 @@ class H264DecoderImpl : public H264Decoder {
   bool has_reported_init_;
   bool has_reported_error_;
 
+  // Whether the number of threads follows the resolution of the key frames,
+  // and whether the threads decode consecutive frames in parallel.
+  const bool threads_follow_resolution_;
+  const bool frame_threads_;
+  int number_of_cores_;
+  int num_threads_;
+  // Whether |av_context_| uses frame threads.
+  bool use_frame_threads_;
+  // Set when the frame rate of a frame-threaded stream has dropped, until the
+  // requested key frame arrives.
+  bool key_frame_requested_;
+  // Smoothed interval between frames, in RTP ticks, or zero if unknown.
+  int64_t frame_interval_;
+  absl::optional<uint32_t> last_rtp_timestamp_;
+  // The QPs of the frames that have not been delivered yet, in decode order.
+  std::deque<std::pair<uint32_t, absl::optional<uint8_t>>> pending_qps_;
+
   webrtc::H264BitstreamParser h264_bitstream_parser_;
 };
 
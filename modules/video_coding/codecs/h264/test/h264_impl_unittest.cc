@@ -8,10 +8,14 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
+#include <vector>
+
 #include "api/video/color_space.h"
 #include "common_video/libyuv/include/webrtc_libyuv.h"
 #include "modules/video_coding/codecs/h264/include/h264.h"
 #include "modules/video_coding/codecs/test/video_codec_unittest.h"
+#include "test/field_trial.h"
 #include "test/video_codec_settings.h"
 
 namespace webrtc {
@@ -34,9 +38,18 @@ class TestH264Impl : public VideoCodecUnitTest {
 #ifdef WEBRTC_USE_H264
 #define MAYBE_EncodeDecode EncodeDecode
 #define MAYBE_DecodedQpEqualsEncodedQp DecodedQpEqualsEncodedQp
+#define MAYBE_DecodeWithFrameThreads DecodeWithFrameThreads
+#define MAYBE_DecodeScreenshareWithoutDelay DecodeScreenshareWithoutDelay
+#define MAYBE_RequestKeyFrameWhenFrameRateDrops \
+  RequestKeyFrameWhenFrameRateDrops
 #else
 #define MAYBE_EncodeDecode DISABLED_EncodeDecode
 #define MAYBE_DecodedQpEqualsEncodedQp DISABLED_DecodedQpEqualsEncodedQp
+#define MAYBE_DecodeWithFrameThreads DISABLED_DecodeWithFrameThreads
+#define MAYBE_DecodeScreenshareWithoutDelay \
+  DISABLED_DecodeScreenshareWithoutDelay
+#define MAYBE_RequestKeyFrameWhenFrameRateDrops \
+  DISABLED_RequestKeyFrameWhenFrameRateDrops
 #endif
 
 TEST_F(TestH264Impl, MAYBE_EncodeDecode) {
@@ -81,4 +94,143 @@ TEST_F(TestH264Impl, MAYBE_DecodedQpEqualsEncodedQp) {
   EXPECT_EQ(encoded_frame.qp_, *decoded_qp);
 }
 
+class TestH264ImplFrameThreads : public TestH264Impl {
+ public:
+  TestH264ImplFrameThreads()
+      : field_trials_("WebRTC-VideoDecoderThreading/Enabled-FrameThreads/") {}
+
+ protected:
+  void ModifyCodecSettings(VideoCodec* codec_settings) override {
+    TestH264Impl::ModifyCodecSettings(codec_settings);
+    codec_settings->width = 1280;
+    codec_settings->height = 720;
+  }
+
+  test::ScopedFieldTrials field_trials_;
+};
+
+TEST_F(TestH264ImplFrameThreads, MAYBE_DecodeWithFrameThreads) {
+  constexpr int kNumFrames = 12;
+  // Reinitialize with several cores, so that the decoder uses frame threads
+  // for the 720p key frame.
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, decoder_->Release());
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            decoder_->InitDecode(&codec_settings_, 4 /* number of cores */));
+
+  std::vector<uint32_t> timestamps;
+  int num_delayed = 0;
+  for (int i = 0; i < kNumFrames; ++i) {
+    VideoFrame* input_frame = NextInputFrame();
+    timestamps.push_back(input_frame->timestamp());
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              encoder_->Encode(*input_frame, nullptr, nullptr));
+    EncodedImage encoded_frame;
+    CodecSpecificInfo codec_specific_info;
+    ASSERT_TRUE(WaitForEncodedFrame(&encoded_frame, &codec_specific_info));
+    if (i == 0)
+      encoded_frame._frameType = kVideoFrameKey;
+    const int32_t ret = decoder_->Decode(encoded_frame, false, nullptr, 0);
+    ASSERT_TRUE(ret == WEBRTC_VIDEO_CODEC_OK ||
+                ret == WEBRTC_VIDEO_CODEC_OUTPUT_DELAYED);
+    if (ret == WEBRTC_VIDEO_CODEC_OUTPUT_DELAYED)
+      ++num_delayed;
+  }
+  // The decoder holds back at most one frame per thread, so some of the
+  // frames are delivered from Decode().
+  EXPECT_GT(num_delayed, 0);
+  EXPECT_LT(num_delayed, kNumFrames);
+
+  // Delayed frames are delivered with their own timestamps.
+  std::unique_ptr<VideoFrame> decoded_frame;
+  absl::optional<uint8_t> decoded_qp;
+  ASSERT_TRUE(WaitForDecodedFrame(&decoded_frame, &decoded_qp));
+  ASSERT_TRUE(decoded_frame);
+  EXPECT_EQ(1280, decoded_frame->width());
+  EXPECT_EQ(720, decoded_frame->height());
+  EXPECT_NE(timestamps.end(), std::find(timestamps.begin(), timestamps.end(),
+                                        decoded_frame->timestamp()));
+  // Also with the QP of their own frame.
+  EXPECT_TRUE(decoded_qp);
+}
+
+TEST_F(TestH264ImplFrameThreads, MAYBE_DecodeScreenshareWithoutDelay) {
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, decoder_->Release());
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            decoder_->InitDecode(&codec_settings_, 4 /* number of cores */));
+
+  // Screen content may not change for a long time, so frames of it are not
+  // held back.
+  for (int i = 0; i < 3; ++i) {
+    VideoFrame* input_frame = NextInputFrame();
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              encoder_->Encode(*input_frame, nullptr, nullptr));
+    EncodedImage encoded_frame;
+    CodecSpecificInfo codec_specific_info;
+    ASSERT_TRUE(WaitForEncodedFrame(&encoded_frame, &codec_specific_info));
+    if (i == 0)
+      encoded_frame._frameType = kVideoFrameKey;
+    encoded_frame.content_type_ = VideoContentType::SCREENSHARE;
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              decoder_->Decode(encoded_frame, false, nullptr, 0));
+    std::unique_ptr<VideoFrame> decoded_frame;
+    absl::optional<uint8_t> decoded_qp;
+    ASSERT_TRUE(WaitForDecodedFrame(&decoded_frame, &decoded_qp));
+    EXPECT_EQ(input_frame->timestamp(), decoded_frame->timestamp());
+  }
+}
+
+TEST_F(TestH264ImplFrameThreads, MAYBE_RequestKeyFrameWhenFrameRateDrops) {
+  constexpr uint32_t kRtpTicksPerSecond = 90000;
+  constexpr uint32_t kLowFpsInterval = kRtpTicksPerSecond / 2;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, decoder_->Release());
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            decoder_->InitDecode(&codec_settings_, 4 /* number of cores */));
+
+  // The stream starts out frame-threaded at 30 fps, then drops to 2 fps.
+  uint32_t rtp_timestamp = 0;
+  int num_key_frame_requests = 0;
+  for (int i = 0; i < 12; ++i) {
+    VideoFrame* input_frame = NextInputFrame();
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              encoder_->Encode(*input_frame, nullptr, nullptr));
+    EncodedImage encoded_frame;
+    CodecSpecificInfo codec_specific_info;
+    ASSERT_TRUE(WaitForEncodedFrame(&encoded_frame, &codec_specific_info));
+    if (i == 0)
+      encoded_frame._frameType = kVideoFrameKey;
+    rtp_timestamp +=
+        i < 4 ? kRtpTicksPerSecond / test::kTestFrameRate : kLowFpsInterval;
+    encoded_frame.SetTimestamp(rtp_timestamp);
+    const int32_t ret = decoder_->Decode(encoded_frame, false, nullptr, 0);
+    ASSERT_TRUE(ret == WEBRTC_VIDEO_CODEC_OK ||
+                ret == WEBRTC_VIDEO_CODEC_OUTPUT_DELAYED ||
+                ret == WEBRTC_VIDEO_CODEC_OK_REQUEST_KEYFRAME);
+    if (ret == WEBRTC_VIDEO_CODEC_OK_REQUEST_KEYFRAME)
+      ++num_key_frame_requests;
+  }
+  // Requested once, not for every frame until the key frame arrives.
+  EXPECT_EQ(1, num_key_frame_requests);
+
+  // The key frame turns the frame threads off, after which every frame is
+  // delivered by its own Decode() call.
+  const std::vector<FrameType> key_frame_type = {kVideoFrameKey};
+  for (int i = 0; i < 3; ++i) {
+    VideoFrame* input_frame = NextInputFrame();
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              encoder_->Encode(*input_frame, nullptr,
+                               i == 0 ? &key_frame_type : nullptr));
+    EncodedImage encoded_frame;
+    CodecSpecificInfo codec_specific_info;
+    ASSERT_TRUE(WaitForEncodedFrame(&encoded_frame, &codec_specific_info));
+    rtp_timestamp += kLowFpsInterval;
+    encoded_frame.SetTimestamp(rtp_timestamp);
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              decoder_->Decode(encoded_frame, false, nullptr, 0));
+    std::unique_ptr<VideoFrame> decoded_frame;
+    absl::optional<uint8_t> decoded_qp;
+    ASSERT_TRUE(WaitForDecodedFrame(&decoded_frame, &decoded_qp));
+    EXPECT_EQ(rtp_timestamp, decoded_frame->timestamp());
+  }
+}
+
 }  // namespace webrtc
@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
 #include <vector>
 
 #include "absl/memory/memory.h"
@@ -20,6 +21,7 @@
 #include "media/engine/simulcast_encoder_adapter.h"
 #include "modules/video_coding/utility/vp8_header_parser.h"
 #include "modules/video_coding/utility/vp9_uncompressed_header_parser.h"
+#include "test/field_trial.h"
 #include "test/gtest.h"
 #include "test/testsupport/fileutils.h"
 
@@ -405,6 +407,62 @@ TEST(VideoCodecTestLibvpx, MAYBE_SimulcastVP8) {
   fixture->RunTest(rate_profiles, &rc_thresholds, &quality_thresholds, nullptr);
 }
 
+// Compares the per-frame encode latency of the SimulcastEncoderAdapter when
+// encoding the simulcast streams one after the other and in parallel.
+#if defined(WEBRTC_ANDROID)
+#define MAYBE_SimulcastVP8EncodeLatency DISABLED_SimulcastVP8EncodeLatency
+#else
+#define MAYBE_SimulcastVP8EncodeLatency SimulcastVP8EncodeLatency
+#endif
+TEST(VideoCodecTestLibvpx, MAYBE_SimulcastVP8EncodeLatency) {
+  printf("--> Summary\n");
+  printf("%11s %16s %16s\n", "mode", "avg_latency_us", "throughput_fps");
+  for (bool parallel : {false, true}) {
+    ScopedFieldTrials field_trials(
+        parallel ? "WebRTC-SimulcastEncoderAdapter-ParallelEncoding/Enabled/"
+                 : "");
+    auto config = CreateConfig();
+    config.filename = "ConferenceMotion_1280_720_50";
+    config.filepath = ResourcePath(config.filename, "yuv");
+    config.num_frames = 100;
+    config.use_single_core = false;
+    config.decode = false;
+    config.SetCodecSettings(cricket::kVp8CodecName, 3, 1, 3, true, true,
+                            false, 1280, 720);
+
+    InternalEncoderFactory internal_encoder_factory;
+    std::unique_ptr<VideoEncoderFactory> adapted_encoder_factory =
+        absl::make_unique<FunctionVideoEncoderFactory>([&]() {
+          return absl::make_unique<SimulcastEncoderAdapter>(
+              &internal_encoder_factory,
+              SdpVideoFormat(cricket::kVp8CodecName));
+        });
+    auto fixture = CreateVideoCodecTestFixture(
+        config, absl::make_unique<InternalDecoderFactory>(),
+        std::move(adapted_encoder_factory));
+
+    std::vector<RateProfile> rate_profiles = {{1500, 30, config.num_frames}};
+    fixture->RunTest(rate_profiles, nullptr, nullptr, nullptr);
+
+    // A frame is done once its last simulcast stream is encoded.
+    VideoCodecTestStats& stats = fixture->GetStats();
+    size_t sum_latency_us = 0;
+    for (size_t frame_num = 0; frame_num < config.num_frames; ++frame_num) {
+      size_t latency_us = 0;
+      for (size_t spatial_idx = 0; spatial_idx < 3; ++spatial_idx) {
+        latency_us = std::max(
+            latency_us,
+            stats.GetFrame(frame_num, spatial_idx)->encode_time_us);
+      }
+      sum_latency_us += latency_us;
+    }
+    const double avg_latency_us =
+        static_cast<double>(sum_latency_us) / config.num_frames;
+    printf("%11s %16.1f %16.1f\n", parallel ? "parallel" : "sequential",
+           avg_latency_us, avg_latency_us > 0 ? 1e6 / avg_latency_us : 0.0);
+  }
+}
+
 #if defined(WEBRTC_ANDROID)
 #define MAYBE_SvcVP9 DISABLED_SvcVP9
 #else
@@ -430,6 +488,42 @@ TEST(VideoCodecTestLibvpx, MAYBE_SvcVP9) {
   fixture->RunTest(rate_profiles, &rc_thresholds, &quality_thresholds, nullptr);
 }
 
+// Compares the VP9 decode throughput at 720p with the number of decoder
+// threads fixed and following the resolution of the key frames.
+#if defined(WEBRTC_ANDROID)
+#define MAYBE_DecodeThroughputVP9 DISABLED_DecodeThroughputVP9
+#else
+#define MAYBE_DecodeThroughputVP9 DecodeThroughputVP9
+#endif
+TEST(VideoCodecTestLibvpx, MAYBE_DecodeThroughputVP9) {
+  printf("--> Summary\n");
+  printf("%11s %14s %19s\n", "threads", "dec_speed_fps", "dec_throughput_fps");
+  for (bool threads_follow_resolution : {false, true}) {
+    ScopedFieldTrials field_trials(
+        threads_follow_resolution ? "WebRTC-VideoDecoderThreading/Enabled/"
+                                  : "");
+    auto config = CreateConfig();
+    config.filename = "ConferenceMotion_1280_720_50";
+    config.filepath = ResourcePath(config.filename, "yuv");
+    config.num_frames = 100;
+    // Lets the encoder use tile columns, which the decoder threads work on.
+    config.use_single_core = false;
+    config.SetCodecSettings(cricket::kVp9CodecName, 1, 1, 1, false, true,
+                            false, 1280, 720);
+    auto fixture = CreateVideoCodecTestFixture(config);
+
+    std::vector<RateProfile> rate_profiles = {{1500, 30, config.num_frames}};
+    fixture->RunTest(rate_profiles, nullptr, nullptr, nullptr);
+
+    const VideoStatistics stats =
+        fixture->GetStats().SliceAndCalcAggregatedVideoStatistic(
+            0, config.num_frames - 1);
+    printf("%11s %14.2f %19.2f\n",
+           threads_follow_resolution ? "resolution" : "fixed",
+           stats.dec_speed_fps, stats.dec_throughput_fps);
+  }
+}
+
 TEST(VideoCodecTestLibvpx, DISABLED_MultiresVP8RdPerf) {
   auto config = CreateConfig();
   config.filename = "FourPeople_1280x720_30";
@@ -13,6 +13,8 @@
 #include "api/test/create_videocodec_test_fixture.h"
 #include "media/base/mediaconstants.h"
 #include "modules/video_coding/codecs/test/videocodec_test_fixture_impl.h"
+#include "rtc_base/arraysize.h"
+#include "test/field_trial.h"
 #include "test/gtest.h"
 #include "test/testsupport/fileutils.h"
 
@@ -82,5 +84,42 @@ TEST(VideoCodecTestOpenH264, SingleNalUnit) {
                    &bs_thresholds);
 }
 
+// Compares the FFmpeg decode throughput at 720p with one thread, with the
+// number of threads following the resolution of the key frames, and with those
+// threads decoding consecutive frames in parallel.
+#if defined(WEBRTC_ANDROID)
+#define MAYBE_DecodeThroughput DISABLED_DecodeThroughput
+#else
+#define MAYBE_DecodeThroughput DecodeThroughput
+#endif
+TEST(VideoCodecTestOpenH264, MAYBE_DecodeThroughput) {
+  printf("--> Summary\n");
+  printf("%14s %14s %19s\n", "threads", "dec_speed_fps", "dec_throughput_fps");
+  const char* const kFieldTrials[] = {
+      "", "WebRTC-VideoDecoderThreading/Enabled/",
+      "WebRTC-VideoDecoderThreading/Enabled-FrameThreads/"};
+  const char* const kThreading[] = {"single", "slice_threads",
+                                    "frame_threads"};
+  for (size_t i = 0; i < arraysize(kFieldTrials); ++i) {
+    ScopedFieldTrials field_trials(kFieldTrials[i]);
+    auto config = CreateConfig();
+    config.filename = "ConferenceMotion_1280_720_50";
+    config.filepath = ResourcePath(config.filename, "yuv");
+    config.use_single_core = false;
+    config.SetCodecSettings(cricket::kH264CodecName, 1, 1, 1, false, true,
+                            false, 1280, 720);
+    auto fixture = CreateVideoCodecTestFixture(config);
+
+    std::vector<RateProfile> rate_profiles = {{1500, 30, kNumFrames}};
+    fixture->RunTest(rate_profiles, nullptr, nullptr, nullptr);
+
+    const VideoCodecTestStats::VideoStatistics stats =
+        fixture->GetStats().SliceAndCalcAggregatedVideoStatistic(
+            0, kNumFrames - 1);
+    printf("%14s %14.2f %19.2f\n", kThreading[i], stats.dec_speed_fps,
+           stats.dec_throughput_fps);
+  }
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -176,6 +176,7 @@ VideoStatistics VideoCodecTestStatsImpl::SliceAndCalcVideoStatistic(
 
   Statistics frame_encoding_time_us;
   Statistics frame_decoding_time_us;
+  size_t decode_call_time_us = 0;
 
   Statistics psnr_y;
   Statistics psnr_u;
@@ -234,6 +235,8 @@ VideoStatistics VideoCodecTestStatsImpl::SliceAndCalcVideoStatistic(
                                                 frame_stat.max_nalu_size_bytes);
     }
 
+    decode_call_time_us += frame_stat.decode_call_time_us;
+
     if (frame_stat.decoding_successful) {
       ++video_stat.num_decoded_frames;
 
@@ -302,6 +305,10 @@ VideoStatistics VideoCodecTestStatsImpl::SliceAndCalcVideoStatistic(
 
   video_stat.enc_speed_fps = 1000000 / frame_encoding_time_us.Mean();
   video_stat.dec_speed_fps = 1000000 / frame_decoding_time_us.Mean();
+  video_stat.dec_throughput_fps =
+      decode_call_time_us > 0
+          ? 1000000.0f * video_stat.num_decoded_frames / decode_call_time_us
+          : 0.0f;
 
   video_stat.avg_delay_sec = buffer_level_sec.Mean();
   video_stat.max_key_frame_delay_sec =
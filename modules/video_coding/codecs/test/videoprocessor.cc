@@ -190,7 +190,8 @@ VideoProcessor::VideoProcessor(webrtc::VideoEncoder* encoder,
       first_decoded_frame_(num_simulcast_or_spatial_layers_, true),
       last_decoded_frame_num_(num_simulcast_or_spatial_layers_),
       decoded_frame_buffer_(num_simulcast_or_spatial_layers_),
-      post_encode_time_ns_(0) {
+      post_encode_time_ns_(0),
+      post_decode_time_ns_(0) {
   // Sanity checks.
   RTC_CHECK(rtc::TaskQueue::Current())
       << "VideoProcessor must be run on a task queue.";
@@ -516,6 +517,8 @@ void VideoProcessor::FrameDecoded(const VideoFrame& decoded_frame,
     RTC_CHECK(decoded_frame_writers_->at(spatial_idx)
                   ->WriteFrame(decoded_frame_buffer_[spatial_idx].data()));
   }
+
+  post_decode_time_ns_ += rtc::TimeNanos() - decode_stop_ns;
 }
 
 void VideoProcessor::DecodeFrame(const EncodedImage& encoded_image,
@@ -524,9 +527,12 @@ void VideoProcessor::DecodeFrame(const EncodedImage& encoded_image,
   FrameStatistics* frame_stat =
       stats_->GetFrameWithTimestamp(encoded_image.Timestamp(), spatial_idx);
 
+  post_decode_time_ns_ = 0;
   frame_stat->decode_start_ns = rtc::TimeNanos();
   frame_stat->decode_return_code =
       decoders_->at(spatial_idx)->Decode(encoded_image, false, nullptr, 0);
+  frame_stat->decode_call_time_us = GetElapsedTimeMicroseconds(
+      frame_stat->decode_start_ns, rtc::TimeNanos() - post_decode_time_ns_);
 }
 
 const webrtc::EncodedImage* VideoProcessor::BuildAndStoreSuperframe(
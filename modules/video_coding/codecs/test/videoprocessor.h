@@ -236,6 +236,11 @@ class VideoProcessor {
   // is substracted from measured encode time. Thus we get pure encode time.
   int64_t post_encode_time_ns_ RTC_GUARDED_BY(sequence_checker_);
 
+  // Time spent in frame decode callback during the current Decode() call. It
+  // is substracted from the time spent in Decode(), which is then the time the
+  // decoder needs per frame when it decodes frames in parallel.
+  int64_t post_decode_time_ns_ RTC_GUARDED_BY(sequence_checker_);
+
   // This class must be operated on a TaskQueue.
   rtc::SequencedTaskChecker sequence_checker_;
 
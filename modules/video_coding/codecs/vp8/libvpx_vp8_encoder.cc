@@ -155,6 +155,8 @@ LibvpxVp8Encoder::LibvpxVp8Encoder(std::unique_ptr<LibvpxInterface> interface)
       qp_max_(56),  // Setting for max quantizer.
       cpu_speed_default_(-6),
       number_of_cores_(0),
+      init_width_(0),
+      init_height_(0),
       rc_max_intra_target_(0),
       key_frame_request_(kMaxSimulcastStreams, false) {
   temporal_layers_.reserve(kMaxSimulcastStreams);
@@ -316,6 +318,10 @@ int LibvpxVp8Encoder::InitEncode(const VideoCodec* inst,
   if (inst->VP8().automaticResizeOn && inst->numberOfSimulcastStreams > 1) {
     return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
   }
+  if (CanReconfigureInPlace(*inst, number_of_cores) &&
+      ReconfigureInPlace(*inst) == WEBRTC_VIDEO_CODEC_OK) {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
   int retVal = Release();
   if (retVal < 0) {
     return retVal;
@@ -334,6 +340,8 @@ int LibvpxVp8Encoder::InitEncode(const VideoCodec* inst,
   number_of_cores_ = number_of_cores;
   timestamp_ = 0;
   codec_ = *inst;
+  init_width_ = inst->width;
+  init_height_ = inst->height;
 
   // Code expects simulcastStream resolutions to be correct, make sure they are
   // filled even when there are no simulcast layers.
@@ -510,6 +518,80 @@ int LibvpxVp8Encoder::InitEncode(const VideoCodec* inst,
   return InitAndSetControlSettings();
 }
 
+bool LibvpxVp8Encoder::CanReconfigureInPlace(const VideoCodec& inst,
+                                             int number_of_cores) {
+  // The multi-resolution encoders share their downsampling factors, so only a
+  // single stream is reconfigured in place.
+  if (!inited_ || encoders_.size() != 1 ||
+      SimulcastUtility::NumberOfSimulcastStreams(inst) != 1) {
+    return false;
+  }
+  // libvpx can not make the frames larger than at initialization.
+  if (inst.width > init_width_ || inst.height > init_height_)
+    return false;
+  // The encoder threads are created at initialization.
+  if (number_of_cores != number_of_cores_ ||
+      NumberOfThreads(inst.width, inst.height, number_of_cores) !=
+          static_cast<int>(configurations_[0].g_threads)) {
+    return false;
+  }
+  return inst.mode == codec_.mode && inst.qpMax == codec_.qpMax &&
+         SimulcastUtility::NumberOfTemporalLayers(inst, 0) ==
+             SimulcastUtility::NumberOfTemporalLayers(codec_, 0) &&
+         inst.VP8().denoisingOn == codec_.VP8()->denoisingOn &&
+         inst.VP8().complexity == codec_.VP8()->complexity &&
+         inst.VP8().frameDroppingOn == codec_.VP8()->frameDroppingOn &&
+         inst.VP8().keyFrameInterval == codec_.VP8()->keyFrameInterval;
+}
+
+int LibvpxVp8Encoder::ReconfigureInPlace(const VideoCodec& inst) {
+  codec_ = inst;
+  if (codec_.numberOfSimulcastStreams == 0) {
+    codec_.simulcastStream[0].width = codec_.width;
+    codec_.simulcastStream[0].height = codec_.height;
+  }
+
+  // The temporal layers start over from a key frame.
+  temporal_layers_.clear();
+  SetupTemporalLayers(codec_);
+
+  const size_t encoded_size =
+      CalcBufferSize(VideoType::kI420, codec_.width, codec_.height);
+  if (encoded_images_[0]._size < encoded_size) {
+    delete[] encoded_images_[0]._buffer;
+    encoded_images_[0]._size = encoded_size;
+    encoded_images_[0]._buffer = new uint8_t[encoded_size];
+  }
+  libvpx_->img_wrap(&raw_images_[0], VPX_IMG_FMT_I420, codec_.width,
+                    codec_.height, 1, NULL);
+
+  configurations_[0].g_w = codec_.width;
+  configurations_[0].g_h = codec_.height;
+  SimulcastRateAllocator init_allocator(codec_);
+  VideoBitrateAllocation allocation = init_allocator.GetAllocation(
+      codec_.startBitrate * 1000, codec_.maxFramerate);
+  configurations_[0].rc_target_bitrate =
+      allocation.GetSpatialLayerSum(0) / 1000;
+  if (configurations_[0].rc_target_bitrate > 0) {
+    temporal_layers_[0]->OnRatesUpdated(
+        allocation.GetTemporalLayerAllocation(0), codec_.maxFramerate);
+  }
+  UpdateVpxConfiguration(temporal_layers_[0].get(), &configurations_[0]);
+  configurations_[0].rc_dropframe_thresh = FrameDropThreshold(0);
+  if (libvpx_->codec_enc_config_set(&encoders_[0], &configurations_[0]))
+    return WEBRTC_VIDEO_CODEC_ERROR;
+
+  cpu_speed_[0] = GetCpuSpeed(codec_.width, codec_.height);
+  libvpx_->codec_control(&encoders_[0], VP8E_SET_CPUUSED, cpu_speed_[0]);
+  rc_max_intra_target_ = MaxIntraTarget(configurations_[0].rc_buf_optimal_sz);
+  libvpx_->codec_control(&encoders_[0], VP8E_SET_MAX_INTRA_BITRATE_PCT,
+                         rc_max_intra_target_);
+
+  send_stream_[0] = true;
+  key_frame_request_[0] = true;
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
 int LibvpxVp8Encoder::GetCpuSpeed(int width, int height) {
 #if defined(WEBRTC_ARCH_ARM) || defined(WEBRTC_ARCH_ARM64) || \
     defined(WEBRTC_ANDROID)
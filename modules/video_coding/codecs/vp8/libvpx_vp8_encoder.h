@@ -67,6 +67,15 @@ class LibvpxVp8Encoder : public VideoEncoder {
   // Call encoder initialize function and set control settings.
   int InitAndSetControlSettings();
 
+  // Returns true if |inst| only changes what the running encoder can take
+  // through vpx_codec_enc_config_set(): the resolution, as long as it is not
+  // larger than at initialization, the rates and the frame rate.
+  bool CanReconfigureInPlace(const VideoCodec& inst, int number_of_cores);
+
+  // Applies |inst| to the running encoder instead of recreating it, and
+  // requests a key frame.
+  int ReconfigureInPlace(const VideoCodec& inst);
+
   void PopulateCodecSpecific(CodecSpecificInfo* codec_specific,
                              const vpx_codec_cx_pkt& pkt,
                              int stream_idx,
@@ -95,6 +104,9 @@ class LibvpxVp8Encoder : public VideoEncoder {
   int qp_max_;
   int cpu_speed_default_;
   int number_of_cores_;
+  // Resolution the libvpx encoders were created with.
+  int init_width_;
+  int init_height_;
   uint32_t rc_max_intra_target_;
   std::vector<std::unique_ptr<Vp8TemporalLayers>> temporal_layers_;
   std::vector<bool> key_frame_request_;
@@ -14,6 +14,7 @@
 
 #include "api/test/mock_video_decoder.h"
 #include "api/test/mock_video_encoder.h"
+#include "api/video/i420_buffer.h"
 #include "api/video_codecs/vp8_temporal_layers.h"
 #include "common_video/libyuv/include/webrtc_libyuv.h"
 #include "modules/video_coding/codecs/test/video_codec_unittest.h"
@@ -31,6 +32,21 @@ using testing::NiceMock;
 using testing::Return;
 using testing::_;
 
+namespace {
+vpx_image_t* WrapImage(vpx_image_t* img,
+                       vpx_img_fmt_t fmt,
+                       unsigned int d_w,
+                       unsigned int d_h,
+                       unsigned int stride_align,
+                       unsigned char* img_data) {
+  img->fmt = fmt;
+  img->d_w = d_w;
+  img->d_h = d_h;
+  img->img_data = img_data;
+  return img;
+}
+}  // namespace
+
 namespace {
 constexpr uint32_t kInitialTimestampRtp = 123;
 constexpr int64_t kTestNtpTimeMs = 456;
@@ -92,6 +108,16 @@ class TestVp8Impl : public VideoCodecUnitTest {
     EXPECT_EQ(temporal_idx, codec_specific_info.codecSpecific.VP8.temporalIdx);
   }
 
+  // Returns the next input frame, scaled to |width|x|height|.
+  VideoFrame NextInputFrameScaledTo(int width, int height) {
+    VideoFrame* input_frame = NextInputFrame();
+    rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(width, height);
+    buffer->ScaleFrom(*input_frame->video_frame_buffer()->ToI420());
+    VideoFrame scaled_frame(buffer, input_frame->timestamp(),
+                            input_frame->render_time_ms(), kVideoRotation_0);
+    return scaled_frame;
+  }
+
   void VerifyQpParser(const EncodedImage& encoded_frame) const {
     int qp;
     EXPECT_GT(encoded_frame._length, 0u);
@@ -428,4 +454,108 @@ TEST_F(TestVp8Impl, KeepsTimestampOnReencode) {
   encoder.Encode(*NextInputFrame(), nullptr, &delta_frame);
 }
 
+TEST_F(TestVp8Impl, InitEncodeWithSmallerResolutionWithoutRelease) {
+  EncodedImage encoded_frame;
+  CodecSpecificInfo codec_specific_info;
+  EncodeAndWaitForFrame(*NextInputFrame(), &encoded_frame,
+                        &codec_specific_info);
+  EncodeAndWaitForFrame(*NextInputFrame(), &encoded_frame,
+                        &codec_specific_info);
+
+  // Reconfigures the running encoder, which starts over with a key frame.
+  codec_settings_.width = kWidth / 2;
+  codec_settings_.height = kHeight / 2;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder_->InitEncode(&codec_settings_, kNumCores, kMaxPayloadSize));
+  const VideoFrame input_frame =
+      NextInputFrameScaledTo(kWidth / 2, kHeight / 2);
+  EncodeAndWaitForFrame(input_frame, &encoded_frame, &codec_specific_info);
+  EXPECT_EQ(kVideoFrameKey, encoded_frame._frameType);
+  EXPECT_EQ(static_cast<uint32_t>(kWidth / 2), encoded_frame._encodedWidth);
+  EXPECT_EQ(static_cast<uint32_t>(kHeight / 2), encoded_frame._encodedHeight);
+
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            decoder_->Decode(encoded_frame, false, nullptr, -1));
+  std::unique_ptr<VideoFrame> decoded_frame;
+  absl::optional<uint8_t> decoded_qp;
+  ASSERT_TRUE(WaitForDecodedFrame(&decoded_frame, &decoded_qp));
+  ASSERT_TRUE(decoded_frame);
+  EXPECT_EQ(kWidth / 2, decoded_frame->width());
+  EXPECT_EQ(kHeight / 2, decoded_frame->height());
+  EXPECT_GT(I420PSNR(&input_frame, decoded_frame.get()), 36);
+}
+
+TEST_F(TestVp8Impl, ReconfiguresInPlaceForSmallerResolution) {
+  auto* const vpx = new NiceMock<MockLibvpxVp8Interface>();
+  LibvpxVp8Encoder encoder((std::unique_ptr<LibvpxInterface>(vpx)));
+  ON_CALL(*vpx, img_wrap(_, _, _, _, _, _)).WillByDefault(Invoke(WrapImage));
+
+  EXPECT_CALL(*vpx, codec_enc_init(_, _, _, _));
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder.InitEncode(&codec_settings_, kNumCores, kMaxPayloadSize));
+  testing::Mock::VerifyAndClearExpectations(vpx);
+
+  codec_settings_.width = kWidth / 2;
+  codec_settings_.height = kHeight / 2;
+  EXPECT_CALL(*vpx, codec_destroy(_)).Times(0);
+  EXPECT_CALL(*vpx, codec_enc_init(_, _, _, _)).Times(0);
+  EXPECT_CALL(*vpx, codec_enc_config_set(_, _))
+      .WillOnce(Invoke(
+          [](vpx_codec_ctx_t* ctx, const vpx_codec_enc_cfg_t* cfg) {
+            EXPECT_EQ(static_cast<unsigned int>(kWidth / 2), cfg->g_w);
+            EXPECT_EQ(static_cast<unsigned int>(kHeight / 2), cfg->g_h);
+            return VPX_CODEC_OK;
+          }));
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder.InitEncode(&codec_settings_, kNumCores, kMaxPayloadSize));
+  testing::Mock::VerifyAndClearExpectations(vpx);
+}
+
+TEST_F(TestVp8Impl, ReinitializesForLargerResolution) {
+  auto* const vpx = new NiceMock<MockLibvpxVp8Interface>();
+  LibvpxVp8Encoder encoder((std::unique_ptr<LibvpxInterface>(vpx)));
+  ON_CALL(*vpx, img_wrap(_, _, _, _, _, _)).WillByDefault(Invoke(WrapImage));
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder.InitEncode(&codec_settings_, kNumCores, kMaxPayloadSize));
+  testing::Mock::VerifyAndClearExpectations(vpx);
+
+  // libvpx can't make the frames larger than at initialization.
+  codec_settings_.width = kWidth * 2;
+  codec_settings_.height = kHeight * 2;
+  EXPECT_CALL(*vpx, codec_destroy(_));
+  EXPECT_CALL(*vpx, codec_enc_init(_, _, _, _));
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder.InitEncode(&codec_settings_, kNumCores, kMaxPayloadSize));
+  testing::Mock::VerifyAndClearExpectations(vpx);
+}
+
+TEST_F(TestVp8Impl, ReinitializesForDifferentNumberOfThreads) {
+  auto* const vpx = new NiceMock<MockLibvpxVp8Interface>();
+  LibvpxVp8Encoder encoder((std::unique_ptr<LibvpxInterface>(vpx)));
+  ON_CALL(*vpx, img_wrap(_, _, _, _, _, _)).WillByDefault(Invoke(WrapImage));
+  codec_settings_.width = 1280;
+  codec_settings_.height = 720;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder.InitEncode(&codec_settings_, 4 /* number of cores */,
+                               kMaxPayloadSize));
+  testing::Mock::VerifyAndClearExpectations(vpx);
+
+  // A smaller resolution, but one that uses fewer encoder threads, which are
+  // only created at initialization.
+  codec_settings_.width = 160;
+  codec_settings_.height = 90;
+  EXPECT_CALL(*vpx, codec_destroy(_));
+  EXPECT_CALL(*vpx, codec_enc_init(_, _, _, _))
+      .WillOnce(Invoke([](vpx_codec_ctx_t* ctx, vpx_codec_iface_t* iface,
+                          const vpx_codec_enc_cfg_t* cfg,
+                          vpx_codec_flags_t flags) {
+        EXPECT_EQ(1u, cfg->g_threads);
+        return VPX_CODEC_OK;
+      }));
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder.InitEncode(&codec_settings_, 4 /* number of cores */,
+                               kMaxPayloadSize));
+  testing::Mock::VerifyAndClearExpectations(vpx);
+}
+
 }  // namespace webrtc
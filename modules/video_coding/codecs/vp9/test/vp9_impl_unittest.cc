@@ -106,6 +106,41 @@ class TestVp9Impl : public VideoCodecUnitTest {
     }
   }
 
+  // Returns the next input frame, scaled to |width|x|height|.
+  VideoFrame NextInputFrameScaledTo(int width, int height) {
+    VideoFrame* input_frame = NextInputFrame();
+    rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(width, height);
+    buffer->ScaleFrom(*input_frame->video_frame_buffer()->ToI420());
+    VideoFrame scaled_frame(buffer, input_frame->timestamp(),
+                            input_frame->render_time_ms(), kVideoRotation_0);
+    return scaled_frame;
+  }
+
+  // Encodes |input_frame|, which must give a key frame of the same size, and
+  // checks that the key frame decodes.
+  void EncodeAndDecodeKeyFrame(const VideoFrame& input_frame) {
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              encoder_->Encode(input_frame, nullptr, nullptr));
+    EncodedImage encoded_frame;
+    CodecSpecificInfo codec_specific_info;
+    ASSERT_TRUE(WaitForEncodedFrame(&encoded_frame, &codec_specific_info));
+    EXPECT_EQ(kVideoFrameKey, encoded_frame._frameType);
+    EXPECT_EQ(static_cast<uint32_t>(input_frame.width()),
+              encoded_frame._encodedWidth);
+    EXPECT_EQ(static_cast<uint32_t>(input_frame.height()),
+              encoded_frame._encodedHeight);
+
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              decoder_->Decode(encoded_frame, false, nullptr, 0));
+    std::unique_ptr<VideoFrame> decoded_frame;
+    absl::optional<uint8_t> decoded_qp;
+    ASSERT_TRUE(WaitForDecodedFrame(&decoded_frame, &decoded_qp));
+    ASSERT_TRUE(decoded_frame);
+    EXPECT_EQ(input_frame.width(), decoded_frame->width());
+    EXPECT_EQ(input_frame.height(), decoded_frame->height());
+    EXPECT_GT(I420PSNR(&input_frame, decoded_frame.get()), 36);
+  }
+
   HdrMetadata CreateTestHdrMetadata() const {
     // Random but reasonable HDR metadata.
     HdrMetadata hdr_metadata;
@@ -269,6 +304,58 @@ TEST_F(TestVp9Impl, ParserQpEqualsEncodedQp) {
   EXPECT_EQ(encoded_frame.qp_, qp);
 }
 
+TEST_F(TestVp9Impl, InitEncodeWithSmallerResolutionWithoutRelease) {
+  EncodeAndDecodeKeyFrame(*NextInputFrame());
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder_->Encode(*NextInputFrame(), nullptr, nullptr));
+  EncodedImage encoded_frame;
+  CodecSpecificInfo codec_specific_info;
+  ASSERT_TRUE(WaitForEncodedFrame(&encoded_frame, &codec_specific_info));
+  EXPECT_EQ(kVideoFrameDelta, encoded_frame._frameType);
+
+  // Reconfigures the running encoder, which starts over with a key frame.
+  codec_settings_.width = kWidth / 2;
+  codec_settings_.height = kHeight / 2;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder_->InitEncode(&codec_settings_, 1 /* number of cores */,
+                                 0 /* max payload size (unused) */));
+  EncodeAndDecodeKeyFrame(NextInputFrameScaledTo(kWidth / 2, kHeight / 2));
+}
+
+TEST_F(TestVp9Impl, InitEncodeWithLargerResolutionWithoutRelease) {
+  codec_settings_.width = kWidth / 2;
+  codec_settings_.height = kHeight / 2;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder_->InitEncode(&codec_settings_, 1 /* number of cores */,
+                                 0 /* max payload size (unused) */));
+  EncodeAndDecodeKeyFrame(NextInputFrameScaledTo(kWidth / 2, kHeight / 2));
+
+  // libvpx can't make the frames larger than at initialization, so this
+  // initializes a new encoder.
+  codec_settings_.width = kWidth;
+  codec_settings_.height = kHeight;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder_->InitEncode(&codec_settings_, 1 /* number of cores */,
+                                 0 /* max payload size (unused) */));
+  EncodeAndDecodeKeyFrame(*NextInputFrame());
+}
+
+TEST_F(TestVp9Impl, InitEncodeWithOtherNumberOfThreadsWithoutRelease) {
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder_->InitEncode(&codec_settings_, 8 /* number of cores */,
+                                 0 /* max payload size (unused) */));
+  EncodeAndDecodeKeyFrame(*NextInputFrame());
+
+  // The smaller resolution uses fewer encoder threads and tile columns, which
+  // are set up at initialization, so this initializes a new encoder.
+  codec_settings_.width = kWidth / 2;
+  codec_settings_.height = kHeight / 2;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder_->InitEncode(&codec_settings_, 8 /* number of cores */,
+                                 0 /* max payload size (unused) */));
+  EncodeAndDecodeKeyFrame(NextInputFrameScaledTo(kWidth / 2, kHeight / 2));
+}
+
 TEST_F(TestVp9Impl, EncoderWith2TemporalLayers) {
   // Override default settings.
   codec_settings_.VP9()->numberOfTemporalLayers = 2;
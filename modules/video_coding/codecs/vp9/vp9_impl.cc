@@ -41,6 +41,7 @@ namespace webrtc {
 namespace {
 const char kVp9TrustedRateControllerFieldTrial[] =
     "WebRTC-LibvpxVp9TrustedRateController";
+const char kDecoderThreadingFieldTrial[] = "WebRTC-VideoDecoderThreading";
 
 // Maps from gof_idx to encoder internal reference frame buffer index. These
 // maps work for 1,2 and 3 temporal layers with GOF length of 1,2 and 4 frames.
@@ -49,6 +50,9 @@ uint8_t kUpdBufIdx[4] = {0, 0, 1, 0};
 
 int kMaxNumTiles4kVideo = 8;
 
+// Tile columns are at least 256 pixels wide.
+constexpr int kMinTileWidth = 256;
+
 // Maximum allowed PID difference for variable frame-rate mode.
 const int kMaxAllowedPidDIff = 8;
 
@@ -139,6 +143,18 @@ bool MoreLayersEnabled(const VideoBitrateAllocation& first,
   return false;
 }
 
+// libvpx decodes the tile columns of a frame in parallel, and spreads the loop
+// filter over the same threads. Threads beyond the number of tile columns an
+// encoder may use at |width| are mostly idle.
+int NumberOfDecoderThreads(int width, int number_of_cores) {
+  int max_tile_columns = 1;
+  while (max_tile_columns < kMaxNumTiles4kVideo &&
+         2 * max_tile_columns * kMinTileWidth <= width) {
+    max_tile_columns *= 2;
+  }
+  return std::max(1, std::min(number_of_cores, max_tile_columns));
+}
+
 }  // namespace
 
 void VP9EncoderImpl::EncoderOutputCodedPacketCallback(vpx_codec_cx_pkt* pkt,
@@ -156,6 +172,8 @@ VP9EncoderImpl::VP9EncoderImpl(const cricket::VideoCodec& codec)
       timestamp_(0),
       cpu_speed_(3),
       rc_max_intra_target_(0),
+      init_width_(0),
+      init_height_(0),
       encoder_(nullptr),
       config_(nullptr),
       raw_(nullptr),
@@ -360,6 +378,10 @@ int VP9EncoderImpl::InitEncode(const VideoCodec* inst,
   if (inst->VP9().numberOfSpatialLayers > 3) {
     return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
   }
+  if (CanReconfigureInPlace(*inst, number_of_cores) &&
+      ReconfigureInPlace(*inst) == WEBRTC_VIDEO_CODEC_OK) {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
 
   int ret_val = Release();
   if (ret_val < 0) {
@@ -432,6 +454,8 @@ int VP9EncoderImpl::InitEncode(const VideoCodec* inst,
 
   config_->g_w = codec_.width;
   config_->g_h = codec_.height;
+  init_width_ = codec_.width;
+  init_height_ = codec_.height;
   config_->rc_target_bitrate = inst->startBitrate;  // in kbit/s
   config_->g_error_resilient = is_svc_ ? VPX_ERROR_RESILIENT_DEFAULT : 0;
   // Setting the time base of the codec.
@@ -536,6 +560,73 @@ int VP9EncoderImpl::InitEncode(const VideoCodec* inst,
   return InitAndSetControlSettings(inst);
 }
 
+bool VP9EncoderImpl::CanReconfigureInPlace(const VideoCodec& inst,
+                                           int number_of_cores) {
+  if (!inited_ || is_svc_ || external_ref_control_ ||
+      inst.VP9().numberOfSpatialLayers > 1 ||
+      inst.VP9().numberOfTemporalLayers > 1) {
+    return false;
+  }
+  // libvpx can not make the frames larger than at initialization.
+  if (inst.width > init_width_ || inst.height > init_height_)
+    return false;
+  // The encoder threads and tile columns are set up at initialization.
+  if (NumberOfThreads(inst.width, inst.height, number_of_cores) !=
+      static_cast<int>(config_->g_threads)) {
+    return false;
+  }
+  const VideoCodecVP9& vp9 = inst.VP9();
+  return inst.mode == codec_.mode &&
+         vp9.denoisingOn == codec_.VP9()->denoisingOn &&
+         vp9.frameDroppingOn == codec_.VP9()->frameDroppingOn &&
+         vp9.keyFrameInterval == codec_.VP9()->keyFrameInterval &&
+         vp9.adaptiveQpMode == codec_.VP9()->adaptiveQpMode &&
+         vp9.automaticResizeOn == codec_.VP9()->automaticResizeOn &&
+         vp9.flexibleMode == codec_.VP9()->flexibleMode;
+}
+
+int VP9EncoderImpl::ReconfigureInPlace(const VideoCodec& inst) {
+  codec_ = inst;
+
+  const size_t encoded_size =
+      CalcBufferSize(VideoType::kI420, codec_.width, codec_.height);
+  if (encoded_image_._size < encoded_size) {
+    delete[] encoded_image_._buffer;
+    encoded_image_._size = encoded_size;
+    encoded_image_._buffer = new uint8_t[encoded_size];
+  }
+  const vpx_img_fmt img_fmt = raw_->fmt;
+  const unsigned int bits_for_storage = raw_->bit_depth;
+  vpx_img_free(raw_);
+  raw_ =
+      vpx_img_wrap(nullptr, img_fmt, codec_.width, codec_.height, 1, nullptr);
+  raw_->bit_depth = bits_for_storage;
+
+  config_->g_w = codec_.width;
+  config_->g_h = codec_.height;
+  framerate_controller_ = std::vector<FramerateController>(
+      num_spatial_layers_, FramerateController(codec_.maxFramerate));
+  SvcRateAllocator init_allocator(codec_);
+  current_bitrate_allocation_ = init_allocator.GetAllocation(
+      codec_.startBitrate * 1000, codec_.maxFramerate);
+  requested_bitrate_allocation_ = absl::nullopt;
+  if (!SetSvcRates(current_bitrate_allocation_))
+    return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
+  if (vpx_codec_enc_config_set(encoder_, config_))
+    return WEBRTC_VIDEO_CODEC_ERROR;
+
+  cpu_speed_ = GetCpuSpeed(codec_.width, codec_.height);
+  vpx_codec_control(encoder_, VP8E_SET_CPUUSED, cpu_speed_);
+  rc_max_intra_target_ = MaxIntraTarget(config_->rc_buf_optimal_sz);
+  vpx_codec_control(encoder_, VP8E_SET_MAX_INTRA_BITRATE_PCT,
+                    rc_max_intra_target_);
+
+  force_key_frame_ = true;
+  pics_since_key_ = 0;
+  ss_info_needed_ = true;
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
 int VP9EncoderImpl::NumberOfThreads(int width,
                                     int height,
                                     int number_of_cores) {
@@ -1363,7 +1454,11 @@ VP9DecoderImpl::VP9DecoderImpl()
     : decode_complete_callback_(nullptr),
       inited_(false),
       decoder_(nullptr),
-      key_frame_required_(true) {}
+      key_frame_required_(true),
+      threads_follow_resolution_(
+          field_trial::IsEnabled(kDecoderThreadingFieldTrial)),
+      number_of_cores_(1),
+      num_threads_(0) {}
 
 VP9DecoderImpl::~VP9DecoderImpl() {
   inited_ = true;  // in order to do the actual release
@@ -1387,13 +1482,29 @@ int VP9DecoderImpl::InitDecode(const VideoCodec* inst, int number_of_cores) {
   if (decoder_ == nullptr) {
     decoder_ = new vpx_codec_ctx_t;
   }
-  vpx_codec_dec_cfg_t cfg;
-  memset(&cfg, 0, sizeof(cfg));
+  number_of_cores_ = number_of_cores;
 
   // We want to use multithreading when decoding high resolution videos. But,
   // since we don't know resolution of input stream at this stage, we always
-  // enable it.
-  cfg.threads = std::min(number_of_cores, kMaxNumTiles4kVideo);
+  // enable it, unless the threads follow the resolution of the key frames.
+  int num_threads = std::min(number_of_cores, kMaxNumTiles4kVideo);
+  if (threads_follow_resolution_ && inst && inst->width > 0)
+    num_threads = NumberOfDecoderThreads(inst->width, number_of_cores);
+  ret_val = InitVpxDecoder(num_threads);
+  if (ret_val != WEBRTC_VIDEO_CODEC_OK) {
+    return ret_val;
+  }
+
+  inited_ = true;
+  // Always start with a complete key frame.
+  key_frame_required_ = true;
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int VP9DecoderImpl::InitVpxDecoder(int num_threads) {
+  vpx_codec_dec_cfg_t cfg;
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.threads = num_threads;
 
   vpx_codec_flags_t flags = 0;
   if (vpx_codec_dec_init(decoder_, vpx_codec_vp9_dx(), &cfg, flags)) {
@@ -1404,9 +1515,41 @@ int VP9DecoderImpl::InitDecode(const VideoCodec* inst, int number_of_cores) {
     return WEBRTC_VIDEO_CODEC_MEMORY;
   }
 
+  num_threads_ = num_threads;
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int VP9DecoderImpl::UpdateNumberOfThreads(const EncodedImage& input_image) {
+  vpx_codec_stream_info_t stream_info;
+  memset(&stream_info, 0, sizeof(stream_info));
+  stream_info.sz = sizeof(stream_info);
+  if (vpx_codec_peek_stream_info(
+          vpx_codec_vp9_dx(), input_image._buffer,
+          static_cast<unsigned int>(input_image._length), &stream_info) !=
+          VPX_CODEC_OK ||
+      !stream_info.is_kf) {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  // Only the first frame of a superframe, the lowest spatial layer, is peeked.
+  // The resolution from the RTP header may be that of a higher layer.
+  const int width = std::max(static_cast<int>(stream_info.w),
+                             static_cast<int>(input_image._encodedWidth));
+  const int num_threads = NumberOfDecoderThreads(width, number_of_cores_);
+  if (num_threads == num_threads_)
+    return WEBRTC_VIDEO_CODEC_OK;
+
+  // A key frame does not refer to earlier frames, so nothing is lost by
+  // recreating the decoder. Buffers of earlier frames that are still in use
+  // stay valid, |frame_buffer_pool_| is kept.
+  inited_ = false;
+  if (vpx_codec_destroy(decoder_)) {
+    return WEBRTC_VIDEO_CODEC_MEMORY;
+  }
+  const int ret = InitVpxDecoder(num_threads);
+  if (ret != WEBRTC_VIDEO_CODEC_OK) {
+    return ret;
+  }
   inited_ = true;
-  // Always start with a complete key frame.
-  key_frame_required_ = true;
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -1431,6 +1574,13 @@ int VP9DecoderImpl::Decode(const EncodedImage& input_image,
       return WEBRTC_VIDEO_CODEC_ERROR;
     }
   }
+  if (threads_follow_resolution_ && input_image._frameType == kVideoFrameKey &&
+      input_image._length > 0) {
+    const int ret = UpdateNumberOfThreads(input_image);
+    if (ret != WEBRTC_VIDEO_CODEC_OK) {
+      return ret;
+    }
+  }
   vpx_codec_iter_t iter = nullptr;
   vpx_image_t* img;
   uint8_t* buffer = input_image._buffer;
@@ -60,6 +60,16 @@ class VP9EncoderImpl : public VP9Encoder {
   // Call encoder initialize function and set control settings.
   int InitAndSetControlSettings(const VideoCodec* inst);
 
+  // Returns true if the encoder runs without spatial or temporal layers and
+  // |inst| only changes what vpx_codec_enc_config_set() can take: the
+  // resolution, as long as it is not larger than at initialization, the rates
+  // and the frame rate.
+  bool CanReconfigureInPlace(const VideoCodec& inst, int number_of_cores);
+
+  // Applies |inst| to the running encoder instead of recreating it, and
+  // requests a key frame.
+  int ReconfigureInPlace(const VideoCodec& inst);
+
   void PopulateCodecSpecific(CodecSpecificInfo* codec_specific,
                              absl::optional<int>* spatial_idx,
                              const vpx_codec_cx_pkt& pkt,
@@ -104,6 +114,9 @@ class VP9EncoderImpl : public VP9Encoder {
   int64_t timestamp_;
   int cpu_speed_;
   uint32_t rc_max_intra_target_;
+  // Resolution |encoder_| was created with.
+  int init_width_;
+  int init_height_;
   vpx_codec_ctx_t* encoder_;
   vpx_codec_enc_cfg_t* config_;
   vpx_image_t* raw_;
@@ -179,12 +192,23 @@ class VP9DecoderImpl : public VP9Decoder {
                   int qp,
                   const ColorSpace* explicit_color_space);
 
+  // Initializes |decoder_| to decode with |num_threads| threads.
+  int InitVpxDecoder(int num_threads);
+
+  // Recreates |decoder_| with the number of threads suited for the
+  // resolution of |input_image|, which must be a key frame.
+  int UpdateNumberOfThreads(const EncodedImage& input_image);
+
   // Memory pool used to share buffers between libvpx and webrtc.
   Vp9FrameBufferPool frame_buffer_pool_;
   DecodedImageCallback* decode_complete_callback_;
   bool inited_;
   vpx_codec_ctx_t* decoder_;
   bool key_frame_required_;
+  // Whether the number of threads follows the resolution of the key frames.
+  const bool threads_follow_resolution_;
+  int number_of_cores_;
+  int num_threads_;
 };
 }  // namespace webrtc
 
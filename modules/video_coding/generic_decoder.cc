@@ -27,6 +27,7 @@ VCMDecodedFrameCallback::VCMDecodedFrameCallback(VCMTiming* timing,
     : _clock(clock),
       _timing(timing),
       _timestampMap(kDecoderFrameMemoryLength),
+      last_decode_start_ms_(0),
       _lastReceivedPictureID(0) {
   ntp_offset_ =
       _clock->CurrentNtpInMilliseconds() - _clock->TimeInMilliseconds();
@@ -71,9 +72,11 @@ void VCMDecodedFrameCallback::Decoded(VideoFrame& decodedImage,
   // TODO(holmer): We should improve this so that we can handle multiple
   // callbacks from one call to Decode().
   VCMFrameInformation* frameInfo;
+  int64_t last_decode_start_ms;
   {
     rtc::CritScope cs(&lock_);
     frameInfo = _timestampMap.Pop(decodedImage.timestamp());
+    last_decode_start_ms = last_decode_start_ms_;
   }
 
   if (frameInfo == NULL) {
@@ -83,11 +86,19 @@ void VCMDecodedFrameCallback::Decoded(VideoFrame& decodedImage,
   }
 
   const int64_t now_ms = _clock->TimeInMilliseconds();
+  // A frame held back by the decoder is decoded by the call delivering it. The
+  // time before that call is pipeline delay, not decode time.
+  const int64_t decode_start_ms =
+      frameInfo->output_delayed
+          ? std::max(frameInfo->decodeStartTimeMs, last_decode_start_ms)
+          : frameInfo->decodeStartTimeMs;
   if (!decode_time_ms) {
-    decode_time_ms = now_ms - frameInfo->decodeStartTimeMs;
+    decode_time_ms = now_ms - decode_start_ms;
   }
   _timing->StopDecodeTimer(decodedImage.timestamp(), *decode_time_ms, now_ms,
                            frameInfo->renderTimeMs);
+  _timing->set_decoder_pipeline_delay(
+      static_cast<int>(decode_start_ms - frameInfo->decodeStartTimeMs));
 
   // Report timing information.
   if (frameInfo->timing.flags != VideoSendTiming::kInvalid) {
@@ -170,6 +181,7 @@ void VCMDecodedFrameCallback::Map(uint32_t timestamp,
                                   VCMFrameInformation* frameInfo) {
   rtc::CritScope cs(&lock_);
   _timestampMap.Add(timestamp, frameInfo);
+  last_decode_start_ms_ = frameInfo->decodeStartTimeMs;
 }
 
 int32_t VCMDecodedFrameCallback::Pop(uint32_t timestamp) {
@@ -216,6 +228,7 @@ int32_t VCMGenericDecoder::Decode(const VCMEncodedFrame& frame, int64_t nowMs) {
   _frameInfos[_nextFrameInfoIdx].renderTimeMs = frame.RenderTimeMs();
   _frameInfos[_nextFrameInfoIdx].rotation = frame.rotation();
   _frameInfos[_nextFrameInfoIdx].timing = frame.video_timing();
+  _frameInfos[_nextFrameInfoIdx].output_delayed = false;
   // Set correctly only for key frames. Thus, use latest key frame
   // content type. If the corresponding key frame was lost, decode will fail
   // and content type will be ignored.
@@ -225,7 +238,8 @@ int32_t VCMGenericDecoder::Decode(const VCMEncodedFrame& frame, int64_t nowMs) {
   } else {
     _frameInfos[_nextFrameInfoIdx].content_type = _last_keyframe_content_type;
   }
-  _callback->Map(frame.Timestamp(), &_frameInfos[_nextFrameInfoIdx]);
+  VCMFrameInformation* const frame_info = &_frameInfos[_nextFrameInfoIdx];
+  _callback->Map(frame.Timestamp(), frame_info);
 
   _nextFrameInfoIdx = (_nextFrameInfoIdx + 1) % kDecoderFrameMemoryLength;
   int32_t ret = decoder_->Decode(frame.EncodedImage(), frame.MissingFrame(),
@@ -241,6 +255,11 @@ int32_t VCMGenericDecoder::Decode(const VCMEncodedFrame& frame, int64_t nowMs) {
              ret == WEBRTC_VIDEO_CODEC_REQUEST_SLI) {
     // No output
     _callback->Pop(frame.Timestamp());
+  } else if (ret == WEBRTC_VIDEO_CODEC_OUTPUT_DELAYED) {
+    // The frame information stays mapped until a later call delivers the
+    // frame. The time until then is reported to VCMTiming as pipeline delay,
+    // so that frames are passed to the decoder that much earlier.
+    frame_info->output_delayed = true;
   }
   return ret;
 }
@@ -25,6 +25,8 @@ namespace webrtc {
 
 class VCMReceiveCallback;
 
+// Also bounds the number of frames a decoder may hold back, see
+// WEBRTC_VIDEO_CODEC_OUTPUT_DELAYED.
 enum { kDecoderFrameMemoryLength = 10 };
 
 struct VCMFrameInformation {
@@ -34,6 +36,9 @@ struct VCMFrameInformation {
   VideoRotation rotation;
   VideoContentType content_type;
   EncodedImage::Timing timing;
+  // Set if Decode() returned WEBRTC_VIDEO_CODEC_OUTPUT_DELAYED, in which case a
+  // later Decode() call delivers the frame.
+  bool output_delayed;
 };
 
 class VCMDecodedFrameCallback : public DecodedImageCallback {
@@ -70,6 +75,9 @@ class VCMDecodedFrameCallback : public DecodedImageCallback {
   VCMTiming* _timing;
   rtc::CriticalSection lock_;
   VCMTimestampMap _timestampMap RTC_GUARDED_BY(lock_);
+  // Start time of the latest Decode() call, which is the one that delivers
+  // frames held back by the decoder.
+  int64_t last_decode_start_ms_ RTC_GUARDED_BY(lock_);
   uint64_t _lastReceivedPictureID;
   int64_t ntp_offset_;
 };
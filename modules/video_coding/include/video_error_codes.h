@@ -16,6 +16,9 @@
 // Define return values
 
 #define WEBRTC_VIDEO_CODEC_OK_REQUEST_KEYFRAME 4
+// The decoder accepted the frame and delivers it with a later Decode() call,
+// e.g. when it decodes several frames in parallel.
+#define WEBRTC_VIDEO_CODEC_OUTPUT_DELAYED 3
 #define WEBRTC_VIDEO_CODEC_REQUEST_SLI 2
 #define WEBRTC_VIDEO_CODEC_NO_OUTPUT 1
 #define WEBRTC_VIDEO_CODEC_OK 0
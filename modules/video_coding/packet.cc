@@ -79,6 +79,11 @@ VCMPacket::VCMPacket(const uint8_t* ptr,
   }
 }
 
+VCMPacket::VCMPacket(const VCMPacket&) = default;
+VCMPacket::VCMPacket(VCMPacket&&) = default;
 VCMPacket::~VCMPacket() = default;
 
+VCMPacket& VCMPacket::operator=(const VCMPacket&) = default;
+VCMPacket& VCMPacket::operator=(VCMPacket&&) = default;
+
 }  // namespace webrtc
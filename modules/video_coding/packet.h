@@ -13,6 +13,7 @@
 
 #include "modules/include/module_common_types.h"
 #include "modules/rtp_rtcp/source/rtp_generic_frame_descriptor.h"
+#include "rtc_base/copyonwritebuffer.h"
 
 namespace webrtc {
 
@@ -22,9 +23,13 @@ class VCMPacket {
   VCMPacket(const uint8_t* ptr,
             const size_t size,
             const WebRtcRTPHeader& rtpHeader);
-
+  VCMPacket(const VCMPacket&);
+  VCMPacket(VCMPacket&&);
   ~VCMPacket();
 
+  VCMPacket& operator=(const VCMPacket&);
+  VCMPacket& operator=(VCMPacket&&);
+
   uint8_t payloadType;
   uint32_t timestamp;
   // NTP time of the capture time in local timebase in milliseconds.
@@ -32,6 +37,9 @@ class VCMPacket {
   uint16_t seqNum;
   const uint8_t* dataPtr;
   size_t sizeBytes;
+  // If not empty, the buffer |dataPtr| points into. video_coding::PacketBuffer
+  // keeps a reference to it instead of taking ownership of |dataPtr|.
+  rtc::CopyOnWriteBuffer payload_buffer;
   bool markerBit;
   int timesNacked;
 
@@ -25,6 +25,9 @@
 namespace webrtc {
 namespace video_coding {
 
+constexpr int PacketBuffer::kMaxPaddingAge;
+constexpr size_t PacketBuffer::kMaxTimestampsHistory;
+
 rtc::scoped_refptr<PacketBuffer> PacketBuffer::Create(
     Clock* clock,
     size_t start_buffer_size,
@@ -49,7 +52,9 @@ PacketBuffer::PacketBuffer(Clock* clock,
       received_frame_callback_(received_frame_callback),
       unique_frames_seen_(0),
       sps_pps_idr_is_h264_keyframe_(
-          field_trial::IsEnabled("WebRTC-SpsPpsIdrIsH264Keyframe")) {
+          field_trial::IsEnabled("WebRTC-SpsPpsIdrIsH264Keyframe")),
+      rtp_timestamps_history_size_(0),
+      rtp_timestamps_history_next_(0) {
   RTC_DCHECK_LE(start_buffer_size, max_buffer_size);
   // Buffer size must always be a power of 2.
   RTC_DCHECK((start_buffer_size & (start_buffer_size - 1)) == 0);
@@ -68,7 +73,7 @@ bool PacketBuffer::InsertPacket(VCMPacket* packet) {
     OnTimestampReceived(packet->timestamp);
 
     uint16_t seq_num = packet->seqNum;
-    size_t index = seq_num % size_;
+    size_t index = Index(seq_num);
 
     if (!first_packet_received_) {
       first_seq_num_ = seq_num;
@@ -77,8 +82,7 @@ bool PacketBuffer::InsertPacket(VCMPacket* packet) {
       // If we have explicitly cleared past this packet then it's old,
       // don't insert it.
       if (is_cleared_to_first_seq_num_) {
-        delete[] packet->dataPtr;
-        packet->dataPtr = nullptr;
+        ReleasePayload(packet);
         return false;
       }
 
@@ -88,20 +92,18 @@ bool PacketBuffer::InsertPacket(VCMPacket* packet) {
     if (sequence_buffer_[index].used) {
       // Duplicate packet, just delete the payload.
       if (data_buffer_[index].seqNum == packet->seqNum) {
-        delete[] packet->dataPtr;
-        packet->dataPtr = nullptr;
+        ReleasePayload(packet);
         return true;
       }
 
       // The packet buffer is full, try to expand the buffer.
-      while (ExpandBufferSize() && sequence_buffer_[seq_num % size_].used) {
+      while (ExpandBufferSize() && sequence_buffer_[Index(seq_num)].used) {
       }
-      index = seq_num % size_;
+      index = Index(seq_num);
 
       // Packet buffer is still full.
       if (sequence_buffer_[index].used) {
-        delete[] packet->dataPtr;
-        packet->dataPtr = nullptr;
+        ReleasePayload(packet);
         return false;
       }
     }
@@ -112,14 +114,15 @@ bool PacketBuffer::InsertPacket(VCMPacket* packet) {
     sequence_buffer_[index].continuous = false;
     sequence_buffer_[index].frame_created = false;
     sequence_buffer_[index].used = true;
-    data_buffer_[index] = *packet;
+    const bool is_keyframe = packet->frameType == kVideoFrameKey;
+    data_buffer_[index] = std::move(*packet);
     packet->dataPtr = nullptr;
 
-    UpdateMissingPackets(packet->seqNum);
+    UpdateMissingPackets(seq_num);
 
     int64_t now_ms = clock_->TimeInMilliseconds();
     last_received_packet_ms_ = now_ms;
-    if (packet->frameType == kVideoFrameKey)
+    if (is_keyframe)
       last_received_keyframe_packet_ms_ = now_ms;
 
     found_frames = FindFrames(seq_num);
@@ -149,11 +152,10 @@ void PacketBuffer::ClearTo(uint16_t seq_num) {
   size_t diff = ForwardDiff<uint16_t>(first_seq_num_, seq_num);
   size_t iterations = std::min(diff, size_);
   for (size_t i = 0; i < iterations; ++i) {
-    size_t index = first_seq_num_ % size_;
+    size_t index = Index(first_seq_num_);
     RTC_DCHECK_EQ(data_buffer_[index].seqNum, sequence_buffer_[index].seq_num);
     if (AheadOf<uint16_t>(seq_num, sequence_buffer_[index].seq_num)) {
-      delete[] data_buffer_[index].dataPtr;
-      data_buffer_[index].dataPtr = nullptr;
+      ReleasePayload(&data_buffer_[index]);
       sequence_buffer_[index].used = false;
     }
     ++first_seq_num_;
@@ -164,18 +166,17 @@ void PacketBuffer::ClearTo(uint16_t seq_num) {
   first_seq_num_ = seq_num;
 
   is_cleared_to_first_seq_num_ = true;
-  auto clear_to_it = missing_packets_.upper_bound(seq_num);
-  if (clear_to_it != missing_packets_.begin()) {
-    --clear_to_it;
-    missing_packets_.erase(missing_packets_.begin(), clear_to_it);
-  }
+  // Keep the newest missing packet up to |seq_num|.
+  absl::optional<uint16_t> newest_missing_packet =
+      missing_packets_.NewestBefore(static_cast<uint16_t>(seq_num + 1));
+  if (newest_missing_packet)
+    missing_packets_.EraseBefore(*newest_missing_packet);
 }
 
 void PacketBuffer::Clear() {
   rtc::CritScope lock(&crit_);
   for (size_t i = 0; i < size_; ++i) {
-    delete[] data_buffer_[i].dataPtr;
-    data_buffer_[i].dataPtr = nullptr;
+    ReleasePayload(&data_buffer_[i]);
     sequence_buffer_[i].used = false;
   }
 
@@ -184,7 +185,7 @@ void PacketBuffer::Clear() {
   last_received_packet_ms_.reset();
   last_received_keyframe_packet_ms_.reset();
   newest_inserted_seq_num_.reset();
-  missing_packets_.clear();
+  missing_packets_.Clear();
 }
 
 void PacketBuffer::PaddingReceived(uint16_t seq_num) {
@@ -227,9 +228,9 @@ bool PacketBuffer::ExpandBufferSize() {
   std::vector<ContinuityInfo> new_sequence_buffer(new_size);
   for (size_t i = 0; i < size_; ++i) {
     if (sequence_buffer_[i].used) {
-      size_t index = sequence_buffer_[i].seq_num % new_size;
+      size_t index = sequence_buffer_[i].seq_num & (new_size - 1);
       new_sequence_buffer[index] = sequence_buffer_[i];
-      new_data_buffer[index] = data_buffer_[i];
+      new_data_buffer[index] = std::move(data_buffer_[i]);
     }
   }
   size_ = new_size;
@@ -240,7 +241,7 @@ bool PacketBuffer::ExpandBufferSize() {
 }
 
 bool PacketBuffer::PotentialNewFrame(uint16_t seq_num) const {
-  size_t index = seq_num % size_;
+  size_t index = Index(seq_num);
   int prev_index = index > 0 ? index - 1 : size_ - 1;
 
   if (!sequence_buffer_[index].used)
@@ -269,7 +270,7 @@ std::vector<std::unique_ptr<RtpFrameObject>> PacketBuffer::FindFrames(
     uint16_t seq_num) {
   std::vector<std::unique_ptr<RtpFrameObject>> found_frames;
   for (size_t i = 0; i < size_ && PotentialNewFrame(seq_num); ++i) {
-    size_t index = seq_num % size_;
+    size_t index = Index(seq_num);
     sequence_buffer_[index].continuous = true;
 
     // If all packets of the frame is continuous, find the first packet of the
@@ -359,7 +360,7 @@ std::vector<std::unique_ptr<RtpFrameObject>> PacketBuffer::FindFrames(
         // Now that we have decided whether to treat this frame as a key frame
         // or delta frame in the frame buffer, we update the field that
         // determines if the RtpFrameObject is a key frame or delta frame.
-        const size_t first_packet_index = start_seq_num % size_;
+        const size_t first_packet_index = Index(start_seq_num);
         RTC_CHECK_LT(first_packet_index, size_);
         if (is_h264_keyframe) {
           data_buffer_[first_packet_index].frameType = kVideoFrameKey;
@@ -369,20 +370,20 @@ std::vector<std::unique_ptr<RtpFrameObject>> PacketBuffer::FindFrames(
 
         // If this is not a keyframe, make sure there are no gaps in the
         // packet sequence numbers up until this point.
-        if (!is_h264_keyframe && missing_packets_.upper_bound(start_seq_num) !=
-                                     missing_packets_.begin()) {
-          uint16_t stop_index = (index + 1) % size_;
+        if (!is_h264_keyframe &&
+            missing_packets_.ContainsAnyBefore(
+                static_cast<uint16_t>(start_seq_num + 1))) {
+          uint16_t stop_index = (index + 1) & (size_ - 1);
           while (start_index != stop_index) {
             sequence_buffer_[start_index].frame_created = false;
-            start_index = (start_index + 1) % size_;
+            start_index = (start_index + 1) & (size_ - 1);
           }
 
           return found_frames;
         }
       }
 
-      missing_packets_.erase(missing_packets_.begin(),
-                             missing_packets_.upper_bound(seq_num));
+      missing_packets_.EraseBefore(static_cast<uint16_t>(seq_num + 1));
 
       found_frames.emplace_back(
           new RtpFrameObject(this, start_seq_num, seq_num, frame_size,
@@ -395,8 +396,8 @@ std::vector<std::unique_ptr<RtpFrameObject>> PacketBuffer::FindFrames(
 
 void PacketBuffer::ReturnFrame(RtpFrameObject* frame) {
   rtc::CritScope lock(&crit_);
-  size_t index = frame->first_seq_num() % size_;
-  size_t end = (frame->last_seq_num() + 1) % size_;
+  size_t index = Index(frame->first_seq_num());
+  size_t end = Index(frame->last_seq_num() + 1);
   uint16_t seq_num = frame->first_seq_num();
   uint32_t timestamp = frame->Timestamp();
   while (index != end) {
@@ -404,22 +405,31 @@ void PacketBuffer::ReturnFrame(RtpFrameObject* frame) {
     // around too quickly for high packet rates.
     if (sequence_buffer_[index].seq_num == seq_num &&
         data_buffer_[index].timestamp == timestamp) {
-      delete[] data_buffer_[index].dataPtr;
-      data_buffer_[index].dataPtr = nullptr;
+      ReleasePayload(&data_buffer_[index]);
       sequence_buffer_[index].used = false;
     }
 
-    index = (index + 1) % size_;
+    index = (index + 1) & (size_ - 1);
     ++seq_num;
   }
 }
 
+// static
+void PacketBuffer::ReleasePayload(VCMPacket* packet) {
+  if (packet->payload_buffer.capacity() > 0) {
+    packet->payload_buffer = rtc::CopyOnWriteBuffer();
+  } else {
+    delete[] packet->dataPtr;
+  }
+  packet->dataPtr = nullptr;
+}
+
 bool PacketBuffer::GetBitstream(const RtpFrameObject& frame,
                                 uint8_t* destination) {
   rtc::CritScope lock(&crit_);
 
-  size_t index = frame.first_seq_num() % size_;
-  size_t end = (frame.last_seq_num() + 1) % size_;
+  size_t index = Index(frame.first_seq_num());
+  size_t end = Index(frame.last_seq_num() + 1);
   uint16_t seq_num = frame.first_seq_num();
   uint32_t timestamp = frame.Timestamp();
   uint8_t* destination_end = destination + frame.size();
@@ -445,7 +455,7 @@ bool PacketBuffer::GetBitstream(const RtpFrameObject& frame,
     const uint8_t* source = data_buffer_[index].dataPtr;
     memcpy(destination, source, length);
     destination += length;
-    index = (index + 1) % size_;
+    index = (index + 1) & (size_ - 1);
     ++seq_num;
   } while (index != end);
 
@@ -453,7 +463,7 @@ bool PacketBuffer::GetBitstream(const RtpFrameObject& frame,
 }
 
 VCMPacket* PacketBuffer::GetPacket(uint16_t seq_num) {
-  size_t index = seq_num % size_;
+  size_t index = Index(seq_num);
   if (!sequence_buffer_[index].used ||
       seq_num != sequence_buffer_[index].seq_num) {
     return nullptr;
@@ -477,38 +487,44 @@ void PacketBuffer::UpdateMissingPackets(uint16_t seq_num) {
   if (!newest_inserted_seq_num_)
     newest_inserted_seq_num_ = seq_num;
 
-  const int kMaxPaddingAge = 1000;
   if (AheadOf(seq_num, *newest_inserted_seq_num_)) {
-    uint16_t old_seq_num = seq_num - kMaxPaddingAge;
-    auto erase_to = missing_packets_.lower_bound(old_seq_num);
-    missing_packets_.erase(missing_packets_.begin(), erase_to);
+    // Drops the missing packets older than |kMaxPaddingAge|.
+    missing_packets_.Advance(seq_num);
 
     // Guard against inserting a large amount of missing packets if there is a
     // jump in the sequence number.
+    uint16_t old_seq_num = seq_num - kMaxPaddingAge;
     if (AheadOf(old_seq_num, *newest_inserted_seq_num_))
       *newest_inserted_seq_num_ = old_seq_num;
 
     ++*newest_inserted_seq_num_;
-    while (AheadOf(seq_num, *newest_inserted_seq_num_)) {
-      missing_packets_.insert(*newest_inserted_seq_num_);
-      ++*newest_inserted_seq_num_;
-    }
+    missing_packets_.Insert(*newest_inserted_seq_num_, seq_num);
+    *newest_inserted_seq_num_ = seq_num;
   } else {
-    missing_packets_.erase(seq_num);
+    missing_packets_.Erase(seq_num);
   }
 }
 
 void PacketBuffer::OnTimestampReceived(uint32_t rtp_timestamp) {
-  const size_t kMaxTimestampsHistory = 1000;
-  if (rtp_timestamps_history_set_.insert(rtp_timestamp).second) {
-    rtp_timestamps_history_queue_.push(rtp_timestamp);
-    ++unique_frames_seen_;
-    if (rtp_timestamps_history_set_.size() > kMaxTimestampsHistory) {
-      uint32_t discarded_timestamp = rtp_timestamps_history_queue_.front();
-      rtp_timestamps_history_set_.erase(discarded_timestamp);
-      rtp_timestamps_history_queue_.pop();
+  if (rtp_timestamps_history_size_ > 0) {
+    const size_t newest = (rtp_timestamps_history_next_ +
+                           kMaxTimestampsHistory - 1) %
+                          kMaxTimestampsHistory;
+    if (rtp_timestamps_history_[newest] == rtp_timestamp)
+      return;
+    const auto history_end =
+        rtp_timestamps_history_.begin() + rtp_timestamps_history_size_;
+    if (std::find(rtp_timestamps_history_.begin(), history_end,
+                  rtp_timestamp) != history_end) {
+      return;
     }
   }
+  ++unique_frames_seen_;
+  rtp_timestamps_history_[rtp_timestamps_history_next_] = rtp_timestamp;
+  rtp_timestamps_history_next_ =
+      (rtp_timestamps_history_next_ + 1) % kMaxTimestampsHistory;
+  if (rtp_timestamps_history_size_ < kMaxTimestampsHistory)
+    ++rtp_timestamps_history_size_;
 }
 
 }  // namespace video_coding
@@ -11,14 +11,14 @@
 #ifndef MODULES_VIDEO_CODING_PACKET_BUFFER_H_
 #define MODULES_VIDEO_CODING_PACKET_BUFFER_H_
 
+#include <array>
 #include <memory>
-#include <queue>
-#include <set>
 #include <vector>
 
 #include "modules/include/module_common_types.h"
 #include "modules/video_coding/packet.h"
 #include "modules/video_coding/rtp_frame_reference_finder.h"
+#include "modules/video_coding/seq_num_bitmap.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/numerics/sequence_number_util.h"
 #include "rtc_base/scoped_ref_ptr.h"
@@ -51,7 +51,8 @@ class PacketBuffer {
 
   // Returns true if |packet| is inserted into the packet buffer, false
   // otherwise. The PacketBuffer will always take ownership of the
-  // |packet.dataPtr| when this function is called. Made virtual for testing.
+  // |packet.dataPtr| when this function is called, and moves the rest of
+  // |packet| into the buffer if it's inserted. Made virtual for testing.
   virtual bool InsertPacket(VCMPacket* packet);
   void ClearTo(uint16_t seq_num);
   void Clear();
@@ -99,8 +100,16 @@ class PacketBuffer {
     bool frame_created = false;
   };
 
+  static constexpr int kMaxPaddingAge = 1000;
+  static constexpr size_t kMaxTimestampsHistory = 1000;
+
   Clock* const clock_;
 
+  // The slot of |seq_num| in |data_buffer_| and |sequence_buffer_|.
+  size_t Index(uint16_t seq_num) const RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    return seq_num & (size_ - 1);
+  }
+
   // Tries to expand the buffer.
   bool ExpandBufferSize() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
@@ -126,6 +135,10 @@ class PacketBuffer {
   // Virtual for testing.
   virtual void ReturnFrame(RtpFrameObject* frame);
 
+  // Frees the payload of |packet|, or releases the reference to its
+  // |payload_buffer| if it has one.
+  static void ReleasePayload(VCMPacket* packet);
+
   void UpdateMissingPackets(uint16_t seq_num)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
@@ -166,17 +179,23 @@ class PacketBuffer {
   int unique_frames_seen_ RTC_GUARDED_BY(crit_);
 
   absl::optional<uint16_t> newest_inserted_seq_num_ RTC_GUARDED_BY(crit_);
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t>> missing_packets_
+  // Packets missing among the |kMaxPaddingAge| sequence numbers before
+  // |newest_inserted_seq_num_|.
+  SeqNumBitmap<uint16_t, kMaxPaddingAge> missing_packets_
       RTC_GUARDED_BY(crit_);
 
   // Indicates if we should require SPS, PPS, and IDR for a particular
   // RTP timestamp to treat the corresponding frame as a keyframe.
   const bool sps_pps_idr_is_h264_keyframe_;
 
-  // Stores several last seen unique timestamps for quick search.
-  std::set<uint32_t> rtp_timestamps_history_set_ RTC_GUARDED_BY(crit_);
-  // Stores the same unique timestamps in the order of insertion.
-  std::queue<uint32_t> rtp_timestamps_history_queue_ RTC_GUARDED_BY(crit_);
+  // The last |kMaxTimestampsHistory| unique timestamps, as a ring in the
+  // order of insertion. Searched linearly, but only when a packet's timestamp
+  // differs from the newest one, i.e. about once per frame.
+  std::array<uint32_t, kMaxTimestampsHistory> rtp_timestamps_history_
+      RTC_GUARDED_BY(crit_);
+  size_t rtp_timestamps_history_size_ RTC_GUARDED_BY(crit_);
+  // Where the next unique timestamp is stored in |rtp_timestamps_history_|.
+  size_t rtp_timestamps_history_next_ RTC_GUARDED_BY(crit_);
 
   mutable volatile int ref_count_ = 0;
 };
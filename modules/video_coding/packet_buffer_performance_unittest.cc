@@ -0,0 +1,151 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "modules/video_coding/frame_object.h"
+#include "modules/video_coding/packet_buffer.h"
+#include "modules/video_coding/rtp_frame_reference_finder.h"
+#include "rtc_base/copyonwritebuffer.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/random.h"
+#include "system_wrappers/include/clock.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace video_coding {
+namespace {
+
+// A 4K stream at 60 fps and 25 Mbps, sent as VP8 with three temporal layers
+// in packets of 1200 bytes.
+constexpr int kFps = 60;
+constexpr int kNumFrames = 60 * kFps;
+constexpr int kPacketsPerFrame = 25000000 / 8 / kFps / 1200;
+constexpr size_t kPayloadSize = 1200;
+constexpr int kLossPercent = 2;
+constexpr int kRetransmissionDelayPackets = 2 * kPacketsPerFrame;
+// Same as in RtpVideoStreamReceiver.
+constexpr size_t kPacketBufferStartSize = 512;
+constexpr size_t kPacketBufferMaxSize = 2048;
+
+class ReceivePath : public OnReceivedFrameCallback,
+                    public OnCompleteFrameCallback {
+ public:
+  ReceivePath()
+      : clock_(0),
+        packet_buffer_(PacketBuffer::Create(&clock_,
+                                            kPacketBufferStartSize,
+                                            kPacketBufferMaxSize,
+                                            this)),
+        reference_finder_(this) {}
+
+  void OnReceivedFrame(std::unique_ptr<RtpFrameObject> frame) override {
+    reference_finder_.ManageFrame(std::move(frame));
+  }
+
+  void OnCompleteFrame(std::unique_ptr<EncodedFrame> frame) override {
+    ++num_complete_frames_;
+  }
+
+  void InsertPacket(VCMPacket* packet) { packet_buffer_->InsertPacket(packet); }
+
+  int num_complete_frames() const { return num_complete_frames_; }
+
+ private:
+  SimulatedClock clock_;
+  rtc::scoped_refptr<PacketBuffer> packet_buffer_;
+  RtpFrameReferenceFinder reference_finder_;
+  int num_complete_frames_ = 0;
+};
+
+// Fills in |packet| as RtpVideoStreamReceiver does for the |packet_index|th
+// packet of the stream.
+void CreatePacket(int packet_index,
+                  const rtc::CopyOnWriteBuffer& payload,
+                  VCMPacket* packet) {
+  const int frame = packet_index / kPacketsPerFrame;
+  const int index_in_frame = packet_index % kPacketsPerFrame;
+  // Temporal layer pattern 0, 2, 1, 2.
+  const uint8_t temporal_idx = frame % 2 == 1 ? 2 : (frame % 4) / 2;
+  packet->codec = kVideoCodecVP8;
+  packet->seqNum = static_cast<uint16_t>(0xffff - 100 + packet_index);
+  packet->timestamp = frame * (90000 / kFps);
+  packet->frameType = frame == 0 ? kVideoFrameKey : kVideoFrameDelta;
+  packet->is_first_packet_in_frame = index_in_frame == 0;
+  packet->is_last_packet_in_frame = index_in_frame == kPacketsPerFrame - 1;
+  packet->markerBit = packet->is_last_packet_in_frame;
+  packet->video_header.codec = kVideoCodecVP8;
+  packet->video_header.width = 3840;
+  packet->video_header.height = 2160;
+  auto& vp8_header =
+      packet->video_header.video_type_header.emplace<RTPVideoHeaderVP8>();
+  vp8_header.InitRTPVideoHeaderVP8();
+  vp8_header.pictureId = frame % (1 << 15);
+  vp8_header.tl0PicIdx = static_cast<uint8_t>(frame / 4);
+  vp8_header.temporalIdx = temporal_idx;
+  // The first frames of the upper layers only reference the base layer.
+  vp8_header.layerSync = frame < 4 && temporal_idx > 0;
+  packet->payload_buffer = payload;
+  packet->dataPtr = payload.cdata();
+  packet->sizeBytes = payload.size();
+}
+
+// Returns the indices of the packets in the order they are received. Lost
+// packets are received again after |kRetransmissionDelayPackets| other
+// packets, as if they were retransmitted in response to a NACK.
+std::vector<int> ReceiveOrder() {
+  constexpr int kNumPackets = kNumFrames * kPacketsPerFrame;
+  Random random(0x5eed);
+  std::vector<int> order;
+  std::deque<std::pair<int, int>> retransmissions;
+  for (int i = 0; i < kNumPackets; ++i) {
+    while (!retransmissions.empty() && retransmissions.front().first <= i) {
+      order.push_back(retransmissions.front().second);
+      retransmissions.pop_front();
+    }
+    if (static_cast<int>(random.Rand(0, 99)) < kLossPercent)
+      retransmissions.emplace_back(i + kRetransmissionDelayPackets, i);
+    else
+      order.push_back(i);
+  }
+  for (const auto& retransmission : retransmissions)
+    order.push_back(retransmission.second);
+  return order;
+}
+
+}  // namespace
+
+// Inserts a 4K60 stream with 2% packet loss into a PacketBuffer, which hands
+// the assembled frames to an RtpFrameReferenceFinder, and reports the CPU
+// time per received packet.
+TEST(PacketBufferPerformanceTest, Receive4k60With2PercentLoss) {
+  const rtc::CopyOnWriteBuffer payload(kPayloadSize, kPayloadSize);
+  const std::vector<int> order = ReceiveOrder();
+  ReceivePath receive_path;
+
+  const int64_t start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+  for (int packet_index : order) {
+    VCMPacket packet;
+    CreatePacket(packet_index, payload, &packet);
+    receive_path.InsertPacket(&packet);
+  }
+  const int64_t elapsed_cpu_ns = rtc::GetThreadCpuTimeNanos() - start_cpu_ns;
+
+  EXPECT_EQ(kNumFrames, receive_path.num_complete_frames());
+  test::PrintResult("packet_buffer_cpu_time_per_packet", "", "4k60_2pct_loss",
+                    static_cast<double>(elapsed_cpu_ns) / order.size(), "ns",
+                    true);
+}
+
+}  // namespace video_coding
+}  // namespace webrtc
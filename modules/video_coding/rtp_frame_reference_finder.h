@@ -13,6 +13,7 @@
 
 #include <array>
 #include <deque>
+#include <limits>
 #include <map>
 #include <memory>
 #include <set>
@@ -20,6 +21,7 @@
 
 #include "modules/include/module_common_types.h"
 #include "modules/rtp_rtcp/source/rtp_generic_frame_descriptor.h"
+#include "modules/video_coding/seq_num_bitmap.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/numerics/sequence_number_util.h"
 #include "rtc_base/thread_annotations.h"
@@ -66,16 +68,74 @@ class RtpFrameReferenceFinder {
   static const int kMaxNotYetReceivedFrames = 100;
   static const int kMaxGofSaved = 50;
   static const int kMaxPaddingAge = 100;
+  static const int kTl0PicIdxMapSize = 64;
+  static_assert(kTl0PicIdxMapSize >= kMaxLayerInfo &&
+                    kTl0PicIdxMapSize >= kMaxGofSaved,
+                "The TL0 picture index maps must hold all saved entries.");
 
   enum FrameDecision { kStash, kHandOff, kDrop };
 
   struct GofInfo {
+    GofInfo() : gof(nullptr), last_picture_id(0) {}
     GofInfo(GofInfoVP9* gof, uint16_t last_picture_id)
         : gof(gof), last_picture_id(last_picture_id) {}
     GofInfoVP9* gof;
     uint16_t last_picture_id;
   };
 
+  // Map from unwrapped TL0 picture indices to |Value|s, stored in a ring
+  // indexed by |tl0_pic_idx % kSize|. An entry evicts the entry of an older
+  // index that is a multiple of |kSize| away from it. An entry for an index
+  // that far behind an existing one is refused instead.
+  template <typename Value, size_t kSize>
+  class Tl0PicIdxMap {
+   public:
+    Tl0PicIdxMap() {
+      for (Entry& entry : entries_)
+        entry.tl0_pic_idx = kUnused;
+    }
+
+    Value* Find(int64_t tl0_pic_idx) {
+      Entry& entry = entries_[Slot(tl0_pic_idx)];
+      return entry.tl0_pic_idx == tl0_pic_idx ? &entry.value : nullptr;
+    }
+
+    // Like std::map::emplace(), returns the existing value for
+    // |tl0_pic_idx| if there is one. Returns null if the slot holds a newer
+    // index.
+    Value* Emplace(int64_t tl0_pic_idx, const Value& value) {
+      Entry& entry = entries_[Slot(tl0_pic_idx)];
+      if (entry.tl0_pic_idx > tl0_pic_idx)
+        return nullptr;
+      if (entry.tl0_pic_idx != tl0_pic_idx) {
+        entry.tl0_pic_idx = tl0_pic_idx;
+        entry.value = value;
+      }
+      return &entry.value;
+    }
+
+    void EraseBefore(int64_t tl0_pic_idx) {
+      for (Entry& entry : entries_) {
+        if (entry.tl0_pic_idx < tl0_pic_idx)
+          entry.tl0_pic_idx = kUnused;
+      }
+    }
+
+   private:
+    static constexpr int64_t kUnused = std::numeric_limits<int64_t>::min();
+
+    struct Entry {
+      int64_t tl0_pic_idx;
+      Value value;
+    };
+
+    static size_t Slot(int64_t tl0_pic_idx) {
+      return static_cast<uint64_t>(tl0_pic_idx) % kSize;
+    }
+
+    std::array<Entry, kSize> entries_;
+  };
+
   rtc::CriticalSection crit_;
 
   // Find the relevant group of pictures and update its "last-picture-id-with
@@ -155,8 +215,8 @@ class RtpFrameReferenceFinder {
       RTC_GUARDED_BY(crit_);
 
   // Frames earlier than the last received frame that have not yet been
-  // fully received.
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t, kPicIdLength>>
+  // fully received, out of the last |kMaxNotYetReceivedFrames| frames.
+  SeqNumBitmap<uint16_t, kMaxNotYetReceivedFrames, kPicIdLength>
       not_yet_received_frames_ RTC_GUARDED_BY(crit_);
 
   // Frames that have been fully received but didn't have all the information
@@ -166,8 +226,8 @@ class RtpFrameReferenceFinder {
 
   // Holds the information about the last completed frame for a given temporal
   // layer given an unwrapped Tl0 picture index.
-  std::map<int64_t, std::array<int16_t, kMaxTemporalLayers>> layer_info_
-      RTC_GUARDED_BY(crit_);
+  Tl0PicIdxMap<std::array<int16_t, kMaxTemporalLayers>, kTl0PicIdxMapSize>
+      layer_info_ RTC_GUARDED_BY(crit_);
 
   // Where the current scalability structure is in the
   // |scalability_structures_| array.
@@ -178,7 +238,7 @@ class RtpFrameReferenceFinder {
       RTC_GUARDED_BY(crit_);
 
   // Holds the the Gof information for a given unwrapped TL0 picture index.
-  std::map<int64_t, GofInfo> gof_info_ RTC_GUARDED_BY(crit_);
+  Tl0PicIdxMap<GofInfo, kTl0PicIdxMapSize> gof_info_ RTC_GUARDED_BY(crit_);
 
   // Keep track of which picture id and which temporal layer that had the
   // up switch flag set.
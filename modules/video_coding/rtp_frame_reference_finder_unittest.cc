@@ -707,6 +707,20 @@ TEST_F(TestRtpFrameReferenceFinder, Vp8DetectMissingFrame_0212) {
   CheckReferencesVp8(7, 6, 5, 4);
 }
 
+TEST_F(TestRtpFrameReferenceFinder, Vp8LateKeyframeKeepsNewerLayerInfo) {
+  InsertVp8(1, 1, true, 1, 0, 70, false);
+  InsertVp8(2, 2, false, 2, 0, 71, false);
+  // A keyframe 64 TL0 indices late must not replace the layer info of TL0
+  // index 71.
+  InsertVp8(3, 3, true, (1 << 15) - 10, 0, 7, false);
+  InsertVp8(4, 4, false, 3, 0, 72, false);
+  ASSERT_EQ(4UL, frames_from_callback_.size());
+
+  CheckReferencesVp8(0);
+  CheckReferencesVp8(1, 0);
+  CheckReferencesVp8(2, 1);
+}
+
 TEST_F(TestRtpFrameReferenceFinder, Vp9GofInsertOneFrame) {
   uint16_t pid = Rand();
   uint16_t sn = Rand();
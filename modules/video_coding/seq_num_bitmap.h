@@ -0,0 +1,181 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_SEQ_NUM_BITMAP_H_
+#define MODULES_VIDEO_CODING_SEQ_NUM_BITMAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <type_traits>
+
+#include "absl/types/optional.h"
+#include "rtc_base/numerics/sequence_number_util.h"
+
+namespace webrtc {
+namespace video_coding {
+
+// A set of sequence numbers, such as the sequence numbers of missing packets,
+// that only holds the |kWindowSize| numbers before the end of its window.
+// Moving the end forward with Advance() removes the numbers that fall out of
+// the window, and numbers outside of the window are never inserted.
+//
+// The set is a ring of bits indexed by |seq_num % kNumBits|, so that
+// operations on ranges of sequence numbers work on whole words and nothing is
+// allocated after construction.
+//
+// All ranges are half-open, [begin, end).
+template <typename T, size_t kWindowSize, T M = 0>
+class SeqNumBitmap {
+ public:
+  SeqNumBitmap() { Clear(); }
+
+  void Clear() {
+    words_.fill(0);
+    has_end_ = false;
+  }
+
+  // Moves the end of the window to |end|, removing the numbers that are no
+  // longer within the window. Does nothing unless |end| is ahead of the
+  // current end.
+  void Advance(T end) {
+    if (has_end_) {
+      if (!AheadOf<T, M>(end, end_))
+        return;
+      const size_t distance = ForwardDiff<T, M>(end_, end);
+      SetBits(0, std::min(distance, kWindowSize), false);
+    }
+    end_ = end;
+    has_end_ = true;
+  }
+
+  void Insert(T seq_num) { Insert(seq_num, Add(seq_num, 1)); }
+  void Insert(T begin, T end) { SetBits(Offset(begin), Offset(end), true); }
+  void Erase(T seq_num) {
+    SetBits(Offset(seq_num), Offset(Add(seq_num, 1)), false);
+  }
+
+  // Removes all numbers before |seq_num|.
+  void EraseBefore(T seq_num) { SetBits(0, Offset(seq_num), false); }
+
+  bool Contains(T seq_num) const {
+    return ContainsAny(seq_num, Add(seq_num, 1));
+  }
+  bool ContainsAny(T begin, T end) const {
+    bool found = false;
+    ForEachWord(Offset(begin), Offset(end), [&](size_t word, uint64_t mask) {
+      found = (words_[word] & mask) != 0;
+      return !found;
+    });
+    return found;
+  }
+  bool ContainsAnyBefore(T seq_num) const {
+    return has_end_ && ContainsAny(Start(), seq_num);
+  }
+
+  // Returns the newest number in the set that is before |seq_num|.
+  absl::optional<T> NewestBefore(T seq_num) const {
+    size_t last_word = kNumWords;
+    uint64_t last_bits = 0;
+    ForEachWord(0, Offset(seq_num), [&](size_t word, uint64_t mask) {
+      if (words_[word] & mask) {
+        last_word = word;
+        last_bits = words_[word] & mask;
+      }
+      return true;
+    });
+    if (last_word == kNumWords)
+      return absl::nullopt;
+    size_t bit = 63;
+    while (!((last_bits >> bit) & 1))
+      --bit;
+    const size_t index = last_word * 64 + bit;
+    return Add(Start(), (index + kNumBits - StartIndex()) % kNumBits);
+  }
+
+ private:
+  static constexpr size_t RoundUpToPowerOfTwo(size_t n, size_t power = 64) {
+    return power >= n ? power : RoundUpToPowerOfTwo(n, 2 * power);
+  }
+
+  static_assert(std::is_unsigned<T>::value && sizeof(T) < sizeof(uint64_t),
+                "Sequence numbers must be unsigned integers.");
+  static constexpr uint64_t kModulus =
+      M == 0 ? uint64_t{std::numeric_limits<T>::max()} + 1 : M;
+  static constexpr size_t kNumBits = RoundUpToPowerOfTwo(kWindowSize);
+  static constexpr size_t kNumWords = kNumBits / 64;
+  static_assert(kWindowSize > 0, "The window can't be empty.");
+  static_assert(kModulus % kNumBits == 0,
+                "The ring must evenly divide the sequence number space.");
+
+  static T Add(T seq_num, size_t n) {
+    return static_cast<T>((seq_num + n) % kModulus);
+  }
+  static T Subtract(T seq_num, size_t n) {
+    return static_cast<T>((seq_num + kModulus - n % kModulus) % kModulus);
+  }
+
+  // The oldest number within the window.
+  T Start() const { return Subtract(end_, kWindowSize); }
+  size_t StartIndex() const {
+    return (end_ % kNumBits + kNumBits - kWindowSize) % kNumBits;
+  }
+
+  // Returns how many numbers of the window there are before |seq_num|.
+  size_t Offset(T seq_num) const {
+    if (!has_end_)
+      return 0;
+    const T start = Start();
+    if (!AheadOrAt<T, M>(seq_num, start))
+      return 0;
+    return std::min<size_t>(ForwardDiff<T, M>(start, seq_num), kWindowSize);
+  }
+
+  // Calls |word_op(word, mask)| for the words holding the bits of the window
+  // offsets [begin, end), until it returns false.
+  template <typename WordOp>
+  void ForEachWord(size_t begin, size_t end, WordOp word_op) const {
+    size_t index = (StartIndex() + begin) % kNumBits;
+    size_t count = end > begin ? end - begin : 0;
+    while (count > 0) {
+      const size_t shift = index % 64;
+      const size_t num_bits = std::min<size_t>(count, 64 - shift);
+      const uint64_t bits =
+          num_bits == 64 ? ~uint64_t{0} : (uint64_t{1} << num_bits) - 1;
+      if (!word_op(index / 64, bits << shift))
+        return;
+      index = (index + num_bits) % kNumBits;
+      count -= num_bits;
+    }
+  }
+
+  void SetBits(size_t begin, size_t end, bool value) {
+    ForEachWord(begin, end, [&](size_t word, uint64_t mask) {
+      if (value)
+        words_[word] |= mask;
+      else
+        words_[word] &= ~mask;
+      return true;
+    });
+  }
+
+  std::array<uint64_t, kNumWords> words_;
+  // One past the newest number of the window.
+  T end_;
+  bool has_end_;
+};
+
+}  // namespace video_coding
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_SEQ_NUM_BITMAP_H_
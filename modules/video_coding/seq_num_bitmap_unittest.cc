@@ -0,0 +1,154 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/seq_num_bitmap.h"
+
+#include <set>
+
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace video_coding {
+
+TEST(SeqNumBitmapTest, EmptyBeforeAdvance) {
+  SeqNumBitmap<uint16_t, 100> bitmap;
+  bitmap.Insert(17);
+  EXPECT_FALSE(bitmap.Contains(17));
+  EXPECT_FALSE(bitmap.ContainsAnyBefore(17));
+  EXPECT_FALSE(bitmap.NewestBefore(18));
+}
+
+TEST(SeqNumBitmapTest, InsertAndEraseWithinWindow) {
+  SeqNumBitmap<uint16_t, 100> bitmap;
+  bitmap.Advance(1000);
+  bitmap.Insert(950, 960);
+  bitmap.Insert(990);
+  // Outside of the window.
+  bitmap.Insert(1000);
+  bitmap.Insert(899);
+
+  EXPECT_TRUE(bitmap.Contains(950));
+  EXPECT_TRUE(bitmap.Contains(959));
+  EXPECT_FALSE(bitmap.Contains(960));
+  EXPECT_TRUE(bitmap.Contains(990));
+  EXPECT_FALSE(bitmap.Contains(1000));
+  EXPECT_FALSE(bitmap.Contains(899));
+
+  EXPECT_FALSE(bitmap.ContainsAnyBefore(950));
+  EXPECT_TRUE(bitmap.ContainsAnyBefore(951));
+  EXPECT_FALSE(bitmap.ContainsAny(960, 990));
+  EXPECT_TRUE(bitmap.ContainsAny(960, 991));
+  EXPECT_EQ(990, bitmap.NewestBefore(1000));
+  EXPECT_EQ(959, bitmap.NewestBefore(990));
+
+  bitmap.Erase(990);
+  EXPECT_FALSE(bitmap.Contains(990));
+  bitmap.EraseBefore(955);
+  EXPECT_FALSE(bitmap.Contains(954));
+  EXPECT_TRUE(bitmap.Contains(955));
+}
+
+TEST(SeqNumBitmapTest, AdvanceRemovesNumbersOutsideOfWindow) {
+  SeqNumBitmap<uint16_t, 100> bitmap;
+  bitmap.Advance(100);
+  bitmap.Insert(0, 100);
+  bitmap.Advance(150);
+  EXPECT_FALSE(bitmap.Contains(49));
+  EXPECT_TRUE(bitmap.Contains(50));
+  EXPECT_FALSE(bitmap.Contains(100));
+
+  // Moving the end backwards does nothing.
+  bitmap.Advance(120);
+  EXPECT_TRUE(bitmap.Contains(50));
+
+  bitmap.Advance(1000);
+  EXPECT_FALSE(bitmap.ContainsAnyBefore(1000));
+}
+
+TEST(SeqNumBitmapTest, WrapsAround) {
+  SeqNumBitmap<uint16_t, 100> bitmap;
+  bitmap.Advance(10);
+  bitmap.Insert(65530, 5);
+  EXPECT_TRUE(bitmap.Contains(65535));
+  EXPECT_TRUE(bitmap.Contains(0));
+  EXPECT_EQ(4, bitmap.NewestBefore(10));
+  EXPECT_EQ(65535, bitmap.NewestBefore(0));
+  EXPECT_TRUE(bitmap.ContainsAnyBefore(65531));
+  EXPECT_FALSE(bitmap.ContainsAnyBefore(65530));
+}
+
+TEST(SeqNumBitmapTest, PictureIdWrapsAround) {
+  constexpr uint16_t kPicIdLength = 1 << 15;
+  SeqNumBitmap<uint16_t, 100, kPicIdLength> bitmap;
+  bitmap.Advance(10);
+  bitmap.Insert(kPicIdLength - 5, 5);
+  EXPECT_TRUE(bitmap.Contains(kPicIdLength - 1));
+  EXPECT_TRUE(bitmap.Contains(0));
+  EXPECT_EQ(kPicIdLength - 1, bitmap.NewestBefore(0));
+  bitmap.EraseBefore(0);
+  EXPECT_FALSE(bitmap.Contains(kPicIdLength - 1));
+  EXPECT_TRUE(bitmap.Contains(0));
+}
+
+// Compares against a std::set holding the same window, with random
+// operations on a window that doesn't fill whole words.
+TEST(SeqNumBitmapTest, MatchesStdSetWithRandomOperations) {
+  constexpr int kWindowSize = 1000;
+  Random random(0x12345678);
+  SeqNumBitmap<uint16_t, kWindowSize> bitmap;
+  std::set<uint16_t, DescendingSeqNumComp<uint16_t>> reference;
+  uint16_t end = 65000;
+  bitmap.Advance(end);
+  for (int i = 0; i < 20000; ++i) {
+    const uint16_t seq_num = end - random.Rand(0, kWindowSize + 50);
+    switch (random.Rand(0, 4)) {
+      case 0: {
+        end += random.Rand(0, 100);
+        bitmap.Advance(end);
+        const uint16_t start = end - kWindowSize;
+        reference.erase(reference.begin(), reference.lower_bound(start));
+        break;
+      }
+      case 1: {
+        const uint16_t insert_end = seq_num + random.Rand(1, 50);
+        bitmap.Insert(seq_num, insert_end);
+        for (uint16_t s = seq_num; s != insert_end; ++s) {
+          if (AheadOf<uint16_t>(end, s) && ForwardDiff(s, end) <= kWindowSize)
+            reference.insert(s);
+        }
+        break;
+      }
+      case 2:
+        bitmap.Erase(seq_num);
+        reference.erase(seq_num);
+        break;
+      case 3:
+        bitmap.EraseBefore(seq_num);
+        reference.erase(reference.begin(), reference.lower_bound(seq_num));
+        break;
+      case 4: {
+        auto it = reference.lower_bound(seq_num);
+        EXPECT_EQ(it != reference.begin(), bitmap.ContainsAnyBefore(seq_num));
+        absl::optional<uint16_t> newest = bitmap.NewestBefore(seq_num);
+        ASSERT_EQ(it != reference.begin(), newest.has_value());
+        if (newest)
+          EXPECT_EQ(*std::prev(it), *newest);
+        break;
+      }
+    }
+    const uint16_t check_end = end + 50;
+    for (uint16_t s = end - kWindowSize - 50; s != check_end; ++s)
+      ASSERT_EQ(reference.count(s) > 0, bitmap.Contains(s)) << s;
+  }
+}
+
+}  // namespace video_coding
+}  // namespace webrtc
@@ -23,6 +23,7 @@ VCMTiming::VCMTiming(Clock* clock, VCMTiming* master_timing)
       ts_extrapolator_(),
       codec_timer_(new VCMCodecTimer()),
       render_delay_ms_(kDefaultRenderDelayMs),
+      decoder_pipeline_delay_ms_(0),
       min_playout_delay_ms_(0),
       max_playout_delay_ms_(10000),
       jitter_delay_ms_(0),
@@ -50,6 +51,7 @@ void VCMTiming::Reset() {
   ts_extrapolator_->Reset(clock_->TimeInMilliseconds());
   codec_timer_.reset(new VCMCodecTimer());
   render_delay_ms_ = kDefaultRenderDelayMs;
+  decoder_pipeline_delay_ms_ = 0;
   min_playout_delay_ms_ = 0;
   jitter_delay_ms_ = 0;
   current_delay_ms_ = 0;
@@ -61,6 +63,11 @@ void VCMTiming::set_render_delay(int render_delay_ms) {
   render_delay_ms_ = render_delay_ms;
 }
 
+void VCMTiming::set_decoder_pipeline_delay(int decoder_pipeline_delay_ms) {
+  rtc::CritScope cs(&crit_sect_);
+  decoder_pipeline_delay_ms_ = decoder_pipeline_delay_ms;
+}
+
 void VCMTiming::set_min_playout_delay(int min_playout_delay_ms) {
   rtc::CritScope cs(&crit_sect_);
   min_playout_delay_ms_ = min_playout_delay_ms;
@@ -138,7 +145,8 @@ void VCMTiming::UpdateCurrentDelay(int64_t render_time_ms,
   uint32_t target_delay_ms = TargetDelayInternal();
   int64_t delayed_ms =
       actual_decode_time_ms -
-      (render_time_ms - RequiredDecodeTimeMs() - render_delay_ms_);
+      (render_time_ms - RequiredDecodeTimeMs() - decoder_pipeline_delay_ms_ -
+       render_delay_ms_);
   if (delayed_ms < 0) {
     return;
   }
@@ -201,7 +209,8 @@ int64_t VCMTiming::MaxWaitingTime(int64_t render_time_ms,
   rtc::CritScope cs(&crit_sect_);
 
   const int64_t max_wait_time_ms =
-      render_time_ms - now_ms - RequiredDecodeTimeMs() - render_delay_ms_;
+      render_time_ms - now_ms - RequiredDecodeTimeMs() -
+      decoder_pipeline_delay_ms_ - render_delay_ms_;
 
   return max_wait_time_ms;
 }
@@ -213,7 +222,8 @@ int VCMTiming::TargetVideoDelay() const {
 
 int VCMTiming::TargetDelayInternal() const {
   return std::max(min_playout_delay_ms_,
-                  jitter_delay_ms_ + RequiredDecodeTimeMs() + render_delay_ms_);
+                  jitter_delay_ms_ + RequiredDecodeTimeMs() +
+                      decoder_pipeline_delay_ms_ + render_delay_ms_);
 }
 
 bool VCMTiming::GetTimings(int* decode_ms,
@@ -35,6 +35,11 @@ class VCMTiming {
   // Set the amount of time needed to render an image. Defaults to 10 ms.
   void set_render_delay(int render_delay_ms);
 
+  // Set the time the decoder holds frames before delivering them, e.g. with
+  // frame threads. Frames are passed to the decoder that much earlier, but the
+  // delay is not counted as decode time. Defaults to 0 ms.
+  void set_decoder_pipeline_delay(int decoder_pipeline_delay_ms);
+
   // Set the minimum time the video must be delayed on the receiver to
   // get the desired jitter buffer level.
   void SetJitterDelay(int required_delay_ms);
@@ -112,6 +117,7 @@ class VCMTiming {
   TimestampExtrapolator* ts_extrapolator_ RTC_GUARDED_BY(crit_sect_);
   std::unique_ptr<VCMCodecTimer> codec_timer_ RTC_GUARDED_BY(crit_sect_);
   int render_delay_ms_ RTC_GUARDED_BY(crit_sect_);
+  int decoder_pipeline_delay_ms_ RTC_GUARDED_BY(crit_sect_);
   // Best-effort playout delay range for frames from capture to render.
   // The receiver tries to keep the delay between |min_playout_delay_ms_|
   // and |max_playout_delay_ms_| taking the network jitter into account.
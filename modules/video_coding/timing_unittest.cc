@@ -128,4 +128,50 @@ TEST(ReceiverTiming, WrapAround) {
   }
 }
 
+TEST(ReceiverTiming, DecoderPipelineDelayIsNotDecodeTime) {
+  SimulatedClock clock(0);
+  VCMTiming timing(&clock);
+  timing.set_render_delay(0);
+  const int kJitterDelayMs = 20;
+  timing.SetJitterDelay(kJitterDelayMs);
+
+  // Frames that took 10 ms to decode, after being held 80 ms in the decoder.
+  const int kDecodeTimeMs = 10;
+  const int kPipelineDelayMs = 80;
+  uint32_t timestamp = 0;
+  for (int i = 0; i < kFps; ++i) {
+    timing.IncomingTimestamp(timestamp, clock.TimeInMilliseconds());
+    clock.AdvanceTimeMilliseconds(kDecodeTimeMs);
+    timing.StopDecodeTimer(timestamp, kDecodeTimeMs,
+                           clock.TimeInMilliseconds(),
+                           /*render_time_ms=*/0);
+    timing.set_decoder_pipeline_delay(kPipelineDelayMs);
+    timestamp += 90000 / kFps;
+    clock.AdvanceTimeMilliseconds(1000 / kFps - kDecodeTimeMs);
+  }
+
+  int decode_ms;
+  int max_decode_ms;
+  int current_delay_ms;
+  int target_delay_ms;
+  int jitter_buffer_ms;
+  int min_playout_delay_ms;
+  int render_delay_ms;
+  ASSERT_TRUE(timing.GetTimings(&decode_ms, &max_decode_ms, &current_delay_ms,
+                                &target_delay_ms, &jitter_buffer_ms,
+                                &min_playout_delay_ms, &render_delay_ms));
+  EXPECT_EQ(kDecodeTimeMs, decode_ms);
+  EXPECT_EQ(kDecodeTimeMs, max_decode_ms);
+  // The frames must still reach the decoder early enough to come out of the
+  // pipeline in time.
+  EXPECT_EQ(kJitterDelayMs + kDecodeTimeMs + kPipelineDelayMs, target_delay_ms);
+
+  timing.UpdateCurrentDelay(timestamp);
+  const int64_t render_time_ms =
+      timing.RenderTimeMs(timestamp, clock.TimeInMilliseconds());
+  EXPECT_EQ(render_time_ms - clock.TimeInMilliseconds() - kDecodeTimeMs -
+                kPipelineDelayMs,
+            timing.MaxWaitingTime(render_time_ms, clock.TimeInMilliseconds()));
+}
+
 }  // namespace webrtc
@@ -23,9 +23,18 @@
 #include "rtc_base/socketadapters.h"
 #include "rtc_base/ssladapter.h"
 #include "rtc_base/thread.h"
+#include "system_wrappers/include/field_trial.h"
 
 namespace rtc {
 
+namespace {
+
+// Datagrams drained per read event while the "WebRTC-BatchUdpReceive" field
+// trial is enabled. They are passed up to RtpTransport together.
+const size_t kUdpReceiveBatchSize = 32;
+
+}  // namespace
+
 BasicPacketSocketFactory::BasicPacketSocketFactory()
     : thread_(Thread::Current()), socket_factory_(NULL) {}
 
@@ -53,7 +62,10 @@ AsyncPacketSocket* BasicPacketSocketFactory::CreateUdpSocket(
     delete socket;
     return NULL;
   }
-  return new AsyncUDPSocket(socket);
+  AsyncUDPSocket* udp_socket = new AsyncUDPSocket(socket);
+  if (webrtc::field_trial::IsEnabled("WebRTC-BatchUdpReceive"))
+    udp_socket->SetReceiveBatchSize(kUdpReceiveBatchSize);
+  return udp_socket;
 }
 
 AsyncPacketSocket* BasicPacketSocketFactory::CreateServerTcpSocket(
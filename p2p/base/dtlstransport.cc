@@ -455,6 +455,8 @@ void DtlsTransport::ConnectToIceTransport() {
   ice_transport_->SignalWritableState.connect(this,
                                               &DtlsTransport::OnWritableState);
   ice_transport_->SignalReadPacket.connect(this, &DtlsTransport::OnReadPacket);
+  ice_transport_->SignalReadPackets.connect(this,
+                                            &DtlsTransport::OnReadPackets);
   ice_transport_->SignalSentPacket.connect(this, &DtlsTransport::OnSentPacket);
   ice_transport_->SignalReadyToSend.connect(this,
                                             &DtlsTransport::OnReadyToSend);
@@ -603,6 +605,41 @@ void DtlsTransport::OnReadPacket(rtc::PacketTransportInternal* transport,
   }
 }
 
+void DtlsTransport::OnReadPackets(rtc::PacketTransportInternal* transport,
+                                  const rtc::Datagram* packets,
+                                  size_t num_packets,
+                                  int flags) {
+  RTC_DCHECK_RUN_ON(&thread_checker_);
+  RTC_DCHECK(transport == ice_transport_.get());
+  RTC_DCHECK(flags == 0);
+
+  if (!dtls_active_) {
+    // Not doing DTLS.
+    EmitReadPackets(packets, num_packets, 0);
+    return;
+  }
+
+  // Once DTLS is connected, the runs of SRTP packets are passed on together
+  // as bypass packets. Everything else goes through OnReadPacket.
+  size_t run_begin = 0;
+  for (size_t i = 0; i <= num_packets; ++i) {
+    if (i < num_packets && dtls_state() == DTLS_TRANSPORT_CONNECTED &&
+        !IsDtlsPacket(packets[i].data, packets[i].size) &&
+        IsRtpPacket(packets[i].data, packets[i].size)) {
+      continue;
+    }
+    if (i > run_begin) {
+      RTC_DCHECK(!srtp_ciphers_.empty());
+      EmitReadPackets(packets + run_begin, i - run_begin, PF_SRTP_BYPASS);
+    }
+    if (i < num_packets) {
+      OnReadPacket(transport, packets[i].data, packets[i].size,
+                   packets[i].timestamp, flags);
+    }
+    run_begin = i + 1;
+  }
+}
+
 void DtlsTransport::OnSentPacket(rtc::PacketTransportInternal* transport,
                                  const rtc::SentPacket& sent_packet) {
   RTC_DCHECK_RUN_ON(&thread_checker_);
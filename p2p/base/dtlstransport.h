@@ -196,6 +196,10 @@ class DtlsTransport : public DtlsTransportInternal {
                     size_t size,
                     const int64_t& packet_time_us,
                     int flags);
+  void OnReadPackets(rtc::PacketTransportInternal* transport,
+                     const rtc::Datagram* packets,
+                     size_t num_packets,
+                     int flags);
   void OnSentPacket(rtc::PacketTransportInternal* transport,
                     const rtc::SentPacket& sent_packet);
   void OnReadyToSend(rtc::PacketTransportInternal* transport);
@@ -197,6 +197,8 @@ void P2PTransportChannel::AddConnection(Connection* connection) {
   connection->set_unwritable_min_checks(config_.ice_unwritable_min_checks);
   connection->SignalReadPacket.connect(
       this, &P2PTransportChannel::OnReadPacket);
+  connection->SignalReadPackets.connect(
+      this, &P2PTransportChannel::OnReadPackets);
   connection->SignalReadyToSend.connect(
       this, &P2PTransportChannel::OnReadyToSend);
   connection->SignalStateChange.connect(
@@ -2384,6 +2386,22 @@ void P2PTransportChannel::OnReadPacket(Connection* connection,
   }
 }
 
+void P2PTransportChannel::OnReadPackets(Connection* connection,
+                                        const rtc::Datagram* packets,
+                                        size_t num_packets) {
+  RTC_DCHECK(network_thread_ == rtc::Thread::Current());
+
+  // Do not deliver, if packets don't belong to the correct transport channel.
+  if (!FindConnection(connection))
+    return;
+
+  EmitReadPackets(packets, num_packets, 0);
+
+  if (ice_role_ == ICEROLE_CONTROLLED) {
+    MaybeSwitchSelectedConnection(connection, "data received");
+  }
+}
+
 void P2PTransportChannel::OnSentPacket(const rtc::SentPacket& sent_packet) {
   RTC_DCHECK(network_thread_ == rtc::Thread::Current());
 
@@ -305,6 +305,9 @@ class RTC_EXPORT P2PTransportChannel : public IceTransportInternal {
                     const char* data,
                     size_t len,
                     int64_t packet_time_us);
+  void OnReadPackets(Connection* connection,
+                     const rtc::Datagram* packets,
+                     size_t num_packets);
   void OnSentPacket(const rtc::SentPacket& sent_packet);
   void OnReadyToSend(Connection* connection);
   void OnConnectionDestroyed(Connection* connection);
@@ -28,4 +28,19 @@ absl::optional<NetworkRoute> PacketTransportInternal::network_route() const {
   return absl::optional<NetworkRoute>();
 }
 
+void PacketTransportInternal::EmitReadPackets(const rtc::Datagram* packets,
+                                              size_t num_packets,
+                                              int flags) {
+  if (num_packets == 0)
+    return;
+  if (!SignalReadPackets.is_empty()) {
+    SignalReadPackets(this, packets, num_packets, flags);
+    return;
+  }
+  for (size_t i = 0; i < num_packets; ++i) {
+    SignalReadPacket(this, packets[i].data, packets[i].size,
+                     packets[i].timestamp, flags);
+  }
+}
+
 }  // namespace rtc
@@ -92,6 +92,14 @@ class RTC_EXPORT PacketTransportInternal
                    int>
       SignalReadPacket;
 
+  // Signalled with packets that were read from the network together, e.g.
+  // with recvmmsg, each with its own receive time. The packet memory is only
+  // valid during the callback. Transports only emit it while something is
+  // connected, and then deliver those packets through it instead of
+  // SignalReadPacket, so listeners must be connected to both.
+  sigslot::signal4<PacketTransportInternal*, const rtc::Datagram*, size_t, int>
+      SignalReadPackets;
+
   // Signalled each time a packet is sent on this channel.
   sigslot::signal2<PacketTransportInternal*, const rtc::SentPacket&>
       SignalSentPacket;
@@ -104,6 +112,12 @@ class RTC_EXPORT PacketTransportInternal
   ~PacketTransportInternal() override;
 
   PacketTransportInternal* GetInternal() override;
+
+  // Emits |packets| through SignalReadPackets, or one at a time through
+  // SignalReadPacket when nothing is connected to the batch signal.
+  void EmitReadPackets(const rtc::Datagram* packets,
+                       size_t num_packets,
+                       int flags);
 };
 
 }  // namespace rtc
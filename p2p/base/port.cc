@@ -1251,18 +1251,9 @@ void Connection::OnReadPacket(const char* data,
   if (!port_->GetStunMessage(data, size, addr, &msg, &remote_ufrag)) {
     // The packet did not parse as a valid STUN message
     // This is a data packet, pass it along.
-    last_data_received_ = rtc::TimeMillis();
-    UpdateReceiving(last_data_received_);
-    recv_rate_tracker_.AddSamples(size);
+    OnDataReceived(size);
     SignalReadPacket(this, data, size, packet_time_us);
-
-    // If timed out sending writability checks, start up again
-    if (!pruned_ && (write_state_ == STATE_WRITE_TIMEOUT)) {
-      RTC_LOG(LS_WARNING)
-          << "Received a data packet on a timed-out Connection. "
-             "Resetting state to STATE_WRITE_INIT.";
-      set_write_state(STATE_WRITE_INIT);
-    }
+    MaybeResumeWriteChecks();
   } else if (!msg) {
     // The packet was STUN, but failed a check and was handled internally.
   } else {
@@ -1318,6 +1309,51 @@ void Connection::OnReadPacket(const char* data,
   }
 }
 
+void Connection::OnReadPackets(const rtc::Datagram* packets,
+                               size_t num_packets) {
+  if (SignalReadPackets.is_empty()) {
+    for (size_t i = 0; i < num_packets; ++i)
+      OnReadPacket(packets[i].data, packets[i].size, packets[i].timestamp);
+    return;
+  }
+
+  size_t run_begin = 0;
+  for (size_t i = 0; i <= num_packets; ++i) {
+    // In ICE mode, all STUN packets have a valid fingerprint, so anything
+    // else is a data packet. See Port::GetStunMessage.
+    if (i < num_packets &&
+        !StunMessage::ValidateFingerprint(packets[i].data, packets[i].size)) {
+      continue;
+    }
+    if (i > run_begin) {
+      size_t num_bytes = 0;
+      for (size_t j = run_begin; j < i; ++j)
+        num_bytes += packets[j].size;
+      OnDataReceived(num_bytes);
+      SignalReadPackets(this, packets + run_begin, i - run_begin);
+      MaybeResumeWriteChecks();
+    }
+    if (i < num_packets)
+      OnReadPacket(packets[i].data, packets[i].size, packets[i].timestamp);
+    run_begin = i + 1;
+  }
+}
+
+void Connection::OnDataReceived(size_t num_bytes) {
+  last_data_received_ = rtc::TimeMillis();
+  UpdateReceiving(last_data_received_);
+  recv_rate_tracker_.AddSamples(num_bytes);
+}
+
+void Connection::MaybeResumeWriteChecks() {
+  // If timed out sending writability checks, start up again
+  if (!pruned_ && (write_state_ == STATE_WRITE_TIMEOUT)) {
+    RTC_LOG(LS_WARNING) << "Received a data packet on a timed-out Connection. "
+                           "Resetting state to STATE_WRITE_INIT.";
+    set_write_state(STATE_WRITE_INIT);
+  }
+}
+
 void Connection::HandleBindingRequest(IceMessage* msg) {
   // This connection should now be receiving.
   ReceivedPing();
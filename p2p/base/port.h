@@ -604,10 +604,18 @@ class Connection : public CandidatePairInterface,
 
   sigslot::signal4<Connection*, const char*, size_t, int64_t> SignalReadPacket;
 
+  // Emitted with the runs of data packets of a batch given to OnReadPackets,
+  // instead of SignalReadPacket, while something is connected.
+  sigslot::signal3<Connection*, const rtc::Datagram*, size_t> SignalReadPackets;
+
   sigslot::signal1<Connection*> SignalReadyToSend;
 
   // Called when a packet is received on this connection.
   void OnReadPacket(const char* data, size_t size, int64_t packet_time_us);
+  // Called with packets read from the socket together. STUN packets are
+  // handled one at a time, and the data packets between them are passed on
+  // together.
+  void OnReadPackets(const rtc::Datagram* packets, size_t num_packets);
 
   // Called when the socket is currently able to send.
   void OnReadyToSend();
@@ -786,6 +794,11 @@ class Connection : public CandidatePairInterface,
 
   void CopyCandidatesToStatsAndSanitizeIfNecessary();
 
+  // Updates the receiving state and rate for |num_bytes| of data packets.
+  void OnDataReceived(size_t num_bytes);
+  // Restarts writability checks that timed out once data is received.
+  void MaybeResumeWriteChecks();
+
   void LogCandidatePairConfig(webrtc::IceCandidatePairConfigType type);
   void LogCandidatePairEvent(webrtc::IceCandidatePairEventType type);
 
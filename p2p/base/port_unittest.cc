@@ -1426,6 +1426,68 @@ TEST_F(PortTest, TestLoopbackCall) {
   EXPECT_EQ(STUN_BINDING_ERROR_RESPONSE, msg->type());
 }
 
+class ReadPacketsRecorder : public sigslot::has_slots<> {
+ public:
+  explicit ReadPacketsRecorder(Connection* conn) {
+    conn->SignalReadPacket.connect(this, &ReadPacketsRecorder::OnReadPacket);
+    conn->SignalReadPackets.connect(this, &ReadPacketsRecorder::OnReadPackets);
+  }
+
+  int num_single_packets() const { return num_single_packets_; }
+  const std::vector<size_t>& batch_sizes() const { return batch_sizes_; }
+
+ private:
+  void OnReadPacket(Connection* conn,
+                    const char* data,
+                    size_t size,
+                    int64_t packet_time_us) {
+    ++num_single_packets_;
+  }
+  void OnReadPackets(Connection* conn,
+                     const rtc::Datagram* packets,
+                     size_t num_packets) {
+    batch_sizes_.push_back(num_packets);
+  }
+
+  int num_single_packets_ = 0;
+  std::vector<size_t> batch_sizes_;
+};
+
+// Test that a batch of packets is passed on in runs of data packets, and that
+// the STUN packets between them are still handled.
+TEST_F(PortTest, TestConnectionReadPacketsSplitsAtStunPackets) {
+  auto lport = CreateTestPort(kLocalAddr1, "lfrag", "lpass");
+  lport->SetIceRole(cricket::ICEROLE_CONTROLLING);
+  lport->SetIceTiebreaker(kTiebreaker1);
+  lport->PrepareAddress();
+  ASSERT_FALSE(lport->Candidates().empty());
+  Connection* conn =
+      lport->CreateConnection(lport->Candidates()[0], Port::ORIGIN_MESSAGE);
+  ReadPacketsRecorder recorder(conn);
+  conn->Ping(0);
+  ASSERT_TRUE_WAIT(lport->last_stun_msg() != NULL, kDefaultTimeout);
+  EXPECT_EQ(STUN_BINDING_REQUEST, lport->last_stun_msg()->type());
+  rtc::Buffer stun_request(lport->last_stun_buf()->data(),
+                           lport->last_stun_buf()->size());
+  lport->Reset();
+
+  // A data packet, i.e. anything without a valid STUN fingerprint.
+  char data[12] = {};
+  rtc::Datagram packets[4];
+  for (rtc::Datagram& packet : packets) {
+    packet.data = data;
+    packet.size = sizeof(data);
+  }
+  packets[2].data = stun_request.data<char>();
+  packets[2].size = stun_request.size();
+  conn->OnReadPackets(packets, 4);
+
+  EXPECT_EQ(0, recorder.num_single_packets());
+  EXPECT_EQ(std::vector<size_t>({2, 1}), recorder.batch_sizes());
+  ASSERT_TRUE_WAIT(lport->last_stun_msg() != NULL, kDefaultTimeout);
+  EXPECT_EQ(STUN_BINDING_RESPONSE, lport->last_stun_msg()->type());
+}
+
 // This test verifies role conflict signal is received when there is
 // conflict in the role. In this case both ports are in controlling and
 // |rport| has higher tiebreaker value than |lport|. Since |lport| has lower
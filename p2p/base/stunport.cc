@@ -216,6 +216,7 @@ bool UDPPort::Init() {
       return false;
     }
     socket_->SignalReadPacket.connect(this, &UDPPort::OnReadPacket);
+    socket_->SignalReadPackets.connect(this, &UDPPort::OnReadPackets);
   }
   socket_->SignalSentPacket.connect(this, &UDPPort::OnSentPacket);
   socket_->SignalReadyToSend.connect(this, &UDPPort::OnReadyToSend);
@@ -325,6 +326,12 @@ bool UDPPort::HandleIncomingPacket(rtc::AsyncPacketSocket* socket,
   return true;
 }
 
+void UDPPort::HandleIncomingPackets(rtc::AsyncPacketSocket* socket,
+                                    const rtc::Datagram* packets,
+                                    size_t num_packets) {
+  OnReadPackets(socket, packets, num_packets);
+}
+
 bool UDPPort::SupportsProtocol(const std::string& protocol) const {
   return protocol == UDP_PROTOCOL_NAME;
 }
@@ -386,6 +393,32 @@ void UDPPort::OnReadPacket(rtc::AsyncPacketSocket* socket,
   }
 }
 
+void UDPPort::OnReadPackets(rtc::AsyncPacketSocket* socket,
+                            const rtc::Datagram* packets,
+                            size_t num_packets) {
+  RTC_DCHECK(socket == socket_);
+  size_t i = 0;
+  while (i < num_packets) {
+    const rtc::SocketAddress& remote_addr = packets[i].addr;
+    Connection* conn = server_addresses_.find(remote_addr) ==
+                               server_addresses_.end()
+                           ? GetConnection(remote_addr)
+                           : nullptr;
+    if (!conn) {
+      OnReadPacket(socket, packets[i].data, packets[i].size, remote_addr,
+                   packets[i].timestamp);
+      ++i;
+      continue;
+    }
+    // Pass the packets from the same remote address on together.
+    size_t run_end = i + 1;
+    while (run_end < num_packets && packets[run_end].addr == remote_addr)
+      ++run_end;
+    conn->OnReadPackets(packets + i, run_end - i);
+    i = run_end;
+  }
+}
+
 void UDPPort::OnSentPacket(rtc::AsyncPacketSocket* socket,
                            const rtc::SentPacket& sent_packet) {
   PortInterface::SignalSentPacket(sent_packet);
@@ -105,6 +105,11 @@ class UDPPort : public Port {
                             size_t size,
                             const rtc::SocketAddress& remote_addr,
                             int64_t packet_time_us) override;
+  // Batch version of HandleIncomingPacket, for a shared socket with batched
+  // reads. All packets are consumed.
+  void HandleIncomingPackets(rtc::AsyncPacketSocket* socket,
+                             const rtc::Datagram* packets,
+                             size_t num_packets);
 
   bool SupportsProtocol(const std::string& protocol) const override;
   ProtocolType GetProtocol() const override;
@@ -168,6 +173,9 @@ class UDPPort : public Port {
                     size_t size,
                     const rtc::SocketAddress& remote_addr,
                     const int64_t& packet_time_us);
+  void OnReadPackets(rtc::AsyncPacketSocket* socket,
+                     const rtc::Datagram* packets,
+                     size_t num_packets);
 
   void OnSentPacket(rtc::AsyncPacketSocket* socket,
                     const rtc::SentPacket& sent_packet) override;
@@ -1212,6 +1212,8 @@ void AllocationSequence::Init() {
     if (udp_socket_) {
       udp_socket_->SignalReadPacket.connect(this,
                                             &AllocationSequence::OnReadPacket);
+      udp_socket_->SignalReadPackets.connect(
+          this, &AllocationSequence::OnReadPackets);
     }
     // Continuing if |udp_socket_| is NULL, as local TCP and RelayPort using TCP
     // are next available options to setup a communication channel.
@@ -1609,6 +1611,38 @@ void AllocationSequence::OnReadPacket(rtc::AsyncPacketSocket* socket,
   }
 }
 
+void AllocationSequence::OnReadPackets(rtc::AsyncPacketSocket* socket,
+                                       const rtc::Datagram* packets,
+                                       size_t num_packets) {
+  RTC_DCHECK(socket == udp_socket_.get());
+
+  auto from_relay_server = [this](const rtc::SocketAddress& remote_addr) {
+    return std::any_of(relay_ports_.begin(), relay_ports_.end(),
+                       [&remote_addr](Port* port) {
+                         return port->CanHandleIncomingPacketsFrom(remote_addr);
+                       });
+  };
+
+  // Packets that may be for a TurnPort are handled one at a time like in
+  // OnReadPacket. The runs of packets between them all go to the UdpPort, so
+  // it gets them together.
+  size_t run_begin = 0;
+  for (size_t i = 0; i <= num_packets; ++i) {
+    if (i < num_packets && udp_port_ && !from_relay_server(packets[i].addr))
+      continue;
+    if (i > run_begin && udp_port_) {
+      RTC_DCHECK(udp_port_->SharedSocket());
+      udp_port_->HandleIncomingPackets(socket, packets + run_begin,
+                                       i - run_begin);
+    }
+    if (i < num_packets) {
+      OnReadPacket(socket, packets[i].data, packets[i].size, packets[i].addr,
+                   packets[i].timestamp);
+    }
+    run_begin = i + 1;
+  }
+}
+
 void AllocationSequence::OnPortDestroyed(PortInterface* port) {
   if (udp_port_ == port) {
     udp_port_ = NULL;
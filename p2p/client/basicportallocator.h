@@ -385,6 +385,9 @@ class AllocationSequence : public rtc::MessageHandler,
                     size_t size,
                     const rtc::SocketAddress& remote_addr,
                     const int64_t& packet_time_us);
+  void OnReadPackets(rtc::AsyncPacketSocket* socket,
+                     const rtc::Datagram* packets,
+                     size_t num_packets);
 
   void OnPortDestroyed(PortInterface* port);
 
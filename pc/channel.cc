@@ -49,7 +49,7 @@ struct SendPacketMessageData : public rtc::MessageData {
 }  // namespace
 
 enum {
-  MSG_SEND_RTP_PACKET = 1,
+  MSG_SEND_RTP_PACKETS = 1,
   MSG_SEND_RTCP_PACKET,
   MSG_READYTOSENDDATA,
   MSG_DATARECEIVED,
@@ -203,6 +203,8 @@ void BaseChannel::Deinit() {
     // Clear pending read packets/messages.
     network_thread_->Clear(&invoker_);
     network_thread_->Clear(this);
+    rtc::CritScope cs(&pending_rtp_packets_crit_);
+    pending_rtp_packets_.clear();
   });
 }
 
@@ -405,17 +407,49 @@ bool BaseChannel::SendPacket(bool rtcp,
   // The only downside is that we can't return a proper failure code if
   // needed. Since UDP is unreliable anyway, this should be a non-issue.
   if (!network_thread_->IsCurrent()) {
+    if (!rtcp) {
+      // Queue RTP packets, so that the packets the pacer sends back to back
+      // reach the transport together. Avoid a copy by transferring the
+      // ownership of the packet data.
+      bool first_pending_packet;
+      {
+        rtc::CritScope cs(&pending_rtp_packets_crit_);
+        first_pending_packet = pending_rtp_packets_.empty();
+        pending_rtp_packets_.push_back({std::move(*packet), options});
+      }
+      if (first_pending_packet)
+        network_thread_->Post(RTC_FROM_HERE, this, MSG_SEND_RTP_PACKETS);
+      return true;
+    }
     // Avoid a copy by transferring the ownership of the packet data.
-    int message_id = rtcp ? MSG_SEND_RTCP_PACKET : MSG_SEND_RTP_PACKET;
     SendPacketMessageData* data = new SendPacketMessageData;
     data->packet = std::move(*packet);
     data->options = options;
-    network_thread_->Post(RTC_FROM_HERE, this, message_id, data);
+    network_thread_->Post(RTC_FROM_HERE, this, MSG_SEND_RTCP_PACKET, data);
     return true;
   }
 
   TRACE_EVENT0("webrtc", "BaseChannel::SendPacket");
 
+  // RTP packets queued before this RTCP packet must not reach the transport
+  // after it, e.g. a sender report must not precede the packets it counts.
+  if (rtcp) {
+    SendPendingRtpPackets_n();
+  }
+
+  if (!CanSendPacket_n(rtcp, *packet)) {
+    return false;
+  }
+
+  // Bon voyage.
+  return rtcp ? rtp_transport_->SendRtcpPacket(packet, options, PF_SRTP_BYPASS)
+              : rtp_transport_->SendRtpPacket(packet, options, PF_SRTP_BYPASS);
+}
+
+bool BaseChannel::CanSendPacket_n(bool rtcp,
+                                  const rtc::CopyOnWriteBuffer& packet) {
+  RTC_DCHECK(network_thread_->IsCurrent());
+
   // Now that we are on the correct thread, ensure we have a place to send this
   // packet before doing anything. (We might get RTCP packets that we don't
   // intend to send.) If we've negotiated RTCP mux, send RTCP over the RTP
@@ -425,10 +459,10 @@ bool BaseChannel::SendPacket(bool rtcp,
   }
 
   // Protect ourselves against crazy data.
-  if (!ValidPacket(rtcp, packet)) {
+  if (!ValidPacket(rtcp, &packet)) {
     RTC_LOG(LS_ERROR) << "Dropping outgoing " << content_name_ << " "
                       << RtpRtcpStringLiteral(rtcp)
-                      << " packet: wrong size=" << packet->size();
+                      << " packet: wrong size=" << packet.size();
     return false;
   }
 
@@ -453,10 +487,32 @@ bool BaseChannel::SendPacket(bool rtcp,
     RTC_LOG(LS_WARNING) << "Sending an " << packet_type
                         << " packet without encryption.";
   }
+  return true;
+}
 
-  // Bon voyage.
-  return rtcp ? rtp_transport_->SendRtcpPacket(packet, options, PF_SRTP_BYPASS)
-              : rtp_transport_->SendRtpPacket(packet, options, PF_SRTP_BYPASS);
+void BaseChannel::SendPendingRtpPackets_n() {
+  RTC_DCHECK(network_thread_->IsCurrent());
+  TRACE_EVENT0("webrtc", "BaseChannel::SendPendingRtpPackets_n");
+  {
+    rtc::CritScope cs(&pending_rtp_packets_crit_);
+    sending_rtp_packets_.swap(pending_rtp_packets_);
+  }
+
+  for (PendingRtpPacket& pending : sending_rtp_packets_) {
+    if (!CanSendPacket_n(/*rtcp=*/false, pending.packet)) {
+      continue;
+    }
+    sending_rtp_packet_ptrs_.push_back(&pending.packet);
+    sending_rtp_packet_options_.push_back(pending.options);
+  }
+  if (!sending_rtp_packet_ptrs_.empty()) {
+    rtp_transport_->SendRtpPackets(sending_rtp_packet_ptrs_,
+                                   sending_rtp_packet_options_, PF_SRTP_BYPASS);
+  }
+
+  sending_rtp_packets_.clear();
+  sending_rtp_packet_ptrs_.clear();
+  sending_rtp_packet_options_.clear();
 }
 
 void BaseChannel::OnRtpPacket(const webrtc::RtpPacketReceived& parsed_packet) {
@@ -713,13 +769,15 @@ RtpHeaderExtensions BaseChannel::GetFilteredRtpHeaderExtensions(
 void BaseChannel::OnMessage(rtc::Message* pmsg) {
   TRACE_EVENT0("webrtc", "BaseChannel::OnMessage");
   switch (pmsg->message_id) {
-    case MSG_SEND_RTP_PACKET:
+    case MSG_SEND_RTP_PACKETS: {
+      SendPendingRtpPackets_n();
+      break;
+    }
     case MSG_SEND_RTCP_PACKET: {
       RTC_DCHECK(network_thread_->IsCurrent());
       SendPacketMessageData* data =
           static_cast<SendPacketMessageData*>(pmsg->pdata);
-      bool rtcp = pmsg->message_id == MSG_SEND_RTCP_PACKET;
-      SendPacket(rtcp, &data->packet, data->options);
+      SendPacket(/*rtcp=*/true, &data->packet, data->options);
       delete data;
       break;
     }
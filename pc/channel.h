@@ -40,6 +40,7 @@
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/network.h"
 #include "rtc_base/third_party/sigslot/sigslot.h"
+#include "rtc_base/thread_annotations.h"
 
 namespace webrtc {
 class AudioSinkInterface;
@@ -232,6 +233,10 @@ class BaseChannel : public ChannelInterface,
   bool SendPacket(bool rtcp,
                   rtc::CopyOnWriteBuffer* packet,
                   const rtc::PacketOptions& options);
+  // Checks that |packet| can be sent, on the network thread.
+  bool CanSendPacket_n(bool rtcp, const rtc::CopyOnWriteBuffer& packet);
+  // Sends the RTP packets queued by SendPacket from other threads together.
+  void SendPendingRtpPackets_n();
 
   void OnRtcpPacketReceived(rtc::CopyOnWriteBuffer* packet,
                             int64_t packet_time_us);
@@ -311,6 +316,22 @@ class BaseChannel : public ChannelInterface,
   rtc::Thread* const network_thread_;
   rtc::Thread* const signaling_thread_;
   rtc::AsyncInvoker invoker_;
+
+  struct PendingRtpPacket {
+    rtc::CopyOnWriteBuffer packet;
+    rtc::PacketOptions options;
+  };
+  // RTP packets sent from other threads, e.g. a burst released by the pacer,
+  // wait here until the network thread sends them with one SendRtpPackets
+  // call. A message to do that is posted when the first packet is queued.
+  // An RTCP packet sent on the network thread sends them first.
+  rtc::CriticalSection pending_rtp_packets_crit_;
+  std::vector<PendingRtpPacket> pending_rtp_packets_
+      RTC_GUARDED_BY(pending_rtp_packets_crit_);
+  // Used by SendPendingRtpPackets_n, kept to reuse the storage.
+  std::vector<PendingRtpPacket> sending_rtp_packets_;
+  std::vector<rtc::CopyOnWriteBuffer*> sending_rtp_packet_ptrs_;
+  std::vector<rtc::PacketOptions> sending_rtp_packet_options_;
   sigslot::signal1<ChannelInterface*> SignalFirstPacketReceived_;
 
   const std::string content_name_;
@@ -10,17 +10,21 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "api/array_view.h"
 #include "media/base/fakemediaengine.h"
 #include "media/base/fakertp.h"
 #include "media/base/mediachannel.h"
+#include "media/base/rtputils.h"
 #include "p2p/base/fakecandidatepair.h"
 #include "p2p/base/fakedtlstransport.h"
 #include "p2p/base/fakepackettransport.h"
 #include "pc/channel.h"
+#include "rtc_base/asyncinvoker.h"
 #include "rtc_base/buffer.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/event.h"
 #include "rtc_base/fakeclock.h"
 #include "rtc_base/gunit.h"
 #include "rtc_base/logging.h"
@@ -535,6 +539,13 @@ class ChannelTest : public testing::Test, public sigslot::has_slots<> {
   void OnRtcpMuxFullyActive2(const std::string&) {
     rtcp_mux_activated_callbacks2_++;
   }
+  void OnReadPacket2(rtc::PacketTransportInternal*,
+                     const char* data,
+                     size_t len,
+                     const int64_t&,
+                     int) {
+    received_rtcp2_.push_back(cricket::IsRtcpPacket(data, len));
+  }
 
   cricket::CandidatePairInterface* last_selected_candidate_pair() {
     return last_selected_candidate_pair_;
@@ -984,6 +995,31 @@ class ChannelTest : public testing::Test, public sigslot::has_slots<> {
     EXPECT_TRUE(CheckNoRtp2());
   }
 
+  // Check that an RTCP packet sent on the network thread doesn't overtake an
+  // RTP packet that another thread queued before it.
+  void SendRtcpAfterQueuedRtp() {
+    CreateChannels(RTCP_MUX, RTCP_MUX);
+    EXPECT_TRUE(SendInitiate());
+    EXPECT_TRUE(SendAccept());
+    WaitForThreads();
+    network_thread_->Invoke<void>(RTC_FROM_HERE, [this] {
+      fake_rtp_dtls_transport2_->SignalReadPacket.connect(
+          this, &ChannelTest<T>::OnReadPacket2);
+    });
+    // Hold the network thread until the RTP packet is queued, then send the
+    // RTCP packet from it.
+    rtc::Event rtp_queued(false, false);
+    rtc::AsyncInvoker invoker;
+    invoker.AsyncInvoke<void>(RTC_FROM_HERE, network_thread_, [&] {
+      rtp_queued.Wait(rtc::Event::kForever);
+      SendRtcp1();
+    });
+    SendRtp1();
+    rtp_queued.Set();
+    WaitForThreads();
+    EXPECT_EQ(std::vector<bool>({false, true}), received_rtcp2_);
+  }
+
   void TestDeinit() {
     CreateChannels(0, 0);
     EXPECT_TRUE(SendInitiate());
@@ -1494,6 +1530,8 @@ class ChannelTest : public testing::Test, public sigslot::has_slots<> {
   rtc::Buffer rtcp_packet_;
   int rtcp_mux_activated_callbacks1_ = 0;
   int rtcp_mux_activated_callbacks2_ = 0;
+  // Whether each packet received by |fake_rtp_dtls_transport2_| was RTCP.
+  std::vector<bool> received_rtcp2_;
   cricket::CandidatePairInterface* last_selected_candidate_pair_;
 };
 
@@ -1864,6 +1902,10 @@ TEST_F(VoiceChannelDoubleThreadTest, SendRtcpToRtcp) {
   Base::SendRtcpToRtcp();
 }
 
+TEST_F(VoiceChannelDoubleThreadTest, SendRtcpAfterQueuedRtp) {
+  Base::SendRtcpAfterQueuedRtp();
+}
+
 TEST_F(VoiceChannelDoubleThreadTest, SendDtlsSrtpToDtlsSrtp) {
   Base::SendDtlsSrtpToDtlsSrtp(0, 0);
 }
@@ -2166,6 +2208,10 @@ TEST_F(VideoChannelDoubleThreadTest, SendRtcpToRtcp) {
   Base::SendRtcpToRtcp();
 }
 
+TEST_F(VideoChannelDoubleThreadTest, SendRtcpAfterQueuedRtp) {
+  Base::SendRtcpAfterQueuedRtp();
+}
+
 TEST_F(VideoChannelDoubleThreadTest, SendDtlsSrtpToDtlsSrtp) {
   Base::SendDtlsSrtpToDtlsSrtp(0, 0);
 }
@@ -157,6 +157,7 @@ VoiceChannel* ChannelManager::CreateVoiceChannel(
     const cricket::MediaConfig& media_config,
     webrtc::RtpTransportInternal* rtp_transport,
     webrtc::MediaTransportInterface* media_transport,
+    rtc::Thread* network_thread,
     rtc::Thread* signaling_thread,
     const std::string& content_name,
     bool srtp_required,
@@ -165,8 +166,9 @@ VoiceChannel* ChannelManager::CreateVoiceChannel(
   if (!worker_thread_->IsCurrent()) {
     return worker_thread_->Invoke<VoiceChannel*>(RTC_FROM_HERE, [&] {
       return CreateVoiceChannel(call, media_config, rtp_transport,
-                                media_transport, signaling_thread, content_name,
-                                srtp_required, crypto_options, options);
+                                media_transport, network_thread,
+                                signaling_thread, content_name, srtp_required,
+                                crypto_options, options);
     });
   }
 
@@ -184,7 +186,7 @@ VoiceChannel* ChannelManager::CreateVoiceChannel(
   }
 
   auto voice_channel = absl::make_unique<VoiceChannel>(
-      worker_thread_, network_thread_, signaling_thread, media_engine_.get(),
+      worker_thread_, network_thread, signaling_thread, media_engine_.get(),
       absl::WrapUnique(media_channel), content_name, srtp_required,
       crypto_options);
 
@@ -224,6 +226,7 @@ VideoChannel* ChannelManager::CreateVideoChannel(
     webrtc::Call* call,
     const cricket::MediaConfig& media_config,
     webrtc::RtpTransportInternal* rtp_transport,
+    rtc::Thread* network_thread,
     rtc::Thread* signaling_thread,
     const std::string& content_name,
     bool srtp_required,
@@ -232,8 +235,8 @@ VideoChannel* ChannelManager::CreateVideoChannel(
   if (!worker_thread_->IsCurrent()) {
     return worker_thread_->Invoke<VideoChannel*>(RTC_FROM_HERE, [&] {
       return CreateVideoChannel(call, media_config, rtp_transport,
-                                signaling_thread, content_name, srtp_required,
-                                crypto_options, options);
+                                network_thread, signaling_thread, content_name,
+                                srtp_required, crypto_options, options);
     });
   }
 
@@ -251,7 +254,7 @@ VideoChannel* ChannelManager::CreateVideoChannel(
   }
 
   auto video_channel = absl::make_unique<VideoChannel>(
-      worker_thread_, network_thread_, signaling_thread,
+      worker_thread_, network_thread, signaling_thread,
       absl::WrapUnique(media_channel), content_name, srtp_required,
       crypto_options);
 
@@ -291,14 +294,16 @@ void ChannelManager::DestroyVideoChannel(VideoChannel* video_channel) {
 RtpDataChannel* ChannelManager::CreateRtpDataChannel(
     const cricket::MediaConfig& media_config,
     webrtc::RtpTransportInternal* rtp_transport,
+    rtc::Thread* network_thread,
     rtc::Thread* signaling_thread,
     const std::string& content_name,
     bool srtp_required,
     const webrtc::CryptoOptions& crypto_options) {
   if (!worker_thread_->IsCurrent()) {
     return worker_thread_->Invoke<RtpDataChannel*>(RTC_FROM_HERE, [&] {
-      return CreateRtpDataChannel(media_config, rtp_transport, signaling_thread,
-                                  content_name, srtp_required, crypto_options);
+      return CreateRtpDataChannel(media_config, rtp_transport, network_thread,
+                                  signaling_thread, content_name, srtp_required,
+                                  crypto_options);
     });
   }
 
@@ -311,7 +316,7 @@ RtpDataChannel* ChannelManager::CreateRtpDataChannel(
   }
 
   auto data_channel = absl::make_unique<RtpDataChannel>(
-      worker_thread_, network_thread_, signaling_thread,
+      worker_thread_, network_thread, signaling_thread,
       absl::WrapUnique(media_channel), content_name, srtp_required,
       crypto_options);
   data_channel->Init_w(rtp_transport);
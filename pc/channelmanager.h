@@ -77,7 +77,10 @@ class ChannelManager final {
 
   // The operations below all occur on the worker thread.
   // ChannelManager retains ownership of the created channels, so clients should
-  // call the appropriate Destroy*Channel method when done.
+  // call the appropriate Destroy*Channel method when done. Channels run their
+  // transport work on |network_thread|, which must be the thread
+  // |rtp_transport| lives on and may differ from network_thread() when the
+  // PeerConnectionFactory shards PeerConnections over several network threads.
 
   // Creates a voice channel, to be associated with the specified session.
   VoiceChannel* CreateVoiceChannel(
@@ -85,6 +88,7 @@ class ChannelManager final {
       const cricket::MediaConfig& media_config,
       webrtc::RtpTransportInternal* rtp_transport,
       webrtc::MediaTransportInterface* media_transport,
+      rtc::Thread* network_thread,
       rtc::Thread* signaling_thread,
       const std::string& content_name,
       bool srtp_required,
@@ -99,6 +103,7 @@ class ChannelManager final {
   VideoChannel* CreateVideoChannel(webrtc::Call* call,
                                    const cricket::MediaConfig& media_config,
                                    webrtc::RtpTransportInternal* rtp_transport,
+                                   rtc::Thread* network_thread,
                                    rtc::Thread* signaling_thread,
                                    const std::string& content_name,
                                    bool srtp_required,
@@ -110,6 +115,7 @@ class ChannelManager final {
   RtpDataChannel* CreateRtpDataChannel(
       const cricket::MediaConfig& media_config,
       webrtc::RtpTransportInternal* rtp_transport,
+      rtc::Thread* network_thread,
       rtc::Thread* signaling_thread,
       const std::string& content_name,
       bool srtp_required,
@@ -835,9 +835,11 @@ void ExtractSharedMediaSessionOptions(
 }
 
 PeerConnection::PeerConnection(PeerConnectionFactory* factory,
+                               rtc::Thread* network_thread,
                                std::unique_ptr<RtcEventLog> event_log,
                                std::unique_ptr<Call> call)
     : factory_(factory),
+      network_thread_(network_thread),
       event_log_(std::move(event_log)),
       rtcp_cname_(GenerateRtcpCname()),
       local_streams_(StreamCollection::Create()),
@@ -882,6 +884,7 @@ PeerConnection::~PeerConnection() {
     // The event log must outlive call (and any other object that uses it).
     event_log_.reset();
   });
+  factory_->ReleaseNetworkThread(network_thread_);
 }
 
 void PeerConnection::DestroyAllChannels() {
@@ -1023,7 +1026,8 @@ bool PeerConnection::Initialize(
   transport_controller_->SignalDtlsHandshakeError.connect(
       this, &PeerConnection::OnTransportControllerDtlsHandshakeError);
 
-  sctp_factory_ = factory_->CreateSctpTransportInternalFactory();
+  sctp_factory_ =
+      factory_->CreateSctpTransportInternalFactory(network_thread());
 
   stats_.reset(new StatsCollector(this));
   stats_collector_ = RTCStatsCollector::Create(this);
@@ -5902,8 +5906,8 @@ cricket::VoiceChannel* PeerConnection::CreateVoiceChannel(
 
   cricket::VoiceChannel* voice_channel = channel_manager()->CreateVoiceChannel(
       call_.get(), configuration_.media_config, rtp_transport, media_transport,
-      signaling_thread(), mid, SrtpRequired(), GetCryptoOptions(),
-      audio_options_);
+      network_thread(), signaling_thread(), mid, SrtpRequired(),
+      GetCryptoOptions(), audio_options_);
   if (!voice_channel) {
     return nullptr;
   }
@@ -5924,8 +5928,8 @@ cricket::VideoChannel* PeerConnection::CreateVideoChannel(
   // TODO(sukhanov): Propagate media_transport to video channel.
   cricket::VideoChannel* video_channel = channel_manager()->CreateVideoChannel(
       call_.get(), configuration_.media_config, rtp_transport,
-      signaling_thread(), mid, SrtpRequired(), GetCryptoOptions(),
-      video_options_);
+      network_thread(), signaling_thread(), mid, SrtpRequired(),
+      GetCryptoOptions(), video_options_);
   if (!video_channel) {
     return nullptr;
   }
@@ -5971,8 +5975,8 @@ bool PeerConnection::CreateDataChannel(const std::string& mid) {
     default:
       RtpTransportInternal* rtp_transport = GetRtpTransport(mid);
       rtp_data_channel_ = channel_manager()->CreateRtpDataChannel(
-          configuration_.media_config, rtp_transport, signaling_thread(), mid,
-          SrtpRequired(), GetCryptoOptions());
+          configuration_.media_config, rtp_transport, network_thread(),
+          signaling_thread(), mid, SrtpRequired(), GetCryptoOptions());
       if (!rtp_data_channel_) {
         return false;
       }
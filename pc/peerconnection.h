@@ -73,9 +73,12 @@ class PeerConnection : public PeerConnectionInternal,
     MAX_VALUE = 0x1000,
   };
 
-  explicit PeerConnection(PeerConnectionFactory* factory,
-                          std::unique_ptr<RtcEventLog> event_log,
-                          std::unique_ptr<Call> call);
+  // |network_thread| is the one of the factory's network threads this
+  // PeerConnection runs its transports on.
+  PeerConnection(PeerConnectionFactory* factory,
+                 rtc::Thread* network_thread,
+                 std::unique_ptr<RtcEventLog> event_log,
+                 std::unique_ptr<Call> call);
 
   bool Initialize(
       const PeerConnectionInterface::RTCConfiguration& configuration,
@@ -203,9 +206,7 @@ class PeerConnection : public PeerConnectionInternal,
   void Close() override;
 
   // PeerConnectionInternal implementation.
-  rtc::Thread* network_thread() const override {
-    return factory_->network_thread();
-  }
+  rtc::Thread* network_thread() const override { return network_thread_; }
   rtc::Thread* worker_thread() const override {
     return factory_->worker_thread();
   }
@@ -995,6 +996,7 @@ class PeerConnection : public PeerConnectionInternal,
   // PeerConnectionFactoryInterface all instances created using the raw pointer
   // will refer to the same reference count.
   rtc::scoped_refptr<PeerConnectionFactory> factory_;
+  rtc::Thread* const network_thread_;
   PeerConnectionObserver* observer_ = nullptr;
 
   // The EventLog needs to outlive |call_| (and any other object that uses it).
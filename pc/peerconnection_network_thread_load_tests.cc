@@ -0,0 +1,192 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <atomic>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "api/audio_codecs/builtin_audio_decoder_factory.h"
+#include "api/audio_codecs/builtin_audio_encoder_factory.h"
+#include "api/create_peerconnection_factory.h"
+#include "api/peerconnectionproxy.h"
+#include "api/video_codecs/builtin_video_decoder_factory.h"
+#include "api/video_codecs/builtin_video_encoder_factory.h"
+#include "call/rtp_demuxer.h"
+#include "call/rtp_packet_sink_interface.h"
+#include "p2p/base/dtlstransportinternal.h"
+#include "p2p/base/fakepackettransport.h"
+#include "pc/peerconnection.h"
+#include "pc/srtptransport.h"
+#include "pc/test/fakeaudiocapturemodule.h"
+#include "pc/test/fakertccertificategenerator.h"
+#include "pc/test/mockpeerconnectionobservers.h"
+#include "rtc_base/asyncinvoker.h"
+#include "rtc_base/byteorder.h"
+#include "rtc_base/event.h"
+#include "rtc_base/sslstreamadapter.h"
+#include "rtc_base/stringencode.h"
+#include "rtc_base/timeutils.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+
+namespace {
+constexpr int kNumPeerConnections = 8;
+constexpr int kPacketsPerPeerConnection = 20000;
+constexpr size_t kPacketSize = 1200;
+// Room for the SRTP auth tag.
+constexpr size_t kPacketCapacity = kPacketSize + 16;
+constexpr uint8_t kPayloadType = 96;
+constexpr int kTimeoutMs = 120000;
+const uint8_t kTestKey1[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ1234";
+const uint8_t kTestKey2[] = "4321ZYXWVUTSRQPONMLKJIHGFEDCBA";
+constexpr int kTestKeyLen = 30;
+
+class CountingRtpSink : public RtpPacketSinkInterface {
+ public:
+  void OnRtpPacket(const RtpPacketReceived& packet) override { ++num_packets_; }
+
+  int num_packets() const { return num_packets_; }
+
+ private:
+  int num_packets_ = 0;
+};
+
+// Does the per packet work a PeerConnection does on its network thread for
+// an incoming and an outgoing media stream: SRTP protect on the sending side,
+// and SRTP unprotect and RTP demuxing on the receiving side, using two
+// SrtpTransports connected back to back. Runs on the calling thread and
+// returns the number of packets delivered.
+int SendPacketsOverSrtpLoopback(int num_packets) {
+  rtc::FakePacketTransport send_packet_transport("send");
+  rtc::FakePacketTransport receive_packet_transport("receive");
+  send_packet_transport.SetDestination(&receive_packet_transport,
+                                       /*asymmetric=*/false);
+  SrtpTransport sender(/*rtcp_mux_enabled=*/true);
+  SrtpTransport receiver(/*rtcp_mux_enabled=*/true);
+  sender.SetRtpPacketTransport(&send_packet_transport);
+  receiver.SetRtpPacketTransport(&receive_packet_transport);
+
+  const std::vector<int> extension_ids;
+  RTC_CHECK(sender.SetRtpParams(rtc::SRTP_AES128_CM_SHA1_80, kTestKey1,
+                                kTestKeyLen, extension_ids,
+                                rtc::SRTP_AES128_CM_SHA1_80, kTestKey2,
+                                kTestKeyLen, extension_ids));
+  RTC_CHECK(receiver.SetRtpParams(rtc::SRTP_AES128_CM_SHA1_80, kTestKey2,
+                                  kTestKeyLen, extension_ids,
+                                  rtc::SRTP_AES128_CM_SHA1_80, kTestKey1,
+                                  kTestKeyLen, extension_ids));
+  CountingRtpSink sink;
+  RtpDemuxerCriteria demuxer_criteria;
+  demuxer_criteria.payload_types = {kPayloadType};
+  receiver.RegisterRtpDemuxerSink(demuxer_criteria, &sink);
+
+  const rtc::PacketOptions options;
+  for (int i = 0; i < num_packets; ++i) {
+    rtc::CopyOnWriteBuffer packet(kPacketSize, kPacketCapacity);
+    uint8_t* data = packet.data();
+    memset(data, 0, kPacketSize);
+    data[0] = 0x80;
+    data[1] = kPayloadType;
+    rtc::SetBE16(data + 2, static_cast<uint16_t>(i));
+    rtc::SetBE32(data + 4, i * 90);
+    rtc::SetBE32(data + 8, 0x12345678);
+    sender.SendRtpPacket(&packet, options, cricket::PF_SRTP_BYPASS);
+  }
+
+  receiver.UnregisterRtpDemuxerSink(&sink);
+  return sink.num_packets();
+}
+
+rtc::Thread* GetNetworkThread(PeerConnectionInterface* pc) {
+  auto* pc_proxy =
+      static_cast<PeerConnectionProxyWithInternal<PeerConnectionInterface>*>(
+          pc);
+  return static_cast<PeerConnection*>(pc_proxy->internal())->network_thread();
+}
+}  // namespace
+
+// Load test for spreading PeerConnections over several network threads with
+// PeerConnectionFactoryInterface::Options::num_network_threads. Creates
+// |kNumPeerConnections| PeerConnections and posts a fixed SRTP loopback
+// workload to the network thread of each, reporting the total packet rate.
+// The PeerConnections are not connected to each other; the workload only
+// stands in for the SRTP and demuxing part of their network thread work, so
+// the result shows how that part scales with the number of network threads,
+// not how a real call does. ICE, DTLS and everything on the worker thread,
+// which all PeerConnections of a factory still share, are not exercised.
+class PeerConnectionNetworkThreadSrtpLoadTest
+    : public ::testing::TestWithParam<int> {};
+
+TEST_P(PeerConnectionNetworkThreadSrtpLoadTest,
+       SrtpLoopbackPacketsPerSecond) {
+  const int num_network_threads = GetParam();
+  rtc::scoped_refptr<PeerConnectionFactoryInterface> pc_factory =
+      CreatePeerConnectionFactory(
+          nullptr /* network_thread */, nullptr /* worker_thread */,
+          rtc::Thread::Current(),
+          rtc::scoped_refptr<AudioDeviceModule>(
+              FakeAudioCaptureModule::Create()),
+          CreateBuiltinAudioEncoderFactory(),
+          CreateBuiltinAudioDecoderFactory(),
+          CreateBuiltinVideoEncoderFactory(),
+          CreateBuiltinVideoDecoderFactory(), nullptr /* audio_mixer */,
+          nullptr /* audio_processing */);
+  ASSERT_TRUE(pc_factory);
+  PeerConnectionFactoryInterface::Options options;
+  options.num_network_threads = num_network_threads;
+  pc_factory->SetOptions(options);
+
+  MockPeerConnectionObserver observer;
+  std::vector<rtc::scoped_refptr<PeerConnectionInterface>> pcs;
+  std::set<rtc::Thread*> network_threads;
+  for (int i = 0; i < kNumPeerConnections; ++i) {
+    pcs.push_back(pc_factory->CreatePeerConnection(
+        PeerConnectionInterface::RTCConfiguration(), nullptr,
+        absl::make_unique<FakeRTCCertificateGenerator>(), &observer));
+    ASSERT_TRUE(pcs.back());
+    network_threads.insert(GetNetworkThread(pcs.back()));
+  }
+  EXPECT_EQ(static_cast<size_t>(num_network_threads), network_threads.size());
+
+  std::atomic<int> num_received(0);
+  std::atomic<int> num_running(kNumPeerConnections);
+  rtc::Event done(false, false);
+  rtc::AsyncInvoker invoker;
+  const int64_t start_us = rtc::TimeMicros();
+  for (const auto& pc : pcs) {
+    invoker.AsyncInvoke<void>(RTC_FROM_HERE, GetNetworkThread(pc), [&] {
+      num_received += SendPacketsOverSrtpLoopback(kPacketsPerPeerConnection);
+      if (--num_running == 0)
+        done.Set();
+    });
+  }
+  ASSERT_TRUE(done.Wait(kTimeoutMs));
+  const int64_t elapsed_us = rtc::TimeMicros() - start_us;
+
+  EXPECT_EQ(kNumPeerConnections * kPacketsPerPeerConnection,
+            num_received.load());
+  ASSERT_GT(elapsed_us, 0);
+  test::PrintResult("pc_network_thread_srtp_loopback", "",
+                    "network_threads_" + rtc::ToString(num_network_threads),
+                    num_received.load() * 1e6 / elapsed_us, "packets/s",
+                    false);
+}
+
+INSTANTIATE_TEST_CASE_P(NumNetworkThreads,
+                        PeerConnectionNetworkThreadSrtpLoadTest,
+                        ::testing::Values(1, 2, 4, 8));
+
+}  // namespace webrtc
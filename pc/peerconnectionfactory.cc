@@ -47,6 +47,7 @@
 #include "pc/videocapturertracksource.h"
 #include "pc/videotrack.h"
 #include "rtc_base/experiments/congestion_controller_experiment.h"
+#include "rtc_base/stringencode.h"
 #include "system_wrappers/include/field_trial.h"
 
 namespace webrtc {
@@ -197,10 +198,11 @@ PeerConnectionFactory::~PeerConnectionFactory() {
   RTC_DCHECK(signaling_thread_->IsCurrent());
   channel_manager_.reset(nullptr);
 
-  // Make sure |worker_thread_| and |signaling_thread_| outlive
-  // |default_socket_factory_| and |default_network_manager_|.
-  default_socket_factory_ = nullptr;
-  default_network_manager_ = nullptr;
+  // All PeerConnections hold a reference to the factory, so no network
+  // thread is in use by now.
+  // Make sure |worker_thread_| and |signaling_thread_| outlive the default
+  // socket factories and network managers.
+  network_shards_.clear();
 
   if (wraps_current_thread_)
     rtc::ThreadManager::Instance()->UnwrapCurrentThread();
@@ -210,16 +212,12 @@ bool PeerConnectionFactory::Initialize() {
   RTC_DCHECK(signaling_thread_->IsCurrent());
   rtc::InitRandom(rtc::Time32());
 
-  default_network_manager_.reset(new rtc::BasicNetworkManager());
-  if (!default_network_manager_) {
-    return false;
-  }
-
-  default_socket_factory_.reset(
+  auto network_shard = absl::make_unique<NetworkShard>();
+  network_shard->thread = network_thread_;
+  network_shard->network_manager.reset(new rtc::BasicNetworkManager());
+  network_shard->socket_factory.reset(
       new rtc::BasicPacketSocketFactory(network_thread_));
-  if (!default_socket_factory_) {
-    return false;
-  }
+  network_shards_.push_back(std::move(network_shard));
 
   channel_manager_ = absl::make_unique<cricket::ChannelManager>(
       std::move(media_engine_), absl::make_unique<cricket::RtpDataEngine>(),
@@ -353,18 +351,23 @@ PeerConnectionFactory::CreatePeerConnection(
     PeerConnectionDependencies dependencies) {
   RTC_DCHECK(signaling_thread_->IsCurrent());
 
+  // An injected allocator has been created for the factory's network thread.
+  NetworkShard* network_shard =
+      AcquireNetworkShard(/*default_thread=*/!!dependencies.allocator);
+  rtc::Thread* network_thread = network_shard->thread;
+
   // Set internal defaults if optional dependencies are not set.
   if (!dependencies.cert_generator) {
     dependencies.cert_generator =
         absl::make_unique<rtc::RTCCertificateGenerator>(signaling_thread_,
-                                                        network_thread_);
+                                                        network_thread);
   }
   if (!dependencies.allocator) {
-    network_thread_->Invoke<void>(RTC_FROM_HERE, [this, &configuration,
-                                                  &dependencies]() {
+    network_thread->Invoke<void>(RTC_FROM_HERE, [network_shard, &configuration,
+                                                 &dependencies]() {
       dependencies.allocator = absl::make_unique<cricket::BasicPortAllocator>(
-          default_network_manager_.get(), default_socket_factory_.get(),
-          configuration.turn_customizer);
+          network_shard->network_manager.get(),
+          network_shard->socket_factory.get(), configuration.turn_customizer);
     });
   }
 
@@ -372,7 +375,7 @@ PeerConnectionFactory::CreatePeerConnection(
   // |dependencies.async_resolver_factory| to a new
   // |rtc::BasicAsyncResolverFactory| if no factory is provided.
 
-  network_thread_->Invoke<void>(
+  network_thread->Invoke<void>(
       RTC_FROM_HERE,
       rtc::Bind(&cricket::PortAllocator::SetNetworkIgnoreMask,
                 dependencies.allocator.get(), options_.network_ignore_mask));
@@ -387,8 +390,8 @@ PeerConnectionFactory::CreatePeerConnection(
       rtc::Bind(&PeerConnectionFactory::CreateCall_w, this, event_log.get()));
 
   rtc::scoped_refptr<PeerConnection> pc(
-      new rtc::RefCountedObject<PeerConnection>(this, std::move(event_log),
-                                                std::move(call)));
+      new rtc::RefCountedObject<PeerConnection>(
+          this, network_thread, std::move(event_log), std::move(call)));
   ActionsBeforeInitializeForTesting(pc);
   if (!pc->Initialize(configuration, std::move(dependencies))) {
     return nullptr;
@@ -421,9 +424,10 @@ rtc::scoped_refptr<AudioTrackInterface> PeerConnectionFactory::CreateAudioTrack(
 }
 
 std::unique_ptr<cricket::SctpTransportInternalFactory>
-PeerConnectionFactory::CreateSctpTransportInternalFactory() {
+PeerConnectionFactory::CreateSctpTransportInternalFactory(
+    rtc::Thread* network_thread) {
 #ifdef HAVE_SCTP
-  return absl::make_unique<cricket::SctpTransportFactory>(network_thread());
+  return absl::make_unique<cricket::SctpTransportFactory>(network_thread);
 #else
   return nullptr;
 #endif
@@ -447,6 +451,58 @@ rtc::Thread* PeerConnectionFactory::network_thread() {
   return network_thread_;
 }
 
+void PeerConnectionFactory::ReleaseNetworkThread(rtc::Thread* network_thread) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  for (const auto& network_shard : network_shards_) {
+    if (network_shard->thread == network_thread) {
+      RTC_DCHECK_GT(network_shard->num_peer_connections, 0);
+      --network_shard->num_peer_connections;
+      return;
+    }
+  }
+  RTC_NOTREACHED();
+}
+
+PeerConnectionFactory::NetworkShard::NetworkShard() = default;
+
+PeerConnectionFactory::NetworkShard::~NetworkShard() = default;
+
+PeerConnectionFactory::NetworkShard* PeerConnectionFactory::AcquireNetworkShard(
+    bool default_thread) {
+  RTC_DCHECK(!network_shards_.empty());
+  NetworkShard* network_shard = network_shards_[0].get();
+  if (!default_thread) {
+    for (const auto& candidate : network_shards_) {
+      if (candidate->num_peer_connections <
+          network_shard->num_peer_connections) {
+        network_shard = candidate.get();
+      }
+    }
+    if (network_shard->num_peer_connections > 0 &&
+        network_shards_.size() <
+            static_cast<size_t>(options_.num_network_threads)) {
+      auto new_shard = absl::make_unique<NetworkShard>();
+      new_shard->owned_thread = rtc::Thread::CreateWithSocketServer();
+      new_shard->owned_thread->SetName(
+          "pc_network_thread_" + rtc::ToString(network_shards_.size()),
+          nullptr);
+      new_shard->owned_thread->Start();
+      new_shard->thread = new_shard->owned_thread.get();
+      // Like the factory's network thread, see ChannelManager::Init().
+      new_shard->thread->Invoke<void>(RTC_FROM_HERE, [&new_shard] {
+        new_shard->thread->SetAllowBlockingCalls(false);
+      });
+      new_shard->network_manager.reset(new rtc::BasicNetworkManager());
+      new_shard->socket_factory.reset(
+          new rtc::BasicPacketSocketFactory(new_shard->thread));
+      network_shard = new_shard.get();
+      network_shards_.push_back(std::move(new_shard));
+    }
+  }
+  ++network_shard->num_peer_connections;
+  return network_shard;
+}
+
 std::unique_ptr<RtcEventLog> PeerConnectionFactory::CreateRtcEventLog_w() {
   RTC_DCHECK_RUN_ON(worker_thread_);
 
@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "api/media_transport_interface.h"
 #include "api/mediastreaminterface.h"
@@ -89,14 +90,23 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
   void StopAecDump() override;
 
   virtual std::unique_ptr<cricket::SctpTransportInternalFactory>
-  CreateSctpTransportInternalFactory();
+  CreateSctpTransportInternalFactory(rtc::Thread* network_thread);
 
   virtual cricket::ChannelManager* channel_manager();
   virtual rtc::Thread* signaling_thread();
   virtual rtc::Thread* worker_thread();
+  // The factory's network thread, which is also the first of the network
+  // threads PeerConnections are spread over; see
+  // Options::num_network_threads.
   virtual rtc::Thread* network_thread();
   const Options& options() const { return options_; }
 
+  // Called by a PeerConnection when it stops using the network thread it was
+  // given at creation.
+  void ReleaseNetworkThread(rtc::Thread* network_thread);
+  // The number of network threads created so far, including the factory's.
+  size_t num_network_threads() const { return network_shards_.size(); }
+
   MediaTransportFactory* media_transport_factory() {
     return media_transport_factory_.get();
   }
@@ -132,9 +142,30 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
   virtual ~PeerConnectionFactory();
 
  private:
+  // A network thread along with the default networking objects, which are
+  // bound to the thread they are used on, of the PeerConnections pinned to
+  // it.
+  struct NetworkShard {
+    NetworkShard();
+    ~NetworkShard();
+
+    // Set if the thread is owned by the factory. Declared first so that the
+    // objects below are destroyed before the thread is stopped.
+    std::unique_ptr<rtc::Thread> owned_thread;
+    rtc::Thread* thread = nullptr;
+    std::unique_ptr<rtc::BasicNetworkManager> network_manager;
+    std::unique_ptr<rtc::BasicPacketSocketFactory> socket_factory;
+    int num_peer_connections = 0;
+  };
+
   std::unique_ptr<RtcEventLog> CreateRtcEventLog_w();
   std::unique_ptr<Call> CreateCall_w(RtcEventLog* event_log);
 
+  // Picks the network thread for a new PeerConnection, creating another one
+  // if the least loaded thread is in use and |options_| allow more threads.
+  // If |default_thread| is true, the factory's network thread is used.
+  NetworkShard* AcquireNetworkShard(bool default_thread);
+
   bool wraps_current_thread_;
   rtc::Thread* network_thread_;
   rtc::Thread* worker_thread_;
@@ -143,8 +174,8 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
   std::unique_ptr<rtc::Thread> owned_worker_thread_;
   Options options_;
   std::unique_ptr<cricket::ChannelManager> channel_manager_;
-  std::unique_ptr<rtc::BasicNetworkManager> default_network_manager_;
-  std::unique_ptr<rtc::BasicPacketSocketFactory> default_socket_factory_;
+  // The first shard is for |network_thread_|.
+  std::vector<std::unique_ptr<NetworkShard>> network_shards_;
   std::unique_ptr<cricket::MediaEngineInterface> media_engine_;
   std::unique_ptr<webrtc::CallFactoryInterface> call_factory_;
   std::unique_ptr<RtcEventLogFactoryInterface> event_log_factory_;
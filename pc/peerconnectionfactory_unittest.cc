@@ -17,10 +17,12 @@
 #include "api/audio_codecs/builtin_audio_encoder_factory.h"
 #include "api/create_peerconnection_factory.h"
 #include "api/mediastreaminterface.h"
+#include "api/peerconnectionproxy.h"
 #include "api/video_codecs/builtin_video_decoder_factory.h"
 #include "api/video_codecs/builtin_video_encoder_factory.h"
 #include "media/base/fakevideocapturer.h"
 #include "p2p/base/fakeportallocator.h"
+#include "pc/peerconnection.h"
 #include "pc/peerconnectionfactory.h"
 #include "pc/test/fakeaudiocapturemodule.h"
 #include "rtc_base/gunit.h"
@@ -184,6 +186,62 @@ TEST(PeerConnectionFactoryTestInternal, DISABLED_CreatePCUsingInternalModules) {
   EXPECT_TRUE(pc.get() != nullptr);
 }
 
+// Verify that PeerConnections are spread over the number of network threads
+// set in the factory options, and that threads are reused once their
+// PeerConnections are gone.
+TEST(PeerConnectionFactoryTestInternal, SpreadsPCsOverNetworkThreads) {
+#ifdef WEBRTC_ANDROID
+  webrtc::InitializeAndroidObjects();
+#endif
+
+  rtc::scoped_refptr<PeerConnectionFactoryInterface> factory(
+      webrtc::CreatePeerConnectionFactory(
+          nullptr /* network_thread */, nullptr /* worker_thread */,
+          rtc::Thread::Current(),
+          rtc::scoped_refptr<webrtc::AudioDeviceModule>(
+              FakeAudioCaptureModule::Create()),
+          webrtc::CreateBuiltinAudioEncoderFactory(),
+          webrtc::CreateBuiltinAudioDecoderFactory(),
+          webrtc::CreateBuiltinVideoEncoderFactory(),
+          webrtc::CreateBuiltinVideoDecoderFactory(), nullptr /* audio_mixer */,
+          nullptr /* audio_processing */));
+  PeerConnectionFactoryInterface::Options options;
+  options.num_network_threads = 2;
+  factory->SetOptions(options);
+
+  NullPeerConnectionObserver observer;
+  webrtc::PeerConnectionInterface::RTCConfiguration config;
+  auto create_pc = [&] {
+    return factory->CreatePeerConnection(
+        config, nullptr,
+        std::unique_ptr<FakeRTCCertificateGenerator>(
+            new FakeRTCCertificateGenerator()),
+        &observer);
+  };
+  auto network_thread = [](PeerConnectionInterface* pc) {
+    auto* pc_proxy = static_cast<
+        webrtc::PeerConnectionProxyWithInternal<PeerConnectionInterface>*>(pc);
+    return static_cast<webrtc::PeerConnection*>(pc_proxy->internal())
+        ->network_thread();
+  };
+
+  rtc::scoped_refptr<PeerConnectionInterface> pc1 = create_pc();
+  rtc::scoped_refptr<PeerConnectionInterface> pc2 = create_pc();
+  rtc::scoped_refptr<PeerConnectionInterface> pc3 = create_pc();
+  ASSERT_TRUE(pc1 && pc2 && pc3);
+  rtc::Thread* const thread1 = network_thread(pc1);
+  rtc::Thread* const thread2 = network_thread(pc2);
+  EXPECT_NE(thread1, thread2);
+  EXPECT_EQ(thread1, network_thread(pc3));
+
+  // The second thread is free again, so it's picked over creating a third
+  // one or using the first.
+  pc2 = nullptr;
+  rtc::scoped_refptr<PeerConnectionInterface> pc4 = create_pc();
+  ASSERT_TRUE(pc4);
+  EXPECT_EQ(thread2, network_thread(pc4));
+}
+
 TEST_F(PeerConnectionFactoryTest, CheckRtpSenderAudioCapabilities) {
   webrtc::RtpCapabilities audio_capabilities =
       factory_->GetRtpSenderCapabilities(cricket::MEDIA_TYPE_AUDIO);
@@ -21,6 +21,17 @@
 #include "rtc_base/trace_event.h"
 
 namespace webrtc {
+namespace {
+
+// Receive buffers kept for reuse, enough for the packets of a few video
+// frames at high bitrate.
+constexpr size_t kMaxFreeReceiveBuffers = 256;
+
+}  // namespace
+
+RtpTransport::RtpTransport(bool rtcp_mux_enabled)
+    : rtcp_mux_enabled_(rtcp_mux_enabled),
+      receive_buffer_pool_(cricket::kMaxRtpPacketLen, kMaxFreeReceiveBuffers) {}
 
 void RtpTransport::SetRtcpMuxEnabled(bool enable) {
   rtcp_mux_enabled_ = enable;
@@ -35,6 +46,7 @@ void RtpTransport::SetRtpPacketTransport(
   if (rtp_packet_transport_) {
     rtp_packet_transport_->SignalReadyToSend.disconnect(this);
     rtp_packet_transport_->SignalReadPacket.disconnect(this);
+    rtp_packet_transport_->SignalReadPackets.disconnect(this);
     rtp_packet_transport_->SignalNetworkRouteChanged.disconnect(this);
     rtp_packet_transport_->SignalWritableState.disconnect(this);
     rtp_packet_transport_->SignalSentPacket.disconnect(this);
@@ -46,6 +58,8 @@ void RtpTransport::SetRtpPacketTransport(
         this, &RtpTransport::OnReadyToSend);
     new_packet_transport->SignalReadPacket.connect(this,
                                                    &RtpTransport::OnReadPacket);
+    new_packet_transport->SignalReadPackets.connect(
+        this, &RtpTransport::OnReadPackets);
     new_packet_transport->SignalNetworkRouteChanged.connect(
         this, &RtpTransport::OnNetworkRouteChanged);
     new_packet_transport->SignalWritableState.connect(
@@ -71,6 +85,7 @@ void RtpTransport::SetRtcpPacketTransport(
   if (rtcp_packet_transport_) {
     rtcp_packet_transport_->SignalReadyToSend.disconnect(this);
     rtcp_packet_transport_->SignalReadPacket.disconnect(this);
+    rtcp_packet_transport_->SignalReadPackets.disconnect(this);
     rtcp_packet_transport_->SignalNetworkRouteChanged.disconnect(this);
     rtcp_packet_transport_->SignalWritableState.disconnect(this);
     rtcp_packet_transport_->SignalSentPacket.disconnect(this);
@@ -82,6 +97,8 @@ void RtpTransport::SetRtcpPacketTransport(
         this, &RtpTransport::OnReadyToSend);
     new_packet_transport->SignalReadPacket.connect(this,
                                                    &RtpTransport::OnReadPacket);
+    new_packet_transport->SignalReadPackets.connect(
+        this, &RtpTransport::OnReadPackets);
     new_packet_transport->SignalNetworkRouteChanged.connect(
         this, &RtpTransport::OnNetworkRouteChanged);
     new_packet_transport->SignalWritableState.connect(
@@ -118,6 +135,30 @@ bool RtpTransport::SendRtcpPacket(rtc::CopyOnWriteBuffer* packet,
   return SendPacket(true, packet, options, flags);
 }
 
+size_t RtpTransport::SendRtpPackets(
+    rtc::ArrayView<rtc::CopyOnWriteBuffer*> packets,
+    rtc::ArrayView<const rtc::PacketOptions> options,
+    int flags) {
+  RTC_DCHECK_EQ(packets.size(), options.size());
+  size_t num_sent = 0;
+  for (size_t i = 0; i < packets.size(); ++i) {
+    if (SendRtpPacket(packets[i], options[i], flags))
+      ++num_sent;
+  }
+  return num_sent;
+}
+
+void RtpTransport::OnRtpPacketsReceived(
+    rtc::ArrayView<rtc::CopyOnWriteBuffer*> packets,
+    rtc::ArrayView<const int64_t> packet_times_us) {
+  RTC_DCHECK_EQ(packets.size(), packet_times_us.size());
+  DropInvalidRtpPackets(packets);
+  for (size_t i = 0; i < packets.size(); ++i) {
+    if (packets[i]->size() > 0)
+      OnRtpPacketReceived(packets[i], packet_times_us[i]);
+  }
+}
+
 bool RtpTransport::SendPacket(bool rtcp,
                               rtc::CopyOnWriteBuffer* packet,
                               const rtc::PacketOptions& options,
@@ -201,6 +242,21 @@ void RtpTransport::DemuxPacket(rtc::CopyOnWriteBuffer* packet,
   rtp_demuxer_.OnRtpPacket(parsed_packet);
 }
 
+size_t RtpTransport::DropInvalidRtpPackets(
+    rtc::ArrayView<rtc::CopyOnWriteBuffer*> packets) {
+  size_t num_dropped = 0;
+  for (rtc::CopyOnWriteBuffer* packet : packets) {
+    // Protect ourselves against crazy data.
+    if (!cricket::IsValidRtpRtcpPacketSize(/*rtcp=*/false, packet->size())) {
+      RTC_LOG(LS_ERROR) << "Dropping incoming RTP packet: wrong size="
+                        << packet->size();
+      packet->Clear();
+      ++num_dropped;
+    }
+  }
+  return num_dropped;
+}
+
 RtpTransportAdapter* RtpTransport::GetInternal() {
   return nullptr;
 }
@@ -262,7 +318,7 @@ void RtpTransport::OnReadPacket(rtc::PacketTransportInternal* transport,
     return;
   }
 
-  rtc::CopyOnWriteBuffer packet(data, len);
+  rtc::CopyOnWriteBuffer packet = receive_buffer_pool_.CreateBuffer(data, len);
   // Protect ourselves against crazy data.
   if (!cricket::IsValidRtpRtcpPacketSize(rtcp, packet.size())) {
     RTC_LOG(LS_ERROR) << "Dropping incoming "
@@ -278,6 +334,46 @@ void RtpTransport::OnReadPacket(rtc::PacketTransportInternal* transport,
   }
 }
 
+void RtpTransport::OnReadPackets(rtc::PacketTransportInternal* transport,
+                                 const rtc::Datagram* packets,
+                                 size_t num_packets,
+                                 int flags) {
+  TRACE_EVENT1("webrtc", "RtpTransport::OnReadPackets", "packets",
+               num_packets);
+
+  for (size_t i = 0; i < num_packets; ++i) {
+    const char* data = packets[i].data;
+    size_t len = packets[i].size;
+    bool rtcp = transport == rtcp_packet_transport() ||
+                cricket::IsRtcpPacket(data, len);
+    if (rtcp) {
+      // Keep the order of RTP and RTCP packets.
+      DeliverReadBatch();
+      OnReadPacket(transport, data, len, packets[i].timestamp, flags);
+      continue;
+    }
+    // Filter out the packet that is neither RTP nor RTCP.
+    if (!cricket::IsRtpPacket(data, len)) {
+      continue;
+    }
+    // The size is checked by OnRtpPacketsReceived.
+    read_batch_.push_back(receive_buffer_pool_.CreateBuffer(data, len));
+    read_batch_times_us_.push_back(packets[i].timestamp);
+  }
+  DeliverReadBatch();
+}
+
+void RtpTransport::DeliverReadBatch() {
+  if (read_batch_.empty())
+    return;
+  for (rtc::CopyOnWriteBuffer& packet : read_batch_)
+    read_batch_ptrs_.push_back(&packet);
+  OnRtpPacketsReceived(read_batch_ptrs_, read_batch_times_us_);
+  read_batch_.clear();
+  read_batch_ptrs_.clear();
+  read_batch_times_us_.clear();
+}
+
 void RtpTransport::SetReadyToSend(bool rtcp, bool ready) {
   if (rtcp) {
     rtcp_ready_to_send_ = ready;
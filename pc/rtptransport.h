@@ -12,15 +12,18 @@
 #define PC_RTPTRANSPORT_H_
 
 #include <string>
+#include <vector>
 
 #include "call/rtp_demuxer.h"
 #include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
 #include "pc/rtptransportinternal.h"
+#include "rtc_base/copyonwritebuffer.h"
+#include "rtc_base/copyonwritebufferpool.h"
 #include "rtc_base/third_party/sigslot/sigslot.h"
 
 namespace rtc {
 
-class CopyOnWriteBuffer;
+struct Datagram;
 struct PacketOptions;
 class PacketTransportInternal;
 
@@ -33,8 +36,7 @@ class RtpTransport : public RtpTransportInternal {
   RtpTransport(const RtpTransport&) = delete;
   RtpTransport& operator=(const RtpTransport&) = delete;
 
-  explicit RtpTransport(bool rtcp_mux_enabled)
-      : rtcp_mux_enabled_(rtcp_mux_enabled) {}
+  explicit RtpTransport(bool rtcp_mux_enabled);
 
   bool rtcp_mux_enabled() const override { return rtcp_mux_enabled_; }
   void SetRtcpMuxEnabled(bool enable) override;
@@ -72,6 +74,10 @@ class RtpTransport : public RtpTransportInternal {
                       const rtc::PacketOptions& options,
                       int flags) override;
 
+  size_t SendRtpPackets(rtc::ArrayView<rtc::CopyOnWriteBuffer*> packets,
+                        rtc::ArrayView<const rtc::PacketOptions> options,
+                        int flags) override;
+
   bool IsSrtpActive() const override { return false; }
 
   void UpdateRtpHeaderExtensionMap(
@@ -82,6 +88,14 @@ class RtpTransport : public RtpTransportInternal {
 
   bool UnregisterRtpDemuxerSink(RtpPacketSinkInterface* sink) override;
 
+  // Handles a batch of RTP packets read from the network together, e.g. with
+  // recvmmsg, each with its own receive time. Same as handling the packets one
+  // by one, but lets SrtpTransport unprotect them in one call. Packets with an
+  // invalid RTP size are dropped.
+  virtual void OnRtpPacketsReceived(
+      rtc::ArrayView<rtc::CopyOnWriteBuffer*> packets,
+      rtc::ArrayView<const int64_t> packet_times_us);
+
  protected:
   // TODO(zstein): Remove this when we remove RtpTransportAdapter.
   RtpTransportAdapter* GetInternal() override;
@@ -89,6 +103,12 @@ class RtpTransport : public RtpTransportInternal {
   // These methods will be used in the subclasses.
   void DemuxPacket(rtc::CopyOnWriteBuffer* packet, int64_t packet_time_us);
 
+  // Clears the packets of a received batch that have an invalid RTP size, so
+  // they are skipped like packets that fail to be unprotected. Returns the
+  // number of packets cleared.
+  static size_t DropInvalidRtpPackets(
+      rtc::ArrayView<rtc::CopyOnWriteBuffer*> packets);
+
   bool SendPacket(bool rtcp,
                   rtc::CopyOnWriteBuffer* packet,
                   const rtc::PacketOptions& options,
@@ -113,6 +133,12 @@ class RtpTransport : public RtpTransportInternal {
                     size_t len,
                     const int64_t& packet_time_us,
                     int flags);
+  void OnReadPackets(rtc::PacketTransportInternal* transport,
+                     const rtc::Datagram* packets,
+                     size_t num_packets,
+                     int flags);
+  // Passes the RTP packets collected by OnReadPackets on together.
+  void DeliverReadBatch();
 
   // Updates "ready to send" for an individual channel and fires
   // SignalReadyToSend.
@@ -148,6 +174,18 @@ class RtpTransport : public RtpTransportInternal {
 
   // Used for identifying the MID for RtpDemuxer.
   RtpHeaderExtensionMap header_extension_map_;
+
+  // Received packets are copied into buffers from this pool. The buffer is
+  // decrypted in place and then shared, not copied, by everything down to
+  // the video packet buffer, which holds on to it until the payload has been
+  // copied into the frame the packet belongs to.
+  rtc::CopyOnWriteBufferPool receive_buffer_pool_;
+
+  // The RTP packets of the batch OnReadPackets is handling, kept across calls
+  // to reuse the storage.
+  std::vector<rtc::CopyOnWriteBuffer> read_batch_;
+  std::vector<rtc::CopyOnWriteBuffer*> read_batch_ptrs_;
+  std::vector<int64_t> read_batch_times_us_;
 };
 
 }  // namespace webrtc
@@ -8,9 +8,13 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <string.h>
+
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "media/base/rtputils.h"
 #include "p2p/base/fakepackettransport.h"
 #include "pc/rtptransport.h"
 #include "pc/rtptransporttestutil.h"
@@ -343,4 +347,38 @@ TEST(RtpTransportTest, DontSignalUnhandledRtpPayloadType) {
   transport.UnregisterRtpDemuxerSink(&observer);
 }
 
+// Test that a batch of packets read together is demuxed like the same packets
+// read one by one, and that RTP packets with an invalid size are dropped.
+TEST(RtpTransportTest, SignalBatchOfReadPackets) {
+  RtpTransport transport(kMuxEnabled);
+  rtc::FakePacketTransport fake_rtp("fake_rtp");
+  transport.SetRtpPacketTransport(&fake_rtp);
+  TransportObserver observer(&transport);
+  RtpDemuxerCriteria demuxer_criteria;
+  demuxer_criteria.payload_types = {0x11};
+  transport.RegisterRtpDemuxerSink(demuxer_criteria, &observer);
+
+  char rtp_data[kRtpLen];
+  memcpy(rtp_data, kRtpData, kRtpLen);
+  char rtcp_data[] = {0, 73, 0, 0};
+  std::vector<char> oversized_rtp_data(cricket::kMaxRtpPacketLen + 1);
+  memcpy(oversized_rtp_data.data(), kRtpData, kRtpLen);
+
+  rtc::Datagram packets[4];
+  packets[0].data = rtp_data;
+  packets[0].size = kRtpLen;
+  packets[1].data = rtcp_data;
+  packets[1].size = sizeof(rtcp_data);
+  packets[2].data = oversized_rtp_data.data();
+  packets[2].size = oversized_rtp_data.size();
+  packets[3].data = rtp_data;
+  packets[3].size = kRtpLen;
+  fake_rtp.SignalReadPackets(&fake_rtp, packets, 4, /*flags=*/0);
+
+  EXPECT_EQ(2, observer.rtp_count());
+  EXPECT_EQ(1, observer.rtcp_count());
+  // Remove the sink before destroying the transport.
+  transport.UnregisterRtpDemuxerSink(&observer);
+}
+
 }  // namespace webrtc
@@ -13,6 +13,7 @@
 
 #include <string>
 
+#include "api/array_view.h"
 #include "api/ortc/srtptransportinterface.h"
 #include "call/rtp_demuxer.h"
 #include "p2p/base/icetransportinternal.h"
@@ -82,6 +83,14 @@ class RtpTransportInternal : public SrtpTransportInterface,
                               const rtc::PacketOptions& options,
                               int flags) = 0;
 
+  // Sends a burst of RTP packets, such as those the pacer releases at once.
+  // |options| holds the options of each packet. Returns the number of packets
+  // that were sent.
+  virtual size_t SendRtpPackets(
+      rtc::ArrayView<rtc::CopyOnWriteBuffer*> packets,
+      rtc::ArrayView<const rtc::PacketOptions> options,
+      int flags) = 0;
+
   // This method updates the RTP header extension map so that the RTP transport
   // can parse the received packets and identify the MID. This is called by the
   // BaseChannel when setting the content description.
@@ -71,6 +71,12 @@ class RtpTransportInternalAdapter : public RtpTransportInternal {
     return transport_->SendRtcpPacket(packet, options, flags);
   }
 
+  size_t SendRtpPackets(rtc::ArrayView<rtc::CopyOnWriteBuffer*> packets,
+                        rtc::ArrayView<const rtc::PacketOptions> options,
+                        int flags) override {
+    return transport_->SendRtpPackets(packets, options, flags);
+  }
+
   void UpdateRtpHeaderExtensionMap(
       const cricket::RtpHeaderExtensions& header_extensions) override {
     transport_->UpdateRtpHeaderExtensionMap(header_extensions);
@@ -12,8 +12,10 @@
 
 #include "media/base/rtputils.h"
 #include "pc/externalhmac.h"
+#include "rtc_base/copyonwritebuffer.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/numerics/safe_conversions.h"
 #include "rtc_base/sslstreamadapter.h"
 #include "system_wrappers/include/metrics.h"
 #include "third_party/libsrtp/include/srtp.h"
@@ -138,22 +140,86 @@ bool SrtpSession::UnprotectRtp(void* p, int in_len, int* out_len) {
   *out_len = in_len;
   int err = srtp_unprotect(session_, p, out_len);
   if (err != srtp_err_status_ok) {
-    // Limit the error logging to avoid excessive logs when there are lots of
-    // bad packets.
-    const int kFailureLogThrottleCount = 100;
-    if (decryption_failure_count_ % kFailureLogThrottleCount == 0) {
-      RTC_LOG(LS_WARNING) << "Failed to unprotect SRTP packet, err=" << err
-                          << ", previous failure count: "
-                          << decryption_failure_count_;
-    }
-    ++decryption_failure_count_;
-    RTC_HISTOGRAM_ENUMERATION("WebRTC.PeerConnection.SrtpUnprotectError",
-                              static_cast<int>(err), kSrtpErrorCodeBoundary);
+    OnUnprotectRtpFailed(err);
     return false;
   }
   return true;
 }
 
+// libsrtp has no batch interface, so the packets are still transformed one
+// srtp_protect() call at a time. What the batch saves is the per-call checks
+// and logging around it, which leaves a tight loop over the cipher and
+// authentication work that dominates the cost of each packet.
+size_t SrtpSession::ProtectRtp(
+    rtc::ArrayView<rtc::CopyOnWriteBuffer*> packets) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  if (!session_) {
+    RTC_LOG(LS_WARNING) << "Failed to protect SRTP packets: no SRTP Session";
+    for (rtc::CopyOnWriteBuffer* packet : packets)
+      packet->SetSize(0);
+    return 0;
+  }
+
+  size_t num_protected = 0;
+  const rtc::CopyOnWriteBuffer* last_protected = nullptr;
+  for (rtc::CopyOnWriteBuffer* packet : packets) {
+    if (packet->size() == 0)
+      continue;
+    const int in_len = rtc::checked_cast<int>(packet->size());
+    // Make room for the auth tag before getting the writable pointer, so the
+    // packet is copied at most once if it is shared.
+    packet->EnsureCapacity(in_len + rtp_auth_tag_len_);
+    int out_len = in_len;
+    int err = srtp_protect(session_, packet->data(), &out_len);
+    if (err != srtp_err_status_ok) {
+      int seq_num = -1;
+      GetRtpSeqNum(packet->cdata(), in_len, &seq_num);
+      RTC_LOG(LS_WARNING) << "Failed to protect SRTP packet, seqnum="
+                          << seq_num << ", err=" << err
+                          << ", last seqnum=" << last_send_seq_num_;
+      packet->SetSize(0);
+      continue;
+    }
+    packet->SetSize(out_len);
+    last_protected = packet;
+    ++num_protected;
+  }
+  // The RTP header is not encrypted, so the sequence number can be read from
+  // the protected packet.
+  if (last_protected) {
+    GetRtpSeqNum(last_protected->cdata(), last_protected->size(),
+                 &last_send_seq_num_);
+  }
+  return num_protected;
+}
+
+size_t SrtpSession::UnprotectRtp(
+    rtc::ArrayView<rtc::CopyOnWriteBuffer*> packets) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  if (!session_) {
+    RTC_LOG(LS_WARNING) << "Failed to unprotect SRTP packets: no SRTP Session";
+    for (rtc::CopyOnWriteBuffer* packet : packets)
+      packet->SetSize(0);
+    return 0;
+  }
+
+  size_t num_unprotected = 0;
+  for (rtc::CopyOnWriteBuffer* packet : packets) {
+    if (packet->size() == 0)
+      continue;
+    int len = rtc::checked_cast<int>(packet->size());
+    int err = srtp_unprotect(session_, packet->data(), &len);
+    if (err != srtp_err_status_ok) {
+      OnUnprotectRtpFailed(err);
+      packet->SetSize(0);
+      continue;
+    }
+    packet->SetSize(len);
+    ++num_unprotected;
+  }
+  return num_unprotected;
+}
+
 bool SrtpSession::UnprotectRtcp(void* p, int in_len, int* out_len) {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
   if (!session_) {
@@ -233,6 +299,20 @@ bool SrtpSession::GetSendStreamPacketIndex(void* p,
   return true;
 }
 
+void SrtpSession::OnUnprotectRtpFailed(int err) {
+  // Limit the error logging to avoid excessive logs when there are lots of
+  // bad packets.
+  const int kFailureLogThrottleCount = 100;
+  if (decryption_failure_count_ % kFailureLogThrottleCount == 0) {
+    RTC_LOG(LS_WARNING) << "Failed to unprotect SRTP packet, err=" << err
+                        << ", previous failure count: "
+                        << decryption_failure_count_;
+  }
+  ++decryption_failure_count_;
+  RTC_HISTOGRAM_ENUMERATION("WebRTC.PeerConnection.SrtpUnprotectError",
+                            static_cast<int>(err), kSrtpErrorCodeBoundary);
+}
+
 bool SrtpSession::DoSetKey(int type,
                            int cs,
                            const uint8_t* key,
@@ -13,6 +13,7 @@
 
 #include <vector>
 
+#include "api/array_view.h"
 #include "rtc_base/scoped_ref_ptr.h"
 #include "rtc_base/thread_checker.h"
 
@@ -20,6 +21,10 @@
 struct srtp_event_data_t;
 struct srtp_ctx_t_;
 
+namespace rtc {
+class CopyOnWriteBuffer;
+}  // namespace rtc
+
 namespace cricket {
 
 // Class that wraps a libSRTP session.
@@ -65,6 +70,14 @@ class SrtpSession {
   bool UnprotectRtp(void* data, int in_len, int* out_len);
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
 
+  // Batch versions of ProtectRtp() and UnprotectRtp(), for bursts of packets
+  // sent by the pacer or read from the socket together. Each packet is
+  // transformed in place and resized; packets that fail are cleared to size
+  // zero. Empty packets are skipped, so callers can drop packets from a batch
+  // by clearing them. Returns the number of packets that succeeded.
+  size_t ProtectRtp(rtc::ArrayView<rtc::CopyOnWriteBuffer*> packets);
+  size_t UnprotectRtp(rtc::ArrayView<rtc::CopyOnWriteBuffer*> packets);
+
   // Helper method to get authentication params.
   bool GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len);
 
@@ -102,6 +115,9 @@ class SrtpSession {
   // Returns send stream current packet index from srtp db.
   bool GetSendStreamPacketIndex(void* data, int in_len, int64_t* index);
 
+  // Logs, throttled, and records in UMA a failure to unprotect a packet.
+  void OnUnprotectRtpFailed(int err);
+
   // These methods are responsible for initializing libsrtp (if the usage count
   // is incremented from 0 to 1) or deinitializing it (when decremented from 1
   // to 0).
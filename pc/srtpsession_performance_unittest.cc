@@ -0,0 +1,145 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "pc/srtpsession.h"
+#include "pc/srtptestutil.h"
+#include "rtc_base/byteorder.h"
+#include "rtc_base/copyonwritebuffer.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/sslstreamadapter.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace rtc {
+namespace {
+
+constexpr size_t kPacketSize = 1200;
+// Room for the longest auth tag, used by the AES-GCM suites.
+constexpr size_t kMaxAuthTagLen = 16;
+constexpr size_t kBatchSize = 32;
+constexpr int kNumBatches = 2000;
+
+// Protects and unprotects |kNumBatches| bursts of |kBatchSize| video sized
+// packets, either one packet at a time or with the batch API, and reports the
+// throughput of each direction in packets per CPU second.
+class SrtpSessionPerformanceTest
+    : public testing::TestWithParam<std::tuple<int, bool>> {
+ protected:
+  SrtpSessionPerformanceTest()
+      : crypto_suite_(std::get<0>(GetParam())),
+        batch_(std::get<1>(GetParam())),
+        packets_(kBatchSize),
+        packet_ptrs_(kBatchSize) {
+    for (size_t i = 0; i < kBatchSize; ++i)
+      packet_ptrs_[i] = &packets_[i];
+  }
+
+  void FillPackets() {
+    for (CopyOnWriteBuffer& packet : packets_) {
+      packet.SetSize(kPacketSize);
+      uint8_t* data = packet.data();
+      memset(data, 0xab, kPacketSize);
+      data[0] = 0x80;
+      data[1] = 96;
+      SetBE16(data + 2, sequence_number_++);
+      SetBE32(data + 4, timestamp_);
+      SetBE32(data + 8, 0x12345678);
+    }
+    timestamp_ += 3000;
+  }
+
+  void Protect(cricket::SrtpSession* session) {
+    if (batch_) {
+      ASSERT_EQ(kBatchSize, session->ProtectRtp(packet_ptrs_));
+      return;
+    }
+    for (CopyOnWriteBuffer& packet : packets_) {
+      packet.EnsureCapacity(kPacketSize + kMaxAuthTagLen);
+      int out_len = 0;
+      ASSERT_TRUE(session->ProtectRtp(
+          packet.data(), static_cast<int>(packet.size()),
+          static_cast<int>(packet.capacity()), &out_len));
+      packet.SetSize(out_len);
+    }
+  }
+
+  void Unprotect(cricket::SrtpSession* session) {
+    if (batch_) {
+      ASSERT_EQ(kBatchSize, session->UnprotectRtp(packet_ptrs_));
+      return;
+    }
+    for (CopyOnWriteBuffer& packet : packets_) {
+      int out_len = 0;
+      ASSERT_TRUE(session->UnprotectRtp(
+          packet.data(), static_cast<int>(packet.size()), &out_len));
+      packet.SetSize(out_len);
+    }
+  }
+
+  std::string Trace() const {
+    return SrtpCryptoSuiteToName(crypto_suite_) +
+           (batch_ ? "_batch" : "_single");
+  }
+
+  const int crypto_suite_;
+  const bool batch_;
+  std::vector<CopyOnWriteBuffer> packets_;
+  std::vector<CopyOnWriteBuffer*> packet_ptrs_;
+  uint16_t sequence_number_ = 0;
+  uint32_t timestamp_ = 0;
+};
+
+}  // namespace
+
+TEST_P(SrtpSessionPerformanceTest, ProtectAndUnprotect) {
+  const int key_len = crypto_suite_ == SRTP_AEAD_AES_128_GCM ? 28 : 30;
+  cricket::SrtpSession sender;
+  cricket::SrtpSession receiver;
+  ASSERT_TRUE(sender.SetSend(crypto_suite_, kTestKey1, key_len, {}));
+  ASSERT_TRUE(receiver.SetRecv(crypto_suite_, kTestKey1, key_len, {}));
+
+  int64_t protect_cpu_ns = 0;
+  int64_t unprotect_cpu_ns = 0;
+  for (int i = 0; i < kNumBatches; ++i) {
+    FillPackets();
+    int64_t start_cpu_ns = GetThreadCpuTimeNanos();
+    Protect(&sender);
+    protect_cpu_ns += GetThreadCpuTimeNanos() - start_cpu_ns;
+
+    start_cpu_ns = GetThreadCpuTimeNanos();
+    Unprotect(&receiver);
+    unprotect_cpu_ns += GetThreadCpuTimeNanos() - start_cpu_ns;
+  }
+  ASSERT_GT(protect_cpu_ns, 0);
+  ASSERT_GT(unprotect_cpu_ns, 0);
+
+  const double num_packets = static_cast<double>(kNumBatches * kBatchSize);
+  webrtc::test::PrintResult("srtp_protect_rate", "", Trace(),
+                            num_packets * 1e9 / protect_cpu_ns, "packets/s",
+                            true);
+  webrtc::test::PrintResult("srtp_unprotect_rate", "", Trace(),
+                            num_packets * 1e9 / unprotect_cpu_ns, "packets/s",
+                            true);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    CryptoSuites,
+    SrtpSessionPerformanceTest,
+    ::testing::Combine(::testing::Values(SRTP_AES128_CM_SHA1_80,
+                                         SRTP_AEAD_AES_128_GCM),
+                       ::testing::Bool()));
+
+}  // namespace rtc
@@ -11,10 +11,12 @@
 #include "pc/srtpsession.h"
 
 #include <string>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "media/base/fakertp.h"
 #include "pc/srtptestutil.h"
+#include "rtc_base/copyonwritebuffer.h"
 #include "rtc_base/gunit.h"
 #include "rtc_base/sslstreamadapter.h"  // For rtc::SRTP_*
 #include "system_wrappers/include/metrics.h"
@@ -192,6 +194,42 @@ TEST_F(SrtpSessionTest, TestBuffersTooSmall) {
                                sizeof(rtcp_packet_) - 14, &out_len));
 }
 
+// Test that a batch of RTP packets can be protected and unprotected in one
+// call, and that a packet that fails doesn't affect the others.
+TEST_F(SrtpSessionTest, TestProtectAndUnprotectRtpBatch) {
+  EXPECT_TRUE(s1_.SetSend(SRTP_AEAD_AES_128_GCM, kTestKey1, 28,
+                          kEncryptedHeaderExtensionIds));
+  EXPECT_TRUE(s2_.SetRecv(SRTP_AEAD_AES_128_GCM, kTestKey1, 28,
+                          kEncryptedHeaderExtensionIds));
+  const int kNumPackets = 4;
+  std::vector<CopyOnWriteBuffer> packets;
+  std::vector<CopyOnWriteBuffer*> packet_ptrs;
+  for (int i = 0; i < kNumPackets; ++i) {
+    packets.emplace_back(kPcmuFrame, sizeof(kPcmuFrame));
+    SetBE16(packets.back().data() + 2, i + 1);
+  }
+  for (CopyOnWriteBuffer& packet : packets)
+    packet_ptrs.push_back(&packet);
+  const std::vector<CopyOnWriteBuffer> original = packets;
+
+  EXPECT_EQ(static_cast<size_t>(kNumPackets), s1_.ProtectRtp(packet_ptrs));
+  for (const CopyOnWriteBuffer& packet : packets) {
+    EXPECT_EQ(sizeof(kPcmuFrame) + rtp_auth_tag_len(CS_AEAD_AES_128_GCM),
+              packet.size());
+  }
+
+  // Tamper with one packet.
+  packets[1].data()[sizeof(kPcmuFrame) - 1] ^= 0xff;
+  EXPECT_EQ(static_cast<size_t>(kNumPackets - 1),
+            s2_.UnprotectRtp(packet_ptrs));
+  EXPECT_EQ(original[0], packets[0]);
+  EXPECT_EQ(0u, packets[1].size());
+  EXPECT_EQ(original[2], packets[2]);
+  EXPECT_EQ(original[3], packets[3]);
+  EXPECT_EQ(1, webrtc::metrics::NumSamples(
+                   "WebRTC.PeerConnection.SrtpUnprotectError"));
+}
+
 TEST_F(SrtpSessionTest, TestReplay) {
   static const uint16_t kMaxSeqnum = static_cast<uint16_t>(-1);
   static const uint16_t seqnum_big = 62275;
@@ -167,6 +167,37 @@ bool SrtpTransport::SendRtpPacket(rtc::CopyOnWriteBuffer* packet,
   return SendPacket(/*rtcp=*/false, packet, updated_options, flags);
 }
 
+size_t SrtpTransport::SendRtpPackets(
+    rtc::ArrayView<rtc::CopyOnWriteBuffer*> packets,
+    rtc::ArrayView<const rtc::PacketOptions> options,
+    int flags) {
+  RTC_DCHECK_EQ(packets.size(), options.size());
+  if (!IsSrtpActive()) {
+    RTC_LOG(LS_ERROR)
+        << "Failed to send the packets because SRTP transport is inactive.";
+    return 0;
+  }
+  if (IsExternalAuthActive())
+    return RtpTransport::SendRtpPackets(packets, options, flags);
+
+  TRACE_EVENT1("webrtc", "SRTP Encode", "packets", packets.size());
+  RTC_CHECK(send_session_);
+  if (send_session_->ProtectRtp(packets) != packets.size()) {
+    RTC_LOG(LS_ERROR) << "Failed to protect some of " << packets.size()
+                      << " RTP packets.";
+  }
+
+  size_t num_sent = 0;
+  for (size_t i = 0; i < packets.size(); ++i) {
+    // Packets that failed to be protected have been cleared.
+    if (packets[i]->size() > 0 &&
+        SendPacket(/*rtcp=*/false, packets[i], options[i], flags)) {
+      ++num_sent;
+    }
+  }
+  return num_sent;
+}
+
 bool SrtpTransport::SendRtcpPacket(rtc::CopyOnWriteBuffer* packet,
                                    const rtc::PacketOptions& options,
                                    int flags) {
@@ -224,6 +255,29 @@ void SrtpTransport::OnRtpPacketReceived(rtc::CopyOnWriteBuffer* packet,
   DemuxPacket(packet, packet_time_us);
 }
 
+void SrtpTransport::OnRtpPacketsReceived(
+    rtc::ArrayView<rtc::CopyOnWriteBuffer*> packets,
+    rtc::ArrayView<const int64_t> packet_times_us) {
+  RTC_DCHECK_EQ(packets.size(), packet_times_us.size());
+  if (!IsSrtpActive()) {
+    RTC_LOG(LS_WARNING)
+        << "Inactive SRTP transport received RTP packets. Drop them.";
+    return;
+  }
+  TRACE_EVENT1("webrtc", "SRTP Decode", "packets", packets.size());
+  RTC_CHECK(recv_session_);
+  // The session skips the cleared packets.
+  const size_t num_dropped = DropInvalidRtpPackets(packets);
+  // Failures are logged by the session.
+  const size_t num_unprotected = recv_session_->UnprotectRtp(packets);
+  decryption_failure_count_ += rtc::checked_cast<int>(
+      packets.size() - num_dropped - num_unprotected);
+  for (size_t i = 0; i < packets.size(); ++i) {
+    if (packets[i]->size() > 0)
+      DemuxPacket(packets[i], packet_times_us[i]);
+  }
+}
+
 void SrtpTransport::OnRtcpPacketReceived(rtc::CopyOnWriteBuffer* packet,
                                          int64_t packet_time_us) {
   if (!IsSrtpActive()) {
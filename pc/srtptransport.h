@@ -47,6 +47,16 @@ class SrtpTransport : public RtpTransport {
                       const rtc::PacketOptions& options,
                       int flags) override;
 
+  // Protects the whole burst with one SrtpSession call before sending it,
+  // unless external auth is active, which needs per-packet auth params.
+  size_t SendRtpPackets(rtc::ArrayView<rtc::CopyOnWriteBuffer*> packets,
+                        rtc::ArrayView<const rtc::PacketOptions> options,
+                        int flags) override;
+
+  void OnRtpPacketsReceived(
+      rtc::ArrayView<rtc::CopyOnWriteBuffer*> packets,
+      rtc::ArrayView<const int64_t> packet_times_us) override;
+
   // The transport becomes active if the send_session_ and recv_session_ are
   // created.
   bool IsSrtpActive() const override;
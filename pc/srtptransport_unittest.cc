@@ -18,6 +18,7 @@
 #include "p2p/base/fakepackettransport.h"
 #include "pc/rtptransport.h"
 #include "pc/rtptransporttestutil.h"
+#include "pc/srtpsession.h"
 #include "pc/srtptestutil.h"
 #include "rtc_base/asyncpacketsocket.h"
 #include "rtc_base/gunit.h"
@@ -399,6 +400,58 @@ INSTANTIATE_TEST_CASE_P(ExternalAuth,
                         SrtpTransportTestWithExternalAuth,
                         ::testing::Values(true, false));
 
+// Test that a batch of RTP packets is protected and delivered to the remote
+// transport, and that a batch received by the transport is unprotected and
+// demuxed except for packets that fail to unprotect or have an invalid size.
+TEST_F(SrtpTransportTest, SendAndRecvRtpPacketBatch) {
+  std::vector<int> extension_ids;
+  EXPECT_TRUE(srtp_transport1_->SetRtpParams(
+      rtc::SRTP_AEAD_AES_128_GCM, kTestKeyGcm128_1, kTestKeyGcm128Len,
+      extension_ids, rtc::SRTP_AEAD_AES_128_GCM, kTestKeyGcm128_2,
+      kTestKeyGcm128Len, extension_ids));
+  EXPECT_TRUE(srtp_transport2_->SetRtpParams(
+      rtc::SRTP_AEAD_AES_128_GCM, kTestKeyGcm128_2, kTestKeyGcm128Len,
+      extension_ids, rtc::SRTP_AEAD_AES_128_GCM, kTestKeyGcm128_1,
+      kTestKeyGcm128Len, extension_ids));
+
+  const size_t kNumPackets = 3;
+  std::vector<rtc::CopyOnWriteBuffer> packets;
+  std::vector<rtc::CopyOnWriteBuffer*> packet_ptrs;
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    packets.emplace_back(kPcmuFrame, sizeof(kPcmuFrame));
+    rtc::SetBE16(packets.back().data() + 2, ++sequence_number_);
+  }
+  for (rtc::CopyOnWriteBuffer& packet : packets)
+    packet_ptrs.push_back(&packet);
+  const rtc::CopyOnWriteBuffer last_packet = packets.back();
+
+  std::vector<rtc::PacketOptions> options(kNumPackets);
+  EXPECT_EQ(kNumPackets,
+            srtp_transport1_->SendRtpPackets(packet_ptrs, options,
+                                             cricket::PF_SRTP_BYPASS));
+  EXPECT_EQ(static_cast<int>(kNumPackets), rtp_sink2_.rtp_count());
+  EXPECT_EQ(last_packet, rtp_sink2_.last_recv_rtp_packet());
+
+  // Protect another batch with the key used by |srtp_transport1_| and feed it
+  // directly to |srtp_transport2_|, with one packet tampered with.
+  cricket::SrtpSession send_session;
+  EXPECT_TRUE(send_session.SetSend(rtc::SRTP_AEAD_AES_128_GCM,
+                                   kTestKeyGcm128_1, kTestKeyGcm128Len,
+                                   extension_ids));
+  for (rtc::CopyOnWriteBuffer& packet : packets) {
+    packet.SetData(kPcmuFrame, sizeof(kPcmuFrame));
+    rtc::SetBE16(packet.data() + 2, ++sequence_number_);
+  }
+  EXPECT_EQ(kNumPackets, send_session.ProtectRtp(packet_ptrs));
+  packets[kNumPackets - 1].data()[sizeof(kPcmuFrame) - 1] ^= 0xff;
+  // A packet too short to be RTP is dropped before unprotecting it.
+  rtc::CopyOnWriteBuffer runt_packet(kPcmuFrame, 4);
+  packet_ptrs.push_back(&runt_packet);
+  std::vector<int64_t> packet_times_us(packet_ptrs.size(), -1);
+  srtp_transport2_->OnRtpPacketsReceived(packet_ptrs, packet_times_us);
+  EXPECT_EQ(static_cast<int>(2 * kNumPackets - 1), rtp_sink2_.rtp_count());
+}
+
 // Test directly setting the params with bogus keys.
 TEST_F(SrtpTransportTest, TestSetParamsKeyTooShort) {
   std::vector<int> extension_ids;
@@ -29,6 +29,19 @@ AsyncPacketSocket::AsyncPacketSocket() = default;
 
 AsyncPacketSocket::~AsyncPacketSocket() = default;
 
+int AsyncPacketSocket::SendToBatch(const Datagram* packets,
+                                   const PacketOptions* options,
+                                   size_t count) {
+  size_t sent = 0;
+  for (; sent < count; ++sent) {
+    if (SendTo(packets[sent].data, packets[sent].size, packets[sent].addr,
+               options[sent]) < 0) {
+      break;
+    }
+  }
+  return (sent > 0 || count == 0) ? static_cast<int>(sent) : -1;
+}
+
 void CopySocketInformationToPacketInfo(size_t packet_size_bytes,
                                        const AsyncPacketSocket& socket_from,
                                        bool is_connectionless,
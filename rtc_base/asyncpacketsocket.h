@@ -84,6 +84,14 @@ class AsyncPacketSocket : public sigslot::has_slots<> {
                      const SocketAddress& addr,
                      const PacketOptions& options) = 0;
 
+  // Sends |count| datagrams, each to its own |Datagram::addr|, with the
+  // matching entry of |options|. Stops at the first packet that cannot be
+  // sent and returns the number of packets sent, or -1 if none were. The
+  // default implementation calls SendTo() for each packet.
+  virtual int SendToBatch(const Datagram* packets,
+                          const PacketOptions* options,
+                          size_t count);
+
   // Close the socket.
   virtual int Close() = 0;
 
@@ -110,6 +118,14 @@ class AsyncPacketSocket : public sigslot::has_slots<> {
                    const int64_t&>
       SignalReadPacket;
 
+  // Emitted by sockets with batched reads enabled (see
+  // AsyncUDPSocket::SetReceiveBatchSize) with all datagrams drained on one
+  // readiness event. The packet memory is only valid during the callback.
+  // When nothing is connected, the packets are emitted one at a time through
+  // SignalReadPacket instead.
+  sigslot::signal3<AsyncPacketSocket*, const Datagram*, size_t>
+      SignalReadPackets;
+
   // Emitted each time a packet is sent.
   sigslot::signal2<AsyncPacketSocket*, const SentPacket&> SignalSentPacket;
 
@@ -17,6 +17,30 @@ AsyncSocket::AsyncSocket() {}
 
 AsyncSocket::~AsyncSocket() {}
 
+int AsyncSocket::RecvFromBatch(Datagram* datagrams, size_t count) {
+  size_t received = 0;
+  for (; received < count; ++received) {
+    Datagram& datagram = datagrams[received];
+    int len = RecvFrom(datagram.data, datagram.capacity, &datagram.addr,
+                       &datagram.timestamp);
+    if (len < 0)
+      break;
+    datagram.size = static_cast<size_t>(len);
+    datagram.segment_size = 0;
+  }
+  return (received > 0 || count == 0) ? static_cast<int>(received) : -1;
+}
+
+int AsyncSocket::SendToBatch(const Datagram* datagrams, size_t count) {
+  size_t sent = 0;
+  for (; sent < count; ++sent) {
+    const Datagram& datagram = datagrams[sent];
+    if (SendTo(datagram.data, datagram.size, datagram.addr) < 0)
+      break;
+  }
+  return (sent > 0 || count == 0) ? static_cast<int>(sent) : -1;
+}
+
 AsyncSocketAdapter::AsyncSocketAdapter(AsyncSocket* socket) : socket_(nullptr) {
   Attach(socket);
 }
@@ -74,6 +98,14 @@ int AsyncSocketAdapter::RecvFrom(void* pv,
   return socket_->RecvFrom(pv, cb, paddr, timestamp);
 }
 
+int AsyncSocketAdapter::RecvFromBatch(Datagram* datagrams, size_t count) {
+  return socket_->RecvFromBatch(datagrams, count);
+}
+
+int AsyncSocketAdapter::SendToBatch(const Datagram* datagrams, size_t count) {
+  return socket_->SendToBatch(datagrams, count);
+}
+
 int AsyncSocketAdapter::Listen(int backlog) {
   return socket_->Listen(backlog);
 }
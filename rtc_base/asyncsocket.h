@@ -26,6 +26,17 @@ class AsyncSocket : public Socket {
 
   AsyncSocket* Accept(SocketAddress* paddr) override = 0;
 
+  // Reads up to |count| datagrams into the caller provided |datagrams|.
+  // Returns the number of datagrams read, or -1 if none could be read, in
+  // which case GetError() tells why. The default implementation calls
+  // RecvFrom() repeatedly; sockets with a cheaper batched read override it.
+  virtual int RecvFromBatch(Datagram* datagrams, size_t count);
+
+  // Sends up to |count| datagrams, stopping at the first one that cannot be
+  // sent. Returns the number of datagrams sent, or -1 if the first one failed.
+  // The default implementation calls SendTo() repeatedly.
+  virtual int SendToBatch(const Datagram* datagrams, size_t count);
+
   // SignalReadEvent and SignalWriteEvent use multi_threaded_local to allow
   // access concurrently from different thread.
   // For example SignalReadEvent::connect will be called in AsyncUDPSocket ctor
@@ -59,6 +70,8 @@ class AsyncSocketAdapter : public AsyncSocket, public sigslot::has_slots<> {
                size_t cb,
                SocketAddress* paddr,
                int64_t* timestamp) override;
+  int RecvFromBatch(Datagram* datagrams, size_t count) override;
+  int SendToBatch(const Datagram* datagrams, size_t count) override;
   int Listen(int backlog) override;
   AsyncSocket* Accept(SocketAddress* paddr) override;
   int Close() override;
@@ -9,13 +9,24 @@
  */
 
 #include "rtc_base/asyncudpsocket.h"
+
+#include <algorithm>
+
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/thread.h"
 
 namespace rtc {
 
 static const int BUF_SIZE = 64 * 1024;
 
+// Limits on the datagrams queued for one coalesced send; reaching either
+// flushes the queue right away.
+static const size_t kMaxPendingSends = 64;
+static const size_t kMaxPendingSendBytes = 64 * 1024;
+
+enum { MSG_FLUSH_PENDING_SENDS };
+
 AsyncUDPSocket* AsyncUDPSocket::Create(AsyncSocket* socket,
                                        const SocketAddress& bind_address) {
   std::unique_ptr<AsyncSocket> owned_socket(socket);
@@ -45,9 +56,40 @@ AsyncUDPSocket::AsyncUDPSocket(AsyncSocket* socket) : socket_(socket) {
 }
 
 AsyncUDPSocket::~AsyncUDPSocket() {
+  // Coalesced sends still waiting for the posted flush would otherwise be
+  // lost. The owner may be half destroyed by now, so don't signal it.
+  SignalSentPacket.disconnect_all();
+  FlushPendingSends();
   delete[] buf_;
 }
 
+void AsyncUDPSocket::SetReceiveBatchSize(size_t max_packets,
+                                         size_t max_packet_size) {
+  RTC_DCHECK_GT(max_packets, 0);
+  RTC_DCHECK_GT(max_packet_size, 0);
+  requested_batch_packets_ = max_packets;
+  requested_batch_packet_size_ = max_packet_size;
+  UpdateReceiveBatch();
+}
+
+void AsyncUDPSocket::UpdateReceiveBatch() {
+  if (requested_batch_packets_ <= 1 && !gro_enabled_) {
+    batch_.clear();
+    batch_buffer_.clear();
+    return;
+  }
+  size_t max_packets = requested_batch_packets_;
+  size_t max_packet_size = requested_batch_packet_size_;
+  if (gro_enabled_)
+    max_packet_size = std::max<size_t>(max_packet_size, BUF_SIZE);
+  batch_buffer_.resize(max_packets * max_packet_size);
+  batch_.resize(max_packets);
+  for (size_t i = 0; i < max_packets; ++i) {
+    batch_[i].data = &batch_buffer_[i * max_packet_size];
+    batch_[i].capacity = max_packet_size;
+  }
+}
+
 SocketAddress AsyncUDPSocket::GetLocalAddress() const {
   return socket_->GetLocalAddress();
 }
@@ -71,6 +113,29 @@ int AsyncUDPSocket::SendTo(const void* pv,
                            size_t cb,
                            const SocketAddress& addr,
                            const rtc::PacketOptions& options) {
+  Thread* current = Thread::Current();
+  if (coalesce_sends_ && current) {
+    // A failed flush is reported by failing the next send, so that the
+    // caller sees the error through GetError() like for any other send.
+    if (pending_send_error_ != 0) {
+      socket_->SetError(pending_send_error_);
+      pending_send_error_ = 0;
+      return -1;
+    }
+    // The datagram is reported as sent now; like any UDP send it may still
+    // get dropped later.
+    pending_sends_.push_back({pending_payload_.size(), cb, addr, options});
+    const char* data = static_cast<const char*>(pv);
+    pending_payload_.insert(pending_payload_.end(), data, data + cb);
+    if (pending_sends_.size() >= kMaxPendingSends ||
+        pending_payload_.size() >= kMaxPendingSendBytes) {
+      FlushPendingSends();
+    } else if (!flush_posted_) {
+      current->Post(RTC_FROM_HERE, this, MSG_FLUSH_PENDING_SENDS);
+      flush_posted_ = true;
+    }
+    return static_cast<int>(cb);
+  }
   rtc::SentPacket sent_packet(options.packet_id, rtc::TimeMillis(),
                               options.info_signaled_after_sent);
   CopySocketInformationToPacketInfo(cb, *this, true, &sent_packet.info);
@@ -79,7 +144,31 @@ int AsyncUDPSocket::SendTo(const void* pv,
   return ret;
 }
 
+int AsyncUDPSocket::SendToBatch(const Datagram* packets,
+                                 const PacketOptions* options,
+                                 size_t count) {
+  // Packets queued by SendTo() go out first, to keep the sending order.
+  FlushPendingSends();
+  return SendBatch(packets, options, count);
+}
+
+int AsyncUDPSocket::SendBatch(const Datagram* packets,
+                              const PacketOptions* options,
+                              size_t count) {
+  int64_t send_time_ms = rtc::TimeMillis();
+  int ret = socket_->SendToBatch(packets, count);
+  for (int i = 0; i < ret; ++i) {
+    rtc::SentPacket sent_packet(options[i].packet_id, send_time_ms,
+                                options[i].info_signaled_after_sent);
+    CopySocketInformationToPacketInfo(packets[i].size, *this, true,
+                                      &sent_packet.info);
+    SignalSentPacket(this, sent_packet);
+  }
+  return ret;
+}
+
 int AsyncUDPSocket::Close() {
+  FlushPendingSends();
   return socket_->Close();
 }
 
@@ -92,7 +181,18 @@ int AsyncUDPSocket::GetOption(Socket::Option opt, int* value) {
 }
 
 int AsyncUDPSocket::SetOption(Socket::Option opt, int value) {
-  return socket_->SetOption(opt, value);
+  int ret = socket_->SetOption(opt, value);
+  if (ret != 0)
+    return ret;
+  if (opt == Socket::OPT_UDP_SEGMENTATION) {
+    if (!value)
+      FlushPendingSends();
+    coalesce_sends_ = (value != 0);
+  } else if (opt == Socket::OPT_UDP_GRO) {
+    gro_enabled_ = (value != 0);
+    UpdateReceiveBatch();
+  }
+  return ret;
 }
 
 int AsyncUDPSocket::GetError() const {
@@ -106,6 +206,11 @@ void AsyncUDPSocket::SetError(int error) {
 void AsyncUDPSocket::OnReadEvent(AsyncSocket* socket) {
   RTC_DCHECK(socket_.get() == socket);
 
+  if (!batch_.empty()) {
+    ReadBatch();
+    return;
+  }
+
   SocketAddress remote_addr;
   int64_t timestamp;
   int len = socket_->RecvFrom(buf_, size_, &remote_addr, &timestamp);
@@ -126,8 +231,96 @@ void AsyncUDPSocket::OnReadEvent(AsyncSocket* socket) {
                    (timestamp > -1 ? timestamp : TimeMicros()));
 }
 
+void AsyncUDPSocket::ReadBatch() {
+  int count = socket_->RecvFromBatch(batch_.data(), batch_.size());
+  if (count < 0) {
+    // See OnReadEvent for why errors are only logged.
+    SocketAddress local_addr = socket_->GetLocalAddress();
+    RTC_LOG(LS_INFO) << "AsyncUDPSocket[" << local_addr.ToSensitiveString()
+                     << "] batched receive failed with error "
+                     << socket_->GetError();
+    return;
+  }
+
+  int64_t now_us = TimeMicros();
+  bool coalesced = false;
+  for (int i = 0; i < count; ++i) {
+    if (batch_[i].timestamp < 0)
+      batch_[i].timestamp = now_us;
+    coalesced |= (batch_[i].segment_size > 0);
+  }
+
+  const Datagram* packets = batch_.data();
+  size_t num_packets = static_cast<size_t>(count);
+  if (coalesced) {
+    // Split GRO trains back into the datagrams the sender sent.
+    segments_.clear();
+    for (int i = 0; i < count; ++i) {
+      const Datagram& datagram = batch_[i];
+      if (datagram.segment_size == 0) {
+        segments_.push_back(datagram);
+        continue;
+      }
+      for (size_t offset = 0; offset < datagram.size;
+           offset += datagram.segment_size) {
+        Datagram segment;
+        segment.data = datagram.data + offset;
+        segment.size = std::min(datagram.segment_size, datagram.size - offset);
+        segment.capacity = segment.size;
+        segment.addr = datagram.addr;
+        segment.timestamp = datagram.timestamp;
+        segments_.push_back(segment);
+      }
+    }
+    packets = segments_.data();
+    num_packets = segments_.size();
+  }
+
+  if (!SignalReadPackets.is_empty()) {
+    SignalReadPackets(this, packets, num_packets);
+    return;
+  }
+  for (size_t i = 0; i < num_packets; ++i) {
+    SignalReadPacket(this, packets[i].data, packets[i].size, packets[i].addr,
+                     packets[i].timestamp);
+  }
+}
+
 void AsyncUDPSocket::OnWriteEvent(AsyncSocket* socket) {
   SignalReadyToSend(this);
 }
 
+void AsyncUDPSocket::OnMessage(Message* msg) {
+  RTC_DCHECK_EQ(MSG_FLUSH_PENDING_SENDS, msg->message_id);
+  flush_posted_ = false;
+  FlushPendingSends();
+}
+
+void AsyncUDPSocket::FlushPendingSends() {
+  if (pending_sends_.empty())
+    return;
+  send_batch_.resize(pending_sends_.size());
+  send_options_.clear();
+  for (size_t i = 0; i < pending_sends_.size(); ++i) {
+    PendingSend& pending = pending_sends_[i];
+    send_batch_[i].data = &pending_payload_[pending.offset];
+    send_batch_[i].size = pending.size;
+    send_batch_[i].addr = pending.addr;
+    send_options_.push_back(std::move(pending.options));
+  }
+  int sent = SendBatch(send_batch_.data(), send_options_.data(),
+                       send_batch_.size());
+  if (sent < static_cast<int>(send_batch_.size())) {
+    // The packets were already reported as sent, and didn't get a
+    // SignalSentPacket. Keep the error for the next SendTo().
+    pending_send_error_ = socket_->GetError();
+    RTC_LOG(LS_WARNING) << "AsyncUDPSocket["
+                        << GetLocalAddress().ToSensitiveString() << "] dropped "
+                        << send_batch_.size() - std::max(sent, 0)
+                        << " coalesced packets, error " << pending_send_error_;
+  }
+  pending_sends_.clear();
+  pending_payload_.clear();
+}
+
 }  // namespace rtc
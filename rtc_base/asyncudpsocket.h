@@ -13,9 +13,11 @@
 
 #include <stddef.h>
 #include <memory>
+#include <vector>
 
 #include "rtc_base/asyncpacketsocket.h"
 #include "rtc_base/asyncsocket.h"
+#include "rtc_base/messagehandler.h"
 #include "rtc_base/socket.h"
 #include "rtc_base/socketaddress.h"
 #include "rtc_base/socketfactory.h"
@@ -24,7 +26,15 @@ namespace rtc {
 
 // Provides the ability to receive packets asynchronously.  Sends are not
 // buffered since it is acceptable to drop packets under high load.
-class AsyncUDPSocket : public AsyncPacketSocket {
+//
+// Setting Socket::OPT_UDP_SEGMENTATION is the exception: SendTo() then
+// queues datagrams and hands them to the socket in one batch once the current
+// thread has handled the messages already posted to it (typically the rest of
+// a pacer burst), so that the socket can use segmentation offload. If that
+// send fails, the next SendTo() fails with its error. Setting
+// Socket::OPT_UDP_GRO moves reads to the batched path with slots large
+// enough for coalesced datagrams, which are split up again before delivery.
+class AsyncUDPSocket : public AsyncPacketSocket, public MessageHandler {
  public:
   // Binds |socket| and creates AsyncUDPSocket for it. Takes ownership
   // of |socket|. Returns null if bind() fails (|socket| is destroyed
@@ -38,6 +48,20 @@ class AsyncUDPSocket : public AsyncPacketSocket {
   explicit AsyncUDPSocket(AsyncSocket* socket);
   ~AsyncUDPSocket() override;
 
+  // Slot size used for batched reads unless specified; large enough for any
+  // datagram that fits in an Ethernet frame.
+  static const size_t kDefaultBatchPacketSize = 2048;
+
+  // Enables batched reads: every read event drains up to |max_packets|
+  // datagrams from the socket with one AsyncSocket::RecvFromBatch call and
+  // delivers them through SignalReadPackets (or SignalReadPacket when
+  // nothing listens to the batch signal). Each datagram gets a
+  // |max_packet_size| byte slot; longer datagrams are truncated. Passing 1
+  // restores the default one-datagram-per-event behavior. While OPT_UDP_GRO
+  // is set, slots are at least 64 KB.
+  void SetReceiveBatchSize(size_t max_packets,
+                           size_t max_packet_size = kDefaultBatchPacketSize);
+
   SocketAddress GetLocalAddress() const override;
   SocketAddress GetRemoteAddress() const override;
   int Send(const void* pv,
@@ -47,6 +71,9 @@ class AsyncUDPSocket : public AsyncPacketSocket {
              size_t cb,
              const SocketAddress& addr,
              const rtc::PacketOptions& options) override;
+  int SendToBatch(const Datagram* packets,
+                  const PacketOptions* options,
+                  size_t count) override;
   int Close() override;
 
   State GetState() const override;
@@ -58,12 +85,50 @@ class AsyncUDPSocket : public AsyncPacketSocket {
  private:
   // Called when the underlying socket is ready to be read from.
   void OnReadEvent(AsyncSocket* socket);
+  // Called from OnReadEvent when batched reads are enabled.
+  void ReadBatch();
   // Called when the underlying socket is ready to send.
   void OnWriteEvent(AsyncSocket* socket);
+  // Sends the datagrams queued by SendTo() while OPT_UDP_SEGMENTATION is set.
+  void OnMessage(Message* msg) override;
+  // Sends the queued datagrams. A failure makes the next SendTo() fail with
+  // the error, since the queued datagrams were already reported as sent.
+  void FlushPendingSends();
+  // Sends |packets| right away and signals those sent.
+  int SendBatch(const Datagram* packets,
+                const PacketOptions* options,
+                size_t count);
+  // (Re)allocates |batch_| for the requested batch size and GRO state.
+  void UpdateReceiveBatch();
+
+  struct PendingSend {
+    size_t offset;  // Into |pending_payload_|.
+    size_t size;
+    SocketAddress addr;
+    PacketOptions options;
+  };
 
   std::unique_ptr<AsyncSocket> socket_;
   char* buf_;
   size_t size_;
+  // Slots for batched reads, all backed by |batch_buffer_|. Empty unless
+  // SetReceiveBatchSize() was called with more than one packet or GRO is on.
+  std::vector<Datagram> batch_;
+  std::vector<char> batch_buffer_;
+  size_t requested_batch_packets_ = 1;
+  size_t requested_batch_packet_size_ = kDefaultBatchPacketSize;
+  bool gro_enabled_ = false;
+  // Scratch space for delivering GRO coalesced datagrams one by one.
+  std::vector<Datagram> segments_;
+
+  bool coalesce_sends_ = false;
+  bool flush_posted_ = false;
+  // Error of the last flush of queued datagrams, until SendTo() reports it.
+  int pending_send_error_ = 0;
+  std::vector<char> pending_payload_;
+  std::vector<PendingSend> pending_sends_;
+  std::vector<Datagram> send_batch_;
+  std::vector<PacketOptions> send_options_;
 };
 
 }  // namespace rtc
@@ -0,0 +1,218 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "rtc_base/asyncudpsocket.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/physicalsocketserver.h"
+#include "rtc_base/strings/string_builder.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/timeutils.h"
+#include "rtc_base/virtualsocketserver.h"
+#include "test/testsupport/perf_test.h"
+
+namespace rtc {
+namespace {
+
+const size_t kPacketSize = 200;
+const size_t kBurstSize = 32;
+const size_t kNumPackets = 200000;
+const int64_t kMaxRunTimeMs = 30000;
+
+class PacketCounter : public sigslot::has_slots<> {
+ public:
+  void OnReadPacket(AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const SocketAddress& remote_addr,
+                    const int64_t& packet_time_us) {
+    ++packets_;
+  }
+  void OnReadPackets(AsyncPacketSocket* socket,
+                     const Datagram* packets,
+                     size_t count) {
+    packets_ += count;
+  }
+  size_t packets() const { return packets_; }
+
+ private:
+  size_t packets_ = 0;
+};
+
+// Pumps |kNumPackets| datagrams from |sender| to |receiver| in bursts of
+// |kBurstSize|, calling |process| after every burst, and reports the number
+// of packets handled per second of CPU time on the (single) test thread.
+template <typename ProcessFunction>
+void RunUdpThroughputTest(const std::string& trace,
+                          SocketFactory* factory,
+                          size_t receive_batch_size,
+                          bool batched_send,
+                          ProcessFunction process) {
+  std::unique_ptr<AsyncUDPSocket> sender(
+      AsyncUDPSocket::Create(factory, SocketAddress(INADDR_LOOPBACK, 0)));
+  std::unique_ptr<AsyncUDPSocket> receiver(
+      AsyncUDPSocket::Create(factory, SocketAddress(INADDR_LOOPBACK, 0)));
+  ASSERT_TRUE(sender);
+  ASSERT_TRUE(receiver);
+  receiver->SetOption(Socket::OPT_RCVBUF, 4 * 1024 * 1024);
+  receiver->SetReceiveBatchSize(receive_batch_size);
+  PacketCounter counter;
+  if (receive_batch_size > 1) {
+    receiver->SignalReadPackets.connect(&counter,
+                                        &PacketCounter::OnReadPackets);
+  } else {
+    receiver->SignalReadPacket.connect(&counter, &PacketCounter::OnReadPacket);
+  }
+
+  std::vector<char> payload(kBurstSize * kPacketSize, 'x');
+  std::vector<Datagram> burst(kBurstSize);
+  std::vector<PacketOptions> options(kBurstSize);
+  for (size_t i = 0; i < kBurstSize; ++i) {
+    burst[i].data = &payload[i * kPacketSize];
+    burst[i].size = kPacketSize;
+    burst[i].addr = receiver->GetLocalAddress();
+  }
+
+  const int64_t start_cpu_ns = GetThreadCpuTimeNanos();
+  const int64_t deadline_ms = TimeMillis() + kMaxRunTimeMs;
+  size_t sent = 0;
+  while (sent < kNumPackets && TimeMillis() < deadline_ms) {
+    if (batched_send) {
+      int result = sender->SendToBatch(burst.data(), options.data(),
+                                       burst.size());
+      sent += result > 0 ? result : 0;
+    } else {
+      for (const Datagram& packet : burst) {
+        if (sender->SendTo(packet.data, packet.size, packet.addr,
+                           options[0]) > 0) {
+          ++sent;
+        }
+      }
+    }
+    // Drain before the next burst so the kernel never has to drop packets.
+    while (counter.packets() < sent && TimeMillis() < deadline_ms)
+      process();
+  }
+  const int64_t cpu_ns = GetThreadCpuTimeNanos() - start_cpu_ns;
+
+  EXPECT_EQ(sent, counter.packets());
+  ASSERT_GT(cpu_ns, 0);
+  webrtc::test::PrintResult(
+      "udp_packets_per_cpu_second", "", trace,
+      counter.packets() * static_cast<double>(kNumNanosecsPerSec) / cpu_ns,
+      "packets/s", true);
+}
+
+std::string TraceName(size_t receive_batch_size, bool batched_send) {
+  rtc::StringBuilder sb;
+  sb << "recv_batch_" << receive_batch_size
+     << (batched_send ? "_send_batch" : "_send_single");
+  return sb.str();
+}
+
+}  // namespace
+
+class AsyncUdpSocketPerformanceTest
+    : public testing::TestWithParam<std::tuple<size_t, bool>> {};
+
+TEST_P(AsyncUdpSocketPerformanceTest, Loopback) {
+  const size_t receive_batch_size = std::get<0>(GetParam());
+  const bool batched_send = std::get<1>(GetParam());
+  PhysicalSocketServer pss;
+  AutoSocketServerThread thread(&pss);
+  RunUdpThroughputTest(
+      "loopback_" + TraceName(receive_batch_size, batched_send), &pss,
+      receive_batch_size, batched_send,
+      [&thread] { thread.ProcessMessages(0); });
+}
+
+TEST_P(AsyncUdpSocketPerformanceTest, VirtualSocketServer) {
+  const size_t receive_batch_size = std::get<0>(GetParam());
+  const bool batched_send = std::get<1>(GetParam());
+  VirtualSocketServer vss;
+  AutoSocketServerThread thread(&vss);
+  RunUdpThroughputTest(
+      "virtual_" + TraceName(receive_batch_size, batched_send), &vss,
+      receive_batch_size, batched_send,
+      [&vss] { vss.ProcessMessagesUntilIdle(); });
+}
+
+// Sends pacer-like bursts of MTU sized packets through SendTo() and reports
+// the CPU time spent per Mbit, with UDP segmentation offload (GSO on the
+// sender, GRO on the receiver) on and off.
+class AsyncUdpSocketOffloadPerformanceTest
+    : public testing::TestWithParam<bool> {};
+
+TEST_P(AsyncUdpSocketOffloadPerformanceTest, Loopback) {
+  const bool offload = GetParam();
+  const size_t kMediaPacketSize = 1200;
+  const size_t kPacketsPerBurst = 10;
+  const size_t kNumBursts = 20000;
+
+  PhysicalSocketServer pss;
+  AutoSocketServerThread thread(&pss);
+  std::unique_ptr<AsyncUDPSocket> sender(
+      AsyncUDPSocket::Create(&pss, SocketAddress(INADDR_LOOPBACK, 0)));
+  std::unique_ptr<AsyncUDPSocket> receiver(
+      AsyncUDPSocket::Create(&pss, SocketAddress(INADDR_LOOPBACK, 0)));
+  ASSERT_TRUE(sender);
+  ASSERT_TRUE(receiver);
+  receiver->SetOption(Socket::OPT_RCVBUF, 4 * 1024 * 1024);
+  receiver->SetReceiveBatchSize(kPacketsPerBurst);
+  if (offload && (sender->SetOption(Socket::OPT_UDP_SEGMENTATION, 1) != 0 ||
+                  receiver->SetOption(Socket::OPT_UDP_GRO, 1) != 0)) {
+    RTC_LOG(LS_INFO) << "No UDP segmentation offload... skipping";
+    return;
+  }
+  PacketCounter counter;
+  receiver->SignalReadPackets.connect(&counter, &PacketCounter::OnReadPackets);
+
+  std::vector<char> payload(kMediaPacketSize, 'x');
+  const int64_t start_cpu_ns = GetThreadCpuTimeNanos();
+  const int64_t deadline_ms = TimeMillis() + kMaxRunTimeMs;
+  size_t sent = 0;
+  for (size_t burst = 0; burst < kNumBursts && TimeMillis() < deadline_ms;
+       ++burst) {
+    for (size_t i = 0; i < kPacketsPerBurst; ++i) {
+      if (sender->SendTo(payload.data(), payload.size(),
+                         receiver->GetLocalAddress(), PacketOptions()) > 0) {
+        ++sent;
+      }
+    }
+    while (counter.packets() < sent && TimeMillis() < deadline_ms)
+      thread.ProcessMessages(0);
+  }
+  const int64_t cpu_ns = GetThreadCpuTimeNanos() - start_cpu_ns;
+
+  EXPECT_EQ(sent, counter.packets());
+  const double mbits = counter.packets() * kMediaPacketSize * 8 / 1e6;
+  ASSERT_GT(mbits, 0);
+  webrtc::test::PrintResult(
+      "udp_cpu_time_per_mbit", "", offload ? "gso_gro" : "no_offload",
+      cpu_ns / static_cast<double>(kNumNanosecsPerMicrosec) / mbits, "us",
+      true);
+}
+
+INSTANTIATE_TEST_CASE_P(OffloadOnOff,
+                        AsyncUdpSocketOffloadPerformanceTest,
+                        ::testing::Bool());
+
+INSTANTIATE_TEST_CASE_P(BatchSizes,
+                        AsyncUdpSocketPerformanceTest,
+                        ::testing::Combine(::testing::Values(1, 8, 32),
+                                           ::testing::Bool()));
+
+}  // namespace rtc
@@ -13,17 +13,39 @@
 
 #include "rtc_base/asyncudpsocket.h"
 #include "rtc_base/gunit.h"
+#include "rtc_base/logging.h"
 #include "rtc_base/physicalsocketserver.h"
+#include "rtc_base/thread.h"
 #include "rtc_base/virtualsocketserver.h"
 
 namespace rtc {
 
+static const int kTimeoutMs = 5000;
+
+// Claims to support segmentation offload, and fails every batched send.
+class FailingSegmentationSocket : public AsyncSocketAdapter {
+ public:
+  explicit FailingSegmentationSocket(AsyncSocket* socket)
+      : AsyncSocketAdapter(socket) {}
+
+  int SetOption(Option opt, int value) override {
+    if (opt == OPT_UDP_SEGMENTATION)
+      return 0;
+    return AsyncSocketAdapter::SetOption(opt, value);
+  }
+
+  int SendToBatch(const Datagram* datagrams, size_t count) override {
+    SetError(EMSGSIZE);
+    return -1;
+  }
+};
+
 class AsyncUdpSocketTest : public testing::Test, public sigslot::has_slots<> {
  public:
   AsyncUdpSocketTest()
       : pss_(new rtc::PhysicalSocketServer),
-        vss_(new rtc::VirtualSocketServer(pss_.get())),
-        socket_(vss_->CreateAsyncSocket(SOCK_DGRAM)),
+        vss_(new rtc::VirtualSocketServer()),
+        socket_(vss_->CreateAsyncSocket(AF_INET, SOCK_DGRAM)),
         udp_socket_(new AsyncUDPSocket(socket_)),
         ready_to_send_(false) {
     udp_socket_->SignalReadyToSend.connect(this,
@@ -32,12 +54,48 @@ class AsyncUdpSocketTest : public testing::Test, public sigslot::has_slots<> {
 
   void OnReadyToSend(rtc::AsyncPacketSocket* socket) { ready_to_send_ = true; }
 
+  void OnReadPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const SocketAddress& remote_addr,
+                    const int64_t& packet_time_us) {
+    ++packets_received_;
+    bytes_received_ += size;
+  }
+
+  void OnSentPacket(rtc::AsyncPacketSocket* socket,
+                    const rtc::SentPacket& sent_packet) {
+    ++packets_sent_;
+  }
+
+  void OnReadPackets(rtc::AsyncPacketSocket* socket,
+                     const Datagram* packets,
+                     size_t count) {
+    ++batches_received_;
+    packets_received_ += count;
+  }
+
+  // Sends |count| one byte datagrams to |dest| from a fresh loopback socket.
+  void SendPackets(const SocketAddress& dest, size_t count) {
+    std::unique_ptr<AsyncSocket> sender(
+        pss_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+    ASSERT_EQ(0, sender->Bind(SocketAddress(INADDR_LOOPBACK, 0)));
+    for (size_t i = 0; i < count; ++i) {
+      char data = static_cast<char>(i);
+      EXPECT_EQ(1, sender->SendTo(&data, 1, dest));
+    }
+  }
+
  protected:
   std::unique_ptr<PhysicalSocketServer> pss_;
   std::unique_ptr<VirtualSocketServer> vss_;
   AsyncSocket* socket_;
   std::unique_ptr<AsyncUDPSocket> udp_socket_;
   bool ready_to_send_;
+  size_t packets_received_ = 0;
+  size_t bytes_received_ = 0;
+  int batches_received_ = 0;
+  size_t packets_sent_ = 0;
 };
 
 TEST_F(AsyncUdpSocketTest, OnWriteEvent) {
@@ -46,4 +104,125 @@ TEST_F(AsyncUdpSocketTest, OnWriteEvent) {
   EXPECT_TRUE(ready_to_send_);
 }
 
+TEST_F(AsyncUdpSocketTest, BatchedReadDrainsPendingPackets) {
+  AutoSocketServerThread thread(pss_.get());
+  std::unique_ptr<AsyncUDPSocket> receiver(AsyncUDPSocket::Create(
+      pss_.get(), SocketAddress(INADDR_LOOPBACK, 0)));
+  ASSERT_TRUE(receiver);
+  receiver->SetReceiveBatchSize(8);
+  receiver->SignalReadPackets.connect(static_cast<AsyncUdpSocketTest*>(this),
+                                      &AsyncUdpSocketTest::OnReadPackets);
+
+  // All packets are queued before the socket server gets to run, so a single
+  // read event picks all of them up.
+  SendPackets(receiver->GetLocalAddress(), 3);
+  EXPECT_EQ_WAIT(3u, packets_received_, kTimeoutMs);
+  EXPECT_EQ(1, batches_received_);
+}
+
+TEST_F(AsyncUdpSocketTest, BatchedReadFallsBackToSignalReadPacket) {
+  AutoSocketServerThread thread(pss_.get());
+  std::unique_ptr<AsyncUDPSocket> receiver(AsyncUDPSocket::Create(
+      pss_.get(), SocketAddress(INADDR_LOOPBACK, 0)));
+  ASSERT_TRUE(receiver);
+  receiver->SetReceiveBatchSize(8);
+  receiver->SignalReadPacket.connect(static_cast<AsyncUdpSocketTest*>(this),
+                                     &AsyncUdpSocketTest::OnReadPacket);
+
+  SendPackets(receiver->GetLocalAddress(), 3);
+  EXPECT_EQ_WAIT(3u, packets_received_, kTimeoutMs);
+  EXPECT_EQ(0, batches_received_);
+}
+
+TEST_F(AsyncUdpSocketTest, SegmentationOffloadRoundTrip) {
+  AutoSocketServerThread thread(pss_.get());
+  std::unique_ptr<AsyncUDPSocket> sender(AsyncUDPSocket::Create(
+      pss_.get(), SocketAddress(INADDR_LOOPBACK, 0)));
+  std::unique_ptr<AsyncUDPSocket> receiver(AsyncUDPSocket::Create(
+      pss_.get(), SocketAddress(INADDR_LOOPBACK, 0)));
+  ASSERT_TRUE(sender);
+  ASSERT_TRUE(receiver);
+  if (sender->SetOption(Socket::OPT_UDP_SEGMENTATION, 1) != 0 ||
+      receiver->SetOption(Socket::OPT_UDP_GRO, 1) != 0) {
+    RTC_LOG(LS_INFO) << "No UDP segmentation offload... skipping";
+    return;
+  }
+  sender->SignalSentPacket.connect(static_cast<AsyncUdpSocketTest*>(this),
+                                   &AsyncUdpSocketTest::OnSentPacket);
+  receiver->SignalReadPacket.connect(static_cast<AsyncUdpSocketTest*>(this),
+                                     &AsyncUdpSocketTest::OnReadPacket);
+
+  // Sends are queued until the thread gets to process messages, then go out
+  // as one segmented send and get split up again on the receiving side.
+  const size_t kNumPackets = 4;
+  const size_t kPacketSize = 100;
+  char payload[kPacketSize] = {0};
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    EXPECT_EQ(static_cast<int>(kPacketSize),
+              sender->SendTo(payload, kPacketSize, receiver->GetLocalAddress(),
+                             PacketOptions()));
+  }
+  EXPECT_EQ(0u, packets_sent_);
+  EXPECT_EQ_WAIT(kNumPackets, packets_received_, kTimeoutMs);
+  EXPECT_EQ(kNumPackets * kPacketSize, bytes_received_);
+  EXPECT_EQ(kNumPackets, packets_sent_);
+}
+
+TEST_F(AsyncUdpSocketTest, SegmentationOffloadFlushesOnDestruction) {
+  AutoSocketServerThread thread(pss_.get());
+  std::unique_ptr<AsyncUDPSocket> sender(AsyncUDPSocket::Create(
+      pss_.get(), SocketAddress(INADDR_LOOPBACK, 0)));
+  std::unique_ptr<AsyncUDPSocket> receiver(AsyncUDPSocket::Create(
+      pss_.get(), SocketAddress(INADDR_LOOPBACK, 0)));
+  ASSERT_TRUE(sender);
+  ASSERT_TRUE(receiver);
+  if (sender->SetOption(Socket::OPT_UDP_SEGMENTATION, 1) != 0) {
+    RTC_LOG(LS_INFO) << "No UDP segmentation offload... skipping";
+    return;
+  }
+  receiver->SignalReadPacket.connect(static_cast<AsyncUdpSocketTest*>(this),
+                                     &AsyncUdpSocketTest::OnReadPacket);
+
+  const size_t kNumPackets = 4;
+  const size_t kPacketSize = 100;
+  char payload[kPacketSize] = {0};
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    EXPECT_EQ(static_cast<int>(kPacketSize),
+              sender->SendTo(payload, kPacketSize, receiver->GetLocalAddress(),
+                             PacketOptions()));
+  }
+  // Destroying the socket before the posted flush runs still sends the
+  // queued packets.
+  sender.reset();
+  EXPECT_EQ_WAIT(kNumPackets, packets_received_, kTimeoutMs);
+}
+
+TEST_F(AsyncUdpSocketTest, SegmentationOffloadReportsFailedFlush) {
+  AutoSocketServerThread thread(vss_.get());
+  FailingSegmentationSocket* socket = new FailingSegmentationSocket(
+      vss_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, socket->Bind(SocketAddress(INADDR_LOOPBACK, 0)));
+  AsyncUDPSocket sender(socket);
+  ASSERT_EQ(0, sender.SetOption(Socket::OPT_UDP_SEGMENTATION, 1));
+  sender.SignalSentPacket.connect(static_cast<AsyncUdpSocketTest*>(this),
+                                  &AsyncUdpSocketTest::OnSentPacket);
+
+  const SocketAddress dest(INADDR_LOOPBACK, 5000);
+  const size_t kPacketSize = 100;
+  char payload[kPacketSize] = {0};
+  EXPECT_EQ(static_cast<int>(kPacketSize),
+            sender.SendTo(payload, kPacketSize, dest, PacketOptions()));
+  EXPECT_EQ(static_cast<int>(kPacketSize),
+            sender.SendTo(payload, kPacketSize, dest, PacketOptions()));
+  // Runs the posted flush, which fails.
+  thread.ProcessMessages(0);
+  EXPECT_EQ(0u, packets_sent_);
+
+  // The error surfaces on the next send, once.
+  EXPECT_EQ(-1, sender.SendTo(payload, kPacketSize, dest, PacketOptions()));
+  EXPECT_EQ(EMSGSIZE, sender.GetError());
+  EXPECT_EQ(static_cast<int>(kPacketSize),
+            sender.SendTo(payload, kPacketSize, dest, PacketOptions()));
+}
+
 }  // namespace rtc
@@ -0,0 +1,161 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/copyonwritebufferpool.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/refcount.h"
+#include "rtc_base/refcountedobject.h"
+
+namespace rtc {
+
+// Unused buffers of a pool. Shared between the pool and all buffers it has
+// handed out, since buffers may be released after the pool is destroyed.
+class CopyOnWriteBufferPool::FreeList : public RefCountInterface {
+ public:
+  FreeList(size_t buffer_capacity, size_t max_free_buffers)
+      : buffer_capacity_(buffer_capacity),
+        max_free_buffers_(max_free_buffers) {}
+
+  // Returns an unused buffer, or null if there is none.
+  PooledBuffer* Get();
+  // Takes back |buffer|, which is no longer referenced. Returns false if the
+  // buffer isn't kept, in which case the caller deletes it.
+  bool Return(PooledBuffer* buffer);
+  // Deletes all unused buffers and stops taking buffers back.
+  void Close();
+
+  size_t NumBuffersInUse() const;
+  size_t NumFreeBuffers() const;
+
+ protected:
+  ~FreeList() override { RTC_DCHECK(buffers_.empty()); }
+
+ private:
+  const size_t buffer_capacity_;
+  const size_t max_free_buffers_;
+  CriticalSection crit_;
+  std::vector<PooledBuffer*> buffers_ RTC_GUARDED_BY(crit_);
+  size_t num_in_use_ RTC_GUARDED_BY(crit_) = 0;
+  bool closed_ RTC_GUARDED_BY(crit_) = false;
+};
+
+// A buffer that is handed back to its pool instead of being deleted when the
+// last reference to it is released.
+class CopyOnWriteBufferPool::PooledBuffer : public RefCountedObject<Buffer> {
+ public:
+  PooledBuffer(size_t capacity, scoped_refptr<FreeList> free_list)
+      : RefCountedObject<Buffer>(size_t{0}, capacity),
+        free_list_(std::move(free_list)) {}
+
+  RefCountReleaseStatus Release() const override {
+    const auto status = ref_count_.DecRef();
+    if (status == RefCountReleaseStatus::kDroppedLastRef) {
+      PooledBuffer* buffer = const_cast<PooledBuffer*>(this);
+      if (!free_list_->Return(buffer))
+        buffer->Delete();
+    }
+    return status;
+  }
+
+  void Delete() { delete this; }
+
+ private:
+  ~PooledBuffer() override {}
+
+  const scoped_refptr<FreeList> free_list_;
+};
+
+CopyOnWriteBufferPool::PooledBuffer* CopyOnWriteBufferPool::FreeList::Get() {
+  CritScope lock(&crit_);
+  ++num_in_use_;
+  if (buffers_.empty())
+    return nullptr;
+  PooledBuffer* buffer = buffers_.back();
+  buffers_.pop_back();
+  return buffer;
+}
+
+bool CopyOnWriteBufferPool::FreeList::Return(PooledBuffer* buffer) {
+  CritScope lock(&crit_);
+  RTC_DCHECK_GT(num_in_use_, 0);
+  --num_in_use_;
+  // Buffers that have been grown past the pool capacity are not reused, to
+  // keep the memory held by the pool bounded.
+  if (closed_ || buffers_.size() >= max_free_buffers_ ||
+      buffer->capacity() != buffer_capacity_) {
+    return false;
+  }
+  buffers_.push_back(buffer);
+  return true;
+}
+
+void CopyOnWriteBufferPool::FreeList::Close() {
+  std::vector<PooledBuffer*> buffers;
+  {
+    CritScope lock(&crit_);
+    closed_ = true;
+    buffers.swap(buffers_);
+  }
+  // Deleting a buffer releases its reference to this list, so it can't be
+  // done while holding the lock.
+  for (PooledBuffer* buffer : buffers)
+    buffer->Delete();
+}
+
+size_t CopyOnWriteBufferPool::FreeList::NumBuffersInUse() const {
+  CritScope lock(&crit_);
+  return num_in_use_;
+}
+
+size_t CopyOnWriteBufferPool::FreeList::NumFreeBuffers() const {
+  CritScope lock(&crit_);
+  return buffers_.size();
+}
+
+CopyOnWriteBufferPool::CopyOnWriteBufferPool(size_t buffer_capacity,
+                                             size_t max_free_buffers)
+    : buffer_capacity_(buffer_capacity),
+      free_list_(new RefCountedObject<FreeList>(buffer_capacity,
+                                                max_free_buffers)) {
+  RTC_DCHECK_GT(buffer_capacity, 0);
+}
+
+CopyOnWriteBufferPool::~CopyOnWriteBufferPool() {
+  free_list_->Close();
+}
+
+CopyOnWriteBuffer CopyOnWriteBufferPool::CreateBuffer(const uint8_t* data,
+                                                      size_t size) {
+  if (size > buffer_capacity_)
+    return CopyOnWriteBuffer(data, size);
+
+  scoped_refptr<RefCountedObject<Buffer>> buffer(free_list_->Get());
+  if (!buffer)
+    buffer = new PooledBuffer(buffer_capacity_, free_list_);
+  RTC_DCHECK(buffer->HasOneRef());
+  buffer->SetData(data, size);
+  return CopyOnWriteBuffer(std::move(buffer));
+}
+
+size_t CopyOnWriteBufferPool::NumBuffersInUse() const {
+  return free_list_->NumBuffersInUse();
+}
+
+size_t CopyOnWriteBufferPool::NumFreeBuffers() const {
+  return free_list_->NumFreeBuffers();
+}
+
+}  // namespace rtc
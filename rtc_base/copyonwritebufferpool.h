@@ -0,0 +1,68 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_COPYONWRITEBUFFERPOOL_H_
+#define RTC_BASE_COPYONWRITEBUFFERPOOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/copyonwritebuffer.h"
+#include "rtc_base/scoped_ref_ptr.h"
+
+namespace rtc {
+
+// Recycles the memory of CopyOnWriteBuffers, for code that creates a buffer
+// of bounded size per packet. A buffer returns to the pool when the last
+// CopyOnWriteBuffer referencing it goes away, which may happen on any thread
+// and after the pool itself has been destroyed.
+//
+// Unlike e.g. I420BufferPool, the pool holds no reference to buffers that are
+// in use, so a buffer handed out can still be written to in place without
+// CopyOnWriteBuffer making a copy of it.
+//
+// CreateBuffer() must not be called concurrently.
+class CopyOnWriteBufferPool {
+ public:
+  // Buffers have room for |buffer_capacity| bytes, and at most
+  // |max_free_buffers| unused buffers are kept around for reuse.
+  CopyOnWriteBufferPool(size_t buffer_capacity, size_t max_free_buffers);
+  ~CopyOnWriteBufferPool();
+
+  // Returns a buffer holding a copy of |data|. Data that doesn't fit in a
+  // pooled buffer gets a regular buffer of its own.
+  CopyOnWriteBuffer CreateBuffer(const uint8_t* data, size_t size);
+  template <typename T,
+            typename std::enable_if<
+                internal::BufferCompat<uint8_t, T>::value>::type* = nullptr>
+  CopyOnWriteBuffer CreateBuffer(const T* data, size_t size) {
+    return CreateBuffer(reinterpret_cast<const uint8_t*>(data), size);
+  }
+
+  // Number of pooled buffers currently referenced by CopyOnWriteBuffers.
+  size_t NumBuffersInUse() const;
+  // Number of unused buffers held for reuse.
+  size_t NumFreeBuffers() const;
+
+ private:
+  class FreeList;
+  class PooledBuffer;
+
+  const size_t buffer_capacity_;
+  const scoped_refptr<FreeList> free_list_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(CopyOnWriteBufferPool);
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_COPYONWRITEBUFFERPOOL_H_
@@ -0,0 +1,114 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+
+#include "rtc_base/copyonwritebufferpool.h"
+#include "rtc_base/gunit.h"
+
+namespace rtc {
+
+namespace {
+
+// clang-format off
+const uint8_t kTestData[] = {0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7,
+                             0x8, 0x9, 0xa, 0xb, 0xc, 0xd, 0xe, 0xf};
+// clang-format on
+
+}  // namespace
+
+TEST(CopyOnWriteBufferPoolTest, ReusesReleasedBuffer) {
+  CopyOnWriteBufferPool pool(64, 4);
+  CopyOnWriteBuffer buf = pool.CreateBuffer(kTestData, sizeof(kTestData));
+  EXPECT_EQ(sizeof(kTestData), buf.size());
+  EXPECT_EQ(64u, buf.capacity());
+  EXPECT_EQ(0, memcmp(buf.cdata(), kTestData, sizeof(kTestData)));
+  EXPECT_EQ(1u, pool.NumBuffersInUse());
+  const uint8_t* data = buf.cdata();
+
+  buf = CopyOnWriteBuffer();
+  EXPECT_EQ(0u, pool.NumBuffersInUse());
+  EXPECT_EQ(1u, pool.NumFreeBuffers());
+
+  buf = pool.CreateBuffer(kTestData, 4);
+  EXPECT_EQ(data, buf.cdata());
+  EXPECT_EQ(4u, buf.size());
+  EXPECT_EQ(0u, pool.NumFreeBuffers());
+}
+
+TEST(CopyOnWriteBufferPoolTest, BufferIsReturnedWhenLastCopyIsReleased) {
+  CopyOnWriteBufferPool pool(64, 4);
+  CopyOnWriteBuffer buf = pool.CreateBuffer(kTestData, sizeof(kTestData));
+  CopyOnWriteBuffer copy = buf;
+  buf = CopyOnWriteBuffer();
+  EXPECT_EQ(1u, pool.NumBuffersInUse());
+  copy = CopyOnWriteBuffer();
+  EXPECT_EQ(0u, pool.NumBuffersInUse());
+  EXPECT_EQ(1u, pool.NumFreeBuffers());
+}
+
+TEST(CopyOnWriteBufferPoolTest, PooledBufferIsWritableInPlace) {
+  // The pool doesn't keep a reference to buffers in use, so writing to the
+  // only reference of a buffer must not copy it.
+  CopyOnWriteBufferPool pool(64, 4);
+  CopyOnWriteBuffer buf = pool.CreateBuffer(kTestData, sizeof(kTestData));
+  const uint8_t* data = buf.cdata();
+  buf.data()[0] = 0xff;
+  EXPECT_EQ(data, buf.cdata());
+  EXPECT_EQ(1u, pool.NumBuffersInUse());
+
+  // A shared buffer is still copied on write.
+  CopyOnWriteBuffer copy = buf;
+  copy.data()[0] = 0;
+  EXPECT_NE(data, copy.cdata());
+  EXPECT_EQ(0xff, buf.cdata()[0]);
+}
+
+TEST(CopyOnWriteBufferPoolTest, LargeDataIsNotPooled) {
+  CopyOnWriteBufferPool pool(8, 4);
+  CopyOnWriteBuffer buf = pool.CreateBuffer(kTestData, sizeof(kTestData));
+  EXPECT_EQ(sizeof(kTestData), buf.size());
+  EXPECT_EQ(0u, pool.NumBuffersInUse());
+  buf = CopyOnWriteBuffer();
+  EXPECT_EQ(0u, pool.NumFreeBuffers());
+}
+
+TEST(CopyOnWriteBufferPoolTest, KeepsAtMostMaxFreeBuffers) {
+  CopyOnWriteBufferPool pool(64, 2);
+  {
+    CopyOnWriteBuffer bufs[] = {pool.CreateBuffer(kTestData, 1),
+                                pool.CreateBuffer(kTestData, 2),
+                                pool.CreateBuffer(kTestData, 3)};
+    EXPECT_EQ(3u, pool.NumBuffersInUse());
+  }
+  EXPECT_EQ(0u, pool.NumBuffersInUse());
+  EXPECT_EQ(2u, pool.NumFreeBuffers());
+}
+
+TEST(CopyOnWriteBufferPoolTest, GrownBufferIsNotReused) {
+  CopyOnWriteBufferPool pool(16, 4);
+  CopyOnWriteBuffer buf = pool.CreateBuffer(kTestData, sizeof(kTestData));
+  buf.EnsureCapacity(32);
+  buf = CopyOnWriteBuffer();
+  EXPECT_EQ(0u, pool.NumFreeBuffers());
+}
+
+TEST(CopyOnWriteBufferPoolTest, BufferMayOutlivePool) {
+  std::unique_ptr<CopyOnWriteBufferPool> pool(
+      new CopyOnWriteBufferPool(64, 4));
+  CopyOnWriteBuffer free_buf = pool->CreateBuffer(kTestData, 1);
+  CopyOnWriteBuffer buf = pool->CreateBuffer(kTestData, sizeof(kTestData));
+  free_buf = CopyOnWriteBuffer();
+  pool.reset();
+  EXPECT_EQ(0, memcmp(buf.cdata(), kTestData, sizeof(kTestData)));
+  buf = CopyOnWriteBuffer();
+}
+
+}  // namespace rtc
@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_LOCK_FREE_SWAP_QUEUE_H_
+#define RTC_BASE_LOCK_FREE_SWAP_QUEUE_H_
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/swap_queue.h"
+#include "rtc_base/system/unused.h"
+
+namespace webrtc {
+
+// Fixed-size queue with the same interface and swap semantics as SwapQueue,
+// but without a lock. Instead, it only allows one producer and one consumer
+// at a time: calls to Insert() must be serialized with each other, and calls
+// to Remove(), Front(), PopFront() and Clear() must be serialized with each
+// other. The producer and the consumer may run concurrently, on different
+// threads, without ever blocking each other.
+//
+// Besides swapping items out with Remove(), the consumer can read the
+// frontmost item in place with Front() and release it with PopFront(), which
+// leaves the item in the queue for the producer to swap its next T with.
+template <typename T, typename QueueItemVerifier = SwapQueueItemVerifier<T>>
+class LockFreeSwapQueue {
+ public:
+  // Creates a queue of size size and fills it with default constructed Ts.
+  explicit LockFreeSwapQueue(size_t size) : queue_(size) {
+    RTC_DCHECK(VerifyQueueSlots());
+  }
+
+  // Same as above and accepts an item verification functor.
+  LockFreeSwapQueue(size_t size, const QueueItemVerifier& queue_item_verifier)
+      : queue_item_verifier_(queue_item_verifier), queue_(size) {
+    RTC_DCHECK(VerifyQueueSlots());
+  }
+
+  // Creates a queue of size size and fills it with copies of prototype.
+  LockFreeSwapQueue(size_t size, const T& prototype)
+      : queue_(size, prototype) {
+    RTC_DCHECK(VerifyQueueSlots());
+  }
+
+  // Same as above and accepts an item verification functor.
+  LockFreeSwapQueue(size_t size,
+                    const T& prototype,
+                    const QueueItemVerifier& queue_item_verifier)
+      : queue_item_verifier_(queue_item_verifier), queue_(size, prototype) {
+    RTC_DCHECK(VerifyQueueSlots());
+  }
+
+  // Drops all items in the queue. Called by the consumer.
+  void Clear() {
+    num_removed_.store(num_inserted_.load(std::memory_order_acquire),
+                       std::memory_order_release);
+  }
+
+  // Inserts a "full" T at the back of the queue by swapping *input with an
+  // "empty" T from the queue.
+  // Returns true if the item was inserted or false if not (the queue was full).
+  // When specified, the T given in *input must pass the ItemVerifier() test.
+  // The contents of *input after the call are then also guaranteed to pass the
+  // ItemVerifier() test.
+  bool Insert(T* input) RTC_WARN_UNUSED_RESULT {
+    RTC_DCHECK(input);
+    RTC_DCHECK(queue_item_verifier_(*input));
+
+    const size_t num_inserted = num_inserted_.load(std::memory_order_relaxed);
+    if (num_inserted - num_removed_.load(std::memory_order_acquire) ==
+        queue_.size()) {
+      return false;
+    }
+
+    using std::swap;
+    swap(*input, queue_[num_inserted % queue_.size()]);
+    num_inserted_.store(num_inserted + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Removes the frontmost "full" T from the queue by swapping it with
+  // the "empty" T in *output.
+  // Returns true if an item could be removed or false if not (the queue was
+  // empty). When specified, The T given in *output must pass the ItemVerifier()
+  // test and the contents of *output after the call are then also guaranteed to
+  // pass the ItemVerifier() test.
+  bool Remove(T* output) RTC_WARN_UNUSED_RESULT {
+    RTC_DCHECK(output);
+    RTC_DCHECK(queue_item_verifier_(*output));
+
+    T* front = Front();
+    if (!front) {
+      return false;
+    }
+
+    using std::swap;
+    swap(*output, *front);
+    PopFront();
+    return true;
+  }
+
+  // Returns the frontmost "full" T, or null if the queue is empty. The item
+  // stays valid, and is not touched by the producer, until PopFront() is
+  // called. The consumer may modify it as long as it still passes the
+  // ItemVerifier() test.
+  T* Front() {
+    const size_t num_removed = num_removed_.load(std::memory_order_relaxed);
+    if (num_removed == num_inserted_.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return &queue_[num_removed % queue_.size()];
+  }
+
+  // Removes the frontmost T, which must exist, from the queue.
+  void PopFront() {
+    const size_t num_removed = num_removed_.load(std::memory_order_relaxed);
+    RTC_DCHECK_NE(num_removed, num_inserted_.load(std::memory_order_acquire));
+    RTC_DCHECK(queue_item_verifier_(queue_[num_removed % queue_.size()]));
+    num_removed_.store(num_removed + 1, std::memory_order_release);
+  }
+
+ private:
+  // Verify that the queue slots complies with the ItemVerifier test.
+  bool VerifyQueueSlots() {
+    for (const auto& v : queue_) {
+      RTC_DCHECK(queue_item_verifier_(v));
+    }
+    return true;
+  }
+
+  QueueItemVerifier queue_item_verifier_;
+
+  // The total number of items inserted and removed. The difference is the
+  // number of items in the queue, and the item with index i lives in
+  // queue_[i % queue_.size()]. Each counter is only written by its own side,
+  // and the release/acquire pairs hand over the slots between the sides.
+  std::atomic<size_t> num_inserted_{0};
+  std::atomic<size_t> num_removed_{0};
+
+  // queue_.size() is constant.
+  std::vector<T> queue_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(LockFreeSwapQueue);
+};
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_LOCK_FREE_SWAP_QUEUE_H_
@@ -0,0 +1,187 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/lock_free_swap_queue.h"
+
+#include <vector>
+
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/thread.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+const size_t kChunkSize = 3;
+
+// Queue item verifier for the vector tests.
+class LengthVerifierFunctor {
+ public:
+  explicit LengthVerifierFunctor(size_t length) : length_(length) {}
+
+  bool operator()(const std::vector<int>& v) const {
+    return v.size() == length_;
+  }
+
+ private:
+  size_t length_;
+};
+
+using VectorQueue = LockFreeSwapQueue<std::vector<int>, LengthVerifierFunctor>;
+
+// Inserts the numbers 0, 1, ... into the queue, kChunkSize at a time,
+// retrying while the queue is full. The thread may get a real-time priority,
+// so it sleeps rather than yields to let the consumer run.
+const size_t kQueueSize = 16;
+const int kNumChunksToTransfer = 4000;
+void ProducerThreadFunc(void* context) {
+  VectorQueue* queue = static_cast<VectorQueue*>(context);
+  std::vector<int> chunk(kChunkSize);
+  for (int i = 0; i < kNumChunksToTransfer; ++i) {
+    for (size_t k = 0; k < kChunkSize; ++k) {
+      chunk[k] = i * kChunkSize + k;
+    }
+    while (!queue->Insert(&chunk)) {
+      rtc::Thread::SleepMs(1);
+    }
+  }
+}
+
+}  // anonymous namespace
+
+TEST(LockFreeSwapQueueTest, BasicOperation) {
+  std::vector<int> i(kChunkSize, 0);
+  LockFreeSwapQueue<std::vector<int>> queue(2, i);
+
+  EXPECT_TRUE(queue.Insert(&i));
+  EXPECT_EQ(i.size(), kChunkSize);
+  EXPECT_TRUE(queue.Insert(&i));
+  EXPECT_EQ(i.size(), kChunkSize);
+  EXPECT_TRUE(queue.Remove(&i));
+  EXPECT_EQ(i.size(), kChunkSize);
+  EXPECT_TRUE(queue.Remove(&i));
+  EXPECT_EQ(i.size(), kChunkSize);
+}
+
+TEST(LockFreeSwapQueueTest, FullQueue) {
+  LockFreeSwapQueue<int> queue(2);
+
+  // Fill, drain and refill the queue, so that the slots wrap around.
+  for (int k = 0; k < 3; ++k) {
+    int i = 0;
+    EXPECT_TRUE(queue.Insert(&i));
+    i = 1;
+    EXPECT_TRUE(queue.Insert(&i));
+
+    // Ensure that the value is not swapped when doing an Insert on a full
+    // queue.
+    i = 2;
+    EXPECT_FALSE(queue.Insert(&i));
+    EXPECT_EQ(i, 2);
+
+    // Ensure that the Insert didn't overwrite anything in the queue.
+    EXPECT_TRUE(queue.Remove(&i));
+    EXPECT_EQ(i, 0);
+    EXPECT_TRUE(queue.Remove(&i));
+    EXPECT_EQ(i, 1);
+    EXPECT_FALSE(queue.Remove(&i));
+  }
+}
+
+TEST(LockFreeSwapQueueTest, Clear) {
+  LockFreeSwapQueue<int> queue(2);
+  int i = 0;
+
+  EXPECT_TRUE(queue.Insert(&i));
+  EXPECT_TRUE(queue.Insert(&i));
+  queue.Clear();
+  EXPECT_FALSE(queue.Remove(&i));
+  EXPECT_EQ(nullptr, queue.Front());
+  EXPECT_TRUE(queue.Insert(&i));
+  EXPECT_TRUE(queue.Insert(&i));
+  EXPECT_FALSE(queue.Insert(&i));
+}
+
+TEST(LockFreeSwapQueueTest, FrontAndPopFront) {
+  LockFreeSwapQueue<int> queue(2);
+  EXPECT_EQ(nullptr, queue.Front());
+
+  int i = 42;
+  EXPECT_TRUE(queue.Insert(&i));
+  i = 43;
+  EXPECT_TRUE(queue.Insert(&i));
+
+  ASSERT_NE(nullptr, queue.Front());
+  EXPECT_EQ(42, *queue.Front());
+  queue.PopFront();
+  ASSERT_NE(nullptr, queue.Front());
+  EXPECT_EQ(43, *queue.Front());
+  queue.PopFront();
+  EXPECT_EQ(nullptr, queue.Front());
+
+  // The popped items are swapped back to the producer on the next inserts.
+  i = 44;
+  EXPECT_TRUE(queue.Insert(&i));
+  EXPECT_EQ(42, i);
+}
+
+TEST(LockFreeSwapQueueTest, ZeroSlotQueue) {
+  LockFreeSwapQueue<int> queue(0);
+  int i = 42;
+  EXPECT_FALSE(queue.Insert(&i));
+  EXPECT_FALSE(queue.Remove(&i));
+  EXPECT_EQ(nullptr, queue.Front());
+  EXPECT_EQ(i, 42);
+}
+
+#if RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
+TEST(LockFreeSwapQueueTest, UnSuccessfulItemVerifyInsert) {
+  std::vector<int> valid_chunk(kChunkSize, 0);
+  std::vector<int> invalid_chunk(kChunkSize - 1, 0);
+  VectorQueue queue(2, valid_chunk, LengthVerifierFunctor(kChunkSize));
+  bool result;
+  EXPECT_DEATH(result = queue.Insert(&invalid_chunk), "");
+}
+#endif
+
+// Moves chunks between two threads, and checks that they arrive in order and
+// intact.
+TEST(LockFreeSwapQueueTest, ProducerAndConsumerThreads) {
+  VectorQueue queue(kQueueSize, std::vector<int>(kChunkSize),
+                    LengthVerifierFunctor(kChunkSize));
+  rtc::PlatformThread producer(&ProducerThreadFunc, &queue, "producer");
+  producer.Start();
+
+  std::vector<int> chunk(kChunkSize);
+  bool received_in_order = true;
+  int num_received = 0;
+  while (num_received < kNumChunksToTransfer) {
+    const bool in_place = num_received % 2 == 0;
+    const std::vector<int>* received = in_place ? queue.Front() : &chunk;
+    if (!received || (!in_place && !queue.Remove(&chunk))) {
+      continue;
+    }
+    for (size_t k = 0; k < kChunkSize; ++k) {
+      received_in_order &=
+          (*received)[k] == static_cast<int>(num_received * kChunkSize + k);
+    }
+    if (in_place) {
+      queue.PopFront();
+    }
+    ++num_received;
+  }
+
+  producer.Stop();
+  EXPECT_TRUE(received_in_order);
+  EXPECT_EQ(nullptr, queue.Front());
+}
+
+}  // namespace webrtc
@@ -66,6 +66,22 @@ typedef void* SockOptArg;
 
 #endif  // WEBRTC_POSIX
 
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+// Batched datagram I/O through recvmmsg(2) and sendmmsg(2).
+#define WEBRTC_USE_MMSG 1
+// UDP segmentation offload, Linux 4.18+ (GSO) and 5.0+ (GRO). Older headers
+// don't have the constants; the kernel rejects them if unsupported.
+#if !defined(SOL_UDP)
+#define SOL_UDP 17
+#endif
+#if !defined(UDP_SEGMENT)
+#define UDP_SEGMENT 103
+#endif
+#if !defined(UDP_GRO)
+#define UDP_GRO 104
+#endif
+#endif
+
 #if defined(WEBRTC_POSIX) && !defined(WEBRTC_MAC) && !defined(__native_client__)
 
 int64_t GetSocketRecvTimestamp(int socket) {
@@ -90,6 +106,15 @@ int64_t GetSocketRecvTimestamp(int socket) {
 typedef char* SockOptArg;
 #endif
 
+#if defined(WEBRTC_USE_MMSG)
+// Upper bound on the datagrams moved by one recvmmsg/sendmmsg call; the
+// per-call bookkeeping arrays live on the stack.
+static const size_t kMaxDatagramBatchSize = 32;
+// Upper bound on the payload of one segmentation offload send; one UDP
+// datagram can't carry more than 64 KB.
+static const size_t kMaxSegmentedSendSize = 60000;
+#endif
+
 #if defined(WEBRTC_USE_EPOLL)
 // POLLRDHUP / EPOLLRDHUP are only defined starting with Linux 2.6.17.
 #if !defined(POLLRDHUP)
@@ -279,6 +304,8 @@ AsyncSocket::ConnState PhysicalSocket::GetState() const {
 }
 
 int PhysicalSocket::GetOption(Option opt, int* value) {
+  if (opt == OPT_UDP_SEGMENTATION || opt == OPT_UDP_GRO)
+    return GetOffloadOption(opt, value);
   int slevel;
   int sopt;
   if (TranslateOption(opt, &slevel, &sopt) == -1)
@@ -294,6 +321,8 @@ int PhysicalSocket::GetOption(Option opt, int* value) {
 }
 
 int PhysicalSocket::SetOption(Option opt, int value) {
+  if (opt == OPT_UDP_SEGMENTATION || opt == OPT_UDP_GRO)
+    return SetOffloadOption(opt, value);
   int slevel;
   int sopt;
   if (TranslateOption(opt, &slevel, &sopt) == -1)
@@ -411,6 +440,171 @@ int PhysicalSocket::RecvFrom(void* buffer,
   return received;
 }
 
+int PhysicalSocket::RecvFromBatch(Datagram* datagrams, size_t count) {
+#if defined(WEBRTC_USE_MMSG)
+  // With GRO even a single slot needs the control messages.
+  if (!udp_ || (count <= 1 && !udp_gro_))
+    return AsyncSocket::RecvFromBatch(datagrams, count);
+  count = std::min(count, kMaxDatagramBatchSize);
+
+  if (!recv_timestamps_enabled_) {
+    // Per-datagram receive times are only available as control messages;
+    // SIOCGSTAMP would only report the time of the last datagram.
+    int value = 1;
+    ::setsockopt(s_, SOL_SOCKET, SO_TIMESTAMP, &value, sizeof(value));
+    recv_timestamps_enabled_ = true;
+  }
+
+  mmsghdr msgs[kMaxDatagramBatchSize];
+  iovec iovs[kMaxDatagramBatchSize];
+  sockaddr_storage addrs[kMaxDatagramBatchSize];
+  union {
+    char buf[CMSG_SPACE(sizeof(timeval)) + CMSG_SPACE(sizeof(int))];
+    cmsghdr align;
+  } control[kMaxDatagramBatchSize];
+  memset(msgs, 0, sizeof(mmsghdr) * count);
+  for (size_t i = 0; i < count; ++i) {
+    iovs[i].iov_base = datagrams[i].data;
+    iovs[i].iov_len = datagrams[i].capacity;
+    msgs[i].msg_hdr.msg_name = &addrs[i];
+    msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    msgs[i].msg_hdr.msg_control = control[i].buf;
+    msgs[i].msg_hdr.msg_controllen = sizeof(control[i].buf);
+  }
+  int received =
+      ::recvmmsg(s_, msgs, static_cast<unsigned int>(count), 0, nullptr);
+  UpdateLastError();
+  for (int i = 0; i < received; ++i) {
+    Datagram& datagram = datagrams[i];
+    datagram.size = msgs[i].msg_len;
+    SocketAddressFromSockAddrStorage(addrs[i], &datagram.addr);
+    datagram.timestamp = -1;
+    datagram.segment_size = 0;
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg;
+         cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg)) {
+      if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMP) {
+        timeval tv;
+        memcpy(&tv, CMSG_DATA(cmsg), sizeof(tv));
+        datagram.timestamp =
+            kNumMicrosecsPerSec * static_cast<int64_t>(tv.tv_sec) +
+            static_cast<int64_t>(tv.tv_usec);
+      } else if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+        int segment_size;
+        memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+        if (segment_size > 0 &&
+            datagram.size > static_cast<size_t>(segment_size)) {
+          datagram.segment_size = static_cast<size_t>(segment_size);
+        }
+      }
+    }
+  }
+  // Datagram sockets always stay readable, see RecvFrom().
+  EnableEvents(DE_READ);
+  if (received < 0 && !IsBlockingError(GetError())) {
+    RTC_LOG_F(LS_VERBOSE) << "Error = " << GetError();
+  }
+  return received;
+#else
+  return AsyncSocket::RecvFromBatch(datagrams, count);
+#endif  // WEBRTC_USE_MMSG
+}
+
+int PhysicalSocket::SendToBatch(const Datagram* datagrams, size_t count) {
+#if defined(WEBRTC_USE_MMSG)
+  if (!udp_ || count <= 1)
+    return AsyncSocket::SendToBatch(datagrams, count);
+
+  // Each message carries one datagram, or with segmentation offload a run of
+  // datagrams that the kernel splits up again. |iovs| is indexed by datagram.
+  mmsghdr msgs[kMaxDatagramBatchSize];
+  size_t msg_datagrams[kMaxDatagramBatchSize];
+  iovec iovs[kMaxDatagramBatchSize];
+  sockaddr_storage addrs[kMaxDatagramBatchSize];
+  union {
+    char buf[CMSG_SPACE(sizeof(uint16_t))];
+    cmsghdr align;
+  } control[kMaxDatagramBatchSize];
+  size_t total_sent = 0;
+  while (total_sent < count) {
+    const Datagram* chunk = datagrams + total_sent;
+    size_t chunk_size = std::min(count - total_sent, kMaxDatagramBatchSize);
+    memset(msgs, 0, sizeof(mmsghdr) * chunk_size);
+    size_t num_msgs = 0;
+    for (size_t i = 0; i < chunk_size;) {
+      // All datagrams of a segmented send but the last must have the same
+      // size, and the last one may not be larger.
+      size_t run = 1;
+      size_t run_bytes = chunk[i].size;
+      if (udp_segmentation_ && chunk[i].size > 0) {
+        while (i + run < chunk_size && chunk[i + run].addr == chunk[i].addr &&
+               chunk[i + run - 1].size == chunk[i].size &&
+               chunk[i + run].size > 0 &&
+               chunk[i + run].size <= chunk[i].size &&
+               run_bytes + chunk[i + run].size <= kMaxSegmentedSendSize) {
+          run_bytes += chunk[i + run].size;
+          ++run;
+        }
+      }
+      for (size_t j = i; j < i + run; ++j) {
+        iovs[j].iov_base = chunk[j].data;
+        iovs[j].iov_len = chunk[j].size;
+      }
+      msghdr& hdr = msgs[num_msgs].msg_hdr;
+      hdr.msg_name = &addrs[num_msgs];
+      hdr.msg_namelen = static_cast<socklen_t>(
+          chunk[i].addr.ToSockAddrStorage(&addrs[num_msgs]));
+      hdr.msg_iov = &iovs[i];
+      hdr.msg_iovlen = run;
+      if (run > 1) {
+        hdr.msg_control = control[num_msgs].buf;
+        hdr.msg_controllen = sizeof(control[num_msgs].buf);
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+        cmsg->cmsg_level = SOL_UDP;
+        cmsg->cmsg_type = UDP_SEGMENT;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+        uint16_t segment_size = static_cast<uint16_t>(chunk[i].size);
+        memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+      }
+      msg_datagrams[num_msgs++] = run;
+      i += run;
+    }
+    // Suppress SIGPIPE. See Send() for explanation.
+    int sent = ::sendmmsg(s_, msgs, static_cast<unsigned int>(num_msgs),
+                          MSG_NOSIGNAL);
+    UpdateLastError();
+    MaybeRemapSendError();
+    if (sent < 0 && udp_segmentation_ &&
+        (GetError() == EINVAL || GetError() == EIO)) {
+      // The route can't take segmented sends, e.g. because its MTU is smaller
+      // than a segment or the device lacks checksum offload. Send datagrams
+      // one by one from now on.
+      RTC_LOG(LS_WARNING) << "UDP segmentation offload failed with error "
+                          << GetError() << ", disabling it.";
+      udp_segmentation_ = false;
+      continue;
+    }
+    if (sent <= 0)
+      break;
+    for (int m = 0; m < sent; ++m)
+      total_sent += msg_datagrams[m];
+    if (static_cast<size_t>(sent) < num_msgs)
+      break;
+  }
+  if (total_sent < count) {
+    // The kernel stops at the first datagram it can't take; ask to be told
+    // when the socket becomes writable again.
+    EnableEvents(DE_WRITE);
+  }
+  if (total_sent == 0 && count > 0)
+    return SOCKET_ERROR;
+  return static_cast<int>(total_sent);
+#else
+  return AsyncSocket::SendToBatch(datagrams, count);
+#endif  // WEBRTC_USE_MMSG
+}
+
 int PhysicalSocket::Listen(int backlog) {
   int err = ::listen(s_, backlog);
   UpdateLastError();
@@ -493,6 +687,42 @@ void PhysicalSocket::OnResolveResult(AsyncResolverInterface* resolver) {
   }
 }
 
+int PhysicalSocket::GetOffloadOption(Option opt, int* value) {
+  *value = (opt == OPT_UDP_SEGMENTATION) ? udp_segmentation_ : udp_gro_;
+  return 0;
+}
+
+int PhysicalSocket::SetOffloadOption(Option opt, int value) {
+#if defined(WEBRTC_USE_MMSG)
+  if (!udp_) {
+    SetError(ENOPROTOOPT);
+    return -1;
+  }
+  if (opt == OPT_UDP_SEGMENTATION) {
+    // The segment size is passed with every send; setting a socket default
+    // of zero only probes whether the kernel supports UDP_SEGMENT at all.
+    int segment_size = 0;
+    if (value && ::setsockopt(s_, SOL_UDP, UDP_SEGMENT, &segment_size,
+                              sizeof(segment_size)) != 0) {
+      UpdateLastError();
+      return -1;
+    }
+    udp_segmentation_ = (value != 0);
+    return 0;
+  }
+  int enable = value ? 1 : 0;
+  if (::setsockopt(s_, SOL_UDP, UDP_GRO, &enable, sizeof(enable)) != 0) {
+    UpdateLastError();
+    return -1;
+  }
+  udp_gro_ = (value != 0);
+  return 0;
+#else
+  SetError(ENOPROTOOPT);
+  return -1;
+#endif  // WEBRTC_USE_MMSG
+}
+
 void PhysicalSocket::UpdateLastError() {
   SetError(LAST_SYSTEM_ERROR);
 }
@@ -554,6 +784,9 @@ int PhysicalSocket::TranslateOption(Option opt, int* slevel, int* sopt) {
       return -1;
     case OPT_RTP_SENDTIME_EXTN_ID:
       return -1;  // No logging is necessary as this not a OS socket option.
+    case OPT_UDP_SEGMENTATION:
+    case OPT_UDP_GRO:
+      return -1;  // Handled by Get/SetOffloadOption().
     default:
       RTC_NOTREACHED();
       return -1;
@@ -164,6 +164,14 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
                SocketAddress* out_addr,
                int64_t* timestamp) override;
 
+  // On Linux these use recvmmsg/sendmmsg to move a whole batch of UDP
+  // datagrams with one system call. With OPT_UDP_SEGMENTATION enabled, runs
+  // of equally sized datagrams to the same address go out as one UDP_SEGMENT
+  // message each; with OPT_UDP_GRO enabled, reads may return coalesced
+  // datagrams (see Datagram::segment_size).
+  int RecvFromBatch(Datagram* datagrams, size_t count) override;
+  int SendToBatch(const Datagram* datagrams, size_t count) override;
+
   int Listen(int backlog) override;
   AsyncSocket* Accept(SocketAddress* out_addr) override;
 
@@ -190,6 +198,11 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
 
   void OnResolveResult(AsyncResolverInterface* resolver);
 
+  // Handles OPT_UDP_SEGMENTATION and OPT_UDP_GRO, which aren't plain
+  // setsockopt() flags.
+  int GetOffloadOption(Option opt, int* value);
+  int SetOffloadOption(Option opt, int value);
+
   void UpdateLastError();
   void MaybeRemapSendError();
 
@@ -214,6 +227,10 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
 
  private:
   uint8_t enabled_events_ = 0;
+  // Set once SO_TIMESTAMP has been enabled for batched reads.
+  bool recv_timestamps_enabled_ = false;
+  bool udp_segmentation_ = false;
+  bool udp_gro_ = false;
 };
 
 class SocketDispatcher : public Dispatcher, public PhysicalSocket {
@@ -10,7 +10,9 @@
 
 #include <signal.h>
 #include <stdarg.h>
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #include "rtc_base/gunit.h"
 #include "rtc_base/logging.h"
@@ -118,6 +120,8 @@ class PhysicalSocketTest : public SocketTest {
 
   void ConnectInternalAcceptError(const IPAddress& loopback);
   void WritableAfterPartialWrite(const IPAddress& loopback);
+  void UdpBatch(const IPAddress& loopback);
+  void UdpSegmentationOffload(const IPAddress& loopback);
 
   std::unique_ptr<FakePhysicalSocketServer> server_;
   rtc::AutoSocketServerThread thread_;
@@ -434,6 +438,143 @@ TEST_F(PhysicalSocketTest, MAYBE_TestUdpReadyToSendIPv6) {
   SocketTest::TestUdpReadyToSendIPv6();
 }
 
+void PhysicalSocketTest::UdpBatch(const IPAddress& loopback) {
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(loopback.family(), SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(loopback.family(), SOCK_DGRAM));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(loopback, 0)));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(loopback, 0)));
+
+  // Send packets of increasing size with a single batched call.
+  const size_t kNumPackets = 5;
+  char payloads[kNumPackets][kNumPackets];
+  Datagram out[kNumPackets];
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    memset(payloads[i], 'a' + i, kNumPackets);
+    out[i].data = payloads[i];
+    out[i].size = i + 1;
+    out[i].addr = receiver->GetLocalAddress();
+  }
+  EXPECT_EQ(static_cast<int>(kNumPackets),
+            sender->SendToBatch(out, kNumPackets));
+
+  // Loopback delivery is synchronous, so all packets can be drained at once,
+  // even when offered more slots than there are packets.
+  const size_t kNumSlots = 8;
+  char buffers[kNumSlots][16];
+  Datagram in[kNumSlots];
+  for (size_t i = 0; i < kNumSlots; ++i) {
+    in[i].data = buffers[i];
+    in[i].capacity = sizeof(buffers[i]);
+  }
+  ASSERT_EQ(static_cast<int>(kNumPackets),
+            receiver->RecvFromBatch(in, kNumSlots));
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    EXPECT_EQ(i + 1, in[i].size);
+    EXPECT_EQ('a' + static_cast<int>(i), in[i].data[0]);
+    EXPECT_EQ(sender->GetLocalAddress(), in[i].addr);
+#if defined(WEBRTC_LINUX)
+    EXPECT_GT(in[i].timestamp, 0);
+#endif
+  }
+
+  // Nothing left to read.
+  EXPECT_EQ(-1, receiver->RecvFromBatch(in, kNumSlots));
+  EXPECT_TRUE(receiver->IsBlocking());
+}
+
+TEST_F(PhysicalSocketTest, TestUdpBatchIPv4) {
+  MAYBE_SKIP_IPV4;
+  UdpBatch(kIPv4Loopback);
+}
+
+TEST_F(PhysicalSocketTest, TestUdpBatchIPv6) {
+  MAYBE_SKIP_IPV6;
+  UdpBatch(kIPv6Loopback);
+}
+
+// Returns the sizes of the datagrams in |datagrams|, with GRO coalesced
+// datagrams split up again.
+static std::vector<size_t> DatagramSizes(const Datagram* datagrams,
+                                         int count) {
+  std::vector<size_t> sizes;
+  for (int i = 0; i < count; ++i) {
+    size_t segment_size = datagrams[i].segment_size;
+    if (segment_size == 0) {
+      sizes.push_back(datagrams[i].size);
+      continue;
+    }
+    for (size_t offset = 0; offset < datagrams[i].size; offset += segment_size)
+      sizes.push_back(std::min(segment_size, datagrams[i].size - offset));
+  }
+  return sizes;
+}
+
+void PhysicalSocketTest::UdpSegmentationOffload(const IPAddress& loopback) {
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(loopback.family(), SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(loopback.family(), SOCK_DGRAM));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(loopback, 0)));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(loopback, 0)));
+  if (sender->SetOption(Socket::OPT_UDP_SEGMENTATION, 1) != 0) {
+    RTC_LOG(LS_INFO) << "No UDP segmentation offload... skipping";
+    return;
+  }
+  int value = 0;
+  EXPECT_EQ(0, sender->GetOption(Socket::OPT_UDP_SEGMENTATION, &value));
+  EXPECT_EQ(1, value);
+
+  // The first four datagrams can go out as one segmented send (only the last
+  // segment may be shorter), the fifth needs a send of its own.
+  const std::vector<size_t> kSizes = {100, 100, 100, 50, 100};
+  char payload[100] = {0};
+  std::vector<Datagram> out(kSizes.size());
+  for (size_t i = 0; i < kSizes.size(); ++i) {
+    out[i].data = payload;
+    out[i].size = kSizes[i];
+    out[i].addr = receiver->GetLocalAddress();
+  }
+  const size_t kNumSlots = 8;
+  std::vector<char> buffers(kNumSlots * 1024);
+  Datagram in[kNumSlots];
+  for (size_t i = 0; i < kNumSlots; ++i) {
+    in[i].data = &buffers[i * 1024];
+    in[i].capacity = 1024;
+  }
+
+  // Without GRO the receiver sees the original datagrams.
+  EXPECT_EQ(static_cast<int>(kSizes.size()),
+            sender->SendToBatch(out.data(), out.size()));
+  int received = receiver->RecvFromBatch(in, kNumSlots);
+  ASSERT_EQ(static_cast<int>(kSizes.size()), received);
+  EXPECT_EQ(kSizes, DatagramSizes(in, received));
+
+  // With GRO they may arrive coalesced, but split up the same way.
+  if (receiver->SetOption(Socket::OPT_UDP_GRO, 1) != 0) {
+    RTC_LOG(LS_INFO) << "No UDP GRO... skipping";
+    return;
+  }
+  EXPECT_EQ(static_cast<int>(kSizes.size()),
+            sender->SendToBatch(out.data(), out.size()));
+  received = receiver->RecvFromBatch(in, kNumSlots);
+  ASSERT_GT(received, 0);
+  EXPECT_EQ(kSizes, DatagramSizes(in, received));
+}
+
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+TEST_F(PhysicalSocketTest, TestUdpSegmentationOffloadIPv4) {
+  MAYBE_SKIP_IPV4;
+  UdpSegmentationOffload(kIPv4Loopback);
+}
+
+TEST_F(PhysicalSocketTest, TestUdpSegmentationOffloadIPv6) {
+  MAYBE_SKIP_IPV6;
+  UdpSegmentationOffload(kIPv6Loopback);
+}
+#endif
+
 TEST_F(PhysicalSocketTest, TestGetSetOptionsIPv4) {
   MAYBE_SKIP_IPV4;
   SocketTest::TestGetSetOptionsIPv4();
@@ -123,6 +123,25 @@ inline bool IsBlockingError(int e) {
   return (e == EWOULDBLOCK) || (e == EAGAIN) || (e == EINPROGRESS);
 }
 
+// One entry of a batched datagram read or write, see
+// AsyncSocket::RecvFromBatch and AsyncSocket::SendToBatch.
+struct Datagram {
+  // Caller owned packet memory. For reads, |capacity| is the size of the
+  // buffer and |size| is set to the number of bytes received. For writes,
+  // |size| is the number of bytes to send.
+  char* data = nullptr;
+  size_t capacity = 0;
+  size_t size = 0;
+  // Source address for reads, destination address for writes.
+  SocketAddress addr;
+  // Receive time in microseconds, or -1 if not available.
+  int64_t timestamp = -1;
+  // Set on reads when the kernel coalesced several datagrams from the same
+  // sender into |data| (see Socket::OPT_UDP_GRO): every |segment_size| bytes
+  // starts a new datagram, and the last one may be shorter. Zero otherwise.
+  size_t segment_size = 0;
+};
+
 // General interface for the socket implementations of various networks.  The
 // methods match those of normal UNIX sockets very closely.
 class Socket {
@@ -167,6 +186,12 @@ class Socket {
     OPT_RTP_SENDTIME_EXTN_ID,  // This is a non-traditional socket option param.
                                // This is specific to libjingle and will be used
                                // if SendTime option is needed at socket level.
+    OPT_UDP_SEGMENTATION,      // Let batched sends hand runs of equally sized
+                               // datagrams for one destination to the kernel
+                               // as a single segmentation offload (GSO) send.
+    OPT_UDP_GRO,               // Let the kernel coalesce received datagrams;
+                               // only usable with batched reads, which report
+                               // the coalesced datagrams via segment_size.
   };
   virtual int GetOption(Option opt, int* value) = 0;
   virtual int SetOption(Option opt, int value) = 0;
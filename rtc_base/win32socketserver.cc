@@ -564,6 +564,9 @@ int Win32Socket::TranslateOption(Option opt, int* slevel, int* sopt) {
     case OPT_DSCP:
       RTC_LOG(LS_WARNING) << "Socket::OPT_DSCP not supported.";
       return -1;
+    case OPT_UDP_SEGMENTATION:
+    case OPT_UDP_GRO:
+      return -1;  // Linux only.
     default:
       RTC_NOTREACHED();
       return -1;
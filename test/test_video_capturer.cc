@@ -15,7 +15,8 @@
 namespace webrtc {
 namespace test {
 TestVideoCapturer::TestVideoCapturer()
-    : video_adapter_(new cricket::VideoAdapter()) {}
+    : video_adapter_(new cricket::VideoAdapter()),
+      pyramid_factory_(I420PyramidBufferFactory::Create()) {}
 TestVideoCapturer::~TestVideoCapturer() {}
 
 absl::optional<VideoFrame> TestVideoCapturer::AdaptFrame(
@@ -34,13 +35,19 @@ absl::optional<VideoFrame> TestVideoCapturer::AdaptFrame(
 
   absl::optional<VideoFrame> out_frame;
   if (out_height != frame.height() || out_width != frame.width()) {
-    // Video adapter has requested a down-scale. Allocate a new buffer and
-    // return scaled version.
-    rtc::scoped_refptr<I420Buffer> scaled_buffer =
-        I420Buffer::Create(out_width, out_height);
-    scaled_buffer->ScaleFrom(*frame.video_frame_buffer()->ToI420());
+    // Video adapter has requested a down-scale. Return a scaled version, from
+    // the pyramid of the frame, and with a pyramid of its own for the
+    // consumers scaling it further.
+    rtc::scoped_refptr<VideoFrameBuffer> scaled_buffer =
+        frame.video_frame_buffer()->GetScaledBuffer(out_width, out_height);
+    if (!scaled_buffer) {
+      scaled_buffer =
+          pyramid_factory_->Wrap(frame.video_frame_buffer()->ToI420())
+              ->GetScaledI420(out_width, out_height);
+    }
     out_frame.emplace(
-        VideoFrame(scaled_buffer, kVideoRotation_0, frame.timestamp_us()));
+        VideoFrame(pyramid_factory_->Wrap(scaled_buffer->ToI420()),
+                   kVideoRotation_0, frame.timestamp_us()));
   } else {
     // No adaptations needed, just return the frame as is.
     out_frame.emplace(frame);
@@ -18,6 +18,7 @@
 #include "api/video/i420_buffer.h"
 #include "api/video/video_frame.h"
 #include "api/video/video_source_interface.h"
+#include "common_video/include/i420_pyramid_buffer.h"
 #include "media/base/videoadapter.h"
 #include "rtc_base/criticalsection.h"
 
@@ -46,6 +47,7 @@ class TestVideoCapturer : public rtc::VideoSourceInterface<VideoFrame> {
 
  private:
   const std::unique_ptr<cricket::VideoAdapter> video_adapter_;
+  const rtc::scoped_refptr<I420PyramidBufferFactory> pyramid_factory_;
 };
 }  // namespace test
 }  // namespace webrtc
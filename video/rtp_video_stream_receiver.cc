@@ -225,6 +225,18 @@ int32_t RtpVideoStreamReceiver::OnReceivedPayloadData(
     const WebRtcRTPHeader* rtp_header,
     const absl::optional<RtpGenericFrameDescriptor>& generic_descriptor,
     bool is_recovered) {
+  return OnReceivedPayloadData(payload_data, payload_size, rtp_header,
+                               generic_descriptor, is_recovered,
+                               rtc::CopyOnWriteBuffer());
+}
+
+int32_t RtpVideoStreamReceiver::OnReceivedPayloadData(
+    const uint8_t* payload_data,
+    size_t payload_size,
+    const WebRtcRTPHeader* rtp_header,
+    const absl::optional<RtpGenericFrameDescriptor>& generic_descriptor,
+    bool is_recovered,
+    const rtc::CopyOnWriteBuffer& payload_buffer) {
   WebRtcRTPHeader rtp_header_with_ntp = *rtp_header;
   rtp_header_with_ntp.ntp_time_ms =
       ntp_estimator_.Estimate(rtp_header->header.timestamp);
@@ -267,6 +279,13 @@ int32_t RtpVideoStreamReceiver::OnReceivedPayloadData(
         break;
     }
 
+  } else if (payload_buffer.size() > 0 &&
+             payload_buffer.cdata() <= packet.dataPtr &&
+             packet.dataPtr + packet.sizeBytes <=
+                 payload_buffer.cdata() + payload_buffer.size()) {
+    // The payload is used as is, let the packet buffer share the buffer it
+    // was received in rather than making a copy of it.
+    packet.payload_buffer = payload_buffer;
   } else {
     uint8_t* data = new uint8_t[packet.sizeBytes];
     memcpy(data, packet.dataPtr, packet.sizeBytes);
@@ -576,7 +595,7 @@ void RtpVideoStreamReceiver::ReceivePacket(const RtpPacketReceived& packet) {
 
   OnReceivedPayloadData(parsed_payload.payload, parsed_payload.payload_length,
                         &webrtc_rtp_header, generic_descriptor_wire,
-                        packet.recovered());
+                        packet.recovered(), packet.Buffer());
 }
 
 void RtpVideoStreamReceiver::ParseAndHandleEncapsulatingHeader(
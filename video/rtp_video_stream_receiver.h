@@ -35,6 +35,7 @@
 #include "modules/video_coding/packet_buffer.h"
 #include "modules/video_coding/rtp_frame_reference_finder.h"
 #include "rtc_base/constructormagic.h"
+#include "rtc_base/copyonwritebuffer.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/numerics/sequence_number_util.h"
 #include "rtc_base/sequenced_task_checker.h"
@@ -146,6 +147,15 @@ class RtpVideoStreamReceiver : public RecoveredPacketReceiver,
   std::vector<webrtc::RtpSource> GetSources() const;
 
  private:
+  // As above, but if the payload lies within |payload_buffer| the packet
+  // buffer keeps a reference to that buffer instead of copying the payload.
+  int32_t OnReceivedPayloadData(
+      const uint8_t* payload_data,
+      size_t payload_size,
+      const WebRtcRTPHeader* rtp_header,
+      const absl::optional<RtpGenericFrameDescriptor>& generic_descriptor,
+      bool is_recovered,
+      const rtc::CopyOnWriteBuffer& payload_buffer);
   // Entry point doing non-stats work for a received packet. Called
   // for the same packet both before and after RED decapsulation.
   void ReceivePacket(const RtpPacketReceived& packet);
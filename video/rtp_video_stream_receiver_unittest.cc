@@ -24,6 +24,7 @@
 #include "modules/video_coding/packet.h"
 #include "modules/video_coding/rtp_frame_reference_finder.h"
 #include "rtc_base/bytebuffer.h"
+#include "rtc_base/copyonwritebufferpool.h"
 #include "rtc_base/logging.h"
 #include "system_wrappers/include/clock.h"
 #include "system_wrappers/include/field_trial.h"
@@ -613,6 +614,83 @@ TEST_F(RtpVideoStreamReceiverTest, ParseGenericDescriptorTwoPackets) {
   rtp_video_stream_receiver_->OnRtpPacket(second_packet);
 }
 
+// Counts the copies of the payload of a received packet until its frame is
+// assembled. The payload is copied into the buffer it is received in, and
+// from there into the frame: parsing and the packet buffer use the receive
+// buffer itself.
+TEST_F(RtpVideoStreamReceiverTest, PayloadCopiesPerReceivedPacket) {
+  const int kPayloadType = 123;
+  // Generic payload headers for the first packet of a key frame and for a
+  // packet later in the frame.
+  const std::vector<uint8_t> first_data = {0x03, 1, 2, 3};
+  const std::vector<uint8_t> last_data = {0x01, 4, 5, 6};
+
+  VideoCodec codec;
+  codec.plType = kPayloadType;
+  rtp_video_stream_receiver_->AddReceiveCodec(codec, {});
+  rtp_video_stream_receiver_->StartReceive();
+
+  rtc::CopyOnWriteBufferPool pool(1500, 4);
+  // Receive buffers, as [begin, end) ranges. Tells whether a payload is
+  // still in the buffer it was received in.
+  std::vector<std::pair<const uint8_t*, const uint8_t*>> receive_buffers;
+  auto in_receive_buffer = [&receive_buffers](const uint8_t* data) {
+    for (const auto& buffer : receive_buffers) {
+      if (buffer.first <= data && data < buffer.second)
+        return true;
+    }
+    return false;
+  };
+  size_t payload_copies = 0;
+
+  auto receive = [&](const std::vector<uint8_t>& data, uint16_t seq_num,
+                     bool marker) {
+    RtpPacketReceived packet;
+    packet.SetPayloadType(kPayloadType);
+    packet.SetSequenceNumber(seq_num);
+    packet.SetMarker(marker);
+    uint8_t* payload = packet.SetPayloadSize(data.size());
+    memcpy(payload, data.data(), data.size());
+
+    // Copied from the socket into a receive buffer, like RtpTransport does.
+    rtc::CopyOnWriteBuffer buffer =
+        pool.CreateBuffer(packet.data(), packet.size());
+    ++payload_copies;
+    receive_buffers.emplace_back(buffer.cdata(),
+                                 buffer.cdata() + buffer.size());
+
+    RtpPacketReceived received;
+    ASSERT_TRUE(received.Parse(std::move(buffer)));
+    if (!in_receive_buffer(received.payload().data()))
+      ++payload_copies;
+    rtp_video_stream_receiver_->OnRtpPacket(received);
+  };
+
+  receive(first_data, 1, false);
+  // The packet buffer holds on to the receive buffer, not to a copy.
+  if (pool.NumBuffersInUse() != 1)
+    ++payload_copies;
+
+  mock_on_complete_frame_callback_.AppendExpectedBitstream(
+      first_data.data() + 1, first_data.size() - 1);
+  mock_on_complete_frame_callback_.AppendExpectedBitstream(
+      last_data.data() + 1, last_data.size() - 1);
+  EXPECT_CALL(mock_on_complete_frame_callback_, DoOnCompleteFrame(_))
+      .WillOnce(Invoke([&](video_coding::EncodedFrame* frame) {
+        EXPECT_EQ(2u, pool.NumBuffersInUse());
+        // Assembling the frame copies the payload of each packet.
+        if (!in_receive_buffer(frame->Buffer()))
+          payload_copies += 2;
+      }));
+  receive(last_data, 2, true);
+
+  EXPECT_EQ(2u * 2u, payload_copies);
+
+  // The packets are released with the assembled frame.
+  EXPECT_EQ(0u, pool.NumBuffersInUse());
+  EXPECT_EQ(2u, pool.NumFreeBuffers());
+}
+
 #if RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
 TEST_F(RtpVideoStreamReceiverTest, RepeatedSecondarySinkDisallowed) {
   MockRtpPacketSink secondary_sink;
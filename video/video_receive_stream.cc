@@ -456,8 +456,11 @@ bool VideoReceiveStream::Decode() {
     stats_proxy_.OnPreDecode(frame->CodecSpecific()->codecType, qp);
 
     int decode_result = video_receiver_.Decode(frame.get());
+    // A frame-threaded decoder has accepted the frame and delivers it with a
+    // later Decode() call.
     if (decode_result == WEBRTC_VIDEO_CODEC_OK ||
-        decode_result == WEBRTC_VIDEO_CODEC_OK_REQUEST_KEYFRAME) {
+        decode_result == WEBRTC_VIDEO_CODEC_OK_REQUEST_KEYFRAME ||
+        decode_result == WEBRTC_VIDEO_CODEC_OUTPUT_DELAYED) {
       keyframe_required_ = false;
       frame_decoded_ = true;
       rtp_video_stream_receiver_.FrameDecoded(frame->id.picture_id);
@@ -209,7 +209,10 @@ VideoStreamDecoderImpl::DecodeResult VideoStreamDecoderImpl::DecodeNextFrame(
                                             nullptr,  // codec specific info
                                             frame->RenderTimeMs());
 
-    return decode_result == WEBRTC_VIDEO_CODEC_OK ? kOk : kDecodeFailure;
+    return decode_result == WEBRTC_VIDEO_CODEC_OK ||
+                   decode_result == WEBRTC_VIDEO_CODEC_OUTPUT_DELAYED
+               ? kOk
+               : kDecodeFailure;
   }
 
   return kNoFrame;